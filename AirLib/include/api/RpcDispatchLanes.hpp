@@ -0,0 +1,297 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_RpcDispatchLanes_hpp
+#define air_RpcDispatchLanes_hpp
+
+#include "common/Common.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+namespace msr { namespace airlib {
+
+//thrown to the client when a lane can't take another call
+class RpcServerBusy : public std::runtime_error {
+public:
+    RpcServerBusy(const std::string& message)
+        : std::runtime_error(message)
+    {
+    }
+};
+
+/*
+    Admission control for RPC handlers, by class of method.
+
+    Every bound method belongs to a lane. A lane runs at most worker_count of its calls at once and lets at most
+    queue_limit more wait for a worker, in arrival order; a call beyond that fails at once with RpcServerBusy, so
+    a client flooding the server with bulk requests is told to back off instead of piling up behind itself.
+
+    RPC handlers run on the server's I/O threads, and a waiting call holds its thread, so the server runs as many
+    threads as all lanes can hold together (getThreadCount()). A lane can then never take the threads of another:
+    however many simGetImages calls arrive, setCarControls and getMultirotorState find a free thread and only wait
+    for the control calls ahead of them.
+
+    The control lane is for short calls whose latency matters, the bulk lane for calls that move a lot of data or
+    take long on the game thread, and every other method is in the default lane. Calls that block for as long
+    as a maneuver, like moveToPosition, are in the default lane so they can't use up the control workers.
+*/
+class RpcDispatchLanes {
+private:
+    class Lane;
+
+public:
+    enum class LaneType : int {
+        Control = 0,
+        Default = 1,
+        Bulk = 2
+    };
+
+    static constexpr int kLaneCount = 3;
+
+    struct LaneSettings {
+        uint worker_count;
+        uint queue_limit;
+
+        LaneSettings(uint worker_count_val = 4, uint queue_limit_val = 4)
+            : worker_count(worker_count_val), queue_limit(queue_limit_val)
+        {
+        }
+    };
+
+    struct LaneStatus {
+        uint running = 0;
+        uint queued = 0;
+        uint64_t admitted_count = 0;
+        uint64_t rejected_count = 0;
+        double max_wait = 0;            //seconds the longest admitted call waited for a worker
+    };
+
+    //a bound method; the server keeps this so a call doesn't look its method up
+    struct Method {
+        std::string name;
+        std::atomic<int> lane;
+
+        Method(const std::string& name_val, LaneType lane_val)
+            : name(name_val), lane(static_cast<int>(lane_val))
+        {
+        }
+    };
+
+    //holds a worker of the method's lane while in scope
+    class Admission {
+    public:
+        Admission(RpcDispatchLanes& lanes, const Method& method)
+            : lane_(lanes.lanes_[method.lane.load(std::memory_order_relaxed)])
+        {
+            lane_.enter(method.name);
+        }
+
+        ~Admission()
+        {
+            lane_.leave();
+        }
+
+        Admission(Admission const&) = delete;
+        void operator=(Admission const&) = delete;
+
+    private:
+        Lane& lane_;
+    };
+
+public:
+    RpcDispatchLanes()
+    {
+        lanes_[static_cast<int>(LaneType::Control)].setup("control", LaneSettings(8, 8));
+        lanes_[static_cast<int>(LaneType::Default)].setup("default", LaneSettings(4, 4));
+        lanes_[static_cast<int>(LaneType::Bulk)].setup("bulk", LaneSettings(2, 2));
+
+        //only calls that return right away, the move calls that fly for a duration block and belong in the default lane
+        for (const char* method : { "ping", "getCarState", "setCarControls", "setCarControlSchedule", "getMultirotorState",
+                 "moveByRC", "moveByControlSchedule", "getControlScheduleStatus", "cancelLastTask", "simGetGroundTruthKinematics", "simGetVehiclePose", "getUrdfBotState",
+                 "updateControlledMotionComponentControlSignal", "simPause", "simIsPaused", "simContinueForTime" })
+            default_lanes_[method] = LaneType::Control;
+        for (const char* method : { "simGetImages", "simGetImage", "simSpawnStaticMeshObject", "simSetDrawableShapes",
+                 "simCharPlayMotionClip", "getLidarData", "simGetCameraEvents" })
+            default_lanes_[method] = LaneType::Bulk;
+    }
+
+    //the returned method stays valid and follows later setMethodLane() calls
+    const Method& addMethod(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(methods_mutex_);
+        auto found = methods_.find(name);
+        if (found == methods_.end()) {
+            auto default_lane = default_lanes_.find(name);
+            LaneType lane = default_lane == default_lanes_.end() ? LaneType::Default : default_lane->second;
+            found = methods_.emplace(name, std::unique_ptr<Method>(new Method(name, lane))).first;
+        }
+        return *found->second;
+    }
+
+    void setMethodLane(const std::string& name, LaneType lane)
+    {
+        checkLane(lane);
+        std::lock_guard<std::mutex> lock(methods_mutex_);
+        default_lanes_[name] = lane;
+        auto found = methods_.find(name);
+        if (found != methods_.end())
+            found->second->lane = static_cast<int>(lane);
+    }
+
+    LaneType getMethodLane(const std::string& name) const
+    {
+        std::lock_guard<std::mutex> lock(methods_mutex_);
+        auto found = methods_.find(name);
+        if (found != methods_.end())
+            return static_cast<LaneType>(found->second->lane.load());
+        auto default_lane = default_lanes_.find(name);
+        return default_lane == default_lanes_.end() ? LaneType::Default : default_lane->second;
+    }
+
+    //the thread count of a running server doesn't change, so settings should be made before it starts
+    void setLaneSettings(LaneType lane, const LaneSettings& settings)
+    {
+        checkLane(lane);
+        if (settings.worker_count == 0)
+            throw std::invalid_argument("RPC lane " + getLaneName(lane) + " needs at least one worker");
+        lanes_[static_cast<int>(lane)].setSettings(settings);
+    }
+
+    LaneSettings getLaneSettings(LaneType lane) const
+    {
+        checkLane(lane);
+        return lanes_[static_cast<int>(lane)].getSettings();
+    }
+
+    LaneStatus getLaneStatus(LaneType lane) const
+    {
+        checkLane(lane);
+        return lanes_[static_cast<int>(lane)].getStatus();
+    }
+
+    //I/O threads the server needs so that every lane can hold all of its calls at once
+    uint getThreadCount() const
+    {
+        uint count = 0;
+        for (const auto& lane : lanes_) {
+            LaneSettings settings = lane.getSettings();
+            count += settings.worker_count + settings.queue_limit;
+        }
+        return count;
+    }
+
+    static std::string getLaneName(LaneType lane)
+    {
+        switch (lane) {
+        case LaneType::Control: return "control";
+        case LaneType::Default: return "default";
+        case LaneType::Bulk: return "bulk";
+        default:
+            throw std::invalid_argument(Utils::stringf("Unknown RPC lane %d", static_cast<int>(lane)));
+        }
+    }
+
+    //case insensitive
+    static LaneType getLaneType(const std::string& name)
+    {
+        std::string lower = Utils::toLower(name);
+        for (int lane = 0; lane < kLaneCount; ++lane) {
+            if (getLaneName(static_cast<LaneType>(lane)) == lower)
+                return static_cast<LaneType>(lane);
+        }
+        throw std::invalid_argument("Unknown RPC lane '" + name + "', expected Control, Default or Bulk");
+    }
+
+private:
+    static void checkLane(LaneType lane)
+    {
+        if (static_cast<int>(lane) < 0 || static_cast<int>(lane) >= kLaneCount)
+            throw std::invalid_argument(Utils::stringf("Unknown RPC lane %d", static_cast<int>(lane)));
+    }
+
+    class Lane {
+    public:
+        void setup(const std::string& name, const LaneSettings& settings)
+        {
+            name_ = name;
+            settings_ = settings;
+        }
+
+        void setSettings(const LaneSettings& settings)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            settings_ = settings;
+            //more workers may let waiting calls in
+            changed_.notify_all();
+        }
+
+        LaneSettings getSettings() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return settings_;
+        }
+
+        LaneStatus getStatus() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return status_;
+        }
+
+        void enter(const std::string& method)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (status_.queued == 0 && status_.running < settings_.worker_count) {
+                ++status_.running;
+                ++status_.admitted_count;
+                return;
+            }
+
+            if (status_.queued >= settings_.queue_limit) {
+                ++status_.rejected_count;
+                throw RpcServerBusy(Utils::stringf("RPC server is busy: %s was rejected because the %s lane has %u calls running and %u waiting, try again later",
+                    method.c_str(), name_.c_str(), status_.running, status_.queued));
+            }
+
+            //first come, first served
+            const uint64_t ticket = next_ticket_++;
+            ++status_.queued;
+            const auto wait_start = std::chrono::steady_clock::now();
+            changed_.wait(lock, [&]() { return ticket == serving_ticket_ && status_.running < settings_.worker_count; });
+            ++serving_ticket_;
+            --status_.queued;
+            ++status_.running;
+            ++status_.admitted_count;
+            status_.max_wait = std::max(status_.max_wait, std::chrono::duration<double>(std::chrono::steady_clock::now() - wait_start).count());
+            //the next ticket may fit too
+            changed_.notify_all();
+        }
+
+        void leave()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --status_.running;
+            changed_.notify_all();
+        }
+
+    private:
+        std::string name_;
+        LaneSettings settings_;
+        LaneStatus status_;
+        uint64_t next_ticket_ = 0;
+        uint64_t serving_ticket_ = 0;
+        mutable std::mutex mutex_;
+        std::condition_variable changed_;
+    };
+
+private:
+    Lane lanes_[kLaneCount];
+    std::map<std::string, LaneType> default_lanes_;
+    std::map<std::string, std::unique_ptr<Method>> methods_;
+    mutable std::mutex methods_mutex_;
+};
+
+}} //namespace
+#endif
@@ -9,6 +9,7 @@
 #include "physics/Kinematics.hpp"
 #include "physics/Environment.hpp"
 #include "common/ImageCaptureBase.hpp"
+#include "camera/EventCameraEmulator.hpp"
 #include "safety/SafetyEval.hpp"
 #include "sensors/SensorCollection.hpp"
 
@@ -36,6 +37,32 @@ public:
             d.push_back(TDest(s.at(i)));
     }
 
+    //streamed bone poses are 7 floats each: x, y, z of the position then w, x, y, z of the orientation
+    static std::vector<float> packPoses(const std::vector<msr::airlib::Pose>& poses)
+    {
+        std::vector<float> values;
+        values.reserve(poses.size() * 7);
+        for (const auto& pose : poses) {
+            values.insert(values.end(), { pose.position.x(), pose.position.y(), pose.position.z(),
+                pose.orientation.w(), pose.orientation.x(), pose.orientation.y(), pose.orientation.z() });
+        }
+        return values;
+    }
+
+    static std::vector<msr::airlib::Pose> unpackPoses(const std::vector<float>& values)
+    {
+        if (values.size() % 7 != 0)
+            throw std::invalid_argument("Packed poses must have 7 values per pose.");
+
+        std::vector<msr::airlib::Pose> poses;
+        poses.reserve(values.size() / 7);
+        for (size_t i = 0; i < values.size(); i += 7) {
+            poses.push_back(msr::airlib::Pose(msr::airlib::Vector3r(values[i], values[i + 1], values[i + 2]),
+                msr::airlib::Quaternionr(values[i + 3], values[i + 4], values[i + 5], values[i + 6])));
+        }
+        return poses;
+    }
+
     struct Vector3r {
         msr::airlib::real_T x_val = 0, y_val = 0, z_val = 0;
         MSGPACK_DEFINE_MAP(x_val, y_val, z_val);
@@ -89,6 +116,45 @@ public:
         }
     };
 
+    struct ControlScheduleStatus {
+        bool is_active = false;
+        unsigned int pending_count = 0;
+        unsigned int executed_count = 0;
+        unsigned int skipped_count = 0;
+        double last_lag = 0;
+        double max_lag = 0;
+        msr::airlib::TTimePoint last_setpoint_time = 0;
+
+        MSGPACK_DEFINE_MAP(is_active, pending_count, executed_count, skipped_count, last_lag, max_lag, last_setpoint_time);
+
+        ControlScheduleStatus()
+        {}
+
+        ControlScheduleStatus(const msr::airlib::ControlScheduleStatus& s)
+        {
+            is_active = s.is_active;
+            pending_count = s.pending_count;
+            executed_count = s.executed_count;
+            skipped_count = s.skipped_count;
+            last_lag = s.last_lag;
+            max_lag = s.max_lag;
+            last_setpoint_time = s.last_setpoint_time;
+        }
+
+        msr::airlib::ControlScheduleStatus to() const
+        {
+            msr::airlib::ControlScheduleStatus d;
+            d.is_active = is_active;
+            d.pending_count = pending_count;
+            d.executed_count = executed_count;
+            d.skipped_count = skipped_count;
+            d.last_lag = last_lag;
+            d.max_lag = max_lag;
+            d.last_setpoint_time = last_setpoint_time;
+            return d;
+        }
+    };
+
     struct Quaternionr {
         msr::airlib::real_T w_val = 1, x_val = 0, y_val = 0, z_val = 0;
         MSGPACK_DEFINE_MAP(w_val, x_val, y_val, z_val);
@@ -482,6 +548,59 @@ public:
         }
     };
 
+    struct EventPacket {
+        msr::airlib::TTimePoint start_time = 0;
+        msr::airlib::TTimePoint end_time = 0;
+        int width = 0, height = 0;
+        //packed events as little endian bytes, 8 per event, so they go as one binary blob
+        std::vector<uint8_t> events;
+
+        MSGPACK_DEFINE_MAP(start_time, end_time, width, height, events);
+
+        EventPacket()
+        {}
+
+        EventPacket(const msr::airlib::EventCameraEmulator::EventPacket& s)
+        {
+            start_time = s.start_time;
+            end_time = s.end_time;
+            width = s.width;
+            height = s.height;
+
+            events.resize(s.events.size() * 8);
+            uint8_t* bytes = events.data();
+            for (uint64_t word : s.events) {
+                for (int i = 0; i < 8; ++i)
+                    *bytes++ = static_cast<uint8_t>(word >> (8 * i));
+            }
+
+            //TODO: remove bug workaround for https://github.com/rpclib/rpclib/issues/152
+            //a single byte is not an event, so to() drops it
+            if (events.size() == 0)
+                events.push_back(0);
+        }
+
+        msr::airlib::EventCameraEmulator::EventPacket to() const
+        {
+            msr::airlib::EventCameraEmulator::EventPacket d;
+
+            d.start_time = start_time;
+            d.end_time = end_time;
+            d.width = width;
+            d.height = height;
+
+            d.events.resize(events.size() / 8);
+            const uint8_t* bytes = events.data();
+            for (auto& word : d.events) {
+                word = 0;
+                for (int i = 0; i < 8; ++i)
+                    word |= static_cast<uint64_t>(*bytes++) << (8 * i);
+            }
+
+            return d;
+        }
+    };
+
     struct LidarData {
 
         msr::airlib::TTimePoint time_stamp;    // timestamp
@@ -7,6 +7,8 @@
 #include "common/Common.hpp"
 #include "common/CommonStructs.hpp"
 #include "common/ImageCaptureBase.hpp"
+#include "camera/EventCameraEmulator.hpp"
+#include "common/ControlSchedule.hpp"
 #include "physics/Kinematics.hpp"
 #include "physics/Environment.hpp"
 
@@ -37,6 +39,8 @@ public:
     bool simIsPaused() const;
     void simPause(bool is_paused);
     void simContinueForTime(double seconds);
+    void simStartRpcRecording(const std::string& file_path);
+    void simStopRpcRecording();
 
     Pose simGetObjectPose(const std::string& object_name) const;
     bool simSetObjectPose(const std::string& object_name, const Pose& pose, bool teleport = true);
@@ -46,6 +50,7 @@ public:
     //task management APIs
     void cancelLastTask(const std::string& vehicle_name = "");
     virtual RpcLibClientBase* waitOnLastTask(bool* task_result = nullptr, float timeout_sec = Utils::nan<float>());
+    ControlScheduleStatus getControlScheduleStatus(const std::string& vehicle_name = "") const;
 
     bool simSetSegmentationObjectID(const std::string& mesh_name, int object_id, bool is_name_regex = false);
     int simGetSegmentationObjectID(const std::string& mesh_name) const;
@@ -78,6 +83,8 @@ public:
     vector<ImageCaptureBase::ImageResponse> simGetImages(vector<ImageCaptureBase::ImageRequest> request, const std::string& vehicle_name = "");
     vector<uint8_t> simGetImage(const std::string& camera_name, ImageCaptureBase::ImageType type, const std::string& vehicle_name = "");
     void simSetCameraPose(const CameraPose camera_pose, const std::string& vehicle_name = "");
+    //DVS events of the camera since the previous call, see EventCameraEmulator; the first call only starts the sequence
+    EventCameraEmulator::EventPacket simGetCameraEvents(const std::string& camera_name, const std::string& vehicle_name = "");
 
     CollisionInfo simGetCollisionInfo(const std::string& vehicle_name = "") const;
 
@@ -106,6 +113,12 @@ public:
     void simSetFacePresets(const std::unordered_map<std::string, float>& presets, const std::string& character_name = "");
     void simSetBonePoses(const std::unordered_map<std::string, msr::airlib::Pose>& poses, const std::string& character_name = "");
     std::unordered_map<std::string, msr::airlib::Pose> simGetBonePoses(const std::vector<std::string>& bone_names, const std::string& character_name = "") const;
+    std::vector<std::string> simCharGetBoneNames(const std::string& character_name = "") const;
+    void simCharSetBonePosesByIndex(const std::vector<int>& bone_indices, const std::vector<msr::airlib::Pose>& poses, const std::string& character_name = "");
+    std::vector<msr::airlib::Pose> simCharGetBonePosesByIndex(const std::vector<int>& bone_indices, const std::string& character_name = "") const;
+    void simCharPlayMotionClip(const std::string& clip_file, float scale = 1, float rate = 1, bool loop = false, const std::string& character_name = "");
+    void simCharSetMotionClipTimeWarp(const std::vector<float>& play_times, const std::vector<float>& clip_times, const std::string& character_name = "");
+    void simCharStopMotionClip(const std::string& character_name = "");
 
 protected:
     void* getClient();
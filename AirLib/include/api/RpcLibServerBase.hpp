@@ -7,6 +7,8 @@
 #include "common/Common.hpp"
 #include "api/ApiServerBase.hpp"
 #include "api/ApiProvider.hpp"
+#include "api/RpcDispatchLanes.hpp"
+#include "camera/EventCameraEmulator.hpp"
 
 
 namespace msr { namespace airlib {
@@ -20,6 +22,17 @@ public:
     virtual void start(bool block = false) override;
     virtual void stop() override;
 
+    //logs every call to a session log that RpcSessionReplayer can replay, see RpcSessionLog.hpp
+    void startRecording(const std::string& file_path);
+    void stopRecording();
+    bool isRecording() const;
+
+    //lanes come from the RpcLanes and RpcMethodLanes settings, changes should be made before start()
+    RpcDispatchLanes& getDispatchLanes();
+
+    //captures a Scene image of the camera and returns the DVS events since the previous call for it, see EventCameraEmulator
+    EventCameraEmulator::EventPacket getCameraEvents(const std::string& camera_name, const std::string& vehicle_name);
+
     class ApiNotSupported : public std::runtime_error {
     public:
         ApiNotSupported(const std::string& message)
@@ -60,6 +73,9 @@ protected:
     }
 
 
+private:
+    void applyLaneSettings();
+
 private:
     ApiProvider* api_provider_;
 
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_RpcLibServerCore_hpp
+#define air_RpcLibServerCore_hpp
+
+//include after rpc/server.h, the way the RpcLib servers include it
+#include "common/Common.hpp"
+#include "api/RpcSessionLog.hpp"
+#include "api/RpcDispatchLanes.hpp"
+
+namespace msr { namespace airlib {
+
+namespace rpclib_server_detail {
+
+//msgpack stream that only counts bytes, so result sizes cost no copy
+struct ByteCounter {
+    uint64_t size = 0;
+
+    void write(const char*, size_t count)
+    {
+        size += count;
+    }
+};
+
+template <typename TResult>
+struct RecordedInvoke {
+    template <typename TFunc, typename... TArgs>
+    static TResult run(RpcSessionRecorder::Call& call, const TFunc& func, TArgs&... args)
+    {
+        TResult result = func(args...);
+        ByteCounter counter;
+        RPCLIB_MSGPACK::pack(counter, result);
+        call.finish(counter.size);
+        return result;
+    }
+};
+
+template <>
+struct RecordedInvoke<void> {
+    template <typename TFunc, typename... TArgs>
+    static void run(RpcSessionRecorder::Call& call, const TFunc& func, TArgs&... args)
+    {
+        func(args...);
+        call.finish(0);
+    }
+};
+
+} //namespace
+
+/*
+    The rpc::server of RpcLibServerBase. Its bind() hides rpc::server::bind and wraps each handler so that calls
+    wait for a worker of their dispatch lane, and, while a session is being recorded, are written to the session
+    log with the arguments repacked as msgpack. Recorded latencies include the wait for a worker and calls the lane
+    rejected are recorded as failed. Handlers bound through rpc::server::bind directly bypass both.
+*/
+class RpcLibServerCore : public rpc::server {
+public:
+    using rpc::server::server;
+
+    template <typename TFunc>
+    void bind(const std::string& method, TFunc func)
+    {
+        bindDispatched(method, func, &TFunc::operator());
+    }
+
+    //runs as many I/O threads as the dispatch lanes can hold calls
+    void startDispatch()
+    {
+        async_run(lanes_.getThreadCount());
+    }
+
+    RpcDispatchLanes& getLanes()
+    {
+        return lanes_;
+    }
+
+    RpcSessionRecorder& getRecorder()
+    {
+        return recorder_;
+    }
+
+    const RpcSessionRecorder& getRecorder() const
+    {
+        return recorder_;
+    }
+
+private:
+    template <typename TFunc, typename TResult, typename... TArgs>
+    void bindDispatched(const std::string& method, TFunc func, TResult (TFunc::*)(TArgs...) const)
+    {
+        RpcSessionRecorder* recorder = &recorder_;
+        RpcDispatchLanes* lanes = &lanes_;
+        const RpcDispatchLanes::Method* lane_method = &lanes_.addMethod(method);
+        rpc::server::bind(method, [recorder, lanes, lane_method, func](TArgs... args) -> TResult {
+            if (!recorder->isRecording()) {
+                RpcDispatchLanes::Admission admission(*lanes, *lane_method);
+                return func(args...);
+            }
+
+            RPCLIB_MSGPACK::sbuffer packed_args;
+            RPCLIB_MSGPACK::pack(packed_args, std::forward_as_tuple(args...));
+            RpcSessionRecorder::Call call(*recorder, lane_method->name, packed_args.data(), packed_args.size());
+            RpcDispatchLanes::Admission admission(*lanes, *lane_method);
+            return rpclib_server_detail::RecordedInvoke<TResult>::run(call, func, args...);
+        });
+    }
+
+private:
+    RpcSessionRecorder recorder_;
+    RpcDispatchLanes lanes_;
+};
+
+}} //namespace
+#endif
@@ -0,0 +1,402 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_RpcSessionLog_hpp
+#define air_RpcSessionLog_hpp
+
+#include "common/Common.hpp"
+#include "common/ClockFactory.hpp"
+#include <atomic>
+#include <cstring>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <iomanip>
+
+namespace msr { namespace airlib {
+
+//one RPC call as the server saw it
+struct RpcCallRecord {
+    std::string method;
+    TTimePoint sim_time = 0;        //sim clock when the call arrived
+    uint64_t offset = 0;            //nanoseconds from the start of the recording to the call
+    uint64_t latency = 0;           //nanoseconds the handler ran
+    uint64_t result_size = 0;       //bytes of the msgpack result
+    bool failed = false;            //handler threw
+    std::string args;               //msgpack array of the call arguments, as the client sent them
+};
+
+/*
+    Writes RPC calls to a session log and reads them back.
+
+    The file is a short header followed by entries. The first call to a method is preceded by an entry that gives
+    the method an id, so calls only carry the id; numbers are LEB128 varints and the arguments are stored as the
+    raw msgpack array, so a replay can send exactly what the client sent. Calls are written as they finish, which
+    is not the order they started in when handlers run concurrently.
+
+    A log cut short by a crash reads up to its last complete entry and reports itself truncated.
+*/
+namespace RpcSessionLog {
+    inline const char* magic()
+    {
+        return "ASRPCLOG";
+    }
+
+    constexpr size_t kMagicSize = 8;
+    constexpr uint64_t kVersion = 1;
+    enum EntryKind : char {
+        kMethodEntry = 1,
+        kCallEntry = 2,
+        kFailedCallEntry = 3
+    };
+
+    class Writer {
+    public:
+        explicit Writer(const std::string& file_path)
+            : file_(file_path, std::ios::binary | std::ios::trunc)
+        {
+            if (!file_)
+                throw std::runtime_error("Cannot open RPC session log " + file_path + " for writing");
+            file_.write(magic(), kMagicSize);
+            writeVarint(kVersion);
+        }
+
+        void write(const RpcCallRecord& record)
+        {
+            auto found = method_ids_.find(record.method);
+            if (found == method_ids_.end()) {
+                found = method_ids_.emplace(record.method, static_cast<uint64_t>(method_ids_.size())).first;
+                file_.put(kMethodEntry);
+                writeVarint(found->second);
+                writeBytes(record.method);
+            }
+
+            file_.put(record.failed ? kFailedCallEntry : kCallEntry);
+            writeVarint(found->second);
+            writeVarint(record.sim_time);
+            writeVarint(record.offset);
+            writeVarint(record.latency);
+            writeVarint(record.result_size);
+            writeBytes(record.args);
+        }
+
+        void flush()
+        {
+            file_.flush();
+        }
+
+    private:
+        void writeVarint(uint64_t value)
+        {
+            while (value >= 0x80) {
+                file_.put(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            file_.put(static_cast<char>(value));
+        }
+
+        void writeBytes(const std::string& bytes)
+        {
+            writeVarint(bytes.size());
+            file_.write(bytes.data(), bytes.size());
+        }
+
+    private:
+        std::ofstream file_;
+        std::map<std::string, uint64_t> method_ids_;
+    };
+
+    class Reader {
+    public:
+        explicit Reader(const std::string& file_path)
+            : file_(file_path, std::ios::binary), file_path_(file_path)
+        {
+            if (!file_)
+                throw std::runtime_error("Cannot open RPC session log " + file_path);
+            char file_magic[kMagicSize];
+            uint64_t version;
+            if (!file_.read(file_magic, kMagicSize) || std::memcmp(file_magic, magic(), kMagicSize) != 0 || !readVarint(version))
+                throw std::runtime_error(file_path + " is not an RPC session log");
+            if (version != kVersion)
+                throw std::runtime_error(Utils::stringf("%s has unsupported RPC session log version %d", file_path.c_str(), static_cast<int>(version)));
+        }
+
+        //false at the end of the log
+        bool next(RpcCallRecord& record)
+        {
+            int kind;
+            while ((kind = file_.get()) == kMethodEntry) {
+                uint64_t id;
+                std::string name;
+                if (!readVarint(id) || !readBytes(name))
+                    return endTruncated();
+                if (id != methods_.size())
+                    throw std::runtime_error(file_path_ + " has a corrupt method entry");
+                methods_.push_back(name);
+            }
+
+            if (kind == std::char_traits<char>::eof())
+                return false;
+            if (kind != kCallEntry && kind != kFailedCallEntry)
+                throw std::runtime_error(Utils::stringf("%s has an unknown entry at byte %d", file_path_.c_str(), static_cast<int>(file_.tellg()) - 1));
+
+            uint64_t id;
+            if (!readVarint(id) || !readVarint(record.sim_time) || !readVarint(record.offset) || !readVarint(record.latency)
+                || !readVarint(record.result_size) || !readBytes(record.args))
+                return endTruncated();
+            if (id >= methods_.size())
+                throw std::runtime_error(file_path_ + " has a call to an undefined method");
+            record.method = methods_[id];
+            record.failed = kind == kFailedCallEntry;
+            return true;
+        }
+
+        //every call in the log, in the order they started
+        vector<RpcCallRecord> readAll()
+        {
+            vector<RpcCallRecord> records;
+            RpcCallRecord record;
+            while (next(record))
+                records.push_back(record);
+            std::stable_sort(records.begin(), records.end(),
+                [](const RpcCallRecord& a, const RpcCallRecord& b) { return a.offset < b.offset; });
+            return records;
+        }
+
+        //the log ended inside an entry, usually because the recording process died
+        bool isTruncated() const
+        {
+            return truncated_;
+        }
+
+    private:
+        bool readVarint(uint64_t& value)
+        {
+            value = 0;
+            for (uint shift = 0; shift < 64; shift += 7) {
+                int byte = file_.get();
+                if (byte == std::char_traits<char>::eof())
+                    return false;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                    return true;
+            }
+            throw std::runtime_error(file_path_ + " has a corrupt number");
+        }
+
+        bool readBytes(std::string& bytes)
+        {
+            uint64_t size;
+            if (!readVarint(size))
+                return false;
+            bytes.resize(static_cast<size_t>(size));
+            return size == 0 || file_.read(&bytes[0], size);
+        }
+
+        bool endTruncated()
+        {
+            truncated_ = true;
+            return false;
+        }
+
+    private:
+        std::ifstream file_;
+        std::string file_path_;
+        vector<std::string> methods_;
+        bool truncated_ = false;
+    };
+} //namespace RpcSessionLog
+
+/*
+    Records RPC calls to a session log while recording is on.
+
+    Handlers wrap each call in a Call, which stamps the sim clock and the start time and writes the record when it
+    goes out of scope; calls that end without finish() were ended by an exception and are recorded as failed.
+    When recording is off a handler only pays for one atomic load.
+*/
+class RpcSessionRecorder {
+public:
+    typedef std::chrono::steady_clock SteadyClock;
+
+    class Call {
+    public:
+        Call(RpcSessionRecorder& recorder, const std::string& method, const char* args, size_t args_size)
+            : recorder_(recorder), start_(SteadyClock::now())
+        {
+            record_.method = method;
+            record_.sim_time = ClockFactory::get()->nowNanos();
+            record_.args.assign(args, args_size);
+            record_.failed = true;
+        }
+
+        void finish(uint64_t result_size)
+        {
+            record_.result_size = result_size;
+            record_.failed = false;
+        }
+
+        ~Call()
+        {
+            record_.latency = nanosSince(start_);
+            recorder_.record(record_, start_);
+        }
+
+        Call(Call const&) = delete;
+        void operator=(Call const&) = delete;
+
+    private:
+        RpcSessionRecorder& recorder_;
+        SteadyClock::time_point start_;
+        RpcCallRecord record_;
+    };
+
+public:
+    ~RpcSessionRecorder()
+    {
+        stop();
+    }
+
+    //replaces the file if it exists; a recording in progress is stopped first
+    void start(const std::string& file_path)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writer_.reset();
+        writer_.reset(new RpcSessionLog::Writer(file_path));
+        start_ = SteadyClock::now();
+        call_count_ = 0;
+        is_recording_ = true;
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_recording_ = false;
+        writer_.reset();
+    }
+
+    bool isRecording() const
+    {
+        return is_recording_.load(std::memory_order_relaxed);
+    }
+
+    //calls recorded since the recording started
+    uint64_t getCallCount() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return call_count_;
+    }
+
+    void record(RpcCallRecord& record, SteadyClock::time_point call_start)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        //calls that started before the recording are dropped along with the ones that end after it
+        if (!writer_ || call_start < start_)
+            return;
+        record.offset = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(call_start - start_).count());
+        writer_->write(record);
+        ++call_count_;
+    }
+
+private:
+    static uint64_t nanosSince(SteadyClock::time_point start)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(SteadyClock::now() - start).count());
+    }
+
+private:
+    std::atomic<bool> is_recording_ { false };
+    std::unique_ptr<RpcSessionLog::Writer> writer_;
+    SteadyClock::time_point start_;
+    uint64_t call_count_ = 0;
+    mutable std::mutex mutex_;
+};
+
+//latency distribution of each method in a set of calls
+class RpcLatencyReport {
+public:
+    struct MethodStats {
+        std::string method;
+        uint count = 0;
+        uint failed_count = 0;
+        //seconds
+        double mean = 0, p50 = 0, p90 = 0, p99 = 0, max = 0;
+    };
+
+public:
+    void add(const std::string& method, double latency, bool failed = false)
+    {
+        Samples& samples = methods_[method];
+        samples.latencies.push_back(latency);
+        samples.failed_count += failed ? 1 : 0;
+    }
+
+    //latencies as the server recorded them
+    static RpcLatencyReport fromRecords(const vector<RpcCallRecord>& records)
+    {
+        RpcLatencyReport report;
+        for (const auto& record : records)
+            report.add(record.method, record.latency * 1E-9, record.failed);
+        return report;
+    }
+
+    //sorted by method name
+    vector<MethodStats> getStats() const
+    {
+        vector<MethodStats> all;
+        for (const auto& method : methods_) {
+            MethodStats stats;
+            stats.method = method.first;
+            stats.failed_count = method.second.failed_count;
+
+            vector<double> latencies = method.second.latencies;
+            std::sort(latencies.begin(), latencies.end());
+            stats.count = static_cast<uint>(latencies.size());
+            double sum = 0;
+            for (double latency : latencies)
+                sum += latency;
+            stats.mean = sum / latencies.size();
+            stats.p50 = percentile(latencies, 0.5);
+            stats.p90 = percentile(latencies, 0.9);
+            stats.p99 = percentile(latencies, 0.99);
+            stats.max = latencies.back();
+            all.push_back(stats);
+        }
+        return all;
+    }
+
+    //a table in milliseconds
+    std::string toString() const
+    {
+        std::ostringstream table;
+        table << std::left << std::setw(32) << "method" << std::right << std::setw(8) << "calls" << std::setw(8) << "failed"
+              << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+        table << std::fixed << std::setprecision(3);
+        for (const auto& stats : getStats()) {
+            table << std::left << std::setw(32) << stats.method << std::right << std::setw(8) << stats.count << std::setw(8) << stats.failed_count
+                  << std::setw(10) << stats.mean * 1E3 << std::setw(10) << stats.p50 * 1E3 << std::setw(10) << stats.p90 * 1E3
+                  << std::setw(10) << stats.p99 * 1E3 << std::setw(10) << stats.max * 1E3 << "\n";
+        }
+        return table.str();
+    }
+
+private:
+    struct Samples {
+        vector<double> latencies;
+        uint failed_count = 0;
+    };
+
+    //nearest rank
+    static double percentile(const vector<double>& sorted, double fraction)
+    {
+        size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+        return sorted[rank > 0 ? rank - 1 : 0];
+    }
+
+private:
+    std::map<std::string, Samples> methods_;
+};
+
+}} //namespace
+#endif
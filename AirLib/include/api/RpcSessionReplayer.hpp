@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_RpcSessionReplayer_hpp
+#define air_RpcSessionReplayer_hpp
+
+#include "common/Common.hpp"
+#include "api/RpcSessionLog.hpp"
+#include <set>
+
+namespace msr { namespace airlib {
+
+/*
+    Replays a recorded RPC session against a server and measures how long each call takes.
+
+    Calls are sent with the arguments they were recorded with, each at its recorded start time divided by the
+    speed; a speed of 0 sends the next call as soon as a connection is free. Several connections replay at once
+    so that calls which block, like moveToPosition, don't hold up the ones the client made meanwhile; with one
+    connection calls are strictly in the recorded order. Latencies are measured at the client, so they include
+    the network round trip that the recorded server side latencies don't.
+*/
+class RpcSessionReplayer {
+public:
+    struct Options {
+        double speed = 1;
+        uint connection_count = 4;
+        float timeout_sec = 60;
+        std::set<std::string> methods;      //replays only these methods, all if empty
+    };
+
+    struct Result {
+        RpcLatencyReport recorded;
+        RpcLatencyReport replayed;
+        uint call_count = 0;
+        uint failed_count = 0;              //calls the server rejected or that timed out
+        double seconds = 0;                 //wall time of the replay
+        bool truncated_log = false;
+    };
+
+public:
+    RpcSessionReplayer(const std::string& ip_address = "localhost", uint16_t port = 41451);
+    ~RpcSessionReplayer();    //required for pimpl
+
+    Result replay(const std::string& file_path, const Options& options);
+    Result replay(const vector<RpcCallRecord>& records, const Options& options);
+
+private:
+    struct impl;
+    std::unique_ptr<impl> pimpl_;
+};
+
+}} //namespace
+#endif
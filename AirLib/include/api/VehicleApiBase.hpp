@@ -8,6 +8,7 @@
 #include "common/UpdatableObject.hpp"
 #include "common/Common.hpp"
 #include "common/Waiter.hpp"
+#include "common/ControlSchedule.hpp"
 #include "safety/SafetyEval.hpp"
 #include "common/CommonStructs.hpp"
 #include "common/ImageCaptureBase.hpp"
@@ -71,6 +72,12 @@ public:
         throw VehicleCommandNotImplementedException("getActuatorCount API is not supported for this vehicle");
     }
 
+    //for vehicles that take setpoints uploaded ahead of time and executed by update()
+    virtual ControlScheduleStatus getControlScheduleStatus() const
+    {
+        throw VehicleCommandNotImplementedException("getControlScheduleStatus API is not supported for this vehicle");
+    }
+
     virtual void getStatusMessages(std::vector<std::string>& messages)
     {
         unused(messages);
@@ -46,6 +46,14 @@ public:
     virtual void charSetFacePresets(const std::unordered_map<std::string, float>& presets, const std::string& character_name) = 0;
     virtual void charSetBonePoses(const std::unordered_map<std::string, msr::airlib::Pose>& poses, const std::string& character_name) = 0;
     virtual std::unordered_map<std::string, msr::airlib::Pose> charGetBonePoses(const std::vector<std::string>& bone_names, const std::string& character_name) const = 0;
+    //bone indices are positions in charGetBoneNames(), looked up once so streamed poses don't carry names
+    virtual std::vector<std::string> charGetBoneNames(const std::string& character_name) const = 0;
+    virtual void charSetBonePosesByIndex(const std::vector<int>& bone_indices, const std::vector<msr::airlib::Pose>& poses, const std::string& character_name) = 0;
+    virtual std::vector<msr::airlib::Pose> charGetBonePosesByIndex(const std::vector<int>& bone_indices, const std::string& character_name) const = 0;
+    //BVH clips played by the simulator every frame, lengths in the file are multiplied by scale
+    virtual void charPlayMotionClip(const std::string& clip_file, float scale, float rate, bool loop, const std::string& character_name) = 0;
+    virtual void charSetMotionClipTimeWarp(const std::vector<float>& play_times, const std::vector<float>& clip_times, const std::string& character_name) = 0;
+    virtual void charStopMotionClip(const std::string& character_name) = 0;
 
 };
 
@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_EventCameraEmulator_hpp
+#define air_EventCameraEmulator_hpp
+
+#include "common/Common.hpp"
+#include "common/AirSimSettings.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    EventCameraEmulator turns consecutive frames of one camera into the output of a dynamic vision sensor (DVS).
+
+    Each pixel keeps the log intensity at which it last fired. Between two frames the log intensity of a pixel is
+    interpolated linearly in time, and an ON or OFF event is emitted at each moment it moves a contrast threshold
+    above or below that reference, which then moves to the crossed level. After an event a pixel is blind for the
+    refractory period; a change it missed fires once at the end of the period and resets the reference to the
+    intensity at that time. Thresholds vary from pixel to pixel by threshold_sigma, and background activity adds
+    events at random pixels and times without changing any reference.
+
+    Pixels whose reference is not crossed during a frame, nearly all of them in most scenes, are found four at a
+    time with SSE2 so only the rest go through the scalar event loop.
+*/
+class EventCameraEmulator {
+public: //types
+    struct Event {
+        uint32_t time_offset = 0; //microseconds after EventPacket::start_time
+        uint16_t x = 0;
+        uint16_t y = 0; //row 0 is the top of the image, at most 32767
+        bool on = false; //polarity, true when the pixel got brighter
+    };
+
+    //events between two frames, sorted by time
+    struct EventPacket {
+        TTimePoint start_time = 0; //time stamp of the previous frame
+        TTimePoint end_time = 0; //time stamp of this frame
+        int width = 0, height = 0;
+        //one word per event: bits 0-15 x, bits 16-30 y, bit 31 polarity and bits 32-63 time_offset, so sorting the
+        //words sorts the events by time
+        vector<uint64_t> events;
+    };
+
+    //most events one pixel can emit between two frames, to bound the packet size of large changes
+    static constexpr uint MaxEventsPerPixel = 255;
+
+public:
+    static uint64_t packEvent(const Event& event)
+    {
+        return (static_cast<uint64_t>(event.time_offset) << 32) | (static_cast<uint64_t>(event.on ? 1 : 0) << 31)
+            | (static_cast<uint64_t>(event.y & 0x7fff) << 16) | event.x;
+    }
+
+    static Event unpackEvent(uint64_t word)
+    {
+        Event event;
+        event.time_offset = static_cast<uint32_t>(word >> 32);
+        event.on = ((word >> 31) & 1) != 0;
+        event.y = static_cast<uint16_t>((word >> 16) & 0x7fff);
+        event.x = static_cast<uint16_t>(word & 0xffff);
+        return event;
+    }
+
+public:
+    EventCameraEmulator(const AirSimSettings::EventCameraSetting& setting = AirSimSettings::EventCameraSetting());
+    ~EventCameraEmulator();
+
+    //forgets the reference of every pixel, the next frame starts a new sequence
+    void reset();
+
+    /*
+        Adds the next frame and returns the events since the previous one. Frames are 8 bit gray, RGB or RGBA
+        depending on channels, with rows from the top of the image. The first frame, a frame of a different size
+        or a frame older than the previous one starts a new sequence and has no events; a frame with the same time
+        stamp as the previous one is ignored.
+    */
+    void addFrame(const uint8_t* pixels, int width, int height, int channels, TTimePoint time_stamp, EventPacket& packet);
+
+    //frame as ImageCaptureBase returns it for an uncompressed Scene request
+    void addFrame(const vector<uint8_t>& pixels, int width, int height, TTimePoint time_stamp, EventPacket& packet);
+
+private:
+    struct impl;
+    std::unique_ptr<impl> pimpl_;
+};
+
+}} //namespace
+#endif
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_OpticalFlowGenerator_hpp
+#define air_OpticalFlowGenerator_hpp
+
+#include "common/Common.hpp"
+#include "common/CommonStructs.hpp"
+#include "common/AirSimSettings.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    OpticalFlowGenerator computes ground truth optical flow of one camera from its planar depth and its motion
+    since the previous capture, assuming the rest of the scene is static.
+
+    The pixel center (u, v) of the current frame is back projected with its depth, moved into the previous camera
+    frame and projected again; the flow of the pixel is (u, v) minus that projection, so the point seen at (u, v)
+    was at (u - flow_u, v - flow_v) in the previous frame. The math is done with inverse depth, so pixels that see
+    nothing (infinite depth) only move with the camera rotation. Pixels whose point was behind the previous camera,
+    pixels without a valid depth and pixels of masked object IDs get nan flow; masking is for objects that move on
+    their own, whose flow the camera motion does not explain.
+
+    Rows are split between threads and each row is computed four pixels at a time with SSE2.
+*/
+class OpticalFlowGenerator {
+public: //types
+    //pinhole intrinsics in pixels, with pixel centers at +0.5
+    struct Intrinsics {
+        float fx = 0, fy = 0; //pixels per unit of y / x and z / x in the camera frame
+        float cx = 0, cy = 0;
+
+        Intrinsics()
+        {
+        }
+
+        Intrinsics(float fx_val, float fy_val, float cx_val, float cy_val)
+            : fx(fx_val), fy(fy_val), cx(cx_val), cy(cy_val)
+        {
+        }
+
+        //from a perspective matrix of APIPCamera::getProjectionMatrix for an image of width x height pixels
+        static Intrinsics fromProjectionMatrix(const ProjectionMatrix& projection, int width, int height);
+    };
+
+    struct Frame {
+        const float* planar_depth = nullptr; //width * height meters, like a DepthPlanner float image
+        //optional, object ID of pixel i at object_ids[i * object_id_stride], 4 for the R channel of an RGBA Infrared image
+        const uint8_t* object_ids = nullptr;
+        int object_id_stride = 1;
+        int width = 0, height = 0;
+        Intrinsics intrinsics;
+        Pose pose; //camera in world NED
+    };
+
+public:
+    OpticalFlowGenerator(const AirSimSettings::OpticalFlowSetting& setting = AirSimSettings::OpticalFlowSetting());
+    ~OpticalFlowGenerator();
+
+    //forgets the previous pose, the next frame has zero flow
+    void reset();
+
+    //0 uses one thread per core
+    void setThreadCount(uint thread_count);
+
+    //true when the setting masks some object IDs, so frames need them
+    bool needsObjectIDs() const;
+
+    //flow since the previous frame as interleaved u, v pixels per pixel, rows from the top of the image
+    void addFrame(const Frame& frame, vector<float>& flow);
+
+    //flow of frame for a camera that was at previous_pose, without changing the previous pose
+    void computeFlow(const Frame& frame, const Pose& previous_pose, vector<float>& flow) const;
+
+private:
+    struct impl;
+    std::unique_ptr<impl> pimpl_;
+};
+
+}} //namespace
+#endif
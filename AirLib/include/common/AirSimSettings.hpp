@@ -76,6 +76,15 @@ public: //types
         bool allow_api_when_disconnected = false;
     };
 
+    //nan keeps the gain built in to simple_flight
+    struct SimpleFlightGains {
+        Vector3r angle_rate_p = VectorMath::nanVector(); //roll, pitch, yaw
+        Vector3r angle_level_p = VectorMath::nanVector(); //roll, pitch, yaw
+        Vector3r velocity_p = VectorMath::nanVector(); //x, y, z
+        Vector3r velocity_i = VectorMath::nanVector(); //x, y, z
+        Vector3r position_p = VectorMath::nanVector(); //x, y, z
+    };
+
     struct Rotation {
         float yaw = 0;
         float pitch = 0;
@@ -159,6 +168,21 @@ public: //types
         float HorzDistortionStrength = 0.002f;
     };
 
+    //DVS emulation of the Scene images of a camera, see EventCameraEmulator
+    struct EventCameraSetting {
+        float contrast_threshold_on = 0.2f; //change of log intensity for an ON event
+        float contrast_threshold_off = 0.2f;
+        float threshold_sigma = 0.03f; //pixel to pixel variation of the thresholds
+        float refractory_period = 0.001f; //sec
+        float background_rate = 0.1f; //noise events per second per pixel
+    };
+
+    //OpticalFlow images of a camera, see OpticalFlowGenerator
+    struct OpticalFlowSetting {
+        //segmentation IDs of objects that move on their own, their pixels get nan flow
+        std::vector<int> masked_object_ids;
+    };
+
     struct CameraSetting {
         //nan means keep the default values set in components
         Vector3r position = VectorMath::nanVector();
@@ -169,6 +193,8 @@ public: //types
         GimbalSetting gimbal;
         std::map<int, CaptureSetting> capture_settings;
         std::map<int, NoiseSetting>  noise_settings;
+        EventCameraSetting event_camera;
+        OpticalFlowSetting optical_flow;
 
         CameraSetting()
         {
@@ -194,6 +220,10 @@ public: //types
     };
 
     struct ImuSetting : SensorSetting {
+        float sample_rate = 0;          // internal samples per second, 0 to sample once per update
+        float anti_alias_cutoff = 250;  // Hz, 0 for no anti-alias filter
+        float vibration_accel = 0;      // m/s^2 per rotor at full rotor speed
+        float vibration_gyro = 0;       // rad/s per rotor at full rotor speed
     };
 
     struct GpsSetting : SensorSetting {
@@ -215,6 +245,58 @@ public: //types
         Rotation rotation = Rotation::nanRotation();
     };
 
+    struct DistanceArraySetting : SensorSetting {
+        std::string pattern = "Grid";       // "Grid" of zones or "Cone"
+        uint zone_rows = 4;
+        uint zone_cols = 4;
+        uint rays_per_zone_side = 4;        // each zone is sampled by the square of this many rays
+        float horizontal_fov = 45.0f;       // degrees
+        float vertical_fov = 45.0f;         // degrees
+        float cone_angle = 30.0f;           // full angle in degrees
+        uint cone_rays = 64;
+        std::string reduction = "Min";      // "Min" or "Mean" of the returns in a zone
+        float max_distance = 4.0f;
+        float min_distance = 0.02f;
+        float noise_sigma = 0.005f;         // m at zero range
+        float noise_growth = 0.002f;        // m of sigma per m^2 of range
+        float multipath_dropout = 0.5f;     // probability that a ray at grazing incidence doesn't return
+        float update_frequency = 15.0f;
+        float update_latency = 0.0f;
+        float startup_delay = 0.0f;
+        bool draw_debug_points = false;
+        bool ignore_pawn_collision = true;
+        Vector3r position = VectorMath::nanVector();
+        Rotation rotation = Rotation::nanRotation();
+    };
+
+    struct JointChannelSetting {
+        std::string joint_name;
+        float resolution = 0;           // radians or meters per count, 0 for none
+        float noise_sigma = 0;
+        float bias = 0;
+        float range = 0;                // full scale, 0 for none
+    };
+
+    struct JointSensorSetting : SensorSetting {
+        float update_frequency = 100.0f;
+        float update_latency = 0.0f;
+        float startup_delay = 0.0f;
+        std::vector<JointChannelSetting> joints;
+    };
+
+    struct JointEncoderSetting : JointSensorSetting {
+    };
+
+    struct JointTorqueSetting : JointSensorSetting {
+    };
+
+    struct ContactSetting : SensorSetting {
+        float update_frequency = 100.0f;
+        float update_latency = 0.0f;
+        float startup_delay = 0.0f;
+        std::vector<std::string> links;
+    };
+
     struct LidarSetting : SensorSetting {
 
         // shared defaults
@@ -261,6 +343,7 @@ public: //types
         std::vector<std::pair<std::string, std::string>> collision_blacklist;
 
         RCSettings rc;
+        SimpleFlightGains gains;
     };
 
     struct MavLinkConnectionInfo {
@@ -336,6 +419,12 @@ public: //types
         std::map<std::string, std::string> configuration;
     };
 
+    //-1 keeps the server default
+    struct RpcLaneSetting {
+        int worker_count = -1;
+        int queue_limit = -1;
+    };
+
 private: //fields
     float settings_version_actual;
     float settings_version_minimum = 1.2f;
@@ -369,6 +458,8 @@ public: //fields
     float speed_unit_factor =  1.0f;
     std::string speed_unit_label = "m\\s";
     std::map<std::string, std::unique_ptr<SensorSetting>> sensor_defaults;
+    std::map<std::string, RpcLaneSetting> rpc_lanes;        //by lane name
+    std::map<std::string, std::string> rpc_method_lanes;    //lane name of each method moved from its default lane
 
 public: //methods
     static AirSimSettings& singleton() 
@@ -573,6 +664,24 @@ private:
         }
     }
 
+    static void loadSimpleFlightGains(const Settings& settings_json, SimpleFlightGains& gains)
+    {
+        Settings gains_json;
+        if (settings_json.getChild("Gains", gains_json)) {
+            Settings axes_json;
+            if (gains_json.getChild("AngleRateP", axes_json))
+                gains.angle_rate_p = createRollPitchYawSetting(axes_json, gains.angle_rate_p);
+            if (gains_json.getChild("AngleLevelP", axes_json))
+                gains.angle_level_p = createRollPitchYawSetting(axes_json, gains.angle_level_p);
+            if (gains_json.getChild("VelocityP", axes_json))
+                gains.velocity_p = createVectorSetting(axes_json, gains.velocity_p);
+            if (gains_json.getChild("VelocityI", axes_json))
+                gains.velocity_i = createVectorSetting(axes_json, gains.velocity_i);
+            if (gains_json.getChild("PositionP", axes_json))
+                gains.position_p = createVectorSetting(axes_json, gains.position_p);
+        }
+    }
+
     static std::string getCameraName(const Settings& settings_json)
     {
         return settings_json.getString("CameraName", 
@@ -692,6 +801,13 @@ private:
             settings_json.getFloat("Roll", default_rot.roll));
     }
 
+    static Vector3r createRollPitchYawSetting(const Settings& settings_json, const Vector3r& default_vec)
+    {
+        return Vector3r(settings_json.getFloat("Roll", default_vec.x()),
+            settings_json.getFloat("Pitch", default_vec.y()),
+            settings_json.getFloat("Yaw", default_vec.z()));
+    }
+
     static std::unique_ptr<VehicleSetting> createVehicleSetting(const std::string& simmode_name,  const Settings& settings_json,
         const std::string vehicle_name)
     {
@@ -708,6 +824,8 @@ private:
                 //TODO: we should be selecting remote if available else keyboard
                 //currently keyboard is not supported so use rc as default
                 vehicle_setting->rc.remote_control_id = 0;
+
+                loadSimpleFlightGains(settings_json, vehicle_setting->gains);
             }
             else if (vehicle_type == kVehicleTypeUrdfBot) {
                 vehicle_setting->debug_symbol_scale = settings_json.getFloat("DebugSymbolScale", 0.0f);
@@ -954,6 +1072,24 @@ private:
         return gimbal;
     }
 
+    static EventCameraSetting createEventCameraSetting(const Settings& settings_json)
+    {
+        EventCameraSetting event_camera;
+        event_camera.contrast_threshold_on = settings_json.getFloat("ContrastThresholdOn", event_camera.contrast_threshold_on);
+        event_camera.contrast_threshold_off = settings_json.getFloat("ContrastThresholdOff", event_camera.contrast_threshold_off);
+        event_camera.threshold_sigma = settings_json.getFloat("ThresholdSigma", event_camera.threshold_sigma);
+        event_camera.refractory_period = settings_json.getFloat("RefractoryPeriod", event_camera.refractory_period);
+        event_camera.background_rate = settings_json.getFloat("BackgroundRate", event_camera.background_rate);
+        return event_camera;
+    }
+
+    static OpticalFlowSetting createOpticalFlowSetting(const Settings& settings_json)
+    {
+        OpticalFlowSetting optical_flow;
+        optical_flow.masked_object_ids = settings_json.getIntArray("MaskedObjectIDs", optical_flow.masked_object_ids);
+        return optical_flow;
+    }
+
     static CameraSetting createCameraSetting(const Settings& settings_json)
     {
         CameraSetting setting;
@@ -966,6 +1102,12 @@ private:
         Settings json_gimbal;
         if (settings_json.getChild("Gimbal", json_gimbal))
             setting.gimbal = createGimbalSetting(json_gimbal);
+        Settings json_event_camera;
+        if (settings_json.getChild("EventCamera", json_event_camera))
+            setting.event_camera = createEventCameraSetting(json_event_camera);
+        Settings json_optical_flow;
+        if (settings_json.getChild("OpticalFlow", json_optical_flow))
+            setting.optical_flow = createOpticalFlowSetting(json_optical_flow);
 
         setting.attach_link = settings_json.getString("AttachLink", "");
 
@@ -1078,6 +1220,32 @@ private:
                 tod_setting.update_interval_secs = tod_settings_json.getFloat("UpdateIntervalSecs", tod_setting.update_interval_secs);
             }
         }
+
+        {   //RPC dispatch lanes
+            rpc_lanes.clear();
+            Settings lanes_json;
+            if (settings_json.getChild("RpcLanes", lanes_json)) {
+                std::vector<std::string> lane_names;
+                lanes_json.getChildNames(lane_names);
+                for (const auto& lane_name : lane_names) {
+                    Settings lane_json;
+                    if (lanes_json.getChild(lane_name, lane_json)) {
+                        RpcLaneSetting& lane = rpc_lanes[lane_name];
+                        lane.worker_count = lane_json.getInt("Workers", lane.worker_count);
+                        lane.queue_limit = lane_json.getInt("QueueLimit", lane.queue_limit);
+                    }
+                }
+            }
+
+            rpc_method_lanes.clear();
+            Settings methods_json;
+            if (settings_json.getChild("RpcMethodLanes", methods_json)) {
+                std::vector<std::string> method_names;
+                methods_json.getChildNames(method_names);
+                for (const auto& method_name : method_names)
+                    rpc_method_lanes[method_name] = methods_json.getString(method_name, "");
+            }
+        }
     }
 
     static void loadDefaultCameraSetting(const Settings& settings_json, CameraSetting& camera_defaults)
@@ -1157,10 +1325,10 @@ private:
 
     static void initializeImuSetting(ImuSetting& imu_setting, const Settings& settings_json)
     {
-        unused(imu_setting);
-        unused(settings_json);
-
-        //TODO: set from json as needed
+        imu_setting.sample_rate = settings_json.getFloat("SampleRate", imu_setting.sample_rate);
+        imu_setting.anti_alias_cutoff = settings_json.getFloat("AntiAliasCutoff", imu_setting.anti_alias_cutoff);
+        imu_setting.vibration_accel = settings_json.getFloat("VibrationAccel", imu_setting.vibration_accel);
+        imu_setting.vibration_gyro = settings_json.getFloat("VibrationGyro", imu_setting.vibration_gyro);
     }
 
     static void initializeGpsSetting(GpsSetting& gps_setting, const Settings& settings_json)
@@ -1194,6 +1362,79 @@ private:
         distance_setting.rotation = createRotationSetting(settings_json, distance_setting.rotation);
     }
 
+    static void initializeDistanceArraySetting(DistanceArraySetting& setting, const Settings& settings_json)
+    {
+        setting.pattern = settings_json.getString("Pattern", setting.pattern);
+        setting.zone_rows = settings_json.getInt("ZoneRows", setting.zone_rows);
+        setting.zone_cols = settings_json.getInt("ZoneCols", setting.zone_cols);
+        setting.rays_per_zone_side = settings_json.getInt("RaysPerZoneSide", setting.rays_per_zone_side);
+        setting.horizontal_fov = settings_json.getFloat("HorizontalFOV", setting.horizontal_fov);
+        setting.vertical_fov = settings_json.getFloat("VerticalFOV", setting.vertical_fov);
+        setting.cone_angle = settings_json.getFloat("ConeAngle", setting.cone_angle);
+        setting.cone_rays = settings_json.getInt("ConeRays", setting.cone_rays);
+        setting.reduction = settings_json.getString("Reduction", setting.reduction);
+        setting.max_distance = settings_json.getFloat("MaxDistance", setting.max_distance);
+        setting.min_distance = settings_json.getFloat("MinDistance", setting.min_distance);
+        setting.noise_sigma = settings_json.getFloat("NoiseSigma", setting.noise_sigma);
+        setting.noise_growth = settings_json.getFloat("NoiseGrowth", setting.noise_growth);
+        setting.multipath_dropout = settings_json.getFloat("MultipathDropout", setting.multipath_dropout);
+        setting.update_frequency = settings_json.getFloat("UpdateFrequency", setting.update_frequency);
+        setting.update_latency = settings_json.getFloat("UpdateLatency", setting.update_latency);
+        setting.startup_delay = settings_json.getFloat("StartupDelay", setting.startup_delay);
+        setting.draw_debug_points = settings_json.getBool("DrawDebugPoints", setting.draw_debug_points);
+        setting.ignore_pawn_collision = settings_json.getBool("IgnorePawnCollision", setting.ignore_pawn_collision);
+        setting.position = createVectorSetting(settings_json, setting.position);
+        setting.rotation = createRotationSetting(settings_json, setting.rotation);
+    }
+
+    // sensor level noise and quantization are the defaults for each entry of "Joints"
+    static JointChannelSetting createJointChannelSetting(const Settings& settings_json, const JointChannelSetting& defaults)
+    {
+        JointChannelSetting channel = defaults;
+        float counts_per_revolution = settings_json.getFloat("CountsPerRevolution", 0);
+        if (counts_per_revolution > 0)
+            channel.resolution = 2 * M_PIf / counts_per_revolution;
+        channel.resolution = settings_json.getFloat("Resolution", channel.resolution);
+        channel.noise_sigma = settings_json.getFloat("NoiseSigma", channel.noise_sigma);
+        channel.bias = settings_json.getFloat("Bias", channel.bias);
+        channel.range = settings_json.getFloat("Range", channel.range);
+        return channel;
+    }
+
+    static void initializeJointSensorSetting(JointSensorSetting& joint_setting, const Settings& settings_json)
+    {
+        joint_setting.update_frequency = settings_json.getFloat("UpdateFrequency", joint_setting.update_frequency);
+        joint_setting.update_latency = settings_json.getFloat("UpdateLatency", joint_setting.update_latency);
+        joint_setting.startup_delay = settings_json.getFloat("StartupDelay", joint_setting.startup_delay);
+
+        JointChannelSetting defaults = createJointChannelSetting(settings_json, JointChannelSetting());
+
+        joint_setting.joints.clear();
+        Settings joints_child;
+        if (settings_json.getChild("Joints", joints_child)) {
+            std::vector<std::string> keys;
+            joints_child.getChildNames(keys);
+            for (const auto& key : keys) {
+                Settings child;
+                joints_child.getChild(key, child);
+                joint_setting.joints.push_back(createJointChannelSetting(child, defaults));
+                joint_setting.joints.back().joint_name = key;
+            }
+        }
+    }
+
+    static void initializeContactSetting(ContactSetting& contact_setting, const Settings& settings_json)
+    {
+        contact_setting.update_frequency = settings_json.getFloat("UpdateFrequency", contact_setting.update_frequency);
+        contact_setting.update_latency = settings_json.getFloat("UpdateLatency", contact_setting.update_latency);
+        contact_setting.startup_delay = settings_json.getFloat("StartupDelay", contact_setting.startup_delay);
+
+        contact_setting.links.clear();
+        Settings links_child;
+        if (settings_json.getChild("Links", links_child))
+            links_child.getChildNames(contact_setting.links);
+    }
+
     static void initializeLidarSetting(LidarSetting& lidar_setting, const Settings& settings_json)
     {
         lidar_setting.number_of_channels = settings_json.getInt("NumberOfChannels", lidar_setting.number_of_channels);
@@ -1239,6 +1480,18 @@ private:
         case SensorBase::SensorType::Lidar:
             sensor_setting = std::unique_ptr<SensorSetting>(new LidarSetting());
             break;
+        case SensorBase::SensorType::JointEncoder:
+            sensor_setting = std::unique_ptr<SensorSetting>(new JointEncoderSetting());
+            break;
+        case SensorBase::SensorType::JointTorque:
+            sensor_setting = std::unique_ptr<SensorSetting>(new JointTorqueSetting());
+            break;
+        case SensorBase::SensorType::Contact:
+            sensor_setting = std::unique_ptr<SensorSetting>(new ContactSetting());
+            break;
+        case SensorBase::SensorType::DistanceArray:
+            sensor_setting = std::unique_ptr<SensorSetting>(new DistanceArraySetting());
+            break;
         default:
             throw std::invalid_argument("Unexpected sensor type");
         }
@@ -1274,6 +1527,16 @@ private:
         case SensorBase::SensorType::Lidar:
             initializeLidarSetting(*static_cast<LidarSetting*>(sensor_setting), settings_json);
             break;
+        case SensorBase::SensorType::JointEncoder:
+        case SensorBase::SensorType::JointTorque:
+            initializeJointSensorSetting(*static_cast<JointSensorSetting*>(sensor_setting), settings_json);
+            break;
+        case SensorBase::SensorType::Contact:
+            initializeContactSetting(*static_cast<ContactSetting*>(sensor_setting), settings_json);
+            break;
+        case SensorBase::SensorType::DistanceArray:
+            initializeDistanceArraySetting(*static_cast<DistanceArraySetting*>(sensor_setting), settings_json);
+            break;
         default:
             throw std::invalid_argument("Unexpected sensor type");
         }
@@ -6,6 +6,7 @@
 
 #include <thread>
 #include <chrono>
+#include <atomic>
 #include "Common.hpp"
 
 namespace msr { namespace airlib {
@@ -19,6 +20,7 @@ public:
 
 
     ClockBase()
+        : step_count_(0)
     {
         wall_clock_start_ = Utils::getTimeSinceEpochNanos();
     }
@@ -35,6 +37,17 @@ public:
     {
         return static_cast<TTimePoint>(t + dt * 1.0E9);
     }
+    //time point a nanosecond before elapsedBetween(result, t) reaches dt, so it is never late because of rounding
+    static TTimePoint addToEarliest(TTimePoint t, TTimeDelta dt)
+    {
+        const TTimePoint never = std::numeric_limits<TTimePoint>::max();
+        TTimeDelta nanos = std::floor(dt * 1.0E9) - 1;
+        if (nanos <= 0)
+            return t;
+        if (nanos >= static_cast<TTimeDelta>(never - t))
+            return never;
+        return t + static_cast<TTimePoint>(nanos);
+    }
     TTimeDelta updateSince(TTimePoint& since) const
     {
         TTimePoint cur = nowNanos();
@@ -85,7 +98,7 @@ private:
     template <typename T>
     using duration = std::chrono::duration<T>;
 
-    uint64_t step_count_ = 0;
+    std::atomic<uint64_t> step_count_;
     TTimePoint wall_clock_start_;
 };
 
@@ -12,6 +12,7 @@ namespace msr { namespace airlib {
 class ClockFactory {
 public:
     //output of this function should not be stored as pointer might change
+    //while a world is updating on this thread this returns that world's clock domain
     static ClockBase* get(std::shared_ptr<ClockBase> val = nullptr)
     {
         static std::shared_ptr<ClockBase> clock;
@@ -19,17 +20,48 @@ public:
         if (val != nullptr)
             clock = val;
 
+        ClockBase* domain = threadDomain();
+        if (domain != nullptr)
+            return domain;
+
         if (clock == nullptr)
             clock = std::make_shared<ScalableClock>();
 
         return clock.get();
     }
 
+    //makes get() return the given clock on this thread until the scope ends, nullptr keeps the current one
+    class DomainScope {
+    public:
+        DomainScope(ClockBase* domain)
+            : previous_(threadDomain())
+        {
+            if (domain != nullptr)
+                threadDomain() = domain;
+        }
+        ~DomainScope()
+        {
+            threadDomain() = previous_;
+        }
+
+        DomainScope(DomainScope const&) = delete;
+        void operator=(DomainScope const&) = delete;
+
+    private:
+        ClockBase* previous_;
+    };
+
     //don't allow multiple instances of this class
     ClockFactory(ClockFactory const&) = delete;
     void operator=(ClockFactory const&) = delete;
 
 private:
+    static ClockBase*& threadDomain()
+    {
+        static thread_local ClockBase* domain = nullptr;
+        return domain;
+    }
+
     //disallow instance creation
     ClockFactory(){}
 };
@@ -0,0 +1,177 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_ControlSchedule_hpp
+#define air_ControlSchedule_hpp
+
+#include "common/Common.hpp"
+#include "common/ClockBase.hpp"
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace msr { namespace airlib {
+
+//how a control schedule has been executed so far
+struct ControlScheduleStatus {
+    bool is_active = false;         //there are setpoints for now or later
+    uint pending_count = 0;         //setpoints whose time has not come yet
+    uint executed_count = 0;        //setpoints a step has started to apply
+    uint skipped_count = 0;         //setpoints that were over before any step applied them
+    double last_lag = 0;            //seconds from the stamp of the last started setpoint to the step that applied it
+    double max_lag = 0;
+    TTimePoint last_setpoint_time = 0;
+};
+
+/*
+    A buffer of future control setpoints stamped in sim time, consumed by the vehicle update loop.
+
+    Clients upload setpoints ahead of time and the update loop asks for the setpoint of each physics step, so the
+    commands a vehicle gets depend only on sim time and not on when the calls arrive. An upload replaces every
+    buffered setpoint at or after its first stamp, which suits controllers that replan a receding horizon.
+
+    Setpoints are held until the next one, or interpolated towards it. After the last setpoint the schedule stays
+    in force for the horizon of the upload and then expires, which step() reports once so the vehicle can fall
+    back to a safe command. Lag is the time from a setpoint's stamp to the first step that applies it; it is
+    below one physics step unless setpoints arrive late.
+
+    Uploads may come from any thread while the update loop steps the schedule.
+*/
+template<typename TSetpoint>
+class ControlSchedule {
+public:
+    enum class Interpolation : int {
+        Hold = 0,
+        Linear = 1
+    };
+
+    enum class StepResult {
+        Idle,       //nothing to apply
+        Setpoint,   //apply the setpoint
+        Expired     //the last setpoint and its horizon have passed
+    };
+
+    typedef std::function<TSetpoint(const TSetpoint& from, const TSetpoint& to, real_T alpha)> InterpolateFunction;
+
+public:
+    explicit ControlSchedule(InterpolateFunction interpolate)
+        : interpolate_(interpolate)
+    {
+    }
+
+    void upload(const vector<TTimePoint>& times, const vector<TSetpoint>& setpoints, Interpolation interpolation, double horizon)
+    {
+        if (times.size() != setpoints.size())
+            throw std::invalid_argument("Control schedule needs one time stamp for each setpoint");
+        if (times.empty())
+            throw std::invalid_argument("Control schedule has no setpoints");
+        for (size_t i = 1; i < times.size(); ++i) {
+            if (times[i] <= times[i - 1])
+                throw std::invalid_argument("Control schedule time stamps must be increasing");
+        }
+        if (interpolation != Interpolation::Hold && interpolation != Interpolation::Linear)
+            throw std::invalid_argument("Unknown control schedule interpolation");
+        if (!(horizon >= 0))
+            throw std::invalid_argument("Control schedule horizon can't be negative");
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (!points_.empty() && points_.back().time >= times.front())
+            points_.pop_back();
+        for (size_t i = 0; i < times.size(); ++i)
+            points_.push_back(Point{ times[i], setpoints[i], false });
+
+        interpolation_ = interpolation;
+        horizon_ = horizon;
+        status_.is_active = true;
+        updatePendingCount();
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        points_.clear();
+        status_.is_active = false;
+        status_.pending_count = 0;
+    }
+
+    //clears setpoints and counters
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        points_.clear();
+        status_ = ControlScheduleStatus();
+    }
+
+    StepResult step(TTimePoint now, TSetpoint& setpoint)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (points_.empty() || now < points_.front().time)
+            return StepResult::Idle;
+
+        //the setpoints before the latest one that has started are over
+        while (points_.size() > 1 && points_[1].time <= now) {
+            if (!points_.front().started)
+                ++status_.skipped_count;
+            points_.pop_front();
+        }
+
+        Point& current = points_.front();
+        if (points_.size() == 1 && ClockBase::elapsedBetween(now, current.time) > horizon_) {
+            if (!current.started)
+                ++status_.skipped_count;
+            points_.clear();
+            status_.is_active = false;
+            status_.pending_count = 0;
+            return StepResult::Expired;
+        }
+
+        if (!current.started) {
+            current.started = true;
+            ++status_.executed_count;
+            status_.last_lag = ClockBase::elapsedBetween(now, current.time);
+            status_.max_lag = std::max(status_.max_lag, status_.last_lag);
+            status_.last_setpoint_time = current.time;
+        }
+
+        if (interpolation_ == Interpolation::Linear && points_.size() > 1) {
+            const Point& next = points_[1];
+            real_T alpha = static_cast<real_T>(static_cast<double>(now - current.time) / (next.time - current.time));
+            setpoint = interpolate_(current.value, next.value, alpha);
+        }
+        else
+            setpoint = current.value;
+
+        updatePendingCount();
+        return StepResult::Setpoint;
+    }
+
+    ControlScheduleStatus getStatus() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return status_;
+    }
+
+private:
+    struct Point {
+        TTimePoint time;
+        TSetpoint value;
+        bool started;
+    };
+
+    //only the first setpoint can have started
+    void updatePendingCount()
+    {
+        status_.pending_count = static_cast<uint>(points_.size()) - (!points_.empty() && points_.front().started ? 1 : 0);
+    }
+
+private:
+    InterpolateFunction interpolate_;
+    std::deque<Point> points_;
+    Interpolation interpolation_ = Interpolation::Hold;
+    double horizon_ = 0;
+    ControlScheduleStatus status_;
+    mutable std::mutex mutex_;
+};
+
+}} //namespace
+#endif
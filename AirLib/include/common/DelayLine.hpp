@@ -69,6 +69,14 @@ public:
         return last_time_;
     }
 
+    //update() will not change the output before this time
+    TTimePoint getNextOutputTime() const
+    {
+        if (times_.empty())
+            return std::numeric_limits<TTimePoint>::max();
+        return ClockBase::addToEarliest(times_.front(), delay_);
+    }
+
     void push_back(const T& val, TTimePoint time_offset = 0)
     {
         values_.push_back(val);
@@ -111,6 +111,14 @@ public:
         return update_count_;
     }
 
+    //update() will not report a complete interval before this time, so calls before it may be skipped
+    TTimePoint getNextDueTime() const
+    {
+        real_T wait_sec = !startup_complete_ && Utils::isDefinitelyGreaterThan(startup_delay_, 0.0f)
+            ? startup_delay_ : interval_size_sec_;
+        return ClockBase::addToEarliest(last_time_, wait_sec);
+    }
+
 private:
     real_T interval_size_sec_;
     TTimeDelta elapsed_total_sec_;
@@ -22,6 +22,7 @@ public: //types
         Segmentation,
         SurfaceNormals,
         Infrared,
+        OpticalFlow,
         Count //must be last
     };
 
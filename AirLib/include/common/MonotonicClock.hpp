@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef airsim_core_MonotonicClock_hpp
+#define airsim_core_MonotonicClock_hpp
+
+#include "ClockBase.hpp"
+#include "Common.hpp"
+#include <atomic>
+#include <mutex>
+
+namespace msr { namespace airlib {
+
+//MonotonicClock is the clock domain of one simulated world. It runs off steady_clock
+//so changes to the system time never leak into simulation time, and its speed can
+//be changed at any time without the simulation time jumping.
+//nowNanos() returns the time sampled by the last step(), which World calls once per tick,
+//so everything updated in a tick sees the same time and reading it costs an atomic load.
+class MonotonicClock : public ClockBase {
+public:
+    //speed > 1 runs the simulation faster than the wall clock, < 1 slower and 0 stops it
+    //start is the simulation time of the first tick, by default nanoseconds since the Unix epoch
+    MonotonicClock(double speed = 1, TTimePoint start = 0)
+        : speed_(speed)
+    {
+        if (speed < 0)
+            throw std::invalid_argument("MonotonicClock speed must not be negative");
+
+        anchor_wall_ = std::chrono::steady_clock::now();
+        anchor_sim_ = start_ = start ? start : Utils::getTimeSinceEpochNanos();
+        current_ = start_;
+    }
+
+    virtual TTimePoint nowNanos() const override
+    {
+        return current_.load(std::memory_order_acquire);
+    }
+
+    virtual TTimePoint getStart() const override
+    {
+        return start_;
+    }
+
+    virtual TTimePoint step() override
+    {
+        ClockBase::step();
+
+        TTimePoint sampled = sampleNanos();
+        //never let a tick go backwards even if two threads step at once
+        TTimePoint current = current_.load(std::memory_order_relaxed);
+        while (sampled > current && !current_.compare_exchange_weak(current, sampled, std::memory_order_acq_rel))
+            ;
+        return current_.load(std::memory_order_acquire);
+    }
+
+    //reads the monotonic source directly instead of the time cached by the last step()
+    TTimePoint sampleNanos() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return simAt(std::chrono::steady_clock::now());
+    }
+
+    //the simulation time carries on from where it is now at the new speed
+    void setSpeed(double speed)
+    {
+        if (speed < 0)
+            throw std::invalid_argument("MonotonicClock speed must not be negative");
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto wall_now = std::chrono::steady_clock::now();
+        anchor_sim_ = simAt(wall_now);
+        anchor_wall_ = wall_now;
+        speed_ = speed;
+    }
+
+    double getSpeed() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return speed_;
+    }
+
+    virtual void sleep_for(TTimeDelta dt) override
+    {
+        if (dt <= 0)
+            return;
+
+        //nowNanos() only moves when the world ticks, so wait on the wall clock instead
+        double speed = getSpeed();
+        TTimeDelta wall_dt = speed > 0 ? dt / speed : dt;
+        std::this_thread::sleep_for(std::chrono::duration<double>(wall_dt));
+    }
+
+private:
+    //caller must hold mutex_
+    TTimePoint simAt(std::chrono::steady_clock::time_point wall_now) const
+    {
+        auto wall_elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(wall_now - anchor_wall_).count();
+        if (wall_elapsed <= 0)
+            return anchor_sim_;
+        return anchor_sim_ + static_cast<TTimePoint>(wall_elapsed * speed_);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::chrono::steady_clock::time_point anchor_wall_;
+    TTimePoint anchor_sim_;
+    double speed_;
+
+    std::atomic<TTimePoint> current_;
+    TTimePoint start_;
+};
+
+}} //namespace
+#endif
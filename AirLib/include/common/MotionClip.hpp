@@ -0,0 +1,290 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_MotionClip_hpp
+#define air_MotionClip_hpp
+
+#include "common/Common.hpp"
+#include "common/common_utils/Utils.hpp"
+#include <fstream>
+#include <sstream>
+
+namespace msr { namespace airlib {
+
+/*
+    A skeletal animation as a table of joint poses, one row per frame.
+
+    Each pose is local to the parent joint: the position is the offset of the joint in the parent frame plus any
+    translation channels of the frame, and the orientation is the rotation channels composed in the order the
+    file lists them. Parents always come before their children, so a single pass over the joints is enough to
+    build world poses.
+*/
+struct MotionClip {
+    struct Joint {
+        std::string name;
+        int parent = -1;
+        Vector3r offset = Vector3r::Zero();
+    };
+
+    vector<Joint> joints;
+    uint frame_count = 0;
+    double frame_time = 0;
+    //frame_count x joints.size() local poses, frame major
+    vector<Pose> poses;
+
+    //time from the first to the last frame
+    double getDuration() const
+    {
+        return frame_count > 1 ? (frame_count - 1) * frame_time : 0;
+    }
+
+    const Pose& getPose(uint frame, uint joint) const
+    {
+        return poses[frame * joints.size() + joint];
+    }
+
+    //-1 if the clip has no such joint
+    int getJointIndex(const std::string& joint_name) const
+    {
+        for (uint i = 0; i < joints.size(); ++i)
+            if (joints[i].name == joint_name)
+                return static_cast<int>(i);
+        return -1;
+    }
+};
+
+/*
+    Reads Biovision hierarchy (BVH) files in to a MotionClip.
+
+    Channel values are turned in to poses as they are read, so playing a clip never parses or composes Euler
+    angles again. Lengths are multiplied by the given scale, which lets centimeter captures drive meter skeletons.
+    Errors throw std::runtime_error with a "file:line: message" text.
+*/
+class BvhParser {
+public:
+    static MotionClip parseFile(const std::string& file_path, real_T scale = 1)
+    {
+        std::ifstream file(file_path);
+        if (!file)
+            throw std::runtime_error("Cannot open motion clip '" + file_path + "'.");
+        return parse(file, file_path, scale);
+    }
+
+    static MotionClip parseString(const std::string& text, const std::string& file_name = "<string>", real_T scale = 1)
+    {
+        std::istringstream stream(text);
+        return parse(stream, file_name, scale);
+    }
+
+    static MotionClip parse(std::istream& stream, const std::string& file_name, real_T scale = 1)
+    {
+        BvhParser parser(stream, file_name, scale);
+        parser.readHierarchy();
+        parser.readMotion();
+        return std::move(parser.clip_);
+    }
+
+private:
+    enum class Channel {
+        XPosition, YPosition, ZPosition, XRotation, YRotation, ZRotation
+    };
+
+    BvhParser(std::istream& stream, const std::string& file_name, real_T scale)
+        : stream_(stream), file_name_(file_name), scale_(scale)
+    {
+    }
+
+    void readHierarchy()
+    {
+        expect("HIERARCHY");
+        expect("ROOT");
+        readJoint(-1);
+
+        if (peek() == "ROOT")
+            fail("only one ROOT is supported");
+    }
+
+    void readJoint(int parent)
+    {
+        MotionClip::Joint joint;
+        joint.name = next("joint name");
+        joint.parent = parent;
+        if (clip_.getJointIndex(joint.name) >= 0)
+            fail("joint '" + joint.name + "' is defined twice");
+
+        expect("{");
+        expect("OFFSET");
+        joint.offset = readVector() * scale_;
+
+        const int index = static_cast<int>(clip_.joints.size());
+        clip_.joints.push_back(joint);
+        channels_.push_back(vector<Channel>());
+
+        if (peek() == "CHANNELS") {
+            next("CHANNELS");
+            int count = readInt("channel count");
+            if (count < 0 || count > 6)
+                fail("a joint can have at most 6 channels");
+            for (int i = 0; i < count; ++i)
+                channels_[index].push_back(readChannel());
+        }
+
+        while (true) {
+            std::string token = next("JOINT, End Site or }");
+            if (token == "}")
+                break;
+            else if (token == "JOINT")
+                readJoint(index);
+            else if (token == "End") {
+                //end sites only carry the length of the last bone, which poses don't need
+                expect("Site");
+                expect("{");
+                expect("OFFSET");
+                readVector();
+                expect("}");
+            }
+            else
+                fail("expected JOINT, End Site or } but found '" + token + "'");
+        }
+    }
+
+    void readMotion()
+    {
+        expect("MOTION");
+        expect("Frames:");
+        int frame_count = readInt("frame count");
+        if (frame_count < 1)
+            fail("a clip needs at least one frame");
+        expect("Frame");
+        expect("Time:");
+        clip_.frame_time = readReal("frame time");
+        if (!(clip_.frame_time > 0))
+            fail("frame time must be positive");
+
+        const uint joint_count = static_cast<uint>(clip_.joints.size());
+        clip_.frame_count = static_cast<uint>(frame_count);
+        clip_.poses.resize(clip_.frame_count * joint_count);
+        for (uint frame = 0; frame < clip_.frame_count; ++frame) {
+            for (uint joint = 0; joint < joint_count; ++joint) {
+                Pose& pose = clip_.poses[frame * joint_count + joint];
+                pose.position = clip_.joints[joint].offset;
+                for (Channel channel : channels_[joint]) {
+                    real_T value = readReal("channel value");
+                    applyChannel(channel, value, pose);
+                }
+            }
+        }
+
+        if (!peek().empty())
+            fail("unexpected '" + peek() + "' after the last frame");
+    }
+
+    void applyChannel(Channel channel, real_T value, Pose& pose) const
+    {
+        switch (channel) {
+        case Channel::XPosition: pose.position.x() += value * scale_; break;
+        case Channel::YPosition: pose.position.y() += value * scale_; break;
+        case Channel::ZPosition: pose.position.z() += value * scale_; break;
+        //rotations are intrinsic, in the order the channels are listed
+        case Channel::XRotation: pose.orientation *= VectorMath::toQuaternion(Vector3r::UnitX(), Utils::degreesToRadians(value)); break;
+        case Channel::YRotation: pose.orientation *= VectorMath::toQuaternion(Vector3r::UnitY(), Utils::degreesToRadians(value)); break;
+        case Channel::ZRotation: pose.orientation *= VectorMath::toQuaternion(Vector3r::UnitZ(), Utils::degreesToRadians(value)); break;
+        default: fail("unknown channel"); break;
+        }
+    }
+
+    Channel readChannel()
+    {
+        std::string name = next("channel name");
+        if (name == "Xposition") return Channel::XPosition;
+        if (name == "Yposition") return Channel::YPosition;
+        if (name == "Zposition") return Channel::ZPosition;
+        if (name == "Xrotation") return Channel::XRotation;
+        if (name == "Yrotation") return Channel::YRotation;
+        if (name == "Zrotation") return Channel::ZRotation;
+        fail("unknown channel '" + name + "'");
+        return Channel::XPosition;
+    }
+
+    Vector3r readVector()
+    {
+        real_T x = readReal("x");
+        real_T y = readReal("y");
+        real_T z = readReal("z");
+        return Vector3r(x, y, z);
+    }
+
+    real_T readReal(const char* what)
+    {
+        std::string token = next(what);
+        char* end = nullptr;
+        double value = std::strtod(token.c_str(), &end);
+        if (end == token.c_str() || *end != '\0' || !std::isfinite(value))
+            fail(std::string("expected a number for the ") + what + " but found '" + token + "'");
+        return static_cast<real_T>(value);
+    }
+
+    int readInt(const char* what)
+    {
+        std::string token = next(what);
+        char* end = nullptr;
+        long value = std::strtol(token.c_str(), &end, 10);
+        if (end == token.c_str() || *end != '\0')
+            fail(std::string("expected an integer for the ") + what + " but found '" + token + "'");
+        return static_cast<int>(value);
+    }
+
+    void expect(const std::string& expected)
+    {
+        std::string token = next(expected.c_str());
+        if (token != expected)
+            fail("expected '" + expected + "' but found '" + token + "'");
+    }
+
+    std::string next(const char* what)
+    {
+        std::string token = peek();
+        if (token.empty())
+            fail(std::string("unexpected end of file, expected ") + what);
+        token_.clear();
+        return token;
+    }
+
+    //empty at the end of the file
+    const std::string& peek()
+    {
+        if (!token_.empty())
+            return token_;
+
+        int c;
+        while ((c = stream_.get()) != EOF && std::isspace(c)) {
+            if (c == '\n')
+                ++line_;
+        }
+        while (c != EOF && !std::isspace(c)) {
+            token_.push_back(static_cast<char>(c));
+            c = stream_.get();
+        }
+        if (c == '\n')
+            stream_.unget();
+        return token_;
+    }
+
+    void fail(const std::string& message) const
+    {
+        throw std::runtime_error(file_name_ + ":" + std::to_string(line_) + ": " + message);
+    }
+
+private:
+    std::istream& stream_;
+    std::string file_name_;
+    real_T scale_;
+    uint line_ = 1;
+    std::string token_;
+
+    MotionClip clip_;
+    vector<vector<Channel>> channels_;
+};
+
+}} //namespace
+#endif
@@ -0,0 +1,248 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_MotionClipPlayer_hpp
+#define air_MotionClipPlayer_hpp
+
+#include "common/Common.hpp"
+#include "common/MotionClip.hpp"
+#include <map>
+
+namespace msr { namespace airlib {
+
+/*
+    Plays a MotionClip on a skeleton.
+
+    Play time advances by the elapsed time times the rate. An optional time warp then maps play time to clip time
+    through piecewise linear keys, so a clip can be slowed down, held or sped up in places without editing it;
+    past the last key clip time goes on at the speed of play time. Poses between two frames are interpolated,
+    positions linearly and orientations by slerp.
+
+    The clip joints are matched to the bones of a skeleton once with mapBones(), after which every update
+    produces the poses of the matched bones in the order of getBoneIndices(), ready to hand to the character.
+*/
+class MotionClipPlayer {
+public:
+    struct TimeWarpKey {
+        double play_time;
+        double clip_time;
+
+        TimeWarpKey(double play_time_val = 0, double clip_time_val = 0)
+            : play_time(play_time_val), clip_time(clip_time_val)
+        {
+        }
+    };
+
+public:
+    MotionClipPlayer()
+    {
+    }
+
+    explicit MotionClipPlayer(shared_ptr<const MotionClip> clip)
+    {
+        setClip(clip);
+    }
+
+    //starts from the beginning, with every clip joint mapped to the bone of the same index
+    void setClip(shared_ptr<const MotionClip> clip)
+    {
+        clip_ = clip;
+        const uint joint_count = clip_ ? static_cast<uint>(clip_->joints.size()) : 0;
+
+        joints_.clear();
+        bone_indices_.clear();
+        for (uint i = 0; i < joint_count; ++i) {
+            joints_.push_back(i);
+            bone_indices_.push_back(static_cast<int>(i));
+        }
+        bone_poses_.assign(joint_count, Pose());
+        seek(0);
+    }
+
+    const MotionClip* getClip() const
+    {
+        return clip_.get();
+    }
+
+    //matches clip joints to bones by name, falling back to a case insensitive match; returns the matched count
+    uint mapBones(const vector<std::string>& bone_names, const std::map<std::string, std::string>& renames = {})
+    {
+        std::map<std::string, int> exact, lower;
+        for (uint i = 0; i < bone_names.size(); ++i) {
+            exact.emplace(bone_names[i], static_cast<int>(i));
+            lower.emplace(Utils::toLower(bone_names[i]), static_cast<int>(i));
+        }
+
+        joints_.clear();
+        bone_indices_.clear();
+        const uint joint_count = clip_ ? static_cast<uint>(clip_->joints.size()) : 0;
+        for (uint joint = 0; joint < joint_count; ++joint) {
+            std::string name = clip_->joints[joint].name;
+            auto renamed = renames.find(name);
+            if (renamed != renames.end())
+                name = renamed->second;
+
+            auto found = exact.find(name);
+            if (found == exact.end()) {
+                found = lower.find(Utils::toLower(name));
+                if (found == lower.end())
+                    continue;
+            }
+
+            joints_.push_back(joint);
+            bone_indices_.push_back(found->second);
+        }
+        bone_poses_.assign(joints_.size(), Pose());
+        updatePoses();
+        return static_cast<uint>(joints_.size());
+    }
+
+    const vector<int>& getBoneIndices() const
+    {
+        return bone_indices_;
+    }
+
+    //local poses of the mapped bones at the current clip time
+    const vector<Pose>& getBonePoses() const
+    {
+        return bone_poses_;
+    }
+
+    //negative rates play backwards
+    void setRate(double rate)
+    {
+        rate_ = rate;
+    }
+
+    double getRate() const
+    {
+        return rate_;
+    }
+
+    void setLoop(bool loop)
+    {
+        loop_ = loop;
+        updatePoses();
+    }
+
+    //an empty list removes the warp
+    void setTimeWarp(const vector<TimeWarpKey>& keys)
+    {
+        checkTimeWarp(keys);
+        time_warp_ = keys;
+        updatePoses();
+    }
+
+    static void checkTimeWarp(const vector<TimeWarpKey>& keys)
+    {
+        for (uint i = 1; i < keys.size(); ++i) {
+            if (!(keys[i].play_time > keys[i - 1].play_time))
+                throw std::runtime_error("Time warp keys must have increasing play times.");
+        }
+    }
+
+    void seek(double play_time)
+    {
+        play_time_ = play_time;
+        updatePoses();
+    }
+
+    void update(double dt)
+    {
+        if (!clip_ || isFinished())
+            return;
+        play_time_ += dt * rate_;
+        updatePoses();
+    }
+
+    double getPlayTime() const
+    {
+        return play_time_;
+    }
+
+    //time in the clip the poses were taken at
+    double getClipTime() const
+    {
+        return clip_time_;
+    }
+
+    //a clip that doesn't loop is finished once it runs past its last frame, or its first when playing backwards
+    bool isFinished() const
+    {
+        if (!clip_)
+            return true;
+        if (loop_)
+            return false;
+        return rate_ >= 0 ? unwrapped_clip_time_ >= clip_->getDuration() : unwrapped_clip_time_ <= 0;
+    }
+
+    //clip time for a play time, before looping or clamping
+    double warpTime(double play_time) const
+    {
+        if (time_warp_.empty())
+            return play_time;
+        if (play_time <= time_warp_.front().play_time)
+            return time_warp_.front().clip_time;
+        if (play_time >= time_warp_.back().play_time)
+            return time_warp_.back().clip_time + (play_time - time_warp_.back().play_time);
+
+        auto upper = std::upper_bound(time_warp_.begin(), time_warp_.end(), play_time,
+            [](double t, const TimeWarpKey& key) { return t < key.play_time; });
+        const TimeWarpKey& b = *upper;
+        const TimeWarpKey& a = *(upper - 1);
+        return a.clip_time + (play_time - a.play_time) / (b.play_time - a.play_time) * (b.clip_time - a.clip_time);
+    }
+
+    //local pose of a clip joint at a clip time inside the clip
+    static Pose sample(const MotionClip& clip, uint joint, double clip_time)
+    {
+        if (clip.frame_count < 2)
+            return clip.getPose(0, joint);
+
+        double frame = Utils::clip(clip_time / clip.frame_time, 0.0, static_cast<double>(clip.frame_count - 1));
+        uint frame0 = std::min(static_cast<uint>(frame), clip.frame_count - 2);
+        real_T alpha = static_cast<real_T>(frame - frame0);
+
+        const Pose& from = clip.getPose(frame0, joint);
+        const Pose& to = clip.getPose(frame0 + 1, joint);
+        return Pose(VectorMath::lerp(from.position, to.position, alpha),
+            VectorMath::slerp(from.orientation, to.orientation, alpha));
+    }
+
+private:
+    void updatePoses()
+    {
+        if (!clip_)
+            return;
+
+        unwrapped_clip_time_ = warpTime(play_time_);
+        const double duration = clip_->getDuration();
+        if (loop_ && duration > 0) {
+            clip_time_ = std::fmod(unwrapped_clip_time_, duration);
+            if (clip_time_ < 0)
+                clip_time_ += duration;
+        }
+        else
+            clip_time_ = Utils::clip(unwrapped_clip_time_, 0.0, duration);
+
+        for (uint i = 0; i < joints_.size(); ++i)
+            bone_poses_[i] = sample(*clip_, joints_[i], clip_time_);
+    }
+
+private:
+    shared_ptr<const MotionClip> clip_;
+    vector<uint> joints_;
+    vector<int> bone_indices_;
+    vector<Pose> bone_poses_;
+
+    double rate_ = 1;
+    bool loop_ = false;
+    vector<TimeWarpKey> time_warp_;
+
+    double play_time_ = 0;
+    double unwrapped_clip_time_ = 0;
+    double clip_time_ = 0;
+};
+
+}} //namespace
+#endif
@@ -16,6 +16,10 @@ public:
     ScalableClock(double scale = 1, TTimeDelta latency = 0)
         : scale_(scale), latency_(latency)
     {
+        //wall time is read from steady_clock from here on so system clock adjustments don't move this clock
+        wall_start_ = Utils::getTimeSinceEpochNanos();
+        steady_start_ = std::chrono::steady_clock::now();
+
         offset_ = latency * (scale_ - 1);
         start_ = nowNanos();
 
@@ -25,7 +29,7 @@ public:
     virtual TTimePoint nowNanos() const override
     {
         if (offset_ == 0 && scale_ == 1) //optimized normal route
-            return Utils::getTimeSinceEpochNanos();
+            return wallNanos();
         else {
             /*
                 Apply scaling and latency.
@@ -34,7 +38,7 @@ public:
                 scaled time point is then given by (r + ((now - r) / scale)).
                 This becomes (r*(s-1) + now)/scale or (offset + now / scale).
             */
-            return static_cast<TTimePoint>((Utils::getTimeSinceEpochNanos() + offset_) / scale_);
+            return static_cast<TTimePoint>((wallNanos() + offset_) / scale_);
         }
     }
 
@@ -71,12 +75,20 @@ protected:
         return dt / scale_;
     }
 
+private:
+    TTimePoint wallNanos() const
+    {
+        return wall_start_ + static_cast<TTimePoint>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - steady_start_).count());
+    }
 
 private:
     double scale_;
     TTimeDelta latency_;
     double offset_;
     TTimePoint start_;
+    TTimePoint wall_start_;
+    std::chrono::steady_clock::time_point steady_start_;
 
 };
 
@@ -207,6 +207,16 @@ public:
         return return_value;
     }
 
+    std::vector<int> getIntArray(const std::string& name, const std::vector<int>& defaultValue) const
+    {
+        if (doc_.count(name) == 1) {
+            return doc_[name].get<std::vector<int>>();
+        }
+        else {
+            return defaultValue;
+        }
+    }
+
     bool hasKey(const std::string& key) const
     {
         return doc_.find(key) != doc_.end();
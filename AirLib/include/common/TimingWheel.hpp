@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef airsim_core_TimingWheel_hpp
+#define airsim_core_TimingWheel_hpp
+
+#include "common/Common.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    TimingWheel holds items until their due time in a ring of slots that each cover resolution seconds.
+    Scheduling an item and taking it out when due are O(1), and advancing only looks at the slots the clock
+    passed, so idle items cost nothing until their slot comes around. Items more than one turn ahead wait in
+    their slot for later turns. Times passed to advance() must not decrease.
+*/
+template<typename T>
+class TimingWheel {
+public:
+    TimingWheel(TTimeDelta resolution = 1E-3, uint slot_count = 256)
+        : resolution_nanos_(std::max<TTimePoint>(1, static_cast<TTimePoint>(resolution * 1.0E9))),
+        slots_(std::max(1u, slot_count))
+    {
+    }
+
+    //removes all items, later due times are relative to now
+    void clear(TTimePoint now = 0)
+    {
+        for (auto& slot : slots_)
+            slot.clear();
+        size_ = 0;
+        current_tick_ = now / resolution_nanos_;
+    }
+
+    //items due in the past are returned by the next advance()
+    void schedule(const T& item, TTimePoint due_time)
+    {
+        TTimePoint tick = std::max(current_tick_, due_time / resolution_nanos_);
+        slots_[tick % slots_.size()].push_back(Entry{ item, due_time });
+        ++size_;
+    }
+
+    //appends items due at or before now to due_items in no particular order
+    void advance(TTimePoint now, vector<T>& due_items)
+    {
+        TTimePoint now_tick = now / resolution_nanos_;
+        //after a full turn every slot has been looked at
+        TTimePoint last_tick = std::min(now_tick, current_tick_ + slots_.size() - 1);
+        for (TTimePoint tick = current_tick_; tick <= last_tick && size_ > 0; ++tick) {
+            vector<Entry>& slot = slots_[tick % slots_.size()];
+            for (size_t i = 0; i < slot.size();) {
+                if (slot[i].due_time <= now) {
+                    due_items.push_back(slot[i].item);
+                    slot[i] = slot.back();
+                    slot.pop_back();
+                    --size_;
+                }
+                else
+                    ++i;
+            }
+        }
+        current_tick_ = std::max(current_tick_, now_tick);
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+private:
+    struct Entry {
+        T item;
+        TTimePoint due_time;
+    };
+
+    TTimePoint resolution_nanos_;
+    vector<vector<Entry>> slots_;
+    TTimePoint current_tick_ = 0;
+    size_t size_ = 0;
+};
+
+}} //namespace
+#endif
@@ -12,17 +12,24 @@
 #include <memory>
 #include "common/CommonStructs.hpp"
 #include "common/SteppableClock.hpp"
+#include "raycast/SignedDistanceField.hpp"
 #include <cinttypes>
 
 namespace msr { namespace airlib {
 
 class FastPhysicsEngine : public PhysicsEngineBase {
 public:
-    FastPhysicsEngine(bool enable_ground_lock = true)
-        : enable_ground_lock_(enable_ground_lock)
+    FastPhysicsEngine(bool enable_ground_lock = true, std::shared_ptr<const SignedDistanceField> static_world = nullptr)
+        : enable_ground_lock_(enable_ground_lock), static_world_(static_world)
     { 
     }
 
+    //bodies also collide with this field every step, in addition to collisions reported by the renderer
+    void setStaticWorld(std::shared_ptr<const SignedDistanceField> static_world)
+    {
+        static_world_ = static_world;
+    }
+
     //*** Start: UpdatableState implementation ***//
     virtual void reset() override
     {
@@ -80,6 +87,10 @@ private:
         //this is necessary to take in to account forces and torques generated by body
         getNextKinematicsNoCollision(dt, body, current, next, next_wrench);
 
+        //report contacts with the static world along the move like the renderer would
+        if (static_world_ != nullptr)
+            updateStaticWorldCollision(body, current, next);
+
         //if there is collision, see if we need collision response
         const CollisionInfo collision_info = body.getCollisionInfo();
         CollisionResponse& collision_response = body.getCollisionResponseInfo();
@@ -107,6 +118,64 @@ private:
 		
 	}
 
+    void updateStaticWorldCollision(PhysicsBody& body, const Kinematics::State& current, const Kinematics::State& next) const
+    {
+        //the center and vertices of the body stand in for its shape
+        vector<Vector3r> probes(1, Vector3r::Zero());
+        for (uint i = 0; i < body.wrenchVertexCount(); ++i)
+            probes.push_back(body.getWrenchVertex(i).getPosition());
+        for (uint i = 0; i < body.dragVertexCount(); ++i)
+            probes.push_back(body.getDragVertex(i).getPosition());
+
+        //earliest contact, the deepest one if several probes start in contact
+        real_T contact_time = 2;
+        SignedDistanceField::Sample contact{ 0, Vector3r::Zero() };
+        Vector3r contact_point = Vector3r::Zero();
+        for (const Vector3r& probe : probes) {
+            const Vector3r start = current.pose.position + VectorMath::transformToWorldFrame(probe, current.pose.orientation);
+            const Vector3r end = next.pose.position + VectorMath::transformToWorldFrame(probe, next.pose.orientation);
+            real_T time;
+            SignedDistanceField::Sample sample;
+            if (sweepStaticWorld(start, end, time, sample)
+                && (time < contact_time || (time == contact_time && sample.distance < contact.distance))) {
+                contact_time = time;
+                contact = sample;
+                contact_point = start + (end - start) * time;
+            }
+        }
+        if (contact_time > 1)
+            return;
+
+        CollisionInfo collision_info;
+        collision_info.has_collided = true;
+        collision_info.normal = contact.normal;
+        collision_info.impact_point = contact_point - contact.normal * contact.distance;
+        collision_info.position = current.pose.position + (next.pose.position - current.pose.position) * contact_time;
+        collision_info.penetration_depth = std::max(0.0f, -contact.distance);
+        collision_info.time_stamp = clock()->nowNanos();
+        collision_info.collision_count = body.getCollisionInfo().collision_count + 1;
+        collision_info.object_name = "StaticWorld";
+        body.setCollisionInfo(collision_info);
+    }
+
+    //sphere traces a point of the body from start to end, returns the first time in [0, 1] it touches the static world
+    bool sweepStaticWorld(const Vector3r& start, const Vector3r& end, real_T& time, SignedDistanceField::Sample& sample) const
+    {
+        const real_T length = (end - start).norm();
+        const real_T skin = static_world_->getVoxelSize() * kStaticWorldSkin;
+        time = 0;
+        for (uint step = 0; step < kStaticWorldMaxSweepSteps; ++step) {
+            sample = static_world_->sample(start + (end - start) * time);
+            //deep inside bricks without samples there is no normal to respond with
+            if (sample.distance <= skin)
+                return sample.normal.squaredNorm() > 0;
+            if (time >= 1 || length == 0)
+                return false;
+            time = std::min(1.0f, time + sample.distance / length);
+        }
+        return false;
+    }
+
     static void updateCollisionResponseInfo(const CollisionInfo& collision_info, const Kinematics::State& next, 
         bool is_collision_response, CollisionResponse& collision_response)
     {
@@ -447,9 +516,12 @@ private:
     static constexpr float kAxisTolerance = 0.25f;
     static constexpr float kRestingVelocityMax = 0.1f;
     static constexpr float kDragMinVelocity = 0.1f;
+    static constexpr float kStaticWorldSkin = 0.05f; //in voxels
+    static constexpr uint kStaticWorldMaxSweepSteps = 32;
 
     std::stringstream debug_string_;
     bool enable_ground_lock_;
+    std::shared_ptr<const SignedDistanceField> static_world_;
     TTimePoint last_message_time;
 };
 
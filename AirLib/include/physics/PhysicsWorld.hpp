@@ -17,9 +17,9 @@ class PhysicsWorld {
 public:
     PhysicsWorld(std::unique_ptr<PhysicsEngineBase> physics_engine, const std::vector<UpdatableObject*>& bodies,
             uint64_t update_period_nanos = 3000000LL, bool state_reporter_enabled = false,
-            bool start_async_updator = true
+            bool start_async_updator = true, std::shared_ptr<ClockBase> clock = nullptr
         )
-        : world_(std::move(physics_engine))
+        : world_(std::move(physics_engine), clock)
     {
         enableStateReport(state_reporter_enabled);
         update_period_nanos_ = update_period_nanos;
@@ -91,6 +91,11 @@ public:
         world_.continueForTime(seconds);
     }
 
+    ClockBase* getClock() const
+    {
+        return world_.getClock();
+    }
+
 private:
     void initializeWorld(const std::vector<UpdatableObject*>& bodies, bool start_async_updator)
     {
@@ -16,8 +16,11 @@ namespace msr { namespace airlib {
 
 class World : public UpdatableContainer<UpdatableObject*> {
 public:
-    World(std::unique_ptr<PhysicsEngineBase> physics_engine)
-        : physics_engine_(std::move(physics_engine))
+    //clock is the clock domain of this world, by default the process wide ClockFactory clock is used
+    //the domain only applies on the thread updating the world, when other threads such as the API server
+    //should see it too it must also be installed with ClockFactory::get(clock)
+    World(std::unique_ptr<PhysicsEngineBase> physics_engine, std::shared_ptr<ClockBase> clock = nullptr)
+        : physics_engine_(std::move(physics_engine)), clock_(clock)
     { 
         World::clear();
 
@@ -29,6 +32,8 @@ public:
     //*** Start: UpdatableState implementation ***//
     virtual void reset() override
     {
+        ClockFactory::DomainScope scope(clock_.get());
+
         UpdatableContainer::reset();
         
         if (physics_engine_)
@@ -37,6 +42,8 @@ public:
 
     virtual void update() override
     {
+        ClockFactory::DomainScope scope(clock_.get());
+
         ClockFactory::get()->step();
 
         //first update our objects
@@ -49,6 +56,8 @@ public:
 
     virtual void reportState(StateReporter& reporter) override
     {
+        ClockFactory::DomainScope scope(clock_.get());
+
         reporter.writeValue("Sleep", 1.0f / executor_.getSleepTimeAvg());
         if (physics_engine_)
             physics_engine_->reportState(reporter);
@@ -118,6 +127,12 @@ public:
         return executor_.isPaused();
     }
 
+    //clock domain of this world, same as ClockFactory::get() if none was given
+    ClockBase* getClock() const
+    {
+        return clock_ != nullptr ? clock_.get() : ClockFactory::get();
+    }
+
     void continueForTime(double seconds)
     {
         executor_.continueForTime(seconds);
@@ -145,6 +160,7 @@ private:
 
 private:
     std::unique_ptr<PhysicsEngineBase> physics_engine_ = nullptr;
+    std::shared_ptr<ClockBase> clock_;
     common_utils::ScheduledExecutor executor_;
 };
 
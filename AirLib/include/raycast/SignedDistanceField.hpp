@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_SignedDistanceField_hpp
+#define air_SignedDistanceField_hpp
+
+#include "common/Common.hpp"
+#include "StaticScene.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    SignedDistanceField stores the distance to the static world on a regular grid, so physics can find contacts
+    without a game engine. Distances are negative inside geometry and positive outside. Only bricks of
+    BrickSize^3 voxels within band of a triangle keep samples, which are quantized to 16 bits. Every other brick
+    only remembers whether it is inside or outside.
+
+    Fields are built offline from a StaticScene and saved to a file that load() maps in to memory, so large
+    worlds start instantly and are shared between processes. The sign comes from the normals of the nearest
+    triangles, so meshes should be closed or, like terrain, have normals pointing to the free side.
+
+    Queries are const and can run on any number of threads.
+*/
+class SignedDistanceField {
+public:
+    struct Sample {
+        real_T distance; //clamped to [-band, band]
+        Vector3r normal; //gradient of the distance, pointing out of the geometry
+    };
+
+    static constexpr int BrickSize = 8;
+
+public:
+    SignedDistanceField();
+    ~SignedDistanceField();
+
+    //band 0 means four voxels
+    void build(const StaticScene& scene, real_T voxel_size, real_T band = 0);
+    void save(const std::string& file_path) const;
+    void load(const std::string& file_path);
+
+    bool isEmpty() const;
+    real_T getVoxelSize() const;
+    real_T getBand() const;
+    //bytes used by samples and the brick table
+    size_t getMemorySize() const;
+
+    real_T distance(const Vector3r& point) const;
+    Sample sample(const Vector3r& point) const;
+
+private:
+    struct impl;
+    std::unique_ptr<impl> pimpl_;
+};
+
+}} //namespace
+#endif
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_StaticScene_hpp
+#define air_StaticScene_hpp
+
+#include "common/Common.hpp"
+#include "common/CommonStructs.hpp"
+#include "TriangleMesh.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    StaticScene answers ray queries against fixed triangle geometry without a game engine, so lidar, distance
+    sensors and simRayCast work in headless simulations. Meshes are added in world NED coordinates, then build()
+    creates a bounding volume hierarchy split with the surface area heuristic. Rays are traced four at a time
+    with SSE when available, and large batches are spread over several threads.
+
+    Adding meshes and build() must not overlap with queries. Queries are const and can run on any number of threads.
+*/
+class StaticScene {
+public:
+    struct Ray {
+        Vector3r origin;
+        Vector3r direction; //does not need to be normalized, distances are in units of its length
+        real_T max_distance;
+
+        Ray()
+        {}
+        Ray(const Vector3r& origin_val, const Vector3r& direction_val, real_T max_distance_val)
+            : origin(origin_val), direction(direction_val), max_distance(max_distance_val)
+        {}
+    };
+
+    struct Hit {
+        real_T distance; //max_distance of the ray if nothing was hit
+        int mesh = -1; //index returned by addMesh, -1 if nothing was hit
+        uint triangle = 0; //index of the triangle in that mesh
+
+        bool isHit() const
+        {
+            return mesh >= 0;
+        }
+    };
+
+public:
+    StaticScene();
+    ~StaticScene();
+
+    //returns the index of the mesh that hits will report
+    int addMesh(const TriangleMesh& mesh, const Pose& pose = Pose(), const Vector3r& scale = Vector3r::Ones());
+    void clear();
+    void build();
+
+    uint triangleCount() const;
+    int meshCount() const;
+    uint triangleCount(int mesh) const;
+    const std::string& getMeshName(int mesh) const;
+    //world NED corners of a triangle in the order they were added
+    void getTriangle(int mesh, uint triangle, Vector3r corners[3]) const;
+    //geometric normal of a triangle in world frame, facing the side its vertices are counter clockwise from
+    Vector3r getNormal(int mesh, uint triangle) const;
+
+    //nearest hit of one ray
+    Hit castRay(const Ray& ray) const;
+    //nearest hit of every ray on thread_count threads, 0 uses one thread per core for large batches
+    void castRays(const vector<Ray>& rays, vector<Hit>& hits, uint thread_count = 0) const;
+    //all hits along the segment from position to position + direction like simRayCast, or only the nearest one
+    //if through_blocking is false. reference_frame_link and persist_seconds are ignored.
+    RayCastResponse rayCast(const RayCastRequest& request) const;
+
+    //with thread_count 0 each thread gets at least this many rays
+    static constexpr uint MinRaysPerThread = 4096;
+
+private:
+    struct impl;
+    std::unique_ptr<impl> pimpl_;
+};
+
+}} //namespace
+#endif
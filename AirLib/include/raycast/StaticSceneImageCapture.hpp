@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_StaticSceneImageCapture_hpp
+#define air_StaticSceneImageCapture_hpp
+
+#include "common/Common.hpp"
+#include "common/ImageCaptureBase.hpp"
+#include "common/AirSimSettings.hpp"
+#include "StaticScene.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    StaticSceneImageCapture renders ground truth images of a StaticScene on the CPU, so DepthPlanner,
+    DepthPerspective, DepthVis, Segmentation and SurfaceNormals images are available on machines without a GPU.
+    Triangles are clipped and projected once per camera, binned into screen tiles and the tiles are rasterized
+    on several threads. Pixels are sampled at their centers and depth is computed exactly on the triangle plane,
+    so results match ray casts through the pixel centers.
+
+    Images use the same layout as the Unreal capture: row 0 is the top of the image, uint8 images are RGBA and
+    float images have one value per pixel, except SurfaceNormals which has x, y and z per pixel. Compressed images
+    are PNG. Cameras are attached to a vehicle pose that can be updated from any thread.
+
+    OpticalFlow images are float only, with u and v per pixel. They are computed by OpticalFlowGenerator from
+    the DepthPlanner render, so they use its capture setting, and the motion of the camera since its previous
+    OpticalFlow image.
+*/
+class StaticSceneImageCapture : public ImageCaptureBase {
+public:
+    //depth reported for pixels that see nothing, the largest value of the 16 bit float targets used for depth in Unreal
+    static constexpr float EmptyDepth = 65504.0f;
+    //geometry closer than this to the camera plane is clipped
+    static constexpr float NearPlane = 0.01f;
+
+public:
+    //triangles of the scene are copied, later changes to it are not seen
+    StaticSceneImageCapture(std::shared_ptr<const StaticScene> scene);
+    ~StaticSceneImageCapture();
+
+    //the camera pose is relative to the vehicle, nan position or rotation means zero like in settings
+    void addCamera(const std::string& camera_name, const AirSimSettings::CameraSetting& setting);
+    void setCameraPose(const std::string& camera_name, const Pose& relative_pose);
+    void setVehiclePose(const Pose& pose);
+
+    //same behaviour as simSetSegmentationObjectID, -1 removes the mesh from segmentation images
+    bool setSegmentationObjectID(const std::string& mesh_name, int object_id, bool is_name_regex = false);
+    int getSegmentationObjectID(const std::string& mesh_name) const;
+
+    //0 uses one thread per core
+    void setThreadCount(uint thread_count);
+
+    virtual void getImages(const std::vector<ImageRequest>& requests, std::vector<ImageResponse>& responses) const override;
+
+private:
+    struct impl;
+    std::unique_ptr<impl> pimpl_;
+};
+
+}} //namespace
+#endif
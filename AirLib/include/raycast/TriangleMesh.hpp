@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_TriangleMesh_hpp
+#define air_TriangleMesh_hpp
+
+#include "common/Common.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    TriangleMesh is an indexed triangle soup used as static geometry for ray casting without a game engine.
+    Meshes can be loaded from Wavefront OBJ, ASCII or binary STL, or from the collision elements of a URDF file.
+    Loaders throw std::runtime_error if the file can't be read or parsed.
+*/
+struct TriangleMesh {
+    std::string name;
+    vector<Vector3r> vertices;
+    vector<uint32_t> indices; //three per triangle
+
+    uint triangleCount() const
+    {
+        return static_cast<uint>(indices.size() / 3);
+    }
+
+    //adds the triangles of other after scaling, rotating and then translating its vertices
+    void append(const TriangleMesh& other, const Pose& pose = Pose(), const Vector3r& scale = Vector3r::Ones());
+
+    //URDF, OBJ and STL files normally use x forward, y left and z up, this converts them to NED
+    void flipYZ();
+
+    static TriangleMesh loadObj(const std::string& file_path);
+    static TriangleMesh loadStl(const std::string& file_path);
+    //picks the loader from the file extension
+    static TriangleMesh loadFile(const std::string& file_path);
+
+    //all collision geometry of the robot with every joint at zero, one mesh per link, in the URDF frame.
+    //package:// mesh paths are resolved against package_root, relative paths against the URDF folder.
+    static vector<TriangleMesh> loadUrdfCollision(const std::string& file_path, const std::string& package_root = "");
+
+    //primitives used by URDF, centered on the origin with cylinders along z
+    static TriangleMesh box(const Vector3r& size);
+    static TriangleMesh cylinder(real_T radius, real_T length, uint segments = 24);
+    static TriangleMesh sphere(real_T radius, uint segments = 16);
+};
+
+}} //namespace
+#endif
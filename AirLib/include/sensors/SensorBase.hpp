@@ -27,7 +27,11 @@ public:
         Gps = 3,
         Magnetometer = 4,
         Distance = 5,
-        Lidar = 6
+        Lidar = 6,
+        JointEncoder = 7,
+        JointTorque = 8,
+        Contact = 9,
+        DistanceArray = 10
     };
 
     SensorBase(const std::string& sensor_name = "", const std::string& attach_link_name = "")
@@ -66,6 +70,12 @@ public:
         return std::map<std::string, double>();
     }
 
+    //update() may be skipped until this clock time because it would not change the output, 0 means every tick
+    virtual TTimePoint getNextUpdateTime() const
+    {
+        return 0;
+    }
+
     virtual ~SensorBase() = default;
 
 private:
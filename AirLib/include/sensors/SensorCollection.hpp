@@ -6,19 +6,29 @@
 
 #include <unordered_map>
 #include <map>
+#include <algorithm>
 #include "sensors/SensorBase.hpp"
 #include "common/UpdatableContainer.hpp"
+#include "common/TimingWheel.hpp"
 #include "common/Common.hpp"
 
 
 namespace msr { namespace airlib {
 
+/*
+    SensorCollection holds the sensors of a vehicle by name and type. Sensors are woken by a timing wheel on the
+    clock of their world, so each tick only updates sensors whose getNextUpdateTime() has come, in the order they
+    were inserted. Sensors that don't report a time are updated every tick.
+*/
 class SensorCollection : UpdatableObject {
 public: //types
     typedef SensorBase* SensorBasePtr;
 public:
     void insert(SensorBasePtr sensor, SensorBase::SensorType type)
     {
+        schedule_.schedule(static_cast<uint>(sensor_list_.size()), 0);
+        sensor_list_.push_back(sensor);
+
         auto type_int = static_cast<uint>(type);
         std::string sensor_name = sensor->getName();
 
@@ -104,6 +114,8 @@ public:
     void clear()
     {
         sensors_.clear();
+        sensor_list_.clear();
+        schedule_.clear();
     }
     
     //*** Start: UpdatableState implementation ***//
@@ -111,8 +123,11 @@ public:
     {
         UpdatableObject::reset();
 
-        for (auto& pair : sensors_) {
-            pair.second->reset();
+        //every sensor is updated on the first tick
+        schedule_.clear(clock()->nowNanos());
+        for (uint index = 0; index < sensor_list_.size(); ++index) {
+            sensor_list_[index]->reset();
+            schedule_.schedule(index, 0);
         }
     }
 
@@ -120,8 +135,12 @@ public:
     {
         UpdatableObject::update();
 
-        for (auto& pair : sensors_) {
-            pair.second->update();
+        due_sensors_.clear();
+        schedule_.advance(clock()->nowNanos(), due_sensors_);
+        std::sort(due_sensors_.begin(), due_sensors_.end());
+        for (uint index : due_sensors_) {
+            sensor_list_[index]->update();
+            schedule_.schedule(index, sensor_list_[index]->getNextUpdateTime());
         }
     }
 
@@ -158,6 +177,11 @@ private:
     typedef UpdatableContainer<SensorBasePtr> SensorBaseContainer;
     unordered_map<uint, std::vector<std::string>> sensor_type_mappings_;
     unordered_map<std::string, unique_ptr<SensorBaseContainer>> sensors_;
+
+    //indices in to sensor_list_, which is in insertion order
+    vector<SensorBasePtr> sensor_list_;
+    TimingWheel<uint> schedule_;
+    vector<uint> due_sensors_;
 };
 
 }} //namespace
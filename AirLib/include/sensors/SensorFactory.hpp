@@ -8,9 +8,13 @@
 
 //sensors
 #include "sensors/imu/ImuSimple.hpp"
+#include "sensors/imu/ImuHighRate.hpp"
 #include "sensors/magnetometer/MagnetometerSimple.hpp"
 #include "sensors/gps/GpsSimple.hpp"
 #include "sensors/barometer/BarometerSimple.hpp"
+#include "sensors/joint/JointEncoderSimple.hpp"
+#include "sensors/joint/JointTorqueSimple.hpp"
+#include "sensors/contact/ContactSimple.hpp"
 
 namespace msr { namespace airlib {
 
@@ -23,14 +27,24 @@ public:
         const AirSimSettings::SensorSetting* sensor_setting) const
     {
         switch (sensor_setting->sensor_type) {
-        case SensorBase::SensorType::Imu:
-            return std::unique_ptr<ImuSimple>(new ImuSimple(*static_cast<const AirSimSettings::ImuSetting*>(sensor_setting)));
+        case SensorBase::SensorType::Imu: {
+            const auto* imu_setting = static_cast<const AirSimSettings::ImuSetting*>(sensor_setting);
+            if (imu_setting->sample_rate > 0)
+                return std::unique_ptr<ImuHighRate>(new ImuHighRate(*imu_setting));
+            return std::unique_ptr<ImuSimple>(new ImuSimple(*imu_setting));
+        }
         case SensorBase::SensorType::Magnetometer:
             return std::unique_ptr<MagnetometerSimple>(new MagnetometerSimple(*static_cast<const AirSimSettings::MagnetometerSetting*>(sensor_setting)));
         case SensorBase::SensorType::Gps:
             return std::unique_ptr<GpsSimple>(new GpsSimple(*static_cast<const AirSimSettings::GpsSetting*>(sensor_setting)));
         case SensorBase::SensorType::Barometer:
             return std::unique_ptr<BarometerSimple>(new BarometerSimple(*static_cast<const AirSimSettings::BarometerSetting*>(sensor_setting)));
+        case SensorBase::SensorType::JointEncoder:
+            return std::unique_ptr<JointEncoderSimple>(new JointEncoderSimple(*static_cast<const AirSimSettings::JointEncoderSetting*>(sensor_setting)));
+        case SensorBase::SensorType::JointTorque:
+            return std::unique_ptr<JointTorqueSimple>(new JointTorqueSimple(*static_cast<const AirSimSettings::JointTorqueSetting*>(sensor_setting)));
+        case SensorBase::SensorType::Contact:
+            return std::unique_ptr<ContactSimple>(new ContactSimple(*static_cast<const AirSimSettings::ContactSetting*>(sensor_setting)));
         default:
             throw new std::invalid_argument("Unexpected sensor type");
         }
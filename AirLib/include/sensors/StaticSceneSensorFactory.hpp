@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_StaticSceneSensorFactory_hpp
+#define msr_airlib_StaticSceneSensorFactory_hpp
+
+#include "SensorFactory.hpp"
+#include "sensors/lidar/LidarStaticScene.hpp"
+#include "sensors/distance/DistanceStaticScene.hpp"
+
+namespace msr { namespace airlib {
+
+//creates lidar and distance sensors that trace a StaticScene, for simulations that run without Unreal
+class StaticSceneSensorFactory : public SensorFactory {
+public:
+    StaticSceneSensorFactory(std::shared_ptr<const StaticScene> scene)
+        : scene_(scene)
+    {
+    }
+
+    virtual std::unique_ptr<SensorBase> createSensorFromSettings(
+        const AirSimSettings::SensorSetting* sensor_setting) const override
+    {
+        switch (sensor_setting->sensor_type) {
+        case SensorBase::SensorType::Distance:
+            return std::unique_ptr<DistanceStaticScene>(new DistanceStaticScene(
+                *static_cast<const AirSimSettings::DistanceSetting*>(sensor_setting), scene_));
+        case SensorBase::SensorType::Lidar:
+            return std::unique_ptr<LidarStaticScene>(new LidarStaticScene(
+                *static_cast<const AirSimSettings::LidarSetting*>(sensor_setting), scene_));
+        default:
+            return SensorFactory::createSensorFromSettings(sensor_setting);
+        }
+    }
+
+private:
+    std::shared_ptr<const StaticScene> scene_;
+};
+
+}} //namespace
+#endif
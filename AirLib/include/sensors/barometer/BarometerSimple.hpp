@@ -67,6 +67,11 @@ public:
     }
     //*** End: UpdatableState implementation ***//
 
+    virtual TTimePoint getNextUpdateTime() const override
+    {
+        return std::min(freq_limiter_.getNextDueTime(), delay_line_.getNextOutputTime());
+    }
+
     virtual ~BarometerSimple() = default;
 
 private: //methods
@@ -0,0 +1,124 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_ContactBase_hpp
+#define msr_airlib_ContactBase_hpp
+
+#include "sensors/SensorBase.hpp"
+#include <functional>
+
+namespace msr { namespace airlib {
+
+/*
+    Contacts on a set of links of an articulated vehicle. The vehicle sums the hits on each link and hands out
+    running totals through a provider, so a sensor sees every hit between two of its samples whatever its rate.
+    Locations and impulses are in the frame of the link, in meters and N s.
+*/
+class ContactBase : public SensorBase {
+public:
+    //running sums since the vehicle was reset, in double so they don't lose hits over long runs
+    struct ContactTotals {
+        uint64_t count = 0;
+        VectorMath::Vector3d normal_impulse = VectorMath::Vector3d::Zero();
+        VectorMath::Vector3d location_sum = VectorMath::Vector3d::Zero();
+    };
+
+    //returns false if the vehicle has no link of that name
+    typedef std::function<bool(const std::string& link_name, ContactTotals& totals)> ContactProvider;
+
+    ContactBase(const std::string& sensor_name = "", const std::string& attach_link = "")
+        : SensorBase(sensor_name, attach_link)
+    {}
+
+public: //types
+    //one entry per link in the order of getLinkNames(), impulses and centroids are x, y, z for each link
+    struct Output {
+        TTimePoint time_stamp = 0;
+        vector<uint> counts;
+        vector<real_T> normal_impulses;
+        vector<real_T> centroids;
+        bool is_valid = false;
+    };
+
+public:
+    void setContactProvider(const ContactProvider& provider)
+    {
+        provider_ = provider;
+    }
+
+    const vector<std::string>& getLinkNames() const
+    {
+        return link_names_;
+    }
+
+    virtual void reportState(StateReporter& reporter) override
+    {
+        //call base
+        UpdatableObject::reportState(reporter);
+
+        for (uint i = 0; i < output_.counts.size() && i < link_names_.size(); ++i) {
+            reporter.writeValue("Contact-" + link_names_[i] + "-Count", output_.counts[i]);
+            reporter.writeValue("Contact-" + link_names_[i] + "-Impulse", getVector(output_.normal_impulses, i));
+        }
+    }
+
+    virtual const std::map<std::string, double> read() const override
+    {
+        std::map<std::string, double> values;
+        for (uint i = 0; i < output_.counts.size() && i < link_names_.size(); ++i) {
+            const std::string prefix = "Contact-" + link_names_[i];
+            values[prefix + "-count"] = output_.counts[i];
+            values[prefix + "-impulse-x"] = output_.normal_impulses[3 * i];
+            values[prefix + "-impulse-y"] = output_.normal_impulses[3 * i + 1];
+            values[prefix + "-impulse-z"] = output_.normal_impulses[3 * i + 2];
+            values[prefix + "-centroid-x"] = output_.centroids[3 * i];
+            values[prefix + "-centroid-y"] = output_.centroids[3 * i + 1];
+            values[prefix + "-centroid-z"] = output_.centroids[3 * i + 2];
+        }
+        values["Contact-IsValid"] = output_.is_valid ? 1.0f : 0.0f;
+
+        return values;
+    }
+
+    const Output& getOutput() const
+    {
+        return output_;
+    }
+
+    static Vector3r getVector(const vector<real_T>& values, uint index)
+    {
+        return Vector3r(values[3 * index], values[3 * index + 1], values[3 * index + 2]);
+    }
+
+protected:
+    void setOutput(const Output& output)
+    {
+        output_ = output;
+    }
+
+    void setLinkNames(const vector<std::string>& link_names)
+    {
+        link_names_ = link_names;
+    }
+
+    //false if there is no provider yet or one of the links is missing
+    bool sampleLinks(vector<ContactTotals>& totals) const
+    {
+        totals.resize(link_names_.size());
+        if (!provider_)
+            return false;
+
+        for (uint i = 0; i < link_names_.size(); ++i)
+            if (!provider_(link_names_[i], totals[i]))
+                return false;
+        return true;
+    }
+
+private:
+    Output output_;
+    vector<std::string> link_names_;
+    ContactProvider provider_;
+};
+
+}} //namespace
+#endif
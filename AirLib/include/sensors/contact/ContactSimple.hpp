@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_ContactSimple_hpp
+#define msr_airlib_ContactSimple_hpp
+
+#include "common/Common.hpp"
+#include "ContactSimpleParams.hpp"
+#include "ContactBase.hpp"
+#include "common/FrequencyLimiter.hpp"
+#include "common/DelayLine.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    Reports the hits on each link since the previous sample: how many there were, their summed normal impulse
+    and the mean of their locations. The vehicle must reset its totals along with its sensors.
+*/
+class ContactSimple : public ContactBase {
+public:
+    ContactSimple(const AirSimSettings::ContactSetting& setting = AirSimSettings::ContactSetting())
+        : ContactBase(setting.sensor_name, setting.attach_link)
+    {
+        // initialize params
+        params_.initializeFromSettings(setting);
+        setLinkNames(params_.link_names);
+
+        //initialize frequency limiter
+        freq_limiter_.initialize(params_.update_frequency, params_.startup_delay);
+        delay_line_.initialize(params_.update_latency);
+    }
+
+    //*** Start: UpdatableState implementation ***//
+    virtual void reset() override
+    {
+        ContactBase::reset();
+
+        last_totals_.assign(params_.link_names.size(), ContactTotals());
+
+        freq_limiter_.reset();
+        delay_line_.reset();
+
+        delay_line_.push_back(getOutputInternal());
+    }
+
+    virtual void update() override
+    {
+        ContactBase::update();
+
+        freq_limiter_.update();
+
+        if (freq_limiter_.isWaitComplete())
+            delay_line_.push_back(getOutputInternal());
+
+        delay_line_.update();
+
+        if (freq_limiter_.isWaitComplete())
+            setOutput(delay_line_.getOutput());
+    }
+    //*** End: UpdatableState implementation ***//
+
+    virtual TTimePoint getNextUpdateTime() const override
+    {
+        return std::min(freq_limiter_.getNextDueTime(), delay_line_.getNextOutputTime());
+    }
+
+    virtual ~ContactSimple() = default;
+
+private: //methods
+    Output getOutputInternal()
+    {
+        uint link_count = static_cast<uint>(params_.link_names.size());
+
+        Output output;
+        output.time_stamp = clock()->nowNanos();
+        output.counts.assign(link_count, 0);
+        output.normal_impulses.assign(3 * link_count, 0);
+        output.centroids.assign(3 * link_count, 0);
+
+        output.is_valid = sampleLinks(totals_);
+        if (!output.is_valid)
+            return output;
+
+        for (uint i = 0; i < link_count; ++i) {
+            const ContactTotals& current = totals_[i];
+            const ContactTotals& last = last_totals_[i];
+            uint64_t count = current.count - last.count;
+            VectorMath::Vector3d impulse = current.normal_impulse - last.normal_impulse;
+            VectorMath::Vector3d location_sum = current.location_sum - last.location_sum;
+
+            output.counts[i] = static_cast<uint>(count);
+            for (uint axis = 0; axis < 3; ++axis) {
+                output.normal_impulses[3 * i + axis] = static_cast<real_T>(impulse[axis]);
+                if (count > 0)
+                    output.centroids[3 * i + axis] = static_cast<real_T>(location_sum[axis] / count);
+            }
+        }
+
+        last_totals_ = totals_;
+        return output;
+    }
+
+private:
+    ContactSimpleParams params_;
+
+    vector<ContactTotals> totals_;
+    vector<ContactTotals> last_totals_;
+
+    FrequencyLimiter freq_limiter_;
+    DelayLine<Output> delay_line_;
+};
+
+}} //namespace
+#endif
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_ContactSimpleParams_hpp
+#define msr_airlib_ContactSimpleParams_hpp
+
+#include "common/Common.hpp"
+#include "common/AirSimSettings.hpp"
+
+namespace msr { namespace airlib {
+
+struct ContactSimpleParams {
+    vector<std::string> link_names;
+
+    real_T update_latency = 0;      //sec
+    real_T update_frequency = 100;  //Hz
+    real_T startup_delay = 0;       //sec
+
+    void initializeFromSettings(const AirSimSettings::ContactSetting& settings)
+    {
+        link_names = settings.links;
+        update_frequency = settings.update_frequency;
+        update_latency = settings.update_latency;
+        startup_delay = settings.startup_delay;
+    }
+};
+
+}} //namespace
+#endif
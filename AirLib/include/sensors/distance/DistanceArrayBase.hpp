@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_DistanceArrayBase_hpp
+#define msr_airlib_DistanceArrayBase_hpp
+
+
+#include "sensors/SensorBase.hpp"
+
+
+namespace msr { namespace airlib {
+
+class DistanceArrayBase : public SensorBase {
+public:
+    DistanceArrayBase(const std::string& sensor_name = "", const std::string& attach_link_name = "")
+        : SensorBase(sensor_name, attach_link_name)
+    {}
+
+public: //types
+    //one entry per zone, row major from the top left zone as seen from behind the sensor
+    struct Output {
+        TTimePoint time_stamp = 0;
+        uint rows = 0;
+        uint cols = 0;
+        vector<real_T> distances;           //meters, max_distance for a zone without returns
+        vector<uint16_t> return_counts;     //rays of the zone that returned
+        real_T min_distance = 0;
+        real_T max_distance = 0;
+        Pose relative_pose;
+    };
+
+
+public:
+    virtual void reportState(StateReporter& reporter) override
+    {
+        //call base
+        UpdatableObject::reportState(reporter);
+
+        if (!output_.distances.empty())
+            reporter.writeValue("DistArray-Min", *std::min_element(output_.distances.begin(), output_.distances.end()));
+    }
+
+    virtual const std::map<std::string, double> read() const override
+    {
+        std::map<std::string, double> values;
+        for (uint i = 0; i < output_.distances.size(); ++i) {
+            values[Utils::stringf("DistArray-%u", i)] = output_.distances[i];
+            values[Utils::stringf("DistArray-%u-returns", i)] = output_.return_counts[i];
+        }
+        values["Max-Distance"] = output_.max_distance;
+        values["Min-Distance"] = output_.min_distance;
+
+        return values;
+    }
+
+    const Output& getOutput() const
+    {
+        return output_;
+    }
+
+protected:
+    void setOutput(const Output& output)
+    {
+        output_ = output;
+    }
+
+
+private:
+    Output output_;
+};
+
+
+}} //namespace
+#endif
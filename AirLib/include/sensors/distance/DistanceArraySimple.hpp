@@ -0,0 +1,155 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_DistanceArraySimple_hpp
+#define msr_airlib_DistanceArraySimple_hpp
+
+#include "common/Common.hpp"
+#include "DistanceArraySimpleParams.hpp"
+#include "DistanceArrayBase.hpp"
+#include "common/DelayLine.hpp"
+#include "common/FrequencyLimiter.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    Distance sensor with many beams, such as a multizone time of flight sensor or an ultrasonic cone. All rays
+    of a sample go to the engine in one castRays() call, so it can trace them as a batch, and are then reduced
+    to one distance per zone with the error model of DistanceArraySimpleParams.
+*/
+class DistanceArraySimple : public DistanceArrayBase {
+public:
+    struct RayHit {
+        real_T distance = 0;            //meters along the ray, if it hit
+        real_T incidence_cos = 1;       //cosine of the angle between the ray and the surface normal
+        bool is_hit = false;
+    };
+
+public:
+    DistanceArraySimple(const AirSimSettings::DistanceArraySetting& setting = AirSimSettings::DistanceArraySetting())
+        : DistanceArrayBase(setting.sensor_name, setting.attach_link)
+    {
+        // initialize params
+        params_.initializeFromSettings(setting);
+        directions_ = params_.getRayDirections();
+        hits_.resize(directions_.size());
+
+        //initialize frequency limiter
+        freq_limiter_.initialize(params_.update_frequency, params_.startup_delay);
+        delay_line_.initialize(params_.update_latency);
+    }
+
+    //*** Start: UpdatableState implementation ***//
+    virtual void reset() override
+    {
+        DistanceArrayBase::reset();
+
+        noise_.reset();
+        dropout_.reset();
+
+        freq_limiter_.reset();
+        delay_line_.reset();
+
+        delay_line_.push_back(getOutputInternal());
+    }
+
+    virtual void update() override
+    {
+        DistanceArrayBase::update();
+
+        freq_limiter_.update();
+
+        if (freq_limiter_.isWaitComplete())
+            delay_line_.push_back(getOutputInternal());
+
+        delay_line_.update();
+
+        if (freq_limiter_.isWaitComplete())
+            setOutput(delay_line_.getOutput());
+    }
+    //*** End: UpdatableState implementation ***//
+
+    virtual TTimePoint getNextUpdateTime() const override
+    {
+        return std::min(freq_limiter_.getNextDueTime(), delay_line_.getNextOutputTime());
+    }
+
+    const DistanceArraySimpleParams& getParams() const
+    {
+        return params_;
+    }
+
+    //ray directions in the sensor frame, getParams().getRaysPerZone() for each zone in turn
+    const vector<Vector3r>& getRayDirections() const
+    {
+        return directions_;
+    }
+
+    virtual ~DistanceArraySimple() = default;
+
+protected:
+    //traces the rays of one sample from pose, the world pose of the sensor, up to max_distance; directions are
+    //unit vectors in the sensor frame and hits already has one entry for each
+    virtual void castRays(const Pose& pose, const vector<Vector3r>& directions, real_T max_distance, vector<RayHit>& hits) = 0;
+
+private: //methods
+    Output getOutputInternal()
+    {
+        const GroundTruth& ground_truth = getGroundTruth();
+
+        Output output;
+        output.time_stamp = clock()->nowNanos();
+        const bool is_cone = params_.pattern == DistanceArraySimpleParams::Pattern::Cone;
+        output.rows = is_cone ? 1 : params_.zone_rows;
+        output.cols = is_cone ? 1 : params_.zone_cols;
+        output.min_distance = params_.min_distance;
+        output.max_distance = params_.max_distance;
+        output.relative_pose = params_.relative_pose;
+
+        //order of Pose addition is important here because it also adds quaternions which is not commutative!
+        castRays(params_.relative_pose + ground_truth.kinematics->pose, directions_, params_.max_distance, hits_);
+
+        const uint zone_count = params_.getZoneCount(), rays_per_zone = params_.getRaysPerZone();
+        output.distances.assign(zone_count, params_.max_distance);
+        output.return_counts.assign(zone_count, 0);
+        for (uint zone = 0; zone < zone_count; ++zone) {
+            uint returns = 0;
+            real_T min_distance = params_.max_distance, distance_sum = 0;
+            for (uint ray = zone * rays_per_zone; ray < (zone + 1) * rays_per_zone; ++ray) {
+                const RayHit& hit = hits_[ray];
+                if (!hit.is_hit || hit.distance > params_.max_distance)
+                    continue;
+                //beams at grazing incidence scatter away from the receiver
+                if (params_.multipath_dropout > 0 && dropout_.next() < params_.multipath_dropout * (1 - std::abs(hit.incidence_cos)))
+                    continue;
+
+                ++returns;
+                min_distance = std::min(min_distance, hit.distance);
+                distance_sum += hit.distance;
+            }
+            if (returns == 0)
+                continue;
+
+            real_T distance = params_.reduction == DistanceArraySimpleParams::Reduction::Min ? min_distance : distance_sum / returns;
+            distance += noise_.next() * params_.getNoiseSigma(distance);
+            output.distances[zone] = Utils::clip(distance, params_.min_distance, params_.max_distance);
+            output.return_counts[zone] = static_cast<uint16_t>(returns);
+        }
+
+        return output;
+    }
+
+private:
+    DistanceArraySimpleParams params_;
+    vector<Vector3r> directions_;
+    vector<RayHit> hits_;
+
+    RandomGeneratorGausianR noise_ = RandomGeneratorGausianR(0.0f, 1.0f);
+    RandomGeneratorR dropout_ = RandomGeneratorR(0.0f, 1.0f);
+
+    FrequencyLimiter freq_limiter_;
+    DelayLine<Output> delay_line_;
+};
+
+}} //namespace
+#endif
@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_DistanceArraySimpleParams_hpp
+#define msr_airlib_DistanceArraySimpleParams_hpp
+
+#include "common/Common.hpp"
+#include "common/AirSimSettings.hpp"
+
+
+namespace msr { namespace airlib {
+
+
+/*
+    Beam pattern and error model of a distance array.
+
+    A Grid is a multizone time of flight sensor: the field of view is split into zone_rows x zone_cols zones,
+    each sampled by rays_per_zone_side^2 rays on a regular grid of the image plane. A Cone is an ultrasonic
+    sensor with one zone, sampled by cone_rays rays spread evenly over the disc of the cone with a sunflower
+    spiral. The defaults are close to a VL53L5CX in its 4 x 4 mode.
+
+    Each ray that hits is dropped with probability multipath_dropout * (1 - cos(incidence)), as a beam that
+    meets a surface at a grazing angle mostly bounces away. A zone reports the minimum or the mean of its
+    returns, with gaussian noise of sigma noise_sigma + noise_growth * distance^2, since the returned signal
+    falls with the square of the range.
+*/
+struct DistanceArraySimpleParams {
+    enum class Pattern {
+        Grid, Cone
+    };
+
+    enum class Reduction {
+        Min, Mean
+    };
+
+    Pattern pattern = Pattern::Grid;
+    uint zone_rows = 4;
+    uint zone_cols = 4;
+    uint rays_per_zone_side = 4;
+    real_T horizontal_fov = Utils::degreesToRadians(45.0f);
+    real_T vertical_fov = Utils::degreesToRadians(45.0f);
+    real_T cone_angle = Utils::degreesToRadians(30.0f);    //full angle
+    uint cone_rays = 64;
+    Reduction reduction = Reduction::Min;
+
+    real_T min_distance = 0.02f;    //m
+    real_T max_distance = 4.0f;     //m
+    real_T noise_sigma = 0.005f;    //m
+    real_T noise_growth = 0.002f;   //m per m^2
+    real_T multipath_dropout = 0.5f;
+    Pose relative_pose;
+
+    real_T update_latency = 0.0f;    //sec
+    real_T update_frequency = 15;    //Hz
+    real_T startup_delay = 0;        //sec
+
+    uint getZoneCount() const
+    {
+        return pattern == Pattern::Cone ? 1 : zone_rows * zone_cols;
+    }
+
+    uint getRaysPerZone() const
+    {
+        return pattern == Pattern::Cone ? cone_rays : rays_per_zone_side * rays_per_zone_side;
+    }
+
+    //unit directions of the rays in the sensor frame, x forward, y right and z down, grouped by zone
+    vector<Vector3r> getRayDirections() const
+    {
+        vector<Vector3r> directions;
+        directions.reserve(getZoneCount() * getRaysPerZone());
+
+        if (pattern == Pattern::Cone) {
+            const real_T radius = std::tan(cone_angle / 2);
+            const real_T golden_angle = M_PIf * (3 - std::sqrt(5.0f));
+            for (uint ray = 0; ray < cone_rays; ++ray) {
+                const real_T r = radius * std::sqrt((ray + 0.5f) / cone_rays);
+                const real_T theta = ray * golden_angle;
+                directions.push_back(Vector3r(1, r * std::cos(theta), r * std::sin(theta)).normalized());
+            }
+            return directions;
+        }
+
+        //zones tile the image plane at distance 1 evenly, as the pixels of a SPAD array do
+        const real_T half_width = std::tan(horizontal_fov / 2), half_height = std::tan(vertical_fov / 2);
+        const uint side = rays_per_zone_side;
+        for (uint row = 0; row < zone_rows; ++row) {
+            for (uint col = 0; col < zone_cols; ++col) {
+                for (uint i = 0; i < side; ++i) {
+                    const real_T v = -half_height + 2 * half_height * (row + (i + 0.5f) / side) / zone_rows;
+                    for (uint j = 0; j < side; ++j) {
+                        const real_T u = -half_width + 2 * half_width * (col + (j + 0.5f) / side) / zone_cols;
+                        directions.push_back(Vector3r(1, u, v).normalized());
+                    }
+                }
+            }
+        }
+        return directions;
+    }
+
+    real_T getNoiseSigma(real_T distance) const
+    {
+        return noise_sigma + noise_growth * distance * distance;
+    }
+
+    void initializeFromSettings(const AirSimSettings::DistanceArraySetting& settings)
+    {
+        const std::string pattern_name = Utils::toLower(settings.pattern);
+        if (pattern_name == "grid")
+            pattern = Pattern::Grid;
+        else if (pattern_name == "cone")
+            pattern = Pattern::Cone;
+        else
+            throw std::invalid_argument("Unknown distance array pattern '" + settings.pattern + "', expected Grid or Cone");
+
+        const std::string reduction_name = Utils::toLower(settings.reduction);
+        if (reduction_name == "min")
+            reduction = Reduction::Min;
+        else if (reduction_name == "mean")
+            reduction = Reduction::Mean;
+        else
+            throw std::invalid_argument("Unknown distance array reduction '" + settings.reduction + "', expected Min or Mean");
+
+        zone_rows = settings.zone_rows;
+        zone_cols = settings.zone_cols;
+        rays_per_zone_side = settings.rays_per_zone_side;
+        cone_rays = settings.cone_rays;
+        if (getZoneCount() == 0 || getRaysPerZone() == 0 || getRaysPerZone() > 65535)
+            throw std::invalid_argument(Utils::stringf("Distance array %s needs at least one zone and between 1 and 65535 rays per zone",
+                settings.sensor_name.c_str()));
+
+        horizontal_fov = Utils::degreesToRadians(settings.horizontal_fov);
+        vertical_fov = Utils::degreesToRadians(settings.vertical_fov);
+        cone_angle = Utils::degreesToRadians(settings.cone_angle);
+
+        min_distance = settings.min_distance;
+        max_distance = settings.max_distance;
+        noise_sigma = settings.noise_sigma;
+        noise_growth = settings.noise_growth;
+        multipath_dropout = settings.multipath_dropout;
+        update_frequency = settings.update_frequency;
+        update_latency = settings.update_latency;
+        startup_delay = settings.startup_delay;
+
+        relative_pose.position = settings.position;
+        for (uint axis = 0; axis < 3; ++axis) {
+            if (std::isnan(relative_pose.position[axis]))
+                relative_pose.position[axis] = 0;
+        }
+        float pitch = !std::isnan(settings.rotation.pitch) ? settings.rotation.pitch : 0;
+        float roll = !std::isnan(settings.rotation.roll) ? settings.rotation.roll : 0;
+        float yaw = !std::isnan(settings.rotation.yaw) ? settings.rotation.yaw : 0;
+        relative_pose.orientation = VectorMath::toQuaternion(
+            Utils::degreesToRadians(pitch),   //pitch - rotation around Y axis
+            Utils::degreesToRadians(roll),    //roll  - rotation around X axis
+            Utils::degreesToRadians(yaw));    //yaw   - rotation around Z axis
+    }
+};
+
+
+}} //namespace
+#endif
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_DistanceArrayStaticScene_hpp
+#define msr_airlib_DistanceArrayStaticScene_hpp
+
+#include "common/Common.hpp"
+#include "DistanceArraySimple.hpp"
+#include "raycast/StaticScene.hpp"
+
+namespace msr { namespace airlib {
+
+//Distance array that traces its rays as one packet batch in a StaticScene, so it works without Unreal
+class DistanceArrayStaticScene : public DistanceArraySimple {
+public:
+    DistanceArrayStaticScene(const AirSimSettings::DistanceArraySetting& setting, std::shared_ptr<const StaticScene> scene)
+        : DistanceArraySimple(setting), scene_(scene)
+    {
+    }
+
+protected:
+    virtual void castRays(const Pose& pose, const vector<Vector3r>& directions, real_T max_distance, vector<RayHit>& hits) override
+    {
+        rays_.resize(directions.size());
+        for (uint i = 0; i < directions.size(); ++i)
+            rays_[i] = StaticScene::Ray(pose.position, VectorMath::rotateVector(directions[i], pose.orientation, true), max_distance);
+
+        scene_->castRays(rays_, scene_hits_);
+
+        for (uint i = 0; i < directions.size(); ++i) {
+            const StaticScene::Hit& scene_hit = scene_hits_[i];
+            RayHit& hit = hits[i];
+            hit.is_hit = scene_hit.isHit();
+            hit.distance = scene_hit.distance;
+            hit.incidence_cos = hit.is_hit ? rays_[i].direction.dot(scene_->getNormal(scene_hit.mesh, scene_hit.triangle)) : 1;
+        }
+    }
+
+private:
+    std::shared_ptr<const StaticScene> scene_;
+    vector<StaticScene::Ray> rays_;
+    vector<StaticScene::Hit> scene_hits_;
+};
+
+}} //namespace
+#endif
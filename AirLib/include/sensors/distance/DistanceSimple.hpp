@@ -63,6 +63,11 @@ public:
     }
     //*** End: UpdatableState implementation ***//
 
+    virtual TTimePoint getNextUpdateTime() const override
+    {
+        return std::min(freq_limiter_.getNextDueTime(), delay_line_.getNextOutputTime());
+    }
+
     virtual ~DistanceSimple() = default;
 
 protected:
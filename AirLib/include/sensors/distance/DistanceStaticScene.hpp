@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_DistanceStaticScene_hpp
+#define msr_airlib_DistanceStaticScene_hpp
+
+#include "common/Common.hpp"
+#include "DistanceSimple.hpp"
+#include "raycast/StaticScene.hpp"
+
+namespace msr { namespace airlib {
+
+//Distance sensor that measures along its x axis in a StaticScene, so it works without Unreal
+class DistanceStaticScene : public DistanceSimple {
+public:
+    DistanceStaticScene(const AirSimSettings::DistanceSetting& setting, std::shared_ptr<const StaticScene> scene)
+        : DistanceSimple(setting), scene_(scene)
+    {
+    }
+
+protected:
+    virtual real_T getRayLength(const Pose& pose) override
+    {
+        const DistanceSimpleParams& params = getParams();
+        StaticScene::Ray ray(pose.position, VectorMath::rotateVector(VectorMath::front(), pose.orientation, true), params.max_distance);
+        StaticScene::Hit hit = scene_->castRay(ray);
+        return hit.isHit() ? std::max(params.min_distance, hit.distance) : params.max_distance;
+    }
+
+private:
+    std::shared_ptr<const StaticScene> scene_;
+};
+
+}} //namespace
+#endif
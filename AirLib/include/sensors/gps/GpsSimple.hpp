@@ -66,6 +66,12 @@ public: //methods
 
     //*** End: UpdatableState implementation ***//
 
+    //the filters integrate the time since their last update, so skipping ticks only changes rounding
+    virtual TTimePoint getNextUpdateTime() const override
+    {
+        return std::min(freq_limiter_.getNextDueTime(), delay_line_.getNextOutputTime());
+    }
+
     virtual ~GpsSimple() = default;
 private:
     void addOutputToDelayLine(real_T eph, real_T epv)
@@ -12,6 +12,9 @@ namespace msr { namespace airlib {
 
 class ImuBase  : public SensorBase {
 public:
+    //writes the speed of each rotor in rad/s to speeds, at most max_count of them, and returns how many it wrote
+    typedef std::function<uint(real_T* speeds, uint max_count)> RotorSpeedProvider;
+
     ImuBase(const std::string& sensor_name = "", const std::string& attach_link_name = "")
         : SensorBase(sensor_name, attach_link_name)
     {}
@@ -54,15 +57,34 @@ public:
         return output_;
     }
 
+    //rotors shake IMUs that model vibration, more so the closer they run to max_speed
+    void setRotorSpeedProvider(const RotorSpeedProvider& provider, real_T max_speed)
+    {
+        rotor_speed_provider_ = provider;
+        rotor_max_speed_ = max_speed;
+    }
+
 protected:
     void setOutput(const Output& output)
     {
         output_ = output;
     }
 
+    const RotorSpeedProvider& getRotorSpeedProvider() const
+    {
+        return rotor_speed_provider_;
+    }
+
+    real_T getRotorMaxSpeed() const
+    {
+        return rotor_max_speed_;
+    }
+
 
 private: 
     Output output_;
+    RotorSpeedProvider rotor_speed_provider_;
+    real_T rotor_max_speed_ = 0;
 };
 
 
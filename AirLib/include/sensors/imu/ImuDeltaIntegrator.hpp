@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_ImuDeltaIntegrator_hpp
+#define msr_airlib_ImuDeltaIntegrator_hpp
+
+#include "common/Common.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    Sums the angle and velocity increments of the high rate IMU samples in one output interval into the
+    rotation and the velocity change over the interval, with coning and sculling corrections.
+
+    A plain sum of the angle increments is only the rotation if the rotation axis stays fixed. When it turns,
+    as when two axes oscillate out of phase, the sum misses the coning term, and the same effect on the rotating
+    specific force (sculling) biases the summed velocity. The corrections are the recursive second order form of
+    Savage, assuming the rates change linearly within each sample.
+
+    ref: Savage, Strapdown Inertial Navigation Integration Algorithm Design Part 1: Attitude Algorithms, eq. 38
+    and Part 2: Velocity and Position Algorithms, eq. 55, Journal of Guidance, Control, and Dynamics, 1998
+*/
+class ImuDeltaIntegrator {
+public:
+    ImuDeltaIntegrator()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        alpha_ = Vector3r::Zero();
+        upsilon_ = Vector3r::Zero();
+        coning_ = Vector3r::Zero();
+        sculling_ = Vector3r::Zero();
+        last_delta_angle_ = Vector3r::Zero();
+        last_delta_velocity_ = Vector3r::Zero();
+        sample_count_ = 0;
+    }
+
+    //delta_angle is the body rate and delta_velocity the specific force integrated over one sample
+    void add(const Vector3r& delta_angle, const Vector3r& delta_velocity)
+    {
+        //the previous increment extrapolates the rate to second order within this sample
+        const Vector3r alpha = alpha_ + last_delta_angle_ / 6;
+        const Vector3r upsilon = upsilon_ + last_delta_velocity_ / 6;
+
+        coning_ += 0.5f * alpha.cross(delta_angle);
+        sculling_ += 0.5f * (alpha.cross(delta_velocity) + upsilon.cross(delta_angle));
+
+        alpha_ += delta_angle;
+        upsilon_ += delta_velocity;
+        last_delta_angle_ = delta_angle;
+        last_delta_velocity_ = delta_velocity;
+        ++sample_count_;
+    }
+
+    //rotation vector from the body frame at reset to the body frame now
+    Vector3r getDeltaAngle() const
+    {
+        return alpha_ + coning_;
+    }
+
+    //velocity change in the body frame at reset, without gravity
+    Vector3r getDeltaVelocity() const
+    {
+        //the rotation term is the first order rotation of the summed specific force back to the frame at reset
+        return upsilon_ + 0.5f * alpha_.cross(upsilon_) + sculling_;
+    }
+
+    //sums of the increments without any correction
+    const Vector3r& getAngleSum() const
+    {
+        return alpha_;
+    }
+
+    const Vector3r& getVelocitySum() const
+    {
+        return upsilon_;
+    }
+
+    uint getSampleCount() const
+    {
+        return sample_count_;
+    }
+
+private:
+    Vector3r alpha_, upsilon_;
+    Vector3r coning_, sculling_;
+    Vector3r last_delta_angle_, last_delta_velocity_;
+    uint sample_count_;
+};
+
+}} //namespace
+#endif
@@ -0,0 +1,297 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_ImuHighRate_hpp
+#define msr_airlib_ImuHighRate_hpp
+
+#include "common/Common.hpp"
+#include "ImuHighRateParams.hpp"
+#include "ImuDeltaIntegrator.hpp"
+#include "ImuBase.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    IMU that samples faster than the physics updates it, the way a MEMS part samples at kHz rates and the
+    flight controller reads the accumulated increments.
+
+    Each update covers the time since the previous one with samples at sample_rate. The body rate and specific
+    force of the samples are interpolated linearly between the ground truth of the two updates and rotor
+    vibration is added to each sample, which then goes through the anti-alias filter and into the coning and
+    sculling integrator. The noise of ImuSimple is added to the increments. The output holds the mean rate and
+    specific force over the update, that is the increments divided by their time, and getIncrements() the
+    increments themselves.
+
+    Updates don't allocate: rotor speeds go to a fixed array and an update longer than kMaxSamples samples, as
+    after a pause, uses longer samples instead of more of them.
+*/
+class ImuHighRate : public ImuBase {
+public:
+    static constexpr uint kMaxSamples = 64;
+    static constexpr uint kMaxRotors = 16;
+
+    struct Increments {
+        Vector3r delta_angle = Vector3r::Zero();       //rotation vector from the body at the previous update to the body now
+        Vector3r delta_velocity = Vector3r::Zero();    //velocity change from the specific force, in the body frame of the previous update
+        real_T delta_time = 0;
+        uint sample_count = 0;
+    };
+
+public:
+    ImuHighRate(const AirSimSettings::ImuSetting& setting = AirSimSettings::ImuSetting())
+        : ImuBase(setting.sensor_name, setting.attach_link)
+    {
+        params_.initializeFromSettings(setting);
+
+        gyro_bias_stability_norm_ = params_.gyro.bias_stability / sqrt(params_.gyro.tau);
+        accel_bias_stability_norm_ = params_.accel.bias_stability / sqrt(params_.accel.tau);
+    }
+
+    //*** Start: UpdatableState implementation ***//
+    virtual void reset() override
+    {
+        ImuBase::reset();
+
+        last_time_ = clock()->nowNanos();
+
+        state_.gyroscope_bias = params_.gyro.turn_on_bias;
+        state_.accelerometer_bias = params_.accel.turn_on_bias;
+        gauss_dist_.reset();
+
+        readGroundTruth(last_angular_velocity_, last_specific_force_);
+        designFilters(1 / params_.sample_rate);
+        gyro_filter_.reset(last_angular_velocity_);
+        accel_filter_.reset(last_specific_force_);
+        //spread the rotor phases so that equal speeds don't add up in phase
+        for (uint i = 0; i < kMaxRotors; ++i)
+            rotor_phases_[i] = std::fmod(i * 2.39996323f, 2 * M_PIf);
+
+        increments_ = Increments();
+        Output output;
+        output.orientation = getGroundTruth().kinematics->pose.orientation;
+        output.angular_velocity = last_angular_velocity_ + state_.gyroscope_bias;
+        output.linear_acceleration = last_specific_force_ + state_.accelerometer_bias;
+        setOutput(output);
+    }
+
+    virtual void update() override
+    {
+        ImuBase::update();
+
+        updateOutput();
+    }
+    //*** End: UpdatableState implementation ***//
+
+    const Increments& getIncrements() const
+    {
+        return increments_;
+    }
+
+    const ImuHighRateParams& getParams() const
+    {
+        return params_;
+    }
+
+    virtual ~ImuHighRate() = default;
+
+private: //types
+    //second order section in transposed direct form II, one per axis
+    struct LowPassFilter {
+        bool enabled = false;
+        real_T b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+        Vector3r z1 = Vector3r::Zero(), z2 = Vector3r::Zero();
+
+        //bilinear transform of the Butterworth prototype with the cutoff prewarped
+        void design(real_T cutoff, real_T sample_time)
+        {
+            //no filter at or too close to the Nyquist frequency
+            enabled = cutoff > 0 && cutoff * sample_time < 0.45f;
+            if (!enabled)
+                return;
+
+            const real_T k = std::tan(M_PIf * cutoff * sample_time);
+            const real_T q = 1 / std::sqrt(2.0f);
+            const real_T norm = 1 / (1 + k / q + k * k);
+            b0 = k * k * norm;
+            b1 = 2 * b0;
+            b2 = b0;
+            a1 = 2 * (k * k - 1) * norm;
+            a2 = (1 - k / q + k * k) * norm;
+        }
+
+        //settles the filter on a constant input
+        void reset(const Vector3r& input)
+        {
+            z1 = (1 - b0) * input;
+            z2 = (b2 - a2) * input;
+        }
+
+        Vector3r apply(const Vector3r& input)
+        {
+            if (!enabled)
+                return input;
+            const Vector3r output = b0 * input + z1;
+            z1 = b1 * input - a1 * output + z2;
+            z2 = b2 * input - a2 * output;
+            return output;
+        }
+    };
+
+private: //methods
+    void readGroundTruth(Vector3r& angular_velocity, Vector3r& specific_force) const
+    {
+        const GroundTruth& ground_truth = getGroundTruth();
+        angular_velocity = ground_truth.kinematics->twist.angular;
+        //acceleration is in world frame so transform to body frame
+        specific_force = VectorMath::transformToBodyFrame(
+            ground_truth.kinematics->accelerations.linear - ground_truth.environment->getState().gravity,
+            ground_truth.kinematics->pose.orientation, true);
+    }
+
+    void designFilters(real_T sample_time)
+    {
+        filter_sample_time_ = sample_time;
+        gyro_filter_.design(params_.anti_alias_cutoff, sample_time);
+        accel_filter_.design(params_.anti_alias_cutoff, sample_time);
+    }
+
+    void updateOutput()
+    {
+        const TTimeDelta dt = clock()->updateSince(last_time_);
+        Vector3r angular_velocity, specific_force;
+        readGroundTruth(angular_velocity, specific_force);
+
+        Output output = getOutput();
+        output.orientation = getGroundTruth().kinematics->pose.orientation;
+        if (dt <= 0) {
+            //nothing was sampled since the last update
+            increments_ = Increments();
+            setOutput(output);
+            return;
+        }
+
+        uint sample_count = static_cast<uint>(std::round(dt * params_.sample_rate));
+        if (sample_count == 0)
+            sample_count = 1;
+        else if (sample_count > kMaxSamples)
+            sample_count = kMaxSamples;
+        const real_T sample_time = static_cast<real_T>(dt / sample_count);
+        if (std::abs(sample_time - filter_sample_time_) > filter_sample_time_ * 0.01f)
+            designFilters(sample_time);
+        startVibration(sample_time, sample_count);
+
+        integrator_.reset();
+        for (uint sample = 1; sample <= sample_count; ++sample) {
+            const real_T t = static_cast<real_T>(sample) / sample_count;
+            Vector3r sample_angular_velocity = last_angular_velocity_ + (angular_velocity - last_angular_velocity_) * t;
+            Vector3r sample_specific_force = last_specific_force_ + (specific_force - last_specific_force_) * t;
+            addVibration(sample_angular_velocity, sample_specific_force);
+
+            integrator_.add(gyro_filter_.apply(sample_angular_velocity) * sample_time,
+                accel_filter_.apply(sample_specific_force) * sample_time);
+        }
+
+        //white noise and bias are added to the increments instead of each sample: the sum of the white noise
+        //of the samples has the same distribution as one draw for the whole update, which is what ImuSimple
+        //adds, and drawing it once keeps the samples cheap
+        const real_T delta_time = static_cast<real_T>(dt);
+        const real_T sqrt_dt = std::sqrt(delta_time);
+        increments_.delta_angle = integrator_.getDeltaAngle()
+            + gauss_dist_.next() * (params_.gyro.arw * sqrt_dt) + state_.gyroscope_bias * delta_time;
+        increments_.delta_velocity = integrator_.getDeltaVelocity()
+            + gauss_dist_.next() * (params_.accel.vrw * sqrt_dt) + state_.accelerometer_bias * delta_time;
+        increments_.delta_time = delta_time;
+
+        //update bias random walk once per update as ImuSimple does
+        const real_T sqrt_bias_dt = static_cast<real_T>(sqrt(std::max<TTimeDelta>(dt, params_.min_sample_time)));
+        state_.gyroscope_bias += gauss_dist_.next() * (gyro_bias_stability_norm_ * sqrt_bias_dt);
+        state_.accelerometer_bias += gauss_dist_.next() * (accel_bias_stability_norm_ * sqrt_bias_dt);
+
+        last_angular_velocity_ = angular_velocity;
+        last_specific_force_ = specific_force;
+
+        increments_.sample_count = sample_count;
+
+        output.angular_velocity = increments_.delta_angle / increments_.delta_time;
+        output.linear_acceleration = increments_.delta_velocity / increments_.delta_time;
+        setOutput(output);
+    }
+
+    //reads the rotor speeds, which stay for the whole update, and sets up their phasors for the samples
+    void startVibration(real_T sample_time, uint sample_count)
+    {
+        rotor_count_ = 0;
+        const auto& rotor_speed_provider = getRotorSpeedProvider();
+        const real_T max_speed = getRotorMaxSpeed();
+        if (!rotor_speed_provider || max_speed <= 0 || (params_.vibration.accel == 0 && params_.vibration.gyro == 0))
+            return;
+
+        const uint max_count = kMaxRotors;
+        rotor_count_ = rotor_speed_provider(rotor_speeds_, max_count);
+        if (rotor_count_ > max_count)
+            rotor_count_ = max_count;
+
+        for (uint i = 0; i < rotor_count_; ++i) {
+            const real_T speed_ratio = rotor_speeds_[i] / max_speed;
+            RotorPhasor& phasor = rotor_phasors_[i];
+            phasor.strength = speed_ratio * speed_ratio;
+            phasor.cos = std::cos(rotor_phases_[i]);
+            phasor.sin = std::sin(rotor_phases_[i]);
+            const real_T step = rotor_speeds_[i] * sample_time;
+            phasor.step_cos = std::cos(step);
+            phasor.step_sin = std::sin(step);
+            rotor_phases_[i] = std::fmod(rotor_phases_[i] + step * sample_count, 2 * M_PIf);
+        }
+    }
+
+    void addVibration(Vector3r& angular_velocity, Vector3r& specific_force)
+    {
+        for (uint i = 0; i < rotor_count_; ++i) {
+            RotorPhasor& phasor = rotor_phasors_[i];
+            const real_T c = phasor.cos, s = phasor.sin;
+            specific_force += (params_.vibration.accel * phasor.strength) * Vector3r(c, s, 2 * s * c);
+            angular_velocity += (params_.vibration.gyro * phasor.strength) * Vector3r(s, c, 0);
+
+            //advance the phase by one sample without trigonometry
+            phasor.cos = c * phasor.step_cos - s * phasor.step_sin;
+            phasor.sin = s * phasor.step_cos + c * phasor.step_sin;
+        }
+    }
+
+private: //fields
+    ImuHighRateParams params_;
+    RandomVectorGaussianR gauss_dist_ = RandomVectorGaussianR(0, 1);
+
+    //cached calculated values
+    real_T gyro_bias_stability_norm_, accel_bias_stability_norm_;
+
+    struct State {
+        Vector3r gyroscope_bias;
+        Vector3r accelerometer_bias;
+    } state_;
+
+    ImuDeltaIntegrator integrator_;
+    Increments increments_;
+    LowPassFilter gyro_filter_, accel_filter_;
+    real_T filter_sample_time_ = 0;
+
+    //ground truth of the previous update, in the body frame
+    Vector3r last_angular_velocity_ = Vector3r::Zero();
+    Vector3r last_specific_force_ = Vector3r::Zero();
+
+    //phase of a rotor within an update as a unit phasor
+    struct RotorPhasor {
+        real_T strength, cos, sin, step_cos, step_sin;
+    };
+
+    real_T rotor_speeds_[kMaxRotors] = {};
+    real_T rotor_phases_[kMaxRotors] = {};
+    RotorPhasor rotor_phasors_[kMaxRotors];
+    uint rotor_count_ = 0;
+
+    TTimePoint last_time_;
+};
+
+
+}} //namespace
+#endif
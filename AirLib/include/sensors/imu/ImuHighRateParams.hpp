@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_ImuHighRateParams_hpp
+#define msr_airlib_ImuHighRateParams_hpp
+
+#include "common/Common.hpp"
+#include "ImuSimpleParams.hpp"
+
+
+namespace msr { namespace airlib {
+
+
+//noise model of ImuSimpleParams plus the internal sampling of ImuHighRate
+struct ImuHighRateParams : public ImuSimpleParams {
+    real_T sample_rate = 2000;          //internal samples per second
+    //second order Butterworth low pass on each sample, as MEMS parts have ahead of their decimation; 0 for none
+    real_T anti_alias_cutoff = 250;
+
+    struct Vibration {
+        //amplitudes per rotor when it runs at its max speed, growing with the square of the speed;
+        //the rotor imbalance shakes the x and y axes at the rotor frequency and the blades the z axis at twice that
+        real_T accel = 0;   //m/s^2
+        real_T gyro = 0;    //rad/s
+    } vibration;
+
+    void initializeFromSettings(const AirSimSettings::ImuSetting& settings)
+    {
+        ImuSimpleParams::initializeFromSettings(settings);
+
+        if (settings.sample_rate > 0)
+            sample_rate = settings.sample_rate;
+        anti_alias_cutoff = settings.anti_alias_cutoff;
+        vibration.accel = settings.vibration_accel;
+        vibration.gyro = settings.vibration_gyro;
+    }
+};
+
+
+}} //namespace
+#endif
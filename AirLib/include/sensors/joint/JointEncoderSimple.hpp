@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_JointEncoderSimple_hpp
+#define msr_airlib_JointEncoderSimple_hpp
+
+#include "common/Common.hpp"
+#include "JointSensorSimpleParams.hpp"
+#include "JointEncoderBase.hpp"
+#include "common/FrequencyLimiter.hpp"
+#include "common/DelayLine.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    Incremental encoders on a set of joints. Each sample the true position gets bias and white noise and is
+    rounded to whole counts. Velocity is the change in counted position since the previous sample divided by
+    the time between them, as an encoder interface computes it, so it carries the quantization steps too. The
+    first sample has nothing to difference against and reports zero velocity.
+*/
+class JointEncoderSimple : public JointEncoderBase {
+public:
+    JointEncoderSimple(const AirSimSettings::JointEncoderSetting& setting = AirSimSettings::JointEncoderSetting())
+        : JointEncoderBase(setting.sensor_name, setting.attach_link)
+    {
+        // initialize params
+        params_.initializeFromSettings(setting);
+        setJointNames(params_.getJointNames());
+
+        //initialize frequency limiter
+        freq_limiter_.initialize(params_.update_frequency, params_.startup_delay);
+        delay_line_.initialize(params_.update_latency);
+    }
+
+    //*** Start: UpdatableState implementation ***//
+    virtual void reset() override
+    {
+        JointEncoderBase::reset();
+
+        noise_.reset();
+        last_positions_.clear();
+        last_sample_time_ = 0;
+
+        freq_limiter_.reset();
+        delay_line_.reset();
+
+        delay_line_.push_back(getOutputInternal());
+    }
+
+    virtual void update() override
+    {
+        JointEncoderBase::update();
+
+        freq_limiter_.update();
+
+        if (freq_limiter_.isWaitComplete())
+            delay_line_.push_back(getOutputInternal());
+
+        delay_line_.update();
+
+        if (freq_limiter_.isWaitComplete())
+            setOutput(delay_line_.getOutput());
+    }
+    //*** End: UpdatableState implementation ***//
+
+    virtual TTimePoint getNextUpdateTime() const override
+    {
+        return std::min(freq_limiter_.getNextDueTime(), delay_line_.getNextOutputTime());
+    }
+
+    const JointSensorSimpleParams& getParams() const
+    {
+        return params_;
+    }
+
+    virtual ~JointEncoderSimple() = default;
+
+private: //methods
+    Output getOutputInternal()
+    {
+        Output output;
+        output.time_stamp = clock()->nowNanos();
+        output.positions.resize(params_.channels.size());
+        output.velocities.resize(params_.channels.size());
+
+        output.is_valid = sampleJoints(states_);
+        if (!output.is_valid)
+            return output;
+
+        TTimeDelta dt = last_positions_.empty() ? 0 : ClockBase::elapsedBetween(output.time_stamp, last_sample_time_);
+        for (uint i = 0; i < params_.channels.size(); ++i) {
+            output.positions[i] = params_.channels[i].measure(states_[i].position, noise_.next());
+            if (dt > 0)
+                output.velocities[i] = static_cast<real_T>((output.positions[i] - last_positions_[i]) / dt);
+        }
+
+        last_positions_ = output.positions;
+        last_sample_time_ = output.time_stamp;
+        return output;
+    }
+
+private:
+    JointSensorSimpleParams params_;
+    RandomGeneratorGausianR noise_ = RandomGeneratorGausianR(0.0f, 1.0f);
+
+    vector<JointState> states_;
+    vector<real_T> last_positions_;
+    TTimePoint last_sample_time_ = 0;
+
+    FrequencyLimiter freq_limiter_;
+    DelayLine<Output> delay_line_;
+};
+
+}} //namespace
+#endif
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_JointSensorBase_hpp
+#define msr_airlib_JointSensorBase_hpp
+
+#include "sensors/SensorBase.hpp"
+#include <functional>
+
+namespace msr { namespace airlib {
+
+/*
+    Base of the sensors that measure the joints of an articulated vehicle. Joint state is not part of the
+    kinematics ground truth, so the vehicle supplies it through a provider after the sensors are created.
+    Positions and velocities are in radians or meters, efforts in N m or N, as in the URDF.
+*/
+class JointSensorBase : public SensorBase {
+public:
+    struct JointState {
+        real_T position = 0;
+        real_T velocity = 0;
+        real_T effort = 0;
+    };
+
+    //returns false if the vehicle has no joint of that name
+    typedef std::function<bool(const std::string& joint_name, JointState& state)> JointStateProvider;
+
+    JointSensorBase(const std::string& sensor_name = "", const std::string& attach_link = "")
+        : SensorBase(sensor_name, attach_link)
+    {}
+
+    void setJointStateProvider(const JointStateProvider& provider)
+    {
+        provider_ = provider;
+    }
+
+    //output arrays are in this order
+    const vector<std::string>& getJointNames() const
+    {
+        return joint_names_;
+    }
+
+protected:
+    void setJointNames(const vector<std::string>& joint_names)
+    {
+        joint_names_ = joint_names;
+    }
+
+    //false if there is no provider yet or one of the joints is missing
+    bool sampleJoints(vector<JointState>& states) const
+    {
+        states.resize(joint_names_.size());
+        if (!provider_)
+            return false;
+
+        for (uint i = 0; i < joint_names_.size(); ++i)
+            if (!provider_(joint_names_[i], states[i]))
+                return false;
+        return true;
+    }
+
+private:
+    vector<std::string> joint_names_;
+    JointStateProvider provider_;
+};
+
+}} //namespace
+#endif
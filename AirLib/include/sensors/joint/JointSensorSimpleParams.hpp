@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_JointSensorSimpleParams_hpp
+#define msr_airlib_JointSensorSimpleParams_hpp
+
+#include "common/Common.hpp"
+#include "common/AirSimSettings.hpp"
+
+namespace msr { namespace airlib {
+
+//noise and quantization of one measured joint quantity
+struct JointChannelParams {
+    std::string joint_name;
+    real_T resolution = 0;      //size of one count, 0 for none
+    real_T noise_sigma = 0;     //white noise added before quantization
+    real_T bias = 0;
+    real_T range = 0;           //measurements saturate at +/- range, 0 for none
+
+    //standard_normal is a draw from N(0, 1), so callers own the random sequence
+    real_T measure(real_T value, real_T standard_normal) const
+    {
+        value += bias + noise_sigma * standard_normal;
+        value = quantize(value, resolution);
+        if (range > 0)
+            value = std::max(-range, std::min(value, range));
+        return value;
+    }
+
+    //rounds to the nearest count, so the error is within half a count either side
+    static real_T quantize(real_T value, real_T resolution)
+    {
+        if (resolution <= 0)
+            return value;
+        return static_cast<real_T>(std::round(value / resolution)) * resolution;
+    }
+};
+
+struct JointSensorSimpleParams {
+    vector<JointChannelParams> channels;
+
+    real_T update_latency = 0;      //sec
+    real_T update_frequency = 100;  //Hz
+    real_T startup_delay = 0;       //sec
+
+    void initializeFromSettings(const AirSimSettings::JointSensorSetting& settings)
+    {
+        channels.clear();
+        for (const auto& joint : settings.joints) {
+            JointChannelParams channel;
+            channel.joint_name = joint.joint_name;
+            channel.resolution = joint.resolution;
+            channel.noise_sigma = joint.noise_sigma;
+            channel.bias = joint.bias;
+            channel.range = joint.range;
+            channels.push_back(channel);
+        }
+
+        update_frequency = settings.update_frequency;
+        update_latency = settings.update_latency;
+        startup_delay = settings.startup_delay;
+    }
+
+    vector<std::string> getJointNames() const
+    {
+        vector<std::string> names;
+        for (const auto& channel : channels)
+            names.push_back(channel.joint_name);
+        return names;
+    }
+};
+
+}} //namespace
+#endif
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_JointTorqueBase_hpp
+#define msr_airlib_JointTorqueBase_hpp
+
+#include "JointSensorBase.hpp"
+
+namespace msr { namespace airlib {
+
+class JointTorqueBase : public JointSensorBase {
+public:
+    JointTorqueBase(const std::string& sensor_name = "", const std::string& attach_link = "")
+        : JointSensorBase(sensor_name, attach_link)
+    {}
+
+public: //types
+    //one entry per joint, in the order of getJointNames()
+    struct Output {
+        TTimePoint time_stamp = 0;
+        vector<real_T> efforts;
+        bool is_valid = false;
+    };
+
+public:
+    virtual void reportState(StateReporter& reporter) override
+    {
+        //call base
+        UpdatableObject::reportState(reporter);
+
+        const auto& names = getJointNames();
+        for (uint i = 0; i < output_.efforts.size() && i < names.size(); ++i)
+            reporter.writeValue("Torque-" + names[i], output_.efforts[i]);
+    }
+
+    virtual const std::map<std::string, double> read() const override
+    {
+        std::map<std::string, double> values;
+        const auto& names = getJointNames();
+        for (uint i = 0; i < output_.efforts.size() && i < names.size(); ++i)
+            values["JointTorque-" + names[i] + "-effort"] = output_.efforts[i];
+        values["JointTorque-IsValid"] = output_.is_valid ? 1.0f : 0.0f;
+
+        return values;
+    }
+
+    const Output& getOutput() const
+    {
+        return output_;
+    }
+
+protected:
+    void setOutput(const Output& output)
+    {
+        output_ = output;
+    }
+
+private:
+    Output output_;
+};
+
+}} //namespace
+#endif
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_JointTorqueSimple_hpp
+#define msr_airlib_JointTorqueSimple_hpp
+
+#include "common/Common.hpp"
+#include "JointSensorSimpleParams.hpp"
+#include "JointTorqueBase.hpp"
+#include "common/FrequencyLimiter.hpp"
+#include "common/DelayLine.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    Strain gauge torque (or force, on prismatic joints) sensors on a set of joints. Each sample the effort
+    transmitted through the joint gets bias and white noise, is rounded to the resolution of the converter and
+    saturates at the full scale range.
+*/
+class JointTorqueSimple : public JointTorqueBase {
+public:
+    JointTorqueSimple(const AirSimSettings::JointTorqueSetting& setting = AirSimSettings::JointTorqueSetting())
+        : JointTorqueBase(setting.sensor_name, setting.attach_link)
+    {
+        // initialize params
+        params_.initializeFromSettings(setting);
+        setJointNames(params_.getJointNames());
+
+        //initialize frequency limiter
+        freq_limiter_.initialize(params_.update_frequency, params_.startup_delay);
+        delay_line_.initialize(params_.update_latency);
+    }
+
+    //*** Start: UpdatableState implementation ***//
+    virtual void reset() override
+    {
+        JointTorqueBase::reset();
+
+        noise_.reset();
+
+        freq_limiter_.reset();
+        delay_line_.reset();
+
+        delay_line_.push_back(getOutputInternal());
+    }
+
+    virtual void update() override
+    {
+        JointTorqueBase::update();
+
+        freq_limiter_.update();
+
+        if (freq_limiter_.isWaitComplete())
+            delay_line_.push_back(getOutputInternal());
+
+        delay_line_.update();
+
+        if (freq_limiter_.isWaitComplete())
+            setOutput(delay_line_.getOutput());
+    }
+    //*** End: UpdatableState implementation ***//
+
+    virtual TTimePoint getNextUpdateTime() const override
+    {
+        return std::min(freq_limiter_.getNextDueTime(), delay_line_.getNextOutputTime());
+    }
+
+    const JointSensorSimpleParams& getParams() const
+    {
+        return params_;
+    }
+
+    virtual ~JointTorqueSimple() = default;
+
+private: //methods
+    Output getOutputInternal()
+    {
+        Output output;
+        output.time_stamp = clock()->nowNanos();
+        output.efforts.resize(params_.channels.size());
+
+        output.is_valid = sampleJoints(states_);
+        if (!output.is_valid)
+            return output;
+
+        for (uint i = 0; i < params_.channels.size(); ++i)
+            output.efforts[i] = params_.channels[i].measure(states_[i].effort, noise_.next());
+
+        return output;
+    }
+
+private:
+    JointSensorSimpleParams params_;
+    RandomGeneratorGausianR noise_ = RandomGeneratorGausianR(0.0f, 1.0f);
+
+    vector<JointState> states_;
+
+    FrequencyLimiter freq_limiter_;
+    DelayLine<Output> delay_line_;
+};
+
+}} //namespace
+#endif
@@ -59,6 +59,11 @@ public:
     }
     //*** End: UpdatableState implementation ***//
 
+    virtual TTimePoint getNextUpdateTime() const override
+    {
+        return freq_limiter_.getNextDueTime();
+    }
+
     virtual ~LidarSimple() = default;
 
     const LidarSimpleParams& getParams() const
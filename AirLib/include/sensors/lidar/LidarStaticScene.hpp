@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_LidarStaticScene_hpp
+#define msr_airlib_LidarStaticScene_hpp
+
+#include "common/Common.hpp"
+#include "LidarSimple.hpp"
+#include "raycast/StaticScene.hpp"
+
+namespace msr { namespace airlib {
+
+//Lidar that traces its lasers through a StaticScene, so it works without Unreal.
+//The scan pattern is the same as the Unreal lidar and points are hits in world NED.
+class LidarStaticScene : public LidarSimple {
+public:
+    LidarStaticScene(const AirSimSettings::LidarSetting& setting, std::shared_ptr<const StaticScene> scene)
+        : LidarSimple(setting), scene_(scene)
+    {
+        const LidarSimpleParams& params = getParams();
+
+        //vertical angle of each laser, top one first
+        if (params.number_of_channels == 1)
+            laser_angles_.push_back(0);
+        else {
+            real_T delta_angle = (params.vertical_FOV_upper - params.vertical_FOV_lower) / static_cast<real_T>(params.number_of_channels - 1);
+            for (uint i = 0; i < params.number_of_channels; ++i)
+                laser_angles_.push_back(params.vertical_FOV_upper - static_cast<real_T>(i) * delta_angle);
+        }
+    }
+
+protected:
+    virtual void getPointCloud(const Pose& lidar_pose, const Pose& vehicle_pose,
+        TTimeDelta delta_time, vector<real_T>& point_cloud) override
+    {
+        point_cloud.clear();
+
+        const LidarSimpleParams& params = getParams();
+        if (laser_angles_.empty())
+            return;
+
+        //same cap as the Unreal lidar for the first update after a long pause
+        constexpr real_T MaxPointsInScan = 1e+5f;
+        real_T total_points = std::min(MaxPointsInScan, std::round(static_cast<real_T>(params.points_per_second * delta_time)));
+        uint points_per_laser = static_cast<uint>(std::round(total_points / laser_angles_.size()));
+        if (points_per_laser == 0)
+            return;
+
+        real_T angle_of_tick = static_cast<real_T>(params.horizontal_rotation_frequency * 360.0f * delta_time);
+        real_T angle_per_point = angle_of_tick / points_per_laser;
+
+        Vector3r start = vehicle_pose.position + VectorMath::rotateVector(lidar_pose.position, vehicle_pose.orientation, true);
+        Quaternionr lidar_world = VectorMath::rotateQuaternion(lidar_pose.orientation, vehicle_pose.orientation, true);
+
+        rays_.clear();
+        for (real_T vertical_angle : laser_angles_) {
+            for (uint i = 0; i < points_per_laser; ++i) {
+                real_T horizontal_angle = current_horizontal_angle_ + angle_per_point * i;
+                Quaternionr ray_lidar = VectorMath::toQuaternion(Utils::degreesToRadians(vertical_angle), 0, Utils::degreesToRadians(horizontal_angle));
+                Quaternionr ray_world = VectorMath::rotateQuaternion(ray_lidar, lidar_world, true);
+                rays_.emplace_back(start, VectorMath::rotateVector(VectorMath::front(), ray_world, true), params.range);
+            }
+        }
+
+        scene_->castRays(rays_, hits_);
+        for (size_t i = 0; i < hits_.size(); ++i) {
+            if (!hits_[i].isHit())
+                continue;
+            Vector3r point = rays_[i].origin + rays_[i].direction * hits_[i].distance;
+            point_cloud.push_back(point.x());
+            point_cloud.push_back(point.y());
+            point_cloud.push_back(point.z());
+        }
+
+        current_horizontal_angle_ = std::fmod(current_horizontal_angle_ + angle_of_tick, 360.0f);
+    }
+
+private:
+    std::shared_ptr<const StaticScene> scene_;
+    vector<real_T> laser_angles_;
+    real_T current_horizontal_angle_ = 0;
+
+    vector<StaticScene::Ray> rays_;
+    vector<StaticScene::Hit> hits_;
+};
+
+}} //namespace
+#endif
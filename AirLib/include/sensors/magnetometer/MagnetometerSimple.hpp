@@ -63,6 +63,11 @@ public:
     }
     //*** End: UpdatableObject implementation ***//
 
+    virtual TTimePoint getNextUpdateTime() const override
+    {
+        return std::min(freq_limiter_.getNextDueTime(), delay_line_.getNextOutputTime());
+    }
+
     virtual ~MagnetometerSimple() = default;
 
 private: //methods
@@ -66,6 +66,8 @@ public:
         }
     };
 
+    typedef ControlSchedule<CarControls> CarControlSchedule;
+
 public:
     CarApiBase(const AirSimSettings::VehicleSetting* vehicle_setting, 
         std::shared_ptr<SensorFactory> sensor_factory, 
@@ -78,6 +80,7 @@ public:
     virtual void reset() override
     {
         VehicleApiBase::reset();
+        control_schedule_.reset();
 
         //reset sensors last after their ground truth has been reset
         getSensors().reset();
@@ -86,6 +89,7 @@ public:
     {
         VehicleApiBase::update();
 
+        updateControlSchedule();
         getSensors().update();
     }
     void reportState(StateReporter& reporter) override
@@ -133,11 +137,58 @@ public:
     virtual CarState getCarState() const = 0;
     virtual const CarApiBase::CarControls& getCarControls() const = 0;
 
+    //controls stamped in sim time that update() applies at each step; the car brakes when the schedule expires
+    virtual void setCarControlSchedule(const vector<TTimePoint>& times, const vector<CarControls>& controls,
+        CarControlSchedule::Interpolation interpolation, double horizon)
+    {
+        control_schedule_.upload(times, controls, interpolation, horizon);
+    }
+    virtual void clearCarControlSchedule()
+    {
+        control_schedule_.clear();
+    }
+    virtual ControlScheduleStatus getControlScheduleStatus() const override
+    {
+        return control_schedule_.getStatus();
+    }
+
+    //pedal and steering inputs blend, the rest comes from the earlier setpoint
+    static CarControls interpolateControls(const CarControls& from, const CarControls& to, real_T alpha)
+    {
+        CarControls controls = from;
+        controls.throttle = from.throttle + alpha * (to.throttle - from.throttle);
+        controls.steering = from.steering + alpha * (to.steering - from.steering);
+        controls.brake = from.brake + alpha * (to.brake - from.brake);
+        return controls;
+    }
+
     virtual ~CarApiBase() = default;
 
     std::shared_ptr<const SensorFactory> sensor_factory_;
     SensorCollection sensors_; //maintains sensor type indexed collection of sensors
     vector<unique_ptr<SensorBase>> sensor_storage_; //RAII for created sensors
+
+private:
+    void updateControlSchedule()
+    {
+        CarControls controls;
+        switch (control_schedule_.step(clock()->nowNanos(), controls)) {
+        case CarControlSchedule::StepResult::Setpoint:
+            setCarControls(controls);
+            break;
+        case CarControlSchedule::StepResult::Expired:
+            controls = getCarControls();
+            controls.throttle = 0;
+            controls.brake = 1;
+            setCarControls(controls);
+            break;
+        default:
+            break;
+        }
+    }
+
+private:
+    CarControlSchedule control_schedule_ { &CarApiBase::interpolateControls };
 };
 
 
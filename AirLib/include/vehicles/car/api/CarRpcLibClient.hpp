@@ -19,6 +19,9 @@ public:
     CarRpcLibClient(const string& ip_address = "localhost", uint16_t port = 41451, float timeout_sec = 60);
 
     void setCarControls(const CarApiBase::CarControls& controls, const std::string& vehicle_name = "");
+    void setCarControlSchedule(const vector<TTimePoint>& times, const vector<CarApiBase::CarControls>& controls,
+        CarApiBase::CarControlSchedule::Interpolation interpolation = CarApiBase::CarControlSchedule::Interpolation::Hold,
+        float horizon = 0, const std::string& vehicle_name = "");
     CarApiBase::CarState getCarState(const std::string& vehicle_name = "");
 
     virtual ~CarRpcLibClient();    //required for pimpl
@@ -139,7 +139,11 @@ public:
         return rotors_.at(rotor_index).getOutput();
     }
 
-    virtual ~MultiRotor() = default;
+    virtual ~MultiRotor()
+    {
+        //the sensors belong to params and may outlive the rotors
+        params_->setRotorSpeedProvider(nullptr, 0);
+    }
 
 private: //methods
     void initialize(const Kinematics::State& initial_kinematic_state, Environment* environment)
@@ -149,6 +153,13 @@ private: //methods
         createRotors(*params_, rotors_, environment);
         createDragVertices();
 
+        params_->setRotorSpeedProvider([this](real_T* speeds, uint max_count) {
+            uint count = std::min(max_count, static_cast<uint>(rotors_.size()));
+            for (uint rotor_index = 0; rotor_index < count; ++rotor_index)
+                speeds[rotor_index] = rotors_[rotor_index].getOutput().speed;
+            return count;
+        }, params_->getParams().rotor_params.max_speed);
+
         initSensors(*params_, getKinematics(), getEnvironment());
     }
 
@@ -7,6 +7,7 @@
 #include "common/Common.hpp"
 #include "RotorParams.hpp"
 #include "sensors/SensorCollection.hpp"
+#include "sensors/SensorFactory.hpp"
 #include "vehicles/multirotor/api/MultirotorApiBase.hpp"
 
 namespace msr { namespace airlib {
@@ -82,6 +83,16 @@ public: //interface
         return sensors_;
     }
 
+    // IMUs that model vibration read the rotor speeds through the provider
+    void setRotorSpeedProvider(const ImuBase::RotorSpeedProvider& provider, real_T max_speed)
+    {
+        for (auto& sensor : sensor_storage_) {
+            auto* imu = dynamic_cast<ImuBase*>(sensor.get());
+            if (imu != nullptr)
+                imu->setRotorSpeedProvider(provider, max_speed);
+        }
+    }
+
     void addSensorsFromSettings(const AirSimSettings::VehicleSetting* vehicle_setting)
     {
         // use sensors from vehicle settings; if empty list, use default sensors.
@@ -20,6 +20,8 @@ using namespace msr::airlib;
 namespace msr { namespace airlib {
 
 class MultirotorApiBase : public VehicleApiBase {
+public:
+    typedef ControlSchedule<MultirotorSetpoint> MultirotorControlSchedule;
 
 protected: //must be implemented
 
@@ -70,6 +72,7 @@ public: //optional overrides
     }
 
     virtual void reset() override;
+    virtual void update() override;
 
 
 public: //these APIs uses above low level APIs
@@ -96,6 +99,17 @@ public: //these APIs uses above low level APIs
     virtual bool rotateByYawRate(float yaw_rate, float duration);
     virtual bool hover();
     virtual RCData estimateRCTrims(float trimduration = 1, float minCountForTrim = 10, float maxTrim = 100);
+
+    //setpoints stamped in sim time that update() sends through the given command at each step. yaw_is_rate applies
+    //to the velocity commands. Any other move command ends the schedule and the vehicle hovers when it expires.
+    virtual void moveByControlSchedule(const vector<TTimePoint>& times, const vector<MultirotorSetpoint>& setpoints,
+        ScheduledCommand command, bool yaw_is_rate, MultirotorControlSchedule::Interpolation interpolation, double horizon);
+    virtual ControlScheduleStatus getControlScheduleStatus() const override
+    {
+        return control_schedule_.getStatus();
+    }
+    //yaw is interpolated as a plain number, so angles should be unwrapped by the client
+    static MultirotorSetpoint interpolateSetpoints(const MultirotorSetpoint& from, const MultirotorSetpoint& to, real_T alpha);
     
     /************************* Safety APIs *********************************/
     virtual void setSafetyEval(const shared_ptr<SafetyEval> safety_eval_ptr);
@@ -189,8 +203,11 @@ protected: //types
                 token.lock();
             }
 
-            if (isRootCall())
+            if (isRootCall()) {
                 token.reset();
+                //a new command takes over from the control schedule
+                api->control_schedule_.clear();
+            }
             //else this is not the start of the call
         }
 
@@ -304,10 +321,12 @@ private: //methods
     void adjustYaw(float x, float y, DrivetrainType drivetrain, YawMode& yaw_mode);
     void moveToPathPosition(const Vector3r& dest, float velocity, DrivetrainType drivetrain, /* pass by value */ YawMode yaw_mode, float last_z);
     bool isYawWithinMargin(float yaw_target, float margin) const;
+    void applySetpoint(const MultirotorSetpoint& setpoint);
 
 private: //variables
     CancelToken token_;
     std::recursive_mutex status_mutex_;
+    MultirotorControlSchedule control_schedule_ { &MultirotorApiBase::interpolateSetpoints };
     RCData rc_data_trims_;
     shared_ptr<SafetyEval> safety_eval_ptr_;
     float obs_avoidance_vel_ = 0.5f;
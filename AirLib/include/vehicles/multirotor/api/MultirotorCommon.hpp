@@ -67,6 +67,29 @@ struct MultirotorApiParams {
     int obs_window = 0;
 };
 
+//low level command a control schedule drives, with the meaning it gives to the fields of MultirotorSetpoint
+enum class ScheduledCommand : int {
+    Velocity = 0,           //x, y, z: velocity in m/s, yaw: angle or rate in degrees
+    VelocityZ = 1,          //x, y: velocity in m/s, z: altitude, yaw: angle or rate in degrees
+    RollPitchZ = 2,         //x: pitch, y: roll, z: altitude, yaw: angle, all angles in radians
+    RollPitchThrottle = 3   //x: pitch, y: roll in radians, z: throttle, yaw: rate in radians/s
+};
+
+//one setpoint of a multirotor control schedule
+struct MultirotorSetpoint {
+    float x = 0, y = 0, z = 0, yaw = 0;
+    //set for the whole upload by moveByControlSchedule
+    ScheduledCommand command = ScheduledCommand::Velocity;
+    bool yaw_is_rate = true;
+
+    MultirotorSetpoint()
+    {}
+
+    MultirotorSetpoint(float x_val, float y_val, float z_val, float yaw_val)
+        : x(x_val), y(y_val), z(z_val), yaw(yaw_val)
+    {}
+};
+
 struct MultirotorState {
     CollisionInfo collision;
     Kinematics::State kinematics_estimated;
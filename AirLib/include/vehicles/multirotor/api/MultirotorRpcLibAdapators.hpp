@@ -39,6 +39,26 @@ public:
         }
     };
 
+    struct MultirotorSetpoint {
+        float x = 0, y = 0, z = 0, yaw = 0;
+        MSGPACK_DEFINE_MAP(x, y, z, yaw);
+
+        MultirotorSetpoint()
+        {}
+
+        MultirotorSetpoint(const msr::airlib::MultirotorSetpoint& s)
+        {
+            x = s.x;
+            y = s.y;
+            z = s.z;
+            yaw = s.yaw;
+        }
+        msr::airlib::MultirotorSetpoint to() const
+        {
+            return msr::airlib::MultirotorSetpoint(x, y, z, yaw);
+        }
+    };
+
     struct MultirotorState {
         CollisionInfo collision;
         KinematicsState kinematics_estimated;
@@ -43,6 +43,10 @@ public:
     MultirotorRpcLibClient* hoverAsync(const std::string& vehicle_name = "");
 
     void moveByRC(const RCData& rc_data, const std::string& vehicle_name = "");
+    void moveByControlSchedule(const vector<TTimePoint>& times, const vector<MultirotorSetpoint>& setpoints,
+        ScheduledCommand command = ScheduledCommand::Velocity, bool yaw_is_rate = true,
+        MultirotorApiBase::MultirotorControlSchedule::Interpolation interpolation = MultirotorApiBase::MultirotorControlSchedule::Interpolation::Hold,
+        float horizon = 0, const std::string& vehicle_name = "");
 
 
     MultirotorState getMultirotorState(const std::string& vehicle_name = "");
@@ -141,6 +141,19 @@ public: //methods
             was_reset_ = false;
     }
 
+    //the offboard link is too slow to stream a setpoint every physics step
+    virtual void moveByControlSchedule(const vector<TTimePoint>& times, const vector<MultirotorSetpoint>& setpoints,
+        ScheduledCommand command, bool yaw_is_rate, MultirotorControlSchedule::Interpolation interpolation, double horizon) override
+    {
+        unused(times);
+        unused(setpoints);
+        unused(command);
+        unused(yaw_is_rate);
+        unused(interpolation);
+        unused(horizon);
+        throw VehicleCommandNotImplementedException("moveByControlSchedule API is not supported for MavLink vehicles");
+    }
+
     virtual bool isReady(std::string& message) const override
     {
         if (!is_ready_)
@@ -701,12 +714,7 @@ private: //methods
     {
         StatusLock lock(this);
         if (mav_vehicle_ != nullptr) {
-            int version = mav_vehicle_->getVehicleStateVersion();
-            if (version != state_version_)
-            {
-                current_state_ = mav_vehicle_->getVehicleState();
-                state_version_ = version;
-            }
+            mav_vehicle_->getVehicleStateIfNewer(state_version_, current_state_);
         }
     }
 
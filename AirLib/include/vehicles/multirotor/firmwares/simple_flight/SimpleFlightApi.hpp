@@ -296,6 +296,24 @@ private:
         remote_control_id_ = vehicle_setting.rc.remote_control_id;
         params_.rc.allow_api_when_disconnected = vehicle_setting.rc.allow_api_when_disconnected;
         params_.rc.allow_api_always = vehicle_setting.allow_api_always;
+
+        //velocity and position controllers have y on axis 0 and x on axis 1
+        const auto& gains = vehicle_setting.gains;
+        setAxisGains(gains.angle_rate_p, 0, 1, 2, params_.angle_rate_pid.p);
+        setAxisGains(gains.angle_level_p, 0, 1, 2, params_.angle_level_pid.p);
+        setAxisGains(gains.velocity_p, 1, 0, 3, params_.velocity_pid.p);
+        setAxisGains(gains.velocity_i, 1, 0, 3, params_.velocity_pid.i);
+        setAxisGains(gains.position_p, 1, 0, 3, params_.position_pid.p);
+    }
+
+    static void setAxisGains(const Vector3r& gains, unsigned int x_axis, unsigned int y_axis, unsigned int z_axis,
+        simple_flight::Axis4r& axes)
+    {
+        const unsigned int axis_indices[] = { x_axis, y_axis, z_axis };
+        for (unsigned int i = 0; i < 3; ++i) {
+            if (!std::isnan(gains[i]))
+                axes[axis_indices[i]] = gains[i];
+        }
     }
 
 private:
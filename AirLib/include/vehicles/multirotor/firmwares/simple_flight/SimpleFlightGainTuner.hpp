@@ -0,0 +1,474 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef msr_airlib_SimpleFlightGainTuner_hpp
+#define msr_airlib_SimpleFlightGainTuner_hpp
+
+#include "SimpleFlightQuadXParams.hpp"
+#include "vehicles/multirotor/MultiRotor.hpp"
+#include "physics/FastPhysicsEngine.hpp"
+#include "common/SteppableClock.hpp"
+#include "common/AirSimSettings.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <random>
+#include <thread>
+
+namespace msr { namespace airlib {
+
+/*
+    SimpleFlightGainTuner searches the PID gains of simple_flight without the simulator. Every flight runs a
+    SimpleFlightQuadXParams vehicle in FastPhysicsEngine on its own steppable clock domain, so flights run side by
+    side on all cores and their results do not depend on the number of threads.
+
+    A candidate flies every test case after hovering for warmup seconds and is scored on settling time, overshoot,
+    tracking error and control effort. The search is the cross entropy method on the logarithm of the gains: each
+    iteration samples a population around the mean and then moves the mean and spread to the best candidates. The
+    best gains found so far are part of every population, so the result is never worse than the starting gains.
+    getSettingsPatch() writes gains as a patch for settings.json.
+*/
+class SimpleFlightGainTuner {
+public:
+    typedef AirSimSettings::SimpleFlightGains Gains;
+
+    enum class TestCaseType {
+        Step, //position moves by vector meters and yaw to value degrees
+        Disturbance, //position is held while velocity jumps by vector m/s and roll rate by value rad/s
+        Trajectory //circle with radii vector.x, vector.y and vertical amplitude vector.z, one lap takes value seconds
+    };
+
+    struct TestCase {
+        std::string name;
+        TestCaseType type;
+        Vector3r vector;
+        real_T value;
+        TTimeDelta duration;
+    };
+
+    struct Weights {
+        real_T settling_time = 1; //per second, cases that do not settle count their whole duration
+        real_T overshoot = 4; //per fraction of the step or of the peak disturbance
+        real_T tracking_error = 2; //per meter of RMS position error
+        real_T control_effort = 0.1f; //per unit of rotor signal travel per second
+        real_T divergence = 1000; //cost of a case that flew away or produced nan
+    };
+
+    struct Options {
+        uint population = 48;
+        uint elite_count = 8;
+        uint iterations = 8;
+        real_T initial_spread = 0.4f; //standard deviation of the log gains
+        real_T min_spread = 0.02f;
+        real_T max_gain_factor = 10; //gains stay within this factor of the starting gains
+
+        TTimeDelta step_size = 3E-3;
+        TTimeDelta warmup = 3;
+        real_T settling_distance = 0.1f; //meters
+        real_T settling_yaw = 2; //degrees
+        real_T divergence_distance = 50; //meters
+
+        uint thread_count = 0; //0 means one per core
+        uint seed = 1;
+        Weights weights;
+    };
+
+    struct Score {
+        real_T settling_time = 0;
+        real_T overshoot = 0;
+        real_T tracking_error = 0;
+        real_T control_effort = 0;
+        bool diverged = false;
+        real_T cost = 0;
+    };
+
+    struct Result {
+        Gains gains;
+        real_T cost = 0;
+        real_T initial_cost = 0;
+        vector<Score> scores; //of gains for each test case
+        uint flights = 0;
+        TTimeDelta simulated_seconds = 0;
+    };
+
+public:
+    SimpleFlightGainTuner()
+        : SimpleFlightGainTuner(defaultTestCases(), Options())
+    {
+    }
+
+    SimpleFlightGainTuner(const vector<TestCase>& test_cases, const Options& options)
+        : test_cases_(test_cases), options_(options), sensor_factory_(std::make_shared<SensorFactory>())
+    {
+        if (test_cases_.size() == 0)
+            throw std::invalid_argument("SimpleFlightGainTuner needs at least one test case");
+        if (options_.elite_count == 0 || options_.population <= options_.elite_count)
+            throw std::invalid_argument("SimpleFlightGainTuner population must be larger than the elite count");
+        if (!(options_.step_size > 0))
+            throw std::invalid_argument("SimpleFlightGainTuner step size must be positive");
+    }
+
+    static vector<TestCase> defaultTestCases()
+    {
+        return vector<TestCase> {
+            { "StepX", TestCaseType::Step, Vector3r(4, 0, 0), 0, 8 },
+            { "StepZYaw", TestCaseType::Step, Vector3r(0, 0, -2), 90, 8 },
+            { "Disturbance", TestCaseType::Disturbance, Vector3r(2, -1, 1), 3, 6 },
+            { "Circle", TestCaseType::Trajectory, Vector3r(3, 3, 0.5f), 10, 10 }
+        };
+    }
+
+    //gains compiled in to simple_flight
+    static Gains getDefaultGains()
+    {
+        simple_flight::Params params;
+        Gains gains;
+        gains.angle_rate_p = Vector3r(params.angle_rate_pid.p[0], params.angle_rate_pid.p[1], params.angle_rate_pid.p[2]);
+        gains.angle_level_p = Vector3r(params.angle_level_pid.p[0], params.angle_level_pid.p[1], params.angle_level_pid.p[2]);
+        gains.velocity_p = Vector3r(params.velocity_pid.p[1], params.velocity_pid.p[0], params.velocity_pid.p[3]);
+        gains.velocity_i = Vector3r(params.velocity_pid.i[1], params.velocity_pid.i[0], params.velocity_pid.i[3]);
+        gains.position_p = Vector3r(params.position_pid.p[1], params.position_pid.p[0], params.position_pid.p[3]);
+        return gains;
+    }
+
+    //fills nan gains with the defaults
+    static Gains withDefaults(const Gains& gains)
+    {
+        Gains defaults = getDefaultGains();
+        Gains result = gains;
+        fillNan(result.angle_rate_p, defaults.angle_rate_p);
+        fillNan(result.angle_level_p, defaults.angle_level_p);
+        fillNan(result.velocity_p, defaults.velocity_p);
+        fillNan(result.velocity_i, defaults.velocity_i);
+        fillNan(result.position_p, defaults.position_p);
+        return result;
+    }
+
+    //flies one test case
+    Score fly(const Gains& gains, const TestCase& test_case) const
+    {
+        //a fixed start keeps the millisecond rounding of the firmware the same on every flight
+        SteppableClock clock(options_.step_size, 1000000000);
+        ClockFactory::DomainScope clock_scope(&clock);
+
+        AirSimSettings::VehicleSetting setting;
+        setting.vehicle_name = "SimpleFlight";
+        setting.vehicle_type = AirSimSettings::kVehicleTypeSimpleFlight;
+        setting.gains = gains;
+        SimpleFlightQuadXParams params(&setting, sensor_factory_);
+        params.initialize(&setting);
+        TunedApi api(&params, &setting);
+
+        const Vector3r start(0, 0, -10);
+        MultiRotor vehicle(&params, &api, Pose(start, Quaternionr::Identity()), GeoPoint(47.641468, -122.140165, 122));
+        api.setSimulatedGroundTruth(&vehicle.getKinematics(), &vehicle.getEnvironment());
+        FastPhysicsEngine physics;
+        physics.insert(&vehicle);
+        vehicle.reset();
+        physics.reset();
+        api.reset();
+        api.enableApiControl(true);
+        api.armDisarm(true);
+
+        const uint warmup_steps = static_cast<uint>(options_.warmup / options_.step_size);
+        const uint case_steps = std::max(1u, static_cast<uint>(test_case.duration / options_.step_size));
+        const real_T dt = static_cast<real_T>(options_.step_size);
+        const Vector3r direction = test_case.vector.norm() > 0 ? test_case.vector.normalized() : Vector3r::Zero();
+
+        Score score;
+        vector<real_T> actuation(api.getActuatorCount());
+        real_T settled_at = 0, max_along = 0, min_along = 0, error_sum = 0, signal_travel = 0;
+        uint flown_steps = 0;
+        for (uint step = 0; step < warmup_steps + case_steps; ++step) {
+            const bool is_warmup = step < warmup_steps;
+            const real_T t = is_warmup ? 0 : (step - warmup_steps) * dt;
+
+            Vector3r target = start;
+            real_T target_yaw = 0;
+            if (!is_warmup) {
+                switch (test_case.type) {
+                case TestCaseType::Step:
+                    target += test_case.vector;
+                    target_yaw = test_case.value;
+                    break;
+                case TestCaseType::Disturbance:
+                    if (step == warmup_steps) {
+                        Kinematics::State state = vehicle.getKinematics();
+                        state.twist.linear += test_case.vector;
+                        state.twist.angular.x() += test_case.value;
+                        vehicle.setKinematics(state);
+                    }
+                    break;
+                case TestCaseType::Trajectory: {
+                    real_T phase = 2 * M_PIf * t / test_case.value;
+                    target += Vector3r(test_case.vector.x() * std::sin(phase), test_case.vector.y() * (1 - std::cos(phase)),
+                        test_case.vector.z() * std::sin(phase));
+                    break;
+                }
+                default:
+                    throw std::invalid_argument("SimpleFlightGainTuner got an unknown test case type");
+                }
+            }
+            api.commandPosition(target.x(), target.y(), target.z(), YawMode(false, target_yaw));
+
+            clock.step();
+            vehicle.update();
+            physics.update();
+
+            if (is_warmup) {
+                for (uint i = 0; i < actuation.size(); ++i)
+                    actuation[i] = api.getActuation(i);
+                continue;
+            }
+
+            const Kinematics::State& state = vehicle.getKinematics();
+            Vector3r error = state.pose.position - target;
+            real_T yaw_error = std::fabs(VectorMath::normalizeAngle(
+                Utils::radiansToDegrees(VectorMath::yawFromQuaternion(state.pose.orientation)) - target_yaw));
+            if (!error.allFinite() || !(error.norm() < options_.divergence_distance)) {
+                score.diverged = true;
+                break;
+            }
+
+            ++flown_steps;
+            error_sum += error.squaredNorm();
+            if (error.norm() > options_.settling_distance || yaw_error > options_.settling_yaw)
+                settled_at = t + dt;
+            real_T along = error.dot(direction);
+            max_along = std::max(max_along, along);
+            min_along = std::min(min_along, along);
+            for (uint i = 0; i < actuation.size(); ++i) {
+                real_T signal = api.getActuation(i);
+                signal_travel += std::fabs(signal - actuation[i]);
+                actuation[i] = signal;
+            }
+        }
+
+        const Weights& weights = options_.weights;
+        if (score.diverged) {
+            score.cost = weights.divergence;
+            return score;
+        }
+
+        const real_T duration = flown_steps * dt;
+        score.tracking_error = std::sqrt(error_sum / flown_steps);
+        score.control_effort = signal_travel / duration;
+        switch (test_case.type) {
+        case TestCaseType::Step:
+            score.settling_time = settled_at;
+            //error starts at -vector, going past the target makes it positive
+            score.overshoot = test_case.vector.norm() > 0 ? max_along / test_case.vector.norm() : 0;
+            break;
+        case TestCaseType::Disturbance:
+            score.settling_time = settled_at;
+            //the kick pushes error along the vector, swinging back past the start makes it negative
+            score.overshoot = max_along > 0 ? -min_along / max_along : 0;
+            break;
+        case TestCaseType::Trajectory:
+            break;
+        default:
+            throw std::invalid_argument("SimpleFlightGainTuner got an unknown test case type");
+        }
+        score.cost = weights.settling_time * score.settling_time + weights.overshoot * score.overshoot
+            + weights.tracking_error * score.tracking_error + weights.control_effort * score.control_effort;
+        return score;
+    }
+
+    //flies all test cases for each candidate on worker threads, costs are summed over test cases
+    void evaluate(const vector<Gains>& candidates, vector<real_T>& costs, vector<vector<Score>>& scores) const
+    {
+        const size_t case_count = test_cases_.size();
+        const size_t flight_count = candidates.size() * case_count;
+        scores.assign(candidates.size(), vector<Score>(case_count));
+
+        std::atomic<size_t> next_flight(0);
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        auto worker = [&]() {
+            try {
+                for (size_t flight = next_flight++; flight < flight_count; flight = next_flight++)
+                    scores[flight / case_count][flight % case_count] = fly(candidates[flight / case_count], test_cases_[flight % case_count]);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                error = std::current_exception();
+                next_flight = flight_count;
+            }
+        };
+
+        size_t thread_count = options_.thread_count;
+        if (thread_count == 0)
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        thread_count = std::min(thread_count, flight_count);
+        vector<std::thread> threads;
+        for (size_t i = 1; i < thread_count; ++i)
+            threads.emplace_back(worker);
+        worker();
+        for (auto& thread : threads)
+            thread.join();
+        if (error)
+            std::rethrow_exception(error);
+
+        costs.assign(candidates.size(), 0);
+        for (size_t i = 0; i < candidates.size(); ++i)
+            for (const Score& score : scores[i])
+                costs[i] += score.cost;
+    }
+
+    Result tune(const Gains& initial_gains = Gains()) const
+    {
+        const Gains start = withDefaults(initial_gains);
+        const vector<real_T> center = toLogGains(start);
+        const real_T log_limit = std::log(options_.max_gain_factor);
+        vector<real_T> mean = center, best = center;
+        vector<real_T> spread(center.size(), options_.initial_spread);
+
+        std::mt19937 rng(options_.seed);
+        std::normal_distribution<real_T> normal;
+
+        Result result;
+        result.cost = std::numeric_limits<real_T>::infinity();
+        for (uint iteration = 0; iteration < options_.iterations; ++iteration) {
+            vector<vector<real_T>> points(options_.population, best);
+            vector<Gains> candidates;
+            for (uint i = 0; i < options_.population; ++i) {
+                if (i > 0) {
+                    for (size_t d = 0; d < mean.size(); ++d)
+                        points[i][d] = Utils::clip(mean[d] + spread[d] * normal(rng), center[d] - log_limit, center[d] + log_limit);
+                }
+                candidates.push_back(fromLogGains(points[i], start));
+            }
+
+            vector<real_T> costs;
+            vector<vector<Score>> scores;
+            evaluate(candidates, costs, scores);
+            if (iteration == 0)
+                result.initial_cost = costs[0];
+
+            vector<uint> order(options_.population);
+            for (uint i = 0; i < order.size(); ++i)
+                order[i] = i;
+            std::stable_sort(order.begin(), order.end(), [&costs](uint a, uint b) { return costs[a] < costs[b]; });
+            if (costs[order[0]] < result.cost) {
+                result.cost = costs[order[0]];
+                result.scores = scores[order[0]];
+                best = points[order[0]];
+            }
+
+            for (size_t d = 0; d < mean.size(); ++d) {
+                real_T sum = 0, square_sum = 0;
+                for (uint e = 0; e < options_.elite_count; ++e) {
+                    sum += points[order[e]][d];
+                    square_sum += points[order[e]][d] * points[order[e]][d];
+                }
+                mean[d] = sum / options_.elite_count;
+                spread[d] = std::max(options_.min_spread,
+                    std::sqrt(std::max(0.0f, square_sum / options_.elite_count - mean[d] * mean[d])));
+            }
+        }
+
+        result.gains = fromLogGains(best, start);
+        result.flights = options_.iterations * options_.population * static_cast<uint>(test_cases_.size());
+        TTimeDelta seconds_per_candidate = 0;
+        for (const TestCase& test_case : test_cases_)
+            seconds_per_candidate += options_.warmup + test_case.duration;
+        result.simulated_seconds = seconds_per_candidate * options_.iterations * options_.population;
+        return result;
+    }
+
+    //a JSON merge patch for settings.json that sets the gains of the vehicle
+    static std::string getSettingsPatch(const Gains& gains, const std::string& vehicle_name = "SimpleFlight")
+    {
+        Gains complete = withDefaults(gains);
+        return Utils::stringf(
+            "{\n"
+            "  \"Vehicles\": {\n"
+            "    \"%s\": {\n"
+            "      \"VehicleType\": \"SimpleFlight\",\n"
+            "      \"Gains\": {\n"
+            "        \"AngleRateP\": %s,\n"
+            "        \"AngleLevelP\": %s,\n"
+            "        \"VelocityP\": %s,\n"
+            "        \"VelocityI\": %s,\n"
+            "        \"PositionP\": %s\n"
+            "      }\n"
+            "    }\n"
+            "  }\n"
+            "}\n",
+            vehicle_name.c_str(),
+            toJson(complete.angle_rate_p, "Roll", "Pitch", "Yaw").c_str(),
+            toJson(complete.angle_level_p, "Roll", "Pitch", "Yaw").c_str(),
+            toJson(complete.velocity_p, "X", "Y", "Z").c_str(),
+            toJson(complete.velocity_i, "X", "Y", "Z").c_str(),
+            toJson(complete.position_p, "X", "Y", "Z").c_str());
+    }
+
+    const vector<TestCase>& getTestCases() const
+    {
+        return test_cases_;
+    }
+
+    const Options& getOptions() const
+    {
+        return options_;
+    }
+
+private:
+    //lets the tuner command positions directly instead of through the blocking move APIs
+    class TunedApi : public SimpleFlightApi {
+    public:
+        TunedApi(const MultiRotorParams* vehicle_params, const AirSimSettings::VehicleSetting* vehicle_setting)
+            : SimpleFlightApi(vehicle_params, vehicle_setting)
+        {
+        }
+
+        using SimpleFlightApi::commandPosition;
+    };
+
+    static void fillNan(Vector3r& gains, const Vector3r& defaults)
+    {
+        for (int i = 0; i < 3; ++i) {
+            if (std::isnan(gains[i]))
+                gains[i] = defaults[i];
+        }
+    }
+
+    //x and y as well as roll and pitch share a gain because the vehicle is symmetric,
+    //integral gains that start at zero are left alone
+    static vector<real_T> toLogGains(const Gains& gains)
+    {
+        vector<real_T> values = { gains.angle_rate_p.x(), gains.angle_rate_p.z(), gains.angle_level_p.x(), gains.angle_level_p.z(),
+            gains.velocity_p.x(), gains.velocity_p.z(), gains.velocity_i.z(), gains.position_p.x(), gains.position_p.z() };
+        for (real_T& value : values) {
+            if (!(value > 0))
+                throw std::invalid_argument("SimpleFlightGainTuner can only tune gains that start above zero");
+            value = std::log(value);
+        }
+        return values;
+    }
+
+    static Gains fromLogGains(const vector<real_T>& values, const Gains& start)
+    {
+        Gains gains = start;
+        gains.angle_rate_p = Vector3r(std::exp(values[0]), std::exp(values[0]), std::exp(values[1]));
+        gains.angle_level_p = Vector3r(std::exp(values[2]), std::exp(values[2]), std::exp(values[3]));
+        gains.velocity_p = Vector3r(std::exp(values[4]), std::exp(values[4]), std::exp(values[5]));
+        gains.velocity_i.z() = std::exp(values[6]);
+        gains.position_p = Vector3r(std::exp(values[7]), std::exp(values[7]), std::exp(values[8]));
+        return gains;
+    }
+
+    static std::string toJson(const Vector3r& gains, const char* x_name, const char* y_name, const char* z_name)
+    {
+        return Utils::stringf("{ \"%s\": %.6g, \"%s\": %.6g, \"%s\": %.6g }",
+            x_name, gains.x(), y_name, gains.y(), z_name, gains.z());
+    }
+
+private:
+    vector<TestCase> test_cases_;
+    Options options_;
+    std::shared_ptr<const SensorFactory> sensor_factory_;
+};
+
+}} //namespace
+#endif
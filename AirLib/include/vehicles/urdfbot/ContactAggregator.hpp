@@ -0,0 +1,195 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_ContactAggregator_hpp
+#define air_ContactAggregator_hpp
+
+#include "common/Common.hpp"
+#include "sensors/contact/ContactBase.hpp"
+#include <map>
+#include <regex>
+#include <unordered_map>
+
+namespace msr { namespace airlib {
+
+/*
+    Filters and sums the hits on the links of a robot, one physics step at a time.
+
+    A link can ignore other objects whose name matches one of its filter patterns. The decision for a link and
+    another component is made the first time they touch and cached, so a link dragging over the same terrain
+    costs a hash lookup per hit instead of a regex match. Other components are told apart by a 32 bit id that
+    must stay unique while the cache lives; call clearFilterCache() when components may have been destroyed.
+
+    Hits that pass are summed per link until endStep(), which turns them in to the contact summary of the step
+    and adds them to the running totals handed out to contact sensors.
+*/
+class ContactAggregator {
+public:
+    //the hits on one link in the last step, location and impulse in the frame of the link
+    struct ContactSummary {
+        uint count = 0;
+        Vector3r normal_impulse = Vector3r::Zero();
+        Vector3r centroid = Vector3r::Zero();
+    };
+
+    ContactAggregator()
+    {
+    }
+
+    explicit ContactAggregator(const vector<std::string>& link_names)
+    {
+        initialize(link_names);
+    }
+
+    void initialize(const vector<std::string>& link_names)
+    {
+        link_names_ = link_names;
+        link_index_.clear();
+        for (uint i = 0; i < link_names_.size(); ++i)
+            link_index_[link_names_[i]] = static_cast<int>(i);
+
+        filters_.assign(link_names_.size(), vector<std::regex>());
+        clearFilterCache();
+        reset();
+    }
+
+    //hits on the link from objects whose name contains a match for the ECMAScript pattern are ignored
+    void addFilter(const std::string& link_name, const std::string& pattern)
+    {
+        int index = getLinkIndex(link_name);
+        if (index < 0)
+            throw std::runtime_error("Collision filter '" + pattern + "' is for link '" + link_name + "', which the robot does not have.");
+
+        try {
+            filters_[index].emplace_back(pattern, std::regex::ECMAScript | std::regex::optimize);
+        }
+        catch (const std::regex_error& error) {
+            throw std::runtime_error("Collision filter '" + pattern + "' for link '" + link_name + "' is not a valid regular expression: " + error.what());
+        }
+        clearFilterCache();
+    }
+
+    //-1 if the robot has no such link
+    int getLinkIndex(const std::string& link_name) const
+    {
+        auto found = link_index_.find(link_name);
+        return found == link_index_.end() ? -1 : found->second;
+    }
+
+    const vector<std::string>& getLinkNames() const
+    {
+        return link_names_;
+    }
+
+    //get_other_name() is only called when the pair is not in the cache yet
+    template<typename NameGetter>
+    bool isFiltered(uint link_index, uint32_t other_id, NameGetter get_other_name)
+    {
+        const vector<std::regex>& filters = filters_[link_index];
+        if (filters.empty())
+            return false;
+
+        uint64_t key = (static_cast<uint64_t>(link_index) << 32) | other_id;
+        auto cached = filter_cache_.find(key);
+        if (cached != filter_cache_.end())
+            return cached->second;
+
+        const std::string other_name = get_other_name();
+        bool filtered = false;
+        for (const auto& filter : filters) {
+            if (std::regex_search(other_name, filter)) {
+                filtered = true;
+                break;
+            }
+        }
+        filter_cache_.emplace(key, filtered);
+        return filtered;
+    }
+
+    //returns true for the first hit on the link in this step that is not filtered out
+    template<typename NameGetter>
+    bool addHit(uint link_index, uint32_t other_id, NameGetter get_other_name, const Vector3r& location, const Vector3r& normal_impulse)
+    {
+        if (isFiltered(link_index, other_id, get_other_name))
+            return false;
+
+        Pending& pending = pending_[link_index];
+        pending.normal_impulse += normal_impulse;
+        pending.location_sum += location;
+        return ++pending.count == 1;
+    }
+
+    //closes the current step
+    void endStep()
+    {
+        for (uint i = 0; i < pending_.size(); ++i) {
+            Pending& pending = pending_[i];
+            ContactSummary& summary = summaries_[i];
+            summary.count = pending.count;
+            summary.normal_impulse = pending.normal_impulse;
+            summary.centroid = pending.count > 0 ? Vector3r(pending.location_sum / static_cast<real_T>(pending.count)) : Vector3r::Zero();
+
+            if (pending.count > 0) {
+                ContactBase::ContactTotals& totals = totals_[i];
+                totals.count += pending.count;
+                totals.normal_impulse += pending.normal_impulse.cast<double>();
+                totals.location_sum += pending.location_sum.cast<double>();
+            }
+            pending = Pending();
+        }
+    }
+
+    const ContactSummary& getStepContacts(uint link_index) const
+    {
+        return summaries_[link_index];
+    }
+
+    //running totals since reset(), in the form contact sensors read
+    bool getTotals(const std::string& link_name, ContactBase::ContactTotals& totals) const
+    {
+        int index = getLinkIndex(link_name);
+        if (index < 0)
+            return false;
+        totals = totals_[index];
+        return true;
+    }
+
+    //clears contacts and totals, the filter cache stays
+    void reset()
+    {
+        pending_.assign(link_names_.size(), Pending());
+        summaries_.assign(link_names_.size(), ContactSummary());
+        totals_.assign(link_names_.size(), ContactBase::ContactTotals());
+    }
+
+    void clearFilterCache()
+    {
+        filter_cache_.clear();
+    }
+
+    uint getFilterCacheSize() const
+    {
+        return static_cast<uint>(filter_cache_.size());
+    }
+
+private:
+    struct Pending {
+        uint count = 0;
+        Vector3r normal_impulse = Vector3r::Zero();
+        Vector3r location_sum = Vector3r::Zero();
+    };
+
+private:
+    vector<std::string> link_names_;
+    std::map<std::string, int> link_index_;
+
+    vector<vector<std::regex>> filters_;
+    std::unordered_map<uint64_t, bool> filter_cache_;
+
+    vector<Pending> pending_;
+    vector<ContactSummary> summaries_;
+    vector<ContactBase::ContactTotals> totals_;
+};
+
+}} //namespace
+#endif
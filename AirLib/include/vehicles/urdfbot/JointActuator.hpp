@@ -0,0 +1,236 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_JointActuator_hpp
+#define air_JointActuator_hpp
+
+#include "common/Common.hpp"
+#include "parser/UrdfSpecification.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    Brushed DC motor driving a joint through a gearbox, which turns a position or velocity target in to the effort
+    (N m, or N for prismatic joints) to apply to the joint.
+
+    A PD controller sets the winding voltage, limited to the supply. The winding current follows with the L/R lag
+    and is clipped to the current limit, so the effort falls linearly from the stall effort to zero at the no-load
+    speed. The gear multiplies torque by ratio * efficiency. Backlash is modelled as free play at the joint: when
+    the motor reverses, the rotor crosses the gap on its own inertia and no effort reaches the joint until it closes.
+
+    Joint positions and velocities are at the joint side of the gear, in radians or meters.
+*/
+class JointActuator {
+public:
+    JointActuator(const UrdfActuator& params = UrdfActuator())
+        : params_(params)
+    {
+        //the effort below which the joint is left alone, so sleeping bodies stay asleep
+        idle_effort_ = getStallEffort() * 1E-4f;
+    }
+
+    const UrdfActuator& getParams() const
+    {
+        return params_;
+    }
+
+    void setPositionTarget(real_T position, real_T velocity = 0)
+    {
+        setCommand(Mode::Position, position, velocity);
+    }
+
+    void setVelocityTarget(real_T velocity)
+    {
+        setCommand(Mode::Velocity, 0, velocity);
+    }
+
+    //open loop, clipped to the supply
+    void setVoltage(real_T voltage)
+    {
+        setCommand(Mode::Voltage, voltage, 0);
+    }
+
+    //steps the motor with the measured joint state and returns the effort on the joint
+    real_T update(TTimeDelta dt, real_T position, real_T velocity)
+    {
+        if (dt <= 0)
+            return effort_;
+        real_T h = static_cast<real_T>(dt);
+
+        if (!initialized_) {
+            motor_position_ = position;
+            motor_velocity_ = velocity;
+            initialized_ = true;
+        }
+
+        voltage_ = clip(getControlVoltage(position, velocity), -params_.voltage, params_.voltage);
+
+        if (params_.backlash <= 0 || engaged_side_ != 0) {
+            motor_position_ = position + engaged_side_ * params_.backlash * 0.5f;
+            motor_velocity_ = velocity;
+        }
+
+        real_T rotor_velocity = motor_velocity_ * params_.gear_ratio;
+        real_T steady_current = (voltage_ - params_.torque_constant * rotor_velocity) / params_.resistance;
+        if (params_.inductance > 0)
+            current_ = steady_current + (current_ - steady_current) * std::exp(-h * params_.resistance / params_.inductance);
+        else
+            current_ = steady_current;
+        if (params_.current_limit > 0)
+            current_ = clip(current_, -params_.current_limit, params_.current_limit);
+
+        real_T rotor_torque = params_.torque_constant * current_ - params_.rotor_friction * rotor_velocity;
+        real_T drive = rotor_torque * params_.gear_ratio * params_.gear_efficiency;
+
+        if (params_.backlash <= 0)
+            effort_ = drive;
+        else
+            effort_ = updateBacklash(h, position, velocity, drive);
+
+        active_ = command_changed_ || std::abs(effort_) > idle_effort_;
+        command_changed_ = false;
+        return effort_;
+    }
+
+    real_T getEffort() const
+    {
+        return effort_;
+    }
+
+    real_T getCurrent() const
+    {
+        return current_;
+    }
+
+    real_T getVoltage() const
+    {
+        return voltage_;
+    }
+
+    //rotor position and velocity at the joint side of the gear
+    real_T getMotorPosition() const
+    {
+        return motor_position_;
+    }
+
+    real_T getMotorVelocity() const
+    {
+        return motor_velocity_;
+    }
+
+    //false while the rotor is crossing the backlash gap
+    bool isEngaged() const
+    {
+        return params_.backlash <= 0 || engaged_side_ != 0;
+    }
+
+    //true when the last update had no new command and no effort worth applying
+    bool isIdle() const
+    {
+        return !active_;
+    }
+
+    //effort at zero speed and full voltage
+    real_T getStallEffort() const
+    {
+        real_T current = params_.voltage / params_.resistance;
+        if (params_.current_limit > 0)
+            current = std::min(current, params_.current_limit);
+        return params_.torque_constant * current * params_.gear_ratio * params_.gear_efficiency;
+    }
+
+    //joint speed where back EMF cancels the full supply voltage
+    real_T getNoLoadVelocity() const
+    {
+        return params_.voltage / (params_.torque_constant * params_.gear_ratio);
+    }
+
+private:
+    enum class Mode {
+        Position, Velocity, Voltage
+    };
+
+    static real_T clip(real_T value, real_T lower, real_T upper)
+    {
+        return std::max(lower, std::min(value, upper));
+    }
+
+    void setCommand(Mode mode, real_T value, real_T velocity)
+    {
+        if (mode != mode_ || value != command_ || velocity != command_velocity_)
+            command_changed_ = true;
+        mode_ = mode;
+        command_ = value;
+        command_velocity_ = velocity;
+    }
+
+    real_T getControlVoltage(real_T position, real_T velocity) const
+    {
+        switch (mode_) {
+        case Mode::Position:
+            return params_.position_gain * (command_ - position) + params_.velocity_gain * (command_velocity_ - velocity);
+        case Mode::Velocity:
+            //feed forward the back EMF at the target speed so the loop only corrects for load
+            return params_.torque_constant * params_.gear_ratio * command_velocity_ + params_.velocity_gain * (command_velocity_ - velocity);
+        default:
+            return command_;
+        }
+    }
+
+    real_T updateBacklash(real_T h, real_T position, real_T velocity, real_T drive)
+    {
+        real_T half_gap = params_.backlash * 0.5f;
+
+        //stay in contact while the motor pushes in to the side it touches
+        if (engaged_side_ != 0 && drive * engaged_side_ > 0)
+            return drive;
+        engaged_side_ = 0;
+
+        real_T rotor_inertia = params_.rotor_inertia * params_.gear_ratio * params_.gear_ratio;
+        if (rotor_inertia <= 0) {
+            if (drive == 0)
+                return 0;
+
+            //a rotor without inertia crosses the gap at once
+            engaged_side_ = drive > 0 ? 1 : -1;
+            motor_position_ = position + engaged_side_ * half_gap;
+            motor_velocity_ = velocity;
+            return drive;
+        }
+
+        //the rotor is stepped to the end of the tick, so compare it with where the joint will be then
+        motor_velocity_ += drive / rotor_inertia * h;
+        motor_position_ += motor_velocity_ * h;
+        real_T next_position = position + velocity * h;
+
+        real_T gap = motor_position_ - next_position;
+        if (std::abs(gap) >= half_gap) {
+            engaged_side_ = gap > 0 ? 1 : -1;
+            motor_position_ = next_position + engaged_side_ * half_gap;
+            motor_velocity_ = velocity;
+            return drive * engaged_side_ > 0 ? drive : 0;
+        }
+        return 0;
+    }
+
+private:
+    UrdfActuator params_;
+    real_T idle_effort_;
+
+    Mode mode_ = Mode::Voltage;
+    real_T command_ = 0;
+    real_T command_velocity_ = 0;
+    bool command_changed_ = false;
+    bool active_ = false;
+
+    bool initialized_ = false;
+    real_T voltage_ = 0;
+    real_T current_ = 0;
+    real_T effort_ = 0;
+    real_T motor_position_ = 0;
+    real_T motor_velocity_ = 0;
+    int engaged_side_ = 0;
+};
+
+}} //namespace
+#endif
@@ -0,0 +1,327 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_JointCoupling_hpp
+#define air_JointCoupling_hpp
+
+#include "common/Common.hpp"
+#include "parser/UrdfSpecification.hpp"
+#include <map>
+
+namespace msr { namespace airlib {
+
+/*
+    Turns commanded joint targets in to set points that respect the URDF joint limits, once per tick.
+
+    Revolute, prismatic and continuous joints take part. Every tick the commanded position (or velocity) of each
+    joint is moved towards at no more than the <limit> velocity, kept inside the <limit> range narrowed by the
+    <safety_controller> soft limits, and slowed down near the soft limits with the same velocity bounds as ROS,
+    -k_position * (position - soft_limit). Joints with a <mimic> element can't be commanded; their set point is
+    always multiplier * leader + offset. The limits of followers are folded back in to their leader, so a leader
+    never moves where one of its followers would break its own limits and coupled joints stay exactly consistent.
+
+    Positions are in joint units (radians or meters) as written in the URDF. The calibration reference of a joint
+    is its rising edge, or the falling edge if only that is given; toCalibrated() gives positions relative to it.
+*/
+class JointCoupling {
+public:
+    JointCoupling()
+    {
+    }
+
+    explicit JointCoupling(const UrdfRobot& robot)
+    {
+        initialize(robot);
+    }
+
+    void initialize(const UrdfRobot& robot)
+    {
+        joints_.clear();
+        index_.clear();
+
+        //order joints so every leader comes before its followers
+        std::map<std::string, int> visit_state;
+        for (const auto& kvp : robot.joints)
+            if (isMovable(kvp.second.type))
+                addJoint(robot, kvp.second, visit_state);
+
+        //fold follower limits in to their leaders, deepest followers first
+        for (size_t i = joints_.size(); i-- > 0;) {
+            const Joint& follower = joints_[i];
+            if (follower.leader < 0)
+                continue;
+
+            Joint& leader = joints_[follower.leader];
+            real_T m = follower.multiplier;
+            if (m == 0) {
+                if (follower.offset < follower.lower || follower.offset > follower.upper)
+                    throw std::runtime_error("Joint '" + follower.name + "' mimics '" + leader.name + "' with a multiplier of 0 and an offset outside of its limits.");
+                continue;
+            }
+
+            real_T a = (follower.lower - follower.offset) / m;
+            real_T b = (follower.upper - follower.offset) / m;
+            leader.lower = std::max(leader.lower, std::min(a, b));
+            leader.upper = std::min(leader.upper, std::max(a, b));
+            leader.max_velocity = std::min(leader.max_velocity, follower.max_velocity / std::abs(m));
+
+            if (leader.lower > leader.upper)
+                throw std::runtime_error("The limits of the joints that mimic '" + leader.name + "' leave it no position to move to.");
+        }
+
+        for (auto& joint : joints_) {
+            if (joint.leader < 0)
+                joint.position = clip(0, joint.lower, joint.upper);
+            else
+                joint.position = joint.multiplier * joints_[joint.leader].position + joint.offset;
+            joint.command = joint.position;
+        }
+
+        step_min_.assign(joints_.size(), 0);
+        step_max_.assign(joints_.size(), 0);
+    }
+
+    bool contains(const std::string& name) const
+    {
+        return index_.find(name) != index_.end();
+    }
+
+    bool isFollower(const std::string& name) const
+    {
+        return joints_[indexOf(name)].leader >= 0;
+    }
+
+    //moves the joint towards the position at the limited rate
+    void setPositionTarget(const std::string& name, real_T position)
+    {
+        Joint& joint = commandable(name, position);
+        joint.command = position;
+        joint.command_is_velocity = false;
+    }
+
+    //moves the joint at the velocity until a position limit is reached
+    void setVelocityTarget(const std::string& name, real_T velocity)
+    {
+        Joint& joint = commandable(name, velocity);
+        joint.command = velocity;
+        joint.command_is_velocity = true;
+    }
+
+    //places a joint that is not a follower at a measured position and holds it there
+    void resetPosition(const std::string& name, real_T position)
+    {
+        Joint& joint = commandable(name, position);
+        joint.position = clip(position, joint.lower, joint.upper);
+        joint.velocity = 0;
+        joint.command = joint.position;
+        joint.command_is_velocity = false;
+
+        uint index = indexOf(name);
+        for (uint i = index + 1; i < joints_.size(); ++i)
+            if (joints_[i].leader >= 0)
+                follow(joints_[i]);
+    }
+
+    void update(TTimeDelta dt)
+    {
+        if (dt <= 0)
+            return;
+        real_T step_dt = static_cast<real_T>(dt);
+
+        for (uint i = 0; i < joints_.size(); ++i) {
+            const Joint& joint = joints_[i];
+            real_T v_min = -joint.max_velocity, v_max = joint.max_velocity;
+
+            if (joint.has_safety_controller && joint.k_position > 0) {
+                v_min = std::max(v_min, -joint.k_position * (joint.position - joint.soft_lower));
+                v_max = std::min(v_max, -joint.k_position * (joint.position - joint.soft_upper));
+            }
+
+            step_min_[i] = v_min * step_dt;
+            step_max_[i] = v_max * step_dt;
+        }
+
+        for (size_t i = joints_.size(); i-- > 0;) {
+            const Joint& follower = joints_[i];
+            if (follower.leader < 0 || follower.multiplier == 0)
+                continue;
+
+            real_T a = step_min_[i] / follower.multiplier;
+            real_T b = step_max_[i] / follower.multiplier;
+            step_min_[follower.leader] = std::max(step_min_[follower.leader], std::min(a, b));
+            step_max_[follower.leader] = std::min(step_max_[follower.leader], std::max(a, b));
+        }
+
+        for (uint i = 0; i < joints_.size(); ++i) {
+            Joint& joint = joints_[i];
+            if (joint.leader >= 0) {
+                follow(joint);
+                continue;
+            }
+
+            real_T step = joint.command_is_velocity
+                ? joint.command * step_dt
+                : clip(joint.command, joint.lower, joint.upper) - joint.position;
+            //bounds only cross when coupled soft limits disagree, then the lower one wins
+            step = std::max(step_min_[i], std::min(step, step_max_[i]));
+
+            real_T position = clip(joint.position + step, joint.lower, joint.upper);
+            joint.velocity = (position - joint.position) / step_dt;
+            joint.position = position;
+        }
+    }
+
+    real_T getPosition(const std::string& name) const
+    {
+        return joints_[indexOf(name)].position;
+    }
+
+    real_T getVelocity(const std::string& name) const
+    {
+        return joints_[indexOf(name)].velocity;
+    }
+
+    //position range left after soft limits and followers are taken in to account
+    void getLimits(const std::string& name, real_T& lower, real_T& upper) const
+    {
+        const Joint& joint = joints_[indexOf(name)];
+        lower = joint.lower;
+        upper = joint.upper;
+    }
+
+    real_T toCalibrated(const std::string& name, real_T position) const
+    {
+        return position - joints_[indexOf(name)].calibration_reference;
+    }
+
+    real_T fromCalibrated(const std::string& name, real_T calibrated) const
+    {
+        return calibrated + joints_[indexOf(name)].calibration_reference;
+    }
+
+private:
+    struct Joint {
+        std::string name;
+
+        int leader = -1;
+        real_T multiplier = 1;
+        real_T offset = 0;
+
+        real_T lower = -std::numeric_limits<real_T>::infinity();
+        real_T upper = std::numeric_limits<real_T>::infinity();
+        real_T max_velocity = std::numeric_limits<real_T>::infinity();
+
+        bool has_safety_controller = false;
+        real_T soft_lower = 0;
+        real_T soft_upper = 0;
+        real_T k_position = 0;
+
+        real_T calibration_reference = 0;
+
+        real_T command = 0;
+        bool command_is_velocity = false;
+        real_T position = 0;
+        real_T velocity = 0;
+    };
+
+    static bool isMovable(UrdfJointType type)
+    {
+        return type == UrdfJointType::Revolute || type == UrdfJointType::Prismatic || type == UrdfJointType::Continuous;
+    }
+
+    static real_T clip(real_T value, real_T lower, real_T upper)
+    {
+        return std::max(lower, std::min(value, upper));
+    }
+
+    //depth first so leaders are added before followers, visit_state is 1 while on the stack and 2 when added
+    int addJoint(const UrdfRobot& robot, const UrdfJoint& spec, std::map<std::string, int>& visit_state)
+    {
+        int& state = visit_state[spec.name];
+        if (state == 2)
+            return static_cast<int>(index_.at(spec.name));
+        if (state == 1)
+            throw std::runtime_error("Mimic joints form a cycle through joint '" + spec.name + "'.");
+        state = 1;
+
+        int leader = -1;
+        if (spec.has_mimic) {
+            auto leader_spec = robot.joints.find(spec.mimic_joint);
+            if (leader_spec == robot.joints.end() || !isMovable(leader_spec->second.type))
+                throw std::runtime_error("Joint '" + spec.name + "' mimics '" + spec.mimic_joint + "', which is not a revolute, continuous or prismatic joint.");
+            leader = addJoint(robot, leader_spec->second, visit_state);
+        }
+
+        Joint joint;
+        joint.name = spec.name;
+        joint.leader = leader;
+        joint.multiplier = spec.mimic_multiplier;
+        joint.offset = spec.mimic_offset;
+
+        if (spec.type != UrdfJointType::Continuous && spec.has_limit) {
+            if (spec.lower > spec.upper)
+                throw std::runtime_error("Joint '" + spec.name + "' has a lower limit above its upper limit.");
+            joint.lower = spec.lower;
+            joint.upper = spec.upper;
+        }
+        if (spec.has_limit && spec.velocity > 0)
+            joint.max_velocity = spec.velocity;
+
+        if (spec.has_safety_controller && spec.type != UrdfJointType::Continuous) {
+            joint.has_safety_controller = true;
+            joint.soft_lower = spec.soft_lower_limit;
+            joint.soft_upper = spec.soft_upper_limit;
+            joint.k_position = spec.k_position;
+            joint.lower = std::max(joint.lower, spec.soft_lower_limit);
+            joint.upper = std::min(joint.upper, spec.soft_upper_limit);
+            if (joint.lower > joint.upper)
+                throw std::runtime_error("The soft limits of joint '" + spec.name + "' are outside of its limits.");
+        }
+
+        if (spec.has_calibration) {
+            if (std::isfinite(spec.calibration_rising))
+                joint.calibration_reference = spec.calibration_rising;
+            else if (std::isfinite(spec.calibration_falling))
+                joint.calibration_reference = spec.calibration_falling;
+        }
+
+        joints_.push_back(joint);
+        int index = static_cast<int>(joints_.size()) - 1;
+        index_[spec.name] = index;
+        state = 2;
+        return index;
+    }
+
+    uint indexOf(const std::string& name) const
+    {
+        auto found = index_.find(name);
+        if (found == index_.end())
+            throw std::runtime_error("Joint '" + name + "' is not a revolute, continuous or prismatic joint of the robot.");
+        return found->second;
+    }
+
+    Joint& commandable(const std::string& name, real_T value)
+    {
+        Joint& joint = joints_[indexOf(name)];
+        if (joint.leader >= 0)
+            throw std::runtime_error("Joint '" + name + "' mimics '" + joints_[joint.leader].name + "' and can't be commanded directly.");
+        if (!std::isfinite(value))
+            throw std::runtime_error("Joint '" + name + "' was given a target that is not a finite number.");
+        return joint;
+    }
+
+    void follow(Joint& joint)
+    {
+        const Joint& leader = joints_[joint.leader];
+        joint.position = joint.multiplier * leader.position + joint.offset;
+        joint.velocity = joint.multiplier * leader.velocity;
+    }
+
+private:
+    vector<Joint> joints_;
+    std::map<std::string, uint> index_;
+    vector<real_T> step_min_, step_max_;
+};
+
+}} //namespace
+#endif
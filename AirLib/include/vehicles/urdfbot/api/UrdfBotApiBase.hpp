@@ -116,6 +116,26 @@ public:
         return sensors_;
     }
 
+    // joint encoders and torque sensors read the joints through the provider
+    void setJointStateProvider(const JointSensorBase::JointStateProvider& provider)
+    {
+        for (auto& sensor : sensor_storage_) {
+            auto* joint_sensor = dynamic_cast<JointSensorBase*>(sensor.get());
+            if (joint_sensor != nullptr)
+                joint_sensor->setJointStateProvider(provider);
+        }
+    }
+
+    // contact sensors read the per link hit totals through the provider
+    void setContactProvider(const ContactBase::ContactProvider& provider)
+    {
+        for (auto& sensor : sensor_storage_) {
+            auto* contact_sensor = dynamic_cast<ContactBase*>(sensor.get());
+            if (contact_sensor != nullptr)
+                contact_sensor->setContactProvider(provider);
+        }
+    }
+
     virtual void reset() override
     {
         VehicleApiBase::reset();
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_UrdfParser_hpp
+#define air_UrdfParser_hpp
+
+#include "common/Common.hpp"
+#include "UrdfSpecification.hpp"
+
+namespace msr { namespace airlib {
+
+/*
+    UrdfParser reads URDF files, optionally written with xacro macros, in to a UrdfRobot without a game engine.
+
+    The document is read in a single streaming pass: xacro elements are expanded as they are seen and the expanded
+    elements go straight to the URDF builder, so no DOM is kept and memory does not grow with the file. The xacro
+    subset covers property, macro (with defaults and *block parameters), insert_block, if, unless, include, arg and
+    ${} expressions with arithmetic, comparisons, and, or, not and math functions.
+
+    Errors throw std::runtime_error with a "file:line: message" text. Problems that don't stop the robot from being
+    built, such as elements the parser doesn't know, are collected as warnings instead.
+*/
+class UrdfParser {
+public:
+    struct Diagnostic {
+        std::string file;
+        uint line;
+        std::string message;
+
+        std::string toString() const;
+    };
+
+public:
+    UrdfParser();
+    ~UrdfParser();
+
+    //value for $(arg name), overrides defaults given by xacro:arg
+    void setArgument(const std::string& name, const std::string& value);
+    //directory for $(find package) and package:// urls
+    void setPackagePath(const std::string& package, const std::string& path);
+
+    UrdfRobot parseFile(const std::string& file_path);
+    //includes are relative to the directory of file_name
+    UrdfRobot parseString(const std::string& xml, const std::string& file_name = "<string>");
+
+    const vector<Diagnostic>& getWarnings() const;
+
+    //stable text dump of a robot, used to compare parses
+    static std::string describe(const UrdfRobot& robot);
+
+private:
+    struct impl;
+    std::unique_ptr<impl> pimpl_;
+};
+
+}} //namespace
+#endif
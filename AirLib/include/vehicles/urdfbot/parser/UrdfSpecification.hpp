@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef air_UrdfSpecification_hpp
+#define air_UrdfSpecification_hpp
+
+#include "common/Common.hpp"
+#include <map>
+
+namespace msr { namespace airlib {
+
+/*
+    Engine independent description of a robot read from a URDF file. Values are as written in the file, so lengths
+    are in meters and angles in radians. Every element remembers the line it started on for diagnostics.
+*/
+
+struct UrdfOrigin {
+    Vector3r xyz = Vector3r::Zero();
+    Vector3r rpy = Vector3r::Zero(); //roll, pitch, yaw
+};
+
+enum class UrdfGeometryType {
+    Box, Sphere, Cylinder, Mesh
+};
+
+enum class UrdfMeshFileType {
+    StlAscii, UnrealMesh
+};
+
+enum class UrdfDynamicCollisionType {
+    Bsp, Vhacd, Manual
+};
+
+struct UrdfGeometry {
+    UrdfGeometryType type = UrdfGeometryType::Box;
+
+    Vector3r size = Vector3r::Zero(); //box
+    real_T radius = 0; //sphere and cylinder
+    real_T length = 0; //cylinder
+
+    std::string mesh_location;
+    UrdfMeshFileType mesh_file_type = UrdfMeshFileType::StlAscii;
+    bool reverse_normals = false;
+    real_T scale_factor = 1;
+    UrdfDynamicCollisionType dynamic_collision_type = UrdfDynamicCollisionType::Bsp;
+    double vhacd_concavity = 0.1;
+    uint vhacd_resolution = 100000;
+    uint vhacd_max_num_vertices_per_ch = 64;
+    double vhacd_min_volume_per_ch = 0.007;
+    std::string vhacd_output_folder_path;
+};
+
+struct UrdfInertial {
+    UrdfOrigin origin;
+    real_T mass = 0;
+    Matrix3x3r inertia = Matrix3x3r::Zero();
+};
+
+struct UrdfVisual {
+    std::string name;
+    UrdfOrigin origin;
+    UrdfGeometry geometry;
+    std::string material_name;
+};
+
+struct UrdfCollision {
+    std::string name;
+    UrdfOrigin origin;
+    UrdfGeometry geometry;
+};
+
+struct UrdfLink {
+    std::string name;
+    uint line = 0;
+    UrdfInertial inertial;
+    bool has_visual = false;
+    UrdfVisual visual;
+    bool has_collision = false;
+    UrdfCollision collision;
+};
+
+enum class UrdfJointType {
+    Revolute, Continuous, Prismatic, Fixed, Floating, Planar
+};
+
+//DC motor behind a gearbox, from the <actuator> element of a joint, which is not part of the URDF standard
+struct UrdfActuator {
+    real_T voltage = 12; //supply, V
+    real_T resistance = 1; //winding, ohm
+    real_T inductance = 0; //winding, H, 0 for no electrical lag
+    real_T torque_constant = 0.05f; //N m/A, also the back EMF constant in V s/rad
+    real_T current_limit = 0; //A, 0 for none
+    real_T rotor_inertia = 0; //kg m^2
+    real_T rotor_friction = 0; //viscous, N m s/rad
+    real_T gear_ratio = 1; //motor radians per joint radian, or per meter for prismatic joints
+    real_T gear_efficiency = 1;
+    real_T backlash = 0; //free play at the joint, rad or m
+    real_T position_gain = 100; //V per rad or m of error
+    real_T velocity_gain = 1; //V per rad/s or m/s of error
+};
+
+struct UrdfJoint {
+    std::string name;
+    uint line = 0;
+    UrdfJointType type = UrdfJointType::Fixed;
+    UrdfOrigin origin;
+    std::string parent_link;
+    std::string child_link;
+    Vector3r axis = Vector3r(1, 0, 0);
+    Vector3r axis_rpy = Vector3r::Zero(); //rotation of the joint frame about the axis, not part of the URDF standard
+
+    //rising and falling are nan when not given
+    bool has_calibration = false;
+    real_T calibration_rising = std::numeric_limits<real_T>::quiet_NaN();
+    real_T calibration_falling = std::numeric_limits<real_T>::quiet_NaN();
+
+    real_T damping = 0;
+    real_T friction = 0;
+
+    bool has_limit = false;
+    real_T lower = 0;
+    real_T upper = 0;
+    real_T effort = 0;
+    real_T velocity = 0;
+
+    bool has_mimic = false;
+    std::string mimic_joint;
+    real_T mimic_multiplier = 1;
+    real_T mimic_offset = 0;
+
+    bool has_safety_controller = false;
+    real_T soft_lower_limit = 0;
+    real_T soft_upper_limit = 0;
+    real_T k_position = 0;
+    real_T k_velocity = 0;
+
+    bool has_actuator = false;
+    UrdfActuator actuator;
+};
+
+enum class UrdfForceType {
+    Angular, Linear
+};
+
+struct UrdfForce {
+    std::string name;
+    uint line = 0;
+    UrdfForceType type = UrdfForceType::Angular;
+    std::string link_name;
+    Vector3r axis = Vector3r::Zero();
+    Vector3r application_point = Vector3r::Zero(); //linear forces only
+};
+
+struct UrdfMaterial {
+    std::string name;
+    uint line = 0;
+    bool has_color = false;
+    real_T color[4] = { 0, 0, 0, 1 }; //rgba
+    std::string texture_file; //unreal_material path or texture filename
+};
+
+struct UrdfRobot {
+    std::string name;
+    std::string root_link;
+    std::map<std::string, UrdfLink> links;
+    std::map<std::string, UrdfJoint> joints;
+    std::map<std::string, UrdfForce> forces;
+    std::map<std::string, UrdfMaterial> materials;
+};
+
+}} //namespace
+#endif
@@ -229,6 +229,11 @@ vector<uint8_t> RpcLibClientBase::simGetImage(const std::string& camera_name, Im
     return result;
 }
 
+EventCameraEmulator::EventPacket RpcLibClientBase::simGetCameraEvents(const std::string& camera_name, const std::string& vehicle_name)
+{
+    return pimpl_->client.call("simGetCameraEvents", camera_name, vehicle_name).as<RpcLibAdapatorsBase::EventPacket>().to();
+}
+
 void RpcLibClientBase::simSetCameraPose(const CameraPose camera_pose, const std::string& vehicle_name)
 {
     pimpl_->client.call("simSetCameraPose", msr::airlib_rpclib::RpcLibAdapatorsBase::CameraPose(camera_pose), vehicle_name);
@@ -387,6 +392,16 @@ void RpcLibClientBase::simContinueForTime(double seconds)
     pimpl_->client.call("simContinueForTime", seconds);
 }
 
+void RpcLibClientBase::simStartRpcRecording(const std::string& file_path)
+{
+    pimpl_->client.call("simStartRpcRecording", file_path);
+}
+
+void RpcLibClientBase::simStopRpcRecording()
+{
+    pimpl_->client.call("simStopRpcRecording");
+}
+
 msr::airlib::Pose RpcLibClientBase::simGetObjectPose(const std::string& object_name) const
 {
     return pimpl_->client.call("simGetObjectPose", object_name).as<RpcLibAdapatorsBase::Pose>().to();
@@ -427,6 +442,11 @@ void RpcLibClientBase::cancelLastTask(const std::string& vehicle_name)
     pimpl_->client.call("cancelLastTask", vehicle_name);
 }
 
+msr::airlib::ControlScheduleStatus RpcLibClientBase::getControlScheduleStatus(const std::string& vehicle_name) const
+{
+    return pimpl_->client.call("getControlScheduleStatus", vehicle_name).as<RpcLibAdapatorsBase::ControlScheduleStatus>().to();
+}
+
 //return value of last task. It should be true if task completed without
 //cancellation or timeout
 RpcLibClientBase* RpcLibClientBase::waitOnLastTask(bool* task_result, float timeout_sec)
@@ -539,6 +559,31 @@ std::unordered_map<std::string, msr::airlib::Pose> RpcLibClientBase::simGetBoneP
 
     return r;
 }
+std::vector<std::string> RpcLibClientBase::simCharGetBoneNames(const std::string& character_name) const
+{
+    return pimpl_->client.call("simCharGetBoneNames", character_name).as<std::vector<std::string>>();
+}
+void RpcLibClientBase::simCharSetBonePosesByIndex(const std::vector<int>& bone_indices, const std::vector<msr::airlib::Pose>& poses, const std::string& character_name)
+{
+    pimpl_->client.call("simCharSetBonePosesByIndex", bone_indices, RpcLibAdapatorsBase::packPoses(poses), character_name);
+}
+std::vector<msr::airlib::Pose> RpcLibClientBase::simCharGetBonePosesByIndex(const std::vector<int>& bone_indices, const std::string& character_name) const
+{
+    return RpcLibAdapatorsBase::unpackPoses(
+        pimpl_->client.call("simCharGetBonePosesByIndex", bone_indices, character_name).as<std::vector<float>>());
+}
+void RpcLibClientBase::simCharPlayMotionClip(const std::string& clip_file, float scale, float rate, bool loop, const std::string& character_name)
+{
+    pimpl_->client.call("simCharPlayMotionClip", clip_file, scale, rate, loop, character_name);
+}
+void RpcLibClientBase::simCharSetMotionClipTimeWarp(const std::vector<float>& play_times, const std::vector<float>& clip_times, const std::string& character_name)
+{
+    pimpl_->client.call("simCharSetMotionClipTimeWarp", play_times, clip_times, character_name);
+}
+void RpcLibClientBase::simCharStopMotionClip(const std::string& character_name)
+{
+    pimpl_->client.call("simCharStopMotionClip", character_name);
+}
 
 
 }} //namespace
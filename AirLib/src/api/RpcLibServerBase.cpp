@@ -8,6 +8,7 @@
 //if using Unreal Build system then include precompiled header file first
 
 #include "api/RpcLibServerBase.hpp"
+#include "common/AirSimSettings.hpp"
 
 
 #include "common/Common.hpp"
@@ -30,6 +31,7 @@ STRICT_MODE_OFF
 #include "common/common_utils/WindowsApisCommonPost.hpp"
 
 #include "api/RpcLibAdapatorsBase.hpp"
+#include "api/RpcLibServerCore.hpp"
 
 STRICT_MODE_ON
 
@@ -48,7 +50,11 @@ struct RpcLibServerBase::impl {
     ~impl() {
     }
 
-    rpc::server server;
+    RpcLibServerCore server;
+
+    //one emulator per vehicle and camera, created on the first simGetCameraEvents call
+    std::mutex event_cameras_mutex;
+    std::map<std::pair<std::string, std::string>, std::unique_ptr<EventCameraEmulator>> event_cameras;
 };
 
 typedef msr::airlib_rpclib::RpcLibAdapatorsBase RpcLibAdapatorsBase;
@@ -61,6 +67,13 @@ RpcLibServerBase::RpcLibServerBase(ApiProvider* api_provider, const std::string&
     else
         pimpl_.reset(new impl(server_address, port));
     pimpl_->server.bind("ping", [&]() -> bool { return true; });
+    //bound around the recorder so recordings don't contain themselves
+    pimpl_->server.rpc::server::bind("simStartRpcRecording", [&](const std::string& file_path) -> void {
+        startRecording(file_path);
+    });
+    pimpl_->server.rpc::server::bind("simStopRpcRecording", [&]() -> void {
+        stopRecording();
+    });
     pimpl_->server.bind("getServerVersion", []() -> int {
         return 1;
     });
@@ -103,6 +116,10 @@ RpcLibServerBase::RpcLibServerBase(ApiProvider* api_provider, const std::string&
         return result;
     });
 
+    pimpl_->server.bind("simGetCameraEvents", [&](const std::string& camera_name, const std::string& vehicle_name) -> RpcLibAdapatorsBase::EventPacket {
+        return RpcLibAdapatorsBase::EventPacket(getCameraEvents(camera_name, vehicle_name));
+    });
+
     pimpl_->server.bind("simSetCameraPose", [&](const RpcLibAdapatorsBase::CameraPose camera_pose, const std::string& vehicle_name) -> void {
         getVehicleSimApi(vehicle_name)->setCameraPose(camera_pose.to());
     });
@@ -229,6 +246,10 @@ RpcLibServerBase::RpcLibServerBase(ApiProvider* api_provider, const std::string&
         getVehicleApi(vehicle_name)->cancelLastTask();
     });
 
+    pimpl_->server.bind("getControlScheduleStatus", [&](const std::string& vehicle_name) -> RpcLibAdapatorsBase::ControlScheduleStatus {
+        return RpcLibAdapatorsBase::ControlScheduleStatus(getVehicleApi(vehicle_name)->getControlScheduleStatus());
+    });
+
     //----------- APIs to control ACharacter in scene ----------/
     pimpl_->server.bind("simCharSetFaceExpression", [&](const std::string& expression_name, float value, const std::string& character_name) -> void {
         getWorldSimApi()->charSetFaceExpression(expression_name, value, character_name);
@@ -291,9 +312,49 @@ RpcLibServerBase::RpcLibServerBase(ApiProvider* api_provider, const std::string&
 
         return r;
     });
+    pimpl_->server.bind("simCharGetBoneNames", [&](const std::string& character_name) -> std::vector<std::string> {
+        return getWorldSimApi()->charGetBoneNames(character_name);
+    });
+    pimpl_->server.bind("simCharSetBonePosesByIndex", [&](const std::vector<int>& bone_indices, const std::vector<float>& poses, const std::string& character_name) -> void {
+        if (poses.size() != bone_indices.size() * 7)
+            throw std::invalid_argument("simCharSetBonePosesByIndex needs 7 pose values per bone index.");
+        getWorldSimApi()->charSetBonePosesByIndex(bone_indices, RpcLibAdapatorsBase::unpackPoses(poses), character_name);
+    });
+    pimpl_->server.bind("simCharGetBonePosesByIndex", [&](const std::vector<int>& bone_indices, const std::string& character_name) -> std::vector<float> {
+        return RpcLibAdapatorsBase::packPoses(getWorldSimApi()->charGetBonePosesByIndex(bone_indices, character_name));
+    });
+    pimpl_->server.bind("simCharPlayMotionClip", [&](const std::string& clip_file, float scale, float rate, bool loop, const std::string& character_name) -> void {
+        getWorldSimApi()->charPlayMotionClip(clip_file, scale, rate, loop, character_name);
+    });
+    pimpl_->server.bind("simCharSetMotionClipTimeWarp", [&](const std::vector<float>& play_times, const std::vector<float>& clip_times, const std::string& character_name) -> void {
+        getWorldSimApi()->charSetMotionClipTimeWarp(play_times, clip_times, character_name);
+    });
+    pimpl_->server.bind("simCharStopMotionClip", [&](const std::string& character_name) -> void {
+        getWorldSimApi()->charStopMotionClip(character_name);
+    });
 
     //if we don't suppress then server will bomb out for exceptions raised by any method
     pimpl_->server.suppress_exceptions(true);
+
+    applyLaneSettings();
+}
+
+void RpcLibServerBase::applyLaneSettings()
+{
+    const AirSimSettings& settings = AirSimSettings::singleton();
+    RpcDispatchLanes& lanes = pimpl_->server.getLanes();
+    for (const auto& lane_setting : settings.rpc_lanes) {
+        RpcDispatchLanes::LaneType lane = RpcDispatchLanes::getLaneType(lane_setting.first);
+        RpcDispatchLanes::LaneSettings lane_settings = lanes.getLaneSettings(lane);
+        if (lane_setting.second.worker_count >= 0)
+            lane_settings.worker_count = static_cast<uint>(lane_setting.second.worker_count);
+        if (lane_setting.second.queue_limit >= 0)
+            lane_settings.queue_limit = static_cast<uint>(lane_setting.second.queue_limit);
+        lanes.setLaneSettings(lane, lane_settings);
+    }
+    //methods bound by derived servers pick their lane up when they are bound
+    for (const auto& method_lane : settings.rpc_method_lanes)
+        lanes.setMethodLane(method_lane.first, RpcDispatchLanes::getLaneType(method_lane.second));
 }
 
 //required for pimpl
@@ -307,7 +368,7 @@ void RpcLibServerBase::start(bool block)
     if (block)
         pimpl_->server.run();
     else
-        pimpl_->server.async_run(4);   //4 threads
+        pimpl_->server.startDispatch();
 }
 
 void RpcLibServerBase::stop()
@@ -315,6 +376,49 @@ void RpcLibServerBase::stop()
     pimpl_->server.stop();
 }
 
+void RpcLibServerBase::startRecording(const std::string& file_path)
+{
+    pimpl_->server.getRecorder().start(file_path);
+}
+
+void RpcLibServerBase::stopRecording()
+{
+    pimpl_->server.getRecorder().stop();
+}
+
+bool RpcLibServerBase::isRecording() const
+{
+    return pimpl_->server.getRecorder().isRecording();
+}
+
+EventCameraEmulator::EventPacket RpcLibServerBase::getCameraEvents(const std::string& camera_name, const std::string& vehicle_name)
+{
+    VehicleSimApiBase* vehicle_sim_api = getVehicleSimApi(vehicle_name);
+    const auto responses = vehicle_sim_api->getImages({
+        ImageCaptureBase::ImageRequest(camera_name, ImageCaptureBase::ImageType::Scene, false, false) });
+    if (responses.size() == 0 || responses[0].image_data_uint8.size() == 0)
+        throw std::runtime_error("Camera '" + camera_name + "' of vehicle '" + vehicle_name + "' returned no Scene image for its events");
+    const ImageCaptureBase::ImageResponse& frame = responses[0];
+
+    std::lock_guard<std::mutex> lock(pimpl_->event_cameras_mutex);
+    std::unique_ptr<EventCameraEmulator>& emulator = pimpl_->event_cameras[std::make_pair(vehicle_name, camera_name)];
+    if (!emulator) {
+        const auto& cameras = vehicle_sim_api->getVehicleSetting()->cameras;
+        const auto camera = cameras.find(camera_name);
+        emulator.reset(new EventCameraEmulator(camera != cameras.end() ? camera->second.event_camera
+            : AirSimSettings::singleton().camera_defaults.event_camera));
+    }
+
+    EventCameraEmulator::EventPacket packet;
+    emulator->addFrame(frame.image_data_uint8, frame.width, frame.height, frame.time_stamp, packet);
+    return packet;
+}
+
+RpcDispatchLanes& RpcLibServerBase::getDispatchLanes()
+{
+    return pimpl_->server.getLanes();
+}
+
 void* RpcLibServerBase::getServer() const
 {
     return &pimpl_->server;
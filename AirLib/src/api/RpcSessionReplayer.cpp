@@ -0,0 +1,179 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//in header only mode, control library is not available
+#ifndef AIRLIB_HEADER_ONLY
+//RPC code requires C++14. If build system like Unreal doesn't support it then use compiled binaries
+#ifndef AIRLIB_NO_RPC
+//if using Unreal Build system then include precompiled header file first
+
+#include "api/RpcSessionReplayer.hpp"
+
+#include "common/Common.hpp"
+#include <atomic>
+#include <thread>
+#include <utility>
+STRICT_MODE_OFF
+
+#ifndef RPCLIB_MSGPACK
+#define RPCLIB_MSGPACK clmdep_msgpack
+#endif // !RPCLIB_MSGPACK
+
+#ifdef nil
+#undef nil
+#endif // nil
+
+#include "common/common_utils/WindowsApisCommonPre.hpp"
+#undef FLOAT
+#undef check
+#include "rpc/client.h"
+//TODO: HACK: UE4 defines macro with stupid names like "check" that conflicts with msgpack library
+#ifndef check
+#define check(expr) (static_cast<void>((expr)))
+#endif
+#include "common/common_utils/WindowsApisCommonPost.hpp"
+
+STRICT_MODE_ON
+
+
+namespace msr { namespace airlib {
+
+namespace {
+
+//rpc::client::call takes the arguments as a parameter pack, so the recorded array is expanded by its length
+const size_t kMaxArgCount = 16;
+
+template <size_t... Index>
+void callExpanded(rpc::client& client, const std::string& method, const RPCLIB_MSGPACK::object* args, std::index_sequence<Index...>)
+{
+    client.call(method, args[Index]...);
+}
+
+template <size_t ArgCount>
+struct ArgCountDispatch {
+    static void call(rpc::client& client, const std::string& method, const RPCLIB_MSGPACK::object* args, size_t arg_count)
+    {
+        if (arg_count == ArgCount)
+            callExpanded(client, method, args, std::make_index_sequence<ArgCount>());
+        else
+            ArgCountDispatch<ArgCount - 1>::call(client, method, args, arg_count);
+    }
+};
+
+template <>
+struct ArgCountDispatch<0> {
+    static void call(rpc::client& client, const std::string& method, const RPCLIB_MSGPACK::object*, size_t arg_count)
+    {
+        if (arg_count != 0)
+            throw std::runtime_error(Utils::stringf("Recorded call to %s has %d arguments, replay supports up to %d",
+                method.c_str(), static_cast<int>(arg_count), static_cast<int>(kMaxArgCount)));
+        client.call(method);
+    }
+};
+
+void callRecorded(rpc::client& client, const RpcCallRecord& record)
+{
+    RPCLIB_MSGPACK::object_handle handle = RPCLIB_MSGPACK::unpack(record.args.data(), record.args.size());
+    const RPCLIB_MSGPACK::object& args = handle.get();
+    if (args.type != RPCLIB_MSGPACK::type::ARRAY)
+        throw std::runtime_error("Recorded arguments of " + record.method + " are not an array");
+    ArgCountDispatch<kMaxArgCount>::call(client, record.method, args.via.array.ptr, args.via.array.size);
+}
+
+} //namespace
+
+struct RpcSessionReplayer::impl {
+    impl(const std::string& ip_address_val, uint16_t port_val)
+        : ip_address(ip_address_val), port(port_val)
+    {}
+
+    std::string ip_address;
+    uint16_t port;
+};
+
+RpcSessionReplayer::RpcSessionReplayer(const std::string& ip_address, uint16_t port)
+{
+    pimpl_.reset(new impl(ip_address, port));
+}
+
+RpcSessionReplayer::~RpcSessionReplayer()
+{}
+
+RpcSessionReplayer::Result RpcSessionReplayer::replay(const std::string& file_path, const Options& options)
+{
+    RpcSessionLog::Reader reader(file_path);
+    vector<RpcCallRecord> records = reader.readAll();
+    Result result = replay(records, options);
+    result.truncated_log = reader.isTruncated();
+    return result;
+}
+
+RpcSessionReplayer::Result RpcSessionReplayer::replay(const vector<RpcCallRecord>& records, const Options& options)
+{
+    if (!(options.speed >= 0))
+        throw std::invalid_argument("Replay speed can't be negative");
+    if (options.connection_count == 0)
+        throw std::invalid_argument("Replay needs at least one connection");
+
+    vector<const RpcCallRecord*> calls;
+    for (const auto& record : records) {
+        if (options.methods.empty() || options.methods.count(record.method) > 0)
+            calls.push_back(&record);
+    }
+
+    struct Sample {
+        const RpcCallRecord* call;
+        double latency;
+        bool failed;
+    };
+
+    typedef std::chrono::steady_clock SteadyClock;
+    std::atomic<size_t> next_call(0);
+    vector<vector<Sample>> samples(options.connection_count);
+    vector<std::thread> connections;
+    const SteadyClock::time_point start = SteadyClock::now();
+
+    for (uint connection = 0; connection < options.connection_count; ++connection) {
+        connections.emplace_back([&, connection]() {
+            rpc::client client(pimpl_->ip_address, pimpl_->port);
+            client.set_timeout(static_cast<int64_t>(options.timeout_sec * 1.0E3));
+
+            for (size_t index = next_call++; index < calls.size(); index = next_call++) {
+                const RpcCallRecord& call = *calls[index];
+                if (options.speed > 0)
+                    std::this_thread::sleep_until(start + std::chrono::nanoseconds(static_cast<int64_t>(call.offset / options.speed)));
+
+                SteadyClock::time_point call_start = SteadyClock::now();
+                bool failed = false;
+                try {
+                    callRecorded(client, call);
+                }
+                catch (const std::exception&) {
+                    failed = true;
+                }
+                double latency = std::chrono::duration<double>(SteadyClock::now() - call_start).count();
+                samples[connection].push_back(Sample{ &call, latency, failed });
+            }
+        });
+    }
+    for (auto& connection : connections)
+        connection.join();
+
+    Result result;
+    result.seconds = std::chrono::duration<double>(SteadyClock::now() - start).count();
+    for (const auto* call : calls)
+        result.recorded.add(call->method, call->latency * 1E-9, call->failed);
+    for (const auto& connection_samples : samples) {
+        for (const auto& sample : connection_samples) {
+            result.replayed.add(sample.call->method, sample.latency, sample.failed);
+            ++result.call_count;
+            result.failed_count += sample.failed ? 1 : 0;
+        }
+    }
+    return result;
+}
+
+}} //namespace
+
+#endif
+#endif
@@ -0,0 +1,264 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//in header only mode, control library is not available
+#ifndef AIRLIB_HEADER_ONLY
+
+#include "camera/EventCameraEmulator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AIRLIB_EVENT_CAMERA_SSE
+#include <emmintrin.h>
+#endif
+
+namespace msr { namespace airlib {
+
+namespace {
+
+//thresholds drawn with threshold_sigma are kept above this
+constexpr float MinContrastThreshold = 0.01f;
+constexpr unsigned int RandomSeed = 42;
+
+//appends the pixels whose log intensity moves a threshold away from the reference at some time between the two
+//frames; interpolation is linear, so the extremes are at the frames
+void findChangedPixels(const float* last, const float* next, const float* reference, const float* threshold_on,
+    const float* threshold_off, uint count, vector<uint32_t>& changed)
+{
+    uint i = 0;
+#ifdef AIRLIB_EVENT_CAMERA_SSE
+    for (; i + 4 <= count; i += 4) {
+        const __m128 a = _mm_loadu_ps(last + i), b = _mm_loadu_ps(next + i), r = _mm_loadu_ps(reference + i);
+        const __m128 up = _mm_sub_ps(_mm_max_ps(a, b), r);
+        const __m128 down = _mm_sub_ps(r, _mm_min_ps(a, b));
+        const int mask = _mm_movemask_ps(_mm_or_ps(
+            _mm_cmpge_ps(up, _mm_loadu_ps(threshold_on + i)), _mm_cmpge_ps(down, _mm_loadu_ps(threshold_off + i))));
+        if (mask == 0)
+            continue;
+        for (uint lane = 0; lane < 4; ++lane) {
+            if (mask & (1 << lane))
+                changed.push_back(i + lane);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        const float up = std::max(last[i], next[i]) - reference[i];
+        const float down = reference[i] - std::min(last[i], next[i]);
+        if (up >= threshold_on[i] || down >= threshold_off[i])
+            changed.push_back(i);
+    }
+}
+
+} //namespace
+
+struct EventCameraEmulator::impl {
+    AirSimSettings::EventCameraSetting setting;
+    float log_table[256];
+
+    bool started = false;
+    int width = 0, height = 0;
+    TTimePoint origin = 0; //time of the first frame, pixel times are seconds after it
+    TTimePoint last_time = 0;
+
+    vector<float> last_log; //log intensity of the previous frame
+    vector<float> next_log;
+    vector<float> reference;
+    vector<float> threshold_on;
+    vector<float> threshold_off;
+    vector<double> blocked_until;
+    vector<uint32_t> changed;
+
+    std::mt19937 random;
+
+    impl(const AirSimSettings::EventCameraSetting& setting_val)
+        : setting(setting_val), random(RandomSeed)
+    {
+        if (!(setting.contrast_threshold_on > 0 && setting.contrast_threshold_off > 0))
+            throw std::invalid_argument("Event camera contrast thresholds must be positive");
+        if (setting.threshold_sigma < 0 || setting.refractory_period < 0 || setting.background_rate < 0)
+            throw std::invalid_argument("Event camera ThresholdSigma, RefractoryPeriod and BackgroundRate cannot be negative");
+
+        //offset by one level, so black stays finite
+        for (int value = 0; value < 256; ++value)
+            log_table[value] = std::log(value + 1.0f);
+    }
+
+    void toLogIntensity(const uint8_t* pixels, int channels, vector<float>& log_intensity) const
+    {
+        const uint count = static_cast<uint>(width * height);
+        log_intensity.resize(count);
+        if (channels == 1) {
+            for (uint i = 0; i < count; ++i)
+                log_intensity[i] = log_table[pixels[i]];
+            return;
+        }
+        //Rec. 601 luma in 8 bit fixed point
+        for (uint i = 0; i < count; ++i, pixels += channels)
+            log_intensity[i] = log_table[(77 * pixels[0] + 150 * pixels[1] + 29 * pixels[2] + 128) >> 8];
+    }
+
+    void start(int width_val, int height_val, TTimePoint time_stamp)
+    {
+        width = width_val;
+        height = height_val;
+        origin = last_time = time_stamp;
+        random.seed(RandomSeed);
+
+        const uint count = static_cast<uint>(width * height);
+        reference = last_log;
+        blocked_until.assign(count, -std::numeric_limits<double>::infinity());
+        threshold_on.resize(count);
+        threshold_off.resize(count);
+        std::normal_distribution<float> mismatch(0, 1);
+        for (uint i = 0; i < count; ++i) {
+            const float mismatch_on = setting.threshold_sigma > 0 ? mismatch(random) * setting.threshold_sigma : 0;
+            const float mismatch_off = setting.threshold_sigma > 0 ? mismatch(random) * setting.threshold_sigma : 0;
+            threshold_on[i] = std::max(MinContrastThreshold, setting.contrast_threshold_on + mismatch_on);
+            threshold_off[i] = std::max(MinContrastThreshold, setting.contrast_threshold_off + mismatch_off);
+        }
+        started = true;
+    }
+
+    //events of one pixel, with the log intensity going from log0 to log1 over duration seconds from frame_start
+    void emitPixelEvents(uint32_t pixel, double frame_start, double duration, vector<uint64_t>& events)
+    {
+        const double log0 = last_log[pixel];
+        const double slope = (next_log[pixel] - log0) / duration;
+        const double on = threshold_on[pixel], off = threshold_off[pixel];
+        double ref = reference[pixel];
+        double blocked = blocked_until[pixel] - frame_start;
+        double time = 0;
+
+        Event event;
+        event.x = static_cast<uint16_t>(pixel % width);
+        event.y = static_cast<uint16_t>(pixel / width);
+        for (uint count = 0; count < MaxEventsPerPixel; ++count) {
+            double event_time = std::max(time, blocked);
+            if (event_time > duration)
+                break;
+            const double log_intensity = log0 + slope * event_time;
+            if (log_intensity - ref >= on || ref - log_intensity >= off) {
+                //crossed while blind, the pixel resets to where it is now
+                event.on = log_intensity > ref;
+                ref = log_intensity;
+            }
+            else {
+                if (slope == 0)
+                    break;
+                const double level = slope > 0 ? ref + on : ref - off;
+                event_time += (level - log_intensity) / slope;
+                if (event_time > duration)
+                    break;
+                event.on = slope > 0;
+                ref = level;
+            }
+
+            const double offset = std::round(event_time * 1E6);
+            event.time_offset = static_cast<uint32_t>(std::min(offset, 4294967295.0));
+            events.push_back(packEvent(event));
+            time = event_time;
+            blocked = event_time + setting.refractory_period;
+        }
+
+        reference[pixel] = static_cast<float>(ref);
+        blocked_until[pixel] = blocked + frame_start;
+    }
+
+    void addBackgroundEvents(double duration, vector<uint64_t>& events)
+    {
+        const double mean = setting.background_rate * duration * width * height;
+        if (mean <= 0)
+            return;
+        std::poisson_distribution<uint> count_distribution(mean);
+        std::uniform_int_distribution<uint> pixel_distribution(0, width * height - 1);
+        std::uniform_real_distribution<double> time_distribution(0, duration);
+        std::bernoulli_distribution polarity_distribution(0.5);
+
+        const uint count = count_distribution(random);
+        for (uint i = 0; i < count; ++i) {
+            const uint pixel = pixel_distribution(random);
+            Event event;
+            event.x = static_cast<uint16_t>(pixel % width);
+            event.y = static_cast<uint16_t>(pixel / width);
+            event.time_offset = static_cast<uint32_t>(std::min(std::round(time_distribution(random) * 1E6), 4294967295.0));
+            event.on = polarity_distribution(random);
+            events.push_back(packEvent(event));
+        }
+    }
+
+    void addFrame(const uint8_t* pixels, int width_val, int height_val, int channels, TTimePoint time_stamp, EventPacket& packet)
+    {
+        if (width_val <= 0 || height_val <= 0 || width_val > 65535 || height_val > 32767)
+            throw std::invalid_argument(Utils::stringf("Event camera frames must be between 1x1 and 65535x32767 pixels, got %dx%d",
+                width_val, height_val));
+        if (channels != 1 && channels != 3 && channels != 4)
+            throw std::invalid_argument(Utils::stringf("Event camera frames must have 1, 3 or 4 channels, got %d", channels));
+
+        packet.width = width_val;
+        packet.height = height_val;
+        packet.end_time = time_stamp;
+        packet.events.clear();
+
+        if (started && time_stamp == last_time && width_val == width && height_val == height) {
+            packet.start_time = time_stamp;
+            return;
+        }
+        if (!started || time_stamp < last_time || width_val != width || height_val != height) {
+            width = width_val;
+            height = height_val;
+            toLogIntensity(pixels, channels, last_log);
+            start(width_val, height_val, time_stamp);
+            packet.start_time = time_stamp;
+            return;
+        }
+
+        packet.start_time = last_time;
+        const double frame_start = (last_time - origin) * 1E-9;
+        const double duration = (time_stamp - last_time) * 1E-9;
+        toLogIntensity(pixels, channels, next_log);
+
+        changed.clear();
+        findChangedPixels(last_log.data(), next_log.data(), reference.data(), threshold_on.data(), threshold_off.data(),
+            static_cast<uint>(next_log.size()), changed);
+        for (uint32_t pixel : changed)
+            emitPixelEvents(pixel, frame_start, duration, packet.events);
+        addBackgroundEvents(duration, packet.events);
+        std::sort(packet.events.begin(), packet.events.end());
+
+        last_log.swap(next_log);
+        last_time = time_stamp;
+    }
+};
+
+EventCameraEmulator::EventCameraEmulator(const AirSimSettings::EventCameraSetting& setting)
+    : pimpl_(new impl(setting))
+{
+}
+
+EventCameraEmulator::~EventCameraEmulator() = default;
+
+void EventCameraEmulator::reset()
+{
+    pimpl_->started = false;
+}
+
+void EventCameraEmulator::addFrame(const uint8_t* pixels, int width, int height, int channels, TTimePoint time_stamp, EventPacket& packet)
+{
+    pimpl_->addFrame(pixels, width, height, channels, time_stamp, packet);
+}
+
+void EventCameraEmulator::addFrame(const vector<uint8_t>& pixels, int width, int height, TTimePoint time_stamp, EventPacket& packet)
+{
+    if (width <= 0 || height <= 0 || pixels.size() % (static_cast<size_t>(width) * height) != 0)
+        throw std::invalid_argument(Utils::stringf("Event camera frame of %d bytes does not match its size of %dx%d",
+            static_cast<int>(pixels.size()), width, height));
+    pimpl_->addFrame(pixels.data(), width, height, static_cast<int>(pixels.size() / (static_cast<size_t>(width) * height)),
+        time_stamp, packet);
+}
+
+}} //namespace
+
+#endif
@@ -0,0 +1,222 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//in header only mode, control library is not available
+#ifndef AIRLIB_HEADER_ONLY
+
+#include "camera/OpticalFlowGenerator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AIRLIB_OPTICAL_FLOW_SSE
+#include <emmintrin.h>
+#endif
+
+namespace msr { namespace airlib {
+
+namespace {
+
+//points closer than this to the plane of the previous camera, per unit of current depth, are treated as behind it
+constexpr float MinProjectedDepth = 1E-6f;
+
+template <typename Func>
+void runOnThreads(uint thread_count, Func func)
+{
+    if (thread_count <= 1) {
+        func(0);
+        return;
+    }
+    vector<std::thread> threads;
+    for (uint i = 1; i < thread_count; ++i)
+        threads.emplace_back(func, i);
+    func(0);
+    for (auto& thread : threads)
+        thread.join();
+}
+
+//motion of the points of a frame into the previous camera frame, scaled by their current depth
+struct Motion {
+    float r[3][3]; //current camera frame to previous camera frame
+    float t[3]; //current camera position in the previous camera frame
+};
+
+Motion makeMotion(const Pose& previous_pose, const Pose& pose)
+{
+    const Quaternionr to_previous = previous_pose.orientation.inverse();
+    const Eigen::Matrix<real_T, 3, 3> r = (to_previous * pose.orientation).toRotationMatrix();
+    const Vector3r t = VectorMath::transformToBodyFrame(pose.position, previous_pose, true);
+
+    Motion motion;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j)
+            motion.r[i][j] = static_cast<float>(r(i, j));
+        motion.t[i] = static_cast<float>(t[i]);
+    }
+    return motion;
+}
+
+/*
+    Flow of one row. A pixel with ray (1, a, b) and depth d is at d * (1, a, b) in the current camera frame, and at
+    d * (r * (1, a, b) + t / d) in the previous one, whose projection only depends on p = r * (1, a, b) + t / d.
+*/
+void computeRow(const OpticalFlowGenerator::Frame& frame, const Motion& m, int y, float* out)
+{
+    const OpticalFlowGenerator::Intrinsics& k = frame.intrinsics;
+    const size_t width = static_cast<size_t>(frame.width);
+    const float* depth = frame.planar_depth + static_cast<size_t>(y) * width;
+    const float inv_fx = 1 / k.fx;
+    const float b = (y + 0.5f - k.cy) / k.fy;
+    //the parts of r * (1, a, b) that are the same for the whole row
+    const float row_x = m.r[0][0] + m.r[0][2] * b;
+    const float row_y = m.r[1][0] + m.r[1][2] * b;
+    const float row_z = m.r[2][0] + m.r[2][2] * b;
+
+    size_t x = 0;
+#ifdef AIRLIB_OPTICAL_FLOW_SSE
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 nan = _mm_set1_ps(std::numeric_limits<float>::quiet_NaN());
+    const __m128 centers = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+    const __m128 cx = _mm_set1_ps(k.cx), scale_x = _mm_set1_ps(inv_fx);
+    const __m128 fx = _mm_set1_ps(k.fx), fy = _mm_set1_ps(k.fy), bv = _mm_set1_ps(b);
+    const __m128 min_depth = _mm_set1_ps(MinProjectedDepth);
+    const __m128 rx = _mm_set1_ps(row_x), ry = _mm_set1_ps(row_y), rz = _mm_set1_ps(row_z);
+    const __m128 ax = _mm_set1_ps(m.r[0][1]), ay = _mm_set1_ps(m.r[1][1]), az = _mm_set1_ps(m.r[2][1]);
+    const __m128 tx = _mm_set1_ps(m.t[0]), ty = _mm_set1_ps(m.t[1]), tz = _mm_set1_ps(m.t[2]);
+    for (; x + 4 <= width; x += 4) {
+        const __m128 d = _mm_loadu_ps(depth + x);
+        const __m128 a = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(x)), centers), cx), scale_x);
+        const __m128 w = _mm_div_ps(one, d);
+        const __m128 px = _mm_add_ps(_mm_add_ps(rx, _mm_mul_ps(ax, a)), _mm_mul_ps(tx, w));
+        const __m128 py = _mm_add_ps(_mm_add_ps(ry, _mm_mul_ps(ay, a)), _mm_mul_ps(ty, w));
+        const __m128 pz = _mm_add_ps(_mm_add_ps(rz, _mm_mul_ps(az, a)), _mm_mul_ps(tz, w));
+        //false for nan depth too
+        const __m128 valid = _mm_and_ps(_mm_cmpgt_ps(d, zero), _mm_cmpgt_ps(px, min_depth));
+        const __m128 flow_u = _mm_mul_ps(fx, _mm_sub_ps(a, _mm_div_ps(py, px)));
+        const __m128 flow_v = _mm_mul_ps(fy, _mm_sub_ps(bv, _mm_div_ps(pz, px)));
+        const __m128 u = _mm_or_ps(_mm_and_ps(valid, flow_u), _mm_andnot_ps(valid, nan));
+        const __m128 v = _mm_or_ps(_mm_and_ps(valid, flow_v), _mm_andnot_ps(valid, nan));
+        _mm_storeu_ps(out + 2 * x, _mm_unpacklo_ps(u, v));
+        _mm_storeu_ps(out + 2 * x + 4, _mm_unpackhi_ps(u, v));
+    }
+#endif
+    for (; x < width; ++x) {
+        const float d = depth[x];
+        const float a = (static_cast<float>(x) + 0.5f - k.cx) * inv_fx;
+        const float w = 1 / d;
+        const float px = row_x + m.r[0][1] * a + m.t[0] * w;
+        const float py = row_y + m.r[1][1] * a + m.t[1] * w;
+        const float pz = row_z + m.r[2][1] * a + m.t[2] * w;
+        if (d > 0 && px > MinProjectedDepth) {
+            out[2 * x] = k.fx * (a - py / px);
+            out[2 * x + 1] = k.fy * (b - pz / px);
+        }
+        else
+            out[2 * x] = out[2 * x + 1] = std::numeric_limits<float>::quiet_NaN();
+    }
+}
+
+} //namespace
+
+struct OpticalFlowGenerator::impl {
+    bool masked[256] = {};
+    bool has_mask = false;
+    uint thread_count = 0;
+    bool has_previous = false;
+    Pose previous_pose;
+
+    impl(const AirSimSettings::OpticalFlowSetting& setting)
+    {
+        for (int id : setting.masked_object_ids) {
+            if (id < 0 || id > 255)
+                throw std::invalid_argument(Utils::stringf("Optical flow MaskedObjectIDs must be between 0 and 255, got %d", id));
+            masked[id] = true;
+            has_mask = true;
+        }
+    }
+
+    void compute(const Frame& frame, const Pose& previous, vector<float>& flow) const
+    {
+        if (frame.planar_depth == nullptr || frame.width <= 0 || frame.height <= 0)
+            throw std::invalid_argument(Utils::stringf("Optical flow needs the depth of a frame of at least 1x1 pixels, got %dx%d",
+                frame.width, frame.height));
+        const Intrinsics& k = frame.intrinsics;
+        if (!(k.fx > 0 && k.fy > 0 && std::isfinite(k.fx) && std::isfinite(k.fy) && std::isfinite(k.cx) && std::isfinite(k.cy)))
+            throw std::invalid_argument("Optical flow intrinsics must be finite with positive focal lengths");
+        if (has_mask && (frame.object_ids == nullptr || frame.object_id_stride < 1))
+            throw std::invalid_argument("Optical flow masks object IDs but the frame has none");
+
+        const size_t pixels = static_cast<size_t>(frame.width) * frame.height;
+        flow.resize(pixels * 2);
+        const Motion motion = makeMotion(previous, frame.pose);
+
+        uint threads = thread_count == 0 ? std::max(1u, std::thread::hardware_concurrency()) : thread_count;
+        threads = std::min(threads, static_cast<uint>(frame.height));
+        runOnThreads(threads, [&](uint worker) {
+            const int begin = static_cast<int>(static_cast<int64_t>(frame.height) * worker / threads);
+            const int end = static_cast<int>(static_cast<int64_t>(frame.height) * (worker + 1) / threads);
+            for (int y = begin; y < end; ++y) {
+                float* out = &flow[static_cast<size_t>(y) * frame.width * 2];
+                computeRow(frame, motion, y, out);
+                if (!has_mask)
+                    continue;
+                const uint8_t* ids = frame.object_ids + static_cast<size_t>(y) * frame.width * frame.object_id_stride;
+                for (int x = 0; x < frame.width; ++x) {
+                    if (masked[ids[static_cast<size_t>(x) * frame.object_id_stride]])
+                        out[2 * x] = out[2 * x + 1] = std::numeric_limits<float>::quiet_NaN();
+                }
+            }
+        });
+    }
+};
+
+OpticalFlowGenerator::Intrinsics OpticalFlowGenerator::Intrinsics::fromProjectionMatrix(const ProjectionMatrix& projection, int width, int height)
+{
+    const float scale_x = projection.matrix[0][0], scale_y = projection.matrix[1][1];
+    if (!(std::isfinite(scale_x) && std::isfinite(scale_y)))
+        throw std::invalid_argument("Projection matrix for optical flow is not available");
+    //perspective matrices copy the depth into w, orthographic ones do not
+    if (projection.matrix[2][3] == 0)
+        throw std::invalid_argument("Optical flow is not available for orthographic cameras");
+    return Intrinsics(scale_x * width / 2.0f, scale_y * height / 2.0f, width / 2.0f, height / 2.0f);
+}
+
+OpticalFlowGenerator::OpticalFlowGenerator(const AirSimSettings::OpticalFlowSetting& setting)
+    : pimpl_(new impl(setting))
+{
+}
+
+OpticalFlowGenerator::~OpticalFlowGenerator() = default;
+
+void OpticalFlowGenerator::reset()
+{
+    pimpl_->has_previous = false;
+}
+
+void OpticalFlowGenerator::setThreadCount(uint thread_count)
+{
+    pimpl_->thread_count = thread_count;
+}
+
+bool OpticalFlowGenerator::needsObjectIDs() const
+{
+    return pimpl_->has_mask;
+}
+
+void OpticalFlowGenerator::addFrame(const Frame& frame, vector<float>& flow)
+{
+    pimpl_->compute(frame, pimpl_->has_previous ? pimpl_->previous_pose : frame.pose, flow);
+    pimpl_->previous_pose = frame.pose;
+    pimpl_->has_previous = true;
+}
+
+void OpticalFlowGenerator::computeFlow(const Frame& frame, const Pose& previous_pose, vector<float>& flow) const
+{
+    pimpl_->compute(frame, previous_pose, flow);
+}
+
+}} //namespace
+
+#endif
@@ -0,0 +1,542 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//in header only mode, control library is not available
+#ifndef AIRLIB_HEADER_ONLY
+
+#include "raycast/SignedDistanceField.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <fstream>
+
+#if defined _WIN32 || defined _WIN64
+#include "common/common_utils/WindowsApisCommonPre.hpp"
+#include "common/common_utils/MinWinDefines.hpp"
+#undef NOKERNEL				    // All KERNEL #undefs and routines
+#include <Windows.h>
+#include "common/common_utils/WindowsApisCommonPost.hpp"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace msr { namespace airlib {
+
+namespace {
+
+constexpr int BrickSamples = SignedDistanceField::BrickSize + 1; //bricks share their border samples
+constexpr int SamplesPerBrick = BrickSamples * BrickSamples * BrickSamples;
+constexpr int32_t FarOutside = -1;
+constexpr int32_t FarInside = -2;
+constexpr int32_t Unresolved = -3; //only while building
+constexpr real_T QuantizedMax = 32767;
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    float origin[3];
+    float voxel_size;
+    float band;
+    int32_t bricks[3];
+    uint32_t brick_count;
+    uint32_t reserved;
+};
+const char FileMagic[4] = { 'A', 'S', 'D', 'F' };
+constexpr uint32_t FileVersion = 1;
+
+//read only view of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& file_path)
+    {
+#if defined _WIN32 || defined _WIN64
+        file_ = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Cannot open signed distance field " + file_path);
+        LARGE_INTEGER size;
+        GetFileSizeEx(file_, &size);
+        size_ = static_cast<size_t>(size.QuadPart);
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ != nullptr)
+            data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+#else
+        file_ = open(file_path.c_str(), O_RDONLY);
+        if (file_ < 0)
+            throw std::runtime_error("Cannot open signed distance field " + file_path);
+        struct stat info;
+        fstat(file_, &info);
+        size_ = static_cast<size_t>(info.st_size);
+        void* data = size_ > 0 ? mmap(nullptr, size_, PROT_READ, MAP_SHARED, file_, 0) : MAP_FAILED;
+        if (data != MAP_FAILED)
+            data_ = static_cast<const uint8_t*>(data);
+#endif
+        if (data_ == nullptr) {
+            close();
+            throw std::runtime_error("Cannot map signed distance field " + file_path);
+        }
+    }
+
+    ~MappedFile()
+    {
+        close();
+    }
+
+    const uint8_t* data() const
+    {
+        return data_;
+    }
+    size_t size() const
+    {
+        return size_;
+    }
+
+private:
+    void close()
+    {
+#if defined _WIN32 || defined _WIN64
+        if (data_ != nullptr)
+            UnmapViewOfFile(data_);
+        if (mapping_ != nullptr)
+            CloseHandle(mapping_);
+        CloseHandle(file_);
+#else
+        if (data_ != nullptr)
+            munmap(const_cast<uint8_t*>(data_), size_);
+        ::close(file_);
+#endif
+        data_ = nullptr;
+    }
+
+#if defined _WIN32 || defined _WIN64
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int file_ = -1;
+#endif
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+//closest point on triangle abc to p, from Real-Time Collision Detection by Christer Ericson, 5.1.5
+Vector3r closestPointOnTriangle(const Vector3r& p, const Vector3r& a, const Vector3r& b, const Vector3r& c)
+{
+    Vector3r ab = b - a, ac = c - a, ap = p - a;
+    real_T d1 = ab.dot(ap), d2 = ac.dot(ap);
+    if (d1 <= 0 && d2 <= 0)
+        return a;
+    Vector3r bp = p - b;
+    real_T d3 = ab.dot(bp), d4 = ac.dot(bp);
+    if (d3 >= 0 && d4 <= d3)
+        return b;
+    real_T vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0)
+        return a + ab * (d1 / (d1 - d3));
+    Vector3r cp = p - c;
+    real_T d5 = ab.dot(cp), d6 = ac.dot(cp);
+    if (d6 >= 0 && d5 <= d6)
+        return c;
+    real_T vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0)
+        return a + ac * (d2 / (d2 - d6));
+    real_T va = d3 * d6 - d5 * d4;
+    if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    real_T denom = 1 / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+} //namespace
+
+struct SignedDistanceField::impl {
+    Vector3r origin = Vector3r::Zero();
+    real_T voxel_size = 0;
+    real_T band = 0;
+    int bricks[3] = { 0, 0, 0 };
+    uint32_t brick_count = 0;
+
+    //either owned after build() or pointing in to the mapped file after load()
+    vector<int32_t> owned_table;
+    vector<int16_t> owned_samples;
+    std::unique_ptr<MappedFile> mapped;
+    const int32_t* table = nullptr;
+    const int16_t* samples = nullptr;
+
+    int brickCell(int x, int y, int z) const
+    {
+        return (z * bricks[1] + y) * bricks[0] + x;
+    }
+
+    static int sampleIndex(int x, int y, int z)
+    {
+        return (z * BrickSamples + y) * BrickSamples + x;
+    }
+
+    //finds the brick and the position in it, returns the table entry
+    int32_t locate(const Vector3r& point, Vector3r& local) const
+    {
+        Vector3r grid = (point - origin) / voxel_size;
+        int cell[3];
+        for (int a = 0; a < 3; ++a) {
+            if (!(grid[a] >= 0 && grid[a] < static_cast<real_T>(bricks[a] * BrickSize)))
+                return FarOutside;
+            cell[a] = std::min(bricks[a] - 1, static_cast<int>(grid[a]) / BrickSize);
+            local[a] = grid[a] - static_cast<real_T>(cell[a] * BrickSize);
+        }
+        return table[brickCell(cell[0], cell[1], cell[2])];
+    }
+
+    //trilinear interpolation of a brick, optionally with its gradient
+    real_T interpolate(int32_t brick, const Vector3r& local, Vector3r* gradient) const
+    {
+        int i[3];
+        real_T f[3];
+        for (int a = 0; a < 3; ++a) {
+            i[a] = std::min(BrickSize - 1, static_cast<int>(local[a]));
+            f[a] = local[a] - static_cast<real_T>(i[a]);
+        }
+        const int16_t* s = samples + static_cast<size_t>(brick) * SamplesPerBrick;
+        real_T c[2][2][2];
+        for (int dz = 0; dz < 2; ++dz)
+            for (int dy = 0; dy < 2; ++dy)
+                for (int dx = 0; dx < 2; ++dx)
+                    c[dz][dy][dx] = s[sampleIndex(i[0] + dx, i[1] + dy, i[2] + dz)];
+
+        real_T scale = band / QuantizedMax;
+        real_T c00 = c[0][0][0] + (c[0][0][1] - c[0][0][0]) * f[0], c01 = c[0][1][0] + (c[0][1][1] - c[0][1][0]) * f[0];
+        real_T c10 = c[1][0][0] + (c[1][0][1] - c[1][0][0]) * f[0], c11 = c[1][1][0] + (c[1][1][1] - c[1][1][0]) * f[0];
+        real_T c0 = c00 + (c01 - c00) * f[1], c1 = c10 + (c11 - c10) * f[1];
+        if (gradient != nullptr) {
+            real_T gx0 = (c[0][0][1] - c[0][0][0]) + ((c[0][1][1] - c[0][1][0]) - (c[0][0][1] - c[0][0][0])) * f[1];
+            real_T gx1 = (c[1][0][1] - c[1][0][0]) + ((c[1][1][1] - c[1][1][0]) - (c[1][0][1] - c[1][0][0])) * f[1];
+            (*gradient)[0] = (gx0 + (gx1 - gx0) * f[2]) * scale;
+            (*gradient)[1] = ((c01 - c00) + ((c11 - c10) - (c01 - c00)) * f[2]) * scale;
+            (*gradient)[2] = (c1 - c0) * scale;
+        }
+        return (c0 + (c1 - c0) * f[2]) * scale;
+    }
+
+    void build(const StaticScene& scene, real_T voxel_size_val, real_T band_val)
+    {
+        if (!(voxel_size_val > 0))
+            throw std::invalid_argument("Voxel size of a signed distance field must be positive");
+        mapped.reset();
+        voxel_size = voxel_size_val;
+        band = band_val > 0 ? band_val : 4 * voxel_size;
+
+        vector<Vector3r> corners;
+        Vector3r corner[3];
+        for (int mesh = 0; mesh < scene.meshCount(); ++mesh) {
+            for (uint triangle = 0; triangle < scene.triangleCount(mesh); ++triangle) {
+                scene.getTriangle(mesh, triangle, corner);
+                corners.insert(corners.end(), corner, corner + 3);
+            }
+        }
+
+        Vector3r min_corner = Vector3r::Constant(std::numeric_limits<real_T>::max());
+        Vector3r max_corner = Vector3r::Constant(std::numeric_limits<real_T>::lowest());
+        for (const auto& point : corners) {
+            min_corner = min_corner.cwiseMin(point);
+            max_corner = max_corner.cwiseMax(point);
+        }
+        if (corners.empty())
+            min_corner = max_corner = Vector3r::Zero();
+        real_T padding = band + voxel_size;
+        origin = min_corner - Vector3r::Constant(padding);
+        for (int a = 0; a < 3; ++a)
+            bricks[a] = corners.empty() ? 0 : static_cast<int>(std::ceil((max_corner[a] + padding - origin[a]) / (voxel_size * BrickSize)));
+        int cells = bricks[0] * bricks[1] * bricks[2];
+
+        //nearest unsigned distance per sample and how squarely the sample faces that triangle, the sign of which
+        //is the side. Equally near triangles share an edge or corner and the most square one decides the side.
+        vector<int32_t> working_table(cells, Unresolved);
+        vector<float> nearest, facing;
+        const real_T tie = 1e-5f * voxel_size;
+
+        for (size_t t = 0; t < corners.size() / 3; ++t) {
+            const Vector3r& a = corners[t * 3];
+            const Vector3r& b = corners[t * 3 + 1];
+            const Vector3r& c = corners[t * 3 + 2];
+            Vector3r normal = (b - a).cross(c - a);
+            if (normal.squaredNorm() == 0)
+                continue;
+            normal.normalize();
+
+            int lo[3], hi[3], brick_lo[3], brick_hi[3];
+            for (int axis = 0; axis < 3; ++axis) {
+                real_T min_value = std::min(a[axis], std::min(b[axis], c[axis])) - band;
+                real_T max_value = std::max(a[axis], std::max(b[axis], c[axis])) + band;
+                lo[axis] = std::max(0, static_cast<int>(std::ceil((min_value - origin[axis]) / voxel_size)));
+                hi[axis] = std::min(bricks[axis] * BrickSize, static_cast<int>(std::floor((max_value - origin[axis]) / voxel_size)));
+                //brick k holds samples k * BrickSize to (k + 1) * BrickSize
+                brick_lo[axis] = lo[axis] > 0 ? (lo[axis] - 1) / BrickSize : 0;
+                brick_hi[axis] = std::min(bricks[axis] - 1, hi[axis] / BrickSize);
+            }
+
+            for (int bz = brick_lo[2]; bz <= brick_hi[2]; ++bz)
+                for (int by = brick_lo[1]; by <= brick_hi[1]; ++by)
+                    for (int bx = brick_lo[0]; bx <= brick_hi[0]; ++bx) {
+                        int32_t& entry = working_table[brickCell(bx, by, bz)];
+                        if (entry == Unresolved) {
+                            entry = static_cast<int32_t>(nearest.size() / SamplesPerBrick);
+                            nearest.resize(nearest.size() + SamplesPerBrick, std::numeric_limits<float>::max());
+                            facing.resize(facing.size() + SamplesPerBrick, 0);
+                        }
+                        float* brick_nearest = &nearest[static_cast<size_t>(entry) * SamplesPerBrick];
+                        float* brick_facing = &facing[static_cast<size_t>(entry) * SamplesPerBrick];
+                        int x0 = std::max(lo[0], bx * BrickSize), x1 = std::min(hi[0], (bx + 1) * BrickSize);
+                        int y0 = std::max(lo[1], by * BrickSize), y1 = std::min(hi[1], (by + 1) * BrickSize);
+                        int z0 = std::max(lo[2], bz * BrickSize), z1 = std::min(hi[2], (bz + 1) * BrickSize);
+                        for (int z = z0; z <= z1; ++z)
+                            for (int y = y0; y <= y1; ++y)
+                                for (int x = x0; x <= x1; ++x) {
+                                    Vector3r point = origin + Vector3r(static_cast<real_T>(x), static_cast<real_T>(y), static_cast<real_T>(z)) * voxel_size;
+                                    Vector3r offset = point - closestPointOnTriangle(point, a, b, c);
+                                    real_T distance = offset.norm();
+                                    if (distance >= band)
+                                        continue;
+                                    real_T side = distance > 0 ? offset.dot(normal) / distance : 1;
+                                    int index = sampleIndex(x - bx * BrickSize, y - by * BrickSize, z - bz * BrickSize);
+                                    if (distance < brick_nearest[index] - tie
+                                        || (distance <= brick_nearest[index] + tie && std::fabs(side) > std::fabs(brick_facing[index]))) {
+                                        brick_nearest[index] = std::min(brick_nearest[index], distance);
+                                        brick_facing[index] = side;
+                                    }
+                                }
+                    }
+        }
+
+        //signed values, samples farther than band take the side of their neighbors
+        vector<float> values(nearest.size());
+        vector<bool> empty_bricks(nearest.size() / SamplesPerBrick, false);
+        for (size_t brick = 0; brick < empty_bricks.size(); ++brick) {
+            float* value = &values[brick * SamplesPerBrick];
+            bool any_set = false;
+            for (int i = 0; i < SamplesPerBrick; ++i) {
+                float distance = nearest[brick * SamplesPerBrick + i];
+                if (distance < band) {
+                    value[i] = facing[brick * SamplesPerBrick + i] >= 0 ? distance : -distance;
+                    any_set = true;
+                }
+                else
+                    value[i] = std::numeric_limits<float>::quiet_NaN();
+            }
+            empty_bricks[brick] = !any_set;
+            for (bool changed = any_set; changed;) {
+                changed = false;
+                for (int z = 0; z < BrickSamples; ++z)
+                    for (int y = 0; y < BrickSamples; ++y)
+                        for (int x = 0; x < BrickSamples; ++x) {
+                            float& v = value[sampleIndex(x, y, z)];
+                            if (!std::isnan(v))
+                                continue;
+                            const int neighbors[6][3] = { { x - 1, y, z }, { x + 1, y, z }, { x, y - 1, z }, { x, y + 1, z }, { x, y, z - 1 }, { x, y, z + 1 } };
+                            for (const auto& n : neighbors) {
+                                //unsigned compares also reject -1
+                                if (static_cast<uint>(n[0]) >= static_cast<uint>(BrickSamples) || static_cast<uint>(n[1]) >= static_cast<uint>(BrickSamples)
+                                    || static_cast<uint>(n[2]) >= static_cast<uint>(BrickSamples))
+                                    continue;
+                                float neighbor = value[sampleIndex(n[0], n[1], n[2])];
+                                if (!std::isnan(neighbor)) {
+                                    v = neighbor >= 0 ? band : -band;
+                                    changed = true;
+                                    break;
+                                }
+                            }
+                        }
+            }
+        }
+        for (auto& entry : working_table) {
+            if (entry >= 0 && empty_bricks[entry])
+                entry = Unresolved;
+        }
+
+        //bricks without samples take the side of their neighbors, starting from the faces of bricks with samples
+        std::deque<int> queue;
+        for (int cell = 0; cell < cells; ++cell) {
+            if (working_table[cell] >= 0)
+                queue.push_back(cell);
+        }
+        while (!queue.empty()) {
+            int cell = queue.front();
+            queue.pop_front();
+            int cx = cell % bricks[0], cy = (cell / bricks[0]) % bricks[1], cz = cell / (bricks[0] * bricks[1]);
+            int32_t entry = working_table[cell];
+            for (int axis = 0; axis < 3; ++axis) {
+                for (int direction = -1; direction <= 1; direction += 2) {
+                    int n[3] = { cx, cy, cz };
+                    n[axis] += direction;
+                    if (static_cast<uint>(n[axis]) >= static_cast<uint>(bricks[axis]))
+                        continue;
+                    int neighbor = brickCell(n[0], n[1], n[2]);
+                    if (working_table[neighbor] != Unresolved)
+                        continue;
+                    int32_t side = entry;
+                    if (entry >= 0) {
+                        //the most distant sample on the shared face is the most reliable
+                        float best = 0;
+                        for (int u = 0; u < BrickSamples; ++u)
+                            for (int v = 0; v < BrickSamples; ++v) {
+                                int s[3];
+                                s[axis] = direction < 0 ? 0 : BrickSize;
+                                s[(axis + 1) % 3] = u;
+                                s[(axis + 2) % 3] = v;
+                                float value = values[static_cast<size_t>(entry) * SamplesPerBrick + sampleIndex(s[0], s[1], s[2])];
+                                if (std::fabs(value) > std::fabs(best))
+                                    best = value;
+                            }
+                        side = best >= 0 ? FarOutside : FarInside;
+                    }
+                    working_table[neighbor] = side;
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+
+        //quantize the bricks in table order
+        owned_table.assign(cells, FarOutside);
+        owned_samples.clear();
+        brick_count = 0;
+        for (int cell = 0; cell < cells; ++cell) {
+            int32_t entry = working_table[cell];
+            if (entry < 0) {
+                owned_table[cell] = entry == FarInside ? FarInside : FarOutside;
+                continue;
+            }
+            owned_table[cell] = static_cast<int32_t>(brick_count++);
+            for (int i = 0; i < SamplesPerBrick; ++i) {
+                real_T value = values[static_cast<size_t>(entry) * SamplesPerBrick + i] / band * QuantizedMax;
+                owned_samples.push_back(static_cast<int16_t>(std::round(Utils::clip(value, -QuantizedMax, QuantizedMax))));
+            }
+        }
+        table = owned_table.data();
+        samples = owned_samples.data();
+    }
+};
+
+SignedDistanceField::SignedDistanceField()
+    : pimpl_(new impl())
+{
+}
+
+SignedDistanceField::~SignedDistanceField() = default;
+
+void SignedDistanceField::build(const StaticScene& scene, real_T voxel_size, real_T band)
+{
+    pimpl_->build(scene, voxel_size, band);
+}
+
+void SignedDistanceField::save(const std::string& file_path) const
+{
+    FileHeader header;
+    std::memcpy(header.magic, FileMagic, sizeof(header.magic));
+    header.version = FileVersion;
+    for (int a = 0; a < 3; ++a) {
+        header.origin[a] = pimpl_->origin[a];
+        header.bricks[a] = pimpl_->bricks[a];
+    }
+    header.voxel_size = pimpl_->voxel_size;
+    header.band = pimpl_->band;
+    header.brick_count = pimpl_->brick_count;
+    header.reserved = 0;
+
+    std::ofstream file(file_path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Cannot write signed distance field " + file_path);
+    size_t cells = static_cast<size_t>(pimpl_->bricks[0]) * pimpl_->bricks[1] * pimpl_->bricks[2];
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(pimpl_->table), cells * sizeof(int32_t));
+    file.write(reinterpret_cast<const char*>(pimpl_->samples), static_cast<size_t>(pimpl_->brick_count) * SamplesPerBrick * sizeof(int16_t));
+    if (!file)
+        throw std::runtime_error("Cannot write signed distance field " + file_path);
+}
+
+void SignedDistanceField::load(const std::string& file_path)
+{
+    std::unique_ptr<MappedFile> mapped(new MappedFile(file_path));
+    FileHeader header;
+    if (mapped->size() < sizeof(header))
+        throw std::runtime_error("Signed distance field " + file_path + " is truncated");
+    std::memcpy(&header, mapped->data(), sizeof(header));
+    if (std::memcmp(header.magic, FileMagic, sizeof(header.magic)) != 0 || header.version != FileVersion)
+        throw std::runtime_error("File " + file_path + " is not a signed distance field of a supported version");
+    if (header.bricks[0] < 0 || header.bricks[1] < 0 || header.bricks[2] < 0)
+        throw std::runtime_error("Signed distance field " + file_path + " is corrupt");
+    size_t cells = static_cast<size_t>(header.bricks[0]) * header.bricks[1] * header.bricks[2];
+    size_t expected = sizeof(header) + cells * sizeof(int32_t) + static_cast<size_t>(header.brick_count) * SamplesPerBrick * sizeof(int16_t);
+    if (mapped->size() != expected)
+        throw std::runtime_error("Signed distance field " + file_path + " is truncated");
+
+    impl& field = *pimpl_;
+    field.origin = Vector3r(header.origin[0], header.origin[1], header.origin[2]);
+    field.voxel_size = header.voxel_size;
+    field.band = header.band;
+    for (int a = 0; a < 3; ++a)
+        field.bricks[a] = header.bricks[a];
+    field.brick_count = header.brick_count;
+    field.table = reinterpret_cast<const int32_t*>(mapped->data() + sizeof(header));
+    field.samples = reinterpret_cast<const int16_t*>(mapped->data() + sizeof(header) + cells * sizeof(int32_t));
+    field.owned_table.clear();
+    field.owned_samples.clear();
+    field.mapped = std::move(mapped);
+}
+
+bool SignedDistanceField::isEmpty() const
+{
+    return pimpl_->brick_count == 0;
+}
+
+real_T SignedDistanceField::getVoxelSize() const
+{
+    return pimpl_->voxel_size;
+}
+
+real_T SignedDistanceField::getBand() const
+{
+    return pimpl_->band;
+}
+
+size_t SignedDistanceField::getMemorySize() const
+{
+    return static_cast<size_t>(pimpl_->bricks[0]) * pimpl_->bricks[1] * pimpl_->bricks[2] * sizeof(int32_t)
+        + static_cast<size_t>(pimpl_->brick_count) * SamplesPerBrick * sizeof(int16_t);
+}
+
+real_T SignedDistanceField::distance(const Vector3r& point) const
+{
+    if (pimpl_->table == nullptr)
+        return pimpl_->band;
+    Vector3r local;
+    int32_t entry = pimpl_->locate(point, local);
+    if (entry < 0)
+        return entry == FarInside ? -pimpl_->band : pimpl_->band;
+    return pimpl_->interpolate(entry, local, nullptr);
+}
+
+SignedDistanceField::Sample SignedDistanceField::sample(const Vector3r& point) const
+{
+    Sample result;
+    result.normal = Vector3r::Zero();
+    result.distance = pimpl_->band;
+    if (pimpl_->table == nullptr)
+        return result;
+
+    Vector3r local;
+    int32_t entry = pimpl_->locate(point, local);
+    if (entry < 0) {
+        result.distance = entry == FarInside ? -pimpl_->band : pimpl_->band;
+        return result;
+    }
+    Vector3r gradient;
+    result.distance = pimpl_->interpolate(entry, local, &gradient);
+    real_T length = gradient.norm();
+    if (length > 0)
+        result.normal = gradient / length;
+    return result;
+}
+
+}} //namespace
+#endif
@@ -0,0 +1,656 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//in header only mode, control library is not available
+#ifndef AIRLIB_HEADER_ONLY
+
+#include "raycast/StaticScene.hpp"
+#include <algorithm>
+#include <thread>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AIRLIB_STATIC_SCENE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace msr { namespace airlib {
+
+namespace {
+
+//node of the flattened hierarchy, children of an inner node are stored next to each other
+struct BvhNode {
+    float min[3];
+    uint32_t index; //first triangle of a leaf or left child of an inner node
+    float max[3];
+    uint16_t count; //triangles in a leaf, 0 for inner nodes
+    uint16_t axis; //split axis of an inner node
+};
+
+//triangle in the form the intersection test wants it, in hierarchy order
+struct BvhTriangle {
+    float v0[3];
+    float e1[3];
+    float e2[3];
+    int mesh;
+    uint32_t triangle;
+};
+
+struct TriangleRef {
+    float min[3];
+    float max[3];
+    float centroid[3];
+    uint32_t source;
+};
+
+struct Bounds {
+    float min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    void grow(const float lo[3], const float hi[3])
+    {
+        for (int a = 0; a < 3; ++a) {
+            min[a] = std::min(min[a], lo[a]);
+            max[a] = std::max(max[a], hi[a]);
+        }
+    }
+    void grow(const float p[3])
+    {
+        grow(p, p);
+    }
+    float area() const
+    {
+        float dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+        if (dx < 0 || dy < 0 || dz < 0)
+            return 0;
+        return 2 * (dx * dy + dy * dz + dz * dx);
+    }
+};
+
+constexpr int SahBins = 16;
+constexpr uint MaxLeafSize = 8;
+constexpr uint MaxDepth = 60;
+//the median splits below MaxDepth keep trees of any size well within this
+constexpr int StackSize = 128;
+//determinants closer to zero than this are rays parallel to the triangle
+constexpr float ParallelEpsilon = 1e-20f;
+
+//directions with a zero component get a tiny one instead so the slab test never computes 0 * infinity
+inline float safeInverse(float d)
+{
+    const float tiny = 1e-20f;
+    if (std::fabs(d) < tiny)
+        d = d < 0 ? -tiny : tiny;
+    return 1 / d;
+}
+
+struct ScalarRay {
+    float o[3];
+    float d[3];
+    float inv[3];
+    float t;
+    float t_min;
+    int mesh;
+    uint32_t triangle;
+
+    ScalarRay(const Vector3r& origin, const Vector3r& direction, float max_distance, float min_distance)
+        : t(max_distance), t_min(min_distance), mesh(-1), triangle(0)
+    {
+        for (int a = 0; a < 3; ++a) {
+            o[a] = origin[a];
+            d[a] = direction[a];
+            inv[a] = safeInverse(d[a]);
+        }
+    }
+};
+
+//Moller-Trumbore, written out so the scalar and SSE versions round the same way
+inline void intersect(const BvhTriangle& tri, ScalarRay& ray)
+{
+    float px = ray.d[1] * tri.e2[2] - ray.d[2] * tri.e2[1];
+    float py = ray.d[2] * tri.e2[0] - ray.d[0] * tri.e2[2];
+    float pz = ray.d[0] * tri.e2[1] - ray.d[1] * tri.e2[0];
+    float det = tri.e1[0] * px + tri.e1[1] * py + tri.e1[2] * pz;
+    if (!(std::fabs(det) > ParallelEpsilon))
+        return;
+    float inv_det = 1 / det;
+    float sx = ray.o[0] - tri.v0[0], sy = ray.o[1] - tri.v0[1], sz = ray.o[2] - tri.v0[2];
+    float u = (sx * px + sy * py + sz * pz) * inv_det;
+    if (!(u >= 0 && u <= 1))
+        return;
+    float qx = sy * tri.e1[2] - sz * tri.e1[1];
+    float qy = sz * tri.e1[0] - sx * tri.e1[2];
+    float qz = sx * tri.e1[1] - sy * tri.e1[0];
+    float v = (ray.d[0] * qx + ray.d[1] * qy + ray.d[2] * qz) * inv_det;
+    if (!(v >= 0 && u + v <= 1))
+        return;
+    float t = (tri.e2[0] * qx + tri.e2[1] * qy + tri.e2[2] * qz) * inv_det;
+    if (t > ray.t_min && t < ray.t) {
+        ray.t = t;
+        ray.mesh = tri.mesh;
+        ray.triangle = tri.triangle;
+    }
+}
+
+//distance where the ray enters the box, or FLT_MAX if it misses it or only enters it past the current hit
+inline float enter(const BvhNode& node, const ScalarRay& ray)
+{
+    float t_near = ray.t_min, t_far = ray.t;
+    for (int a = 0; a < 3; ++a) {
+        float t1 = (node.min[a] - ray.o[a]) * ray.inv[a];
+        float t2 = (node.max[a] - ray.o[a]) * ray.inv[a];
+        t_near = std::max(t_near, std::min(t1, t2));
+        t_far = std::min(t_far, std::max(t1, t2));
+    }
+    return t_near <= t_far ? t_near : FLT_MAX;
+}
+
+} //anonymous namespace
+
+struct StaticScene::impl {
+    struct MeshInfo {
+        std::string name;
+        uint32_t first; //first triangle in corners
+        uint32_t count;
+    };
+
+    vector<MeshInfo> meshes;
+    vector<Vector3r> corners; //three per triangle in the order meshes were added
+    vector<BvhNode> nodes;
+    vector<BvhTriangle> triangles;
+    bool built = false;
+
+    void build()
+    {
+        uint32_t count = static_cast<uint32_t>(corners.size() / 3);
+        vector<TriangleRef> refs(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            TriangleRef& ref = refs[i];
+            ref.source = i;
+            for (int a = 0; a < 3; ++a) {
+                float c0 = corners[i * 3][a], c1 = corners[i * 3 + 1][a], c2 = corners[i * 3 + 2][a];
+                ref.min[a] = std::min(c0, std::min(c1, c2));
+                ref.max[a] = std::max(c0, std::max(c1, c2));
+                ref.centroid[a] = (ref.min[a] + ref.max[a]) / 2;
+            }
+        }
+
+        nodes.clear();
+        nodes.reserve(count > 0 ? 2 * count : 1);
+        nodes.push_back(BvhNode());
+        if (count == 0) {
+            //a root that nothing can hit
+            BvhNode& root = nodes[0];
+            for (int a = 0; a < 3; ++a) {
+                root.min[a] = FLT_MAX;
+                root.max[a] = -FLT_MAX;
+            }
+            root.index = 0;
+            root.count = 0;
+            root.axis = 0;
+        }
+        else
+            split(0, refs, 0, count, 0);
+
+        triangles.resize(count);
+        uint32_t mesh = 0;
+        vector<int> mesh_of(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            while (i >= meshes[mesh].first + meshes[mesh].count)
+                ++mesh;
+            mesh_of[i] = static_cast<int>(mesh);
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t source = refs[i].source;
+            BvhTriangle& tri = triangles[i];
+            const Vector3r& v0 = corners[source * 3];
+            Vector3r e1 = corners[source * 3 + 1] - v0;
+            Vector3r e2 = corners[source * 3 + 2] - v0;
+            for (int a = 0; a < 3; ++a) {
+                tri.v0[a] = v0[a];
+                tri.e1[a] = e1[a];
+                tri.e2[a] = e2[a];
+            }
+            tri.mesh = mesh_of[source];
+            tri.triangle = source - meshes[tri.mesh].first;
+        }
+        built = true;
+    }
+
+    void makeLeaf(uint32_t node_index, uint32_t begin, uint32_t end)
+    {
+        nodes[node_index].index = begin;
+        nodes[node_index].count = static_cast<uint16_t>(end - begin);
+        nodes[node_index].axis = 0;
+    }
+
+    void split(uint32_t node_index, vector<TriangleRef>& refs, uint32_t begin, uint32_t end, uint depth)
+    {
+        Bounds bounds, centroids;
+        for (uint32_t i = begin; i < end; ++i) {
+            bounds.grow(refs[i].min, refs[i].max);
+            centroids.grow(refs[i].centroid);
+        }
+        BvhNode& node = nodes[node_index];
+        for (int a = 0; a < 3; ++a) {
+            node.min[a] = bounds.min[a];
+            node.max[a] = bounds.max[a];
+        }
+
+        uint32_t count = end - begin;
+        //a leaf can hold at most 65535 triangles, deeper than MaxDepth only happens for piles of identical triangles
+        if (count <= 2 || (depth >= MaxDepth && count <= 0xffff)) {
+            makeLeaf(node_index, begin, end);
+            return;
+        }
+
+        //binned surface area heuristic: cost of a split is the area weighted triangle count of both sides
+        int best_axis = -1, best_bin = 0;
+        float best_cost = FLT_MAX;
+        for (int a = 0; a < 3; ++a) {
+            float extent = centroids.max[a] - centroids.min[a];
+            if (!(extent > 0))
+                continue;
+            Bounds bin_bounds[SahBins];
+            uint32_t bin_count[SahBins] = {};
+            float scale = SahBins / extent;
+            for (uint32_t i = begin; i < end; ++i) {
+                int bin = std::min(SahBins - 1, static_cast<int>((refs[i].centroid[a] - centroids.min[a]) * scale));
+                bin_bounds[bin].grow(refs[i].min, refs[i].max);
+                ++bin_count[bin];
+            }
+            float right_area[SahBins];
+            uint32_t right_count[SahBins];
+            Bounds right;
+            uint32_t right_total = 0;
+            for (int b = SahBins - 1; b > 0; --b) {
+                right.grow(bin_bounds[b].min, bin_bounds[b].max);
+                right_total += bin_count[b];
+                right_area[b] = right.area();
+                right_count[b] = right_total;
+            }
+            Bounds left;
+            uint32_t left_total = 0;
+            for (int b = 0; b < SahBins - 1; ++b) {
+                left.grow(bin_bounds[b].min, bin_bounds[b].max);
+                left_total += bin_count[b];
+                if (left_total == 0 || right_count[b + 1] == 0)
+                    continue;
+                float cost = left.area() * left_total + right_area[b + 1] * right_count[b + 1];
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_axis = a;
+                    best_bin = b;
+                }
+            }
+        }
+
+        //intersecting a triangle and visiting a node cost about the same
+        float area = bounds.area();
+        float leaf_cost = static_cast<float>(count);
+        float split_cost = area > 0 ? 1 + best_cost / area : FLT_MAX;
+        if (count <= MaxLeafSize && (best_axis < 0 || split_cost >= leaf_cost)) {
+            makeLeaf(node_index, begin, end);
+            return;
+        }
+
+        uint32_t middle;
+        int axis;
+        if (best_axis >= 0 && depth < MaxDepth) {
+            axis = best_axis;
+            float extent = centroids.max[axis] - centroids.min[axis];
+            float scale = SahBins / extent;
+            float min_centroid = centroids.min[axis];
+            auto first_right = std::partition(refs.begin() + begin, refs.begin() + end, [=](const TriangleRef& ref) {
+                return std::min(SahBins - 1, static_cast<int>((ref.centroid[axis] - min_centroid) * scale)) <= best_bin;
+            });
+            middle = static_cast<uint32_t>(first_right - refs.begin());
+        }
+        else {
+            //all centroids in one spot or the tree is already too deep, split the list in half
+            axis = 0;
+            middle = begin + count / 2;
+        }
+
+        uint32_t left = static_cast<uint32_t>(nodes.size());
+        nodes[node_index].index = left;
+        nodes[node_index].count = 0;
+        nodes[node_index].axis = static_cast<uint16_t>(axis);
+        nodes.push_back(BvhNode());
+        nodes.push_back(BvhNode());
+        split(left, refs, begin, middle, depth + 1);
+        split(left + 1, refs, middle, end, depth + 1);
+    }
+
+    void trace(ScalarRay& ray) const
+    {
+        uint32_t stack[StackSize];
+        int top = 0;
+        if (triangles.empty() || enter(nodes[0], ray) == FLT_MAX)
+            return;
+        uint32_t current = 0;
+        while (true) {
+            const BvhNode& node = nodes[current];
+            if (node.count > 0) {
+                for (uint32_t i = node.index; i < node.index + node.count; ++i)
+                    intersect(triangles[i], ray);
+            }
+            else {
+                uint32_t near_child = node.index, far_child = node.index + 1;
+                float t_near = enter(nodes[near_child], ray);
+                float t_far = enter(nodes[far_child], ray);
+                if (t_far < t_near) {
+                    std::swap(near_child, far_child);
+                    std::swap(t_near, t_far);
+                }
+                if (t_near != FLT_MAX) {
+                    if (t_far != FLT_MAX)
+                        stack[top++] = far_child;
+                    current = near_child;
+                    continue;
+                }
+            }
+            //pop the next subtree that could still have a nearer hit
+            bool found = false;
+            while (top > 0) {
+                current = stack[--top];
+                if (enter(nodes[current], ray) != FLT_MAX) {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+                return;
+        }
+    }
+
+    Hit traceOne(const Ray& ray, float t_min = 0) const
+    {
+        ScalarRay scalar(ray.origin, ray.direction, ray.max_distance, t_min);
+        trace(scalar);
+        Hit hit;
+        hit.distance = scalar.t;
+        hit.mesh = scalar.mesh;
+        hit.triangle = scalar.triangle;
+        return hit;
+    }
+
+#ifdef AIRLIB_STATIC_SCENE_SSE
+    //four rays traced together, a subtree is visited if any of them could hit something in it
+    void tracePacket(const Ray* rays, int ray_count, Hit* hits) const
+    {
+        float o[3][4], d[3][4], inv[3][4], t[4];
+        for (int lane = 0; lane < 4; ++lane) {
+            //spare lanes repeat the first ray and are thrown away
+            const Ray& ray = rays[lane < ray_count ? lane : 0];
+            for (int a = 0; a < 3; ++a) {
+                o[a][lane] = ray.origin[a];
+                d[a][lane] = ray.direction[a];
+                inv[a][lane] = safeInverse(ray.direction[a]);
+            }
+            t[lane] = ray.max_distance;
+        }
+        __m128 ox = _mm_loadu_ps(o[0]), oy = _mm_loadu_ps(o[1]), oz = _mm_loadu_ps(o[2]);
+        __m128 dx = _mm_loadu_ps(d[0]), dy = _mm_loadu_ps(d[1]), dz = _mm_loadu_ps(d[2]);
+        __m128 ix = _mm_loadu_ps(inv[0]), iy = _mm_loadu_ps(inv[1]), iz = _mm_loadu_ps(inv[2]);
+        __m128 best_t = _mm_loadu_ps(t);
+        __m128i best_mesh = _mm_set1_epi32(-1);
+        __m128i best_triangle = _mm_setzero_si128();
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1);
+        const __m128 epsilon = _mm_set1_ps(ParallelEpsilon);
+        const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+        //direction signs decide which child the packet visits first
+        int sign[3];
+        for (int a = 0; a < 3; ++a)
+            sign[a] = d[a][0] < 0 ? 1 : 0;
+
+        uint32_t stack[StackSize];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const BvhNode& node = nodes[stack[--top]];
+
+            __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.min[0]), ox), ix);
+            __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.max[0]), ox), ix);
+            __m128 t_near = _mm_max_ps(zero, _mm_min_ps(t1, t2));
+            __m128 t_far = _mm_min_ps(best_t, _mm_max_ps(t1, t2));
+            t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.min[1]), oy), iy);
+            t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.max[1]), oy), iy);
+            t_near = _mm_max_ps(t_near, _mm_min_ps(t1, t2));
+            t_far = _mm_min_ps(t_far, _mm_max_ps(t1, t2));
+            t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.min[2]), oz), iz);
+            t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.max[2]), oz), iz);
+            t_near = _mm_max_ps(t_near, _mm_min_ps(t1, t2));
+            t_far = _mm_min_ps(t_far, _mm_max_ps(t1, t2));
+            __m128 active = _mm_cmple_ps(t_near, t_far);
+            if (_mm_movemask_ps(active) == 0)
+                continue;
+
+            if (node.count == 0) {
+                uint32_t first = node.index + sign[node.axis];
+                uint32_t second = node.index + 1 - sign[node.axis];
+                stack[top++] = second;
+                stack[top++] = first;
+                continue;
+            }
+
+            for (uint32_t i = node.index; i < node.index + node.count; ++i) {
+                const BvhTriangle& tri = triangles[i];
+                __m128 e1x = _mm_set1_ps(tri.e1[0]), e1y = _mm_set1_ps(tri.e1[1]), e1z = _mm_set1_ps(tri.e1[2]);
+                __m128 e2x = _mm_set1_ps(tri.e2[0]), e2y = _mm_set1_ps(tri.e2[1]), e2z = _mm_set1_ps(tri.e2[2]);
+                __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+                __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+                __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+                __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+                __m128 mask = _mm_cmpgt_ps(_mm_and_ps(det, abs_mask), epsilon);
+                if (_mm_movemask_ps(mask) == 0)
+                    continue;
+                __m128 inv_det = _mm_div_ps(one, det);
+                __m128 sx = _mm_sub_ps(ox, _mm_set1_ps(tri.v0[0]));
+                __m128 sy = _mm_sub_ps(oy, _mm_set1_ps(tri.v0[1]));
+                __m128 sz = _mm_sub_ps(oz, _mm_set1_ps(tri.v0[2]));
+                __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inv_det);
+                mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+                if (_mm_movemask_ps(mask) == 0)
+                    continue;
+                __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+                __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+                __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+                __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inv_det);
+                __m128 tt = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inv_det);
+                mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+                mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpgt_ps(tt, zero), _mm_cmplt_ps(tt, best_t)));
+                if (_mm_movemask_ps(mask) == 0)
+                    continue;
+                __m128i imask = _mm_castps_si128(mask);
+                best_t = _mm_or_ps(_mm_and_ps(mask, tt), _mm_andnot_ps(mask, best_t));
+                best_mesh = _mm_or_si128(_mm_and_si128(imask, _mm_set1_epi32(tri.mesh)), _mm_andnot_si128(imask, best_mesh));
+                best_triangle = _mm_or_si128(_mm_and_si128(imask, _mm_set1_epi32(static_cast<int>(tri.triangle))), _mm_andnot_si128(imask, best_triangle));
+            }
+        }
+
+        float out_t[4];
+        int32_t out_mesh[4], out_triangle[4];
+        _mm_storeu_ps(out_t, best_t);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out_mesh), best_mesh);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out_triangle), best_triangle);
+        for (int lane = 0; lane < ray_count; ++lane) {
+            hits[lane].distance = out_t[lane];
+            hits[lane].mesh = out_mesh[lane];
+            hits[lane].triangle = static_cast<uint>(out_triangle[lane]);
+        }
+    }
+#else
+    void tracePacket(const Ray* rays, int ray_count, Hit* hits) const
+    {
+        for (int lane = 0; lane < ray_count; ++lane)
+            hits[lane] = traceOne(rays[lane]);
+    }
+#endif
+
+    void traceRange(const Ray* rays, size_t count, Hit* hits) const
+    {
+        if (triangles.empty()) {
+            for (size_t i = 0; i < count; ++i)
+                hits[i] = traceOne(rays[i]);
+            return;
+        }
+        for (size_t i = 0; i < count; i += 4)
+            tracePacket(rays + i, static_cast<int>(std::min<size_t>(4, count - i)), hits + i);
+    }
+};
+
+StaticScene::StaticScene()
+    : pimpl_(new impl())
+{
+}
+
+StaticScene::~StaticScene() = default;
+
+int StaticScene::addMesh(const TriangleMesh& mesh, const Pose& pose, const Vector3r& scale)
+{
+    TriangleMesh placed;
+    placed.append(mesh, pose, scale);
+
+    impl::MeshInfo info;
+    info.name = mesh.name;
+    info.first = static_cast<uint32_t>(pimpl_->corners.size() / 3);
+    info.count = placed.triangleCount();
+    for (uint32_t index : placed.indices) {
+        if (index >= placed.vertices.size())
+            throw std::runtime_error(Utils::stringf("Mesh '%s' has a vertex index out of range", mesh.name.c_str()));
+        pimpl_->corners.push_back(placed.vertices[index]);
+    }
+    pimpl_->meshes.push_back(info);
+    pimpl_->built = false;
+    return static_cast<int>(pimpl_->meshes.size() - 1);
+}
+
+void StaticScene::clear()
+{
+    pimpl_->meshes.clear();
+    pimpl_->corners.clear();
+    pimpl_->nodes.clear();
+    pimpl_->triangles.clear();
+    pimpl_->built = false;
+}
+
+void StaticScene::build()
+{
+    pimpl_->build();
+}
+
+uint StaticScene::triangleCount() const
+{
+    return static_cast<uint>(pimpl_->corners.size() / 3);
+}
+
+int StaticScene::meshCount() const
+{
+    return static_cast<int>(pimpl_->meshes.size());
+}
+
+uint StaticScene::triangleCount(int mesh) const
+{
+    return pimpl_->meshes.at(mesh).count;
+}
+
+const std::string& StaticScene::getMeshName(int mesh) const
+{
+    return pimpl_->meshes.at(mesh).name;
+}
+
+void StaticScene::getTriangle(int mesh, uint triangle, Vector3r corners[3]) const
+{
+    const impl::MeshInfo& info = pimpl_->meshes.at(mesh);
+    if (triangle >= info.count)
+        throw std::out_of_range("Triangle index is out of range");
+    const Vector3r* corner = &pimpl_->corners[(info.first + triangle) * 3];
+    for (int i = 0; i < 3; ++i)
+        corners[i] = corner[i];
+}
+
+Vector3r StaticScene::getNormal(int mesh, uint triangle) const
+{
+    const impl::MeshInfo& info = pimpl_->meshes.at(mesh);
+    if (triangle >= info.count)
+        throw std::out_of_range("Triangle index is out of range");
+    const Vector3r* corner = &pimpl_->corners[(info.first + triangle) * 3];
+    return (corner[1] - corner[0]).cross(corner[2] - corner[0]).normalized();
+}
+
+StaticScene::Hit StaticScene::castRay(const Ray& ray) const
+{
+    if (!pimpl_->built)
+        throw std::runtime_error("StaticScene::build() must be called before casting rays");
+    return pimpl_->traceOne(ray);
+}
+
+void StaticScene::castRays(const vector<Ray>& rays, vector<Hit>& hits, uint thread_count) const
+{
+    if (!pimpl_->built)
+        throw std::runtime_error("StaticScene::build() must be called before casting rays");
+
+    hits.resize(rays.size());
+    if (rays.empty())
+        return;
+
+    size_t threads = thread_count;
+    if (threads == 0)
+        threads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), rays.size() / MinRaysPerThread);
+    //no point in a thread for less than a packet
+    threads = std::min(threads, (rays.size() + 3) / 4);
+    if (threads <= 1) {
+        pimpl_->traceRange(rays.data(), rays.size(), hits.data());
+        return;
+    }
+
+    //chunks are a multiple of the packet size, the calling thread takes the first one
+    size_t chunk = ((rays.size() + threads - 1) / threads + 3) / 4 * 4;
+    vector<std::thread> workers;
+    for (size_t start = chunk; start < rays.size(); start += chunk) {
+        size_t count = std::min(chunk, rays.size() - start);
+        workers.emplace_back([this, &rays, &hits, start, count]() {
+            pimpl_->traceRange(rays.data() + start, count, hits.data() + start);
+        });
+    }
+    pimpl_->traceRange(rays.data(), std::min(chunk, rays.size()), hits.data());
+    for (auto& worker : workers)
+        worker.join();
+}
+
+RayCastResponse StaticScene::rayCast(const RayCastRequest& request) const
+{
+    if (!pimpl_->built)
+        throw std::runtime_error("StaticScene::build() must be called before casting rays");
+
+    RayCastResponse response;
+    Ray ray(request.position, request.direction, 1);
+    float t_min = 0;
+    while (true) {
+        Hit hit = pimpl_->traceOne(ray, t_min);
+        if (!hit.isHit())
+            break;
+
+        RayCastHit result;
+        result.collided_actor_name = getMeshName(hit.mesh);
+        result.hit_point = request.position + request.direction * hit.distance;
+        Vector3r normal = getNormal(hit.mesh, hit.triangle);
+        //face the normal back towards the ray like the engine does
+        result.hit_normal = normal.dot(request.direction) > 0 ? Vector3r(-normal) : normal;
+        response.hits.push_back(result);
+
+        if (!request.through_blocking)
+            break;
+        //continue just past this hit so the same surface isn't found again
+        t_min = hit.distance + std::max(1e-6f, hit.distance * 1e-5f);
+    }
+    return response;
+}
+
+}} //namespace
+
+#endif
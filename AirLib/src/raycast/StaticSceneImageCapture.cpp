@@ -0,0 +1,746 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//in header only mode, control library is not available
+#ifndef AIRLIB_HEADER_ONLY
+
+#include "raycast/StaticSceneImageCapture.hpp"
+#include "camera/OpticalFlowGenerator.hpp"
+#include "common/ClockFactory.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <regex>
+#include <thread>
+
+namespace msr { namespace airlib {
+
+namespace {
+
+//colors of docs/seg_rgbs.txt, indexed by object ID
+const uint8_t SegmentationPalette[256][3] = {
+    { 55, 181, 57 }, { 153, 108, 6 }, { 112, 105, 191 }, { 89, 121, 72 }, { 190, 225, 64 }, { 206, 190, 59 }, { 81, 13, 36 }, { 115, 176, 195 },
+    { 161, 171, 27 }, { 135, 169, 180 }, { 29, 26, 199 }, { 102, 16, 239 }, { 242, 107, 146 }, { 156, 198, 23 }, { 49, 89, 160 }, { 68, 218, 116 },
+    { 11, 236, 9 }, { 196, 30, 8 }, { 121, 67, 28 }, { 0, 53, 65 }, { 146, 52, 70 }, { 226, 149, 143 }, { 151, 126, 171 }, { 194, 39, 7 },
+    { 205, 120, 161 }, { 212, 51, 60 }, { 211, 80, 208 }, { 189, 135, 188 }, { 54, 72, 205 }, { 103, 252, 157 }, { 124, 21, 123 }, { 19, 132, 69 },
+    { 195, 237, 132 }, { 94, 253, 175 }, { 182, 251, 87 }, { 90, 162, 242 }, { 199, 29, 1 }, { 254, 12, 229 }, { 35, 196, 244 }, { 220, 163, 49 },
+    { 86, 254, 214 }, { 152, 3, 129 }, { 92, 31, 106 }, { 207, 229, 90 }, { 125, 75, 48 }, { 98, 55, 74 }, { 126, 129, 238 }, { 222, 153, 109 },
+    { 85, 152, 34 }, { 173, 69, 31 }, { 37, 128, 125 }, { 58, 19, 33 }, { 134, 57, 119 }, { 218, 124, 115 }, { 120, 0, 200 }, { 225, 131, 92 },
+    { 246, 90, 16 }, { 51, 155, 241 }, { 202, 97, 155 }, { 184, 145, 182 }, { 96, 232, 44 }, { 133, 244, 133 }, { 180, 191, 29 }, { 1, 222, 192 },
+    { 99, 242, 104 }, { 91, 168, 219 }, { 65, 54, 217 }, { 148, 66, 130 }, { 203, 102, 204 }, { 216, 78, 75 }, { 234, 20, 250 }, { 109, 206, 24 },
+    { 164, 194, 17 }, { 157, 23, 236 }, { 158, 114, 88 }, { 245, 22, 110 }, { 67, 17, 35 }, { 181, 213, 93 }, { 170, 179, 42 }, { 52, 187, 148 },
+    { 247, 200, 111 }, { 25, 62, 174 }, { 100, 25, 240 }, { 191, 195, 144 }, { 252, 36, 67 }, { 241, 77, 149 }, { 237, 33, 141 }, { 119, 230, 85 },
+    { 28, 34, 108 }, { 78, 98, 254 }, { 114, 161, 30 }, { 75, 50, 243 }, { 66, 226, 253 }, { 46, 104, 76 }, { 8, 234, 216 }, { 15, 241, 102 },
+    { 93, 14, 71 }, { 192, 255, 193 }, { 253, 41, 164 }, { 24, 175, 120 }, { 185, 243, 231 }, { 169, 233, 97 }, { 243, 215, 145 }, { 72, 137, 21 },
+    { 160, 113, 101 }, { 214, 92, 13 }, { 167, 140, 147 }, { 101, 109, 181 }, { 53, 118, 126 }, { 3, 177, 32 }, { 40, 63, 99 }, { 186, 139, 153 },
+    { 88, 207, 100 }, { 71, 146, 227 }, { 236, 38, 187 }, { 215, 4, 215 }, { 18, 211, 66 }, { 113, 49, 134 }, { 47, 42, 63 }, { 219, 103, 127 },
+    { 57, 240, 137 }, { 227, 133, 211 }, { 145, 71, 201 }, { 217, 173, 183 }, { 250, 40, 113 }, { 208, 125, 68 }, { 224, 186, 249 }, { 69, 148, 46 },
+    { 239, 85, 20 }, { 108, 116, 224 }, { 56, 214, 26 }, { 179, 147, 43 }, { 48, 188, 172 }, { 221, 83, 47 }, { 155, 166, 218 }, { 62, 217, 189 },
+    { 198, 180, 122 }, { 201, 144, 169 }, { 132, 2, 14 }, { 128, 189, 114 }, { 163, 227, 112 }, { 45, 157, 177 }, { 64, 86, 142 }, { 118, 193, 163 },
+    { 14, 32, 79 }, { 200, 45, 170 }, { 74, 81, 2 }, { 59, 37, 212 }, { 73, 35, 225 }, { 95, 224, 39 }, { 84, 170, 220 }, { 159, 58, 173 },
+    { 17, 91, 237 }, { 31, 95, 84 }, { 34, 201, 248 }, { 63, 73, 209 }, { 129, 235, 107 }, { 231, 115, 40 }, { 36, 74, 95 }, { 238, 228, 154 },
+    { 61, 212, 54 }, { 13, 94, 165 }, { 141, 174, 0 }, { 140, 167, 255 }, { 117, 93, 91 }, { 183, 10, 186 }, { 165, 28, 61 }, { 144, 238, 194 },
+    { 12, 158, 41 }, { 76, 110, 234 }, { 150, 9, 121 }, { 142, 1, 246 }, { 230, 136, 198 }, { 5, 60, 233 }, { 232, 250, 80 }, { 143, 112, 56 },
+    { 187, 70, 156 }, { 2, 185, 62 }, { 138, 223, 226 }, { 122, 183, 222 }, { 166, 245, 3 }, { 175, 6, 140 }, { 240, 59, 210 }, { 248, 44, 10 },
+    { 83, 82, 52 }, { 223, 248, 167 }, { 87, 15, 150 }, { 111, 178, 117 }, { 197, 84, 22 }, { 235, 208, 124 }, { 9, 76, 45 }, { 176, 24, 50 },
+    { 154, 159, 251 }, { 149, 111, 207 }, { 168, 231, 15 }, { 209, 247, 202 }, { 80, 205, 152 }, { 178, 221, 213 }, { 27, 8, 38 }, { 244, 117, 51 },
+    { 107, 68, 190 }, { 23, 199, 139 }, { 171, 88, 168 }, { 136, 202, 58 }, { 6, 46, 86 }, { 105, 127, 176 }, { 174, 249, 197 }, { 172, 172, 138 },
+    { 228, 142, 81 }, { 7, 204, 185 }, { 22, 61, 247 }, { 233, 100, 78 }, { 127, 65, 105 }, { 33, 87, 158 }, { 139, 156, 252 }, { 42, 7, 136 },
+    { 20, 99, 179 }, { 79, 150, 223 }, { 131, 182, 184 }, { 110, 123, 37 }, { 60, 138, 96 }, { 210, 96, 94 }, { 123, 48, 18 }, { 137, 197, 162 },
+    { 188, 18, 5 }, { 39, 219, 151 }, { 204, 143, 135 }, { 249, 79, 73 }, { 77, 64, 178 }, { 41, 246, 77 }, { 16, 154, 4 }, { 116, 134, 19 },
+    { 4, 122, 235 }, { 177, 106, 230 }, { 21, 119, 12 }, { 104, 5, 98 }, { 50, 130, 53 }, { 30, 192, 25 }, { 26, 165, 166 }, { 10, 160, 82 },
+    { 106, 43, 131 }, { 44, 216, 103 }, { 255, 101, 221 }, { 32, 151, 196 }, { 213, 220, 89 }, { 70, 209, 228 }, { 97, 184, 83 }, { 82, 239, 232 },
+    { 251, 164, 128 }, { 193, 11, 245 }, { 38, 27, 159 }, { 229, 141, 203 }, { 130, 56, 55 }, { 147, 210, 11 }, { 162, 203, 118 }, { 43, 47, 206 },
+};
+
+constexpr int TileSize = 32;
+constexpr uint32_t NoTriangle = 0xffffffff;
+//DepthVis is white at this depth
+constexpr float DepthVisMax = 100.0f;
+
+//projection of one rendered image
+struct View {
+    int width, height;
+    bool orthographic;
+    double focal; //pixels per unit of y / x, or pixels per meter when orthographic
+    double cx, cy;
+    Pose pose; //camera in world NED
+
+    bool operator==(const View& other) const
+    {
+        return width == other.width && height == other.height && orthographic == other.orthographic
+            && focal == other.focal && pose.position == other.pose.position
+            && pose.orientation.coeffs() == other.pose.orientation.coeffs();
+    }
+};
+
+//part of a triangle in front of the camera, projected to pixel coordinates
+struct ScreenTriangle {
+    //edge function opposite to each corner is offset + step_x * x + step_y * y, positive inside
+    double offset[3], step_x[3], step_y[3];
+    //1 / depth, or -depth when orthographic, divided by twice the area so it interpolates with the edge functions
+    double key_scale[3];
+    bool owns_ties[3];
+    //triangle plane in camera frame, normal.dot(p) == offset
+    Vector3r plane_normal;
+    double plane_offset;
+    Vector3r normal; //world frame, facing the camera
+    uint32_t source; //triangle in the capture
+    int min_x, min_y, max_x, max_y; //pixels whose centers may be covered
+};
+
+//nearest triangle and its depth for each pixel of a view
+struct Frame {
+    View view;
+    vector<ScreenTriangle> triangles;
+    vector<uint32_t> visible; //index into triangles, NoTriangle for empty pixels
+    vector<float> planar_depth;
+};
+
+template <typename Func>
+void runOnThreads(uint thread_count, Func func)
+{
+    if (thread_count <= 1) {
+        func(0);
+        return;
+    }
+    vector<std::thread> threads;
+    for (uint i = 1; i < thread_count; ++i)
+        threads.emplace_back(func, i);
+    func(0);
+    for (auto& thread : threads)
+        thread.join();
+}
+
+//pixel centers exactly on an edge belong to only one of the two triangles that share it
+inline bool ownsTies(double ax, double ay, double bx, double by)
+{
+    return by < ay || (by == ay && bx > ax);
+}
+
+class PngWriter {
+public:
+    //writes an RGBA image as PNG with uncompressed deflate blocks, which every decoder reads
+    static vector<uint8_t> encode(const vector<uint8_t>& rgba, int width, int height)
+    {
+        vector<uint8_t> raw;
+        raw.reserve((width * 4 + 1) * height);
+        for (int y = 0; y < height; ++y) {
+            raw.push_back(0); //no filter
+            raw.insert(raw.end(), rgba.begin() + y * width * 4, rgba.begin() + (y + 1) * width * 4);
+        }
+
+        vector<uint8_t> zlib = { 0x78, 0x01 };
+        size_t offset = 0;
+        do {
+            size_t length = std::min<size_t>(65535, raw.size() - offset);
+            zlib.push_back(offset + length == raw.size() ? 1 : 0);
+            zlib.push_back(static_cast<uint8_t>(length));
+            zlib.push_back(static_cast<uint8_t>(length >> 8));
+            zlib.push_back(static_cast<uint8_t>(~length));
+            zlib.push_back(static_cast<uint8_t>(~length >> 8));
+            zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+            offset += length;
+        } while (offset < raw.size());
+        uint32_t a = 1, b = 0;
+        for (uint8_t byte : raw) {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+        appendBigEndian(zlib, (b << 16) | a);
+
+        vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+        vector<uint8_t> header;
+        appendBigEndian(header, static_cast<uint32_t>(width));
+        appendBigEndian(header, static_cast<uint32_t>(height));
+        header.insert(header.end(), { 8, 6, 0, 0, 0 }); //8 bit RGBA
+        appendChunk(png, "IHDR", header);
+        appendChunk(png, "IDAT", zlib);
+        appendChunk(png, "IEND", vector<uint8_t>());
+        return png;
+    }
+
+private:
+    static void appendBigEndian(vector<uint8_t>& out, uint32_t value)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+            out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+
+    static void appendChunk(vector<uint8_t>& png, const char* type, const vector<uint8_t>& data)
+    {
+        appendBigEndian(png, static_cast<uint32_t>(data.size()));
+        size_t start = png.size();
+        png.insert(png.end(), type, type + 4);
+        png.insert(png.end(), data.begin(), data.end());
+        uint32_t crc = 0xffffffff;
+        for (size_t i = start; i < png.size(); ++i) {
+            crc ^= png[i];
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+        }
+        appendBigEndian(png, ~crc);
+    }
+};
+
+} //namespace
+
+struct StaticSceneImageCapture::impl {
+    struct CameraInfo {
+        Pose relative_pose;
+        std::map<int, AirSimSettings::CaptureSetting> capture_settings;
+        AirSimSettings::OpticalFlowSetting optical_flow;
+    };
+
+    vector<Vector3r> corners; //three per triangle
+    vector<Vector3r> normals;
+    vector<int> triangle_meshes;
+    vector<std::string> mesh_names;
+
+    mutable std::mutex mutex; //guards everything below
+    std::map<std::string, CameraInfo> cameras;
+    Pose vehicle_pose;
+    vector<int> object_ids; //per mesh
+    uint thread_count = 0;
+    std::map<std::string, Pose> optical_flow_poses; //camera pose of the last OpticalFlow image of each camera
+
+    //the Unreal startup object ID: sum of the lower case letters plus 5, modulo 256
+    static int defaultObjectID(const std::string& mesh_name)
+    {
+        std::string name = Utils::toLower(mesh_name);
+        if (name.empty() || Utils::startsWith(name, "default_"))
+            return 0;
+        int hash = 5;
+        for (char c : name) {
+            if (static_cast<unsigned char>(c) >= 97)
+                hash += static_cast<unsigned char>(c);
+        }
+        return hash % 256;
+    }
+
+    static View makeView(const AirSimSettings::CaptureSetting& capture, const Pose& pose)
+    {
+        View view;
+        view.width = static_cast<int>(capture.width);
+        view.height = static_cast<int>(capture.height);
+        view.orthographic = capture.projection_mode == 1;
+        if (view.orthographic) {
+            double ortho_width = std::isnan(capture.ortho_width) ? 5.12 : capture.ortho_width;
+            view.focal = view.width / ortho_width;
+        }
+        else {
+            double fov = std::isnan(capture.fov_degrees) ? 90.0 : capture.fov_degrees;
+            view.focal = view.width / 2.0 / std::tan(Utils::degreesToRadians(fov) / 2);
+        }
+        view.cx = view.width / 2.0;
+        view.cy = view.height / 2.0;
+        view.pose = pose;
+        return view;
+    }
+
+    void project(const View& view, uint32_t source, const Vector3r camera_corners[3], vector<ScreenTriangle>& out) const
+    {
+        //clip against the near plane, which leaves at most four corners
+        Vector3r polygon[4];
+        int count = 0;
+        for (int i = 0; i < 3; ++i) {
+            const Vector3r& a = camera_corners[i];
+            const Vector3r& b = camera_corners[(i + 1) % 3];
+            bool a_in = a.x() >= NearPlane, b_in = b.x() >= NearPlane;
+            if (a_in)
+                polygon[count++] = a;
+            if (a_in != b_in) {
+                real_T t = (NearPlane - a.x()) / (b.x() - a.x());
+                polygon[count++] = a + (b - a) * t;
+            }
+        }
+        if (count < 3)
+            return;
+
+        ScreenTriangle triangle;
+        Vector3r plane_normal = (camera_corners[1] - camera_corners[0]).cross(camera_corners[2] - camera_corners[0]);
+        triangle.plane_normal = plane_normal;
+        triangle.plane_offset = plane_normal.cast<double>().dot(camera_corners[0].cast<double>());
+        //the camera is at the origin of its frame, so the normal faces it when the offset is negative
+        triangle.normal = plane_normal.dot(camera_corners[0]) > 0 ? -normals[source] : normals[source];
+        triangle.source = source;
+
+        double x[4], y[4], key[4];
+        for (int i = 0; i < count; ++i) {
+            const Vector3r& p = polygon[i];
+            if (view.orthographic) {
+                x[i] = view.cx + view.focal * p.y();
+                y[i] = view.cy + view.focal * p.z();
+                key[i] = -p.x();
+            }
+            else {
+                x[i] = view.cx + view.focal * p.y() / p.x();
+                y[i] = view.cy + view.focal * p.z() / p.x();
+                key[i] = 1.0 / p.x();
+            }
+        }
+
+        for (int fan = 1; fan + 1 < count; ++fan) {
+            int order[3] = { 0, fan, fan + 1 };
+            double area = (x[fan] - x[0]) * (y[fan + 1] - y[0]) - (y[fan] - y[0]) * (x[fan + 1] - x[0]);
+            if (area == 0 || !std::isfinite(area))
+                continue;
+            if (area < 0) {
+                std::swap(order[1], order[2]);
+                area = -area;
+            }
+            double min_x = 1e300, min_y = 1e300, max_x = -1e300, max_y = -1e300;
+            for (int i = 0; i < 3; ++i) {
+                double ax = x[order[(i + 1) % 3]], ay = y[order[(i + 1) % 3]];
+                double bx = x[order[(i + 2) % 3]], by = y[order[(i + 2) % 3]];
+                triangle.step_x[i] = ay - by;
+                triangle.step_y[i] = bx - ax;
+                triangle.offset[i] = (by - ay) * ax - (bx - ax) * ay;
+                triangle.owns_ties[i] = ownsTies(ax, ay, bx, by);
+                triangle.key_scale[i] = key[order[i]] / area;
+                min_x = std::min(min_x, x[order[i]]);
+                max_x = std::max(max_x, x[order[i]]);
+                min_y = std::min(min_y, y[order[i]]);
+                max_y = std::max(max_y, y[order[i]]);
+            }
+            //pixel centers are at +0.5
+            min_x = std::max(0.0, std::ceil(min_x - 0.5));
+            min_y = std::max(0.0, std::ceil(min_y - 0.5));
+            max_x = std::min(view.width - 1.0, std::floor(max_x - 0.5));
+            max_y = std::min(view.height - 1.0, std::floor(max_y - 0.5));
+            if (min_x > max_x || min_y > max_y)
+                continue;
+            triangle.min_x = static_cast<int>(min_x);
+            triangle.min_y = static_cast<int>(min_y);
+            triangle.max_x = static_cast<int>(max_x);
+            triangle.max_y = static_cast<int>(max_y);
+            out.push_back(triangle);
+        }
+    }
+
+    void rasterize(Frame& frame, const vector<uint32_t>& bin, int tile_x, int tile_y, vector<double>& keys) const
+    {
+        const View& view = frame.view;
+        int x0 = tile_x * TileSize, y0 = tile_y * TileSize;
+        int x1 = std::min(view.width, x0 + TileSize) - 1, y1 = std::min(view.height, y0 + TileSize) - 1;
+        std::fill(keys.begin(), keys.end(), -std::numeric_limits<double>::infinity());
+
+        for (uint32_t index : bin) {
+            const ScreenTriangle& t = frame.triangles[index];
+            int min_x = std::max(x0, t.min_x), max_x = std::min(x1, t.max_x);
+            int min_y = std::max(y0, t.min_y), max_y = std::min(y1, t.max_y);
+
+            for (int py = min_y; py <= max_y; ++py) {
+                double sy = py + 0.5;
+                double row[3];
+                //narrow the row to where the edges cross it, with a pixel of margin for the exact tests below
+                int span_min = min_x, span_max = max_x;
+                for (int i = 0; i < 3; ++i) {
+                    row[i] = t.offset[i] + t.step_y[i] * sy;
+                    if (t.step_x[i] == 0)
+                        continue;
+                    double crossing = -row[i] / t.step_x[i] - 0.5;
+                    if (t.step_x[i] > 0)
+                        span_min = std::max(span_min, static_cast<int>(std::max(-1e9, std::floor(crossing))));
+                    else
+                        span_max = std::min(span_max, static_cast<int>(std::min(1e9, std::ceil(crossing))));
+                }
+
+                double* nearest_row = &keys[(py - y0) * TileSize - x0];
+                uint32_t* visible_row = &frame.visible[py * view.width];
+                for (int px = span_min; px <= span_max; ++px) {
+                    double sx = px + 0.5;
+                    double e0 = row[0] + t.step_x[0] * sx, e1 = row[1] + t.step_x[1] * sx, e2 = row[2] + t.step_x[2] * sx;
+                    //branch free, since with overdraw the depth test is close to a coin flip
+                    bool inside = (e0 > 0 || (e0 == 0 && t.owns_ties[0])) & (e1 > 0 || (e1 == 0 && t.owns_ties[1]))
+                        & (e2 > 0 || (e2 == 0 && t.owns_ties[2]));
+                    double key = e0 * t.key_scale[0] + e1 * t.key_scale[1] + e2 * t.key_scale[2];
+                    bool nearer = inside & (key > nearest_row[px]);
+                    nearest_row[px] = nearer ? key : nearest_row[px];
+                    visible_row[px] = nearer ? index : visible_row[px];
+                }
+            }
+        }
+
+        //depth on the triangle plane along the ray through the pixel center
+        for (int py = y0; py <= y1; ++py) {
+            for (int px = x0; px <= x1; ++px) {
+                size_t pixel = py * view.width + px;
+                uint32_t index = frame.visible[pixel];
+                if (index == NoTriangle) {
+                    frame.planar_depth[pixel] = EmptyDepth;
+                    continue;
+                }
+                const ScreenTriangle& t = frame.triangles[index];
+                double u = (px + 0.5 - view.cx) / view.focal, v = (py + 0.5 - view.cy) / view.focal;
+                double nx = t.plane_normal.x(), ny = t.plane_normal.y(), nz = t.plane_normal.z();
+                double depth = view.orthographic ? (t.plane_offset - ny * u - nz * v) / nx
+                    : t.plane_offset / (nx + ny * u + nz * v);
+                //nearly edge on triangles fall back to the interpolated depth
+                if (!std::isfinite(depth) || depth < NearPlane) {
+                    double key = keys[(py - y0) * TileSize + px - x0];
+                    depth = view.orthographic ? -key : 1 / key;
+                }
+                frame.planar_depth[pixel] = static_cast<float>(depth);
+            }
+        }
+    }
+
+    void render(Frame& frame, uint worker_count) const
+    {
+        const View& view = frame.view;
+        if (worker_count == 0)
+            worker_count = std::max(1u, std::thread::hardware_concurrency());
+        uint32_t triangle_count = static_cast<uint32_t>(corners.size() / 3);
+
+        //clip and project on all threads, then keep the scene order so results do not depend on thread count
+        vector<vector<ScreenTriangle>> projected(worker_count);
+        Eigen::Matrix<real_T, 3, 3> to_camera = view.pose.orientation.toRotationMatrix().transpose();
+        runOnThreads(worker_count, [&](uint worker) {
+            uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(triangle_count) * worker / worker_count);
+            uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(triangle_count) * (worker + 1) / worker_count);
+            Vector3r camera_corners[3];
+            for (uint32_t i = begin; i < end; ++i) {
+                for (int c = 0; c < 3; ++c)
+                    camera_corners[c] = to_camera * (corners[i * 3 + c] - view.pose.position);
+                project(view, i, camera_corners, projected[worker]);
+            }
+        });
+        frame.triangles.clear();
+        for (const auto& part : projected)
+            frame.triangles.insert(frame.triangles.end(), part.begin(), part.end());
+
+        int tiles_x = (view.width + TileSize - 1) / TileSize, tiles_y = (view.height + TileSize - 1) / TileSize;
+        vector<vector<uint32_t>> bins(tiles_x * tiles_y);
+        for (uint32_t i = 0; i < frame.triangles.size(); ++i) {
+            const ScreenTriangle& t = frame.triangles[i];
+            for (int ty = t.min_y / TileSize; ty <= t.max_y / TileSize; ++ty)
+                for (int tx = t.min_x / TileSize; tx <= t.max_x / TileSize; ++tx)
+                    bins[ty * tiles_x + tx].push_back(i);
+        }
+
+        frame.visible.assign(view.width * view.height, NoTriangle);
+        frame.planar_depth.resize(view.width * view.height);
+        std::atomic<int> next_tile(0);
+        runOnThreads(std::min<uint>(worker_count, static_cast<uint>(bins.size())), [&](uint) {
+            vector<double> keys(TileSize * TileSize);
+            for (int tile = next_tile++; tile < static_cast<int>(bins.size()); tile = next_tile++)
+                rasterize(frame, bins[tile], tile % tiles_x, tile / tiles_x, keys);
+        });
+    }
+
+    static int objectID(const Frame& frame, size_t pixel, const vector<int>& mesh_object_ids, const vector<int>& triangle_meshes)
+    {
+        uint32_t index = frame.visible[pixel];
+        if (index == NoTriangle)
+            return 0;
+        int id = mesh_object_ids[triangle_meshes[frame.triangles[index].source]];
+        return id < 0 ? 0 : id;
+    }
+
+    //flow of the frame since previous_pose, like the Unreal capture computes it from DepthPlanner and Infrared
+    static void fillOpticalFlow(const Frame& frame, const AirSimSettings::OpticalFlowSetting& setting, const Pose& previous_pose,
+        const vector<int>& mesh_object_ids, const vector<int>& triangle_meshes, uint thread_count, ImageResponse& response)
+    {
+        const View& view = frame.view;
+        OpticalFlowGenerator generator(setting);
+        generator.setThreadCount(thread_count);
+
+        OpticalFlowGenerator::Frame flow_frame;
+        flow_frame.planar_depth = frame.planar_depth.data();
+        flow_frame.width = view.width;
+        flow_frame.height = view.height;
+        flow_frame.intrinsics = OpticalFlowGenerator::Intrinsics(static_cast<float>(view.focal), static_cast<float>(view.focal),
+            static_cast<float>(view.cx), static_cast<float>(view.cy));
+        flow_frame.pose = view.pose;
+        vector<uint8_t> ids;
+        if (generator.needsObjectIDs()) {
+            ids.resize(frame.planar_depth.size());
+            for (size_t pixel = 0; pixel < ids.size(); ++pixel)
+                ids[pixel] = static_cast<uint8_t>(objectID(frame, pixel, mesh_object_ids, triangle_meshes));
+            flow_frame.object_ids = ids.data();
+        }
+        generator.computeFlow(flow_frame, previous_pose, response.image_data_float);
+    }
+
+    static void fillResponse(const Frame& frame, const ImageRequest& request, const vector<int>& mesh_object_ids,
+        const vector<int>& triangle_meshes, ImageResponse& response)
+    {
+        const View& view = frame.view;
+        size_t pixels = view.width * view.height;
+        ImageType type = request.image_type;
+
+        //distance along the ray through the pixel center for each unit of planar depth
+        auto perspective_scale = [&view](size_t pixel) {
+            if (view.orthographic)
+                return 1.0f;
+            double u = (pixel % view.width + 0.5 - view.cx) / view.focal, v = (pixel / view.width + 0.5 - view.cy) / view.focal;
+            return static_cast<float>(std::sqrt(1 + u * u + v * v));
+        };
+        auto object_id = [&](size_t pixel) {
+            return objectID(frame, pixel, mesh_object_ids, triangle_meshes);
+        };
+
+        if (request.pixels_as_float) {
+            response.image_data_float.resize(type == ImageType::SurfaceNormals ? pixels * 3 : pixels);
+            for (size_t pixel = 0; pixel < pixels; ++pixel) {
+                float depth = frame.planar_depth[pixel];
+                bool empty = frame.visible[pixel] == NoTriangle;
+                float* out = &response.image_data_float[0];
+                switch (type) {
+                case ImageType::DepthPlanner:
+                    out[pixel] = depth;
+                    break;
+                case ImageType::DepthPerspective:
+                    out[pixel] = empty ? EmptyDepth : depth * perspective_scale(pixel);
+                    break;
+                case ImageType::DepthVis:
+                    out[pixel] = std::min(1.0f, depth / DepthVisMax);
+                    break;
+                case ImageType::Segmentation:
+                case ImageType::Infrared:
+                    out[pixel] = static_cast<float>(object_id(pixel));
+                    break;
+                case ImageType::SurfaceNormals: {
+                    Vector3r normal = empty ? Vector3r::Zero() : frame.triangles[frame.visible[pixel]].normal;
+                    for (int i = 0; i < 3; ++i)
+                        out[pixel * 3 + i] = normal[i];
+                    break;
+                }
+                default:
+                    break;
+                }
+            }
+            return;
+        }
+
+        vector<uint8_t> rgba(pixels * 4, 255);
+        for (size_t pixel = 0; pixel < pixels; ++pixel) {
+            uint8_t* out = &rgba[pixel * 4];
+            switch (type) {
+            case ImageType::DepthPlanner:
+            case ImageType::DepthPerspective:
+            case ImageType::DepthVis: {
+                float depth = frame.planar_depth[pixel];
+                if (type == ImageType::DepthPerspective && frame.visible[pixel] != NoTriangle)
+                    depth *= perspective_scale(pixel);
+                out[0] = out[1] = out[2] = static_cast<uint8_t>(std::round(std::min(1.0f, depth / DepthVisMax) * 255));
+                break;
+            }
+            case ImageType::Segmentation: {
+                const uint8_t* color = SegmentationPalette[object_id(pixel)];
+                out[0] = color[0];
+                out[1] = color[1];
+                out[2] = color[2];
+                break;
+            }
+            case ImageType::Infrared:
+                out[0] = out[1] = out[2] = static_cast<uint8_t>(object_id(pixel));
+                break;
+            case ImageType::SurfaceNormals: {
+                uint32_t index = frame.visible[pixel];
+                Vector3r normal = index == NoTriangle ? Vector3r::Zero() : frame.triangles[index].normal;
+                for (int i = 0; i < 3; ++i)
+                    out[i] = static_cast<uint8_t>(std::round((normal[i] + 1) / 2 * 255));
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        if (request.compress)
+            response.image_data_uint8 = PngWriter::encode(rgba, view.width, view.height);
+        else
+            response.image_data_uint8.swap(rgba);
+    }
+};
+
+StaticSceneImageCapture::StaticSceneImageCapture(std::shared_ptr<const StaticScene> scene)
+    : pimpl_(new impl())
+{
+    Vector3r corners[3];
+    for (int mesh = 0; mesh < scene->meshCount(); ++mesh) {
+        pimpl_->mesh_names.push_back(scene->getMeshName(mesh));
+        pimpl_->object_ids.push_back(impl::defaultObjectID(scene->getMeshName(mesh)));
+        for (uint triangle = 0; triangle < scene->triangleCount(mesh); ++triangle) {
+            scene->getTriangle(mesh, triangle, corners);
+            pimpl_->corners.insert(pimpl_->corners.end(), corners, corners + 3);
+            pimpl_->normals.push_back((corners[1] - corners[0]).cross(corners[2] - corners[0]).normalized());
+            pimpl_->triangle_meshes.push_back(mesh);
+        }
+    }
+}
+
+StaticSceneImageCapture::~StaticSceneImageCapture() = default;
+
+void StaticSceneImageCapture::addCamera(const std::string& camera_name, const AirSimSettings::CameraSetting& setting)
+{
+    impl::CameraInfo camera;
+    camera.capture_settings = setting.capture_settings;
+    if (!std::isnan(setting.position.x()))
+        camera.relative_pose.position = setting.position;
+    AirSimSettings::Rotation rotation = setting.rotation;
+    if (!std::isnan(rotation.yaw))
+        camera.relative_pose.orientation = VectorMath::toQuaternion(Utils::degreesToRadians(rotation.pitch),
+            Utils::degreesToRadians(rotation.roll), Utils::degreesToRadians(rotation.yaw));
+
+    camera.optical_flow = setting.optical_flow;
+
+    std::lock_guard<std::mutex> lock(pimpl_->mutex);
+    pimpl_->cameras[camera_name] = camera;
+    pimpl_->optical_flow_poses.erase(camera_name);
+}
+
+void StaticSceneImageCapture::setCameraPose(const std::string& camera_name, const Pose& relative_pose)
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex);
+    auto camera = pimpl_->cameras.find(camera_name);
+    if (camera == pimpl_->cameras.end())
+        throw std::invalid_argument(Utils::stringf("Camera '%s' was not added", camera_name.c_str()));
+    camera->second.relative_pose = relative_pose;
+}
+
+void StaticSceneImageCapture::setVehiclePose(const Pose& pose)
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex);
+    pimpl_->vehicle_pose = pose;
+}
+
+bool StaticSceneImageCapture::setSegmentationObjectID(const std::string& mesh_name, int object_id, bool is_name_regex)
+{
+    std::regex name_regex;
+    if (is_name_regex)
+        name_regex.assign(mesh_name, std::regex_constants::icase);
+
+    std::lock_guard<std::mutex> lock(pimpl_->mutex);
+    bool changed = false;
+    for (size_t mesh = 0; mesh < pimpl_->mesh_names.size(); ++mesh) {
+        const std::string& name = pimpl_->mesh_names[mesh];
+        if (is_name_regex ? std::regex_match(name, name_regex) : name == mesh_name) {
+            pimpl_->object_ids[mesh] = object_id;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+int StaticSceneImageCapture::getSegmentationObjectID(const std::string& mesh_name) const
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex);
+    for (size_t mesh = 0; mesh < pimpl_->mesh_names.size(); ++mesh) {
+        if (pimpl_->mesh_names[mesh] == mesh_name)
+            return pimpl_->object_ids[mesh];
+    }
+    return -1;
+}
+
+void StaticSceneImageCapture::setThreadCount(uint thread_count)
+{
+    std::lock_guard<std::mutex> lock(pimpl_->mutex);
+    pimpl_->thread_count = thread_count;
+}
+
+void StaticSceneImageCapture::getImages(const std::vector<ImageRequest>& requests, std::vector<ImageResponse>& responses) const
+{
+    std::map<std::string, impl::CameraInfo> cameras;
+    Pose vehicle_pose;
+    vector<int> object_ids;
+    uint thread_count;
+    std::map<std::string, Pose> optical_flow_poses;
+    {
+        std::lock_guard<std::mutex> lock(pimpl_->mutex);
+        thread_count = pimpl_->thread_count;
+        cameras = pimpl_->cameras;
+        vehicle_pose = pimpl_->vehicle_pose;
+        object_ids = pimpl_->object_ids;
+        optical_flow_poses = pimpl_->optical_flow_poses;
+    }
+    //flow of every request in this call is since the previous call
+    std::map<std::string, Pose> new_optical_flow_poses;
+    TTimePoint time_stamp = ClockFactory::get()->nowNanos();
+
+    //requests for the same camera and projection share one render
+    vector<std::unique_ptr<Frame>> frames;
+    for (const ImageRequest& request : requests) {
+        responses.push_back(ImageResponse());
+        ImageResponse& response = responses.back();
+        response.camera_name = request.camera_name;
+        response.time_stamp = time_stamp;
+        response.pixels_as_float = request.pixels_as_float;
+        response.compress = request.compress;
+        response.image_type = request.image_type;
+
+        auto camera = cameras.find(request.camera_name);
+        if (camera == cameras.end()) {
+            response.message = "camera " + request.camera_name + " was not found";
+            continue;
+        }
+        switch (request.image_type) {
+        case ImageType::DepthPlanner:
+        case ImageType::DepthPerspective:
+        case ImageType::DepthVis:
+        case ImageType::Segmentation:
+        case ImageType::SurfaceNormals:
+        case ImageType::Infrared:
+            break;
+        case ImageType::OpticalFlow:
+            if (!request.pixels_as_float) {
+                response.message = "OpticalFlow images are only available with pixels_as_float";
+                continue;
+            }
+            break;
+        default:
+            response.message = "image type is not rendered by StaticSceneImageCapture";
+            continue;
+        }
+        //flow is computed from the DepthPlanner render
+        ImageType capture_type = request.image_type == ImageType::OpticalFlow ? ImageType::DepthPlanner : request.image_type;
+        auto capture = camera->second.capture_settings.find(static_cast<int>(capture_type));
+        if (capture == camera->second.capture_settings.end() || capture->second.width == 0 || capture->second.height == 0) {
+            response.message = "camera has no capture setting for this image type";
+            continue;
+        }
+
+        Pose camera_pose = camera->second.relative_pose + vehicle_pose;
+        View view = impl::makeView(capture->second, camera_pose);
+        const Frame* frame = nullptr;
+        for (const auto& rendered : frames) {
+            if (rendered->view == view)
+                frame = rendered.get();
+        }
+        if (frame == nullptr) {
+            frames.push_back(std::unique_ptr<Frame>(new Frame()));
+            frames.back()->view = view;
+            pimpl_->render(*frames.back(), thread_count);
+            frame = frames.back().get();
+        }
+
+        response.camera_position = camera_pose.position;
+        response.camera_orientation = camera_pose.orientation;
+        response.width = view.width;
+        response.height = view.height;
+        if (request.image_type != ImageType::OpticalFlow) {
+            impl::fillResponse(*frame, request, object_ids, pimpl_->triangle_meshes, response);
+            continue;
+        }
+
+        if (view.orthographic) {
+            response.message = "OpticalFlow images are not available for orthographic cameras";
+            continue;
+        }
+        auto previous = optical_flow_poses.find(request.camera_name);
+        impl::fillOpticalFlow(*frame, camera->second.optical_flow, previous == optical_flow_poses.end() ? camera_pose : previous->second,
+            object_ids, pimpl_->triangle_meshes, thread_count, response);
+        new_optical_flow_poses[request.camera_name] = camera_pose;
+    }
+
+    if (!new_optical_flow_poses.empty()) {
+        std::lock_guard<std::mutex> lock(pimpl_->mutex);
+        for (const auto& pose : new_optical_flow_poses)
+            pimpl_->optical_flow_poses[pose.first] = pose.second;
+    }
+}
+
+}} //namespace
+#endif
@@ -0,0 +1,477 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//in header only mode, control library is not available
+#ifndef AIRLIB_HEADER_ONLY
+
+#include "raycast/TriangleMesh.hpp"
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cctype>
+#include <map>
+#include <functional>
+
+namespace msr { namespace airlib {
+
+namespace {
+
+std::string readFile(const std::string& file_path)
+{
+    std::ifstream file(file_path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error(Utils::stringf("Cannot open mesh file '%s'", file_path.c_str()));
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+std::string lowerExtension(const std::string& file_path)
+{
+    size_t dot = file_path.find_last_of('.');
+    size_t slash = file_path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return "";
+    std::string ext = file_path.substr(dot);
+    for (char& c : ext)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return ext;
+}
+
+std::string parentFolder(const std::string& file_path)
+{
+    size_t slash = file_path.find_last_of("/\\");
+    return slash == std::string::npos ? "." : file_path.substr(0, slash);
+}
+
+std::string joinPath(const std::string& folder, const std::string& child)
+{
+    if (folder.empty() || child.empty() || child[0] == '/' || child[0] == '\\' || (child.size() > 1 && child[1] == ':'))
+        return folder.empty() ? child : (child.empty() ? folder : child);
+    char last = folder[folder.size() - 1];
+    return (last == '/' || last == '\\') ? folder + child : folder + "/" + child;
+}
+
+Vector3r parseVector(const std::string& text, const Vector3r& default_val)
+{
+    if (text.empty())
+        return default_val;
+    std::istringstream stream(text);
+    Vector3r v;
+    if (!(stream >> v.x() >> v.y() >> v.z()))
+        throw std::runtime_error(Utils::stringf("Expected three numbers but got '%s'", text.c_str()));
+    return v;
+}
+
+//just enough XML for URDF: elements, attributes and nesting. Text, comments and declarations are skipped.
+struct XmlElement {
+    std::string name;
+    std::map<std::string, std::string> attributes;
+    vector<XmlElement> children;
+
+    std::string attribute(const std::string& key) const
+    {
+        auto found = attributes.find(key);
+        return found == attributes.end() ? "" : found->second;
+    }
+    const XmlElement* child(const std::string& child_name) const
+    {
+        for (const auto& c : children)
+            if (c.name == child_name)
+                return &c;
+        return nullptr;
+    }
+};
+
+class XmlReader {
+public:
+    XmlReader(const std::string& text)
+        : text_(text)
+    {
+    }
+
+    XmlElement readDocument()
+    {
+        XmlElement document;
+        vector<XmlElement*> open { &document };
+        while (pos_ < text_.size()) {
+            size_t lt = text_.find('<', pos_);
+            if (lt == std::string::npos)
+                break;
+            pos_ = lt + 1;
+            if (startsWith("!--")) {
+                skipPast("-->");
+            }
+            else if (startsWith("?") || startsWith("!")) {
+                skipPast(">");
+            }
+            else if (startsWith("/")) {
+                ++pos_;
+                std::string name = readName();
+                if (open.size() < 2 || open.back()->name != name)
+                    throw std::runtime_error(Utils::stringf("Unexpected closing tag </%s> in URDF", name.c_str()));
+                open.pop_back();
+                skipPast(">");
+            }
+            else {
+                XmlElement element;
+                element.name = readName();
+                bool self_closing = readAttributes(element);
+                open.back()->children.push_back(element);
+                if (!self_closing)
+                    open.push_back(&open.back()->children.back());
+            }
+        }
+        if (open.size() != 1)
+            throw std::runtime_error(Utils::stringf("Element <%s> is not closed in URDF", open.back()->name.c_str()));
+        return document;
+    }
+
+private:
+    bool startsWith(const char* prefix) const
+    {
+        return text_.compare(pos_, std::strlen(prefix), prefix) == 0;
+    }
+    void skipPast(const char* marker)
+    {
+        size_t found = text_.find(marker, pos_);
+        if (found == std::string::npos)
+            throw std::runtime_error("Unterminated markup in URDF");
+        pos_ = found + std::strlen(marker);
+    }
+    void skipSpace()
+    {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_])))
+            ++pos_;
+    }
+    std::string readName()
+    {
+        size_t start = pos_;
+        while (pos_ < text_.size() && !std::isspace(static_cast<unsigned char>(text_[pos_])) &&
+            text_[pos_] != '>' && text_[pos_] != '/' && text_[pos_] != '=')
+            ++pos_;
+        return text_.substr(start, pos_ - start);
+    }
+    //returns true if the element ends with />
+    bool readAttributes(XmlElement& element)
+    {
+        while (true) {
+            skipSpace();
+            if (pos_ >= text_.size())
+                throw std::runtime_error("Unterminated element in URDF");
+            if (text_[pos_] == '>') {
+                ++pos_;
+                return false;
+            }
+            if (startsWith("/>")) {
+                pos_ += 2;
+                return true;
+            }
+            std::string key = readName();
+            skipSpace();
+            if (pos_ >= text_.size() || text_[pos_] != '=')
+                throw std::runtime_error(Utils::stringf("Attribute '%s' has no value in URDF", key.c_str()));
+            ++pos_;
+            skipSpace();
+            char quote = pos_ < text_.size() ? text_[pos_] : 0;
+            if (quote != '"' && quote != '\'')
+                throw std::runtime_error(Utils::stringf("Attribute '%s' is not quoted in URDF", key.c_str()));
+            size_t end = text_.find(quote, pos_ + 1);
+            if (end == std::string::npos)
+                throw std::runtime_error("Unterminated attribute in URDF");
+            element.attributes[key] = text_.substr(pos_ + 1, end - pos_ - 1);
+            pos_ = end + 1;
+        }
+    }
+
+    const std::string& text_;
+    size_t pos_ = 0;
+};
+
+//URDF origin element, roll pitch yaw are about fixed x, y and z axes
+Pose parseOrigin(const XmlElement* origin)
+{
+    if (origin == nullptr)
+        return Pose();
+    Vector3r xyz = parseVector(origin->attribute("xyz"), Vector3r::Zero());
+    Vector3r rpy = parseVector(origin->attribute("rpy"), Vector3r::Zero());
+    return Pose(xyz, VectorMath::toQuaternion(rpy.y(), rpy.x(), rpy.z()));
+}
+
+std::string resolveMeshPath(const std::string& uri, const std::string& urdf_folder, const std::string& package_root)
+{
+    const std::string package_prefix = "package://";
+    const std::string file_prefix = "file://";
+    if (uri.compare(0, package_prefix.size(), package_prefix) == 0)
+        return joinPath(package_root.empty() ? urdf_folder : package_root, uri.substr(package_prefix.size()));
+    if (uri.compare(0, file_prefix.size(), file_prefix) == 0)
+        return uri.substr(file_prefix.size());
+    return joinPath(urdf_folder, uri);
+}
+
+} //anonymous namespace
+
+void TriangleMesh::append(const TriangleMesh& other, const Pose& pose, const Vector3r& scale)
+{
+    uint32_t base = static_cast<uint32_t>(vertices.size());
+    vertices.reserve(vertices.size() + other.vertices.size());
+    for (const auto& v : other.vertices)
+        vertices.push_back(VectorMath::transformToWorldFrame(Vector3r(v.cwiseProduct(scale)), pose));
+
+    //a mirroring scale turns the triangles inside out, swap two corners to keep the winding
+    bool mirrored = scale.x() * scale.y() * scale.z() < 0;
+    indices.reserve(indices.size() + other.indices.size());
+    for (size_t i = 0; i + 2 < other.indices.size(); i += 3) {
+        indices.push_back(base + other.indices[i]);
+        indices.push_back(base + other.indices[mirrored ? i + 2 : i + 1]);
+        indices.push_back(base + other.indices[mirrored ? i + 1 : i + 2]);
+    }
+}
+
+void TriangleMesh::flipYZ()
+{
+    //180 degree turn about x so the winding stays the same
+    for (auto& v : vertices) {
+        v.y() = -v.y();
+        v.z() = -v.z();
+    }
+}
+
+TriangleMesh TriangleMesh::loadObj(const std::string& file_path)
+{
+    std::istringstream stream(readFile(file_path));
+    TriangleMesh mesh;
+    mesh.name = file_path;
+
+    std::string line;
+    vector<uint32_t> face;
+    uint line_number = 0;
+    while (std::getline(stream, line)) {
+        ++line_number;
+        std::istringstream tokens(line);
+        std::string tag;
+        if (!(tokens >> tag))
+            continue;
+        if (tag == "v") {
+            Vector3r v;
+            if (!(tokens >> v.x() >> v.y() >> v.z()))
+                throw std::runtime_error(Utils::stringf("Bad vertex at line %u of '%s'", line_number, file_path.c_str()));
+            mesh.vertices.push_back(v);
+        }
+        else if (tag == "f") {
+            //f v, f v/vt, f v//vn or f v/vt/vn, indices start at 1 and negative ones count back from the last vertex
+            face.clear();
+            std::string corner;
+            while (tokens >> corner) {
+                long index = std::strtol(corner.c_str(), nullptr, 10);
+                const size_t count = mesh.vertices.size();
+                const size_t magnitude = index < 0 ? 0 - static_cast<size_t>(index) : static_cast<size_t>(index);
+                if (index == 0 || magnitude > count)
+                    throw std::runtime_error(Utils::stringf("Bad face index at line %u of '%s'", line_number, file_path.c_str()));
+                face.push_back(static_cast<uint32_t>(index < 0 ? count - magnitude : magnitude - 1));
+            }
+            //polygons are split into a fan
+            for (size_t i = 2; i < face.size(); ++i) {
+                mesh.indices.push_back(face[0]);
+                mesh.indices.push_back(face[i - 1]);
+                mesh.indices.push_back(face[i]);
+            }
+        }
+    }
+    return mesh;
+}
+
+TriangleMesh TriangleMesh::loadStl(const std::string& file_path)
+{
+    std::string data = readFile(file_path);
+    TriangleMesh mesh;
+    mesh.name = file_path;
+
+    //binary files have an 80 byte header, a triangle count and 50 bytes per triangle.
+    //Some binary files start with "solid" too, so the size decides.
+    if (data.size() >= 84) {
+        uint32_t count;
+        std::memcpy(&count, data.data() + 80, sizeof(count));
+        if (data.size() == 84 + static_cast<size_t>(count) * 50) {
+            mesh.vertices.reserve(count * 3);
+            mesh.indices.reserve(count * 3);
+            const char* record = data.data() + 84;
+            for (uint32_t t = 0; t < count; ++t, record += 50) {
+                for (int corner = 0; corner < 3; ++corner) {
+                    float xyz[3];
+                    std::memcpy(xyz, record + 12 + corner * 12, sizeof(xyz));
+                    mesh.indices.push_back(static_cast<uint32_t>(mesh.vertices.size()));
+                    mesh.vertices.push_back(Vector3r(xyz[0], xyz[1], xyz[2]));
+                }
+            }
+            return mesh;
+        }
+    }
+
+    std::istringstream stream(data);
+    std::string token;
+    if (!(stream >> token) || token != "solid")
+        throw std::runtime_error(Utils::stringf("'%s' is neither a binary nor an ASCII STL file", file_path.c_str()));
+    while (stream >> token) {
+        if (token == "vertex") {
+            Vector3r v;
+            if (!(stream >> v.x() >> v.y() >> v.z()))
+                throw std::runtime_error(Utils::stringf("Bad vertex in '%s'", file_path.c_str()));
+            mesh.indices.push_back(static_cast<uint32_t>(mesh.vertices.size()));
+            mesh.vertices.push_back(v);
+        }
+    }
+    if (mesh.indices.size() % 3 != 0)
+        throw std::runtime_error(Utils::stringf("Incomplete facet in '%s'", file_path.c_str()));
+    return mesh;
+}
+
+TriangleMesh TriangleMesh::loadFile(const std::string& file_path)
+{
+    std::string ext = lowerExtension(file_path);
+    if (ext == ".obj")
+        return loadObj(file_path);
+    if (ext == ".stl")
+        return loadStl(file_path);
+    throw std::runtime_error(Utils::stringf("Mesh format of '%s' is not supported, use OBJ or STL", file_path.c_str()));
+}
+
+vector<TriangleMesh> TriangleMesh::loadUrdfCollision(const std::string& file_path, const std::string& package_root)
+{
+    std::string text = readFile(file_path);
+    XmlElement document = XmlReader(text).readDocument();
+    const XmlElement* robot = document.child("robot");
+    if (robot == nullptr)
+        throw std::runtime_error(Utils::stringf("'%s' has no <robot> element", file_path.c_str()));
+
+    //pose of every link with all joints at zero, found by walking down from the links that are nobody's child
+    std::map<std::string, std::pair<std::string, Pose>> parent_of;
+    for (const auto& joint : robot->children) {
+        if (joint.name != "joint")
+            continue;
+        const XmlElement* parent = joint.child("parent");
+        const XmlElement* child = joint.child("child");
+        if (parent == nullptr || child == nullptr)
+            throw std::runtime_error(Utils::stringf("Joint '%s' needs a parent and a child", joint.attribute("name").c_str()));
+        parent_of[child->attribute("link")] = std::make_pair(parent->attribute("link"), parseOrigin(joint.child("origin")));
+    }
+    std::map<std::string, Pose> link_poses;
+    std::function<Pose(const std::string&, uint)> linkPose = [&](const std::string& link, uint depth) -> Pose {
+        auto known = link_poses.find(link);
+        if (known != link_poses.end())
+            return known->second;
+        if (depth > parent_of.size())
+            throw std::runtime_error(Utils::stringf("Joints form a loop at link '%s'", link.c_str()));
+        Pose pose;
+        auto parent = parent_of.find(link);
+        if (parent != parent_of.end())
+            pose = VectorMath::transformToWorldFrame(parent->second.second, linkPose(parent->second.first, depth + 1));
+        link_poses[link] = pose;
+        return pose;
+    };
+
+    std::string urdf_folder = parentFolder(file_path);
+    std::map<std::string, TriangleMesh> loaded;
+    vector<TriangleMesh> meshes;
+    for (const auto& link : robot->children) {
+        if (link.name != "link")
+            continue;
+        TriangleMesh link_mesh;
+        link_mesh.name = link.attribute("name");
+        Pose link_pose = linkPose(link_mesh.name, 0);
+        for (const auto& collision : link.children) {
+            if (collision.name != "collision")
+                continue;
+            const XmlElement* geometry = collision.child("geometry");
+            if (geometry == nullptr || geometry->children.empty())
+                continue;
+            const XmlElement& shape = geometry->children.front();
+            Pose pose = VectorMath::transformToWorldFrame(parseOrigin(collision.child("origin")), link_pose);
+            if (shape.name == "mesh") {
+                std::string path = resolveMeshPath(shape.attribute("filename"), urdf_folder, package_root);
+                auto cached = loaded.find(path);
+                if (cached == loaded.end())
+                    cached = loaded.insert(std::make_pair(path, loadFile(path))).first;
+                link_mesh.append(cached->second, pose, parseVector(shape.attribute("scale"), Vector3r::Ones()));
+            }
+            else if (shape.name == "box")
+                link_mesh.append(box(parseVector(shape.attribute("size"), Vector3r::Ones())), pose);
+            else if (shape.name == "cylinder")
+                link_mesh.append(cylinder(std::stof(shape.attribute("radius")), std::stof(shape.attribute("length"))), pose);
+            else if (shape.name == "sphere")
+                link_mesh.append(sphere(std::stof(shape.attribute("radius"))), pose);
+            else
+                throw std::runtime_error(Utils::stringf("Unknown collision geometry <%s> in link '%s'", shape.name.c_str(), link_mesh.name.c_str()));
+        }
+        if (link_mesh.triangleCount() > 0)
+            meshes.push_back(std::move(link_mesh));
+    }
+    return meshes;
+}
+
+TriangleMesh TriangleMesh::box(const Vector3r& size)
+{
+    TriangleMesh mesh;
+    mesh.name = "box";
+    Vector3r half = size / 2;
+    for (int i = 0; i < 8; ++i)
+        mesh.vertices.push_back(Vector3r(i & 1 ? half.x() : -half.x(), i & 2 ? half.y() : -half.y(), i & 4 ? half.z() : -half.z()));
+    //two triangles per face, wound counter clockwise seen from outside
+    static const uint32_t faces[36] = {
+        0, 2, 1, 1, 2, 3,  4, 5, 6, 5, 7, 6,
+        0, 1, 4, 1, 5, 4,  2, 6, 3, 3, 6, 7,
+        0, 4, 2, 2, 4, 6,  1, 3, 5, 3, 7, 5
+    };
+    mesh.indices.assign(faces, faces + 36);
+    return mesh;
+}
+
+TriangleMesh TriangleMesh::cylinder(real_T radius, real_T length, uint segments)
+{
+    TriangleMesh mesh;
+    mesh.name = "cylinder";
+    real_T half = length / 2;
+    for (uint i = 0; i < segments; ++i) {
+        real_T angle = 2 * M_PIf * i / segments;
+        mesh.vertices.push_back(Vector3r(radius * std::cos(angle), radius * std::sin(angle), -half));
+        mesh.vertices.push_back(Vector3r(radius * std::cos(angle), radius * std::sin(angle), half));
+    }
+    uint32_t bottom = static_cast<uint32_t>(mesh.vertices.size());
+    mesh.vertices.push_back(Vector3r(0, 0, -half));
+    mesh.vertices.push_back(Vector3r(0, 0, half));
+    for (uint i = 0; i < segments; ++i) {
+        uint32_t a = 2 * i, b = 2 * ((i + 1) % segments);
+        uint32_t side[12] = { a, b, a + 1,  b, b + 1, a + 1,  bottom, b, a,  bottom + 1, a + 1, b + 1 };
+        mesh.indices.insert(mesh.indices.end(), side, side + 12);
+    }
+    return mesh;
+}
+
+TriangleMesh TriangleMesh::sphere(real_T radius, uint segments)
+{
+    TriangleMesh mesh;
+    mesh.name = "sphere";
+    uint rings = segments / 2;
+    for (uint r = 0; r <= rings; ++r) {
+        real_T polar = M_PIf * r / rings;
+        //sin of the float pi is slightly negative, which would mirror the triangles at the bottom pole
+        real_T ring_radius = std::max(0.0f, std::sin(polar));
+        for (uint s = 0; s < segments; ++s) {
+            real_T azimuth = 2 * M_PIf * s / segments;
+            mesh.vertices.push_back(radius * Vector3r(ring_radius * std::cos(azimuth), ring_radius * std::sin(azimuth), std::cos(polar)));
+        }
+    }
+    for (uint r = 0; r < rings; ++r) {
+        for (uint s = 0; s < segments; ++s) {
+            uint32_t a = r * segments + s, b = r * segments + (s + 1) % segments;
+            uint32_t c = a + segments, d = b + segments;
+            uint32_t quad[6] = { a, c, b,  b, c, d };
+            mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+        }
+    }
+    return mesh;
+}
+
+}} //namespace
+
+#endif
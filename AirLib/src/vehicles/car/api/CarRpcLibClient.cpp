@@ -60,6 +60,15 @@ void CarRpcLibClient::setCarControls(const CarApiBase::CarControls& controls, co
         call("setCarControls", CarRpcLibAdapators::CarControls(controls), vehicle_name);
 }
 
+void CarRpcLibClient::setCarControlSchedule(const vector<TTimePoint>& times, const vector<CarApiBase::CarControls>& controls,
+    CarApiBase::CarControlSchedule::Interpolation interpolation, float horizon, const std::string& vehicle_name)
+{
+    vector<CarRpcLibAdapators::CarControls> packed;
+    CarRpcLibAdapators::from(controls, packed);
+    static_cast<rpc::client*>(getClient())->
+        call("setCarControlSchedule", times, packed, static_cast<int>(interpolation), horizon, vehicle_name);
+}
+
 CarApiBase::CarState CarRpcLibClient::getCarState(const std::string& vehicle_name)
 {
     return static_cast<rpc::client*>(getClient())->
@@ -30,6 +30,7 @@ STRICT_MODE_OFF
 #include "common/common_utils/WindowsApisCommonPost.hpp"
 
 #include "vehicles/car/api/CarRpcLibAdapators.hpp"
+#include "api/RpcLibServerCore.hpp"
 
 
 STRICT_MODE_ON
@@ -42,16 +43,27 @@ typedef msr::airlib_rpclib::CarRpcLibAdapators CarRpcLibAdapators;
 CarRpcLibServer::CarRpcLibServer(ApiProvider* api_provider, string server_address, uint16_t port)
     : RpcLibServerBase(api_provider, server_address, port)
 {
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("getCarState", [&](const std::string& vehicle_name) -> CarRpcLibAdapators::CarState {
         return CarRpcLibAdapators::CarState(getVehicleApi(vehicle_name)->getCarState());
     });
 
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("setCarControls", [&](const CarRpcLibAdapators::CarControls& controls, const std::string& vehicle_name) -> void {
+        //direct controls take over from any uploaded schedule
+        getVehicleApi(vehicle_name)->clearCarControlSchedule();
         getVehicleApi(vehicle_name)->setCarControls(controls.to());
     });
 
+    (static_cast<RpcLibServerCore*>(getServer()))->
+        bind("setCarControlSchedule", [&](const std::vector<TTimePoint>& times, const std::vector<CarRpcLibAdapators::CarControls>& controls,
+            int interpolation, float horizon, const std::string& vehicle_name) -> void {
+        std::vector<CarApiBase::CarControls> setpoints;
+        CarRpcLibAdapators::to(controls, setpoints);
+        getVehicleApi(vehicle_name)->setCarControlSchedule(times, setpoints,
+            static_cast<CarApiBase::CarControlSchedule::Interpolation>(interpolation), horizon);
+    });
+
 }
 
 //required for pimpl
@@ -18,9 +18,88 @@ void MultirotorApiBase::reset()
     cancelLastTask();
     SingleTaskCall lock(this); //cancel previous tasks
 
+    control_schedule_.reset();
     VehicleApiBase::reset();
 }
 
+void MultirotorApiBase::update()
+{
+    VehicleApiBase::update();
+
+    MultirotorSetpoint setpoint;
+    try {
+        switch (control_schedule_.step(clock()->nowNanos(), setpoint)) {
+        case MultirotorControlSchedule::StepResult::Setpoint:
+            applySetpoint(setpoint);
+            break;
+        case MultirotorControlSchedule::StepResult::Expired:
+            moveByVelocityZInternal(0, 0, getPosition().z(), YawMode::Zero());
+            break;
+        default:
+            break;
+        }
+    }
+    catch (const VehicleMoveException& ex) {
+        //update runs on the physics thread, so a rejected setpoint ends the schedule instead of propagating
+        control_schedule_.clear();
+        Utils::log(Utils::stringf("Control schedule stopped: %s", ex.what()), Utils::kLogLevelError);
+    }
+}
+
+void MultirotorApiBase::moveByControlSchedule(const vector<TTimePoint>& times, const vector<MultirotorSetpoint>& setpoints,
+    ScheduledCommand command, bool yaw_is_rate, MultirotorControlSchedule::Interpolation interpolation, double horizon)
+{
+    switch (command) {
+    case ScheduledCommand::Velocity:
+    case ScheduledCommand::VelocityZ:
+    case ScheduledCommand::RollPitchZ:
+    case ScheduledCommand::RollPitchThrottle:
+        break;
+    default:
+        throw std::invalid_argument("Unknown scheduled command");
+    }
+
+    vector<MultirotorSetpoint> stamped = setpoints;
+    for (auto& setpoint : stamped) {
+        setpoint.command = command;
+        setpoint.yaw_is_rate = yaw_is_rate;
+    }
+
+    //a running task stops at its next check; taking its lock would clear the schedule this upload extends
+    cancelLastTask();
+    control_schedule_.upload(times, stamped, interpolation, horizon);
+}
+
+MultirotorSetpoint MultirotorApiBase::interpolateSetpoints(const MultirotorSetpoint& from, const MultirotorSetpoint& to, real_T alpha)
+{
+    MultirotorSetpoint setpoint = from;
+    setpoint.x = from.x + alpha * (to.x - from.x);
+    setpoint.y = from.y + alpha * (to.y - from.y);
+    setpoint.z = from.z + alpha * (to.z - from.z);
+    setpoint.yaw = from.yaw + alpha * (to.yaw - from.yaw);
+    return setpoint;
+}
+
+void MultirotorApiBase::applySetpoint(const MultirotorSetpoint& setpoint)
+{
+    switch (setpoint.command) {
+    case ScheduledCommand::Velocity:
+        moveByVelocityInternal(setpoint.x, setpoint.y, setpoint.z, YawMode(setpoint.yaw_is_rate, setpoint.yaw));
+        break;
+    case ScheduledCommand::VelocityZ:
+        moveByVelocityZInternal(setpoint.x, setpoint.y, setpoint.z, YawMode(setpoint.yaw_is_rate, setpoint.yaw));
+        break;
+    case ScheduledCommand::RollPitchZ:
+        moveByRollPitchZInternal(setpoint.x, setpoint.y, setpoint.z, setpoint.yaw);
+        break;
+    case ScheduledCommand::RollPitchThrottle:
+        moveByRollPitchThrottleInternal(setpoint.x, setpoint.y, setpoint.z, setpoint.yaw);
+        break;
+    default:
+        throw std::invalid_argument("Unknown scheduled command");
+    }
+}
+
 bool MultirotorApiBase::takeoff(float timeout_sec)
 {
     SingleTaskCall lock(this);
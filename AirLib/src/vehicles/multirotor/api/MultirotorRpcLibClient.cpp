@@ -174,6 +174,16 @@ void MultirotorRpcLibClient::moveByRC(const RCData& rc_data, const std::string&
     static_cast<rpc::client*>(getClient())->call("moveByRC", MultirotorRpcLibAdapators::RCData(rc_data), vehicle_name);
 }
 
+void MultirotorRpcLibClient::moveByControlSchedule(const vector<TTimePoint>& times, const vector<MultirotorSetpoint>& setpoints,
+    ScheduledCommand command, bool yaw_is_rate, MultirotorApiBase::MultirotorControlSchedule::Interpolation interpolation,
+    float horizon, const std::string& vehicle_name)
+{
+    vector<MultirotorRpcLibAdapators::MultirotorSetpoint> packed;
+    MultirotorRpcLibAdapators::from(setpoints, packed);
+    static_cast<rpc::client*>(getClient())->call("moveByControlSchedule", times, packed, static_cast<int>(command), yaw_is_rate,
+        static_cast<int>(interpolation), horizon, vehicle_name);
+}
+
 //return value of last task. It should be true if task completed without
 //cancellation or timeout
 MultirotorRpcLibClient* MultirotorRpcLibClient::waitOnLastTask(bool* task_result, float timeout_sec)
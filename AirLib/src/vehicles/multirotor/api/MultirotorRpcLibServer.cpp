@@ -30,6 +30,7 @@ STRICT_MODE_OFF
 #include "common/common_utils/WindowsApisCommonPost.hpp"
 
 #include "vehicles/multirotor/api/MultirotorRpcLibAdapators.hpp"
+#include "api/RpcLibServerCore.hpp"
 
 STRICT_MODE_ON
 
@@ -41,78 +42,86 @@ typedef msr::airlib_rpclib::MultirotorRpcLibAdapators MultirotorRpcLibAdapators;
 MultirotorRpcLibServer::MultirotorRpcLibServer(ApiProvider* api_provider, string server_address, uint16_t port)
         : RpcLibServerBase(api_provider, server_address, port)
 {
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("takeoff", [&](float timeout_sec, const std::string& vehicle_name) -> bool { 
         return getVehicleApi(vehicle_name)->takeoff(timeout_sec); 
     });
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("land", [&](float timeout_sec, const std::string& vehicle_name) -> bool { 
         return getVehicleApi(vehicle_name)->land(timeout_sec); 
     });
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("goHome", [&](float timeout_sec, const std::string& vehicle_name) -> bool { 
         return getVehicleApi(vehicle_name)->goHome(timeout_sec); 
     });
 
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("moveByAngleZ", [&](float pitch, float roll, float z, float yaw, float duration, const std::string& vehicle_name) ->
         bool { return getVehicleApi(vehicle_name)->moveByAngleZ(pitch, roll, z, yaw, duration); });
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("moveByAngleThrottle", [&](float pitch, float roll, float throttle, float yaw_rate, float duration, 
             const std::string& vehicle_name) -> bool { 
                 return getVehicleApi(vehicle_name)->moveByAngleThrottle(pitch, roll, throttle, yaw_rate, duration); 
     });
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("moveByVelocity", [&](float vx, float vy, float vz, float duration, DrivetrainType drivetrain, 
             const MultirotorRpcLibAdapators::YawMode& yaw_mode, const std::string& vehicle_name) -> bool { 
         return getVehicleApi(vehicle_name)->moveByVelocity(vx, vy, vz, duration, drivetrain, yaw_mode.to()); 
     });
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("moveByVelocityZ", [&](float vx, float vy, float z, float duration, DrivetrainType drivetrain, 
             const MultirotorRpcLibAdapators::YawMode& yaw_mode, const std::string& vehicle_name) -> bool {
             return getVehicleApi(vehicle_name)->moveByVelocityZ(vx, vy, z, duration, drivetrain, yaw_mode.to()); 
     });
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("moveOnPath", [&](const vector<MultirotorRpcLibAdapators::Vector3r>& path, float velocity, float timeout_sec, DrivetrainType drivetrain, const MultirotorRpcLibAdapators::YawMode& yaw_mode,
         float lookahead, float adaptive_lookahead, const std::string& vehicle_name) -> bool {
             vector<Vector3r> conv_path;
             MultirotorRpcLibAdapators::to(path, conv_path);
             return getVehicleApi(vehicle_name)->moveOnPath(conv_path, velocity, timeout_sec, drivetrain, yaw_mode.to(), lookahead, adaptive_lookahead);
         });
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("moveToPosition", [&](float x, float y, float z, float velocity, float timeout_sec, DrivetrainType drivetrain,
         const MultirotorRpcLibAdapators::YawMode& yaw_mode, float lookahead, float adaptive_lookahead, const std::string& vehicle_name) -> bool {
         return getVehicleApi(vehicle_name)->moveToPosition(x, y, z, velocity, timeout_sec, drivetrain, yaw_mode.to(), lookahead, adaptive_lookahead); 
     });
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("moveToZ", [&](float z, float velocity, float timeout_sec, const MultirotorRpcLibAdapators::YawMode& yaw_mode, 
             float lookahead, float adaptive_lookahead, const std::string& vehicle_name) -> bool {
         return getVehicleApi(vehicle_name)->moveToZ(z, velocity, timeout_sec, yaw_mode.to(), lookahead, adaptive_lookahead); 
     });
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("moveByManual", [&](float vx_max, float vy_max, float z_min, float duration, DrivetrainType drivetrain, 
             const MultirotorRpcLibAdapators::YawMode& yaw_mode, const std::string& vehicle_name) -> bool {
         return getVehicleApi(vehicle_name)->moveByManual(vx_max, vy_max, z_min, duration, drivetrain, yaw_mode.to()); 
     });
 
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("rotateToYaw", [&](float yaw, float timeout_sec, float margin, const std::string& vehicle_name) -> bool {
         return getVehicleApi(vehicle_name)->rotateToYaw(yaw, timeout_sec, margin); 
     });
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("rotateByYawRate", [&](float yaw_rate, float duration, const std::string& vehicle_name) -> bool {
         return getVehicleApi(vehicle_name)->rotateByYawRate(yaw_rate, duration); 
     });
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("hover", [&](const std::string& vehicle_name) -> bool {
         return getVehicleApi(vehicle_name)->hover(); 
     });
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("moveByRC", [&](const MultirotorRpcLibAdapators::RCData& data, const std::string& vehicle_name) -> void {
         getVehicleApi(vehicle_name)->moveByRC(data.to()); 
     });
+    (static_cast<RpcLibServerCore*>(getServer()))->
+        bind("moveByControlSchedule", [&](const std::vector<TTimePoint>& times, const std::vector<MultirotorRpcLibAdapators::MultirotorSetpoint>& setpoints,
+            int command, bool yaw_is_rate, int interpolation, float horizon, const std::string& vehicle_name) -> void {
+        std::vector<MultirotorSetpoint> converted;
+        MultirotorRpcLibAdapators::to(setpoints, converted);
+        getVehicleApi(vehicle_name)->moveByControlSchedule(times, converted, static_cast<ScheduledCommand>(command), yaw_is_rate,
+            static_cast<MultirotorApiBase::MultirotorControlSchedule::Interpolation>(interpolation), horizon);
+    });
 
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("setSafety", [&](uint enable_reasons, float obs_clearance, const SafetyEval::ObsAvoidanceStrategy& obs_startegy,
         float obs_avoidance_vel, const MultirotorRpcLibAdapators::Vector3r& origin, float xy_length, 
             float max_z, float min_z, const std::string& vehicle_name) -> bool {
@@ -121,7 +130,7 @@ MultirotorRpcLibServer::MultirotorRpcLibServer(ApiProvider* api_provider, string
     });
 
     //getters
-    (static_cast<rpc::server*>(getServer()))->
+    (static_cast<RpcLibServerCore*>(getServer()))->
         bind("getMultirotorState", [&](const std::string& vehicle_name) -> MultirotorRpcLibAdapators::MultirotorState {
         return MultirotorRpcLibAdapators::MultirotorState(getVehicleApi(vehicle_name)->getMultirotorState()); 
     });
@@ -18,6 +18,7 @@ STRICT_MODE_OFF
 //#undef check
 #include "rpc/server.h"
 #include "vehicles/urdfbot/api/UrdfBotRpcLibAdaptors.hpp"
+#include "api/RpcLibServerCore.hpp"
 //UE4 defines macro names that conflicts with msgpack library (e.g. "check")
 #define check(expr) (static_cast<void>((expr)))
 STRICT_MODE_ON
@@ -28,7 +29,7 @@ namespace msr { namespace airlib {
 UrdfBotRpcLibServer::UrdfBotRpcLibServer(ApiProvider* api_provider, string server_address, uint16_t port)
     : RpcLibServerBase(api_provider, server_address, port)
 {
-    auto server = static_cast<rpc::server*>(getServer());
+    auto server = static_cast<RpcLibServerCore*>(getServer());
 
     server->
         bind("addAngularForce", [&](const msr::airlib_rpclib::UrdfBotRpcLibAdaptors::AddAngularForce& force, const std::string& vehicle_name) -> void {
@@ -0,0 +1,2149 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//in header only mode, control library is not available
+#ifndef AIRLIB_HEADER_ONLY
+
+#include "vehicles/urdfbot/parser/UrdfParser.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace msr { namespace airlib {
+
+namespace {
+
+constexpr uint MaxElementDepth = 256;
+constexpr uint MaxExpansionDepth = 1024; //elements, macro calls and includes together
+constexpr uint MaxMacroDepth = 100;
+constexpr uint MaxIncludeDepth = 32;
+constexpr uint MaxExpressionDepth = 128;
+constexpr size_t MaxExpandedElements = 2000000;
+
+struct XmlEvent {
+    enum class Type {
+        Start, End
+    };
+
+    Type type = Type::Start;
+    std::string name;
+    vector<std::pair<std::string, std::string>> attributes;
+    const std::string* file = nullptr;
+    uint line = 0;
+
+    const std::string* getAttribute(const char* attribute_name) const
+    {
+        for (const auto& attribute : attributes)
+            if (attribute.first == attribute_name)
+                return &attribute.second;
+        return nullptr;
+    }
+};
+
+//formats errors and collects warnings, file names live here so events can point to them
+class ParseContext {
+public:
+    const std::string* addFile(const std::string& file_name)
+    {
+        files_.push_back(file_name);
+        return &files_.back();
+    }
+
+    [[noreturn]] void fail(const std::string* file, uint line, const std::string& message) const
+    {
+        std::string text = Utils::stringf("%s:%u: %s", file->c_str(), line, message.c_str());
+        for (auto call = macro_calls_.rbegin(); call != macro_calls_.rend(); ++call)
+            text += Utils::stringf(" (in macro '%s' called at %s:%u)", call->name.c_str(), call->file->c_str(), call->line);
+        throw std::runtime_error(text);
+    }
+
+    [[noreturn]] void fail(const XmlEvent& event, const std::string& message) const
+    {
+        fail(event.file, event.line, message);
+    }
+
+    void warn(const std::string* file, uint line, const std::string& message)
+    {
+        warnings.push_back(UrdfParser::Diagnostic{ *file, line, message });
+    }
+
+    void pushMacroCall(const std::string& name, const XmlEvent& call)
+    {
+        macro_calls_.push_back(MacroCall{ name, call.file, call.line });
+    }
+
+    void popMacroCall()
+    {
+        macro_calls_.pop_back();
+    }
+
+    size_t getMacroDepth() const
+    {
+        return macro_calls_.size();
+    }
+
+    vector<UrdfParser::Diagnostic> warnings;
+
+private:
+    struct MacroCall {
+        std::string name;
+        const std::string* file;
+        uint line;
+    };
+
+    std::deque<std::string> files_;
+    vector<MacroCall> macro_calls_;
+};
+
+class EventSource {
+public:
+    virtual ~EventSource() = default;
+    //returns false at the end of the source
+    virtual bool next(XmlEvent& event) = 0;
+};
+
+//events recorded from a macro body or block
+class RecordedSource : public EventSource {
+public:
+    explicit RecordedSource(const vector<XmlEvent>& events)
+        : events_(events)
+    {
+    }
+
+    virtual bool next(XmlEvent& event) override
+    {
+        if (index_ >= events_.size())
+            return false;
+        event = events_[index_++];
+        return true;
+    }
+
+private:
+    const vector<XmlEvent>& events_;
+    size_t index_ = 0;
+};
+
+/*
+    Pull parser for the subset of XML used by robot descriptions. Reports start and end tags in document order,
+    with empty elements reported as a start followed by an end. Text, comments, processing instructions, CDATA and
+    the DOCTYPE are checked and skipped. Tags must be balanced and there must be exactly one root element.
+*/
+class XmlReader : public EventSource {
+public:
+    XmlReader(const std::string& text, const std::string* file, ParseContext& context)
+        : pos_(text.data()), end_(text.data() + text.size()), file_(file), context_(context)
+    {
+        //utf-8 byte order mark
+        if (end_ - pos_ >= 3 && std::memcmp(pos_, "\xEF\xBB\xBF", 3) == 0)
+            pos_ += 3;
+    }
+
+    virtual bool next(XmlEvent& event) override
+    {
+        event.file = file_;
+        if (pending_end_) {
+            pending_end_ = false;
+            event.type = XmlEvent::Type::End;
+            event.line = line_;
+            event.name = open_.back();
+            event.attributes.clear();
+            closeElement();
+            return true;
+        }
+
+        for (;;) {
+            const char* tag = static_cast<const char*>(std::memchr(pos_, '<', end_ - pos_));
+            checkText(pos_, tag != nullptr ? tag : end_);
+            advanceTo(tag != nullptr ? tag : end_);
+            if (tag == nullptr) {
+                if (!open_.empty())
+                    fail("unexpected end of file, <" + open_.back() + "> is not closed");
+                if (!root_seen_)
+                    fail("no root element");
+                return false;
+            }
+
+            if (startsWith("<!--")) {
+                skipPast("-->", "unterminated comment");
+            }
+            else if (startsWith("<![CDATA[")) {
+                if (open_.empty())
+                    fail("text outside the root element");
+                skipPast("]]>", "unterminated CDATA section");
+            }
+            else if (startsWith("<!")) {
+                skipDeclaration();
+            }
+            else if (startsWith("<?")) {
+                skipPast("?>", "unterminated processing instruction");
+            }
+            else if (startsWith("</")) {
+                event.type = XmlEvent::Type::End;
+                event.line = line_;
+                event.attributes.clear();
+                advanceTo(pos_ + 2);
+                readName(event.name);
+                skipSpace();
+                expect('>');
+                if (open_.empty() || open_.back() != event.name)
+                    fail(open_.empty() ? "unexpected closing tag </" + event.name + ">"
+                        : "expected </" + open_.back() + "> but found </" + event.name + ">");
+                closeElement();
+                return true;
+            }
+            else {
+                readStartTag(event);
+                return true;
+            }
+        }
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& message) const
+    {
+        context_.fail(file_, line_, message);
+    }
+
+    bool startsWith(const char* text) const
+    {
+        size_t length = std::strlen(text);
+        return static_cast<size_t>(end_ - pos_) >= length && std::memcmp(pos_, text, length) == 0;
+    }
+
+    void advanceTo(const char* position)
+    {
+        line_ += static_cast<uint>(std::count(pos_, position, '\n'));
+        pos_ = position;
+    }
+
+    void skipPast(const char* terminator, const char* error)
+    {
+        const char* found = std::search(pos_, end_, terminator, terminator + std::strlen(terminator));
+        if (found == end_)
+            fail(error);
+        advanceTo(found + std::strlen(terminator));
+    }
+
+    void skipDeclaration()
+    {
+        //<!DOCTYPE ...> with an optional internal subset in brackets
+        int brackets = 0;
+        for (const char* c = pos_ + 2; c < end_; ++c) {
+            if (*c == '[')
+                ++brackets;
+            else if (*c == ']')
+                --brackets;
+            else if (*c == '>' && brackets <= 0) {
+                advanceTo(c + 1);
+                return;
+            }
+        }
+        fail("unterminated declaration");
+    }
+
+    //only whitespace may appear outside the root element, text inside elements is not used by robot descriptions
+    void checkText(const char* begin, const char* end) const
+    {
+        if (open_.empty()) {
+            for (const char* c = begin; c < end; ++c)
+                if (!isSpace(*c))
+                    fail("text outside the root element");
+        }
+    }
+
+    static bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    static bool isNameStart(char c)
+    {
+        return std::isalpha(static_cast<unsigned char>(c)) || c == '_' || c == ':' || (c & 0x80) != 0;
+    }
+
+    static bool isNameChar(char c)
+    {
+        return isNameStart(c) || std::isdigit(static_cast<unsigned char>(c)) || c == '-' || c == '.';
+    }
+
+    void skipSpace()
+    {
+        const char* c = pos_;
+        while (c < end_ && isSpace(*c))
+            ++c;
+        advanceTo(c);
+    }
+
+    void expect(char c)
+    {
+        if (pos_ >= end_)
+            fail(std::string("unexpected end of file, expected '") + c + "'");
+        if (*pos_ != c)
+            fail(std::string("expected '") + c + "' but found '" + *pos_ + "'");
+        ++pos_;
+    }
+
+    void readName(std::string& name)
+    {
+        if (pos_ >= end_ || !isNameStart(*pos_))
+            fail("expected a name");
+        const char* start = pos_;
+        while (pos_ < end_ && isNameChar(*pos_))
+            ++pos_;
+        name.assign(start, pos_);
+    }
+
+    void readStartTag(XmlEvent& event)
+    {
+        event.type = XmlEvent::Type::Start;
+        event.line = line_;
+        event.attributes.clear();
+        ++pos_;
+        readName(event.name);
+
+        if (open_.empty()) {
+            if (root_seen_)
+                fail("more than one root element");
+            root_seen_ = true;
+        }
+
+        for (;;) {
+            const char* before_space = pos_;
+            skipSpace();
+            if (pos_ >= end_)
+                fail("unexpected end of file in <" + event.name + ">");
+            if (*pos_ == '/') {
+                ++pos_;
+                expect('>');
+                pending_end_ = true;
+                break;
+            }
+            if (*pos_ == '>') {
+                ++pos_;
+                break;
+            }
+            if (before_space == pos_)
+                fail("expected whitespace between attributes of <" + event.name + ">");
+
+            event.attributes.emplace_back();
+            auto& attribute = event.attributes.back();
+            readName(attribute.first);
+            skipSpace();
+            expect('=');
+            skipSpace();
+            if (pos_ >= end_ || (*pos_ != '"' && *pos_ != '\''))
+                fail("value of attribute '" + attribute.first + "' must be quoted");
+            const char* value_end = static_cast<const char*>(std::memchr(pos_ + 1, *pos_, end_ - pos_ - 1));
+            if (value_end == nullptr)
+                fail("unterminated value of attribute '" + attribute.first + "'");
+            decode(pos_ + 1, value_end, attribute.second);
+            advanceTo(value_end + 1);
+
+            for (size_t i = 0; i + 1 < event.attributes.size(); ++i)
+                if (event.attributes[i].first == attribute.first)
+                    fail("duplicate attribute '" + attribute.first + "' in <" + event.name + ">");
+        }
+
+        if (open_.size() >= MaxElementDepth)
+            fail("elements are nested too deeply");
+        open_.push_back(event.name);
+    }
+
+    void closeElement()
+    {
+        open_.pop_back();
+        if (open_.empty())
+            root_closed_ = true;
+    }
+
+    //replaces entity and character references
+    void decode(const char* begin, const char* end, std::string& value) const
+    {
+        const char* amp = static_cast<const char*>(std::memchr(begin, '&', end - begin));
+        if (std::find(begin, end, '<') != end)
+            fail("'<' is not allowed in attribute values");
+        if (amp == nullptr) {
+            value.assign(begin, end);
+            return;
+        }
+
+        value.clear();
+        for (const char* c = begin; c < end; ++c) {
+            if (*c != '&') {
+                value += *c;
+                continue;
+            }
+            const char* semicolon = std::find(c, end, ';');
+            if (semicolon == end)
+                fail("unterminated entity reference");
+            std::string entity(c + 1, semicolon);
+            if (entity == "lt")
+                value += '<';
+            else if (entity == "gt")
+                value += '>';
+            else if (entity == "amp")
+                value += '&';
+            else if (entity == "quot")
+                value += '"';
+            else if (entity == "apos")
+                value += '\'';
+            else if (entity.size() > 1 && entity[0] == '#') {
+                bool hex = entity[1] == 'x';
+                const char* digits = entity.c_str() + (hex ? 2 : 1);
+                char* digits_end;
+                unsigned long code = std::strtoul(digits, &digits_end, hex ? 16 : 10);
+                if (*digits == '\0' || *digits_end != '\0' || code == 0 || code > 0x10FFFF)
+                    fail("invalid character reference &" + entity + ";");
+                appendUtf8(static_cast<uint32_t>(code), value);
+            }
+            else
+                fail("unknown entity &" + entity + ";");
+            c = semicolon;
+        }
+    }
+
+    static void appendUtf8(uint32_t code, std::string& out)
+    {
+        if (code < 0x80)
+            out += static_cast<char>(code);
+        else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+private:
+    const char* pos_;
+    const char* end_;
+    const std::string* file_;
+    ParseContext& context_;
+    uint line_ = 1;
+    vector<std::string> open_;
+    bool pending_end_ = false;
+    bool root_seen_ = false;
+    bool root_closed_ = false;
+};
+
+std::string formatNumber(double value)
+{
+    if (value == 0)
+        return "0";
+    if (std::floor(value) == value && std::fabs(value) < 1E15)
+        return Utils::stringf("%.0f", value);
+    //shortest text that reads back to the same double
+    for (int precision = 15; precision <= 17; ++precision) {
+        std::string text = Utils::stringf("%.*g", precision, value);
+        if (std::strtod(text.c_str(), nullptr) == value || precision == 17)
+            return text;
+    }
+    return std::string();
+}
+
+//parses the whole of text as a number
+bool parseNumber(const std::string& text, double& value)
+{
+    const char* begin = text.c_str();
+    while (*begin == ' ' || *begin == '\t' || *begin == '\n' || *begin == '\r')
+        ++begin;
+    if (*begin == '\0')
+        return false;
+    char* end;
+    value = std::strtod(begin, &end);
+    while (*end == ' ' || *end == '\t' || *end == '\n' || *end == '\r')
+        ++end;
+    return *end == '\0' && end != begin;
+}
+
+struct Scope {
+    Scope* parent = nullptr;
+    std::unordered_map<std::string, std::string> properties;
+    std::unordered_map<std::string, std::shared_ptr<const vector<XmlEvent>>> blocks;
+
+    const std::string* findProperty(const std::string& name) const
+    {
+        for (const Scope* scope = this; scope != nullptr; scope = scope->parent) {
+            auto found = scope->properties.find(name);
+            if (found != scope->properties.end())
+                return &found->second;
+        }
+        return nullptr;
+    }
+
+    const vector<XmlEvent>* findBlock(const std::string& name) const
+    {
+        for (const Scope* scope = this; scope != nullptr; scope = scope->parent) {
+            auto found = scope->blocks.find(name);
+            if (found != scope->blocks.end())
+                return found->second.get();
+        }
+        return nullptr;
+    }
+};
+
+/*
+    Evaluates the python-like expressions inside ${}. Values are numbers, booleans or strings, and names are
+    looked up as properties. Errors are returned as text so the caller can add the location.
+*/
+class ExpressionEvaluator {
+public:
+    struct Value {
+        enum class Type {
+            Number, Bool, String
+        };
+
+        Type type = Type::Number;
+        double number = 0;
+        std::string text;
+
+        static Value fromNumber(double number)
+        {
+            Value value;
+            value.number = number;
+            return value;
+        }
+
+        static Value fromBool(bool flag)
+        {
+            Value value;
+            value.type = Type::Bool;
+            value.number = flag ? 1 : 0;
+            return value;
+        }
+
+        static Value fromString(const std::string& text)
+        {
+            Value value;
+            value.type = Type::String;
+            value.text = text;
+            return value;
+        }
+
+        std::string toString() const
+        {
+            switch (type) {
+            case Type::Bool: return number != 0 ? "true" : "false";
+            case Type::String: return text;
+            default: return formatNumber(number);
+            }
+        }
+    };
+
+    struct Error {
+        std::string message;
+    };
+
+    explicit ExpressionEvaluator(const Scope& scope)
+        : scope_(scope)
+    {
+    }
+
+    Value evaluate(const std::string& expression)
+    {
+        text_ = expression.c_str();
+        pos_ = 0;
+        depth_ = 0;
+        Value value = parseOr();
+        skipSpace();
+        if (text_[pos_] != '\0')
+            fail(std::string("unexpected '") + text_[pos_] + "'");
+        return value;
+    }
+
+    static bool toBool(const Value& value)
+    {
+        if (value.type != Value::Type::String)
+            return value.number != 0;
+        double number;
+        if (parseNumber(value.text, number))
+            return number != 0;
+        if (value.text == "true" || value.text == "True")
+            return true;
+        if (value.text == "false" || value.text == "False" || value.text.empty())
+            return false;
+        throw Error{ "'" + value.text + "' is not a boolean" };
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& message) const
+    {
+        throw Error{ message + " in expression '" + text_ + "'" };
+    }
+
+    void skipSpace()
+    {
+        while (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')
+            ++pos_;
+    }
+
+    bool accept(const char* token)
+    {
+        skipSpace();
+        size_t length = std::strlen(token);
+        if (std::strncmp(text_ + pos_, token, length) != 0)
+            return false;
+        //keywords must not run in to a following name
+        if (std::isalpha(static_cast<unsigned char>(token[0])) && isNameChar(text_[pos_ + length]))
+            return false;
+        pos_ += length;
+        return true;
+    }
+
+    static bool isNameChar(char c)
+    {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.';
+    }
+
+    double toNumber(const Value& value) const
+    {
+        if (value.type != Value::Type::String)
+            return value.number;
+        double number;
+        if (!parseNumber(value.text, number))
+            fail("'" + value.text + "' is not a number");
+        return number;
+    }
+
+    void enter()
+    {
+        if (++depth_ > MaxExpressionDepth)
+            fail("expression is nested too deeply");
+    }
+
+    Value parseOr()
+    {
+        enter();
+        Value value = parseAnd();
+        while (accept("or") || accept("||")) {
+            Value right = parseAnd();
+            value = Value::fromBool(toBoolChecked(value) || toBoolChecked(right));
+        }
+        --depth_;
+        return value;
+    }
+
+    Value parseAnd()
+    {
+        Value value = parseNot();
+        while (accept("and") || accept("&&")) {
+            Value right = parseNot();
+            value = Value::fromBool(toBoolChecked(value) && toBoolChecked(right));
+        }
+        return value;
+    }
+
+    Value parseNot()
+    {
+        if (accept("not")) {
+            enter();
+            Value value = Value::fromBool(!toBoolChecked(parseNot()));
+            --depth_;
+            return value;
+        }
+        return parseComparison();
+    }
+
+    bool toBoolChecked(const Value& value) const
+    {
+        try {
+            return toBool(value);
+        }
+        catch (const Error& error) {
+            fail(error.message);
+        }
+    }
+
+    Value parseComparison()
+    {
+        Value left = parseSum();
+        const char* operators[] = { "==", "!=", "<=", ">=", "<", ">" };
+        for (const char* op : operators) {
+            if (!accept(op))
+                continue;
+            Value right = parseSum();
+            int order;
+            if (left.type == Value::Type::String && right.type == Value::Type::String)
+                order = left.text.compare(right.text);
+            else if ((left.type == Value::Type::String) != (right.type == Value::Type::String) && (op[0] == '=' || op[0] == '!')) {
+                //a string only equals a number if it is that number
+                double number;
+                const Value& text = left.type == Value::Type::String ? left : right;
+                const Value& other = left.type == Value::Type::String ? right : left;
+                order = parseNumber(text.text, number) && number == other.number ? 0 : 1;
+            }
+            else {
+                double a = toNumber(left), b = toNumber(right);
+                order = a < b ? -1 : (a > b ? 1 : 0);
+            }
+
+            bool result;
+            if (op[0] == '=')
+                result = order == 0;
+            else if (op[0] == '!')
+                result = order != 0;
+            else if (op[0] == '<')
+                result = op[1] == '=' ? order <= 0 : order < 0;
+            else
+                result = op[1] == '=' ? order >= 0 : order > 0;
+            return Value::fromBool(result);
+        }
+        return left;
+    }
+
+    Value parseSum()
+    {
+        Value value = parseProduct();
+        for (;;) {
+            if (accept("+")) {
+                Value right = parseProduct();
+                if (value.type == Value::Type::String && right.type == Value::Type::String)
+                    value = Value::fromString(value.text + right.text);
+                else
+                    value = Value::fromNumber(toNumber(value) + toNumber(right));
+            }
+            else if (accept("-"))
+                value = Value::fromNumber(toNumber(value) - toNumber(parseProduct()));
+            else
+                return value;
+        }
+    }
+
+    Value parseProduct()
+    {
+        Value value = parseUnary();
+        for (;;) {
+            if (accept("*"))
+                value = Value::fromNumber(toNumber(value) * toNumber(parseUnary()));
+            else if (accept("//")) {
+                double divisor = toNumber(parseUnary());
+                if (divisor == 0)
+                    fail("division by zero");
+                value = Value::fromNumber(std::floor(toNumber(value) / divisor));
+            }
+            else if (accept("/")) {
+                double divisor = toNumber(parseUnary());
+                if (divisor == 0)
+                    fail("division by zero");
+                value = Value::fromNumber(toNumber(value) / divisor);
+            }
+            else if (accept("%")) {
+                double divisor = toNumber(parseUnary());
+                if (divisor == 0)
+                    fail("division by zero");
+                double dividend = toNumber(value);
+                value = Value::fromNumber(dividend - divisor * std::floor(dividend / divisor));
+            }
+            else
+                return value;
+        }
+    }
+
+    Value parseUnary()
+    {
+        enter();
+        Value value;
+        if (accept("-"))
+            value = Value::fromNumber(-toNumber(parseUnary()));
+        else if (accept("+"))
+            value = Value::fromNumber(toNumber(parseUnary()));
+        else
+            value = parsePower();
+        --depth_;
+        return value;
+    }
+
+    Value parsePower()
+    {
+        Value value = parsePrimary();
+        if (accept("**"))
+            value = Value::fromNumber(std::pow(toNumber(value), toNumber(parseUnary())));
+        return value;
+    }
+
+    Value parsePrimary()
+    {
+        skipSpace();
+        char c = text_[pos_];
+        if (c == '(') {
+            ++pos_;
+            Value value = parseOr();
+            if (!accept(")"))
+                fail("missing ')'");
+            return value;
+        }
+        if (c == '\'' || c == '"') {
+            const char* end = std::strchr(text_ + pos_ + 1, c);
+            if (end == nullptr)
+                fail("unterminated string");
+            Value value = Value::fromString(std::string(text_ + pos_ + 1, end));
+            pos_ = end - text_ + 1;
+            return value;
+        }
+        if (std::isdigit(static_cast<unsigned char>(c)) || (c == '.' && std::isdigit(static_cast<unsigned char>(text_[pos_ + 1])))) {
+            char* end;
+            double number = std::strtod(text_ + pos_, &end);
+            pos_ = end - text_;
+            return Value::fromNumber(number);
+        }
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            size_t start = pos_;
+            while (isNameChar(text_[pos_]))
+                ++pos_;
+            std::string name(text_ + start, text_ + pos_);
+            if (accept("("))
+                return callFunction(name);
+            return lookup(name);
+        }
+        if (c == '\0')
+            fail("unexpected end");
+        fail(std::string("unexpected '") + c + "'");
+    }
+
+    Value lookup(const std::string& name) const
+    {
+        const std::string* property = scope_.findProperty(name);
+        if (property != nullptr) {
+            double number;
+            if (parseNumber(*property, number))
+                return Value::fromNumber(number);
+            return Value::fromString(*property);
+        }
+
+        std::string constant = name.compare(0, 5, "math.") == 0 ? name.substr(5) : name;
+        if (constant == "pi")
+            return Value::fromNumber(M_PI);
+        if (constant == "e")
+            return Value::fromNumber(std::exp(1.0));
+        if (name == "True" || name == "true")
+            return Value::fromBool(true);
+        if (name == "False" || name == "false")
+            return Value::fromBool(false);
+        fail("unknown property '" + name + "'");
+    }
+
+    Value callFunction(const std::string& name)
+    {
+        vector<double> args;
+        if (!accept(")")) {
+            do {
+                args.push_back(toNumber(parseOr()));
+            } while (accept(","));
+            if (!accept(")"))
+                fail("missing ')' after arguments of " + name);
+        }
+
+        std::string function = name.compare(0, 5, "math.") == 0 ? name.substr(5) : name;
+        typedef double (*Unary)(double);
+        static const std::pair<const char*, Unary> unary_functions[] = {
+            { "sin", static_cast<Unary>(std::sin) }, { "cos", static_cast<Unary>(std::cos) },
+            { "tan", static_cast<Unary>(std::tan) }, { "asin", static_cast<Unary>(std::asin) },
+            { "acos", static_cast<Unary>(std::acos) }, { "atan", static_cast<Unary>(std::atan) },
+            { "sqrt", static_cast<Unary>(std::sqrt) }, { "exp", static_cast<Unary>(std::exp) },
+            { "log", static_cast<Unary>(std::log) }, { "log10", static_cast<Unary>(std::log10) },
+            { "floor", static_cast<Unary>(std::floor) }, { "ceil", static_cast<Unary>(std::ceil) },
+            { "fabs", static_cast<Unary>(std::fabs) }, { "abs", static_cast<Unary>(std::fabs) },
+            { "round", static_cast<Unary>(std::round) }, { "float", [](double x) { return x; } },
+            { "int", static_cast<Unary>(std::trunc) },
+            { "radians", [](double x) { return x * M_PI / 180; } },
+            { "degrees", [](double x) { return x * 180 / M_PI; } }
+        };
+        for (const auto& unary : unary_functions) {
+            if (function == unary.first) {
+                if (args.size() != 1)
+                    fail(function + " takes one argument");
+                return Value::fromNumber(unary.second(args[0]));
+            }
+        }
+        if (function == "atan2" || function == "pow" || function == "fmod") {
+            if (args.size() != 2)
+                fail(function + " takes two arguments");
+            if (function == "atan2")
+                return Value::fromNumber(std::atan2(args[0], args[1]));
+            if (function == "pow")
+                return Value::fromNumber(std::pow(args[0], args[1]));
+            return Value::fromNumber(std::fmod(args[0], args[1]));
+        }
+        if (function == "min" || function == "max") {
+            if (args.empty())
+                fail(function + " needs arguments");
+            return Value::fromNumber(function == "min" ? *std::min_element(args.begin(), args.end())
+                : *std::max_element(args.begin(), args.end()));
+        }
+        fail("unknown function '" + name + "'");
+    }
+
+private:
+    const Scope& scope_;
+    const char* text_ = "";
+    size_t pos_ = 0;
+    uint depth_ = 0;
+};
+
+//receives the expanded URDF elements
+class ElementHandler {
+public:
+    virtual ~ElementHandler() = default;
+    virtual void startElement(const XmlEvent& event) = 0;
+    virtual void endElement() = 0;
+};
+
+/*
+    Expands xacro elements as they stream past. Macro bodies and blocks are recorded as events and replayed with
+    their own scope, everything else is passed on with ${} and $() substituted in its attributes.
+*/
+class XacroExpander {
+public:
+    XacroExpander(ParseContext& context, ElementHandler& handler,
+        const std::map<std::string, std::string>& args, const std::map<std::string, std::string>& package_paths)
+        : context_(context), handler_(handler), args_(args), package_paths_(package_paths)
+    {
+    }
+
+    //expands events until the end of the current element or source
+    void expandChildren(EventSource& source, Scope& scope)
+    {
+        XmlEvent event;
+        while (source.next(event)) {
+            if (event.type == XmlEvent::Type::End)
+                return;
+            DepthGuard guard(*this, event);
+
+            if (event.name.compare(0, 6, "xacro:") == 0)
+                expandXacro(event, source, scope);
+            else {
+                if (++expanded_elements_ > MaxExpandedElements)
+                    context_.fail(event, "expansion produced too many elements");
+                for (auto& attribute : event.attributes)
+                    if (attribute.second.find('$') != std::string::npos)
+                        attribute.second = substitute(attribute.second, scope, event);
+                handler_.startElement(event);
+                expandChildren(source, scope);
+                handler_.endElement();
+            }
+        }
+    }
+
+    std::string substitute(const std::string& text, const Scope& scope, const XmlEvent& event)
+    {
+        if (text.find('$') == std::string::npos)
+            return text;
+
+        std::string result;
+        for (size_t i = 0; i < text.size(); ++i) {
+            char c = text[i];
+            if (c != '$' || i + 1 >= text.size()) {
+                result += c;
+                continue;
+            }
+            char next = text[i + 1];
+            if (next == '$' && i + 2 < text.size() && (text[i + 2] == '{' || text[i + 2] == '(')) {
+                //$${ and $$( are escapes for a literal ${ and $(
+                result += '$';
+                result += text[i + 2];
+                i += 2;
+            }
+            else if (next == '{' || next == '(') {
+                size_t end = findClosing(text, i + 1);
+                if (end == std::string::npos)
+                    context_.fail(event, "unterminated $" + std::string(1, next) + " in '" + text + "'");
+                std::string inner = text.substr(i + 2, end - i - 2);
+                if (next == '{')
+                    result += evaluate(inner, scope, event).toString();
+                else
+                    result += substituteCommand(inner, event);
+                i = end;
+            }
+            else
+                result += c;
+        }
+        return result;
+    }
+
+    ExpressionEvaluator::Value evaluate(const std::string& expression, const Scope& scope, const XmlEvent& event)
+    {
+        try {
+            return ExpressionEvaluator(scope).evaluate(substituteCommands(expression, event));
+        }
+        catch (const ExpressionEvaluator::Error& error) {
+            context_.fail(event, error.message);
+        }
+    }
+
+private:
+    struct Macro {
+        struct Param {
+            std::string name;
+            int block_stars = 0; //* for an element, ** for the children of an element
+            bool has_default = false;
+            bool from_parent = false; //:=^ takes the value from the calling scope
+            std::string default_value;
+        };
+
+        std::string name;
+        vector<Param> params;
+        vector<XmlEvent> body;
+    };
+
+    class DepthGuard {
+    public:
+        DepthGuard(XacroExpander& expander, const XmlEvent& event)
+            : expander_(expander)
+        {
+            if (++expander_.depth_ > MaxExpansionDepth)
+                expander_.context_.fail(event, "expansion is nested too deeply");
+        }
+        ~DepthGuard()
+        {
+            --expander_.depth_;
+        }
+    private:
+        XacroExpander& expander_;
+    };
+
+    static size_t findClosing(const std::string& text, size_t open)
+    {
+        char open_char = text[open], close_char = open_char == '{' ? '}' : ')';
+        int level = 0;
+        char quote = 0;
+        for (size_t i = open; i < text.size(); ++i) {
+            char c = text[i];
+            if (quote != 0) {
+                if (c == quote)
+                    quote = 0;
+            }
+            else if (c == '\'' || c == '"')
+                quote = c;
+            else if (c == open_char)
+                ++level;
+            else if (c == close_char && --level == 0)
+                return i;
+        }
+        return std::string::npos;
+    }
+
+    //only $() inside expressions, so ${$(arg x) * 2} works
+    std::string substituteCommands(const std::string& text, const XmlEvent& event)
+    {
+        size_t start = text.find("$(");
+        if (start == std::string::npos)
+            return text;
+        size_t end = findClosing(text, start + 1);
+        if (end == std::string::npos)
+            context_.fail(event, "unterminated $( in '" + text + "'");
+        std::string value = substituteCommand(text.substr(start + 2, end - start - 2), event);
+        double number;
+        if (!parseNumber(value, number))
+            value = "'" + value + "'";
+        return text.substr(0, start) + value + substituteCommands(text.substr(end + 1), event);
+    }
+
+    std::string substituteCommand(const std::string& command, const XmlEvent& event)
+    {
+        std::istringstream words(command);
+        std::string verb, name;
+        words >> verb >> name;
+        if (verb == "arg") {
+            auto found = args_.find(name);
+            if (found == args_.end())
+                context_.fail(event, "undefined argument '" + name + "'");
+            return found->second;
+        }
+        if (verb == "find") {
+            auto found = package_paths_.find(name);
+            if (found == package_paths_.end())
+                context_.fail(event, "unknown package '" + name + "', set its path with setPackagePath");
+            return found->second;
+        }
+        if (verb == "env" || verb == "optenv") {
+            const char* value = std::getenv(name.c_str());
+            if (value != nullptr)
+                return value;
+            if (verb == "env")
+                context_.fail(event, "environment variable '" + name + "' is not set");
+            std::string fallback;
+            std::getline(words >> std::ws, fallback);
+            return fallback;
+        }
+        context_.fail(event, "unknown substitution $(" + command + ")");
+    }
+
+    const std::string& requireAttribute(const XmlEvent& event, const char* name)
+    {
+        const std::string* value = event.getAttribute(name);
+        if (value == nullptr)
+            context_.fail(event, "<" + event.name + "> is missing the '" + name + "' attribute");
+        return *value;
+    }
+
+    //records events until the end of the current element, which is consumed but not recorded
+    void recordChildren(EventSource& source, vector<XmlEvent>& events)
+    {
+        int level = 0;
+        XmlEvent event;
+        while (source.next(event)) {
+            if (event.type == XmlEvent::Type::End && level-- == 0)
+                return;
+            if (event.type == XmlEvent::Type::Start)
+                ++level;
+            events.push_back(event);
+        }
+    }
+
+    void skipChildren(EventSource& source)
+    {
+        int level = 0;
+        XmlEvent event;
+        while (source.next(event)) {
+            if (event.type == XmlEvent::Type::End && level-- == 0)
+                return;
+            if (event.type == XmlEvent::Type::Start)
+                ++level;
+        }
+    }
+
+    void expandXacro(const XmlEvent& event, EventSource& source, Scope& scope)
+    {
+        std::string tag = event.name.substr(6);
+        if (tag == "property")
+            defineProperty(event, source, scope);
+        else if (tag == "arg") {
+            const std::string& name = requireAttribute(event, "name");
+            const std::string* default_value = event.getAttribute("default");
+            if (args_.find(name) == args_.end() && default_value != nullptr)
+                args_[name] = substitute(*default_value, scope, event);
+            skipChildren(source);
+        }
+        else if (tag == "macro")
+            defineMacro(event, source);
+        else if (tag == "if" || tag == "unless") {
+            ExpressionEvaluator::Value value = ExpressionEvaluator::Value::fromString(
+                substitute(requireAttribute(event, "value"), scope, event));
+            bool condition;
+            try {
+                condition = ExpressionEvaluator::toBool(value);
+            }
+            catch (const ExpressionEvaluator::Error& error) {
+                context_.fail(event, error.message);
+            }
+            if (condition == (tag == "if"))
+                expandChildren(source, scope);
+            else
+                skipChildren(source);
+        }
+        else if (tag == "insert_block") {
+            const std::string name = substitute(requireAttribute(event, "name"), scope, event);
+            const vector<XmlEvent>* block = scope.findBlock(name);
+            if (block == nullptr)
+                context_.fail(event, "unknown block '" + name + "'");
+            RecordedSource block_source(*block);
+            expandChildren(block_source, scope);
+            skipChildren(source);
+        }
+        else if (tag == "include")
+            include(event, source, scope);
+        else {
+            auto macro = macros_.find(tag);
+            if (macro == macros_.end())
+                context_.fail(event, "unknown macro or unsupported xacro element <" + event.name + ">");
+            callMacro(*macro->second, event, source, scope);
+        }
+    }
+
+    void defineProperty(const XmlEvent& event, EventSource& source, Scope& scope)
+    {
+        const std::string name = requireAttribute(event, "name");
+        Scope* target = &scope;
+        const std::string* scope_name = event.getAttribute("scope");
+        if (scope_name != nullptr && *scope_name == "parent" && scope.parent != nullptr)
+            target = scope.parent;
+        else if (scope_name != nullptr && *scope_name == "global")
+            while (target->parent != nullptr)
+                target = target->parent;
+
+        const std::string* value = event.getAttribute("value");
+        const std::string* default_value = event.getAttribute("default");
+        if (value != nullptr) {
+            target->properties[name] = substitute(*value, scope, event);
+            skipChildren(source);
+        }
+        else if (default_value != nullptr) {
+            if (scope.findProperty(name) == nullptr)
+                target->properties[name] = substitute(*default_value, scope, event);
+            skipChildren(source);
+        }
+        else {
+            //a block property, inserted later with insert_block
+            auto block = std::make_shared<vector<XmlEvent>>();
+            recordChildren(source, *block);
+            target->blocks[name] = block;
+        }
+    }
+
+    void defineMacro(const XmlEvent& event, EventSource& source)
+    {
+        auto macro = std::make_shared<Macro>();
+        macro->name = requireAttribute(event, "name");
+        const std::string* params = event.getAttribute("params");
+        if (params != nullptr)
+            parseParams(*params, event, macro->params);
+        recordChildren(source, macro->body);
+        macros_[macro->name] = macro;
+    }
+
+    //params look like "a b:=1 c:=^ d:=^|2 e:='some text' *block **content"
+    void parseParams(const std::string& text, const XmlEvent& event, vector<Macro::Param>& params)
+    {
+        size_t i = 0;
+        while (i < text.size()) {
+            if (std::isspace(static_cast<unsigned char>(text[i]))) {
+                ++i;
+                continue;
+            }
+            Macro::Param param;
+            while (i < text.size() && text[i] == '*') {
+                ++param.block_stars;
+                ++i;
+            }
+            if (param.block_stars > 2)
+                context_.fail(event, "invalid macro parameter in '" + text + "'");
+            size_t name_start = i;
+            while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i])) && text[i] != ':' && text[i] != '=')
+                ++i;
+            param.name = text.substr(name_start, i - name_start);
+            if (param.name.empty())
+                context_.fail(event, "invalid macro parameter in '" + text + "'");
+
+            if (i < text.size() && (text[i] == ':' || text[i] == '=')) {
+                if (param.block_stars > 0)
+                    context_.fail(event, "block parameter '" + param.name + "' cannot have a default");
+                i += text[i] == ':' ? 2 : 1;
+                if (i < text.size() && text[i] == '^') {
+                    param.from_parent = true;
+                    ++i;
+                    if (i < text.size() && text[i] == '|')
+                        ++i;
+                    else {
+                        params.push_back(param);
+                        continue;
+                    }
+                }
+                param.has_default = true;
+                if (i < text.size() && (text[i] == '\'' || text[i] == '"')) {
+                    size_t end = text.find(text[i], i + 1);
+                    if (end == std::string::npos)
+                        context_.fail(event, "unterminated default for macro parameter '" + param.name + "'");
+                    param.default_value = text.substr(i + 1, end - i - 1);
+                    i = end + 1;
+                }
+                else {
+                    size_t value_start = i;
+                    while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i])))
+                        ++i;
+                    param.default_value = text.substr(value_start, i - value_start);
+                }
+            }
+            params.push_back(param);
+        }
+    }
+
+    void callMacro(const Macro& macro, const XmlEvent& call, EventSource& source, Scope& scope)
+    {
+        if (context_.getMacroDepth() >= MaxMacroDepth)
+            context_.fail(call, "macros are nested too deeply, is '" + macro.name + "' recursive?");
+
+        Scope local;
+        local.parent = &scope;
+        for (const auto& attribute : call.attributes) {
+            auto param = std::find_if(macro.params.begin(), macro.params.end(),
+                [&attribute](const Macro::Param& p) { return p.name == attribute.first && p.block_stars == 0; });
+            if (param == macro.params.end())
+                context_.fail(call, "macro '" + macro.name + "' has no parameter '" + attribute.first + "'");
+            local.properties[attribute.first] = substitute(attribute.second, scope, call);
+        }
+
+        //block parameters take the child elements in order
+        vector<std::shared_ptr<vector<XmlEvent>>> children;
+        XmlEvent event;
+        while (source.next(event) && event.type == XmlEvent::Type::Start) {
+            auto child = std::make_shared<vector<XmlEvent>>();
+            child->push_back(event);
+            recordChildren(source, *child);
+            XmlEvent end = event;
+            end.type = XmlEvent::Type::End;
+            end.attributes.clear();
+            child->push_back(end);
+            children.push_back(child);
+        }
+
+        size_t next_child = 0;
+        for (const auto& param : macro.params) {
+            if (param.block_stars > 0) {
+                if (next_child >= children.size())
+                    context_.fail(call, "macro '" + macro.name + "' expects an element for block parameter '" + param.name + "'");
+                auto block = children[next_child++];
+                if (param.block_stars == 2)
+                    block = std::make_shared<vector<XmlEvent>>(block->begin() + 1, block->end() - 1);
+                local.blocks[param.name] = block;
+            }
+            else if (local.properties.find(param.name) == local.properties.end()) {
+                const std::string* parent_value = param.from_parent ? scope.findProperty(param.name) : nullptr;
+                if (parent_value != nullptr)
+                    local.properties[param.name] = *parent_value;
+                else if (param.has_default)
+                    local.properties[param.name] = substitute(param.default_value, scope, call);
+                else
+                    context_.fail(call, "macro '" + macro.name + "' is missing parameter '" + param.name + "'");
+            }
+        }
+        if (next_child < children.size())
+            context_.warn(call.file, call.line, "macro '" + macro.name + "' ignores " + std::to_string(children.size() - next_child) + " child elements");
+
+        context_.pushMacroCall(macro.name, call);
+        RecordedSource body(macro.body);
+        expandChildren(body, local);
+        context_.popMacroCall();
+    }
+
+    void include(const XmlEvent& event, EventSource& source, Scope& scope)
+    {
+        if (include_depth_ >= MaxIncludeDepth)
+            context_.fail(event, "includes are nested too deeply");
+
+        std::string file_name = substitute(requireAttribute(event, "filename"), scope, event);
+        bool absolute = !file_name.empty() && (file_name[0] == '/' || file_name[0] == '\\'
+            || (file_name.size() > 1 && file_name[1] == ':'));
+        if (!absolute) {
+            size_t separator = event.file->find_last_of("/\\");
+            if (separator != std::string::npos)
+                file_name = event.file->substr(0, separator + 1) + file_name;
+        }
+
+        std::string text;
+        if (!readFile(file_name, text))
+            context_.fail(event, "cannot open included file " + file_name);
+
+        //the children of the included root element are inserted in place
+        ++include_depth_;
+        XmlReader reader(text, context_.addFile(file_name), context_);
+        XmlEvent root;
+        reader.next(root);
+        expandChildren(reader, scope);
+        XmlEvent rest;
+        if (reader.next(rest))
+            context_.fail(rest, "content after the root element");
+        --include_depth_;
+
+        skipChildren(source);
+    }
+
+public:
+    static bool readFile(const std::string& file_path, std::string& text)
+    {
+        std::ifstream file(file_path, std::ios::binary);
+        if (!file)
+            return false;
+        std::ostringstream stream;
+        stream << file.rdbuf();
+        text = stream.str();
+        return true;
+    }
+
+private:
+    ParseContext& context_;
+    ElementHandler& handler_;
+    std::map<std::string, std::string> args_;
+    const std::map<std::string, std::string>& package_paths_;
+    std::unordered_map<std::string, std::shared_ptr<const Macro>> macros_;
+    uint depth_ = 0;
+    uint include_depth_ = 0;
+    size_t expanded_elements_ = 0;
+};
+
+//one expanded top level element with its children
+struct Element {
+    std::string name;
+    vector<std::pair<std::string, std::string>> attributes;
+    vector<Element> children;
+    const std::string* file;
+    uint line;
+
+    const std::string* getAttribute(const char* attribute_name) const
+    {
+        for (const auto& attribute : attributes)
+            if (attribute.first == attribute_name)
+                return &attribute.second;
+        return nullptr;
+    }
+};
+
+/*
+    Builds the robot from expanded elements. Only one top level element is kept in memory at a time, it is parsed
+    as soon as it is closed.
+*/
+class UrdfBuilder : public ElementHandler {
+public:
+    UrdfBuilder(ParseContext& context, const std::string* file, UrdfRobot& robot)
+        : context_(context), file_(file), robot_(robot)
+    {
+    }
+
+    virtual void startElement(const XmlEvent& event) override
+    {
+        Element* parent = open_.empty() ? nullptr : open_.back();
+        Element* element;
+        if (parent == nullptr) {
+            current_ = Element();
+            element = &current_;
+        }
+        else {
+            parent->children.emplace_back();
+            element = &parent->children.back();
+        }
+        element->name = event.name;
+        element->attributes = event.attributes;
+        element->file = event.file;
+        element->line = event.line;
+        open_.push_back(element);
+    }
+
+    virtual void endElement() override
+    {
+        open_.pop_back();
+        if (open_.empty())
+            parseTopLevel(current_);
+    }
+
+    void finish()
+    {
+        for (const auto& inline_material : inline_materials_)
+            if (robot_.materials.find(inline_material.name) == robot_.materials.end())
+                robot_.materials[inline_material.name] = inline_material;
+        validate();
+    }
+
+private:
+    [[noreturn]] void fail(const Element& element, const std::string& message) const
+    {
+        context_.fail(element.file, element.line, message);
+    }
+
+    void warnUnknown(const Element& element, const std::string& parent)
+    {
+        context_.warn(element.file, element.line, "ignoring unknown element <" + element.name + "> in " + parent);
+    }
+
+    static std::string quote(const std::string& name)
+    {
+        return "'" + name + "'";
+    }
+
+    const std::string& requireAttribute(const Element& element, const char* name) const
+    {
+        const std::string* value = element.getAttribute(name);
+        if (value == nullptr)
+            fail(element, "<" + element.name + "> is missing the '" + name + "' attribute");
+        return *value;
+    }
+
+    real_T toReal(const Element& element, const char* attribute, const std::string& text) const
+    {
+        double value;
+        if (!parseNumber(text, value))
+            fail(element, Utils::stringf("attribute '%s' of <%s> is not a number: '%s'", attribute, element.name.c_str(), text.c_str()));
+        return static_cast<real_T>(value);
+    }
+
+    real_T getReal(const Element& element, const char* attribute, real_T default_value) const
+    {
+        const std::string* text = element.getAttribute(attribute);
+        return text == nullptr ? default_value : toReal(element, attribute, *text);
+    }
+
+    void toReals(const Element& element, const char* attribute, const std::string& text, real_T* values, int count) const
+    {
+        const char* c = text.c_str();
+        int found = 0;
+        for (;;) {
+            while (*c == ' ' || *c == '\t' || *c == '\n' || *c == '\r')
+                ++c;
+            if (*c == '\0')
+                break;
+            char* end;
+            double value = std::strtod(c, &end);
+            if (end == c || (*end != '\0' && *end != ' ' && *end != '\t' && *end != '\n' && *end != '\r'))
+                fail(element, Utils::stringf("attribute '%s' of <%s> is not a list of numbers: '%s'", attribute, element.name.c_str(), text.c_str()));
+            if (found < count)
+                values[found] = static_cast<real_T>(value);
+            ++found;
+            c = end;
+        }
+        if (found != count)
+            fail(element, Utils::stringf("attribute '%s' of <%s> must have %d numbers: '%s'", attribute, element.name.c_str(), count, text.c_str()));
+    }
+
+    Vector3r toVector(const Element& element, const char* attribute, const std::string& text) const
+    {
+        real_T values[3];
+        toReals(element, attribute, text, values, 3);
+        return Vector3r(values[0], values[1], values[2]);
+    }
+
+    Vector3r getVector(const Element& element, const char* attribute, const Vector3r& default_value) const
+    {
+        const std::string* text = element.getAttribute(attribute);
+        return text == nullptr ? default_value : toVector(element, attribute, *text);
+    }
+
+    //checks that an optional child appears at most once
+    const Element* once(const Element* found, const Element& child, const std::string& owner) const
+    {
+        if (found != nullptr)
+            fail(child, "multiple <" + child.name + "> elements in " + owner);
+        return &child;
+    }
+
+    void parseTopLevel(const Element& element)
+    {
+        if (element.name == "link")
+            add(robot_.links, parseLink(element), "links", element);
+        else if (element.name == "joint")
+            add(robot_.joints, parseJoint(element), "joints", element);
+        else if (element.name == "force")
+            add(robot_.forces, parseForce(element), "forces", element);
+        else if (element.name == "material")
+            add(robot_.materials, parseMaterial(element), "materials", element);
+        else
+            warnUnknown(element, "robot");
+    }
+
+    template<typename T>
+    void add(std::map<std::string, T>& items, T&& item, const char* kind, const Element& element)
+    {
+        auto existing = items.find(item.name);
+        if (existing != items.end())
+            fail(element, Utils::stringf("multiple %s with name '%s', the first is on line %u", kind, item.name.c_str(), existing->second.line));
+        std::string name = item.name;
+        sources_[std::string(kind) + " " + name] = element.file;
+        items.emplace(name, std::move(item));
+    }
+
+    UrdfOrigin parseOrigin(const Element& element) const
+    {
+        UrdfOrigin origin;
+        origin.xyz = getVector(element, "xyz", origin.xyz);
+        origin.rpy = getVector(element, "rpy", origin.rpy);
+        return origin;
+    }
+
+    UrdfLink parseLink(const Element& element)
+    {
+        UrdfLink link;
+        link.name = requireAttribute(element, "name");
+        link.line = element.line;
+        const std::string owner = "link " + quote(link.name);
+
+        const Element *inertial = nullptr, *visual = nullptr, *collision = nullptr;
+        for (const Element& child : element.children) {
+            if (child.name == "inertial")
+                inertial = once(inertial, child, owner);
+            else if (child.name == "visual") {
+                if (visual != nullptr)
+                    fail(child, "multiple visual elements in " + owner + ". Although this is technically allowed, limitations in the Unreal engine prevent us from efficiently implementing this. Please re-write as a series of multiple links with FIXED joint constraints.");
+                visual = &child;
+            }
+            else if (child.name == "collision") {
+                if (collision != nullptr)
+                    fail(child, "multiple collision elements in " + owner + ". Although this is technically allowed, limitations in the Unreal engine prevent us from efficiently implementing this. Please re-write as a series of multiple links with FIXED joint constraints.");
+                collision = &child;
+            }
+            else
+                warnUnknown(child, owner);
+        }
+
+        if (inertial == nullptr)
+            fail(element, "no inertial element in " + owner);
+        if (visual == nullptr && collision == nullptr)
+            fail(element, "no visual or collision element in " + owner);
+
+        link.inertial = parseInertial(*inertial, owner);
+        if (visual != nullptr) {
+            link.has_visual = true;
+            link.visual = parseVisual(*visual, owner);
+        }
+        if (collision != nullptr) {
+            link.has_collision = true;
+            link.collision = parseCollision(*collision, owner);
+        }
+        return link;
+    }
+
+    UrdfInertial parseInertial(const Element& element, const std::string& owner)
+    {
+        UrdfInertial inertial;
+        const Element *origin = nullptr, *mass = nullptr, *inertia = nullptr;
+        for (const Element& child : element.children) {
+            if (child.name == "origin")
+                origin = once(origin, child, "the inertial of " + owner);
+            else if (child.name == "mass")
+                mass = once(mass, child, "the inertial of " + owner);
+            else if (child.name == "inertia")
+                inertia = once(inertia, child, "the inertial of " + owner);
+            else
+                warnUnknown(child, "the inertial of " + owner);
+        }
+        if (mass == nullptr)
+            fail(element, "no mass element in the inertial of " + owner);
+        if (inertia == nullptr)
+            fail(element, "no inertia element in the inertial of " + owner);
+
+        if (origin != nullptr)
+            inertial.origin = parseOrigin(*origin);
+        inertial.mass = toReal(*mass, "value", requireAttribute(*mass, "value"));
+
+        const char* names[] = { "ixx", "ixy", "ixz", "iyy", "iyz", "izz" };
+        real_T values[6];
+        for (int i = 0; i < 6; ++i)
+            values[i] = toReal(*inertia, names[i], requireAttribute(*inertia, names[i]));
+        inertial.inertia << values[0], values[1], values[2],
+            values[1], values[3], values[4],
+            values[2], values[4], values[5];
+        return inertial;
+    }
+
+    UrdfVisual parseVisual(const Element& element, const std::string& owner)
+    {
+        UrdfVisual visual;
+        const std::string* name = element.getAttribute("name");
+        if (name != nullptr)
+            visual.name = *name;
+        const std::string visual_owner = "the visual of " + owner;
+
+        const Element *origin = nullptr, *geometry = nullptr, *material = nullptr;
+        for (const Element& child : element.children) {
+            if (child.name == "origin")
+                origin = once(origin, child, visual_owner);
+            else if (child.name == "geometry")
+                geometry = once(geometry, child, visual_owner);
+            else if (child.name == "material")
+                material = once(material, child, visual_owner);
+            else
+                warnUnknown(child, visual_owner);
+        }
+        if (geometry == nullptr)
+            fail(element, "no geometry element in " + visual_owner);
+
+        if (origin != nullptr)
+            visual.origin = parseOrigin(*origin);
+        visual.geometry = parseGeometry(*geometry, visual_owner);
+        if (material != nullptr) {
+            visual.material_name = requireAttribute(*material, "name");
+            //materials defined inside a visual are shared by name like top level ones
+            if (!material->children.empty())
+                inline_materials_.push_back(parseMaterial(*material));
+        }
+        return visual;
+    }
+
+    UrdfCollision parseCollision(const Element& element, const std::string& owner)
+    {
+        UrdfCollision collision;
+        const std::string* name = element.getAttribute("name");
+        if (name != nullptr)
+            collision.name = *name;
+        const std::string collision_owner = "the collision of " + owner;
+
+        const Element *origin = nullptr, *geometry = nullptr;
+        for (const Element& child : element.children) {
+            if (child.name == "origin")
+                origin = once(origin, child, collision_owner);
+            else if (child.name == "geometry")
+                geometry = once(geometry, child, collision_owner);
+            else
+                warnUnknown(child, collision_owner);
+        }
+        if (geometry == nullptr)
+            fail(element, "no geometry element in " + collision_owner);
+
+        if (origin != nullptr)
+            collision.origin = parseOrigin(*origin);
+        collision.geometry = parseGeometry(*geometry, collision_owner);
+        return collision;
+    }
+
+    UrdfGeometry parseGeometry(const Element& element, const std::string& owner) const
+    {
+        if (element.children.size() != 1)
+            fail(element, "the geometry of " + owner + " must have exactly one shape, found " + std::to_string(element.children.size()));
+
+        const Element& shape = element.children.front();
+        UrdfGeometry geometry;
+        if (shape.name == "box") {
+            geometry.type = UrdfGeometryType::Box;
+            geometry.size = toVector(shape, "size", requireAttribute(shape, "size"));
+        }
+        else if (shape.name == "cylinder") {
+            geometry.type = UrdfGeometryType::Cylinder;
+            geometry.radius = toReal(shape, "radius", requireAttribute(shape, "radius"));
+            geometry.length = toReal(shape, "length", requireAttribute(shape, "length"));
+        }
+        else if (shape.name == "sphere") {
+            geometry.type = UrdfGeometryType::Sphere;
+            geometry.radius = toReal(shape, "radius", requireAttribute(shape, "radius"));
+        }
+        else if (shape.name == "mesh") {
+            geometry.type = UrdfGeometryType::Mesh;
+            parseMesh(shape, geometry);
+        }
+        else
+            fail(shape, "unknown geometry <" + shape.name + "> in " + owner + ", valid shapes are box, cylinder, sphere and mesh");
+        return geometry;
+    }
+
+    void parseMesh(const Element& element, UrdfGeometry& geometry) const
+    {
+        //the standard filename attribute is accepted for location
+        const std::string* location = element.getAttribute("location");
+        if (location == nullptr)
+            location = element.getAttribute("filename");
+        if (location == nullptr)
+            fail(element, "no location for mesh");
+        geometry.mesh_location = *location;
+
+        const std::string& type = requireAttribute(element, "type");
+        if (type == "stl_ascii")
+            geometry.mesh_file_type = UrdfMeshFileType::StlAscii;
+        else if (type == "unreal_mesh")
+            geometry.mesh_file_type = UrdfMeshFileType::UnrealMesh;
+        else
+            fail(element, "unknown mesh type '" + type + "', valid types are 'stl_ascii' and 'unreal_mesh'");
+
+        const std::string* reverse_normals = element.getAttribute("reverse_normals");
+        geometry.reverse_normals = reverse_normals != nullptr && *reverse_normals == "true";
+        geometry.scale_factor = getReal(element, "scale_factor", geometry.scale_factor);
+        geometry.vhacd_concavity = getReal(element, "vhacd_concavity", static_cast<real_T>(geometry.vhacd_concavity));
+        geometry.vhacd_resolution = static_cast<uint>(getReal(element, "vhacd_resolution", static_cast<real_T>(geometry.vhacd_resolution)));
+        geometry.vhacd_max_num_vertices_per_ch = static_cast<uint>(getReal(element, "vhacd_max_num_vertices_per_ch",
+            static_cast<real_T>(geometry.vhacd_max_num_vertices_per_ch)));
+        geometry.vhacd_min_volume_per_ch = getReal(element, "vhacd_min_volume_per_ch", static_cast<real_T>(geometry.vhacd_min_volume_per_ch));
+        const std::string* output_folder = element.getAttribute("vhacd_output_folder_path");
+        if (output_folder != nullptr)
+            geometry.vhacd_output_folder_path = *output_folder;
+
+        const std::string* collision_type = element.getAttribute("dynamic_collision_type");
+        if (collision_type != nullptr) {
+            std::string lower = *collision_type;
+            std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+            if (lower == "bsp")
+                geometry.dynamic_collision_type = UrdfDynamicCollisionType::Bsp;
+            else if (lower == "vhacd")
+                geometry.dynamic_collision_type = UrdfDynamicCollisionType::Vhacd;
+            else if (lower == "manual")
+                geometry.dynamic_collision_type = UrdfDynamicCollisionType::Manual;
+            else
+                fail(element, "unknown dynamic_collision_type '" + *collision_type + "', valid types are 'bsp', 'vhacd' and 'manual'");
+        }
+    }
+
+    UrdfJoint parseJoint(const Element& element)
+    {
+        UrdfJoint joint;
+        joint.name = requireAttribute(element, "name");
+        joint.line = element.line;
+        const std::string owner = "joint " + quote(joint.name);
+
+        const std::string& type = requireAttribute(element, "type");
+        if (type == "revolute")
+            joint.type = UrdfJointType::Revolute;
+        else if (type == "continuous")
+            joint.type = UrdfJointType::Continuous;
+        else if (type == "prismatic")
+            joint.type = UrdfJointType::Prismatic;
+        else if (type == "fixed")
+            joint.type = UrdfJointType::Fixed;
+        else if (type == "floating")
+            joint.type = UrdfJointType::Floating;
+        else if (type == "planar")
+            joint.type = UrdfJointType::Planar;
+        else
+            fail(element, "unknown type '" + type + "' for " + owner);
+
+        const Element *origin = nullptr, *parent = nullptr, *child_link = nullptr, *axis = nullptr, *calibration = nullptr,
+            *dynamics = nullptr, *limit = nullptr, *mimic = nullptr, *safety_controller = nullptr, *actuator = nullptr;
+        for (const Element& child : element.children) {
+            if (child.name == "origin")
+                origin = once(origin, child, owner);
+            else if (child.name == "parent")
+                parent = once(parent, child, owner);
+            else if (child.name == "child")
+                child_link = once(child_link, child, owner);
+            else if (child.name == "axis")
+                axis = once(axis, child, owner);
+            else if (child.name == "calibration")
+                calibration = once(calibration, child, owner);
+            else if (child.name == "dynamics")
+                dynamics = once(dynamics, child, owner);
+            else if (child.name == "limit")
+                limit = once(limit, child, owner);
+            else if (child.name == "mimic")
+                mimic = once(mimic, child, owner);
+            else if (child.name == "safety_controller")
+                safety_controller = once(safety_controller, child, owner);
+            else if (child.name == "actuator")
+                actuator = once(actuator, child, owner);
+            else
+                warnUnknown(child, owner);
+        }
+
+        if (parent == nullptr)
+            fail(element, owner + " has no parent element");
+        if (child_link == nullptr)
+            fail(element, owner + " has no child element");
+        joint.parent_link = requireAttribute(*parent, "link");
+        joint.child_link = requireAttribute(*child_link, "link");
+
+        if (origin != nullptr)
+            joint.origin = parseOrigin(*origin);
+        if (axis != nullptr) {
+            joint.axis = getVector(*axis, "xyz", joint.axis);
+            joint.axis_rpy = getVector(*axis, "rpy", joint.axis_rpy);
+        }
+        if (calibration != nullptr) {
+            joint.has_calibration = true;
+            joint.calibration_rising = getReal(*calibration, "rising", joint.calibration_rising);
+            joint.calibration_falling = getReal(*calibration, "falling", joint.calibration_falling);
+        }
+        if (dynamics != nullptr) {
+            joint.damping = getReal(*dynamics, "damping", joint.damping);
+            joint.friction = getReal(*dynamics, "friction", joint.friction);
+        }
+        if (limit != nullptr) {
+            joint.has_limit = true;
+            joint.lower = getReal(*limit, "lower", joint.lower);
+            joint.upper = getReal(*limit, "upper", joint.upper);
+            joint.effort = toReal(*limit, "effort", requireAttribute(*limit, "effort"));
+            joint.velocity = toReal(*limit, "velocity", requireAttribute(*limit, "velocity"));
+        }
+        else if (joint.type == UrdfJointType::Revolute || joint.type == UrdfJointType::Prismatic)
+            fail(element, owner + " is of type '" + type + "', which needs a limit element");
+        if (mimic != nullptr) {
+            joint.has_mimic = true;
+            joint.mimic_joint = requireAttribute(*mimic, "joint");
+            joint.mimic_multiplier = getReal(*mimic, "multiplier", joint.mimic_multiplier);
+            joint.mimic_offset = getReal(*mimic, "offset", joint.mimic_offset);
+        }
+        if (safety_controller != nullptr) {
+            joint.has_safety_controller = true;
+            joint.soft_lower_limit = getReal(*safety_controller, "soft_lower_limit", joint.soft_lower_limit);
+            joint.soft_upper_limit = getReal(*safety_controller, "soft_upper_limit", joint.soft_upper_limit);
+            joint.k_position = getReal(*safety_controller, "k_position", joint.k_position);
+            joint.k_velocity = toReal(*safety_controller, "k_velocity", requireAttribute(*safety_controller, "k_velocity"));
+        }
+        if (actuator != nullptr) {
+            if (joint.type != UrdfJointType::Revolute && joint.type != UrdfJointType::Continuous && joint.type != UrdfJointType::Prismatic)
+                fail(*actuator, owner + " is of type '" + type + "', which can't have an actuator");
+            joint.has_actuator = true;
+            joint.actuator = parseActuator(*actuator, owner);
+        }
+        return joint;
+    }
+
+    UrdfActuator parseActuator(const Element& element, const std::string& owner)
+    {
+        UrdfActuator actuator;
+        actuator.voltage = getReal(element, "voltage", actuator.voltage);
+        actuator.resistance = getReal(element, "resistance", actuator.resistance);
+        actuator.inductance = getReal(element, "inductance", actuator.inductance);
+        actuator.torque_constant = getReal(element, "torque_constant", actuator.torque_constant);
+        actuator.current_limit = getReal(element, "current_limit", actuator.current_limit);
+        actuator.rotor_inertia = getReal(element, "rotor_inertia", actuator.rotor_inertia);
+        actuator.rotor_friction = getReal(element, "rotor_friction", actuator.rotor_friction);
+        actuator.gear_ratio = getReal(element, "gear_ratio", actuator.gear_ratio);
+        actuator.gear_efficiency = getReal(element, "gear_efficiency", actuator.gear_efficiency);
+        actuator.backlash = getReal(element, "backlash", actuator.backlash);
+        actuator.position_gain = getReal(element, "position_gain", actuator.position_gain);
+        actuator.velocity_gain = getReal(element, "velocity_gain", actuator.velocity_gain);
+
+        if (actuator.voltage <= 0 || actuator.resistance <= 0 || actuator.torque_constant <= 0 || actuator.gear_ratio <= 0)
+            fail(element, "the actuator of " + owner + " needs a positive voltage, resistance, torque_constant and gear_ratio");
+        if (actuator.gear_efficiency <= 0 || actuator.gear_efficiency > 1)
+            fail(element, "the actuator of " + owner + " has a gear_efficiency outside of (0, 1]");
+        if (actuator.inductance < 0 || actuator.current_limit < 0 || actuator.rotor_inertia < 0 || actuator.rotor_friction < 0
+            || actuator.backlash < 0 || actuator.position_gain < 0 || actuator.velocity_gain < 0)
+            fail(element, "the actuator of " + owner + " has a negative value");
+        return actuator;
+    }
+
+    UrdfForce parseForce(const Element& element)
+    {
+        UrdfForce force;
+        force.name = requireAttribute(element, "name");
+        force.line = element.line;
+
+        const std::string& type = requireAttribute(element, "type");
+        if (type == "angular" || type == "actuator")
+            force.type = UrdfForceType::Angular;
+        else if (type == "linear")
+            force.type = UrdfForceType::Linear;
+        else
+            fail(element, "unknown type '" + type + "' for force '" + force.name + "', valid types are 'angular', 'actuator' and 'linear'");
+
+        force.link_name = requireAttribute(element, "link_name");
+        force.axis = toVector(element, "axis", requireAttribute(element, "axis"));
+        if (force.type == UrdfForceType::Linear)
+            force.application_point = toVector(element, "application_point", requireAttribute(element, "application_point"));
+        for (const Element& child : element.children)
+            warnUnknown(child, "force " + quote(force.name));
+        return force;
+    }
+
+    UrdfMaterial parseMaterial(const Element& element)
+    {
+        UrdfMaterial material;
+        material.name = requireAttribute(element, "name");
+        material.line = element.line;
+        const std::string owner = "material " + quote(material.name);
+
+        for (const Element& child : element.children) {
+            if (child.name == "color") {
+                material.has_color = true;
+                toReals(child, "rgba", requireAttribute(child, "rgba"), material.color, 4);
+            }
+            else if (child.name == "unreal_material")
+                material.texture_file = requireAttribute(child, "path");
+            else if (child.name == "texture")
+                material.texture_file = requireAttribute(child, "filename");
+            else
+                warnUnknown(child, owner);
+        }
+        return material;
+    }
+
+    //includes may add elements, so remember which file each came from
+    const std::string* getSource(const char* kind, const std::string& name) const
+    {
+        return sources_.at(std::string(kind) + " " + name);
+    }
+
+    void validate()
+    {
+        std::map<std::string, const UrdfJoint*> parent_joints;
+        for (const auto& item : robot_.joints) {
+            const UrdfJoint& joint = item.second;
+            auto failJoint = [&](const std::string& message) {
+                context_.fail(getSource("joints", joint.name), joint.line, "joint '" + joint.name + "' " + message);
+            };
+            if (robot_.links.find(joint.parent_link) == robot_.links.end())
+                failJoint("references link '" + joint.parent_link + "' as the parent link, which does not exist");
+            if (robot_.links.find(joint.child_link) == robot_.links.end())
+                failJoint("references link '" + joint.child_link + "' as the child link, which does not exist");
+            if (joint.has_mimic && robot_.joints.find(joint.mimic_joint) == robot_.joints.end())
+                failJoint("references joint '" + joint.mimic_joint + "' as the mimic joint, which does not exist");
+
+            auto existing = parent_joints.find(joint.child_link);
+            if (existing != parent_joints.end())
+                context_.warn(getSource("joints", joint.name), joint.line, "link '" + joint.child_link + "' is also the child of joint '" + existing->second->name + "'");
+            else
+                parent_joints[joint.child_link] = &joint;
+        }
+
+        vector<std::string> roots;
+        for (const auto& item : robot_.links)
+            if (parent_joints.find(item.first) == parent_joints.end())
+                roots.push_back(item.first);
+        if (roots.empty())
+            throw std::runtime_error(*file_ + ": there is no root link, at least one link must not be the child of a joint");
+        if (roots.size() > 1) {
+            std::string names;
+            for (const auto& root : roots)
+                names += " '" + root + "'";
+            throw std::runtime_error(*file_ + ": there can only be one link without a parent, these links have none:" + names);
+        }
+        robot_.root_link = roots.front();
+
+        for (const auto& item : robot_.forces)
+            if (robot_.links.find(item.second.link_name) == robot_.links.end())
+                context_.fail(getSource("forces", item.first), item.second.line, "force '" + item.first + "' is attached to link '"
+                    + item.second.link_name + "', which does not exist");
+
+        for (const auto& item : robot_.links)
+            if (item.second.has_visual && !item.second.visual.material_name.empty()
+                && robot_.materials.find(item.second.visual.material_name) == robot_.materials.end())
+                context_.fail(getSource("links", item.first), item.second.line, "link '" + item.first + "' uses material '"
+                    + item.second.visual.material_name + "', which does not exist");
+    }
+
+private:
+    ParseContext& context_;
+    const std::string* file_;
+    UrdfRobot& robot_;
+    std::map<std::string, const std::string*> sources_;
+    Element current_;
+    vector<Element*> open_;
+    vector<UrdfMaterial> inline_materials_;
+};
+
+} //namespace
+
+std::string UrdfParser::Diagnostic::toString() const
+{
+    return Utils::stringf("%s:%u: %s", file.c_str(), line, message.c_str());
+}
+
+struct UrdfParser::impl {
+    std::map<std::string, std::string> args;
+    std::map<std::string, std::string> package_paths;
+    vector<Diagnostic> warnings;
+};
+
+UrdfParser::UrdfParser()
+    : pimpl_(new impl())
+{
+}
+
+UrdfParser::~UrdfParser() = default;
+
+void UrdfParser::setArgument(const std::string& name, const std::string& value)
+{
+    pimpl_->args[name] = value;
+}
+
+void UrdfParser::setPackagePath(const std::string& package, const std::string& path)
+{
+    pimpl_->package_paths[package] = path;
+}
+
+UrdfRobot UrdfParser::parseFile(const std::string& file_path)
+{
+    std::string text;
+    if (!XacroExpander::readFile(file_path, text))
+        throw std::runtime_error("Cannot open URDF file " + file_path);
+    return parseString(text, file_path);
+}
+
+UrdfRobot UrdfParser::parseString(const std::string& xml, const std::string& file_name)
+{
+    ParseContext context;
+    const std::string* file = context.addFile(file_name);
+    UrdfRobot robot;
+    UrdfBuilder builder(context, file, robot);
+    XacroExpander expander(context, builder, pimpl_->args, pimpl_->package_paths);
+    Scope global;
+
+    XmlReader reader(xml, file, context);
+    XmlEvent root;
+    reader.next(root);
+    if (root.name != "robot")
+        context.fail(root, "the root element must be <robot>, found <" + root.name + ">");
+
+    expander.expandChildren(reader, global);
+    XmlEvent rest;
+    if (reader.next(rest))
+        context.fail(rest, "content after the root element");
+    //like xacro, attributes of the root see every property in the document
+    const std::string* name = root.getAttribute("name");
+    if (name != nullptr)
+        robot.name = expander.substitute(*name, global, root);
+    builder.finish();
+
+    pimpl_->warnings = std::move(context.warnings);
+    return robot;
+}
+
+const vector<UrdfParser::Diagnostic>& UrdfParser::getWarnings() const
+{
+    return pimpl_->warnings;
+}
+
+std::string UrdfParser::describe(const UrdfRobot& robot)
+{
+    std::ostringstream text;
+    auto number = [](double value) { return Utils::stringf("%g", value); };
+    auto vector3 = [&number](const Vector3r& v) { return number(v.x()) + " " + number(v.y()) + " " + number(v.z()); };
+    auto origin = [&vector3](const UrdfOrigin& o) { return "xyz " + vector3(o.xyz) + " rpy " + vector3(o.rpy); };
+    auto geometry = [&](const UrdfGeometry& g) {
+        switch (g.type) {
+        case UrdfGeometryType::Box: return "box " + vector3(g.size);
+        case UrdfGeometryType::Sphere: return "sphere " + number(g.radius);
+        case UrdfGeometryType::Cylinder: return "cylinder " + number(g.radius) + " " + number(g.length);
+        default:
+            return "mesh " + g.mesh_location + (g.mesh_file_type == UrdfMeshFileType::StlAscii ? " stl_ascii" : " unreal_mesh")
+                + " scale " + number(g.scale_factor) + (g.reverse_normals ? " reversed" : "")
+                + " collision " + std::to_string(static_cast<int>(g.dynamic_collision_type));
+        }
+    };
+    const char* joint_types[] = { "revolute", "continuous", "prismatic", "fixed", "floating", "planar" };
+
+    text << "robot " << robot.name << " root " << robot.root_link << "\n";
+    for (const auto& item : robot.materials) {
+        const UrdfMaterial& m = item.second;
+        text << "material " << m.name;
+        if (m.has_color)
+            text << " rgba " << number(m.color[0]) << " " << number(m.color[1]) << " " << number(m.color[2]) << " " << number(m.color[3]);
+        if (!m.texture_file.empty())
+            text << " texture " << m.texture_file;
+        text << "\n";
+    }
+    for (const auto& item : robot.links) {
+        const UrdfLink& l = item.second;
+        const Matrix3x3r& inertia = l.inertial.inertia;
+        text << "link " << l.name << "\n  inertial " << origin(l.inertial.origin) << " mass " << number(l.inertial.mass)
+            << " inertia " << number(inertia(0, 0)) << " " << number(inertia(0, 1)) << " " << number(inertia(0, 2))
+            << " " << number(inertia(1, 1)) << " " << number(inertia(1, 2)) << " " << number(inertia(2, 2)) << "\n";
+        if (l.has_visual)
+            text << "  visual " << l.visual.name << " " << origin(l.visual.origin) << " " << geometry(l.visual.geometry)
+                << (l.visual.material_name.empty() ? "" : " material " + l.visual.material_name) << "\n";
+        if (l.has_collision)
+            text << "  collision " << l.collision.name << " " << origin(l.collision.origin) << " " << geometry(l.collision.geometry) << "\n";
+    }
+    for (const auto& item : robot.joints) {
+        const UrdfJoint& j = item.second;
+        text << "joint " << j.name << " " << joint_types[static_cast<int>(j.type)] << " " << j.parent_link << " -> " << j.child_link
+            << " " << origin(j.origin) << " axis " << vector3(j.axis) << " rpy " << vector3(j.axis_rpy)
+            << " damping " << number(j.damping) << " friction " << number(j.friction) << "\n";
+        if (j.has_limit)
+            text << "  limit " << number(j.lower) << " " << number(j.upper) << " effort " << number(j.effort) << " velocity " << number(j.velocity) << "\n";
+        if (j.has_calibration)
+            text << "  calibration " << number(j.calibration_rising) << " " << number(j.calibration_falling) << "\n";
+        if (j.has_mimic)
+            text << "  mimic " << j.mimic_joint << " " << number(j.mimic_multiplier) << " " << number(j.mimic_offset) << "\n";
+        if (j.has_safety_controller)
+            text << "  safety " << number(j.soft_lower_limit) << " " << number(j.soft_upper_limit)
+                << " " << number(j.k_position) << " " << number(j.k_velocity) << "\n";
+        if (j.has_actuator) {
+            const UrdfActuator& a = j.actuator;
+            text << "  actuator " << number(a.voltage) << " V " << number(a.resistance) << " ohm " << number(a.inductance) << " H "
+                << number(a.torque_constant) << " Nm/A limit " << number(a.current_limit) << " A rotor " << number(a.rotor_inertia)
+                << " " << number(a.rotor_friction) << " gear " << number(a.gear_ratio) << " " << number(a.gear_efficiency)
+                << " backlash " << number(a.backlash) << " gains " << number(a.position_gain) << " " << number(a.velocity_gain) << "\n";
+        }
+    }
+    for (const auto& item : robot.forces) {
+        const UrdfForce& f = item.second;
+        text << "force " << f.name << (f.type == UrdfForceType::Angular ? " angular " : " linear ") << f.link_name
+            << " axis " << vector3(f.axis);
+        if (f.type == UrdfForceType::Linear)
+            text << " at " << vector3(f.application_point);
+        text << "\n";
+    }
+    return text.str();
+}
+
+}} //namespace
+
+#endif
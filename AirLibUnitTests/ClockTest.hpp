@@ -0,0 +1,147 @@
+#ifndef msr_AirLibUnitTests_ClockTest_hpp
+#define msr_AirLibUnitTests_ClockTest_hpp
+
+#include "TestBase.hpp"
+#include "common/MonotonicClock.hpp"
+#include "common/ScalableClock.hpp"
+#include "physics/World.hpp"
+#include <thread>
+#include <chrono>
+
+namespace msr { namespace airlib {
+
+class ClockTest : public TestBase {
+    //remembers which clock it was updated with
+    class ClockReader : public UpdatableObject {
+    public:
+        virtual void update() override
+        {
+            UpdatableObject::update();
+            seen = clock();
+            seen_now = clock()->nowNanos();
+        }
+
+        const ClockBase* seen = nullptr;
+        TTimePoint seen_now = 0;
+    };
+
+public:
+    virtual void run() override
+    {
+        testMonotonic();
+        testRateChange();
+        testWorldDomain();
+        testProcessDomain();
+    }
+
+private:
+    void testMonotonic()
+    {
+        MonotonicClock clock(1, 1000);
+        testAssert(clock.nowNanos() == 1000 && clock.getStart() == 1000, "MonotonicClock should start at the given time");
+
+        TTimePoint last = clock.nowNanos();
+        for (int i = 0; i < 10000; ++i) {
+            TTimePoint now = clock.step();
+            testAssert(now >= last, "MonotonicClock went backwards");
+            testAssert(clock.nowNanos() == now, "MonotonicClock should return the time of the last step");
+            last = now;
+        }
+        testAssert(clock.getStepCount() == 10000, "MonotonicClock did not count its steps");
+
+        //time read between ticks doesn't move
+        TTimePoint tick = clock.step();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        testAssert(clock.nowNanos() == tick, "MonotonicClock moved between ticks");
+        testAssert(clock.sampleNanos() > tick, "MonotonicClock source did not move");
+
+        ScalableClock scalable;
+        TTimePoint scalable_last = scalable.nowNanos();
+        for (int i = 0; i < 10000; ++i) {
+            TTimePoint now = scalable.nowNanos();
+            testAssert(now >= scalable_last, "ScalableClock went backwards");
+            scalable_last = now;
+        }
+    }
+
+    void testRateChange()
+    {
+        MonotonicClock clock(1, 1000);
+
+        //switching speed keeps the simulation time where it was
+        for (double speed : { 10.0, 0.1, 3.0, 1.0 }) {
+            TTimePoint before = clock.sampleNanos();
+            clock.setSpeed(speed);
+            TTimePoint after = clock.sampleNanos();
+            testAssert(after >= before && after - before < 50000000, "simulation time jumped on speed change");
+        }
+
+        clock.setSpeed(4);
+        TTimePoint start = clock.step();
+        auto wall_start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        TTimePoint end = clock.step();
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+        double ratio = ClockBase::elapsedBetween(end, start) / wall;
+        testAssert(ratio > 3.5 && ratio < 4.5, Utils::stringf("clock at speed 4 ran at %f", ratio));
+
+        //speed 0 stops the simulation
+        clock.setSpeed(0);
+        TTimePoint frozen = clock.step();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        testAssert(clock.step() == frozen, "clock at speed 0 moved");
+
+        clock.setSpeed(1);
+        testAssert(clock.step() >= frozen, "clock went backwards after restarting");
+
+        bool thrown = false;
+        try {
+            clock.setSpeed(-1);
+        }
+        catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        testAssert(thrown, "negative clock speed was accepted");
+    }
+
+    void testWorldDomain()
+    {
+        auto domain = std::make_shared<MonotonicClock>(2, 5000);
+        World world(nullptr, domain);
+        ClockReader reader;
+        world.insert(&reader);
+        world.reset();
+        world.update();
+
+        testAssert(reader.seen == domain.get(), "world members were not updated with the world clock");
+        testAssert(reader.seen_now == domain->nowNanos(), "world members saw a different time than the tick");
+        testAssert(domain->getStepCount() == 1, "world did not step its clock");
+        testAssert(ClockFactory::get() != domain.get(), "world clock leaked out of the update");
+    }
+
+    void testProcessDomain()
+    {
+        //same setup as the simulator, the world clock is also the process clock
+        auto domain = std::make_shared<MonotonicClock>(1, 5000);
+        ClockFactory::get(domain);
+        World world(nullptr, domain);
+        world.reset();
+        world.update();
+
+        TTimePoint tick = domain->nowNanos();
+        ClockBase* api_clock = nullptr;
+        TTimePoint api_now = 0;
+        std::thread api_thread([&]() {
+            api_clock = ClockFactory::get();
+            api_now = api_clock->nowNanos();
+        });
+        api_thread.join();
+        testAssert(api_clock == domain.get(), "other threads did not see the world clock");
+        testAssert(api_now == tick, "other threads saw a different time than the last tick");
+
+        ClockFactory::get(std::make_shared<ScalableClock>());
+    }
+};
+
+}}
+#endif
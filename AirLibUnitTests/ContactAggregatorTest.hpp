@@ -0,0 +1,188 @@
+#ifndef msr_AirLibUnitTests_ContactAggregatorTest_hpp
+#define msr_AirLibUnitTests_ContactAggregatorTest_hpp
+
+#include "TestBase.hpp"
+#include "common/SteppableClock.hpp"
+#include "common/common_utils/Timer.hpp"
+#include "sensors/contact/ContactSimple.hpp"
+#include "vehicles/urdfbot/ContactAggregator.hpp"
+
+namespace msr { namespace airlib {
+
+class ContactAggregatorTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testFilterCache();
+        testAggregation();
+        testErrors();
+        testSensor();
+        benchmark();
+    }
+
+private:
+    static ContactAggregator makeAggregator()
+    {
+        ContactAggregator contacts({ "base", "wheel", "gripper" });
+        contacts.addFilter("wheel", "^Floor");
+        contacts.addFilter("wheel", "Ramp_[0-9]+");
+        return contacts;
+    }
+
+    void testFilterCache()
+    {
+        ContactAggregator contacts = makeAggregator();
+        int lookups = 0;
+        auto name = [&](const std::string& value) {
+            return [&lookups, value] { ++lookups; return value; };
+        };
+
+        const uint wheel = contacts.getLinkIndex("wheel");
+        for (int i = 0; i < 100; ++i) {
+            testAssert(contacts.isFiltered(wheel, 7, name("Floor_12")), "floor should be filtered for the wheel");
+            testAssert(contacts.isFiltered(wheel, 8, name("Big_Ramp_3")), "patterns should match anywhere in the name");
+            testAssert(!contacts.isFiltered(wheel, 9, name("Wall")), "other objects should pass");
+        }
+        testAssert(lookups == 3 && contacts.getFilterCacheSize() == 3, "each pair should be matched once");
+
+        //links without filters never look at names
+        testAssert(!contacts.isFiltered(contacts.getLinkIndex("gripper"), 7, name("Floor_12")), "gripper has no filters");
+        testAssert(lookups == 3, "a link without filters should not match names");
+
+        contacts.clearFilterCache();
+        testAssert(contacts.isFiltered(wheel, 7, name("Floor_12")) && lookups == 4, "clearing the cache should match again");
+    }
+
+    void testAggregation()
+    {
+        ContactAggregator contacts = makeAggregator();
+        const uint wheel = contacts.getLinkIndex("wheel"), gripper = contacts.getLinkIndex("gripper");
+        auto floor = [] { return std::string("Floor"); };
+        auto box = [] { return std::string("Box"); };
+
+        testAssert(contacts.addHit(gripper, 1, box, Vector3r(1, 0, 0), Vector3r(0, 0, 2)), "first hit of the step should be reported");
+        testAssert(!contacts.addHit(gripper, 1, box, Vector3r(3, 2, 0), Vector3r(0, 1, 2)), "later hits of the step should not be reported");
+        testAssert(!contacts.addHit(wheel, 2, floor, Vector3r(5, 5, 5), Vector3r(9, 9, 9)), "filtered hits should be dropped");
+        testAssert(contacts.addHit(wheel, 1, box, Vector3r(0, 0, 1), Vector3r(0, 0, 1)), "wheel should report the box");
+
+        testAssert(contacts.getStepContacts(gripper).count == 0, "summaries should only change at the end of a step");
+        contacts.endStep();
+
+        const auto& summary = contacts.getStepContacts(gripper);
+        testAssert(summary.count == 2, "gripper should have two hits");
+        testAssert(summary.normal_impulse == Vector3r(0, 1, 4), "impulses should be summed");
+        testAssert(summary.centroid == Vector3r(2, 1, 0), "centroid should be the mean location");
+        testAssert(contacts.getStepContacts(wheel).count == 1, "filtered hits should not count");
+
+        contacts.endStep();
+        testAssert(contacts.getStepContacts(gripper).count == 0 && contacts.getStepContacts(gripper).centroid == Vector3r::Zero(), "an empty step should clear the summary");
+        testAssert(contacts.addHit(gripper, 1, box, Vector3r(0, 0, 0), Vector3r(0, 0, 1)), "a new step should report its first hit again");
+        contacts.endStep();
+
+        ContactBase::ContactTotals totals;
+        testAssert(contacts.getTotals("gripper", totals) && totals.count == 3 && totals.normal_impulse.z() == 5, "totals should keep every step");
+        testAssert(!contacts.getTotals("arm", totals), "unknown links have no totals");
+
+        contacts.reset();
+        contacts.getTotals("gripper", totals);
+        testAssert(totals.count == 0 && contacts.getFilterCacheSize() == 2, "reset should clear totals but keep filter decisions");
+    }
+
+    void testErrors()
+    {
+        ContactAggregator contacts = makeAggregator();
+        expectError([&] { contacts.addFilter("arm", "x"); }, "does not have");
+        expectError([&] { contacts.addFilter("base", "(unclosed"); }, "not a valid regular expression");
+    }
+
+    //a sensor at 20 Hz sees every hit of the 1 kHz steps between its samples
+    void testSensor()
+    {
+        SteppableClock clock(1E-3f, 1000000000);
+        ClockFactory::DomainScope clock_scope(&clock);
+
+        ContactAggregator contacts = makeAggregator();
+        AirSimSettings::ContactSetting setting;
+        setting.update_frequency = 20;
+        setting.links = { "gripper", "wheel" };
+        ContactSimple sensor(setting);
+        sensor.setContactProvider([&](const std::string& link_name, ContactBase::ContactTotals& totals) {
+            return contacts.getTotals(link_name, totals);
+        });
+        contacts.reset();
+        sensor.reset();
+
+        const uint gripper = contacts.getLinkIndex("gripper"), wheel = contacts.getLinkIndex("wheel");
+        auto box = [] { return std::string("Box"); };
+        auto floor = [] { return std::string("Floor"); };
+        //hits are counted from the reset
+        TTimePoint last_stamp = clock.nowNanos();
+        int samples = 0;
+        uint reported_hits = 0;
+        for (int step = 1; step <= 1000; ++step) {
+            clock.step();
+            //one gripper hit every step, wheel hits every other step but only on the floor
+            contacts.addHit(gripper, 1, box, Vector3r(0.1f, 0, static_cast<real_T>(step % 2)), Vector3r(0, 0, 0.5f));
+            if (step % 2 == 0)
+                contacts.addHit(wheel, 2, floor, Vector3r::Zero(), Vector3r(0, 0, 1));
+            contacts.endStep();
+            sensor.update();
+
+            const auto& output = sensor.getOutput();
+            if (!output.is_valid || output.time_stamp == last_stamp)
+                continue;
+            uint steps = static_cast<uint>(std::round(ClockBase::elapsedBetween(output.time_stamp, last_stamp) / 1E-3));
+            last_stamp = output.time_stamp;
+            ++samples;
+
+            uint count = output.counts[0];
+            testAssert(count == steps, Utils::stringf("expected %u gripper hits since the last sample, got %u", steps, count));
+            reported_hits += count;
+            testAssert(std::abs(ContactBase::getVector(output.normal_impulses, 0).z() - 0.5f * count) < 1E-3f, "impulse should be summed over the sample");
+            Vector3r centroid = ContactBase::getVector(output.centroids, 0);
+            testAssert(std::abs(centroid.x() - 0.1f) < 1E-5f && std::abs(centroid.z() - 0.5f) <= 0.5f / count + 1E-5f, "centroid should average the sample");
+            testAssert(output.counts[1] == 0, "filtered wheel hits should not be reported");
+        }
+        testAssert(sensor.getOutput().is_valid, "sensor should read the aggregator");
+        testAssert(samples >= 19 && samples <= 20, Utils::stringf("expected 20 samples in 1 s, got %d", samples));
+        testAssert(reported_hits == static_cast<uint>(std::round(ClockBase::elapsedBetween(last_stamp, clock.getStart()) / 1E-3)), "every hit up to the last sample should be reported once");
+        testAssert(sensor.read().at("Contact-gripper-count") == sensor.getOutput().counts[0], "read() should flatten the arrays");
+    }
+
+    void benchmark()
+    {
+        ContactAggregator contacts = makeAggregator();
+        const uint wheel = contacts.getLinkIndex("wheel");
+        const int hits = 2000000;
+        uint32_t other_ids = 64;
+        common_utils::Timer timer;
+        timer.start();
+        uint reported = 0;
+        for (int i = 0; i < hits; ++i) {
+            uint32_t other = static_cast<uint32_t>(i) % other_ids;
+            reported += contacts.addHit(wheel, other, [other] { return other % 2 ? std::string("Floor_") + std::to_string(other) : std::string("Rock"); },
+                Vector3r(0, 0, 0), Vector3r(0, 0, 1)) ? 1 : 0;
+            if (i % 1000 == 999)
+                contacts.endStep();
+        }
+        double seconds = timer.seconds();
+        testAssert(reported == hits / 1000, "each step should report its first hit");
+        std::cout << "ContactAggregator: " << hits / seconds / 1E6 << " M filtered hits/s" << std::endl;
+    }
+
+    template <typename Func>
+    void expectError(Func func, const std::string& expected)
+    {
+        try {
+            func();
+        }
+        catch (const std::runtime_error& error) {
+            testAssert(std::string(error.what()).find(expected) != std::string::npos, std::string("unexpected error: ") + error.what());
+            return;
+        }
+        testAssert(false, "expected an error containing: " + expected);
+    }
+};
+
+}}
+#endif
@@ -0,0 +1,175 @@
+#ifndef msr_AirLibUnitTests_ControlScheduleTest_hpp
+#define msr_AirLibUnitTests_ControlScheduleTest_hpp
+
+#include "TestBase.hpp"
+#include "common/ControlSchedule.hpp"
+#include "common/common_utils/Timer.hpp"
+#include "vehicles/car/api/CarApiBase.hpp"
+
+namespace msr { namespace airlib {
+
+class ControlScheduleTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testHold();
+        testLinear();
+        testReplace();
+        testExpiry();
+        testErrors();
+        testCarControls();
+        benchmark();
+    }
+
+private:
+    typedef ControlSchedule<float> Schedule;
+
+    static constexpr TTimePoint kStep = 3000000; //3 ms physics step
+    static constexpr TTimePoint kStart = 1000000000;
+
+    static float lerp(const float& from, const float& to, real_T alpha)
+    {
+        return from + alpha * (to - from);
+    }
+
+    static TTimePoint ms(double milliseconds)
+    {
+        return kStart + static_cast<TTimePoint>(milliseconds * 1E6);
+    }
+
+    void testHold()
+    {
+        Schedule schedule(&ControlScheduleTest::lerp);
+        schedule.upload({ ms(10), ms(20), ms(30) }, { 1, 2, 3 }, Schedule::Interpolation::Hold, 0.05);
+
+        float value = -1;
+        testAssert(schedule.step(ms(9), value) == Schedule::StepResult::Idle && value == -1, "nothing applies before the first stamp");
+        testAssert(schedule.getStatus().is_active && schedule.getStatus().pending_count == 3, "all setpoints should be pending");
+
+        //steps land between stamps, so each setpoint starts up to one step late
+        vector<float> applied;
+        for (TTimePoint now = ms(9) + kStep; now < ms(35); now += kStep) {
+            testAssert(schedule.step(now, value) == Schedule::StepResult::Setpoint, "schedule should be in force");
+            applied.push_back(value);
+        }
+        testAssert(applied.front() == 1 && applied.back() == 3, "setpoints should be held until the next stamp");
+        testAssert(std::is_sorted(applied.begin(), applied.end()), "setpoints should apply in order");
+
+        ControlScheduleStatus status = schedule.getStatus();
+        testAssert(status.executed_count == 3 && status.skipped_count == 0 && status.pending_count == 0, "every setpoint should execute once");
+        testAssert(status.last_setpoint_time == ms(30), "last setpoint should be the final one");
+        testAssert(status.max_lag < 3E-3 && status.last_lag >= 0, Utils::stringf("lag should stay below one step, got %f", status.max_lag));
+    }
+
+    void testLinear()
+    {
+        Schedule schedule(&ControlScheduleTest::lerp);
+        schedule.upload({ ms(0), ms(10) }, { 0, 10 }, Schedule::Interpolation::Linear, 0);
+
+        float value;
+        schedule.step(ms(2.5), value);
+        testAssert(std::abs(value - 2.5f) < 1E-5f, "linear schedules should blend towards the next setpoint");
+        schedule.step(ms(10), value);
+        testAssert(value == 10, "the last setpoint should apply exactly");
+    }
+
+    void testReplace()
+    {
+        Schedule schedule(&ControlScheduleTest::lerp);
+        schedule.upload({ ms(0), ms(10), ms(20), ms(30) }, { 1, 2, 3, 4 }, Schedule::Interpolation::Hold, 1);
+
+        float value;
+        schedule.step(ms(1), value);
+        //replanning at 15 ms keeps what was planned before it
+        schedule.upload({ ms(15), ms(25) }, { 7, 8 }, Schedule::Interpolation::Hold, 1);
+        testAssert(schedule.getStatus().pending_count == 3, "setpoints from 15 ms on should be replaced");
+        schedule.step(ms(12), value);
+        testAssert(value == 2, "earlier setpoints should survive an upload");
+        schedule.step(ms(26), value);
+        testAssert(value == 8, "uploaded setpoints should apply");
+        testAssert(schedule.getStatus().skipped_count == 1, "a setpoint passed between steps should be counted as skipped");
+
+        schedule.clear();
+        testAssert(schedule.step(ms(27), value) == Schedule::StepResult::Idle && !schedule.getStatus().is_active, "clear should stop the schedule");
+        testAssert(schedule.getStatus().executed_count == 3, "clear should keep the counters");
+        schedule.reset();
+        testAssert(schedule.getStatus().executed_count == 0, "reset should clear the counters");
+    }
+
+    void testExpiry()
+    {
+        Schedule schedule(&ControlScheduleTest::lerp);
+        schedule.upload({ ms(0) }, { 5 }, Schedule::Interpolation::Hold, 0.01);
+
+        float value;
+        testAssert(schedule.step(ms(10), value) == Schedule::StepResult::Setpoint, "setpoint should hold through the horizon");
+        testAssert(schedule.step(ms(10.5), value) == Schedule::StepResult::Expired, "schedule should expire after the horizon");
+        testAssert(schedule.step(ms(11), value) == Schedule::StepResult::Idle, "expiry should be reported once");
+        testAssert(!schedule.getStatus().is_active, "expired schedule should not be active");
+    }
+
+    void testErrors()
+    {
+        Schedule schedule(&ControlScheduleTest::lerp);
+        expectError([&] { schedule.upload({ ms(0) }, { 1, 2 }, Schedule::Interpolation::Hold, 0); }, "one time stamp for each");
+        expectError([&] { schedule.upload({}, {}, Schedule::Interpolation::Hold, 0); }, "no setpoints");
+        expectError([&] { schedule.upload({ ms(1), ms(1) }, { 1, 2 }, Schedule::Interpolation::Hold, 0); }, "increasing");
+        expectError([&] { schedule.upload({ ms(1) }, { 1 }, static_cast<Schedule::Interpolation>(7), 0); }, "interpolation");
+        expectError([&] { schedule.upload({ ms(1) }, { 1 }, Schedule::Interpolation::Hold, -1); }, "horizon");
+        testAssert(!schedule.getStatus().is_active, "rejected uploads should not change the schedule");
+    }
+
+    void testCarControls()
+    {
+        CarApiBase::CarControls from(0, 1, 0, false, true, 2, false), to(1, -1, 0.5f, true, false, 3, true);
+        CarApiBase::CarControls half = CarApiBase::interpolateControls(from, to, 0.5f);
+        testAssert(half.throttle == 0.5f && half.steering == 0 && half.brake == 0.25f, "pedals and steering should blend");
+        testAssert(!half.handbrake && half.manual_gear == 2, "discrete controls should come from the earlier setpoint");
+    }
+
+    //a 100 point plan replanned every 10 steps at 1 kHz
+    void benchmark()
+    {
+        Schedule schedule(&ControlScheduleTest::lerp);
+        const TTimePoint step = 1000000;
+        const int steps = 200000, plan_size = 100;
+        vector<TTimePoint> times(plan_size);
+        vector<float> values(plan_size);
+
+        common_utils::Timer timer;
+        timer.start();
+        float checksum = 0;
+        for (int i = 0; i < steps; ++i) {
+            const TTimePoint now = kStart + i * step;
+            if (i % 10 == 0) {
+                for (int k = 0; k < plan_size; ++k) {
+                    times[k] = now + k * 5 * step;
+                    values[k] = static_cast<float>(k);
+                }
+                schedule.upload(times, values, Schedule::Interpolation::Linear, 0.1);
+            }
+            float value;
+            schedule.step(now, value);
+            checksum += value;
+        }
+        double seconds = timer.seconds();
+        testAssert(std::isfinite(checksum) && schedule.getStatus().max_lag == 0, "steps on the stamps should have no lag");
+        std::cout << "ControlSchedule: " << steps / seconds / 1E6 << " M steps/s with a replan every 10 steps" << std::endl;
+    }
+
+    template <typename Func>
+    void expectError(Func func, const std::string& expected)
+    {
+        try {
+            func();
+        }
+        catch (const std::invalid_argument& error) {
+            testAssert(std::string(error.what()).find(expected) != std::string::npos, std::string("unexpected error: ") + error.what());
+            return;
+        }
+        testAssert(false, "expected an error containing: " + expected);
+    }
+};
+
+}}
+#endif
@@ -0,0 +1,280 @@
+#ifndef msr_AirLibUnitTests_DistanceArrayTest_hpp
+#define msr_AirLibUnitTests_DistanceArrayTest_hpp
+
+#include "TestBase.hpp"
+#include "common/AirSimSettings.hpp"
+#include "common/SteppableClock.hpp"
+#include "common/common_utils/Timer.hpp"
+#include "sensors/distance/DistanceArrayStaticScene.hpp"
+
+namespace msr { namespace airlib {
+
+class DistanceArrayTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testPattern();
+        testWall();
+        testOutOfRange();
+        testTiltedWall();
+        testNoise();
+        testSettings();
+        benchmarkSample();
+    }
+
+private:
+    typedef DistanceArraySimpleParams::Pattern Pattern;
+
+    //a 1 m thick wall whose near face is distance in front of the origin, turned by yaw about the origin
+    static std::shared_ptr<StaticScene> makeWall(real_T distance, real_T yaw = 0)
+    {
+        auto scene = std::make_shared<StaticScene>();
+        const Quaternionr orientation = VectorMath::toQuaternion(0, 0, yaw);
+        const Vector3r center = VectorMath::rotateVector(Vector3r(distance + 0.5f, 0, 0), orientation, true);
+        scene->addMesh(TriangleMesh::box(Vector3r(1, 200, 200)), Pose(center, orientation));
+        scene->build();
+        return scene;
+    }
+
+    //distance along a ray from the origin to the near face of makeWall(distance, yaw)
+    static real_T wallDistance(const Vector3r& direction, real_T distance, real_T yaw = 0)
+    {
+        const Vector3r normal = VectorMath::rotateVector(Vector3r(1, 0, 0), VectorMath::toQuaternion(0, 0, yaw), true);
+        return distance / direction.dot(normal);
+    }
+
+    static AirSimSettings::DistanceArraySetting makeSetting()
+    {
+        AirSimSettings::DistanceArraySetting setting;
+        setting.sensor_type = SensorBase::SensorType::DistanceArray;
+        setting.noise_sigma = 0;
+        setting.noise_growth = 0;
+        setting.multipath_dropout = 0;
+        //faster than the clock steps, so that every step samples
+        setting.update_frequency = 1000;
+        setting.max_distance = 10;
+        return setting;
+    }
+
+    struct Rig {
+        SteppableClock clock;
+        ClockFactory::DomainScope clock_scope;
+        Kinematics::State kinematics = Kinematics::State::zero();
+        Environment environment;
+
+        Rig()
+            : clock(1E-2f, 1000000000), clock_scope(&clock), environment(Environment::State(Vector3r::Zero(), GeoPoint(47.641468, -122.140165, 122)))
+        {
+        }
+
+        void start(DistanceArraySimple& sensor)
+        {
+            sensor.initialize(&kinematics, &environment);
+            sensor.reset();
+        }
+
+        void step(DistanceArraySimple& sensor)
+        {
+            clock.step();
+            sensor.update();
+        }
+    };
+
+    void testPattern()
+    {
+        DistanceArraySimpleParams params;
+        params.zone_rows = 2;
+        params.zone_cols = 3;
+        params.rays_per_zone_side = 3;
+        vector<Vector3r> directions = params.getRayDirections();
+        testAssert(directions.size() == 54 && params.getRaysPerZone() == 9, "grid should have rays_per_zone_side^2 rays in each zone");
+
+        const real_T half_width = std::tan(params.horizontal_fov / 2), half_height = std::tan(params.vertical_fov / 2);
+        for (uint ray = 0; ray < directions.size(); ++ray) {
+            const Vector3r& direction = directions[ray];
+            testAssert(std::abs(direction.norm() - 1) < 1E-5f, "ray directions should be unit vectors");
+            const uint zone = ray / 9, row = zone / 3, col = zone % 3;
+            const real_T u = direction.y() / direction.x(), v = direction.z() / direction.x();
+            //each zone covers its own part of the image plane
+            testAssert(u > -half_width + 2 * half_width * col / 3 && u < -half_width + 2 * half_width * (col + 1) / 3, "ray is outside the columns of its zone");
+            testAssert(v > -half_height + 2 * half_height * row / 2 && v < -half_height + 2 * half_height * (row + 1) / 2, "ray is outside the rows of its zone");
+        }
+
+        params.pattern = Pattern::Cone;
+        params.cone_rays = 100;
+        directions = params.getRayDirections();
+        testAssert(directions.size() == 100 && params.getZoneCount() == 1, "a cone is one zone of cone_rays rays");
+        Vector3r mean = Vector3r::Zero();
+        for (const auto& direction : directions) {
+            testAssert(std::acos(direction.x()) <= params.cone_angle / 2 + 1E-5f, "cone ray is outside the cone");
+            mean += direction;
+        }
+        mean.normalize();
+        testAssert(std::acos(std::min(1.0f, mean.x())) < Utils::degreesToRadians(1.0f), "cone rays should be spread evenly around the axis");
+    }
+
+    //zone distances on a wall facing the sensor are the nearest and the mean ray distances of the zones
+    void testWall()
+    {
+        const real_T wall = 2.5f;
+        for (const char* reduction : { "Min", "Mean" }) {
+            Rig rig;
+            AirSimSettings::DistanceArraySetting setting = makeSetting();
+            setting.zone_rows = 3;
+            setting.zone_cols = 5;
+            setting.horizontal_fov = 60;
+            setting.reduction = reduction;
+            DistanceArrayStaticScene sensor(setting, makeWall(wall));
+            rig.start(sensor);
+            rig.step(sensor);
+
+            const DistanceArrayBase::Output& output = sensor.getOutput();
+            testAssert(output.rows == 3 && output.cols == 5 && output.distances.size() == 15 && output.return_counts.size() == 15, "output should have one entry per zone");
+            const uint rays_per_zone = sensor.getParams().getRaysPerZone();
+            for (uint zone = 0; zone < 15; ++zone) {
+                real_T expected_min = setting.max_distance, expected_sum = 0;
+                for (uint ray = zone * rays_per_zone; ray < (zone + 1) * rays_per_zone; ++ray) {
+                    real_T distance = wallDistance(sensor.getRayDirections()[ray], wall);
+                    expected_min = std::min(expected_min, distance);
+                    expected_sum += distance;
+                }
+                real_T expected = std::string(reduction) == "Min" ? expected_min : expected_sum / rays_per_zone;
+                testAssert(std::abs(output.distances[zone] - expected) < 1E-4f,
+                    Utils::stringf("%s of zone %u is %f, expected %f", reduction, zone, output.distances[zone], expected));
+                testAssert(output.return_counts[zone] == rays_per_zone, "every ray should return from the wall");
+            }
+            //the center zone looks straight at the wall
+            testAssert(output.distances[7] < output.distances[5] && output.distances[7] >= wall, "outer zones should be further away");
+        }
+    }
+
+    void testOutOfRange()
+    {
+        Rig rig;
+        AirSimSettings::DistanceArraySetting setting = makeSetting();
+        setting.max_distance = 4;
+        DistanceArrayStaticScene sensor(setting, makeWall(6));
+        rig.start(sensor);
+        rig.step(sensor);
+        for (uint zone = 0; zone < 16; ++zone) {
+            testAssert(sensor.getOutput().return_counts[zone] == 0, "a wall beyond max_distance should not return");
+            testAssert(sensor.getOutput().distances[zone] == 4, "zones without returns should report max_distance");
+        }
+    }
+
+    //an ultrasonic cone at a wall turned 60 degrees away, where half of the beams scatter away
+    void testTiltedWall()
+    {
+        const real_T wall = 1.5f, yaw = Utils::degreesToRadians(60.0f);
+        Rig rig;
+        AirSimSettings::DistanceArraySetting setting = makeSetting();
+        setting.pattern = "Cone";
+        setting.cone_angle = 4;
+        setting.cone_rays = 50;
+        DistanceArrayStaticScene sensor(setting, makeWall(wall, yaw));
+        rig.start(sensor);
+        rig.step(sensor);
+
+        real_T expected = setting.max_distance;
+        for (const auto& direction : sensor.getRayDirections())
+            expected = std::min(expected, wallDistance(direction, wall, yaw));
+        testAssert(std::abs(sensor.getOutput().distances[0] - expected) < 1E-4f, "cone should report the nearest point of the tilted wall");
+        testAssert(expected < wall / std::cos(yaw) * 0.98f, "the edge of the cone should be nearer than its axis");
+
+        setting.multipath_dropout = 1;
+        DistanceArrayStaticScene scattering(setting, makeWall(wall, yaw));
+        rig.start(scattering);
+        uint returns = 0;
+        const uint samples = 200;
+        for (uint i = 0; i < samples; ++i) {
+            rig.step(scattering);
+            returns += scattering.getOutput().return_counts[0];
+        }
+        //incidence is 60 degrees give or take the 2 degree half angle, so about cos(60) of the rays return
+        const double fraction = static_cast<double>(returns) / (samples * setting.cone_rays);
+        testAssert(std::abs(fraction - 0.5) < 0.05, Utils::stringf("expected half of the rays to return, got %f", fraction));
+    }
+
+    void testNoise()
+    {
+        const real_T wall = 3;
+        Rig rig;
+        AirSimSettings::DistanceArraySetting setting = makeSetting();
+        setting.noise_sigma = 0.01f;
+        setting.noise_growth = 0.002f;
+        DistanceArrayStaticScene sensor(setting, makeWall(wall));
+        rig.start(sensor);
+
+        //the inner zones see the wall a little further than its distance, by the same amount in each sample
+        double sum = 0, square_sum = 0;
+        const int samples = 4000;
+        for (int i = 0; i < samples; ++i) {
+            rig.step(sensor);
+            double distance = sensor.getOutput().distances[5];
+            sum += distance;
+            square_sum += distance * distance;
+        }
+        const double mean = sum / samples, sigma = std::sqrt(square_sum / samples - mean * mean);
+        const double expected_sigma = sensor.getParams().getNoiseSigma(static_cast<real_T>(mean));
+        testAssert(std::abs(expected_sigma - (0.01 + 0.002 * 9)) < 1E-3, "noise should grow with the square of the range");
+        testAssert(std::abs(sigma / expected_sigma - 1) < 0.05, Utils::stringf("noise sigma is %f, expected %f", sigma, expected_sigma));
+        real_T nearest = setting.max_distance;
+        for (uint ray = 5 * 16; ray < 6 * 16; ++ray)
+            nearest = std::min(nearest, wallDistance(sensor.getRayDirections()[ray], wall));
+        testAssert(std::abs(mean - nearest) < 2E-3, "noise should be unbiased");
+    }
+
+    void testSettings()
+    {
+        DistanceArraySimpleParams params;
+        AirSimSettings::DistanceArraySetting setting = makeSetting();
+        setting.pattern = "fan";
+        expectError([&] { params.initializeFromSettings(setting); }, "Unknown distance array pattern 'fan'");
+        setting.pattern = "cone";
+        setting.reduction = "median";
+        expectError([&] { params.initializeFromSettings(setting); }, "Unknown distance array reduction 'median'");
+        setting.reduction = "mean";
+        setting.cone_rays = 0;
+        expectError([&] { params.initializeFromSettings(setting); }, "between 1 and 65535 rays");
+        setting.cone_rays = 12;
+        params.initializeFromSettings(setting);
+        testAssert(params.pattern == Pattern::Cone && params.reduction == DistanceArraySimpleParams::Reduction::Mean, "names should ignore case");
+    }
+
+    //an 8 x 8 zone sensor with 16 rays per zone
+    void benchmarkSample()
+    {
+        Rig rig;
+        AirSimSettings::DistanceArraySetting setting = makeSetting();
+        setting.zone_rows = 8;
+        setting.zone_cols = 8;
+        setting.noise_sigma = 0.005f;
+        setting.multipath_dropout = 0.5f;
+        DistanceArrayStaticScene sensor(setting, makeWall(2, 0.3f));
+        rig.start(sensor);
+
+        const int samples = 2000;
+        common_utils::Timer timer;
+        timer.start();
+        for (int i = 0; i < samples; ++i)
+            rig.step(sensor);
+        std::cout << "DistanceArrayStaticScene: " << timer.seconds() / samples * 1E6 << " us per sample of "
+                  << sensor.getRayDirections().size() << " rays" << std::endl;
+    }
+
+    template <typename Func>
+    void expectError(Func func, const std::string& expected)
+    {
+        try {
+            func();
+        }
+        catch (const std::invalid_argument& error) {
+            testAssert(std::string(error.what()).find(expected) != std::string::npos, std::string("unexpected error: ") + error.what());
+            return;
+        }
+        testAssert(false, "expected an error containing: " + expected);
+    }
+};
+
+}}
+#endif
@@ -0,0 +1,291 @@
+#ifndef msr_AirLibUnitTests_EventCameraEmulatorTest_hpp
+#define msr_AirLibUnitTests_EventCameraEmulatorTest_hpp
+
+#include "TestBase.hpp"
+#include "camera/EventCameraEmulator.hpp"
+#include "common/common_utils/Timer.hpp"
+
+namespace msr { namespace airlib {
+
+class EventCameraEmulatorTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testPacking();
+        testBrightnessSteps();
+        testRefractoryPeriod();
+        testMovingEdge();
+        testThresholdMismatch();
+        testBackgroundActivity();
+        testSequences();
+        benchmarkFrames();
+    }
+
+private:
+    typedef EventCameraEmulator::Event Event;
+    typedef EventCameraEmulator::EventPacket EventPacket;
+
+    static constexpr TTimePoint Millisecond = 1000000;
+
+    static AirSimSettings::EventCameraSetting makeSetting()
+    {
+        AirSimSettings::EventCameraSetting setting;
+        setting.threshold_sigma = 0;
+        setting.refractory_period = 0;
+        setting.background_rate = 0;
+        return setting;
+    }
+
+    //log intensity the emulator uses for a gray value
+    static double logIntensity(int value)
+    {
+        return std::log(value + 1.0);
+    }
+
+    static vector<Event> unpack(const EventPacket& packet)
+    {
+        vector<Event> events;
+        for (uint64_t word : packet.events)
+            events.push_back(EventCameraEmulator::unpackEvent(word));
+        return events;
+    }
+
+    void testPacking()
+    {
+        Event event;
+        event.time_offset = 4000000000u;
+        event.x = 65535;
+        event.y = 32767;
+        event.on = true;
+        Event unpacked = EventCameraEmulator::unpackEvent(EventCameraEmulator::packEvent(event));
+        testAssert(unpacked.time_offset == event.time_offset && unpacked.x == event.x && unpacked.y == event.y && unpacked.on,
+            "packed event should round trip");
+
+        Event later;
+        later.time_offset = 1;
+        testAssert(EventCameraEmulator::packEvent(later) > EventCameraEmulator::packEvent(Event()), "packed events should sort by time");
+        event.time_offset = 0;
+        testAssert(EventCameraEmulator::packEvent(later) > EventCameraEmulator::packEvent(event), "time should outweigh position and polarity");
+    }
+
+    //expected crossing times in microseconds when the log intensity goes linearly from log0 to log1 over duration_us
+    static vector<double> crossingTimes(double log0, double log1, double& reference, double threshold, double duration_us)
+    {
+        vector<double> times;
+        const double step = log1 > log0 ? threshold : -threshold;
+        while ((log1 - reference) * step >= threshold * threshold) {
+            reference += step;
+            times.push_back((reference - log0) / (log1 - log0) * duration_us);
+        }
+        return times;
+    }
+
+    //a uniform gray image brightens and then darkens, which gives one event per threshold crossed
+    void testBrightnessSteps()
+    {
+        const int width = 15, height = 7; //not a multiple of the SIMD width
+        EventCameraEmulator emulator(makeSetting());
+        EventPacket packet;
+
+        const int values[] = { 50, 100, 40 };
+        double reference = logIntensity(values[0]);
+        emulator.addFrame(vector<uint8_t>(width * height, static_cast<uint8_t>(values[0])), width, height, 10 * Millisecond, packet);
+        testAssert(packet.events.empty() && packet.width == width && packet.height == height, "the first frame only sets the reference");
+
+        for (int frame = 1; frame < 3; ++frame) {
+            emulator.addFrame(vector<uint8_t>(width * height, static_cast<uint8_t>(values[frame])), width, height, (frame + 1) * 10 * Millisecond, packet);
+            testAssert(packet.start_time == frame * 10 * Millisecond && packet.end_time == (frame + 1) * 10 * Millisecond, "packet should span the two frames");
+
+            const vector<double> expected = crossingTimes(logIntensity(values[frame - 1]), logIntensity(values[frame]), reference, 0.2, 10000);
+            testAssert(expected.size() == (frame == 1 ? 3u : 4u), "test values should cross 3 and 4 thresholds");
+            const vector<Event> events = unpack(packet);
+            testAssert(events.size() == expected.size() * width * height, Utils::stringf("frame %d has %d events, expected %d per pixel",
+                frame, static_cast<int>(events.size()), static_cast<int>(expected.size())));
+
+            vector<int> counts(width * height, 0);
+            for (uint i = 0; i < events.size(); ++i) {
+                const Event& event = events[i];
+                testAssert(event.on == (frame == 1), "brighter pixels give ON events and darker pixels OFF events");
+                testAssert(i == 0 || events[i - 1].time_offset <= event.time_offset, "events should be sorted by time");
+                int& count = counts[event.y * width + event.x];
+                testAssert(std::abs(event.time_offset - expected[count]) <= 1, Utils::stringf("event at %u us, expected %f us",
+                    event.time_offset, expected[count]));
+                ++count;
+            }
+        }
+    }
+
+    //a pixel blind after each event fires once per refractory period, and a change it missed carries to the next frame
+    void testRefractoryPeriod()
+    {
+        AirSimSettings::EventCameraSetting setting = makeSetting();
+        setting.refractory_period = 0.002f;
+        EventCameraEmulator emulator(setting);
+        EventPacket packet;
+
+        emulator.addFrame(vector<uint8_t>(4, 10), 2, 2, 0, packet);
+        emulator.addFrame(vector<uint8_t>(4, 250), 2, 2, 10 * Millisecond, packet);
+        const double first = 0.2 / (logIntensity(250) - logIntensity(10)) * 10000;
+        const vector<Event> events = unpack(packet);
+        testAssert(events.size() == 5 * 4, "a ramp of 15 thresholds in 10 ms should give 5 events per pixel with a 2 ms refractory period");
+        for (uint i = 0; i < events.size(); ++i) {
+            const double expected = first + (i / 4) * 2000;
+            testAssert(events[i].on && std::abs(events[i].time_offset - expected) <= 1, "events should be one refractory period apart");
+        }
+
+        emulator.addFrame(vector<uint8_t>(4, 250), 2, 2, 20 * Millisecond, packet);
+        const vector<Event> late = unpack(packet);
+        testAssert(late.size() == 4, "the change missed at the end of the ramp should fire once the pixel sees again");
+        for (const Event& event : late)
+            testAssert(event.on && std::abs(event.time_offset - (first + 8000 + 2000 - 10000)) <= 1, "missed change should fire at the end of the period");
+
+        emulator.addFrame(vector<uint8_t>(4, 250), 2, 2, 30 * Millisecond, packet);
+        testAssert(packet.events.empty(), "the reference should have reset to the intensity when the pixel fired");
+    }
+
+    //a bright area grows over a dark one a column at a time, RGBA like Scene images
+    void testMovingEdge()
+    {
+        const int width = 32, height = 8, bright = 200, dark = 20;
+        EventCameraEmulator emulator(makeSetting());
+        EventPacket packet;
+        const size_t expected_per_pixel = static_cast<size_t>((logIntensity(bright) - logIntensity(dark)) / 0.2);
+
+        for (int edge = 4; edge < 28; ++edge) {
+            vector<uint8_t> frame(width * height * 4);
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    uint8_t* pixel = &frame[(y * width + x) * 4];
+                    pixel[0] = pixel[1] = pixel[2] = static_cast<uint8_t>(x < edge ? bright : dark);
+                    pixel[3] = 255;
+                }
+            }
+            emulator.addFrame(frame, width, height, edge * 5 * Millisecond, packet);
+            if (edge == 4) {
+                testAssert(packet.events.empty(), "first frame should have no events");
+                continue;
+            }
+
+            testAssert(packet.events.size() == expected_per_pixel * height, Utils::stringf("column %d has %d events, expected %d",
+                edge - 1, static_cast<int>(packet.events.size()), static_cast<int>(expected_per_pixel * height)));
+            for (const Event& event : unpack(packet))
+                testAssert(event.x == edge - 1 && event.on, "only the column the edge passed should fire, with ON events");
+        }
+    }
+
+    //thresholds vary around their setting, so pixels differ in the number of events for the same change
+    void testThresholdMismatch()
+    {
+        AirSimSettings::EventCameraSetting setting = makeSetting();
+        setting.threshold_sigma = 0.03f;
+        EventCameraEmulator emulator(setting);
+        EventPacket packet;
+
+        const int width = 64, height = 64;
+        emulator.addFrame(vector<uint8_t>(width * height, 20), width, height, 0, packet);
+        emulator.addFrame(vector<uint8_t>(width * height, 220), width, height, 10 * Millisecond, packet);
+        vector<int> counts(width * height, 0);
+        for (const Event& event : unpack(packet))
+            ++counts[event.y * width + event.x];
+
+        const double nominal = (logIntensity(220) - logIntensity(20)) / 0.2;
+        const double mean = static_cast<double>(packet.events.size()) / counts.size();
+        const auto range = std::minmax_element(counts.begin(), counts.end());
+        testAssert(*range.first < *range.second, "pixels should not all have the same thresholds");
+        testAssert(std::abs(mean - nominal) < 0.5, Utils::stringf("mean of %f events per pixel, expected about %f", mean, nominal));
+    }
+
+    void testBackgroundActivity()
+    {
+        AirSimSettings::EventCameraSetting setting = makeSetting();
+        setting.background_rate = 5;
+        EventCameraEmulator emulator(setting);
+        EventPacket packet;
+
+        const int width = 64, height = 64, frames = 100;
+        const vector<uint8_t> frame(width * height, 128);
+        size_t count = 0, on_count = 0;
+        emulator.addFrame(frame, width, height, 0, packet);
+        for (int i = 1; i <= frames; ++i) {
+            emulator.addFrame(frame, width, height, i * 10 * Millisecond, packet);
+            for (const Event& event : unpack(packet)) {
+                testAssert(event.time_offset <= 10000, "noise events should be inside the packet");
+                on_count += event.on ? 1 : 0;
+            }
+            count += packet.events.size();
+        }
+        const double expected = 5.0 * width * height * frames * 0.01;
+        testAssert(std::abs(count / expected - 1) < 0.03, Utils::stringf("%d noise events, expected about %f", static_cast<int>(count), expected));
+        testAssert(std::abs(static_cast<double>(on_count) / count - 0.5) < 0.02, "noise should have both polarities equally");
+    }
+
+    void testSequences()
+    {
+        EventCameraEmulator emulator(makeSetting());
+        EventPacket packet;
+        emulator.addFrame(vector<uint8_t>(16, 10), 4, 4, 100 * Millisecond, packet);
+
+        emulator.addFrame(vector<uint8_t>(16, 200), 4, 4, 100 * Millisecond, packet);
+        testAssert(packet.events.empty() && packet.start_time == packet.end_time, "a frame with the same time stamp should be ignored");
+        emulator.addFrame(vector<uint8_t>(16, 200), 4, 4, 50 * Millisecond, packet);
+        testAssert(packet.events.empty(), "an older frame should start a new sequence");
+        emulator.addFrame(vector<uint8_t>(12, 10), 3, 4, 60 * Millisecond, packet);
+        testAssert(packet.events.empty(), "a frame of another size should start a new sequence");
+        emulator.reset();
+        emulator.addFrame(vector<uint8_t>(12, 200), 3, 4, 70 * Millisecond, packet);
+        testAssert(packet.events.empty(), "reset should start a new sequence");
+
+        expectError([&] { emulator.addFrame(vector<uint8_t>(32, 10), 4, 4, 0, packet); }, "3 or 4 channels, got 2");
+        expectError([&] { emulator.addFrame(vector<uint8_t>(15, 10), 4, 4, 0, packet); }, "does not match its size");
+        AirSimSettings::EventCameraSetting setting = makeSetting();
+        setting.contrast_threshold_off = 0;
+        expectError([&] { EventCameraEmulator bad(setting); }, "thresholds must be positive");
+    }
+
+    //VGA frames of a texture panning one pixel per frame
+    void benchmarkFrames()
+    {
+        const int width = 640, height = 480, frames = 60;
+        vector<uint8_t> texture(width * 2);
+        for (size_t i = 0; i < texture.size(); ++i)
+            texture[i] = static_cast<uint8_t>(128 + 100 * std::sin(i * 0.05) * std::sin(i * 0.011));
+
+        EventCameraEmulator emulator(AirSimSettings::EventCameraSetting{});
+        EventPacket packet;
+        vector<uint8_t> frame(width * height * 4);
+        size_t events = 0;
+        double seconds = 0;
+        for (int i = 0; i <= frames; ++i) {
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    uint8_t* pixel = &frame[(y * width + x) * 4];
+                    pixel[0] = pixel[1] = pixel[2] = texture[x + i + (y & 7)];
+                    pixel[3] = 255;
+                }
+            }
+            common_utils::Timer timer;
+            timer.start();
+            emulator.addFrame(frame, width, height, i * 2 * Millisecond, packet);
+            seconds += timer.seconds();
+            events += packet.events.size();
+        }
+        std::cout << "EventCameraEmulator: " << width * height * frames / seconds * 1E-6 << " Mpixels per second, "
+                  << events / frames << " events per frame" << std::endl;
+    }
+
+    template <typename Func>
+    void expectError(Func func, const std::string& expected)
+    {
+        try {
+            func();
+        }
+        catch (const std::invalid_argument& error) {
+            testAssert(std::string(error.what()).find(expected) != std::string::npos, std::string("unexpected error: ") + error.what());
+            return;
+        }
+        testAssert(false, "expected an error containing: " + expected);
+    }
+};
+
+}}
+#endif
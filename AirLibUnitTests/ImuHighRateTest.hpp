@@ -0,0 +1,253 @@
+#ifndef msr_AirLibUnitTests_ImuHighRateTest_hpp
+#define msr_AirLibUnitTests_ImuHighRateTest_hpp
+
+#include "TestBase.hpp"
+#include "common/AirSimSettings.hpp"
+#include "common/SteppableClock.hpp"
+#include "common/common_utils/Timer.hpp"
+#include "sensors/SensorFactory.hpp"
+#include "sensors/imu/ImuDeltaIntegrator.hpp"
+#include "sensors/imu/ImuHighRate.hpp"
+
+namespace msr { namespace airlib {
+
+class ImuHighRateTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testConstantRate();
+        testConing();
+        testSculling();
+        testVibration();
+        benchmarkSample();
+    }
+
+private:
+    typedef Eigen::Vector3d Vector3d;
+    typedef Eigen::Quaterniond Quaterniond;
+
+    static Vector3r toFloat(const Vector3d& vec)
+    {
+        return vec.cast<real_T>();
+    }
+
+    static Vector3d rotationVector(const Quaterniond& q)
+    {
+        Eigen::AngleAxisd angle_axis(q);
+        return angle_axis.axis() * angle_axis.angle();
+    }
+
+    //integrates qdot = q * (0, w) / 2 and vdot = q f q* with RK4, for the rotation from the body at t = 0
+    template <typename TRate, typename TForce>
+    static void integrateTruth(TRate rate, TForce force, double duration, Quaterniond& q, Vector3d& velocity)
+    {
+        const int steps = 20000;
+        const double h = duration / steps;
+        q = Quaterniond::Identity();
+        velocity = Vector3d::Zero();
+        auto derivative = [&](const Quaterniond& at, double t) {
+            Quaterniond omega(0, 0, 0, 0);
+            omega.vec() = rate(t);
+            Quaterniond dq = at * omega;
+            dq.coeffs() *= 0.5;
+            return dq;
+        };
+        auto add = [](const Quaterniond& at, const Quaterniond& dq, double scale) {
+            Quaterniond sum;
+            sum.coeffs() = at.coeffs() + dq.coeffs() * scale;
+            return sum;
+        };
+        for (int step = 0; step < steps; ++step) {
+            const double t = step * h;
+            Quaterniond k1 = derivative(q, t);
+            Quaterniond k2 = derivative(add(q, k1, h / 2), t + h / 2);
+            Quaterniond k3 = derivative(add(q, k2, h / 2), t + h / 2);
+            Quaterniond k4 = derivative(add(q, k3, h), t + h);
+            Quaterniond mid = add(q, k1, h / 2);
+            mid.normalize();
+            const Vector3d v1 = q * force(t), v2 = mid * force(t + h / 2);
+            q.coeffs() += (k1.coeffs() + 2 * k2.coeffs() + 2 * k3.coeffs() + k4.coeffs()) * (h / 6);
+            q.normalize();
+            velocity += (v1 + 4 * v2 + q * force(t + h)) * (h / 6);
+        }
+    }
+
+    void testConstantRate()
+    {
+        const Vector3r rate(0.3f, -1.2f, 0.8f);
+        const Vector3r force = rate * 4;
+        ImuDeltaIntegrator integrator;
+        for (int i = 0; i < 10; ++i)
+            integrator.add(rate * 1E-3f, force * 1E-3f);
+        testAssert(integrator.getSampleCount() == 10, "integrator should count its samples");
+        testAssert((integrator.getDeltaAngle() - rate * 1E-2f).norm() < 1E-6f, "a constant rate about a fixed axis needs no coning correction");
+        testAssert((integrator.getDeltaVelocity() - force * 1E-2f).norm() < 1E-6f, "a force along the rotation axis doesn't rotate");
+
+        integrator.reset();
+        testAssert(integrator.getDeltaAngle() == Vector3r::Zero() && integrator.getSampleCount() == 0, "reset should clear the increments");
+    }
+
+    //two axes oscillating a quarter period apart turn the rotation axis around z
+    void testConing()
+    {
+        const double amplitude = 2, frequency = 2 * M_PI * 40, duration = 0.01;
+        auto rate = [&](double t) { return Vector3d(amplitude * std::cos(frequency * t), amplitude * std::sin(frequency * t), 0); };
+        auto no_force = [](double) { return Vector3d::Zero().eval(); };
+        Quaterniond truth;
+        Vector3d unused_velocity;
+        integrateTruth(rate, no_force, duration, truth, unused_velocity);
+        const Vector3d truth_angle = rotationVector(truth);
+
+        const int samples = 10;
+        const double h = duration / samples;
+        ImuDeltaIntegrator integrator;
+        for (int i = 0; i < samples; ++i) {
+            const double t0 = i * h, t1 = t0 + h;
+            //exact integral of the rate over the sample
+            Vector3d delta_angle(amplitude / frequency * (std::sin(frequency * t1) - std::sin(frequency * t0)),
+                -amplitude / frequency * (std::cos(frequency * t1) - std::cos(frequency * t0)), 0);
+            integrator.add(toFloat(delta_angle), Vector3r::Zero());
+        }
+
+        const double corrected_error = (integrator.getDeltaAngle().cast<double>() - truth_angle).norm();
+        const double summed_error = (integrator.getAngleSum().cast<double>() - truth_angle).norm();
+        testAssert(summed_error > 1E-5, "the plain sum should miss the coning rotation");
+        testAssert(corrected_error < summed_error / 20, Utils::stringf("coning correction should cut the error, got %g vs %g rad", corrected_error, summed_error));
+    }
+
+    //a force along y in phase with the angle about x gives a steady velocity change along z
+    void testSculling()
+    {
+        const double amplitude = 2, force_amplitude = 10, frequency = 2 * M_PI * 40, duration = 0.01;
+        auto rate = [&](double t) { return Vector3d(amplitude * std::cos(frequency * t), 0, 0); };
+        auto force = [&](double t) { return Vector3d(0, force_amplitude * std::sin(frequency * t), 0); };
+        Quaterniond truth;
+        Vector3d truth_velocity;
+        integrateTruth(rate, force, duration, truth, truth_velocity);
+
+        const int samples = 10;
+        const double h = duration / samples;
+        ImuDeltaIntegrator integrator;
+        for (int i = 0; i < samples; ++i) {
+            const double t0 = i * h, t1 = t0 + h;
+            const double s = (std::sin(frequency * t1) - std::sin(frequency * t0)) / frequency;
+            const double c = -(std::cos(frequency * t1) - std::cos(frequency * t0)) / frequency;
+            integrator.add(toFloat(Vector3d(amplitude * s, 0, 0)), toFloat(Vector3d(0, force_amplitude * c, 0)));
+        }
+
+        const double corrected_error = (integrator.getDeltaVelocity().cast<double>() - truth_velocity).norm();
+        const double summed_error = (integrator.getVelocitySum().cast<double>() - truth_velocity).norm();
+        testAssert(std::abs(truth_velocity.z()) > 1E-4, "the oscillation should rectify into z");
+        testAssert(corrected_error < summed_error / 20, Utils::stringf("sculling correction should cut the error, got %g vs %g m/s", corrected_error, summed_error));
+    }
+
+    struct Rig {
+        SteppableClock clock;
+        ClockFactory::DomainScope clock_scope;
+        Kinematics::State kinematics = Kinematics::State::zero();
+        Environment environment;
+
+        Rig()
+            : clock(3E-3f, 1000000000), clock_scope(&clock), environment(Environment::State(Vector3r::Zero(), GeoPoint(47.641468, -122.140165, 122)))
+        {
+            environment.reset();
+        }
+    };
+
+    //spread of the output specific force on x while four rotors run at full speed, 107 Hz for the default quad
+    double vibrationSpread(Rig& rig, const AirSimSettings::ImuSetting& setting)
+    {
+        const real_T max_speed = 6396.667f / 60 * 2 * M_PIf;
+        ImuHighRate imu(setting);
+        imu.initialize(&rig.kinematics, &rig.environment);
+        imu.setRotorSpeedProvider([&](real_T* speeds, uint max_count) {
+            uint count = std::min(4u, max_count);
+            for (uint i = 0; i < count; ++i)
+                speeds[i] = max_speed * (1 - 0.01f * i);
+            return count;
+        }, max_speed);
+        imu.reset();
+
+        double sum = 0, square_sum = 0;
+        const int updates = 2000;
+        for (int i = 0; i < updates; ++i) {
+            rig.clock.step();
+            imu.update();
+            double x = imu.getOutput().linear_acceleration.x();
+            sum += x;
+            square_sum += x * x;
+        }
+        testAssert(imu.getIncrements().sample_count == 6, "a 3 ms update should hold 6 samples at 2 kHz");
+        testAssert(std::abs(imu.getIncrements().delta_time - 3E-3f) < 1E-6f, "increments should cover the update");
+        const double mean = sum / updates;
+        return std::sqrt(square_sum / updates - mean * mean);
+    }
+
+    void testVibration()
+    {
+        Rig rig;
+        rig.kinematics.twist.angular = Vector3r(0.1f, -0.2f, 0.5f);
+
+        AirSimSettings::ImuSetting setting;
+        setting.sensor_type = SensorBase::SensorType::Imu;
+        unique_ptr<SensorBase> simple = SensorFactory().createSensorFromSettings(&setting);
+        testAssert(dynamic_cast<ImuSimple*>(simple.get()) != nullptr, "IMUs without a sample rate should stay simple");
+        setting.sample_rate = 2000;
+        unique_ptr<SensorBase> sensor = SensorFactory().createSensorFromSettings(&setting);
+        auto* imu = dynamic_cast<ImuHighRate*>(sensor.get());
+        testAssert(imu != nullptr, "factory should create a high rate IMU when the sample rate is set");
+
+        //without vibration the output follows the ground truth
+        imu->initialize(&rig.kinematics, &rig.environment);
+        imu->reset();
+        Vector3r rate_sum = Vector3r::Zero(), force_sum = Vector3r::Zero();
+        for (int i = 0; i < 1000; ++i) {
+            rig.clock.step();
+            imu->update();
+            rate_sum += imu->getOutput().angular_velocity;
+            force_sum += imu->getOutput().linear_acceleration;
+        }
+        testAssert((rate_sum / 1000 - rig.kinematics.twist.angular).norm() < 1E-3f, "mean rate should match the ground truth");
+        testAssert((force_sum / 1000 - Vector3r(0, 0, -EarthUtils::Gravity)).norm() < 0.05f, "a vehicle at rest should sense gravity");
+
+        setting.vibration_accel = 2;
+        setting.anti_alias_cutoff = 0;
+        const double unfiltered = vibrationSpread(rig, setting);
+        setting.anti_alias_cutoff = 50;
+        const double filtered = vibrationSpread(rig, setting);
+        testAssert(unfiltered > 1, Utils::stringf("rotors should shake the accelerometer, spread %g m/s^2", unfiltered));
+        testAssert(filtered < unfiltered * 0.4, Utils::stringf("anti-alias filter should damp the vibration, spread %g vs %g m/s^2", filtered, unfiltered));
+    }
+
+    void benchmarkSample()
+    {
+        Rig rig;
+        AirSimSettings::ImuSetting setting;
+        setting.sample_rate = 2000;
+        setting.vibration_accel = 2;
+        setting.vibration_gyro = 0.2f;
+        ImuHighRate imu(setting);
+        imu.initialize(&rig.kinematics, &rig.environment);
+        imu.setRotorSpeedProvider([](real_T* speeds, uint max_count) {
+            uint count = std::min(4u, max_count);
+            for (uint i = 0; i < count; ++i)
+                speeds[i] = 600;
+            return count;
+        }, 670);
+        imu.reset();
+
+        const int updates = 100000;
+        common_utils::Timer timer;
+        timer.start();
+        for (int i = 0; i < updates; ++i) {
+            rig.clock.step();
+            imu.update();
+        }
+        const double seconds = timer.seconds();
+        std::cout << "ImuHighRate: " << seconds / updates * 1E9 << " ns per update of 6 samples, "
+                  << seconds / (updates * 6.0) * 1E9 << " ns per sample with 4 vibrating rotors" << std::endl;
+    }
+};
+
+}}
+#endif
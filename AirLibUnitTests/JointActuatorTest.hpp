@@ -0,0 +1,306 @@
+#ifndef msr_AirLibUnitTests_JointActuatorTest_hpp
+#define msr_AirLibUnitTests_JointActuatorTest_hpp
+
+#include "TestBase.hpp"
+#include "vehicles/urdfbot/JointActuator.hpp"
+#include "vehicles/urdfbot/parser/UrdfParser.hpp"
+#include "common/common_utils/Timer.hpp"
+#include <iostream>
+
+namespace msr { namespace airlib {
+
+class JointActuatorTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testTorqueSpeed();
+        testCurrentLimit();
+        testElectricalLag();
+        testBacklash();
+        testPositionControl();
+        testVelocityControl();
+        testIdle();
+        testParse();
+        benchmark();
+    }
+
+private:
+    //12 V motor on a 10:1 gear, stall effort 2.4 N m and no-load speed 24 rad/s
+    static UrdfActuator getMotor()
+    {
+        UrdfActuator params;
+        params.voltage = 12;
+        params.resistance = 2;
+        params.torque_constant = 0.05f;
+        params.gear_ratio = 10;
+        params.gear_efficiency = 0.8f;
+        return params;
+    }
+
+    //rigid joint with inertia and a constant load, stepped with semi-implicit Euler
+    struct Plant {
+        real_T inertia = 0.05f;
+        real_T load = 0;
+        real_T position = 0;
+        real_T velocity = 0;
+
+        void step(JointActuator& actuator, real_T dt)
+        {
+            real_T effort = actuator.update(dt, position, velocity);
+            velocity += (effort - load) / inertia * dt;
+            position += velocity * dt;
+        }
+    };
+
+    static bool near(real_T lhs, real_T rhs, real_T tolerance)
+    {
+        return std::abs(lhs - rhs) <= tolerance;
+    }
+
+    void testTorqueSpeed()
+    {
+        JointActuator actuator(getMotor());
+        testAssert(near(actuator.getStallEffort(), 2.4f, 1E-5f), "stall effort");
+        testAssert(near(actuator.getNoLoadVelocity(), 24, 1E-4f), "no-load velocity");
+
+        actuator.setVoltage(12);
+        for (real_T speed = 0; speed <= 24; speed += 2) {
+            real_T effort = actuator.update(0.001f, 0, speed);
+            real_T expected = 2.4f * (1 - speed / 24);
+            testAssert(near(effort, expected, 1E-4f), "effort should fall linearly with speed");
+        }
+
+        //above the no-load speed the motor brakes
+        testAssert(actuator.update(0.001f, 0, 30) < 0, "motor should brake above no-load speed");
+
+        actuator.setVoltage(100);
+        actuator.update(0.001f, 0, 0);
+        testAssert(actuator.getVoltage() == 12, "voltage should be clipped to the supply");
+    }
+
+    void testCurrentLimit()
+    {
+        UrdfActuator params = getMotor();
+        params.current_limit = 2;
+        JointActuator actuator(params);
+        testAssert(near(actuator.getStallEffort(), 0.8f, 1E-5f), "stall effort should follow the current limit");
+
+        actuator.setVoltage(-12);
+        actuator.update(0.001f, 0, 0);
+        testAssert(actuator.getCurrent() == -2, "current should be clipped");
+        testAssert(near(actuator.getEffort(), -0.8f, 1E-5f), "effort should follow the clipped current");
+
+        //at high speed the back EMF keeps the current under the limit
+        actuator.setVoltage(12);
+        actuator.update(0.001f, 0, 20);
+        testAssert(near(actuator.getCurrent(), 1, 1E-4f), "back EMF should reduce the current");
+    }
+
+    void testElectricalLag()
+    {
+        UrdfActuator params = getMotor();
+        params.inductance = 0.02f; //L/R of 10 ms
+        JointActuator actuator(params);
+
+        actuator.setVoltage(12);
+        for (int i = 0; i < 10; ++i)
+            actuator.update(0.001f, 0, 0);
+        testAssert(near(actuator.getCurrent(), 6 * (1 - std::exp(-1.0f)), 1E-3f), "current should reach 63% after one time constant");
+
+        for (int i = 0; i < 100; ++i)
+            actuator.update(0.001f, 0, 0);
+        testAssert(near(actuator.getCurrent(), 6, 1E-3f), "current should settle at V/R");
+
+        //the lag is exact, so one long step gives the same current as many short ones
+        JointActuator coarse(params);
+        coarse.setVoltage(12);
+        coarse.update(0.01f, 0, 0);
+        testAssert(near(coarse.getCurrent(), 6 * (1 - std::exp(-1.0f)), 1E-3f), "lag should not depend on the step length");
+    }
+
+    void testBacklash()
+    {
+        UrdfActuator params = getMotor();
+        params.backlash = 0.02f;
+        params.rotor_inertia = 1E-5f;
+        JointActuator actuator(params);
+
+        //with the joint held, the rotor first crosses half the gap, then pushes
+        actuator.setVoltage(6);
+        int free_ticks = 0;
+        while (actuator.update(0.0005f, 0, 0) == 0) {
+            testAssert(!actuator.isEngaged(), "no effort should only happen while crossing the gap");
+            testAssert(++free_ticks < 1000, "rotor never crossed the gap");
+        }
+        testAssert(free_ticks > 2, "rotor should take time to cross half the gap");
+        testAssert(actuator.isEngaged() && actuator.getEffort() > 0, "rotor should push once the gap is closed");
+        testAssert(near(actuator.getMotorPosition(), 0.01f, 1E-6f), "rotor should rest at the edge of the gap");
+
+        //reversing crosses the whole gap before any effort comes back
+        actuator.setVoltage(-6);
+        int reverse_ticks = 0;
+        while (actuator.update(0.0005f, 0, 0) == 0)
+            testAssert(++reverse_ticks < 1000, "rotor never crossed back");
+        testAssert(reverse_ticks > free_ticks, "crossing the whole gap should take longer than half of it");
+        testAssert(actuator.getEffort() < 0 && near(actuator.getMotorPosition(), -0.01f, 1E-6f), "rotor should push from the other side");
+
+        //a joint that moves with the rotor sees the same free play on reversal
+        Plant plant;
+        JointActuator servo(params);
+        servo.setPositionTarget(0.5f);
+        for (int i = 0; i < 4000; ++i)
+            plant.step(servo, 0.0005f);
+        servo.setPositionTarget(0);
+        bool lost_contact = false;
+        for (int i = 0; i < 4000; ++i) {
+            plant.step(servo, 0.0005f);
+            lost_contact |= !servo.isEngaged();
+        }
+        testAssert(lost_contact, "reversing a servo should open the gap");
+        testAssert(near(plant.position, 0, 0.02f), "servo should still reach its target within the backlash");
+    }
+
+    void testPositionControl()
+    {
+        Plant plant;
+        plant.load = 0.3f;
+        JointActuator actuator(getMotor());
+        actuator.setPositionTarget(1);
+
+        real_T max_speed = 0;
+        for (int i = 0; i < 3000; ++i) {
+            plant.step(actuator, 0.001f);
+            max_speed = std::max(max_speed, std::abs(plant.velocity));
+        }
+        //the load leaves an error of load / (position_gain * kt / R * ratio * efficiency) = 0.015 rad
+        testAssert(near(plant.position, 1 - 0.015f, 2E-3f), "servo should settle with the expected droop");
+        testAssert(max_speed <= actuator.getNoLoadVelocity(), "servo can't outrun its motor");
+    }
+
+    void testVelocityControl()
+    {
+        Plant plant;
+        JointActuator actuator(getMotor());
+        actuator.setVelocityTarget(5);
+        for (int i = 0; i < 2000; ++i)
+            plant.step(actuator, 0.001f);
+        testAssert(near(plant.velocity, 5, 0.01f), "motor should reach its target speed");
+
+        //an impossible target saturates at the no-load speed
+        actuator.setVelocityTarget(100);
+        for (int i = 0; i < 5000; ++i)
+            plant.step(actuator, 0.001f);
+        testAssert(plant.velocity <= actuator.getNoLoadVelocity() + 1E-3f && plant.velocity > 20, "motor should saturate");
+    }
+
+    void testIdle()
+    {
+        Plant plant;
+        JointActuator actuator(getMotor());
+        actuator.setPositionTarget(0.2f);
+        plant.step(actuator, 0.001f);
+        testAssert(!actuator.isIdle(), "a new command should wake the joint");
+
+        for (int i = 0; i < 5000; ++i)
+            plant.step(actuator, 0.001f);
+        testAssert(actuator.isIdle(), "a joint at rest on its target should be idle");
+
+        actuator.setPositionTarget(0.2f);
+        plant.step(actuator, 0.001f);
+        testAssert(actuator.isIdle(), "repeating a command should not wake the joint");
+
+        actuator.setPositionTarget(0.3f);
+        plant.step(actuator, 0.001f);
+        testAssert(!actuator.isIdle(), "a changed command should wake the joint");
+
+        //holding against a load is never idle
+        plant.load = 0.5f;
+        for (int i = 0; i < 5000; ++i)
+            plant.step(actuator, 0.001f);
+        testAssert(!actuator.isIdle(), "a loaded joint should keep pushing");
+    }
+
+    void testParse()
+    {
+        const std::string links = R"xml(
+  <link name="base"><inertial><mass value="1"/><inertia ixx="1" ixy="0" ixz="0" iyy="1" iyz="0" izz="1"/></inertial>
+    <visual><geometry><box size="1 1 1"/></geometry></visual></link>
+  <link name="arm"><inertial><mass value="1"/><inertia ixx="1" ixy="0" ixz="0" iyy="1" iyz="0" izz="1"/></inertial>
+    <visual><geometry><box size="1 1 1"/></geometry></visual></link>)xml";
+
+        UrdfParser parser;
+        UrdfRobot robot = parser.parseString("<robot name=\"r\">" + links + R"xml(
+  <joint name="shoulder" type="revolute">
+    <parent link="base"/><child link="arm"/>
+    <limit lower="-1" upper="1" effort="10" velocity="2"/>
+    <actuator voltage="24" resistance="0.5" inductance="0.001" torque_constant="0.03" current_limit="8"
+              rotor_inertia="2e-6" gear_ratio="100" gear_efficiency="0.7" backlash="0.001"/>
+  </joint>
+</robot>)xml");
+        const UrdfJoint& joint = robot.joints.at("shoulder");
+        testAssert(joint.has_actuator, "actuator should be parsed");
+        testAssert(joint.actuator.voltage == 24 && joint.actuator.gear_ratio == 100 && joint.actuator.current_limit == 8, "actuator values");
+        testAssert(joint.actuator.position_gain == UrdfActuator().position_gain, "missing values keep their defaults");
+        testAssert(UrdfParser::describe(robot).find("  actuator 24 V") != std::string::npos, "describe should list the actuator");
+
+        expectError(parser, "<robot name=\"r\">" + links + R"xml(
+  <joint name="shoulder" type="revolute">
+    <parent link="base"/><child link="arm"/>
+    <limit lower="-1" upper="1" effort="10" velocity="2"/>
+    <actuator gear_efficiency="1.5"/>
+  </joint>
+</robot>)xml", ":9: the actuator of joint 'shoulder' has a gear_efficiency outside of (0, 1]");
+
+        expectError(parser, "<robot name=\"r\">" + links + R"xml(
+  <joint name="weld" type="fixed">
+    <parent link="base"/><child link="arm"/>
+    <actuator/>
+  </joint>
+</robot>)xml", ":8: joint 'weld' is of type 'fixed', which can't have an actuator");
+    }
+
+    void expectError(UrdfParser& parser, const std::string& xml, const std::string& expected)
+    {
+        try {
+            parser.parseString(xml);
+        }
+        catch (const std::runtime_error& error) {
+            testAssert(std::string(error.what()).find(expected) != std::string::npos, std::string("unexpected error: ") + error.what());
+            return;
+        }
+        testAssert(false, "expected an error containing: " + expected);
+    }
+
+    //a thousand servos with backlash and lag, the cost of the actuator models on a large robot
+    void benchmark()
+    {
+        UrdfActuator params = getMotor();
+        params.inductance = 0.002f;
+        params.backlash = 0.002f;
+        params.rotor_inertia = 1E-5f;
+
+        const int joint_count = 1000, tick_count = 2000;
+        vector<JointActuator> actuators(joint_count, JointActuator(params));
+        vector<Plant> plants(joint_count);
+        for (int i = 0; i < joint_count; ++i)
+            actuators[i].setPositionTarget((i % 20) * 0.05f - 0.5f);
+
+        common_utils::Timer timer;
+        timer.start();
+        real_T checksum = 0;
+        for (int tick = 0; tick < tick_count; ++tick) {
+            for (int i = 0; i < joint_count; ++i)
+                plants[i].step(actuators[i], 0.001f);
+        }
+        for (const auto& plant : plants)
+            checksum += plant.position;
+        double seconds = timer.seconds();
+
+        std::cout << "JointActuatorTest: " << joint_count << " joints x " << tick_count << " ticks in " << seconds << " s, "
+            << (joint_count * tick_count / seconds / 1E6) << " M joint updates/s, checksum " << checksum << std::endl;
+        testAssert(std::isfinite(checksum), "benchmark diverged");
+    }
+};
+
+}}
+#endif
@@ -0,0 +1,235 @@
+#ifndef msr_AirLibUnitTests_JointCouplingTest_hpp
+#define msr_AirLibUnitTests_JointCouplingTest_hpp
+
+#include "TestBase.hpp"
+#include "vehicles/urdfbot/JointCoupling.hpp"
+#include "vehicles/urdfbot/parser/UrdfParser.hpp"
+#include <random>
+
+namespace msr { namespace airlib {
+
+class JointCouplingTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testMimic();
+        testSoftLimits();
+        testVelocityCommands();
+        testCalibration();
+        testErrors();
+        testRandomCommands();
+    }
+
+private:
+    //wrist with a thumb that mimics it, two fingers that close together and a continuous spinner
+    static std::string getGripperUrdf(const std::string& extra_joints = "")
+    {
+        std::string urdf = "<robot name=\"gripper\">\n";
+        vector<std::string> links = { "base", "palm", "thumb", "finger_l", "finger_r", "spinner" };
+        //extra joints connect links a and b
+        if (!extra_joints.empty())
+            links.insert(links.end(), { "a", "b" });
+
+        for (const auto& link : links)
+            urdf += "  <link name=\"" + link + "\"><inertial><mass value=\"0.1\"/>"
+                + "<inertia ixx=\"0.001\" ixy=\"0\" ixz=\"0\" iyy=\"0.001\" iyz=\"0\" izz=\"0.001\"/></inertial>"
+                + "<visual><geometry><box size=\"0.1 0.1 0.1\"/></geometry></visual></link>\n";
+
+        return urdf + R"xml(
+  <joint name="wrist" type="revolute">
+    <parent link="base"/><child link="palm"/>
+    <limit lower="-1.5" upper="1.5" velocity="1" effort="5"/>
+    <safety_controller soft_lower_limit="-1.2" soft_upper_limit="1.2" k_position="10" k_velocity="1"/>
+    <calibration rising="0.25"/>
+  </joint>
+  <joint name="thumb" type="revolute">
+    <parent link="palm"/><child link="thumb"/>
+    <limit lower="-1" upper="1" velocity="2" effort="1"/>
+    <mimic joint="wrist" multiplier="0.5" offset="0.1"/>
+  </joint>
+  <joint name="finger_l" type="prismatic">
+    <parent link="palm"/><child link="finger_l"/>
+    <limit lower="0" upper="0.04" velocity="0.05" effort="10"/>
+  </joint>
+  <joint name="finger_r" type="prismatic">
+    <parent link="palm"/><child link="finger_r"/>
+    <limit lower="-0.03" upper="0" velocity="0.02" effort="10"/>
+    <mimic joint="finger_l" multiplier="-1"/>
+  </joint>
+  <joint name="spin" type="continuous">
+    <parent link="base"/><child link="spinner"/>
+    <limit velocity="3" effort="1"/>
+    <calibration falling="-0.5"/>
+  </joint>
+)xml" + extra_joints + "</robot>";
+    }
+
+    static JointCoupling makeCoupling(const std::string& extra_joints = "")
+    {
+        UrdfParser parser;
+        return JointCoupling(parser.parseString(getGripperUrdf(extra_joints)));
+    }
+
+    static bool near(real_T lhs, real_T rhs, real_T tolerance = 1E-5f)
+    {
+        return std::abs(lhs - rhs) <= tolerance;
+    }
+
+    void testMimic()
+    {
+        JointCoupling coupling = makeCoupling();
+        testAssert(coupling.isFollower("finger_r") && coupling.isFollower("thumb"), "mimic joints should follow");
+        testAssert(!coupling.isFollower("finger_l"), "finger_l leads");
+        testAssert(near(coupling.getPosition("thumb"), 0.1f), "followers should start at their offset from the leader");
+
+        //finger_r only opens to 0.03, so finger_l is held to that as well
+        real_T lower, upper;
+        coupling.getLimits("finger_l", lower, upper);
+        testAssert(near(lower, 0) && near(upper, 0.03f), "follower range should narrow the leader");
+
+        coupling.setPositionTarget("finger_l", 0.04f);
+        const real_T dt = 0.01f;
+        real_T previous = 0;
+        for (int i = 0; i < 300; ++i) {
+            coupling.update(dt);
+            real_T left = coupling.getPosition("finger_l");
+            testAssert(coupling.getPosition("finger_r") == -left, "fingers should stay mirrored on every tick");
+            //the follower limit of 0.02 m/s caps the leader as well
+            testAssert(left - previous <= 0.02f * dt + 1E-6f, "finger_l moved faster than finger_r allows");
+            previous = left;
+        }
+        testAssert(near(coupling.getPosition("finger_l"), 0.03f), "finger_l should stop at the folded limit");
+        testAssert(near(coupling.getPosition("finger_r"), -0.03f), "finger_r should stop at its own limit");
+
+        coupling.resetPosition("finger_l", 0.01f);
+        testAssert(near(coupling.getPosition("finger_r"), -0.01f), "reset should move followers too");
+        coupling.update(dt);
+        testAssert(near(coupling.getPosition("finger_l"), 0.01f), "reset should hold the measured position");
+    }
+
+    void testSoftLimits()
+    {
+        JointCoupling coupling = makeCoupling();
+        coupling.setPositionTarget("wrist", 1.5f);
+
+        const real_T dt = 0.01f;
+        real_T previous_velocity = 2;
+        for (int i = 0; i < 500; ++i) {
+            coupling.update(dt);
+            real_T position = coupling.getPosition("wrist");
+            real_T velocity = coupling.getVelocity("wrist");
+            testAssert(position <= 1.2f, "wrist went past its soft upper limit");
+            testAssert(velocity <= 1 + 1E-5f, "wrist went faster than its velocity limit");
+            testAssert(velocity <= 10 * (1.2f - (position - velocity * dt)) + 1E-4f, "wrist ignored the k_position bound");
+            if (position > 1.15f)
+                testAssert(velocity <= previous_velocity, "wrist should slow down near its soft limit");
+            previous_velocity = velocity;
+
+            testAssert(near(coupling.getPosition("thumb"), 0.5f * position + 0.1f), "thumb should follow the wrist");
+        }
+        testAssert(coupling.getPosition("wrist") > 1.19f, "wrist should settle at its soft limit");
+
+        coupling.setPositionTarget("wrist", -3);
+        for (int i = 0; i < 500; ++i)
+            coupling.update(dt);
+        testAssert(near(coupling.getPosition("wrist"), -1.2f, 1E-2f), "wrist should settle at its soft lower limit");
+        testAssert(coupling.getPosition("wrist") >= -1.2f, "wrist went past its soft lower limit");
+    }
+
+    void testVelocityCommands()
+    {
+        JointCoupling coupling = makeCoupling();
+        coupling.setVelocityTarget("spin", 10);
+        coupling.update(0.1f);
+        testAssert(near(coupling.getVelocity("spin"), 3), "continuous joint velocity should be limited");
+        testAssert(near(coupling.getPosition("spin"), 0.3f), "continuous joint should integrate its velocity");
+
+        //velocity commands on a limited joint stop at the limit
+        coupling.setVelocityTarget("finger_l", 1);
+        for (int i = 0; i < 300; ++i)
+            coupling.update(0.01f);
+        testAssert(near(coupling.getPosition("finger_l"), 0.03f) && coupling.getVelocity("finger_l") == 0, "velocity command should stop at the limit");
+
+        coupling.update(0);
+        testAssert(near(coupling.getPosition("finger_l"), 0.03f), "a zero length tick should not move anything");
+    }
+
+    void testCalibration()
+    {
+        JointCoupling coupling = makeCoupling();
+        testAssert(near(coupling.toCalibrated("wrist", 0.25f), 0), "rising edge should be the wrist reference");
+        testAssert(near(coupling.fromCalibrated("wrist", 0.5f), 0.75f), "calibrated positions are relative to the reference");
+        testAssert(near(coupling.toCalibrated("spin", 0), 0.5f), "falling edge is used when rising is missing");
+        testAssert(near(coupling.toCalibrated("finger_l", 0.02f), 0.02f), "joints without calibration have no offset");
+    }
+
+    void testErrors()
+    {
+        JointCoupling coupling = makeCoupling();
+        expectError([&] { coupling.setPositionTarget("finger_r", 0); }, "mimics 'finger_l'");
+        expectError([&] { coupling.setPositionTarget("nope", 0); }, "Joint 'nope'");
+        expectError([&] { coupling.setPositionTarget("wrist", std::numeric_limits<real_T>::quiet_NaN()); }, "finite");
+
+        const std::string cycle = R"xml(
+  <joint name="a" type="revolute"><parent link="base"/><child link="a"/><limit lower="-1" upper="1" velocity="1" effort="1"/><mimic joint="b"/></joint>
+  <joint name="b" type="revolute"><parent link="base"/><child link="b"/><limit lower="-1" upper="1" velocity="1" effort="1"/><mimic joint="a"/></joint>
+)xml";
+        expectError([&] { makeCoupling(cycle); }, "cycle");
+
+        const std::string disjoint = R"xml(
+  <joint name="a" type="revolute"><parent link="base"/><child link="a"/><limit lower="-1" upper="1" velocity="1" effort="1"/></joint>
+  <joint name="b" type="revolute"><parent link="base"/><child link="b"/><limit lower="-1" upper="1" velocity="1" effort="1"/><mimic joint="a" offset="5"/></joint>
+)xml";
+        expectError([&] { makeCoupling(disjoint); }, "no position");
+
+        const std::string fixed_leader = R"xml(
+  <joint name="a" type="fixed"><parent link="base"/><child link="a"/></joint>
+  <joint name="b" type="revolute"><parent link="base"/><child link="b"/><limit lower="-1" upper="1" velocity="1" effort="1"/><mimic joint="a"/></joint>
+)xml";
+        expectError([&] { makeCoupling(fixed_leader); }, "not a revolute");
+    }
+
+    //random commands at random tick lengths must never break limits or coupling
+    void testRandomCommands()
+    {
+        JointCoupling coupling = makeCoupling();
+        std::mt19937 random(88);
+        std::uniform_real_distribution<float> unit(0, 1);
+
+        real_T wrist = coupling.getPosition("wrist"), finger = coupling.getPosition("finger_l");
+        for (int i = 0; i < 20000; ++i) {
+            if (i % 50 == 0) {
+                coupling.setPositionTarget("wrist", unit(random) * 4 - 2);
+                coupling.setPositionTarget("finger_l", unit(random) * 0.1f - 0.05f);
+            }
+            real_T dt = 0.001f + unit(random) * 0.03f;
+            coupling.update(dt);
+
+            real_T next_wrist = coupling.getPosition("wrist"), next_finger = coupling.getPosition("finger_l");
+            testAssert(next_wrist >= -1.2f && next_wrist <= 1.2f, "wrist left its soft limits");
+            testAssert(std::abs(next_wrist - wrist) <= dt + 1E-5f, "wrist broke its velocity limit");
+            testAssert(next_finger >= 0 && next_finger <= 0.03f, "finger left its limits");
+            testAssert(std::abs(next_finger - finger) <= 0.02f * dt + 1E-6f, "finger broke the follower velocity limit");
+            testAssert(coupling.getPosition("thumb") == 0.5f * next_wrist + 0.1f, "thumb lost its coupling");
+            testAssert(coupling.getPosition("finger_r") == -next_finger, "fingers lost their coupling");
+            wrist = next_wrist;
+            finger = next_finger;
+        }
+    }
+
+    template <typename Func>
+    void expectError(Func func, const std::string& expected)
+    {
+        try {
+            func();
+        }
+        catch (const std::runtime_error& error) {
+            testAssert(std::string(error.what()).find(expected) != std::string::npos, std::string("unexpected error: ") + error.what());
+            return;
+        }
+        testAssert(false, "expected an error containing: " + expected);
+    }
+};
+
+}}
+#endif
@@ -0,0 +1,231 @@
+#ifndef msr_AirLibUnitTests_JointSensorTest_hpp
+#define msr_AirLibUnitTests_JointSensorTest_hpp
+
+#include "TestBase.hpp"
+#include "common/AirSimSettings.hpp"
+#include "common/SteppableClock.hpp"
+#include "sensors/SensorFactory.hpp"
+#include "sensors/joint/JointEncoderSimple.hpp"
+#include "sensors/joint/JointTorqueSimple.hpp"
+
+namespace msr { namespace airlib {
+
+class JointSensorTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testQuantization();
+        testNoise();
+        testEncoder();
+        testTorque();
+        testSettings();
+    }
+
+private:
+    static AirSimSettings::JointChannelSetting makeChannel(const std::string& joint_name, float resolution = 0,
+        float noise_sigma = 0, float bias = 0, float range = 0)
+    {
+        AirSimSettings::JointChannelSetting channel;
+        channel.joint_name = joint_name;
+        channel.resolution = resolution;
+        channel.noise_sigma = noise_sigma;
+        channel.bias = bias;
+        channel.range = range;
+        return channel;
+    }
+
+    void testQuantization()
+    {
+        const real_T count = 2 * M_PIf / 4096;
+        JointChannelParams channel;
+        channel.resolution = count;
+
+        common_utils::RandomGeneratorF truth(-10.0f, 10.0f);
+        double error_sum = 0, error_square_sum = 0;
+        const int samples = 100000;
+        for (int i = 0; i < samples; ++i) {
+            real_T value = truth.next();
+            real_T measured = channel.measure(value, 0);
+            real_T counts = measured / count;
+            testAssert(std::abs(counts - std::round(counts)) < 1E-3f, "measurement is not a whole number of counts");
+            testAssert(std::abs(measured - value) <= count * 0.5f + 1E-5f, "quantization error is more than half a count");
+            error_sum += measured - value;
+            error_square_sum += (measured - value) * (measured - value);
+        }
+        //rounding error is uniform over one count, so unbiased with a deviation of count / sqrt(12)
+        double mean = error_sum / samples;
+        double sigma = std::sqrt(error_square_sum / samples - mean * mean);
+        testAssert(std::abs(mean) < count * 0.01, "quantization should be unbiased");
+        testAssert(std::abs(sigma / (count / std::sqrt(12.0)) - 1) < 0.02, "quantization noise should be count / sqrt(12)");
+
+        testAssert(JointChannelParams::quantize(0.37f, 0) == 0.37f, "zero resolution should leave values alone");
+
+        channel.range = 0.5f;
+        testAssert(channel.measure(3, 0) == 0.5f && channel.measure(-3, 0) == -0.5f, "measurements should saturate at the range");
+    }
+
+    void testNoise()
+    {
+        JointChannelParams channel;
+        channel.noise_sigma = 0.2f;
+        channel.bias = 0.05f;
+
+        RandomGeneratorGausianR noise(0.0f, 1.0f);
+        double sum = 0, square_sum = 0;
+        const int samples = 100000;
+        for (int i = 0; i < samples; ++i) {
+            double error = channel.measure(1, noise.next()) - 1;
+            sum += error;
+            square_sum += error * error;
+        }
+        double mean = sum / samples;
+        double sigma = std::sqrt(square_sum / samples - mean * mean);
+        testAssert(std::abs(mean - 0.05) < 0.005, "noise mean should be the bias");
+        testAssert(std::abs(sigma - 0.2) < 0.005, "noise deviation should be the configured sigma");
+    }
+
+    //a joint that turns at a constant rate, sampled at 100 Hz and delivered 20 ms late
+    void testEncoder()
+    {
+        SteppableClock clock(1E-3f, 1000000000);
+        ClockFactory::DomainScope clock_scope(&clock);
+
+        AirSimSettings::JointEncoderSetting setting;
+        setting.update_frequency = 100;
+        setting.update_latency = 0.02f;
+        setting.joints.push_back(makeChannel("finger", 1E-4f));
+        setting.joints.push_back(makeChannel("wrist", 2 * M_PIf / 1024));
+        JointEncoderSimple encoder(setting);
+        testAssert(encoder.getJointNames() == vector<std::string>({ "finger", "wrist" }), "joints should keep their order");
+
+        const real_T wrist_velocity = 0.7f, finger_velocity = -0.01f;
+        auto truth = [&](const std::string& joint_name, JointSensorBase::JointState& state) {
+            real_T t = static_cast<real_T>(clock.elapsedSince(clock.getStart()));
+            if (joint_name == "wrist")
+                state.position = wrist_velocity * t;
+            else if (joint_name == "finger")
+                state.position = finger_velocity * t;
+            else
+                return false;
+            return true;
+        };
+
+        JointEncoderSimple unconnected(setting);
+        unconnected.reset();
+        unconnected.update();
+        testAssert(!unconnected.getOutput().is_valid, "encoder without a provider can't measure");
+
+        encoder.setJointStateProvider(truth);
+        encoder.reset();
+
+        TTimePoint last_stamp = 0;
+        int outputs = 0;
+        for (int step = 0; step < 2000; ++step) {
+            clock.step();
+            encoder.update();
+
+            const auto& output = encoder.getOutput();
+            if (!output.is_valid || output.time_stamp == last_stamp)
+                continue;
+            ++outputs;
+            if (last_stamp != 0)
+                testAssert(std::abs(ClockBase::elapsedBetween(output.time_stamp, last_stamp) - 0.01) < 1.5E-3, "samples should be 10 ms apart");
+            last_stamp = output.time_stamp;
+
+            testAssert(clock.elapsedSince(output.time_stamp) >= 0.02 - 1E-6, "output arrived before its latency");
+            real_T t = static_cast<real_T>(ClockBase::elapsedBetween(output.time_stamp, clock.getStart()));
+            testAssert(std::abs(output.positions[1] - wrist_velocity * t) <= M_PIf / 1024 + 1E-5f, "wrist position is off by more than half a count");
+            testAssert(std::abs(output.positions[0] - finger_velocity * t) <= 0.5E-4f + 1E-6f, "finger position is off by more than half a count");
+            if (outputs > 2) {
+                //two counts of error over one sample interval
+                testAssert(std::abs(output.velocities[1] - wrist_velocity) <= 2 * M_PIf / 1024 / 0.01f + 1E-3f, "wrist velocity is off");
+                testAssert(std::abs(output.velocities[0] - finger_velocity) <= 1E-4f / 0.01f + 1E-4f, "finger velocity is off");
+            }
+        }
+        testAssert(outputs >= 195 && outputs <= 200, Utils::stringf("expected about 200 samples in 2 s, got %d", outputs));
+
+        std::map<std::string, double> values = encoder.read();
+        testAssert(values.count("JointEncoder-wrist-position") == 1 && values["JointEncoder-IsValid"] == 1, "read() should flatten the arrays");
+
+        setting.joints.push_back(makeChannel("elbow"));
+        JointEncoderSimple missing(setting);
+        missing.setJointStateProvider(truth);
+        missing.reset();
+        missing.update();
+        testAssert(!missing.getOutput().is_valid, "a missing joint should invalidate the output");
+    }
+
+    void testTorque()
+    {
+        SteppableClock clock(1E-3f, 1000000000);
+        ClockFactory::DomainScope clock_scope(&clock);
+
+        AirSimSettings::JointTorqueSetting setting;
+        setting.sensor_type = SensorBase::SensorType::JointTorque;
+        setting.update_frequency = 50;
+        setting.joints.push_back(makeChannel("wrist", 0.01f, 0.05f, 0.1f, 2));
+        unique_ptr<SensorBase> sensor = SensorFactory().createSensorFromSettings(&setting);
+        auto* torque = dynamic_cast<JointTorqueSimple*>(sensor.get());
+        testAssert(torque != nullptr, "factory should create a joint torque sensor");
+
+        real_T effort = 1;
+        torque->setJointStateProvider([&](const std::string&, JointSensorBase::JointState& state) {
+            state.effort = effort;
+            return true;
+        });
+        torque->reset();
+
+        double sum = 0;
+        int outputs = 0;
+        TTimePoint last_stamp = 0;
+        for (int step = 0; step < 20000; ++step) {
+            clock.step();
+            torque->update();
+            const auto& output = torque->getOutput();
+            if (output.time_stamp == last_stamp)
+                continue;
+            last_stamp = output.time_stamp;
+            ++outputs;
+            sum += output.efforts[0];
+            testAssert(std::abs(output.efforts[0] / 0.01f - std::round(output.efforts[0] / 0.01f)) < 1E-3f, "effort is not a whole number of counts");
+        }
+        testAssert(outputs >= 995 && outputs <= 1000, "torque sensor should sample at 50 Hz");
+        testAssert(std::abs(sum / outputs - 1.1) < 0.01, "mean effort should include the bias");
+
+        effort = 10;
+        for (int step = 0; step < 30; ++step) {
+            clock.step();
+            torque->update();
+        }
+        testAssert(torque->getOutput().efforts[0] == 2, "effort should saturate at the range");
+    }
+
+    void testSettings()
+    {
+        AirSimSettings::initializeSettings(R"json({
+            "SettingsVersion": 1.2,
+            "SimMode": "ComputerVision",
+            "DefaultSensors": {
+                "Encoders": {
+                    "SensorType": 7, "Enabled": true, "UpdateFrequency": 500, "CountsPerRevolution": 4096, "NoiseSigma": 0.001,
+                    "Joints": { "wrist": {}, "finger": { "Resolution": 0.0001 } }
+                },
+                "Torque": { "SensorType": 8, "Enabled": true, "Range": 5, "Joints": { "wrist": { "Bias": 0.2 } } }
+            }
+        })json");
+        AirSimSettings settings;
+        settings.load([] { return "ComputerVision"; });
+
+        const auto* encoder = static_cast<const AirSimSettings::JointEncoderSetting*>(settings.sensor_defaults.at("Encoders").get());
+        testAssert(encoder->sensor_type == SensorBase::SensorType::JointEncoder && encoder->update_frequency == 500, "encoder settings were not read");
+        testAssert(encoder->joints.size() == 2 && encoder->joints[0].joint_name == "finger" && encoder->joints[1].joint_name == "wrist", "joints should be sorted by name");
+        testAssert(encoder->joints[0].resolution == 0.0001f && encoder->joints[0].noise_sigma == 0.001f, "joint settings should override sensor defaults");
+        testAssert(std::abs(encoder->joints[1].resolution - 2 * M_PIf / 4096) < 1E-9f, "counts per revolution should set the resolution");
+
+        const auto* torque = static_cast<const AirSimSettings::JointTorqueSetting*>(settings.sensor_defaults.at("Torque").get());
+        testAssert(torque->joints.size() == 1 && torque->joints[0].bias == 0.2f && torque->joints[0].range == 5, "torque settings were not read");
+    }
+};
+
+}}
+#endif
@@ -0,0 +1,225 @@
+#ifndef msr_AirLibUnitTests_MotionClipTest_hpp
+#define msr_AirLibUnitTests_MotionClipTest_hpp
+
+#include "TestBase.hpp"
+#include "common/MotionClipPlayer.hpp"
+#include "common/common_utils/Timer.hpp"
+
+namespace msr { namespace airlib {
+
+class MotionClipTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testParse();
+        testErrors();
+        testInterpolation();
+        testPlayback();
+        testBoneMapping();
+        benchmark();
+    }
+
+private:
+    //root moves 10 cm along x per frame and yaws 90 degrees over the clip, the knee bends 90 degrees
+    static std::string walkClip()
+    {
+        return R"bvh(HIERARCHY
+ROOT Hips
+{
+    OFFSET 0 100 0
+    CHANNELS 6 Xposition Yposition Zposition Zrotation Xrotation Yrotation
+    JOINT LeftKnee
+    {
+        OFFSET 10 -50 0
+        CHANNELS 3 Zrotation Xrotation Yrotation
+        End Site
+        {
+            OFFSET 0 -50 0
+        }
+    }
+    JOINT Spine
+    {
+        OFFSET 0 20 0
+        CHANNELS 3 Zrotation Xrotation Yrotation
+    }
+}
+MOTION
+Frames: 3
+Frame Time: 0.5
+0 0 0 0 0 0   0 0 0    0 0 0
+10 0 0 0 0 45   0 45 0   0 0 0
+20 0 0 0 0 90   0 90 0   0 0 0
+)bvh";
+    }
+
+    static bool near(const Vector3r& a, const Vector3r& b, real_T tolerance = 1E-4f)
+    {
+        return (a - b).norm() < tolerance;
+    }
+
+    static real_T angleBetween(const Quaternionr& a, const Quaternionr& b)
+    {
+        Quaternionr difference = a.conjugate() * b;
+        return 2 * std::atan2(difference.vec().norm(), std::abs(difference.w()));
+    }
+
+    void testParse()
+    {
+        MotionClip clip = BvhParser::parseString(walkClip(), "walk.bvh", 0.01f);
+        testAssert(clip.joints.size() == 3 && clip.frame_count == 3 && clip.frame_time == 0.5, "clip layout was not read");
+        testAssert(clip.getDuration() == 1, "duration runs from the first to the last frame");
+        testAssert(clip.joints[1].name == "LeftKnee" && clip.joints[1].parent == 0 && clip.joints[2].parent == 0, "parents were not read");
+        testAssert(clip.getJointIndex("Spine") == 2 && clip.getJointIndex("Head") == -1, "joint lookup is wrong");
+        testAssert(near(clip.joints[1].offset, Vector3r(0.1f, -0.5f, 0)), "offsets should be scaled");
+
+        const Pose& hips = clip.getPose(2, 0);
+        testAssert(near(hips.position, Vector3r(0.2f, 1, 0)), "translation channels should add to the offset");
+        testAssert(angleBetween(hips.orientation, VectorMath::toQuaternion(Vector3r::UnitY(), M_PIf / 2)) < 1E-4f, "root should yaw 90 degrees");
+
+        //the foot lands in front of the hips when the knee is bent 90 degrees about x
+        const Pose& knee = clip.getPose(2, 1);
+        Vector3r foot = knee.position + knee.orientation._transformVector(Vector3r(0, -0.5f, 0));
+        testAssert(near(foot, Vector3r(0.1f, -0.5f, -0.5f)), "rotation channels were composed wrongly");
+
+        //channels compose in the listed order: Z then X
+        MotionClip ordered = BvhParser::parseString("HIERARCHY ROOT a { OFFSET 0 0 0 CHANNELS 2 Zrotation Xrotation }\n"
+                                                    "MOTION Frames: 1 Frame Time: 0.1\n90 90\n");
+        Quaternionr expected = VectorMath::toQuaternion(Vector3r::UnitZ(), M_PIf / 2) * VectorMath::toQuaternion(Vector3r::UnitX(), M_PIf / 2);
+        testAssert(angleBetween(ordered.getPose(0, 0).orientation, expected) < 1E-4f, "rotations should be intrinsic in channel order");
+    }
+
+    void testErrors()
+    {
+        expectError([] { BvhParser::parseString("HIERARCHY\nROOT a\n{\nOFFSET 0 0 0\nCHANNELS 1 Wrotation\n}\n", "bad.bvh"); }, "bad.bvh:5: unknown channel 'Wrotation'");
+        expectError([] { BvhParser::parseString("HIERARCHY ROOT a { OFFSET 0 0 0 CHANNELS 1 Xposition }\nMOTION\nFrames: 2\nFrame Time: 0.1\n1\n", "short.bvh"); },
+            "short.bvh:6: unexpected end of file");
+        expectError([] { BvhParser::parseString("HIERARCHY ROOT a { OFFSET 0 0 0 CHANNELS 1 Xposition }\nMOTION\nFrames: 1\nFrame Time: 0.1\n1 2\n", "long.bvh"); },
+            "long.bvh:5: unexpected '2'");
+        expectError([] { BvhParser::parseString("HIERARCHY ROOT a { OFFSET 0 x 0 }"); }, "expected a number for the y");
+        expectError([] { BvhParser::parseString("HIERARCHY ROOT a { OFFSET 0 0 0 JOINT a { OFFSET 0 0 0 } }"); }, "defined twice");
+        expectError([] { BvhParser::parseFile("/nonexistent/clip.bvh"); }, "Cannot open");
+
+        MotionClipPlayer player;
+        expectError([&] { player.setTimeWarp({ { 0, 0 }, { 0, 1 } }); }, "increasing play times");
+    }
+
+    void testInterpolation()
+    {
+        MotionClip clip = BvhParser::parseString(walkClip(), "walk.bvh", 0.01f);
+
+        Pose half = MotionClipPlayer::sample(clip, 0, 0.25);
+        testAssert(near(half.position, Vector3r(0.05f, 1, 0)), "positions should interpolate linearly");
+        testAssert(angleBetween(half.orientation, VectorMath::toQuaternion(Vector3r::UnitY(), M_PIf / 8)) < 1E-4f, "orientations should slerp");
+
+        testAssert(MotionClipPlayer::sample(clip, 1, 1) == clip.getPose(2, 1), "the last frame should be exact");
+        testAssert(MotionClipPlayer::sample(clip, 1, 7) == clip.getPose(2, 1) && MotionClipPlayer::sample(clip, 1, -1) == clip.getPose(0, 1),
+            "times outside the clip should clamp");
+    }
+
+    void testPlayback()
+    {
+        auto clip = std::make_shared<const MotionClip>(BvhParser::parseString(walkClip(), "walk.bvh", 0.01f));
+        MotionClipPlayer player(clip);
+
+        player.setRate(2);
+        player.update(0.25);
+        testAssert(std::abs(player.getClipTime() - 0.5) < 1E-9, "rate should scale elapsed time");
+        testAssert(near(player.getBonePoses()[0].position, Vector3r(0.1f, 1, 0)), "poses should follow the clip time");
+        player.update(0.5);
+        testAssert(player.isFinished() && player.getClipTime() == 1, "a clip that doesn't loop should stop on its last frame");
+
+        player.setLoop(true);
+        player.seek(2.25);
+        testAssert(!player.isFinished() && std::abs(player.getClipTime() - 0.25) < 1E-9, "looping should wrap the clip time");
+
+        //hold the first frame for a second, then play the clip at half speed
+        player.setLoop(false);
+        player.setRate(1);
+        player.setTimeWarp({ { 0, 0 }, { 1, 0 }, { 3, 1 } });
+        player.seek(0);
+        player.update(0.9);
+        testAssert(player.getClipTime() == 0, "time warp should hold the first frame");
+        player.update(1.1);
+        testAssert(std::abs(player.getClipTime() - 0.5) < 1E-9, "time warp should play at half speed");
+        testAssert(!player.isFinished(), "clip should still be playing");
+        player.update(1);
+        testAssert(player.isFinished(), "clip should end at the last key");
+
+        player.setTimeWarp({});
+        player.setRate(-1);
+        player.seek(0.5);
+        player.update(0.25);
+        testAssert(std::abs(player.getClipTime() - 0.25) < 1E-9, "negative rates should play backwards");
+        player.update(1);
+        testAssert(player.isFinished() && player.getClipTime() == 0, "playing backwards should stop on the first frame");
+    }
+
+    void testBoneMapping()
+    {
+        auto clip = std::make_shared<const MotionClip>(BvhParser::parseString(walkClip(), "walk.bvh", 0.01f));
+        MotionClipPlayer player(clip);
+        testAssert(player.getBoneIndices() == vector<int>({ 0, 1, 2 }), "an unmapped clip should use the joint indices");
+
+        vector<std::string> skeleton = { "root", "pelvis", "spine", "knee_l" };
+        uint matched = player.mapBones(skeleton, { { "Hips", "pelvis" }, { "LeftKnee", "knee_l" } });
+        testAssert(matched == 3 && player.getBoneIndices() == vector<int>({ 1, 3, 2 }), "bones should map by rename, then ignoring case");
+
+        matched = player.mapBones({ "Hips" });
+        testAssert(matched == 1 && player.getBonePoses().size() == 1, "joints without a bone should be skipped");
+    }
+
+    //a 60 joint skeleton posed at a 1 kHz tick
+    void benchmark()
+    {
+        std::ostringstream bvh;
+        bvh << "HIERARCHY\nROOT j0\n{\nOFFSET 0 0 0\nCHANNELS 6 Xposition Yposition Zposition Zrotation Xrotation Yrotation\n";
+        const int joint_count = 60, frame_count = 240;
+        for (int i = 1; i < joint_count; ++i)
+            bvh << "JOINT j" << i << "\n{\nOFFSET 0 1 0\nCHANNELS 3 Zrotation Xrotation Yrotation\n";
+        for (int i = 0; i < joint_count; ++i)
+            bvh << "}\n";
+        bvh << "MOTION\nFrames: " << frame_count << "\nFrame Time: 0.0333333\n";
+        for (int frame = 0; frame < frame_count; ++frame) {
+            bvh << "0 0 " << frame;
+            for (int i = 0; i < joint_count; ++i)
+                bvh << " " << (frame % 30) << " " << (i % 7) << " " << -frame;
+            bvh << "\n";
+        }
+
+        common_utils::Timer timer;
+        timer.start();
+        auto clip = std::make_shared<const MotionClip>(BvhParser::parseString(bvh.str()));
+        double parse_seconds = timer.seconds();
+        testAssert(clip->joints.size() == static_cast<uint>(joint_count) && clip->joints.back().parent == joint_count - 2, "generated chain was not read");
+
+        MotionClipPlayer player(clip);
+        player.setLoop(true);
+        const int ticks = 20000;
+        timer.start();
+        real_T checksum = 0;
+        for (int i = 0; i < ticks; ++i) {
+            player.update(1E-3);
+            checksum += player.getBonePoses().back().orientation.w();
+        }
+        double seconds = timer.seconds();
+        testAssert(std::isfinite(checksum), "poses should be finite");
+        std::cout << "MotionClipPlayer: parsed " << frame_count << " frames in " << parse_seconds * 1E3 << " ms, "
+                  << ticks / seconds / 1E3 << " k skeleton updates/s" << std::endl;
+    }
+
+    template <typename Func>
+    void expectError(Func func, const std::string& expected)
+    {
+        try {
+            func();
+        }
+        catch (const std::exception& error) {
+            testAssert(std::string(error.what()).find(expected) != std::string::npos, std::string("unexpected error: ") + error.what());
+            return;
+        }
+        testAssert(false, "expected an error containing: " + expected);
+    }
+};
+
+}}
+#endif
@@ -0,0 +1,304 @@
+#ifndef msr_AirLibUnitTests_OpticalFlowTest_hpp
+#define msr_AirLibUnitTests_OpticalFlowTest_hpp
+
+#include "TestBase.hpp"
+#include "camera/OpticalFlowGenerator.hpp"
+#include "raycast/StaticSceneImageCapture.hpp"
+#include "common/common_utils/Timer.hpp"
+#include <random>
+
+namespace msr { namespace airlib {
+
+class OpticalFlowTest : public TestBase {
+    typedef OpticalFlowGenerator::Frame Frame;
+    typedef OpticalFlowGenerator::Intrinsics Intrinsics;
+    typedef ImageCaptureBase::ImageType ImageType;
+    typedef ImageCaptureBase::ImageRequest ImageRequest;
+    typedef ImageCaptureBase::ImageResponse ImageResponse;
+
+public:
+    virtual void run() override
+    {
+        testProjectionMatrix();
+        testForwardMotion();
+        testSideMotion();
+        testRotation();
+        testInvalidPixels();
+        testMasking();
+        testGeneralMotion();
+        testStaticSceneCapture();
+        benchmark();
+    }
+
+private:
+    static Frame makeFrame(const vector<float>& depth, int width, int height, const Intrinsics& intrinsics, const Pose& pose)
+    {
+        Frame frame;
+        frame.planar_depth = depth.data();
+        frame.width = width;
+        frame.height = height;
+        frame.intrinsics = intrinsics;
+        frame.pose = pose;
+        return frame;
+    }
+
+    //flow of pixel x, y with depth from previous to pose in double precision, infinite depth is a direction
+    static Eigen::Vector2d expectedFlow(int x, int y, double depth, const Intrinsics& k, const Pose& previous, const Pose& pose)
+    {
+        const double a = (x + 0.5 - k.cx) / k.fx, b = (y + 0.5 - k.cy) / k.fy;
+        const Eigen::Vector3d ray(1, a, b);
+        const Eigen::Quaterniond orientation = pose.orientation.cast<double>(), previous_orientation = previous.orientation.cast<double>();
+        Eigen::Vector3d point;
+        if (std::isinf(depth))
+            point = previous_orientation.inverse() * (orientation * ray);
+        else
+            point = previous_orientation.inverse() * (orientation * (ray * depth) + (pose.position - previous.position).cast<double>());
+        return Eigen::Vector2d(x + 0.5 - (k.cx + k.fx * point.y() / point.x()), y + 0.5 - (k.cy + k.fy * point.z() / point.x()));
+    }
+
+    void checkFlow(const vector<float>& flow, int x, int y, int width, const Eigen::Vector2d& expected, double tolerance, const char* scene)
+    {
+        const float u = flow[(y * width + x) * 2], v = flow[(y * width + x) * 2 + 1];
+        testAssert(std::abs(u - expected.x()) < tolerance && std::abs(v - expected.y()) < tolerance,
+            Utils::stringf("%s: flow at %d, %d is %f, %f, expected %f, %f", scene, x, y, u, v, expected.x(), expected.y()));
+    }
+
+    void testProjectionMatrix()
+    {
+        //what APIPCamera::getProjectionMatrix returns for a 90 degree camera of 256 x 144 pixels
+        ProjectionMatrix projection;
+        projection.setTo(0);
+        projection.matrix[0][0] = 1;
+        projection.matrix[1][1] = 256.0f / 144;
+        projection.matrix[2][3] = 1;
+        projection.matrix[3][2] = 10;
+        Intrinsics k = Intrinsics::fromProjectionMatrix(projection, 256, 144);
+        testAssert(std::abs(k.fx - 128) < 1E-4f && std::abs(k.fy - 128) < 1E-4f && k.cx == 128 && k.cy == 72,
+            Utils::stringf("intrinsics are %f, %f, %f, %f", k.fx, k.fy, k.cx, k.cy));
+
+        projection.matrix[2][3] = 0;
+        projection.matrix[3][3] = 1;
+        expectError([&] { Intrinsics::fromProjectionMatrix(projection, 256, 144); }, "orthographic");
+        projection.setTo(Utils::nan<float>());
+        expectError([&] { Intrinsics::fromProjectionMatrix(projection, 256, 144); }, "not available");
+    }
+
+    //camera moving 1 m towards a wall 5 m away, every pixel moves away from the center by its distance over 5
+    void testForwardMotion()
+    {
+        const int width = 40, height = 30;
+        const Intrinsics k(20, 20, 20, 15);
+        vector<float> depth(width * height, 5.0f);
+        OpticalFlowGenerator generator;
+        vector<float> flow;
+        generator.addFrame(makeFrame(depth, width, height, k, Pose(Vector3r(-1, 0, 0), Quaternionr::Identity())), flow);
+        for (float value : flow)
+            testAssert(value == 0, "the first frame should have zero flow");
+
+        generator.addFrame(makeFrame(depth, width, height, k, Pose()), flow);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                const Eigen::Vector2d expected((x + 0.5 - 20) / 6, (y + 0.5 - 15) / 6);
+                checkFlow(flow, x, y, width, expected, 1E-4, "forward");
+            }
+        }
+    }
+
+    //moving right by 0.5 m moves everything 2 m away left by fx / 4
+    void testSideMotion()
+    {
+        const int width = 33, height = 7;
+        const Intrinsics k(100, 80, 16.5f, 3.5f);
+        vector<float> depth(width * height, 2.0f);
+        OpticalFlowGenerator generator;
+        vector<float> flow;
+        generator.computeFlow(makeFrame(depth, width, height, k, Pose(Vector3r(3, 1.5f, -2), Quaternionr::Identity())),
+            Pose(Vector3r(3, 1, -2), Quaternionr::Identity()), flow);
+        for (int pixel = 0; pixel < width * height; ++pixel) {
+            testAssert(std::abs(flow[pixel * 2] + 25) < 1E-4f && std::abs(flow[pixel * 2 + 1]) < 1E-4f,
+                Utils::stringf("side flow at %d is %f, %f", pixel, flow[pixel * 2], flow[pixel * 2 + 1]));
+        }
+    }
+
+    //pure rotation moves pixels at infinite depth like a homography, and translation does not change that
+    void testRotation()
+    {
+        const int width = 64, height = 48;
+        const Intrinsics k(50, 50, 32, 24);
+        vector<float> depth(width * height, std::numeric_limits<float>::infinity());
+        const Pose previous(Vector3r(0, 0, 0), VectorMath::toQuaternion(0.02f, 0.01f, 0.3f));
+        const Pose pose(Vector3r(4, -2, 1), VectorMath::toQuaternion(-0.05f, 0, 0.25f));
+        OpticalFlowGenerator generator;
+        vector<float> flow;
+        generator.computeFlow(makeFrame(depth, width, height, k, pose), previous, flow);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x)
+                checkFlow(flow, x, y, width, expectedFlow(x, y, depth[0], k, previous, pose), 2E-3, "rotation");
+        }
+        //turning left by 0.05 rad moves the scene right by about fx * 0.05
+        testAssert(flow[(24 * width + 32) * 2] > 2.3f && flow[(24 * width + 32) * 2] < 2.7f, "yaw should move the center sideways");
+    }
+
+    void testInvalidPixels()
+    {
+        const int width = 9, height = 2;
+        const Intrinsics k(10, 10, 4.5f, 1);
+        vector<float> depth(width * height, 3.0f);
+        depth[1] = std::numeric_limits<float>::quiet_NaN();
+        depth[6] = 0;
+        depth[9 + 8] = -1;
+        //points 3 m ahead end up behind a camera that was 4 m further ahead
+        OpticalFlowGenerator generator;
+        vector<float> flow;
+        generator.computeFlow(makeFrame(depth, width, height, k, Pose()), Pose(Vector3r(4, 0, 0), Quaternionr::Identity()), flow);
+        for (float value : flow)
+            testAssert(std::isnan(value), "points behind the previous camera should have nan flow");
+
+        generator.computeFlow(makeFrame(depth, width, height, k, Pose()), Pose(Vector3r(-1, 0, 0), Quaternionr::Identity()), flow);
+        for (int pixel = 0; pixel < width * height; ++pixel) {
+            bool invalid = pixel == 1 || pixel == 6 || pixel == 17;
+            testAssert(std::isnan(flow[pixel * 2]) == invalid && std::isnan(flow[pixel * 2 + 1]) == invalid,
+                Utils::stringf("only pixels without a valid depth should have nan flow, pixel %d", pixel));
+        }
+
+        expectError([&] { generator.computeFlow(makeFrame(depth, 0, height, k, Pose()), Pose(), flow); }, "at least 1x1");
+        expectError([&] { generator.computeFlow(makeFrame(depth, width, height, Intrinsics(0, 10, 4.5f, 1), Pose()), Pose(), flow); },
+            "positive focal lengths");
+    }
+
+    void testMasking()
+    {
+        const int width = 11, height = 5;
+        const Intrinsics k(10, 10, 5.5f, 2.5f);
+        vector<float> depth(width * height, 3.0f);
+        //RGBA Infrared image with object ID 7 on the left half and 200 on the right
+        vector<uint8_t> infrared(width * height * 4, 255);
+        for (int pixel = 0; pixel < width * height; ++pixel)
+            infrared[pixel * 4] = pixel % width < width / 2 ? 7 : 200;
+
+        AirSimSettings::OpticalFlowSetting setting;
+        setting.masked_object_ids = { 200, 3 };
+        OpticalFlowGenerator generator(setting);
+        testAssert(generator.needsObjectIDs(), "masked IDs need object IDs");
+        Frame frame = makeFrame(depth, width, height, k, Pose(Vector3r(0, 1, 0), Quaternionr::Identity()));
+        vector<float> flow;
+        expectError([&] { generator.addFrame(frame, flow); }, "has none");
+        frame.object_ids = infrared.data();
+        frame.object_id_stride = 4;
+        generator.computeFlow(frame, Pose(), flow);
+        for (int pixel = 0; pixel < width * height; ++pixel) {
+            bool masked = pixel % width >= width / 2;
+            testAssert(std::isnan(flow[pixel * 2]) == masked && std::isnan(flow[pixel * 2 + 1]) == masked,
+                Utils::stringf("pixel %d of object %d is masked wrong", pixel, infrared[pixel * 4]));
+        }
+
+        setting.masked_object_ids = { 256 };
+        expectError([&] { OpticalFlowGenerator invalid(setting); }, "between 0 and 255, got 256");
+    }
+
+    //random depths and motion against the double precision reference, with the same result on any number of threads
+    void testGeneralMotion()
+    {
+        const int width = 67, height = 23; //not a multiple of four, so every row has a scalar tail
+        const Intrinsics k(40, 45, 33, 12);
+        std::mt19937 random(5);
+        std::uniform_real_distribution<float> depth_distribution(1, 50);
+        vector<float> depth(width * height);
+        for (float& value : depth)
+            value = depth_distribution(random);
+        const Pose previous(Vector3r(1, 2, -3), VectorMath::toQuaternion(0.1f, -0.05f, 1.2f));
+        const Pose pose(Vector3r(1.4f, 2.3f, -3.1f), VectorMath::toQuaternion(0.12f, -0.02f, 1.25f));
+
+        OpticalFlowGenerator generator;
+        vector<float> flow, threaded_flow;
+        generator.setThreadCount(1);
+        generator.computeFlow(makeFrame(depth, width, height, k, pose), previous, flow);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x)
+                checkFlow(flow, x, y, width, expectedFlow(x, y, depth[y * width + x], k, previous, pose), 2E-3, "general");
+        }
+
+        for (uint threads : { 3u, 0u }) {
+            generator.setThreadCount(threads);
+            generator.computeFlow(makeFrame(depth, width, height, k, pose), previous, threaded_flow);
+            testAssert(threaded_flow == flow, Utils::stringf("flow on %u threads differs from one thread", threads));
+        }
+    }
+
+    //a camera moving towards a wall of a StaticScene sees the same flow as from its depth
+    void testStaticSceneCapture()
+    {
+        auto scene = std::make_shared<StaticScene>();
+        scene->addMesh(TriangleMesh::box(Vector3r(1, 100, 100)), Pose(Vector3r(10, 0, 0), Quaternionr::Identity()));
+        StaticSceneImageCapture capture(scene);
+        AirSimSettings::CameraSetting camera;
+        camera.capture_settings[Utils::toNumeric(ImageType::DepthPlanner)].width = 64;
+        camera.capture_settings[Utils::toNumeric(ImageType::DepthPlanner)].height = 48;
+        capture.addCamera("0", camera);
+
+        const vector<ImageRequest> requests = { ImageRequest("0", ImageType::OpticalFlow, true, false) };
+        vector<ImageResponse> responses;
+        capture.getImages(requests, responses);
+        testAssert(responses[0].message.empty() && responses[0].width == 64 && responses[0].height == 48
+            && responses[0].image_data_float.size() == 64 * 48 * 2, "flow should have u and v per pixel of the DepthPlanner capture");
+
+        capture.setVehiclePose(Pose(Vector3r(1.5f, 0, 0), Quaternionr::Identity()));
+        responses.clear();
+        capture.getImages(requests, responses);
+        //the wall is 8 m away after moving 1.5 m, and the focal length is 32 pixels
+        const Intrinsics k(32, 32, 32, 24);
+        for (int y = 0; y < 48; ++y) {
+            for (int x = 0; x < 64; ++x) {
+                checkFlow(responses[0].image_data_float, x, y, 64,
+                    expectedFlow(x, y, 8, k, Pose(), Pose(Vector3r(1.5f, 0, 0), Quaternionr::Identity())), 1E-3, "static scene");
+            }
+        }
+
+        responses.clear();
+        capture.getImages({ ImageRequest("0", ImageType::OpticalFlow, false, false) }, responses);
+        testAssert(responses[0].message.find("pixels_as_float") != std::string::npos, "uint8 flow images should be refused");
+    }
+
+    void benchmark()
+    {
+        const int width = 1280, height = 720;
+        const Intrinsics k(640, 640, 640, 360);
+        vector<float> depth(width * height);
+        std::mt19937 random(3);
+        std::uniform_real_distribution<float> depth_distribution(1, 100);
+        for (float& value : depth)
+            value = depth_distribution(random);
+        OpticalFlowGenerator generator;
+        vector<float> flow;
+        Frame frame = makeFrame(depth, width, height, k, Pose());
+        const int frames = 50;
+
+        for (uint threads : { 1u, 0u }) {
+            generator.setThreadCount(threads);
+            common_utils::Timer timer;
+            timer.start();
+            for (int i = 0; i < frames; ++i) {
+                frame.pose = Pose(Vector3r(i * 0.1f, 0, 0), VectorMath::toQuaternion(0, 0, i * 0.01f));
+                generator.addFrame(frame, flow);
+            }
+            std::cout << "OpticalFlowGenerator: " << timer.seconds() / frames * 1E3 << " ms per 1280x720 frame on "
+                      << (threads == 0 ? "all" : "one") << " thread" << (threads == 0 ? "s" : "") << std::endl;
+        }
+    }
+
+    template <typename Func>
+    void expectError(Func func, const std::string& expected)
+    {
+        try {
+            func();
+        }
+        catch (const std::invalid_argument& error) {
+            testAssert(std::string(error.what()).find(expected) != std::string::npos, std::string("unexpected error: ") + error.what());
+            return;
+        }
+        testAssert(false, "expected an error containing: " + expected);
+    }
+};
+
+}}
+#endif
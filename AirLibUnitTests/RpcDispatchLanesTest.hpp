@@ -0,0 +1,243 @@
+#ifndef msr_AirLibUnitTests_RpcDispatchLanesTest_hpp
+#define msr_AirLibUnitTests_RpcDispatchLanesTest_hpp
+
+#include "TestBase.hpp"
+#include "api/RpcDispatchLanes.hpp"
+#include "api/RpcSessionLog.hpp"
+#include "common/common_utils/Timer.hpp"
+#include <future>
+#include <thread>
+
+STRICT_MODE_OFF
+#ifndef RPCLIB_MSGPACK
+#define RPCLIB_MSGPACK clmdep_msgpack
+#endif // !RPCLIB_MSGPACK
+#include "common/common_utils/WindowsApisCommonPre.hpp"
+#undef FLOAT
+#undef check
+#include "rpc/server.h"
+#include "rpc/client.h"
+#ifndef check
+#define check(expr) (static_cast<void>((expr)))
+#endif
+#include "common/common_utils/WindowsApisCommonPost.hpp"
+#include "api/RpcLibServerCore.hpp"
+STRICT_MODE_ON
+
+namespace msr { namespace airlib {
+
+class RpcDispatchLanesTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testClassification();
+        testAdmission();
+        testOrder();
+        testSettings();
+        benchmarkLoopback();
+    }
+
+private:
+    typedef RpcDispatchLanes::LaneType LaneType;
+
+    void waitForQueued(const RpcDispatchLanes& lanes, LaneType lane, uint queued)
+    {
+        for (int i = 0; i < 1000 && lanes.getLaneStatus(lane).queued < queued; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        testAssert(lanes.getLaneStatus(lane).queued == queued, "calls should be waiting for a worker");
+    }
+
+    void testClassification()
+    {
+        RpcDispatchLanes lanes;
+        testAssert(lanes.addMethod("setCarControls").lane == static_cast<int>(LaneType::Control), "car controls should be control calls");
+        testAssert(lanes.getMethodLane("getMultirotorState") == LaneType::Control, "state queries should be control calls");
+        testAssert(lanes.getMethodLane("simGetImages") == LaneType::Bulk, "images should be bulk calls");
+        testAssert(lanes.getMethodLane("moveToPosition") == LaneType::Default, "blocking maneuvers should be in the default lane");
+        testAssert(lanes.getMethodLane("moveByVelocity") == LaneType::Default, "moves that fly for a duration block, so they are not control calls");
+
+        const RpcDispatchLanes::Method& method = lanes.addMethod("simRayCast");
+        lanes.setMethodLane("simRayCast", LaneType::Bulk);
+        testAssert(method.lane == static_cast<int>(LaneType::Bulk), "bound methods should follow lane changes");
+        lanes.setMethodLane("simGetLidarSegmentation", LaneType::Control);
+        testAssert(lanes.addMethod("simGetLidarSegmentation").lane == static_cast<int>(LaneType::Control), "methods bound later should get their lane");
+
+        testAssert(RpcDispatchLanes::getLaneType("Bulk") == LaneType::Bulk, "lane names should ignore case");
+        expectError([] { RpcDispatchLanes::getLaneType("Fast"); }, "Unknown RPC lane 'Fast'");
+        expectError([&] { lanes.setLaneSettings(LaneType::Bulk, RpcDispatchLanes::LaneSettings(0, 1)); }, "at least one worker");
+    }
+
+    void testAdmission()
+    {
+        RpcDispatchLanes lanes;
+        lanes.setLaneSettings(LaneType::Bulk, RpcDispatchLanes::LaneSettings(1, 1));
+        const RpcDispatchLanes::Method& images = lanes.addMethod("simGetImages");
+        const RpcDispatchLanes::Method& state = lanes.addMethod("getCarState");
+
+        std::promise<void> release;
+        std::shared_future<void> released = release.get_future().share();
+        auto call = [&]() {
+            RpcDispatchLanes::Admission admission(lanes, images);
+            released.wait();
+        };
+        std::thread running(call);
+        for (int i = 0; i < 1000 && lanes.getLaneStatus(LaneType::Bulk).running == 0; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::thread waiting(call);
+        waitForQueued(lanes, LaneType::Bulk, 1);
+
+        bool rejected = false;
+        try {
+            RpcDispatchLanes::Admission admission(lanes, images);
+        }
+        catch (const RpcServerBusy& error) {
+            rejected = std::string(error.what()).find("simGetImages was rejected because the bulk lane") != std::string::npos;
+        }
+        testAssert(rejected, "a call beyond the queue limit should be told the server is busy");
+        {
+            RpcDispatchLanes::Admission admission(lanes, state);
+            testAssert(lanes.getLaneStatus(LaneType::Control).running == 1, "a full bulk lane should not hold up control calls");
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        release.set_value();
+        running.join();
+        waiting.join();
+
+        RpcDispatchLanes::LaneStatus status = lanes.getLaneStatus(LaneType::Bulk);
+        testAssert(status.admitted_count == 2 && status.rejected_count == 1 && status.running == 0 && status.queued == 0, "lane counters are wrong");
+        testAssert(status.max_wait >= 4E-3, "the queued call should have waited for the worker");
+    }
+
+    void testOrder()
+    {
+        RpcDispatchLanes lanes;
+        lanes.setLaneSettings(LaneType::Default, RpcDispatchLanes::LaneSettings(1, 3));
+        const RpcDispatchLanes::Method& method = lanes.addMethod("moveOnPath");
+
+        std::promise<void> release;
+        std::shared_future<void> released = release.get_future().share();
+        std::mutex order_mutex;
+        vector<int> order;
+        vector<std::thread> calls;
+        for (int i = 0; i < 4; ++i) {
+            calls.emplace_back([&, i]() {
+                RpcDispatchLanes::Admission admission(lanes, method);
+                {
+                    std::lock_guard<std::mutex> lock(order_mutex);
+                    order.push_back(i);
+                }
+                released.wait();
+            });
+            //the first call runs, the rest queue up one at a time
+            if (i == 0) {
+                for (int k = 0; k < 1000 && lanes.getLaneStatus(LaneType::Default).running == 0; ++k)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            else
+                waitForQueued(lanes, LaneType::Default, i);
+        }
+        release.set_value();
+        for (auto& call : calls)
+            call.join();
+        testAssert(order == vector<int>({ 0, 1, 2, 3 }), "waiting calls should be admitted in arrival order");
+    }
+
+    void testSettings()
+    {
+        RpcDispatchLanes lanes;
+        testAssert(lanes.getThreadCount() == 28, "default lanes should hold 28 calls");
+        lanes.setLaneSettings(LaneType::Bulk, RpcDispatchLanes::LaneSettings(1, 0));
+        testAssert(lanes.getThreadCount() == 25, "thread count should follow the lane settings");
+    }
+
+    //control calls while eight clients keep asking for 20 ms, 256 kB image requests
+    //latencies depend on the machine, so they are only printed
+    void benchmarkLoopback()
+    {
+        measureUnderLoad(false);
+        measureUnderLoad(true);
+    }
+
+    void measureUnderLoad(bool use_lanes)
+    {
+        //port 0 lets the system pick a free port
+        RpcLibServerCore server("127.0.0.1", 0);
+        const uint16_t port = server.port();
+        server.suppress_exceptions(true);
+        auto get_images = [](int camera) -> std::vector<uint8_t> {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            return std::vector<uint8_t>(256 * 1024, static_cast<uint8_t>(camera));
+        };
+        auto get_state = []() -> std::vector<float> { return std::vector<float>(20, 1.0f); };
+        if (use_lanes) {
+            server.bind("simGetImages", get_images);
+            server.bind("getMultirotorState", get_state);
+            server.startDispatch();
+        }
+        else {
+            //the pool every call shared before there were lanes
+            server.rpc::server::bind("simGetImages", get_images);
+            server.rpc::server::bind("getMultirotorState", get_state);
+            server.async_run(4);
+        }
+
+        std::atomic<bool> stop(false);
+        std::atomic<uint> images(0), busy(0);
+        vector<std::thread> image_clients;
+        for (int i = 0; i < 8; ++i) {
+            image_clients.emplace_back([&, i]() {
+                rpc::client client("127.0.0.1", port);
+                while (!stop) {
+                    try {
+                        client.call("simGetImages", i).as<std::vector<uint8_t>>();
+                        ++images;
+                    }
+                    catch (const rpc::rpc_error&) {
+                        ++busy;
+                        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                    }
+                }
+            });
+        }
+
+        RpcLatencyReport report;
+        {
+            rpc::client client("127.0.0.1", port);
+            client.call("getMultirotorState");
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            common_utils::Timer timer;
+            for (int i = 0; i < 300; ++i) {
+                timer.start();
+                client.call("getMultirotorState").as<std::vector<float>>();
+                report.add("getMultirotorState", timer.seconds());
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        }
+        stop = true;
+        for (auto& client : image_clients)
+            client.join();
+        server.stop();
+
+        RpcLatencyReport::MethodStats stats = report.getStats()[0];
+        std::cout << "RPC loopback, " << (use_lanes ? "dispatch lanes" : "one shared pool of 4 threads") << ": getMultirotorState p50 "
+                  << stats.p50 * 1E3 << " ms, p99 " << stats.p99 * 1E3 << " ms, max " << stats.max * 1E3 << " ms with "
+                  << images << " image calls served and " << busy << " turned away" << std::endl;
+    }
+
+    template <typename Func>
+    void expectError(Func func, const std::string& expected)
+    {
+        try {
+            func();
+        }
+        catch (const std::invalid_argument& error) {
+            testAssert(std::string(error.what()).find(expected) != std::string::npos, std::string("unexpected error: ") + error.what());
+            return;
+        }
+        testAssert(false, "expected an error containing: " + expected);
+    }
+};
+
+}}
+#endif
@@ -0,0 +1,211 @@
+#ifndef msr_AirLibUnitTests_RpcSessionLogTest_hpp
+#define msr_AirLibUnitTests_RpcSessionLogTest_hpp
+
+#include "TestBase.hpp"
+#include "api/RpcSessionLog.hpp"
+#include "common/common_utils/Timer.hpp"
+#include <cstdio>
+
+namespace msr { namespace airlib {
+
+class RpcSessionLogTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testRoundTrip();
+        testTruncated();
+        testErrors();
+        testRecorder();
+        testReport();
+        benchmark();
+        std::remove(kLogPath);
+    }
+
+private:
+    static constexpr const char* kLogPath = "RpcSessionLogTest.log";
+
+    static RpcCallRecord makeRecord(const std::string& method, uint64_t offset, uint64_t latency, const std::string& args, bool failed = false)
+    {
+        RpcCallRecord record;
+        record.method = method;
+        record.sim_time = 1000000000ULL + offset;
+        record.offset = offset;
+        record.latency = latency;
+        record.result_size = args.size() * 3;
+        record.failed = failed;
+        record.args = args;
+        return record;
+    }
+
+    static bool same(const RpcCallRecord& a, const RpcCallRecord& b)
+    {
+        return a.method == b.method && a.sim_time == b.sim_time && a.offset == b.offset && a.latency == b.latency
+            && a.result_size == b.result_size && a.failed == b.failed && a.args == b.args;
+    }
+
+    void testRoundTrip()
+    {
+        //written in the order the calls finished
+        vector<RpcCallRecord> written = {
+            makeRecord("getMultirotorState", 300, 50, std::string("\x91\xa0", 2)),
+            makeRecord("simGetImages", 100, 900000000000ULL, std::string("\x92\x90\x00\xff", 4)),
+            makeRecord("getMultirotorState", 200, 40, std::string("\x91\xa0", 2), true),
+            makeRecord("ping", 400, 1, "")
+        };
+        {
+            RpcSessionLog::Writer writer(kLogPath);
+            for (const auto& record : written)
+                writer.write(record);
+        }
+
+        RpcSessionLog::Reader reader(kLogPath);
+        vector<RpcCallRecord> read = reader.readAll();
+        testAssert(read.size() == written.size() && !reader.isTruncated(), "every call should be read back");
+        testAssert(same(read[0], written[1]) && same(read[1], written[2]) && same(read[2], written[0]) && same(read[3], written[3]),
+            "calls should read back unchanged, in the order they started");
+    }
+
+    void testTruncated()
+    {
+        std::string contents;
+        {
+            RpcSessionLog::Writer writer(kLogPath);
+            writer.write(makeRecord("moveByVelocity", 10, 20, std::string(40, 'v')));
+            writer.write(makeRecord("moveByVelocity", 30, 20, std::string(40, 'w')));
+        }
+        {
+            std::ifstream file(kLogPath, std::ios::binary);
+            contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        {
+            std::ofstream file(kLogPath, std::ios::binary | std::ios::trunc);
+            file.write(contents.data(), contents.size() - 5);
+        }
+
+        RpcSessionLog::Reader reader(kLogPath);
+        vector<RpcCallRecord> read = reader.readAll();
+        testAssert(read.size() == 1 && read[0].args == std::string(40, 'v'), "complete calls before the cut should be read");
+        testAssert(reader.isTruncated(), "a cut log should report itself truncated");
+    }
+
+    void testErrors()
+    {
+        expectError([] { RpcSessionLog::Reader reader("/nonexistent/session.log"); }, "Cannot open");
+        {
+            std::ofstream file(kLogPath, std::ios::binary | std::ios::trunc);
+            file << "not a log at all";
+        }
+        expectError([] { RpcSessionLog::Reader reader(kLogPath); }, "is not an RPC session log");
+        {
+            std::ofstream file(kLogPath, std::ios::binary | std::ios::trunc);
+            file.write("ASRPCLOG\x01\x09", 10);
+        }
+        expectError([] { RpcSessionLog::Reader(kLogPath).readAll(); }, "unknown entry");
+        expectError([] { RpcSessionRecorder().start("/nonexistent/session.log"); }, "for writing");
+    }
+
+    void testRecorder()
+    {
+        RpcSessionRecorder recorder;
+        const std::string args = "\x93\x01\x02\x03";
+        auto call = [&](const std::string& method, bool fail) {
+            RpcSessionRecorder::Call recorded(recorder, method, args.data(), args.size());
+            if (fail)
+                throw std::runtime_error("handler failed");
+            recorded.finish(7);
+        };
+
+        testAssert(!recorder.isRecording(), "recording should be off until started");
+        recorder.start(kLogPath);
+        testAssert(recorder.isRecording(), "recording should be on");
+        call("setCarControls", false);
+        try {
+            call("simGetImages", true);
+        }
+        catch (const std::runtime_error&) {
+        }
+        //a call that outlives the recording is dropped
+        {
+            RpcSessionRecorder::Call late(recorder, "simPause", args.data(), args.size());
+            recorder.stop();
+            late.finish(1);
+        }
+        testAssert(!recorder.isRecording() && recorder.getCallCount() == 2, "calls in the recording should be counted");
+
+        vector<RpcCallRecord> read = RpcSessionLog::Reader(kLogPath).readAll();
+        testAssert(read.size() == 2, "only calls made while recording should be logged");
+        testAssert(read[0].method == "setCarControls" && !read[0].failed && read[0].result_size == 7 && read[0].args == args,
+            "finished calls should record their arguments and result size");
+        testAssert(read[1].method == "simGetImages" && read[1].failed && read[1].offset >= read[0].offset, "calls ended by an exception should be failed");
+        testAssert(read[0].sim_time > 0, "calls should be stamped with the sim clock");
+    }
+
+    void testReport()
+    {
+        RpcLatencyReport report;
+        for (int i = 1; i <= 100; ++i)
+            report.add("getCarState", i * 1E-3, i == 100);
+        report.add("simGetImages", 0.25);
+
+        vector<RpcLatencyReport::MethodStats> stats = report.getStats();
+        testAssert(stats.size() == 2 && stats[0].method == "getCarState" && stats[1].method == "simGetImages", "stats should be per method, by name");
+        const RpcLatencyReport::MethodStats& car = stats[0];
+        testAssert(car.count == 100 && car.failed_count == 1, "calls and failures should be counted");
+        testAssert(std::abs(car.mean - 0.0505) < 1E-9 && car.p50 == 0.05 && car.p90 == 0.09 && car.p99 == 0.099 && car.max == 0.1,
+            "percentiles should use the nearest rank");
+        testAssert(stats[1].p99 == 0.25 && stats[1].max == 0.25, "a single call is every percentile");
+        testAssert(report.toString().find("simGetImages") != std::string::npos, "the table should list every method");
+
+        RpcLatencyReport recorded = RpcLatencyReport::fromRecords({ makeRecord("ping", 0, 2000000, "") });
+        testAssert(recorded.getStats()[0].max == 2E-3, "recorded latencies should convert to seconds");
+    }
+
+    //what recording adds to a small call such as getMultirotorState
+    void benchmark()
+    {
+        RpcSessionRecorder recorder;
+        const std::string args(48, 'a');
+        const int calls = 200000;
+
+        common_utils::Timer timer;
+        timer.start();
+        for (int i = 0; i < calls; ++i) {
+            if (recorder.isRecording()) {
+                RpcSessionRecorder::Call call(recorder, "getMultirotorState", args.data(), args.size());
+                call.finish(300);
+            }
+        }
+        double off_seconds = timer.seconds();
+
+        recorder.start(kLogPath);
+        timer.start();
+        for (int i = 0; i < calls; ++i) {
+            RpcSessionRecorder::Call call(recorder, "getMultirotorState", args.data(), args.size());
+            call.finish(300);
+        }
+        recorder.stop();
+        double on_seconds = timer.seconds();
+
+        std::ifstream file(kLogPath, std::ios::binary | std::ios::ate);
+        double bytes_per_call = static_cast<double>(file.tellg()) / calls;
+        testAssert(recorder.getCallCount() == static_cast<uint64_t>(calls), "every call should be recorded");
+        std::cout << "RpcSessionRecorder: " << off_seconds / calls * 1E9 << " ns per call when off, " << on_seconds / calls * 1E9
+                  << " ns when recording, " << bytes_per_call << " bytes per call with " << args.size() << " bytes of arguments" << std::endl;
+    }
+
+    template <typename Func>
+    void expectError(Func func, const std::string& expected)
+    {
+        try {
+            func();
+        }
+        catch (const std::runtime_error& error) {
+            testAssert(std::string(error.what()).find(expected) != std::string::npos, std::string("unexpected error: ") + error.what());
+            return;
+        }
+        testAssert(false, "expected an error containing: " + expected);
+    }
+};
+
+}}
+#endif
@@ -0,0 +1,235 @@
+#ifndef msr_AirLibUnitTests_SensorCollectionTest_hpp
+#define msr_AirLibUnitTests_SensorCollectionTest_hpp
+
+#include "TestBase.hpp"
+#include "common/AirSimSettings.hpp"
+#include "sensors/SensorCollection.hpp"
+#include "sensors/barometer/BarometerSimple.hpp"
+#include "sensors/gps/GpsSimple.hpp"
+#include "sensors/imu/ImuSimple.hpp"
+#include "sensors/magnetometer/MagnetometerSimple.hpp"
+#include "sensors/distance/DistanceSimple.hpp"
+#include "sensors/lidar/LidarSimple.hpp"
+#include "common/SteppableClock.hpp"
+#include "common/TimingWheel.hpp"
+#include "common/common_utils/Timer.hpp"
+#include <random>
+
+namespace msr { namespace airlib {
+
+class SensorCollectionTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testTimingWheel();
+        testAgainstPolling(false);
+        testAgainstPolling(true);
+        benchmark();
+    }
+
+private:
+    class TestDistance : public DistanceSimple {
+    public:
+        TestDistance(const AirSimSettings::DistanceSetting& setting)
+            : DistanceSimple(setting)
+        {
+        }
+    protected:
+        virtual real_T getRayLength(const Pose& pose) override
+        {
+            return 10 + pose.position.x();
+        }
+    };
+
+    class TestLidar : public LidarSimple {
+    public:
+        TestLidar(const AirSimSettings::LidarSetting& setting)
+            : LidarSimple(setting)
+        {
+        }
+    protected:
+        virtual void getPointCloud(const Pose& lidar_pose, const Pose& vehicle_pose,
+            TTimeDelta delta_time, vector<real_T>& point_cloud) override
+        {
+            unused(lidar_pose);
+            point_cloud.push_back(vehicle_pose.position.x());
+            point_cloud.push_back(static_cast<real_T>(delta_time));
+        }
+    };
+
+    //one of each sensor and distance sensors with a range of rates, startup delays and latencies
+    static void createSensors(vector<unique_ptr<SensorBase>>& sensors)
+    {
+        sensors.emplace_back(new BarometerSimple());
+        sensors.emplace_back(new GpsSimple());
+        sensors.emplace_back(new ImuSimple());
+        sensors.emplace_back(new MagnetometerSimple());
+        const float rates[][3] = { { 7, 0.3f, 0.05f }, { 33, 0, 0 }, { 1000, 0, 0.01f }, { 0.5f, 0.1f, 1.3f }, { 200, 0.05f, 0.003f } };
+        for (const auto& rate : rates) {
+            AirSimSettings::DistanceSetting setting;
+            setting.update_frequency = rate[0];
+            setting.startup_delay = rate[1];
+            setting.update_latency = rate[2];
+            sensors.emplace_back(new TestDistance(setting));
+        }
+        AirSimSettings::LidarSetting lidar_setting;
+        lidar_setting.vertical_FOV_upper = -15;
+        lidar_setting.vertical_FOV_lower = -45;
+        sensors.emplace_back(new TestLidar(lidar_setting));
+    }
+
+    void testTimingWheel()
+    {
+        TimingWheel<int> wheel(1E-3, 8);
+        wheel.clear(1000);
+        wheel.schedule(1, 500);          //in the past
+        wheel.schedule(2, 3500000);      //3.5 ms
+        wheel.schedule(3, 20000000);     //more than a turn ahead
+        vector<int> due;
+        wheel.advance(1000, due);
+        testAssert(due == vector<int>{ 1 }, "past item should be due at once");
+        wheel.advance(3400000, due);
+        testAssert(due.size() == 1, "item was returned early");
+        wheel.advance(3500000, due);
+        testAssert(due.size() == 2 && due[1] == 2, "item was not returned when due");
+        wheel.advance(19999999, due);
+        testAssert(due.size() == 2, "item a turn ahead was returned early");
+        wheel.advance(50000000, due);
+        testAssert(due.size() == 3 && due[2] == 3 && wheel.size() == 0, "item was not returned after jumping several turns");
+    }
+
+    //scheduled sensors must give the same output on every tick as sensors updated on every tick
+    void testAgainstPolling(bool jittered_ticks)
+    {
+        SteppableClock clock(3E-3f, 1000000000);
+        ClockFactory::DomainScope clock_scope(&clock);
+
+        Kinematics::State kinematics = Kinematics::State::zero();
+        Environment environment(Environment::State(Vector3r::Zero(), GeoPoint(47.641468, -122.140165, 122)));
+        vector<unique_ptr<SensorBase>> scheduled, polled;
+        createSensors(scheduled);
+        createSensors(polled);
+        SensorCollection collection;
+        for (auto& sensor : scheduled) {
+            sensor->initialize(&kinematics, &environment);
+            collection.insert(sensor.get(), SensorBase::SensorType::Distance);
+        }
+        for (auto& sensor : polled)
+            sensor->initialize(&kinematics, &environment);
+
+        environment.reset();
+        collection.reset();
+        for (auto& sensor : polled)
+            sensor->reset();
+
+        std::mt19937 rng(13);
+        std::uniform_int_distribution<TTimePoint> tick(1000000, 9000000);
+        for (int step = 0; step < 2000; ++step) {
+            if (jittered_ticks)
+                clock.stepBy(static_cast<TTimeDelta>(tick(rng)) / 1E9);
+            else
+                clock.step();
+            kinematics.pose.position += Vector3r(0.01f, 0.02f, -0.005f);
+            kinematics.twist.linear = Vector3r(1, 2, -0.5f) * static_cast<real_T>(step % 7);
+            environment.setPosition(kinematics.pose.position);
+            environment.update();
+
+            collection.update();
+            for (auto& sensor : polled)
+                sensor->update();
+
+            //outputs are not set before the first interval and the startup delay of the gps are over
+            if (clock.elapsedSince(clock.getStart()) < 1.5f)
+                continue;
+            for (size_t i = 0; i < polled.size(); ++i) {
+                std::map<std::string, double> expected = polled[i]->read(), actual = scheduled[i]->read();
+                for (const auto& value : expected) {
+                    //gps filters integrate skipped ticks at once, which only rounds differently
+                    double tolerance = value.first == "GPS-Eph" || value.first == "GPS-Epv" ? 1E-4 * std::fabs(value.second) : 0;
+                    testAssert(std::fabs(actual[value.first] - value.second) <= tolerance,
+                        Utils::stringf("%s differs at step %d", value.first.c_str(), step));
+                }
+                auto* distance = dynamic_cast<DistanceBase*>(polled[i].get());
+                if (distance != nullptr)
+                    testAssert(distance->getOutput().distance == static_cast<DistanceBase*>(scheduled[i].get())->getOutput().distance,
+                        Utils::stringf("distance sensor %d differs at step %d", static_cast<int>(i), step));
+                auto* lidar = dynamic_cast<LidarBase*>(polled[i].get());
+                if (lidar != nullptr)
+                    testAssert(lidar->getOutput().point_cloud == static_cast<LidarBase*>(scheduled[i].get())->getOutput().point_cloud
+                        && lidar->getOutput().time_stamp == static_cast<LidarBase*>(scheduled[i].get())->getOutput().time_stamp,
+                        Utils::stringf("lidar differs at step %d", step));
+            }
+        }
+    }
+
+    //a sensor that counts its updates and is due at a fixed rate
+    class CountingSensor : public SensorBase {
+    public:
+        CountingSensor(real_T frequency)
+            : freq_limiter_(frequency)
+        {
+        }
+        virtual void reset() override
+        {
+            SensorBase::reset();
+            freq_limiter_.reset();
+        }
+        virtual void update() override
+        {
+            SensorBase::update();
+            freq_limiter_.update();
+            if (freq_limiter_.isWaitComplete())
+                ++outputs;
+        }
+        virtual TTimePoint getNextUpdateTime() const override
+        {
+            return scheduled ? freq_limiter_.getNextDueTime() : 0;
+        }
+
+        uint outputs = 0;
+        bool scheduled = true;
+
+    private:
+        FrequencyLimiter freq_limiter_;
+    };
+
+    void benchmark()
+    {
+        SteppableClock clock(3E-3f);
+        ClockFactory::DomainScope clock_scope(&clock);
+        common_utils::Timer timer;
+
+        std::cout << "SensorCollection: ticks/s polled vs scheduled for 1 to 50 Hz sensors";
+        for (uint sensor_count : { 10u, 100u, 1000u }) {
+            double ticks_per_second[2];
+            uint outputs[2] = { 0, 0 };
+            for (int scheduled = 0; scheduled < 2; ++scheduled) {
+                vector<unique_ptr<CountingSensor>> sensors;
+                SensorCollection collection;
+                for (uint i = 0; i < sensor_count; ++i) {
+                    sensors.emplace_back(new CountingSensor(static_cast<real_T>(1 + i % 50)));
+                    sensors.back()->scheduled = scheduled != 0;
+                    collection.insert(sensors.back().get(), SensorBase::SensorType::Distance);
+                }
+                collection.reset();
+
+                const int ticks = 2000;
+                timer.start();
+                for (int tick = 0; tick < ticks; ++tick) {
+                    clock.step();
+                    collection.update();
+                }
+                ticks_per_second[scheduled] = ticks / timer.seconds();
+                for (const auto& sensor : sensors)
+                    outputs[scheduled] += sensor->outputs;
+            }
+            testAssert(outputs[0] == outputs[1], "scheduling changed the number of outputs");
+            std::cout << ", " << sensor_count << " sensors: " << static_cast<int>(ticks_per_second[0])
+                << " vs " << static_cast<int>(ticks_per_second[1]);
+        }
+        std::cout << std::endl;
+    }
+};
+
+}}
+#endif
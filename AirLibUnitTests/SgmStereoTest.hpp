@@ -0,0 +1,216 @@
+#ifndef msr_AirLibUnitTests_SgmStereoTest_hpp
+#define msr_AirLibUnitTests_SgmStereoTest_hpp
+
+#include "TestBase.hpp"
+#include "common/Common.hpp"
+#include "common/common_utils/Timer.hpp"
+#include "../SGM/src/sgmstereo/sgmstereo.h"
+#include <random>
+
+namespace msr { namespace airlib {
+
+class SgmStereoTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testAccuracy();
+        testLeftRightCheck();
+        testSubPixel();
+        benchmark();
+    }
+
+private:
+    //the matcher is run the way CStateStereo does, with disparities in [-max_disparity, 0)
+    static constexpr int kMaxDisparity = 32;
+
+    struct StereoPair {
+        int w, h;
+        vector<unsigned char> left, right;
+        vector<float> truth;        //expected output disparity, negative like SGMStereo's
+        vector<bool> occluded;      //left pixels the right camera can't see
+    };
+
+    struct Result {
+        vector<float> disparity;
+        vector<unsigned char> confidence;
+    };
+
+    struct Score {
+        float density = 0;      //valid pixels among the visible ones
+        float accuracy = 0;     //valid visible pixels within one pixel of the truth
+        float occluded_valid = 0;  //occluded pixels that were not invalidated
+        float mean_error = 0;
+    };
+
+    //smoothed noise so both cost functions see texture at the scale of their windows
+    static vector<float> makeTexture(int w, int h, unsigned int seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> uniform(0, 255);
+        vector<float> noise(w * h), texture(w * h);
+        for (auto& value : noise)
+            value = uniform(random);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                float sum = 0;
+                int count = 0;
+                for (int dy = -1; dy <= 1; ++dy)
+                    for (int dx = -1; dx <= 1; ++dx)
+                        if (x + dx >= 0 && x + dx < w && y + dy >= 0 && y + dy < h) {
+                            sum += noise[(y + dy) * w + x + dx];
+                            ++count;
+                        }
+                texture[y * w + x] = sum / count;
+            }
+        }
+        return texture;
+    }
+
+    static unsigned char sampleRow(const vector<float>& texture, int w, int y, float x)
+    {
+        x = Utils::clip(x, 0.0f, static_cast<float>(w - 1));
+        int x0 = std::min(static_cast<int>(x), w - 2);
+        float alpha = x - x0;
+        return static_cast<unsigned char>(texture[y * w + x0] * (1 - alpha) + texture[y * w + x0 + 1] * alpha + 0.5f);
+    }
+
+    //a fronto-parallel background with a nearer square in front of it; the band left of the square is occluded
+    static StereoPair makeScene(int w, int h, float background_disparity, float square_disparity)
+    {
+        const int margin = 16;
+        vector<float> background = makeTexture(w + margin * 2, h, 1), square = makeTexture(w + margin * 2, h, 2);
+        const int x0 = w * 3 / 8, x1 = w * 5 / 8, y0 = h / 3, y1 = h * 2 / 3;
+        auto in_square = [&](int x, int y) { return x >= x0 && x < x1 && y >= y0 && y < y1; };
+
+        StereoPair pair;
+        pair.w = w;
+        pair.h = h;
+        pair.left.resize(w * h);
+        pair.right.resize(w * h);
+        pair.truth.resize(w * h);
+        pair.occluded.resize(w * h);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const int i = y * w + x;
+                bool near = in_square(x, y);
+                pair.left[i] = sampleRow(near ? square : background, w + margin * 2, y, static_cast<float>(x + margin));
+                float disparity = near ? square_disparity : background_disparity;
+                pair.truth[i] = -disparity;
+                //the right camera sees this point at x - disparity, unless the square covers it there
+                float xr = x - disparity;
+                pair.occluded[i] = xr < 0 || (!near && in_square(static_cast<int>(std::floor(xr + square_disparity)), y));
+
+                //the right view shows the square where it has moved to, background elsewhere
+                bool right_near = in_square(static_cast<int>(std::floor(x + square_disparity)), y);
+                pair.right[i] = right_near
+                    ? sampleRow(square, w + margin * 2, y, x + square_disparity + margin)
+                    : sampleRow(background, w + margin * 2, y, x + background_disparity + margin);
+            }
+        }
+        return pair;
+    }
+
+    static Result match(const StereoPair& pair, int cost_function, int left_right_check, int sub_pixel = 1, int directions = 4)
+    {
+        SGMStereo sgm(pair.w, pair.h, -kMaxDisparity, 0, directions, 16, sub_pixel, 200.0f, 1.0f, 8.0f, 10.0f, directions == 8 ? 1 : 0,
+            cost_function, left_right_check, 1.0f);
+        Result result;
+        result.disparity.resize(pair.w * pair.h);
+        result.confidence.resize(pair.w * pair.h);
+        vector<unsigned char> left = pair.left, right = pair.right;
+        sgm.Run(left.data(), right.data(), result.disparity.data(), result.confidence.data());
+        sgm.free();
+        return result;
+    }
+
+    //ignores the image border, where neither window fits
+    Score score(const StereoPair& pair, const Result& result)
+    {
+        const int border = 3;
+        uint visible = 0, valid = 0, accurate = 0, occluded = 0, occluded_valid = 0;
+        double error = 0;
+        for (int y = border; y < pair.h - border; ++y) {
+            for (int x = border + kMaxDisparity / 2; x < pair.w - border; ++x) {
+                const int i = y * pair.w + x;
+                bool is_valid = result.disparity[i] != FLT_MAX;
+                testAssert(is_valid == (result.confidence[i] > 0), "invalid pixels should have no confidence");
+                if (pair.occluded[i]) {
+                    ++occluded;
+                    occluded_valid += is_valid ? 1 : 0;
+                    continue;
+                }
+                ++visible;
+                if (!is_valid)
+                    continue;
+                ++valid;
+                float difference = std::abs(result.disparity[i] - pair.truth[i]);
+                error += difference;
+                accurate += difference <= 1 ? 1 : 0;
+            }
+        }
+        Score s;
+        s.density = static_cast<float>(valid) / visible;
+        s.accuracy = valid ? static_cast<float>(accurate) / valid : 0;
+        s.occluded_valid = occluded ? static_cast<float>(occluded_valid) / occluded : 0;
+        s.mean_error = valid ? static_cast<float>(error / valid) : 0;
+        return s;
+    }
+
+    void testAccuracy()
+    {
+        StereoPair pair = makeScene(128, 96, 6, 14);
+        for (int cost : { SGM_COST_NCC, SGM_COST_CENSUS }) {
+            for (int directions : { 4, 8 }) {
+                Score s = score(pair, match(pair, cost, 0, 1, directions));
+                testAssert(s.density > 0.8f && s.accuracy > 0.95f,
+                    Utils::stringf("cost %d with %d directions: density %f, accuracy %f", cost, directions, s.density, s.accuracy));
+            }
+        }
+    }
+
+    void testLeftRightCheck()
+    {
+        StereoPair pair = makeScene(128, 96, 6, 14);
+        for (int cost : { SGM_COST_NCC, SGM_COST_CENSUS }) {
+            Score unchecked = score(pair, match(pair, cost, 0));
+            Score checked = score(pair, match(pair, cost, 1));
+            testAssert(checked.occluded_valid < 0.1f && checked.occluded_valid < unchecked.occluded_valid,
+                Utils::stringf("cost %d: %f of occluded pixels kept, %f without the check", cost, checked.occluded_valid, unchecked.occluded_valid));
+            testAssert(checked.density > 0.95f && checked.accuracy > 0.99f,
+                Utils::stringf("cost %d: the check should keep good matches, density %f", cost, checked.density));
+        }
+    }
+
+    void testSubPixel()
+    {
+        StereoPair pair = makeScene(128, 96, 9.5f, 9.5f);
+        for (int cost : { SGM_COST_NCC, SGM_COST_CENSUS }) {
+            Score whole = score(pair, match(pair, cost, 0, 0));
+            Score refined = score(pair, match(pair, cost, 0, 1));
+            testAssert(refined.mean_error < whole.mean_error,
+                Utils::stringf("cost %d: refined error %f should be below %f", cost, refined.mean_error, whole.mean_error));
+        }
+    }
+
+    void benchmark()
+    {
+        StereoPair pair = makeScene(320, 240, 6, 14);
+        for (int cost : { SGM_COST_NCC, SGM_COST_CENSUS }) {
+            SGMStereo sgm(pair.w, pair.h, -64, 0, 4, 16, 1, 200.0f, 1.0f, 8.0f, 10.0f, 0, cost, 1, 1.0f);
+            vector<float> disparity(pair.w * pair.h);
+            vector<unsigned char> confidence(pair.w * pair.h);
+            const int runs = 5;
+            common_utils::Timer timer;
+            timer.start();
+            for (int i = 0; i < runs; ++i)
+                sgm.Run(pair.left.data(), pair.right.data(), disparity.data(), confidence.data());
+            double seconds = timer.seconds();
+            sgm.free();
+            std::cout << "SGMStereo " << (cost == SGM_COST_CENSUS ? "census" : "NCC") << ": " << seconds / runs * 1E3
+                      << " ms per 320x240 frame with 64 disparities and the left-right check" << std::endl;
+        }
+    }
+};
+
+}}
+#endif
@@ -0,0 +1,196 @@
+#ifndef msr_AirLibUnitTests_SignedDistanceFieldTest_hpp
+#define msr_AirLibUnitTests_SignedDistanceFieldTest_hpp
+
+#include "TestBase.hpp"
+#include "raycast/SignedDistanceField.hpp"
+#include "physics/FastPhysicsEngine.hpp"
+#include "common/common_utils/Timer.hpp"
+#include <cstdio>
+#include <random>
+
+namespace msr { namespace airlib {
+
+class SignedDistanceFieldTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testAgainstAnalytic();
+        testSaveLoad();
+        testFallingBody();
+        benchmark();
+    }
+
+private:
+    //a point mass that does nothing when updated
+    class PointBody : public PhysicsBody {
+    public:
+        PointBody(const Vector3r& position, Environment* environment)
+        {
+            Kinematics::State state = Kinematics::State::zero();
+            state.pose.position = position;
+            initialize(1, Matrix3x3r::Identity() * 0.01f, state, environment);
+        }
+        virtual void kinematicsUpdated() override
+        {
+        }
+        virtual real_T getRestitution() const override
+        {
+            return 0.5f;
+        }
+        virtual real_T getFriction() const override
+        {
+            return 0.5f;
+        }
+    };
+
+    //a 4 m cube at the origin next to a sphere of 2 m radius at (6, 0, 0)
+    static void makeScene(StaticScene& scene)
+    {
+        scene.addMesh(TriangleMesh::box(Vector3r(4, 4, 4)));
+        scene.addMesh(TriangleMesh::sphere(2, 48), Pose(Vector3r(6, 0, 0), Quaternionr::Identity()));
+        scene.build();
+    }
+
+    static real_T boxDistance(const Vector3r& point)
+    {
+        Vector3r q = point.cwiseAbs() - Vector3r(2, 2, 2);
+        return q.cwiseMax(Vector3r::Zero()).norm() + std::min(q.maxCoeff(), 0.0f);
+    }
+
+    static real_T analyticDistance(const Vector3r& point)
+    {
+        return std::min(boxDistance(point), (point - Vector3r(6, 0, 0)).norm() - 2);
+    }
+
+    void testAgainstAnalytic()
+    {
+        StaticScene scene;
+        makeScene(scene);
+        SignedDistanceField field;
+        field.build(scene, 0.1f);
+        testAssert(!field.isEmpty() && field.getBand() == 0.4f, "field was not built");
+
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<real_T> coordinate(-3, 9), side(-3, 3);
+        int checked = 0;
+        for (int i = 0; i < 20000; ++i) {
+            Vector3r point(coordinate(rng), side(rng), side(rng));
+            real_T expected = analyticDistance(point);
+            SignedDistanceField::Sample sample = field.sample(point);
+            if (std::fabs(expected) < field.getBand() * 0.75f) {
+                //the sphere is faceted and samples are quantized
+                testAssert(std::fabs(sample.distance - expected) < 0.05f,
+                    Utils::stringf("distance %f instead of %f at %s", sample.distance, expected, VectorMath::toString(point).c_str()));
+                ++checked;
+            }
+            else
+                testAssert((sample.distance > 0) == (expected > 0), "far sample has the wrong sign at " + VectorMath::toString(point));
+        }
+        testAssert(checked > 1000, "too few points near the surface");
+
+        //normals point out of the geometry, interpolation bends them a little near vertices
+        testAssert(field.sample(Vector3r(2.1f, 0.3f, -0.5f)).normal.dot(Vector3r(1, 0, 0)) > 0.999f, "box normal is wrong");
+        testAssert(field.sample(Vector3r(6, 0, -2.05f)).normal.dot(Vector3r(0, 0, -1)) > 0.99f, "sphere normal is wrong");
+        testAssert(field.distance(Vector3r(0, 0, 0)) == -field.getBand() && field.distance(Vector3r(100, 0, 0)) == field.getBand(),
+            "distances far from the surface should be clamped to the band");
+    }
+
+    void testSaveLoad()
+    {
+        StaticScene scene;
+        makeScene(scene);
+        SignedDistanceField built;
+        built.build(scene, 0.2f);
+        const std::string file_path = "SignedDistanceFieldTest.sdf";
+        built.save(file_path);
+        {
+            SignedDistanceField loaded;
+            loaded.load(file_path);
+            testAssert(loaded.getVoxelSize() == built.getVoxelSize() && loaded.getMemorySize() == built.getMemorySize(),
+                "loaded field has a different layout");
+            std::mt19937 rng(7);
+            std::uniform_real_distribution<real_T> coordinate(-4, 10);
+            for (int i = 0; i < 1000; ++i) {
+                Vector3r point(coordinate(rng), coordinate(rng) / 2, coordinate(rng) / 2);
+                testAssert(loaded.distance(point) == built.distance(point), "loaded field differs at " + VectorMath::toString(point));
+            }
+        }
+        std::remove(file_path.c_str());
+
+        bool thrown = false;
+        try {
+            SignedDistanceField missing;
+            missing.load("missing.sdf");
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        testAssert(thrown, "loading a missing file should throw");
+    }
+
+    void testFallingBody()
+    {
+        SteppableClock clock(3E-3f);
+        ClockFactory::DomainScope clock_scope(&clock);
+
+        //a 10 cm thick floor whose top is at z = 0, NED so down is +z
+        StaticScene scene;
+        scene.addMesh(TriangleMesh::box(Vector3r(20, 20, 0.1f)), Pose(Vector3r(0, 0, 0.05f), Quaternionr::Identity()));
+        scene.build();
+        auto field = std::make_shared<SignedDistanceField>();
+        field->build(scene, 0.05f);
+
+        Environment environment(Environment::State(Vector3r::Zero(), GeoPoint(47.641468, -122.140165, 122)));
+        PointBody body(Vector3r(0, 0, -5), &environment);
+        FastPhysicsEngine engine(true, field);
+        engine.insert(&body);
+        engine.reset();
+        body.reset();
+
+        //1 m/s sideways so the fall is not along an axis of the grid
+        Kinematics::State state = body.getKinematics();
+        state.twist.linear = Vector3r(1, 0, 0);
+        body.setKinematics(state);
+
+        real_T lowest = -5;
+        for (int step = 0; step < 2000; ++step) {
+            clock.step();
+            engine.update();
+            lowest = std::max(lowest, body.getKinematics().pose.position.z());
+        }
+        //falling 5 m reaches almost 10 m/s, which is 3 cm per step
+        testAssert(lowest < 0.01f, Utils::stringf("body fell through the floor to %f", lowest));
+        testAssert(std::fabs(body.getKinematics().pose.position.z()) < 0.01f && body.getCollisionInfo().has_collided,
+            Utils::stringf("body should rest on the floor, is at %f", body.getKinematics().pose.position.z()));
+        testAssert(body.getCollisionInfo().object_name == "StaticWorld", "collision was not with the static world");
+    }
+
+    void benchmark()
+    {
+        StaticScene scene;
+        makeScene(scene);
+        SignedDistanceField field;
+        common_utils::Timer timer;
+        timer.start();
+        field.build(scene, 0.05f);
+        double build_seconds = timer.seconds();
+
+        std::mt19937 rng(9);
+        std::uniform_real_distribution<real_T> coordinate(-3, 9), side(-3, 3);
+        vector<Vector3r> points;
+        for (int i = 0; i < 1000000; ++i)
+            points.emplace_back(coordinate(rng), side(rng), side(rng));
+
+        timer.start();
+        real_T sum = 0;
+        for (const Vector3r& point : points)
+            sum += field.sample(point).distance;
+        double seconds = timer.seconds();
+        std::cout << "SignedDistanceField: " << scene.triangleCount() << " triangles built in " << build_seconds << " s, "
+            << field.getMemorySize() / 1e6 << " MB, " << points.size() / 1e6 / seconds << " M samples/s"
+            << (sum == 0 ? " " : "") << std::endl;
+    }
+};
+
+}}
+#endif
@@ -0,0 +1,100 @@
+#ifndef msr_AirLibUnitTests_SimpleFlightGainTunerTest_hpp
+#define msr_AirLibUnitTests_SimpleFlightGainTunerTest_hpp
+
+#include "TestBase.hpp"
+#include "common/AirSimSettings.hpp"
+#include "vehicles/multirotor/firmwares/simple_flight/SimpleFlightGainTuner.hpp"
+#include "common/common_utils/Timer.hpp"
+
+namespace msr { namespace airlib {
+
+class SimpleFlightGainTunerTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testDefaultGains();
+        testTuning();
+        testSettingsPatch();
+        benchmark();
+    }
+
+private:
+    static SimpleFlightGainTuner::Options getSmallOptions()
+    {
+        SimpleFlightGainTuner::Options options;
+        options.population = 8;
+        options.elite_count = 3;
+        options.iterations = 2;
+        options.warmup = 2;
+        return options;
+    }
+
+    void testDefaultGains()
+    {
+        SimpleFlightGainTuner tuner;
+        SimpleFlightGainTuner::Gains defaults = SimpleFlightGainTuner::getDefaultGains();
+        for (const auto& test_case : tuner.getTestCases()) {
+            SimpleFlightGainTuner::Score score = tuner.fly(defaults, test_case);
+            testAssert(!score.diverged && score.cost > 0, "default gains should fly " + test_case.name);
+            if (test_case.type == SimpleFlightGainTuner::TestCaseType::Step)
+                testAssert(score.settling_time > 0 && score.settling_time < test_case.duration, "default gains should settle " + test_case.name);
+        }
+
+        //cranking up the rate loop makes the vehicle shake, which costs control effort
+        SimpleFlightGainTuner::Gains shaky = defaults;
+        shaky.angle_rate_p *= 8;
+        const auto& step = tuner.getTestCases().front();
+        testAssert(tuner.fly(shaky, step).control_effort > tuner.fly(defaults, step).control_effort,
+            "high rate gains should take more control effort");
+    }
+
+    void testTuning()
+    {
+        SimpleFlightGainTuner::Options options = getSmallOptions();
+        options.thread_count = 1;
+        SimpleFlightGainTuner::Result single = SimpleFlightGainTuner(SimpleFlightGainTuner::defaultTestCases(), options).tune();
+        options.thread_count = 3;
+        SimpleFlightGainTuner::Result threaded = SimpleFlightGainTuner(SimpleFlightGainTuner::defaultTestCases(), options).tune();
+
+        testAssert(single.cost <= single.initial_cost, "tuning made the gains worse");
+        testAssert(single.cost == threaded.cost && single.gains.position_p == threaded.gains.position_p
+            && single.gains.angle_rate_p == threaded.gains.angle_rate_p, "results depend on the number of threads");
+        testAssert(single.flights == 2 * 8 * 4, "wrong number of flights");
+    }
+
+    void testSettingsPatch()
+    {
+        SimpleFlightGainTuner::Gains gains = SimpleFlightGainTuner::getDefaultGains();
+        gains.angle_rate_p = Vector3r(0.3f, 0.35f, 0.2f);
+        gains.position_p = Vector3r(0.5f, 0.6f, 0.7f);
+        gains.velocity_i.z() = 1.5f;
+
+        AirSimSettings::initializeSettings(SimpleFlightGainTuner::getSettingsPatch(gains, "Tuned"));
+        AirSimSettings settings;
+        settings.load([]() { return std::string("Multirotor"); });
+        const AirSimSettings::SimpleFlightGains& loaded = settings.getVehicleSetting("Tuned")->gains;
+        testAssert(loaded.angle_rate_p == gains.angle_rate_p && loaded.angle_level_p == gains.angle_level_p
+            && loaded.velocity_p == gains.velocity_p && loaded.velocity_i == gains.velocity_i
+            && loaded.position_p == gains.position_p, "gains changed going through settings");
+        AirSimSettings::initializeSettings("{}");
+    }
+
+    void benchmark()
+    {
+        std::cout << "SimpleFlightGainTuner: simulated seconds per second";
+        for (uint thread_count : { 1u, std::max(2u, std::thread::hardware_concurrency()) }) {
+            SimpleFlightGainTuner::Options options = getSmallOptions();
+            options.iterations = 1;
+            options.thread_count = thread_count;
+            SimpleFlightGainTuner tuner(SimpleFlightGainTuner::defaultTestCases(), options);
+            common_utils::Timer timer;
+            timer.start();
+            SimpleFlightGainTuner::Result result = tuner.tune();
+            std::cout << ", " << thread_count << " threads: " << static_cast<int>(result.simulated_seconds / timer.seconds());
+        }
+        std::cout << std::endl;
+    }
+};
+
+}}
+#endif
@@ -0,0 +1,224 @@
+#ifndef msr_AirLibUnitTests_StaticSceneImageCaptureTest_hpp
+#define msr_AirLibUnitTests_StaticSceneImageCaptureTest_hpp
+
+#include "TestBase.hpp"
+#include "raycast/StaticSceneImageCapture.hpp"
+#include "common/common_utils/Timer.hpp"
+#include <random>
+
+namespace msr { namespace airlib {
+
+class StaticSceneImageCaptureTest : public TestBase {
+    typedef ImageCaptureBase::ImageType ImageType;
+    typedef ImageCaptureBase::ImageRequest ImageRequest;
+    typedef ImageCaptureBase::ImageResponse ImageResponse;
+
+public:
+    virtual void run() override
+    {
+        testWall();
+        testOrthographic();
+        testAgainstRayCasts();
+        testSegmentationIDs();
+        benchmark();
+    }
+
+private:
+    static AirSimSettings::CameraSetting makeCamera(unsigned int width, unsigned int height, float fov_degrees = 90)
+    {
+        AirSimSettings::CameraSetting camera;
+        for (auto& capture : camera.capture_settings) {
+            capture.second.width = width;
+            capture.second.height = height;
+            capture.second.fov_degrees = fov_degrees;
+        }
+        return camera;
+    }
+
+    static ImageResponse getImage(const StaticSceneImageCapture& capture, ImageType type, bool pixels_as_float, bool compress = false)
+    {
+        vector<ImageResponse> responses;
+        capture.getImages({ ImageRequest("0", type, pixels_as_float, compress) }, responses);
+        return responses.at(0);
+    }
+
+    void testWall()
+    {
+        auto scene = std::make_shared<StaticScene>();
+        TriangleMesh wall = TriangleMesh::box(Vector3r(1, 100, 100));
+        wall.name = "Wall";
+        scene->addMesh(wall, Pose(Vector3r(10, 0, 0), Quaternionr::Identity()));
+
+        StaticSceneImageCapture capture(scene);
+        capture.addCamera("0", makeCamera(64, 48));
+        ImageResponse planner = getImage(capture, ImageType::DepthPlanner, true);
+        ImageResponse perspective = getImage(capture, ImageType::DepthPerspective, true);
+        testAssert(planner.message.empty() && planner.width == 64 && planner.height == 48
+            && planner.image_data_float.size() == 64 * 48, "depth image has the wrong size");
+
+        //the near face is at 9.5 m and the focal length is 32 pixels
+        for (int y = 0; y < 48; ++y) {
+            for (int x = 0; x < 64; ++x) {
+                float u = (x + 0.5f - 32) / 32, v = (y + 0.5f - 24) / 32;
+                float planar = planner.image_data_float[y * 64 + x];
+                float distance = perspective.image_data_float[y * 64 + x];
+                testAssert(std::fabs(planar - 9.5f) < 1e-4f, Utils::stringf("planar depth %f at %d, %d", planar, x, y));
+                testAssert(std::fabs(distance - 9.5f * std::sqrt(1 + u * u + v * v)) < 1e-3f,
+                    Utils::stringf("perspective depth %f at %d, %d", distance, x, y));
+            }
+        }
+
+        ImageResponse normals = getImage(capture, ImageType::SurfaceNormals, false);
+        testAssert(normals.image_data_uint8.size() == 64 * 48 * 4 && normals.image_data_uint8[0] == 0
+            && normals.image_data_uint8[1] == 128 && normals.image_data_uint8[2] == 128, "wall normal should face the camera");
+
+        //the letters of "wall" plus 5 sum to 437, which is object ID 181
+        ImageResponse segmentation = getImage(capture, ImageType::Segmentation, false);
+        testAssert(capture.getSegmentationObjectID("Wall") == 181, "default object ID differs from Unreal");
+        testAssert(segmentation.image_data_uint8[0] == 175 && segmentation.image_data_uint8[1] == 6
+            && segmentation.image_data_uint8[2] == 140, "segmentation color is not from the palette");
+
+        ImageResponse png = getImage(capture, ImageType::Segmentation, false, true);
+        testAssert(png.image_data_uint8.size() > 8 && png.image_data_uint8[1] == 'P' && png.image_data_uint8[2] == 'N'
+            && png.image_data_uint8[3] == 'G', "compressed image is not a PNG");
+
+        //looking away from the wall nothing is visible
+        capture.setVehiclePose(Pose(Vector3r::Zero(), VectorMath::toQuaternion(0, 0, M_PIf)));
+        ImageResponse empty = getImage(capture, ImageType::DepthPlanner, true);
+        testAssert(empty.image_data_float[0] == StaticSceneImageCapture::EmptyDepth, "empty pixel should report EmptyDepth");
+    }
+
+    void testOrthographic()
+    {
+        auto scene = std::make_shared<StaticScene>();
+        scene->addMesh(TriangleMesh::box(Vector3r(1, 2, 2)), Pose(Vector3r(5, 0, 0), Quaternionr::Identity()));
+
+        AirSimSettings::CameraSetting camera = makeCamera(64, 64);
+        for (auto& capture : camera.capture_settings) {
+            capture.second.projection_mode = 1;
+            capture.second.ortho_width = 4;
+        }
+        StaticSceneImageCapture capture(scene);
+        capture.addCamera("0", camera);
+        ImageResponse depth = getImage(capture, ImageType::DepthPlanner, true);
+
+        //a 2 m box in a 4 m wide view covers the middle 32 pixels in both directions
+        for (int y = 0; y < 64; ++y) {
+            for (int x = 0; x < 64; ++x) {
+                bool inside = x >= 16 && x < 48 && y >= 16 && y < 48;
+                float value = depth.image_data_float[y * 64 + x];
+                testAssert(inside ? std::fabs(value - 4.5f) < 1e-4f : value == StaticSceneImageCapture::EmptyDepth,
+                    Utils::stringf("orthographic depth %f at %d, %d", value, x, y));
+            }
+        }
+    }
+
+    static std::shared_ptr<StaticScene> makeScene(std::mt19937& rng, int box_count)
+    {
+        std::uniform_real_distribution<real_T> position(-20, 20), angle(-2, 2);
+        auto scene = std::make_shared<StaticScene>();
+        TriangleMesh room = TriangleMesh::box(Vector3r(60, 60, 20));
+        room.name = "room";
+        scene->addMesh(room);
+        for (int i = 0; i < box_count; ++i) {
+            TriangleMesh mesh = i % 2 ? TriangleMesh::box(Vector3r(2, 3, 4)) : TriangleMesh::sphere(1.5f, 24);
+            mesh.name = Utils::stringf("object%d", i);
+            scene->addMesh(mesh, Pose(Vector3r(position(rng), position(rng), position(rng) / 4),
+                VectorMath::toQuaternion(angle(rng), angle(rng), angle(rng))));
+        }
+        scene->build();
+        return scene;
+    }
+
+    void testAgainstRayCasts()
+    {
+        std::mt19937 rng(3);
+        std::shared_ptr<StaticScene> scene = makeScene(rng, 40);
+        StaticSceneImageCapture capture(scene);
+        const int width = 160, height = 120;
+        capture.addCamera("0", makeCamera(width, height, 70));
+
+        std::uniform_real_distribution<real_T> position(-15, 15), angle(-M_PIf, M_PIf);
+        for (int view = 0; view < 4; ++view) {
+            //inside the room every pixel sees something, and nearby objects are clipped by the near plane
+            Pose pose(Vector3r(position(rng), position(rng), position(rng) / 4), VectorMath::toQuaternion(angle(rng) / 4, 0, angle(rng)));
+            capture.setVehiclePose(pose);
+            capture.setThreadCount(1);
+            ImageResponse depth = getImage(capture, ImageType::DepthPlanner, true);
+            ImageResponse segmentation = getImage(capture, ImageType::Segmentation, true);
+            capture.setThreadCount(4);
+            ImageResponse threaded = getImage(capture, ImageType::DepthPlanner, true);
+            testAssert(depth.image_data_float == threaded.image_data_float, "image depends on the thread count");
+
+            //the camera x component of each ray is 1, so hit distances are planar depths
+            real_T focal = width / 2 / std::tan(Utils::degreesToRadians(35.0f));
+            vector<StaticScene::Ray> rays;
+            for (int y = 0; y < height; ++y)
+                for (int x = 0; x < width; ++x) {
+                    Vector3r direction(1, (x + 0.5f - width / 2) / focal, (y + 0.5f - height / 2) / focal);
+                    rays.emplace_back(pose.position, VectorMath::rotateVector(direction, pose.orientation, true), 1000.0f);
+                }
+            vector<StaticScene::Hit> hits;
+            scene->castRays(rays, hits);
+
+            //pixels whose center is on an edge may see either triangle
+            int mismatches = 0;
+            for (size_t i = 0; i < hits.size(); ++i) {
+                testAssert(hits[i].isHit(), "ray from inside the room escaped");
+                float expected_id = static_cast<float>(capture.getSegmentationObjectID(scene->getMeshName(hits[i].mesh)));
+                if (std::fabs(depth.image_data_float[i] - hits[i].distance) > 1e-3f * hits[i].distance
+                    || segmentation.image_data_float[i] != expected_id)
+                    ++mismatches;
+            }
+            testAssert(mismatches <= width * height / 1000, Utils::stringf("%d pixels differ from ray casts", mismatches));
+        }
+    }
+
+    void testSegmentationIDs()
+    {
+        auto scene = std::make_shared<StaticScene>();
+        TriangleMesh ground = TriangleMesh::box(Vector3r(1, 1, 1));
+        for (const char* name : { "Ground_1", "Ground_2", "Tree" }) {
+            ground.name = name;
+            scene->addMesh(ground);
+        }
+        StaticSceneImageCapture capture(scene);
+        testAssert(capture.setSegmentationObjectID("ground[\\w]*", 21, true), "regex did not match");
+        testAssert(capture.getSegmentationObjectID("Ground_2") == 21 && capture.getSegmentationObjectID("Tree") != 21,
+            "regex changed the wrong meshes");
+        testAssert(!capture.setSegmentationObjectID("Rock", 3), "missing mesh reported as found");
+
+        vector<ImageResponse> responses;
+        capture.getImages({ ImageRequest("missing", ImageType::DepthPlanner, true), ImageRequest("0", ImageType::Scene) }, responses);
+        testAssert(responses.size() == 2 && !responses[0].message.empty() && !responses[1].message.empty(),
+            "unknown camera and Scene images should report a message");
+    }
+
+    void benchmark()
+    {
+        std::mt19937 rng(11);
+        std::shared_ptr<StaticScene> scene = makeScene(rng, 400);
+        StaticSceneImageCapture capture(scene);
+        capture.setVehiclePose(Pose(Vector3r(-25, 0, 0), Quaternionr::Identity()));
+        common_utils::Timer timer;
+
+        for (unsigned int width : { 640u, 1920u }) {
+            unsigned int height = width * 9 / 16;
+            capture.addCamera("0", makeCamera(width, height));
+            std::cout << "StaticSceneImageCapture: " << scene->triangleCount() << " triangles at " << width << "x" << height;
+            for (uint threads : { 1u, 0u }) {
+                capture.setThreadCount(threads);
+                const int frames = 5;
+                timer.start();
+                for (int i = 0; i < frames; ++i)
+                    getImage(capture, ImageType::DepthPlanner, true);
+                double seconds = timer.seconds();
+                std::cout << ", " << frames * width * height / 1e6 / seconds << " MP/s " << (threads == 1 ? "single" : "all threads");
+            }
+            std::cout << std::endl;
+        }
+    }
+};
+
+}}
+#endif
@@ -0,0 +1,245 @@
+#ifndef msr_AirLibUnitTests_StaticSceneTest_hpp
+#define msr_AirLibUnitTests_StaticSceneTest_hpp
+
+#include "TestBase.hpp"
+#include "raycast/StaticScene.hpp"
+#include "common/common_utils/Timer.hpp"
+#include <fstream>
+#include <cstdio>
+#include <random>
+
+namespace msr { namespace airlib {
+
+class StaticSceneTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testLoaders();
+        testAgainstBruteForce();
+        testRayCast();
+        benchmark();
+    }
+
+private:
+    //nearest hit found by testing every triangle
+    static StaticScene::Hit bruteForce(const vector<TriangleMesh>& meshes, const StaticScene::Ray& ray)
+    {
+        StaticScene::Hit best;
+        best.distance = ray.max_distance;
+        for (size_t m = 0; m < meshes.size(); ++m) {
+            const TriangleMesh& mesh = meshes[m];
+            for (uint t = 0; t < mesh.triangleCount(); ++t) {
+                const Vector3r& v0 = mesh.vertices[mesh.indices[t * 3]];
+                Vector3r e1 = mesh.vertices[mesh.indices[t * 3 + 1]] - v0;
+                Vector3r e2 = mesh.vertices[mesh.indices[t * 3 + 2]] - v0;
+                Vector3r p = ray.direction.cross(e2);
+                real_T det = e1.dot(p);
+                if (std::fabs(det) < 1e-20f)
+                    continue;
+                Vector3r s = ray.origin - v0;
+                real_T u = s.dot(p) / det;
+                Vector3r q = s.cross(e1);
+                real_T v = ray.direction.dot(q) / det;
+                real_T distance = e2.dot(q) / det;
+                if (u >= 0 && v >= 0 && u + v <= 1 && distance > 0 && distance < best.distance) {
+                    best.distance = distance;
+                    best.mesh = static_cast<int>(m);
+                    best.triangle = t;
+                }
+            }
+        }
+        return best;
+    }
+
+    static vector<TriangleMesh> makeMeshes(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<real_T> position(-50, 50), size(-2, 2);
+        vector<TriangleMesh> meshes;
+
+        //a room with some boxes and a cloud of small random triangles in it
+        TriangleMesh room;
+        room.append(TriangleMesh::box(Vector3r(120, 120, 60)));
+        room.name = "room";
+        meshes.push_back(room);
+        for (int i = 0; i < 20; ++i) {
+            TriangleMesh box;
+            box.append(TriangleMesh::box(Vector3r(4, 6, 8)), Pose(Vector3r(position(rng), position(rng), position(rng) / 2),
+                VectorMath::toQuaternion(size(rng), size(rng), size(rng))));
+            box.name = "box";
+            meshes.push_back(box);
+        }
+        TriangleMesh cloud;
+        cloud.name = "cloud";
+        for (int i = 0; i < 20000; ++i) {
+            Vector3r center(position(rng), position(rng), position(rng) / 2);
+            for (int corner = 0; corner < 3; ++corner) {
+                cloud.indices.push_back(static_cast<uint32_t>(cloud.vertices.size()));
+                cloud.vertices.push_back(center + Vector3r(size(rng), size(rng), size(rng)));
+            }
+        }
+        meshes.push_back(cloud);
+        return meshes;
+    }
+
+    static vector<StaticScene::Ray> makeRays(std::mt19937& rng, size_t count, bool coherent)
+    {
+        std::uniform_real_distribution<real_T> position(-40, 40), angle(-M_PIf, M_PIf);
+        vector<StaticScene::Ray> rays;
+        Vector3r origin(position(rng), position(rng), position(rng) / 2);
+        for (size_t i = 0; i < count; ++i) {
+            //lidar like fans from one point, or rays from anywhere in any direction
+            if (!coherent)
+                origin = Vector3r(position(rng), position(rng), position(rng) / 2);
+            real_T yaw = coherent ? 2 * M_PIf * i / count : angle(rng);
+            real_T pitch = coherent ? -0.5f + static_cast<real_T>(i % 16) / 16 : angle(rng) / 2;
+            Vector3r direction(std::cos(pitch) * std::cos(yaw), std::cos(pitch) * std::sin(yaw), std::sin(pitch));
+            rays.emplace_back(origin, direction, i % 3 == 0 ? 20.0f : 200.0f);
+        }
+        //axis aligned rays exercise the zero direction components
+        rays.emplace_back(Vector3r(0, 0, 0), Vector3r(1, 0, 0), 200.0f);
+        rays.emplace_back(Vector3r(0, 0, 0), Vector3r(0, 0, -1), 200.0f);
+        return rays;
+    }
+
+    void testLoaders()
+    {
+        const std::string obj_path = "StaticSceneTest.obj";
+        const std::string stl_path = "StaticSceneTest.stl";
+        const std::string urdf_path = "StaticSceneTest.urdf";
+        {
+            std::ofstream obj(obj_path);
+            obj << "# quad\nv 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvn 0 0 1\nf 1//1 2//1 3//1 4//1\nf -4 -2 -1\n";
+        }
+        {
+            std::ofstream stl(stl_path, std::ios::binary);
+            char header[80] = {};
+            uint32_t count = 1;
+            float facet[12] = { 0, 0, 1,  0, 0, 0,  2, 0, 0,  0, 2, 0 };
+            uint16_t attributes = 0;
+            stl.write(header, sizeof(header));
+            stl.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            stl.write(reinterpret_cast<const char*>(facet), sizeof(facet));
+            stl.write(reinterpret_cast<const char*>(&attributes), sizeof(attributes));
+        }
+        {
+            std::ofstream urdf(urdf_path);
+            urdf << "<?xml version=\"1.0\"?>\n<robot name=\"test\">\n"
+                "  <!-- base with a mesh, arm with a box one meter up -->\n"
+                "  <link name=\"base\"><collision><geometry><mesh filename=\"" << stl_path << "\" scale=\"1 1 1\"/></geometry></collision></link>\n"
+                "  <link name=\"arm\"><collision><origin xyz=\"0 0 0.5\" rpy=\"0 0 0\"/><geometry><box size=\"1 1 1\"/></geometry></collision></link>\n"
+                "  <joint name=\"lift\" type=\"revolute\"><parent link=\"base\"/><child link=\"arm\"/><origin xyz=\"0 0 1\"/></joint>\n"
+                "</robot>\n";
+        }
+
+        TriangleMesh obj = TriangleMesh::loadFile(obj_path);
+        testAssert(obj.vertices.size() == 4 && obj.triangleCount() == 3, "OBJ quad and triangle were not loaded");
+        TriangleMesh stl = TriangleMesh::loadFile(stl_path);
+        testAssert(stl.triangleCount() == 1 && stl.vertices[1] == Vector3r(2, 0, 0), "binary STL was not loaded");
+        vector<TriangleMesh> robot = TriangleMesh::loadUrdfCollision(urdf_path);
+        testAssert(robot.size() == 2 && robot[0].name == "base" && robot[1].triangleCount() == 12, "URDF collision links were not loaded");
+        real_T top = -1e9f;
+        for (const auto& v : robot[1].vertices)
+            top = std::max(top, v.z());
+        testAssert(std::fabs(top - 2) < 1e-5f, "URDF joint and collision origins were not applied");
+
+        std::remove(obj_path.c_str());
+        std::remove(stl_path.c_str());
+        std::remove(urdf_path.c_str());
+
+        bool thrown = false;
+        try {
+            TriangleMesh::loadFile("missing.obj");
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        testAssert(thrown, "loading a missing mesh did not throw");
+    }
+
+    void testAgainstBruteForce()
+    {
+        std::mt19937 rng(42);
+        vector<TriangleMesh> meshes = makeMeshes(rng);
+        StaticScene scene;
+        for (const auto& mesh : meshes)
+            scene.addMesh(mesh);
+        scene.build();
+
+        for (bool coherent : { true, false }) {
+            vector<StaticScene::Ray> rays = makeRays(rng, 5000, coherent);
+            vector<StaticScene::Hit> packet_hits, thread_hits;
+            scene.castRays(rays, packet_hits, 1);
+            scene.castRays(rays, thread_hits, 4);
+            for (size_t i = 0; i < rays.size(); ++i) {
+                StaticScene::Hit expected = bruteForce(meshes, rays[i]);
+                StaticScene::Hit single = scene.castRay(rays[i]);
+                for (const StaticScene::Hit* hit : { &single, &packet_hits[i], &thread_hits[i] }) {
+                    testAssert(hit->isHit() == expected.isHit(), Utils::stringf("ray %d: hit differs from brute force", static_cast<int>(i)));
+                    testAssert(std::fabs(hit->distance - expected.distance) <= 1e-4f * std::max(1.0f, expected.distance),
+                        Utils::stringf("ray %d: distance %f, brute force %f", static_cast<int>(i), hit->distance, expected.distance));
+                }
+            }
+        }
+    }
+
+    void testRayCast()
+    {
+        StaticScene scene;
+        TriangleMesh wall = TriangleMesh::box(Vector3r(1, 10, 10));
+        wall.name = "wall";
+        scene.addMesh(wall, Pose(Vector3r(5, 0, 0), Quaternionr::Identity()));
+        scene.build();
+
+        RayCastRequest request;
+        request.position = Vector3r(0, 0, 0);
+        request.direction = Vector3r(10, 0, 0);
+        request.through_blocking = true;
+        request.persist_seconds = 0;
+        RayCastResponse response = scene.rayCast(request);
+        testAssert(response.hits.size() == 2, "ray through the wall should hit both faces");
+        testAssert((response.hits[0].hit_point - Vector3r(4.5f, 0, 0)).norm() < 1e-4f && response.hits[0].collided_actor_name == "wall",
+            "first hit is not on the near face");
+        testAssert((response.hits[0].hit_normal - Vector3r(-1, 0, 0)).norm() < 1e-4f, "hit normal does not face the ray");
+        testAssert((response.hits[1].hit_point - Vector3r(5.5f, 0, 0)).norm() < 1e-4f, "second hit is not on the far face");
+
+        request.through_blocking = false;
+        testAssert(scene.rayCast(request).hits.size() == 1, "blocking ray cast should stop at the first hit");
+        request.direction = Vector3r(4, 0, 0);
+        testAssert(scene.rayCast(request).hits.empty(), "ray cast should end at position + direction");
+    }
+
+    void benchmark()
+    {
+        std::mt19937 rng(7);
+        vector<TriangleMesh> meshes = makeMeshes(rng);
+        StaticScene scene;
+        for (const auto& mesh : meshes)
+            scene.addMesh(mesh);
+        common_utils::Timer timer;
+        timer.start();
+        scene.build();
+        double build_seconds = timer.seconds();
+
+        vector<StaticScene::Ray> rays = makeRays(rng, 1 << 20, true);
+        vector<StaticScene::Hit> hits(rays.size());
+
+        timer.start();
+        for (size_t i = 0; i < rays.size(); ++i)
+            hits[i] = scene.castRay(rays[i]);
+        double single_seconds = timer.seconds();
+        timer.start();
+        scene.castRays(rays, hits, 1);
+        double packet_seconds = timer.seconds();
+        timer.start();
+        scene.castRays(rays, hits);
+        double threaded_seconds = timer.seconds();
+
+        double millions = rays.size() / 1e6;
+        std::cout << "StaticScene: " << scene.triangleCount() << " triangles built in " << build_seconds * 1000 << " ms, "
+            << millions / single_seconds << " M rays/s single, " << millions / packet_seconds << " M rays/s packets, "
+            << millions / threaded_seconds << " M rays/s all threads" << std::endl;
+    }
+};
+
+}}
+#endif
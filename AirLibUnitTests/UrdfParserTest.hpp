@@ -0,0 +1,473 @@
+#ifndef msr_AirLibUnitTests_UrdfParserTest_hpp
+#define msr_AirLibUnitTests_UrdfParserTest_hpp
+
+#include "TestBase.hpp"
+#include "vehicles/urdfbot/parser/UrdfParser.hpp"
+#include "common/common_utils/Timer.hpp"
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+namespace msr { namespace airlib {
+
+class UrdfParserTest : public TestBase {
+public:
+    virtual void run() override
+    {
+        testGolden();
+        testXacro();
+        testInclude();
+        testErrors();
+        testFuzz();
+        benchmark();
+    }
+
+private:
+    //two link arm with a gripper finger that mimics the wrist
+    static const char* getArmUrdf()
+    {
+        return R"xml(<?xml version="1.0"?>
+<!-- test arm -->
+<robot name="arm">
+  <material name="steel">
+    <color rgba="0.5 0.5 0.55 1"/>
+  </material>
+  <link name="base">
+    <inertial>
+      <mass value="4"/>
+      <inertia ixx="0.1" ixy="0" ixz="0" iyy="0.1" iyz="0" izz="0.2"/>
+    </inertial>
+    <visual name="base_visual">
+      <origin xyz="0 0 0.05" rpy="0 0 0"/>
+      <geometry><cylinder radius="0.2" length="0.1"/></geometry>
+      <material name="steel"/>
+    </visual>
+  </link>
+  <link name="upper">
+    <inertial>
+      <origin xyz="0 0 0.25"/>
+      <mass value="1.5"/>
+      <inertia ixx="0.03" ixy="0" ixz="0" iyy="0.03" iyz="0" izz="0.001"/>
+    </inertial>
+    <visual>
+      <geometry><box size="0.05 0.05 0.5"/></geometry>
+      <material name="paint"><color rgba="1 0.5 0 1"/></material>
+    </visual>
+    <collision>
+      <geometry>
+        <mesh location="meshes/upper.stl" type="stl_ascii" scale_factor="0.001" reverse_normals="true" dynamic_collision_type="VHACD"/>
+      </geometry>
+    </collision>
+  </link>
+  <link name="finger">
+    <inertial>
+      <mass value="0.1"/>
+      <inertia ixx="1e-4" ixy="0" ixz="0" iyy="1e-4" iyz="0" izz="1e-4"/>
+    </inertial>
+    <collision><geometry><sphere radius="0.02"/></geometry></collision>
+  </link>
+  <joint name="shoulder" type="revolute">
+    <origin xyz="0 0 0.1" rpy="0 0 1.5707963267948966"/>
+    <parent link="base"/>
+    <child link="upper"/>
+    <axis xyz="0 1 0"/>
+    <limit lower="-1.5" upper="1.5" effort="40" velocity="2"/>
+    <dynamics damping="0.7"/>
+    <safety_controller soft_lower_limit="-1.4" soft_upper_limit="1.4" k_position="10" k_velocity="5"/>
+    <calibration rising="0.1"/>
+  </joint>
+  <joint name="wrist" type="prismatic">
+    <origin xyz="0 0 0.5"/>
+    <parent link="upper"/>
+    <child link="finger"/>
+    <axis xyz="1 0 0"/>
+    <limit lower="0" upper="0.04" effort="5" velocity="0.1"/>
+    <mimic joint="shoulder" multiplier="-0.01" offset="0.02"/>
+  </joint>
+  <force name="spin" type="actuator" link_name="upper" axis="0 0 1"/>
+  <force name="push" type="linear" link_name="finger" axis="1 0 0" application_point="0 0 0.01"/>
+  <gazebo reference="base"/>
+</robot>
+)xml";
+    }
+
+    //the same arm written with xacro
+    static const char* getArmXacro()
+    {
+        return R"xml(<?xml version="1.0"?>
+<robot name="${robot_name}" xmlns:xacro="http://www.ros.org/wiki/xacro">
+  <xacro:arg name="finger_mass" default="0.1"/>
+  <xacro:property name="robot_name" value="arm"/>
+  <xacro:property name="arm_length" value="0.5"/>
+  <xacro:property name="half_pi" value="${pi / 2}"/>
+  <xacro:property name="tiny" value="${1e-4}"/>
+  <material name="steel">
+    <color rgba="0.5 0.5 0.55 1"/>
+  </material>
+
+  <xacro:macro name="inertial" params="mass ixx iyy:=^|${ixx} izz *origin">
+    <inertial>
+      <xacro:insert_block name="origin"/>
+      <mass value="${mass}"/>
+      <inertia ixx="${ixx}" ixy="0" ixz="0" iyy="${iyy}" iyz="0" izz="${izz}"/>
+    </inertial>
+  </xacro:macro>
+
+  <xacro:macro name="link" params="name mass ixx izz z:=0 **shapes">
+    <link name="${name}">
+      <xacro:inertial mass="${mass}" ixx="${ixx}" izz="${izz}">
+        <origin xyz="0 0 ${z}"/>
+      </xacro:inertial>
+      <xacro:unless value="${name == 'finger'}"><xacro:insert_block name="shapes"/></xacro:unless>
+      <xacro:if value="${name == 'finger'}">
+        <collision><geometry><sphere radius="0.02"/></geometry></collision>
+      </xacro:if>
+    </link>
+  </xacro:macro>
+
+  <xacro:link name="base" mass="4" ixx="0.1" izz="${2 * 0.1}">
+    <shapes>
+      <visual name="base_visual">
+        <origin xyz="0 0 ${0.1 / 2}" rpy="0 0 0"/>
+        <geometry><cylinder radius="0.2" length="0.1"/></geometry>
+        <material name="steel"/>
+      </visual>
+    </shapes>
+  </xacro:link>
+  <xacro:link name="upper" mass="${3 / 2}" ixx="0.03" izz="0.001" z="${arm_length / 2}">
+    <shapes>
+      <visual>
+        <geometry><box size="0.05 0.05 ${arm_length}"/></geometry>
+        <material name="paint"><color rgba="1 0.5 0 1"/></material>
+      </visual>
+      <collision>
+        <geometry>
+          <mesh location="meshes/upper.stl" type="stl_ascii" scale_factor="${1 / 1000}" reverse_normals="${arm_length > 0.1}" dynamic_collision_type="VHACD"/>
+        </geometry>
+      </collision>
+    </shapes>
+  </xacro:link>
+  <xacro:link name="finger" mass="$(arg finger_mass)" ixx="${tiny}" izz="${tiny}">
+    <shapes/>
+  </xacro:link>
+
+  <joint name="shoulder" type="revolute">
+    <origin xyz="0 0 0.1" rpy="0 0 ${half_pi}"/>
+    <parent link="base"/>
+    <child link="upper"/>
+    <axis xyz="0 1 0"/>
+    <limit lower="${-1.5}" upper="1.5" effort="${8 * 5}" velocity="2"/>
+    <dynamics damping="0.7"/>
+    <safety_controller soft_lower_limit="-1.4" soft_upper_limit="1.4" k_position="10" k_velocity="5"/>
+    <calibration rising="0.1"/>
+  </joint>
+  <joint name="wrist" type="prismatic">
+    <origin xyz="0 0 ${arm_length}"/>
+    <parent link="upper"/>
+    <child link="finger"/>
+    <axis xyz="1 0 0"/>
+    <limit lower="0" upper="0.04" effort="5" velocity="0.1"/>
+    <mimic joint="shoulder" multiplier="-0.01" offset="0.02"/>
+  </joint>
+  <force name="spin" type="actuator" link_name="upper" axis="0 0 1"/>
+  <force name="push" type="linear" link_name="finger" axis="1 0 0" application_point="0 0 0.01"/>
+  <gazebo reference="base"/>
+</robot>
+)xml";
+    }
+
+    static const char* getArmGolden()
+    {
+        return R"xml(robot arm root base
+material paint rgba 1 0.5 0 1
+material steel rgba 0.5 0.5 0.55 1
+link base
+  inertial xyz 0 0 0 rpy 0 0 0 mass 4 inertia 0.1 0 0 0.1 0 0.2
+  visual base_visual xyz 0 0 0.05 rpy 0 0 0 cylinder 0.2 0.1 material steel
+link finger
+  inertial xyz 0 0 0 rpy 0 0 0 mass 0.1 inertia 0.0001 0 0 0.0001 0 0.0001
+  collision  xyz 0 0 0 rpy 0 0 0 sphere 0.02
+link upper
+  inertial xyz 0 0 0.25 rpy 0 0 0 mass 1.5 inertia 0.03 0 0 0.03 0 0.001
+  visual  xyz 0 0 0 rpy 0 0 0 box 0.05 0.05 0.5 material paint
+  collision  xyz 0 0 0 rpy 0 0 0 mesh meshes/upper.stl stl_ascii scale 0.001 reversed collision 1
+joint shoulder revolute base -> upper xyz 0 0 0.1 rpy 0 0 1.5708 axis 0 1 0 rpy 0 0 0 damping 0.7 friction 0
+  limit -1.5 1.5 effort 40 velocity 2
+  calibration 0.1 nan
+  safety -1.4 1.4 10 5
+joint wrist prismatic upper -> finger xyz 0 0 0.5 rpy 0 0 0 axis 1 0 0 rpy 0 0 0 damping 0 friction 0
+  limit 0 0.04 effort 5 velocity 0.1
+  mimic shoulder -0.01 0.02
+force push linear finger axis 1 0 0 at 0 0 0.01
+force spin angular upper axis 0 0 1
+)xml";
+    }
+
+    void testGolden()
+    {
+        UrdfParser parser;
+        UrdfRobot urdf = parser.parseString(getArmUrdf(), "arm.urdf");
+        testAssert(UrdfParser::describe(urdf) == getArmGolden(), "urdf does not match the golden description");
+        testAssert(parser.getWarnings().size() == 1 && parser.getWarnings()[0].line == 61
+            && parser.getWarnings()[0].toString().find("arm.urdf:61:") == 0, "unknown element should warn with its line");
+
+        UrdfRobot xacro = parser.parseString(getArmXacro(), "arm.xacro");
+        testAssert(UrdfParser::describe(xacro) == getArmGolden(), "xacro does not match the golden description");
+        testAssert(xacro.joints.at("shoulder").origin.rpy.z() == static_cast<real_T>(M_PI / 2), "pi was not expanded");
+        testAssert(xacro.links.at("upper").collision.geometry.dynamic_collision_type == UrdfDynamicCollisionType::Vhacd, "wrong collision type");
+
+        parser.setArgument("finger_mass", "0.25");
+        testAssert(parser.parseString(getArmXacro(), "arm.xacro").links.at("finger").inertial.mass == 0.25f, "argument did not override default");
+    }
+
+    void testXacro()
+    {
+        UrdfParser parser;
+        testAssert(parser.parseString("<robot name='${2 ** 3 + 7 // 2 - 10 % 4}'>" + std::string(R"xml(
+            <link name="l"><inertial><mass value="1"/><inertia ixx="1" ixy="0" ixz="0" iyy="1" iyz="0" izz="1"/></inertial>
+            <collision><geometry><sphere radius="1"/></geometry></collision></link></robot>)xml")).name == "9", "arithmetic");
+
+        struct Case {
+            const char* expression;
+            const char* expected;
+        };
+        const Case cases[] = {
+            { "${-2 ** 2}", "-4" },
+            { "${(1 + 2) * 3}", "9" },
+            { "${1 / 4}", "0.25" },
+            { "${0.1 + 0.2}", "0.30000000000000004" },
+            { "${radians(180) == pi}", "true" },
+            { "${math.cos(0) > 0.5 and not 1 > 2}", "true" },
+            { "${max(1, 5, 3) - min(4, 2)}", "3" },
+            { "${atan2(1, 1) * 4 / pi}", "1" },
+            { "${'a' + 'b'}", "ab" },
+            { "x${1+1}y$${z}", "x2y${z}" }
+        };
+        for (const auto& c : cases) {
+            UrdfParser expression_parser;
+            std::string name = expression_parser.parseString(std::string("<robot name=\"") + c.expression + R"xml(">
+                <link name="l"><inertial><mass value="1"/><inertia ixx="1" ixy="0" ixz="0" iyy="1" iyz="0" izz="1"/></inertial>
+                <collision><geometry><sphere radius="1"/></geometry></collision></link></robot>)xml").name;
+            testAssert(name == c.expected, std::string(c.expression) + " gave " + name);
+        }
+
+        //scopes: macro parameters hide properties, scope="parent" writes through
+        UrdfParser scope_parser;
+        UrdfRobot robot = scope_parser.parseString(R"xml(<robot name="r" xmlns:xacro="http://www.ros.org/wiki/xacro">
+            <xacro:property name="size" value="1"/>
+            <xacro:macro name="sphere_link" params="name size:=2 extra:=''">
+                <xacro:property name="last" value="${name}" scope="global"/>
+                <link name="${name}${extra}"><inertial><mass value="${size}"/><inertia ixx="1" ixy="0" ixz="0" iyy="1" iyz="0" izz="1"/></inertial>
+                <collision><geometry><sphere radius="${size}"/></geometry></collision></link>
+            </xacro:macro>
+            <xacro:sphere_link name="a"/>
+            <xacro:sphere_link name="b" size="${size * 3}" extra="_x"/>
+            <joint name="j" type="fixed"><parent link="a"/><child link="${last}_x"/></joint>
+        </robot>)xml");
+        testAssert(robot.links.at("a").inertial.mass == 2 && robot.links.at("b_x").inertial.mass == 3
+            && robot.root_link == "a", "macro parameters and scopes");
+    }
+
+    void writeFile(const std::string& file_path, const std::string& text)
+    {
+        std::ofstream file(file_path, std::ios::binary);
+        file << text;
+    }
+
+    void testInclude()
+    {
+        writeFile("UrdfParserTest_parts.xacro", R"xml(<robot xmlns:xacro="http://www.ros.org/wiki/xacro">
+  <xacro:property name="radius" value="0.3"/>
+  <xacro:macro name="ball" params="name">
+    <link name="${name}"><inertial><mass value="1"/><inertia ixx="1" ixy="0" ixz="0" iyy="1" iyz="0" izz="1"/></inertial>
+    <collision><geometry><sphere radius="${radius}"/></geometry></collision></link>
+  </xacro:macro>
+  <xacro:ball name="included"/>
+  <joint name="broken" type="fixed"><parent link="included"/><child link="missing"/></joint>
+</robot>)xml");
+
+        UrdfParser parser;
+        parser.setPackagePath("test_pkg", ".");
+        std::string main = R"xml(<robot name="r" xmlns:xacro="http://www.ros.org/wiki/xacro">
+  <xacro:include filename="$(find test_pkg)/UrdfParserTest_parts.xacro"/>
+  <xacro:ball name="main"/>
+  <joint name="j" type="fixed"><parent link="included"/><child link="main"/></joint>
+</robot>)xml";
+        try {
+            parser.parseString(main, "main.xacro");
+            testAssert(false, "missing link was not reported");
+        }
+        catch (const std::runtime_error& error) {
+            testAssert(std::string(error.what()).find("./UrdfParserTest_parts.xacro:8: joint 'broken'") == 0,
+                std::string("error should point to the included file, got ") + error.what());
+        }
+
+        writeFile("UrdfParserTest_parts.xacro", R"xml(<robot xmlns:xacro="http://www.ros.org/wiki/xacro">
+  <xacro:property name="radius" value="0.3"/>
+  <xacro:macro name="ball" params="name">
+    <link name="${name}"><inertial><mass value="1"/><inertia ixx="1" ixy="0" ixz="0" iyy="1" iyz="0" izz="1"/></inertial>
+    <collision><geometry><sphere radius="${radius}"/></geometry></collision></link>
+  </xacro:macro>
+  <xacro:ball name="included"/>
+</robot>)xml");
+        UrdfRobot robot = parser.parseString(main, "main.xacro");
+        testAssert(robot.links.size() == 2 && robot.links.at("main").collision.geometry.radius == 0.3f
+            && robot.root_link == "included", "include was not expanded");
+        std::remove("UrdfParserTest_parts.xacro");
+    }
+
+    void testErrors()
+    {
+        const std::string inertial = R"xml(<inertial><mass value="1"/><inertia ixx="1" ixy="0" ixz="0" iyy="1" iyz="0" izz="1"/></inertial>)xml";
+        const std::string shape = R"xml(<collision><geometry><sphere radius="1"/></geometry></collision>)xml";
+        const std::string link = "<link name='a'>" + inertial + shape + "</link>";
+        struct Case {
+            std::string xml;
+            std::string expected; //start of the message
+        };
+        const Case cases[] = {
+            { "<robot>\n<link name='a'>\n</robot>", "t.urdf:3: expected </link> but found </robot>" },
+            { "<robot>\n<link name='a' name='b'/>\n</robot>", "t.urdf:2: duplicate attribute 'name'" },
+            { "<robot>\n" + link + "\n<link name='a'>" + inertial + shape + "</link></robot>", "t.urdf:3: multiple links with name 'a', the first is on line 2" },
+            { "<robot>\n\n<link name='a'>" + shape + "</link></robot>", "t.urdf:3: no inertial element in link 'a'" },
+            { "<robot>" + link + "\n<joint name='j' type='revolute'><parent link='a'/><child link='a'/></joint></robot>",
+                "t.urdf:2: joint 'j' is of type 'revolute', which needs a limit element" },
+            { "<robot>" + link + "\n<joint name='j' type='fixed'><parent link='a'/><child link='b'/></joint></robot>",
+                "t.urdf:2: joint 'j' references link 'b' as the child link" },
+            { "<robot>\n<link name='a'>" + inertial + "<visual><geometry><box size='1 2'/></geometry></visual></link></robot>",
+                "t.urdf:2: attribute 'size' of <box> must have 3 numbers" },
+            { "<robot>\n<link name='a'>" + inertial + "<visual><geometry><sphere radius='big'/></geometry></visual></link></robot>",
+                "t.urdf:2: attribute 'radius' of <sphere> is not a number" },
+            { "<robot>" + link + "<force name='f' type='spin' link_name='a' axis='0 0 1'/></robot>", "t.urdf:1: unknown type 'spin' for force 'f'" },
+            { "<robot>" + link + "\n<link name='b'>" + inertial + shape + "</link></robot>", "t.urdf: there can only be one link without a parent" },
+            { "<robot xmlns:xacro='x'>\n\n<xacro:missing/></robot>", "t.urdf:3: unknown macro or unsupported xacro element <xacro:missing>" },
+            { "<robot xmlns:xacro='x'>\n<xacro:property name='p' value='${1 +}'/></robot>", "t.urdf:2: unexpected end in expression '1 +'" },
+            { "<robot xmlns:xacro='x'>\n<xacro:property name='p' value='${q}'/></robot>", "t.urdf:2: unknown property 'q'" },
+            { "<robot xmlns:xacro='x'>\n<xacro:macro name='m' params='a'>\n<link name='${b}'/></xacro:macro>\n<xacro:m a='1'/></robot>",
+                "t.urdf:3: unknown property 'b' in expression 'b' (in macro 'm' called at t.urdf:4)" },
+            { "<robot xmlns:xacro='x'>\n<xacro:macro name='m' params='a'>\n<xacro:m a='1'/></xacro:macro>\n<xacro:m a='1'/></robot>",
+                "t.urdf:3: macros are nested too deeply" },
+            { "<robot xmlns:xacro='x'><xacro:macro name='m' params='a'/>\n<xacro:m/></robot>", "t.urdf:2: macro 'm' is missing parameter 'a'" },
+            { "<robot>\n<!-- never closed </robot>", "t.urdf:2: unterminated comment" },
+            { "<robot/>\n<robot/>", "t.urdf:2: more than one root element" },
+            { "<robot name='&bogus;'/>", "t.urdf:1: unknown entity &bogus;" }
+        };
+        for (const auto& c : cases) {
+            std::string message = "no error";
+            try {
+                UrdfParser parser;
+                parser.parseString(c.xml, "t.urdf");
+            }
+            catch (const std::runtime_error& error) {
+                message = error.what();
+            }
+            testAssert(message.compare(0, c.expected.size(), c.expected) == 0, "expected '" + c.expected + "', got '" + message + "'");
+        }
+    }
+
+    //random edits of valid documents must be reported as errors, never crash or throw anything else
+    void testFuzz()
+    {
+        const std::string seeds[] = { getArmUrdf(), getArmXacro() };
+        const char alphabet[] = "<>/=\"'${}()&;!?-[] \nxacro:if*";
+        std::mt19937 rng(7);
+        int accepted = 0;
+        for (uint iteration = 0; iteration < 3000; ++iteration) {
+            std::string xml = seeds[iteration % 2];
+            const uint edits = 1 + static_cast<uint>(rng() % 4);
+            for (uint edit = 0; edit < edits; ++edit) {
+                size_t pos = rng() % xml.size();
+                size_t length = 1 + rng() % 16;
+                switch (rng() % 4) {
+                case 0: xml.erase(pos, length); break;
+                case 1: xml.insert(pos, 1, alphabet[rng() % (sizeof(alphabet) - 1)]); break;
+                case 2: xml.insert(pos, xml.substr(rng() % xml.size(), length)); break;
+                default: xml.resize(pos); break;
+                }
+                if (xml.empty())
+                    xml = "<";
+            }
+
+            try {
+                UrdfParser parser;
+                parser.parseString(xml, "fuzz.urdf");
+                ++accepted;
+            }
+            catch (const std::runtime_error& error) {
+                testAssert(std::string(error.what()).compare(0, 10, "fuzz.urdf:") == 0, std::string("error without a location: ") + error.what());
+            }
+            catch (...) {
+                testAssert(false, "unexpected exception type for:\n" + xml);
+            }
+        }
+        testAssert(accepted > 0, "every mutation was rejected");
+    }
+
+    //a serial chain of box links, written either with a macro or expanded
+    static std::string generateRobot(int links, bool use_xacro)
+    {
+        std::string xml = "<robot name='chain' xmlns:xacro='http://www.ros.org/wiki/xacro'>\n";
+        if (use_xacro)
+            xml += R"xml(<xacro:property name="length" value="0.2"/>
+<xacro:macro name="segment" params="index parent:='' mass:=1.5">
+  <link name="link${index}">
+    <inertial><origin xyz="0 0 ${length / 2}"/><mass value="${mass}"/>
+      <inertia ixx="${mass * length * length / 12}" ixy="0" ixz="0" iyy="${mass * length * length / 12}" iyz="0" izz="0.001"/></inertial>
+    <visual><origin xyz="0 0 ${length / 2}"/><geometry><box size="0.05 0.05 ${length}"/></geometry></visual>
+    <collision><origin xyz="0 0 ${length / 2}"/><geometry><box size="0.05 0.05 ${length}"/></geometry></collision>
+  </link>
+  <xacro:unless value="${index == 0}">
+    <joint name="joint${index}" type="revolute">
+      <origin xyz="0 0 ${length}" rpy="0 0 ${pi / 6}"/><parent link="${parent}"/><child link="link${index}"/>
+      <axis xyz="0 1 0"/><limit lower="${-pi / 2}" upper="${pi / 2}" effort="10" velocity="1"/>
+    </joint>
+  </xacro:unless>
+</xacro:macro>
+)xml";
+
+        for (int i = 0; i < links; ++i) {
+            if (use_xacro) {
+                xml += Utils::stringf("<xacro:segment index=\"%d\" parent=\"link%d\"/>\n", i, i - 1);
+                continue;
+            }
+            xml += Utils::stringf(R"xml(<link name="link%d">
+    <inertial><origin xyz="0 0 0.1"/><mass value="1.5"/>
+      <inertia ixx="0.005" ixy="0" ixz="0" iyy="0.005" iyz="0" izz="0.001"/></inertial>
+    <visual><origin xyz="0 0 0.1"/><geometry><box size="0.05 0.05 0.2"/></geometry></visual>
+    <collision><origin xyz="0 0 0.1"/><geometry><box size="0.05 0.05 0.2"/></geometry></collision>
+  </link>
+)xml", i);
+            if (i > 0)
+                xml += Utils::stringf(R"xml(<joint name="joint%d" type="revolute">
+      <origin xyz="0 0 0.2" rpy="0 0 0.5235987755982988"/><parent link="link%d"/><child link="link%d"/>
+      <axis xyz="0 1 0"/><limit lower="-1.5707963267948966" upper="1.5707963267948966" effort="10" velocity="1"/>
+    </joint>
+)xml", i, i - 1, i);
+        }
+        return xml + "</robot>\n";
+    }
+
+    void benchmark()
+    {
+        const int links = 20000;
+        std::cout << "UrdfParser: chain of " << links << " links";
+        std::string descriptions[2];
+        for (int use_xacro = 0; use_xacro < 2; ++use_xacro) {
+            std::string xml = generateRobot(links, use_xacro != 0);
+            UrdfParser parser;
+            common_utils::Timer timer;
+            timer.start();
+            UrdfRobot robot = parser.parseString(xml, "chain.urdf");
+            double seconds = timer.seconds();
+            testAssert(robot.links.size() == links && robot.joints.size() == links - 1 && robot.root_link == "link0", "wrong chain");
+            descriptions[use_xacro] = UrdfParser::describe(robot);
+            std::cout << (use_xacro ? ", xacro " : ", urdf ") << static_cast<int>(links / seconds) << " links/s "
+                << static_cast<int>(xml.size() / 1E6 / seconds) << " MB/s";
+        }
+        std::cout << std::endl;
+        testAssert(descriptions[0] == descriptions[1], "xacro chain differs from the expanded chain");
+    }
+};
+
+}}
+#endif
@@ -5,6 +5,29 @@
 #include "WorkerThreadTest.hpp"
 #include "QuaternionTest.hpp"
 #include "CelestialTests.hpp"
+#include "ClockTest.hpp"
+#include "StaticSceneTest.hpp"
+#include "StaticSceneImageCaptureTest.hpp"
+#include "SignedDistanceFieldTest.hpp"
+#include "SensorCollectionTest.hpp"
+#include "SimpleFlightGainTunerTest.hpp"
+#include "UrdfParserTest.hpp"
+#include "JointCouplingTest.hpp"
+#include "JointActuatorTest.hpp"
+#include "JointSensorTest.hpp"
+#include "ContactAggregatorTest.hpp"
+#include "MotionClipTest.hpp"
+#include "ControlScheduleTest.hpp"
+#include "RpcSessionLogTest.hpp"
+#include "RpcDispatchLanesTest.hpp"
+#include "ImuHighRateTest.hpp"
+#include "DistanceArrayTest.hpp"
+#include "EventCameraEmulatorTest.hpp"
+#include "OpticalFlowTest.hpp"
+//the SGM projects are only built on Windows
+#ifdef _WIN32
+#include "SgmStereoTest.hpp"
+#endif
 
 int main()
 {
@@ -13,6 +36,28 @@ int main()
     std::unique_ptr<TestBase> tests[] = {
         std::unique_ptr<TestBase>(new QuaternionTest()),
         std::unique_ptr<TestBase>(new CelestialTest()),
+        std::unique_ptr<TestBase>(new ClockTest()),
+        std::unique_ptr<TestBase>(new StaticSceneTest()),
+        std::unique_ptr<TestBase>(new StaticSceneImageCaptureTest()),
+        std::unique_ptr<TestBase>(new SignedDistanceFieldTest()),
+        std::unique_ptr<TestBase>(new SensorCollectionTest()),
+        std::unique_ptr<TestBase>(new SimpleFlightGainTunerTest()),
+        std::unique_ptr<TestBase>(new UrdfParserTest()),
+        std::unique_ptr<TestBase>(new JointCouplingTest()),
+        std::unique_ptr<TestBase>(new JointActuatorTest()),
+        std::unique_ptr<TestBase>(new JointSensorTest()),
+        std::unique_ptr<TestBase>(new ContactAggregatorTest()),
+        std::unique_ptr<TestBase>(new MotionClipTest()),
+        std::unique_ptr<TestBase>(new ControlScheduleTest()),
+        std::unique_ptr<TestBase>(new RpcSessionLogTest()),
+        std::unique_ptr<TestBase>(new RpcDispatchLanesTest()),
+        std::unique_ptr<TestBase>(new ImuHighRateTest()),
+        std::unique_ptr<TestBase>(new DistanceArrayTest()),
+        std::unique_ptr<TestBase>(new EventCameraEmulatorTest()),
+        std::unique_ptr<TestBase>(new OpticalFlowTest()),
+#ifdef _WIN32
+        std::unique_ptr<TestBase>(new SgmStereoTest()),
+#endif
         std::unique_ptr<TestBase>(new SettingsTest()),
         std::unique_ptr<TestBase>(new SimpleFlightTest())
         //,
@@ -0,0 +1,259 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "UnitTests.h"
+#include <vector>
+#include <random>
+#include <chrono>
+#include <stdexcept>
+#include <string.h>
+#include "Utils.hpp"
+#include "../src/impl/MavLinkFrameParser.hpp"
+
+STRICT_MODE_OFF
+#define MAVLINK_PACKED
+#include "../mavlink/common/mavlink.h"
+#include "../mavlink/mavlink_helpers.h"
+STRICT_MODE_ON
+
+// this test lives in its own file because the mavlink C headers clash with the MavLinkMessages.hpp enums.
+using namespace mavlink_utils;
+using namespace mavlinkcom;
+using namespace mavlinkcom_impl;
+
+namespace {
+
+    struct FrameEvent {
+        uint8_t framing;
+        MavLinkMessage msg;
+    };
+
+    const mavlink_msg_entry_t message_entries[] = MAVLINK_MESSAGE_CRCS;
+
+    // build a frame the slow way, using the byte at a time checksum from the mavlink headers.
+    void appendFrame(std::vector<uint8_t>& stream, std::mt19937& rng, bool mavlink1, bool sign, bool zeroLength)
+    {
+        const int entryCount = static_cast<int>(sizeof(message_entries) / sizeof(message_entries[0]));
+        const mavlink_msg_entry_t* entry = nullptr;
+        uint32_t msgid;
+        do {
+            entry = &message_entries[rng() % entryCount];
+            msgid = entry->msgid;
+        } while (mavlink1 && msgid > 255);
+        if (!mavlink1 && rng() % 20 == 0) {
+            // a message we don't know, checked with crc_extra 0.
+            msgid = 60000 + rng() % 100;
+            entry = nullptr;
+        }
+
+        int len = entry != nullptr ? entry->msg_len : 1 + static_cast<int>(rng() % 200);
+        if (!mavlink1 && len > 1) {
+            len = 1 + static_cast<int>(rng() % len); // trimmed payload
+        }
+        int payloadLength = zeroLength ? 256 : len;
+
+        std::vector<uint8_t> frame;
+        frame.push_back(mavlink1 ? MAVLINK_STX_MAVLINK1 : MAVLINK_STX);
+        frame.push_back(zeroLength ? 0 : static_cast<uint8_t>(len));
+        if (!mavlink1) {
+            frame.push_back(sign ? MAVLINK_IFLAG_SIGNED : 0);
+            frame.push_back(static_cast<uint8_t>(rng()));
+        }
+        frame.push_back(static_cast<uint8_t>(rng())); // seq
+        frame.push_back(static_cast<uint8_t>(1 + rng() % 10)); // sysid
+        frame.push_back(static_cast<uint8_t>(rng())); // compid
+        frame.push_back(msgid & 0xff);
+        if (!mavlink1) {
+            frame.push_back((msgid >> 8) & 0xff);
+            frame.push_back((msgid >> 16) & 0xff);
+        }
+        for (int i = 0; i < payloadLength; i++) {
+            frame.push_back(static_cast<uint8_t>(rng()));
+        }
+        uint16_t crc = crc_calculate(&frame[1], static_cast<uint16_t>(frame.size() - 1));
+        crc_accumulate(entry != nullptr ? entry->crc_extra : 0, &crc);
+        frame.push_back(crc & 0xff);
+        frame.push_back(crc >> 8);
+        if (sign) {
+            for (int i = 0; i < MAVLINK_SIGNATURE_BLOCK_LEN; i++) {
+                frame.push_back(static_cast<uint8_t>(rng()));
+            }
+        }
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+
+    // valid frames of both versions mixed with garbage, corrupted bytes and truncated frames.
+    std::vector<uint8_t> makeStream(std::mt19937& rng, int frames)
+    {
+        std::vector<uint8_t> stream;
+        for (int n = 0; n < frames; n++) {
+            size_t start = stream.size();
+            int kind = rng() % 100;
+            bool mavlink1 = rng() % 4 == 0;
+            appendFrame(stream, rng, mavlink1, !mavlink1 && rng() % 10 == 0, rng() % 200 == 0);
+            size_t frameLength = stream.size() - start;
+            if (kind < 8) {
+                // flip a byte anywhere in the frame
+                stream[start + rng() % frameLength] ^= static_cast<uint8_t>(1 + rng() % 255);
+            }
+            else if (kind < 12) {
+                // frame cut short by a radio dropout
+                stream.resize(start + rng() % frameLength);
+            }
+            else if (kind < 18) {
+                // noise, sometimes with start bytes or an unknown incompat flag in it
+                int noise = rng() % 40;
+                for (int i = 0; i < noise; i++) {
+                    int r = rng() % 10;
+                    stream.push_back(r == 0 ? MAVLINK_STX : (r == 1 ? MAVLINK_STX_MAVLINK1 : (r == 2 ? 0x80 : static_cast<uint8_t>(rng()))));
+                }
+            }
+        }
+        return stream;
+    }
+
+    std::vector<FrameEvent> parseReference(const std::vector<uint8_t>& stream)
+    {
+        std::vector<FrameEvent> events;
+        mavlink_message_t rxmsg;
+        mavlink_message_t msg;
+        mavlink_status_t status;
+        mavlink_status_t r_status;
+        ::memset(&rxmsg, 0, sizeof(rxmsg));
+        ::memset(&msg, 0, sizeof(msg));
+        ::memset(&status, 0, sizeof(status));
+        ::memset(&r_status, 0, sizeof(r_status));
+        for (size_t i = 0; i < stream.size(); i++) {
+            uint8_t framing = mavlink_frame_char_buffer(&rxmsg, &status, stream[i], &msg, &r_status);
+            if (framing != MAVLINK_FRAMING_INCOMPLETE) {
+                FrameEvent e;
+                ::memset(&e.msg, 0, sizeof(e.msg));
+                e.framing = framing;
+                e.msg.checksum = msg.checksum;
+                e.msg.magic = msg.magic;
+                e.msg.len = msg.len;
+                e.msg.incompat_flags = msg.incompat_flags;
+                e.msg.compat_flags = msg.compat_flags;
+                e.msg.seq = msg.seq;
+                e.msg.sysid = msg.sysid;
+                e.msg.compid = msg.compid;
+                e.msg.msgid = msg.msgid;
+                ::memcpy(e.msg.payload64, msg.payload64, sizeof(e.msg.payload64));
+                ::memcpy(e.msg.ck, msg.ck, 2);
+                ::memcpy(e.msg.signature, msg.signature, sizeof(e.msg.signature));
+                events.push_back(e);
+            }
+        }
+        return events;
+    }
+
+    std::vector<FrameEvent> parseBulk(const std::vector<uint8_t>& stream, std::mt19937& rng)
+    {
+        std::vector<FrameEvent> events;
+        MavLinkFrameParser parser;
+        size_t pos = 0;
+        while (pos < stream.size()) {
+            // the port hands us whatever arrived, so frames are split at random places.
+            size_t chunk = std::min(stream.size() - pos, static_cast<size_t>(1 + rng() % 600));
+            parser.parse(&stream[pos], chunk, [&](uint8_t framing, const MavLinkMessage& msg) {
+                FrameEvent e;
+                e.framing = framing;
+                e.msg = msg;
+                events.push_back(e);
+            });
+            pos += chunk;
+        }
+        return events;
+    }
+
+    void compareEvents(const std::vector<FrameEvent>& expected, const std::vector<FrameEvent>& actual)
+    {
+        if (expected.size() != actual.size()) {
+            throw std::runtime_error(Utils::stringf("bulk parser found %d frames, reference parser found %d",
+                static_cast<int>(actual.size()), static_cast<int>(expected.size())));
+        }
+        for (size_t i = 0; i < expected.size(); i++) {
+            const MavLinkMessage& a = expected[i].msg;
+            const MavLinkMessage& b = actual[i].msg;
+            bool same = expected[i].framing == actual[i].framing && a.len == b.len && a.checksum == b.checksum;
+            // the reference parser only updates the length and checksum in the early bad crc report of a signed frame.
+            bool early = expected[i].framing == MAVLINK_FRAMING_BAD_CRC && (b.incompat_flags & MAVLINK_IFLAG_SIGNED) != 0;
+            if (same && !early) {
+                same = a.magic == b.magic && a.incompat_flags == b.incompat_flags && a.compat_flags == b.compat_flags &&
+                    a.seq == b.seq && a.sysid == b.sysid && a.compid == b.compid && a.msgid == b.msgid &&
+                    ::memcmp(a.ck, b.ck, 2) == 0;
+                // past the wire payload and the zero filled message length the reference buffer has stale bytes.
+                const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(a.msgid);
+                size_t defined = a.len == 0 ? 256 : std::max<size_t>(a.len, entry != nullptr ? entry->msg_len : 0);
+                same = same && ::memcmp(a.payload64, b.payload64, defined) == 0;
+                if ((a.incompat_flags & MAVLINK_IFLAG_SIGNED) != 0) {
+                    same = same && ::memcmp(a.signature, b.signature, sizeof(a.signature)) == 0;
+                }
+            }
+            if (!same) {
+                throw std::runtime_error(Utils::stringf("frame %d differs, reference: framing %d msgid %d len %d, bulk: framing %d msgid %d len %d",
+                    static_cast<int>(i), expected[i].framing, static_cast<int>(a.msgid), a.len, actual[i].framing, static_cast<int>(b.msgid), b.len));
+            }
+        }
+    }
+}
+
+void UnitTests::FrameParserTest()
+{
+    std::mt19937 rng(1234);
+
+    // the table driven checksum must match the byte at a time one.
+    for (int i = 0; i < 1000; i++) {
+        uint8_t data[300];
+        size_t length = rng() % sizeof(data);
+        for (size_t j = 0; j < length; j++) {
+            data[j] = static_cast<uint8_t>(rng());
+        }
+        uint16_t expected = crc_calculate(data, static_cast<uint16_t>(length));
+        if (MavLinkFrameParser::crcAccumulate(X25_INIT_CRC, data, length) != expected) {
+            throw std::runtime_error(Utils::stringf("table checksum differs for %d bytes", static_cast<int>(length)));
+        }
+    }
+
+    int total = 0;
+    for (int round = 0; round < 20; round++) {
+        std::vector<uint8_t> stream = makeStream(rng, 2000);
+        std::vector<FrameEvent> expected = parseReference(stream);
+        compareEvents(expected, parseBulk(stream, rng));
+        total += static_cast<int>(expected.size());
+    }
+    printf("    %d frames parsed identically\n", total);
+
+    // throughput on a clean stream.
+    std::vector<uint8_t> clean;
+    for (int n = 0; n < 20000; n++) {
+        appendFrame(clean, rng, false, false, false);
+    }
+    const int repeat = 10;
+    auto start = std::chrono::steady_clock::now();
+    size_t referenceFrames = 0;
+    for (int r = 0; r < repeat; r++) {
+        referenceFrames += parseReference(clean).size();
+    }
+    double referenceSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    MavLinkFrameParser parser;
+    size_t bulkFrames = 0;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++) {
+        for (size_t pos = 0; pos < clean.size(); pos += 512) {
+            parser.parse(&clean[pos], std::min(clean.size() - pos, static_cast<size_t>(512)), [&](uint8_t framing, const MavLinkMessage& msg) {
+                unused(msg);
+                if (framing == MAVLINK_FRAMING_OK) {
+                    bulkFrames++;
+                }
+            });
+        }
+    }
+    double bulkSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (bulkFrames != referenceFrames) {
+        throw std::runtime_error(Utils::stringf("bulk parser found %d clean frames, expecting %d", static_cast<int>(bulkFrames), static_cast<int>(referenceFrames)));
+    }
+    double megabytes = static_cast<double>(clean.size()) * repeat / 1e6;
+    printf("    reference parser %.1f MB/s, bulk parser %.1f MB/s\n", megabytes / referenceSeconds, megabytes / bulkSeconds);
+}
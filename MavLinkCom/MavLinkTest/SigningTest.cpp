@@ -0,0 +1,288 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "UnitTests.h"
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+#include <string.h>
+#include "Utils.hpp"
+#include "MavLinkConnection.hpp"
+#include "../src/impl/MavLinkFrameParser.hpp"
+#include "../src/impl/MavLinkSigning.hpp"
+
+STRICT_MODE_OFF
+#define MAVLINK_PACKED
+#include "../mavlink/common/mavlink.h"
+#include "../mavlink/mavlink_helpers.h"
+STRICT_MODE_ON
+
+// this test lives in its own file because the mavlink C headers clash with the MavLinkMessages.hpp enums.
+using namespace mavlink_utils;
+using namespace mavlinkcom;
+using namespace mavlinkcom_impl;
+
+namespace {
+
+    // the message id macros from the C headers are hidden behind the MavLinkMessageIds enum here.
+    const uint32_t LocalPositionNedId = static_cast<uint32_t>(MavLinkMessageIds::MAVLINK_MSG_ID_LOCAL_POSITION_NED);
+    const int LocalPositionNedLength = 28;
+    const uint32_t HeartbeatId = static_cast<uint32_t>(MavLinkMessageIds::MAVLINK_MSG_ID_HEARTBEAT);
+    const int HeartbeatLength = 9;
+
+    std::string toHex(const uint8_t* data, size_t length)
+    {
+        std::string result;
+        for (size_t i = 0; i < length; i++) {
+            result += Utils::stringf("%02x", data[i]);
+        }
+        return result;
+    }
+
+    void checkSha256(const std::string& input, int repeat, const std::string& expected)
+    {
+        // feed it in uneven pieces so the block buffering gets exercised.
+        MavLinkSha256 sha;
+        std::string data;
+        for (int i = 0; i < repeat; i++) {
+            data += input;
+        }
+        size_t pos = 0;
+        size_t piece = 1;
+        while (pos < data.size()) {
+            size_t n = std::min(piece, data.size() - pos);
+            sha.update(reinterpret_cast<const uint8_t*>(data.data()) + pos, n);
+            pos += n;
+            piece = piece * 3 + 1;
+        }
+        uint8_t hash[32];
+        sha.finish(hash);
+        std::string actual = toHex(hash, sizeof(hash));
+        if (actual != expected) {
+            throw std::runtime_error(Utils::stringf("sha256 of '%s' x %d is %s, expecting %s", input.c_str(), repeat, actual.c_str(), expected.c_str()));
+        }
+    }
+
+    struct Frame {
+        std::vector<uint8_t> bytes;
+        uint8_t* header() { return &bytes[0]; }
+        uint8_t* payload() { return &bytes[MAVLINK_CORE_HEADER_LEN + 1]; }
+        uint8_t* ck() { return payload() + bytes[1]; }
+        uint8_t* signature() { return ck() + 2; }
+    };
+
+    Frame makeFrame(std::mt19937& rng, uint8_t sysid, uint8_t compid, int length, bool sign)
+    {
+        const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(LocalPositionNedId);
+        Frame frame;
+        frame.bytes.resize(MAVLINK_CORE_HEADER_LEN + 1 + length + 2 + (sign ? MAVLINK_SIGNATURE_BLOCK_LEN : 0));
+        uint8_t* h = frame.header();
+        h[0] = MAVLINK_STX;
+        h[1] = static_cast<uint8_t>(length);
+        h[2] = sign ? MAVLINK_IFLAG_SIGNED : 0;
+        h[3] = 0;
+        h[4] = static_cast<uint8_t>(rng());
+        h[5] = sysid;
+        h[6] = compid;
+        h[7] = LocalPositionNedId;
+        h[8] = 0;
+        h[9] = 0;
+        for (int i = 0; i < length; i++) {
+            frame.payload()[i] = static_cast<uint8_t>(rng());
+        }
+        uint16_t crc = crc_calculate(h + 1, static_cast<uint16_t>(MAVLINK_CORE_HEADER_LEN + length));
+        crc_accumulate(entry->crc_extra, &crc);
+        frame.ck()[0] = crc & 0xff;
+        frame.ck()[1] = crc >> 8;
+        return frame;
+    }
+
+    Frame makeSignedFrame(std::mt19937& rng, MavLinkSigning& signing, uint8_t sysid, int length)
+    {
+        Frame frame = makeFrame(rng, sysid, 1, length, true);
+        signing.sign(frame.header(), MAVLINK_CORE_HEADER_LEN + 1, frame.payload(), length, frame.ck(), frame.signature());
+        return frame;
+    }
+
+    uint8_t parseOne(MavLinkFrameParser& parser, const Frame& frame)
+    {
+        uint8_t result = MAVLINK_FRAMING_INCOMPLETE;
+        parser.parse(frame.bytes.data(), frame.bytes.size(), [&](uint8_t framing, const MavLinkMessage& msg) {
+            unused(msg);
+            result = framing;
+        });
+        return result;
+    }
+}
+
+void UnitTests::SigningTest()
+{
+    // FIPS 180-2 test vectors.
+    checkSha256("", 1, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    checkSha256("abc", 1, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    checkSha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    checkSha256("a", 1000000, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+    std::mt19937 rng(42);
+    std::vector<uint8_t> key(32);
+    for (size_t i = 0; i < key.size(); i++) {
+        key[i] = static_cast<uint8_t>(rng());
+    }
+
+    // our signatures must pass the reference check in mavlink_helpers.h, and the other way around.
+    mavlink_signing_t reference;
+    ::memset(&reference, 0, sizeof(reference));
+    ::memcpy(reference.secret_key, key.data(), key.size());
+    reference.link_id = 7;
+    reference.timestamp = MavLinkSigning::currentTimestamp();
+    reference.flags = MAVLINK_SIGNING_FLAG_SIGN_OUTGOING;
+    mavlink_signing_streams_t referenceStreams;
+    ::memset(&referenceStreams, 0, sizeof(referenceStreams));
+
+    auto sender = std::make_shared<MavLinkSigning>(key, 3, 0);
+    auto receiver = std::make_shared<MavLinkSigning>(key, 4, 0);
+    MavLinkFrameParser parser;
+    parser.setSigning(receiver);
+    for (int i = 0; i < 200; i++) {
+        int length = 1 + static_cast<int>(rng() % LocalPositionNedLength);
+        Frame ours = makeSignedFrame(rng, *sender, 1, length);
+        mavlink_message_t rxmsg, msg;
+        mavlink_status_t status, rstatus;
+        ::memset(&status, 0, sizeof(status));
+        status.signing = &reference;
+        status.signing_streams = &referenceStreams;
+        uint8_t framing = MAVLINK_FRAMING_INCOMPLETE;
+        for (size_t j = 0; j < ours.bytes.size(); j++) {
+            framing = mavlink_frame_char_buffer(&rxmsg, &status, ours.bytes[j], &msg, &rstatus);
+        }
+        if (framing != MAVLINK_FRAMING_OK) {
+            throw std::runtime_error(Utils::stringf("reference parser rejected our signature, framing %d", framing));
+        }
+
+        Frame theirs = makeFrame(rng, 2, 1, length, true);
+        mavlink_sign_packet(&reference, theirs.signature(), theirs.header(), MAVLINK_CORE_HEADER_LEN + 1, theirs.payload(), static_cast<uint8_t>(length), theirs.ck());
+        if (parseOne(parser, theirs) != MAVLINK_FRAMING_OK) {
+            throw std::runtime_error("bulk parser rejected a reference signature");
+        }
+    }
+
+    // replays, tampering, wrong keys and unsigned messages are all rejected.
+    Frame f1 = makeSignedFrame(rng, *sender, 5, 28);
+    Frame f2 = makeSignedFrame(rng, *sender, 5, 28);
+    Frame f3 = makeSignedFrame(rng, *sender, 5, 28);
+    if (parseOne(parser, f1) != MAVLINK_FRAMING_OK || parseOne(parser, f1) != MAVLINK_FRAMING_BAD_SIGNATURE) {
+        throw std::runtime_error("replayed frame was accepted");
+    }
+    if (parseOne(parser, f3) != MAVLINK_FRAMING_OK || parseOne(parser, f2) != MAVLINK_FRAMING_OK ||
+        parseOne(parser, f2) != MAVLINK_FRAMING_BAD_SIGNATURE) {
+        throw std::runtime_error("out of order frame should be accepted once");
+    }
+    Frame tampered = makeSignedFrame(rng, *sender, 5, 28);
+    tampered.signature()[10] ^= 1;
+    if (parseOne(parser, tampered) != MAVLINK_FRAMING_BAD_SIGNATURE) {
+        throw std::runtime_error("tampered signature was accepted");
+    }
+    std::vector<uint8_t> otherKey(key);
+    otherKey[0] ^= 0xff;
+    MavLinkSigning intruder(otherKey, 3, 0);
+    if (parseOne(parser, makeSignedFrame(rng, intruder, 6, 28)) != MAVLINK_FRAMING_BAD_SIGNATURE) {
+        throw std::runtime_error("frame signed with the wrong key was accepted");
+    }
+    Frame unsignedFrame = makeFrame(rng, 5, 1, 28, false);
+    if (parseOne(parser, unsignedFrame) != MAVLINK_FRAMING_BAD_SIGNATURE) {
+        throw std::runtime_error("unsigned frame was accepted");
+    }
+    receiver->setAcceptUnsignedHandler([](int msgid) { return msgid == static_cast<int>(LocalPositionNedId); });
+    if (parseOne(parser, unsignedFrame) != MAVLINK_FRAMING_OK) {
+        throw std::runtime_error("unsigned frame was not accepted by the handler");
+    }
+
+    // end to end over udp, the vehicle only hears the ground station that has the key.
+    const int port = 14596;
+    auto vehicle = MavLinkConnection::connectLocalUdp("vehicle", "127.0.0.1", port);
+    auto gcs = MavLinkConnection::connectRemoteUdp("gcs", "127.0.0.1", "127.0.0.1", port);
+    auto rogue = MavLinkConnection::connectRemoteUdp("rogue", "127.0.0.1", "127.0.0.1", port);
+    vehicle->enableSigning(key, 1);
+    gcs->enableSigning(key, 2);
+    std::atomic<int> fromGcs{ 0 };
+    std::atomic<int> fromRogue{ 0 };
+    int id = vehicle->subscribe([&](std::shared_ptr<MavLinkConnection> connection, const MavLinkMessage& msg) {
+        unused(connection);
+        if ((msg.incompat_flags & MAVLINK_IFLAG_SIGNED) == 0) {
+            fromRogue++;
+        }
+        else if (msg.sysid == 255) {
+            fromGcs++;
+        }
+        else {
+            fromRogue++;
+        }
+    });
+    MavLinkMessage heartbeat;
+    ::memset(&heartbeat, 0, sizeof(heartbeat));
+    heartbeat.msgid = HeartbeatId;
+    heartbeat.len = HeartbeatLength;
+    heartbeat.compid = 190;
+    const int count = 100;
+    for (int i = 0; i < count; i++) {
+        heartbeat.sysid = 255;
+        gcs->sendMessage(heartbeat);
+        heartbeat.sysid = 66;
+        rogue->sendMessage(heartbeat);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    for (int retries = 0; retries < 100 && fromGcs < count; retries++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    MavLinkTelemetry telemetry;
+    vehicle->getTelemetry(telemetry);
+    printf("    vehicle accepted %d signed messages, rejected %d\n", static_cast<int>(fromGcs), telemetry.crcErrors);
+    if (fromGcs < count * 3 / 4 || fromRogue != 0 || telemetry.crcErrors < count * 3 / 4) {
+        throw std::runtime_error(Utils::stringf("signed link accepted %d of %d messages from the gcs and %d from the rogue",
+            static_cast<int>(fromGcs), count, static_cast<int>(fromRogue)));
+    }
+    vehicle->unsubscribe(id);
+    vehicle->close();
+    gcs->close();
+    rogue->close();
+
+    // per frame cost, a typical 28 byte telemetry message.
+    const int frames = 100000;
+    std::vector<Frame> batch;
+    MavLinkSigning benchSender(key, 9, 0);
+    for (int i = 0; i < frames; i++) {
+        batch.push_back(makeFrame(rng, 9, 1, 28, true));
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        Frame& f = batch[i];
+        benchSender.sign(f.header(), MAVLINK_CORE_HEADER_LEN + 1, f.payload(), 28, f.ck(), f.signature());
+    }
+    double signNanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    MavLinkSigning benchReceiver(key, 10, 0);
+    int accepted = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        Frame& f = batch[i];
+        if (benchReceiver.check(f.header(), MAVLINK_CORE_HEADER_LEN + 1 + 28 + 2, f.signature(), 9, 1)) {
+            accepted++;
+        }
+    }
+    double checkNanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+    if (accepted != frames) {
+        throw std::runtime_error(Utils::stringf("only %d of %d benchmark frames were accepted", accepted, frames));
+    }
+
+    reference.timestamp = MavLinkSigning::currentTimestamp();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        Frame& f = batch[i];
+        mavlink_sign_packet(&reference, f.signature(), f.header(), MAVLINK_CORE_HEADER_LEN + 1, f.payload(), 28, f.ck());
+    }
+    double referenceNanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+    printf("    sign %.0f ns, check %.0f ns per frame (mavlink_sign_packet %.0f ns)\n", signNanos, checkNanos, referenceNanos);
+}
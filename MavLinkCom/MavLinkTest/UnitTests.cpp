@@ -12,6 +12,8 @@
 #include "MavLinkVideoStream.hpp"
 #include "MavLinkTcpServer.hpp"
 #include "MavLinkFtpClient.hpp"
+#include "MavLinkMissionClient.hpp"
+#include "MavLinkRouter.hpp"
 #include "Semaphore.hpp"
 
 STRICT_MODE_OFF
@@ -19,6 +21,9 @@ STRICT_MODE_OFF
 STRICT_MODE_ON
 
 #include <iostream>
+#include <random>
+#include <mutex>
+#include <atomic>
 
 using namespace mavlink_utils;
 using namespace mavlinkcom;
@@ -39,6 +44,11 @@ void UnitTests::RunAll(std::string comPort, int boardRate)
 	RunTest("SerialPx4Test", [=] { SerialPx4Test(); });
 	RunTest("FtpTest", [=] { FtpTest(); });
     RunTest("JSonLogTest", [=] { JSonLogTest(); });
+    RunTest("MissionTest", [=] { MissionTest(); });
+    RunTest("VehicleStateTest", [=] { VehicleStateTest(); });
+    RunTest("RouterTest", [=] { RouterTest(); });
+    RunTest("FrameParserTest", [=] { FrameParserTest(); });
+    RunTest("SigningTest", [=] { SigningTest(); });
 }
 
 void UnitTests::RunTest(const std::string& name, TestHandler handler)
@@ -458,4 +468,698 @@ void UnitTests::JSonLogTest()
         printf("found %d valid rows in the json file, and %d HIGHRES_IMU records\n", found, imu);
     }
 
-}
\ No newline at end of file
+}
+// This class plays the vehicle side of the mission protocol on a local UDP connection, and it randomly
+// drops a percentage of the messages it receives and sends so the MavLinkMissionClient has to recover.
+class MissionTestPeer {
+public:
+    MissionTestPeer(std::shared_ptr<MavLinkConnection> con)
+        : con_(con), random_(42)
+    {
+        node_ = std::make_shared<MavLinkNode>(1, 1);
+        node_->connect(con);
+        subscription_ = con->subscribe([=](std::shared_ptr<MavLinkConnection> connection, const MavLinkMessage& msg) {
+            unused(connection);
+            handleMessage(msg);
+        });
+        running_ = true;
+        watchdog_ = std::thread([=] { runWatchdog(); });
+    }
+
+    ~MissionTestPeer() {
+        running_ = false;
+        watchdog_.join();
+        con_->unsubscribe(subscription_);
+        node_->close();
+    }
+
+    void setLossPercent(int lossPercent) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        loss_percent_ = lossPercent;
+    }
+
+    // answer any upload item other than the one we asked for with MAV_MISSION_INVALID_SEQUENCE and drop it, the
+    // way ArduPilot does.
+    void setStrictSequence(bool strict) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        strict_sequence_ = strict;
+    }
+
+    int getInvalidSequenceCount() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return invalid_sequence_count_;
+    }
+
+    void sendHeartbeat() {
+        MavLinkHeartbeat hb;
+        hb.type = static_cast<uint8_t>(MAV_TYPE::MAV_TYPE_QUADROTOR);
+        hb.autopilot = static_cast<uint8_t>(MAV_AUTOPILOT::MAV_AUTOPILOT_PX4);
+        node_->sendMessage(hb);
+    }
+
+    std::vector<MavLinkMissionItemInt> getMission() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return mission_;
+    }
+
+    int getCurrent() {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return current_;
+    }
+
+private:
+    bool drop() {
+        std::uniform_int_distribution<int> dist(0, 99);
+        return dist(random_) < loss_percent_;
+    }
+
+    void send(MavLinkMessageBase& msg) {
+        if (!drop()) {
+            node_->sendMessage(msg);
+        }
+    }
+
+    void sendAck(uint8_t type) {
+        MavLinkMissionAck ack;
+        ack.target_system = client_system_;
+        ack.target_component = client_component_;
+        ack.type = type;
+        send(ack);
+    }
+
+    void requestItem(int seq) {
+        MavLinkMissionRequestInt req;
+        req.target_system = client_system_;
+        req.target_component = client_component_;
+        req.seq = static_cast<uint16_t>(seq);
+        send(req);
+        last_request_ = std::chrono::steady_clock::now();
+    }
+
+    void handleMessage(const MavLinkMessage& msg) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (drop()) {
+            return;
+        }
+        client_system_ = msg.sysid;
+        client_component_ = msg.compid;
+
+        switch (msg.msgid) {
+        case MavLinkMissionCount::kMessageId: {
+            MavLinkMissionCount count;
+            count.decode(msg);
+            if (uploading_) {
+                // the client did not get our request, so ask again.
+                requestItem(expected_);
+                break;
+            }
+            mission_.resize(count.count);
+            received_.assign(count.count, false);
+            expected_ = 0;
+            if (count.count == 0) {
+                sendAck(static_cast<uint8_t>(MAV_MISSION_RESULT::MAV_MISSION_ACCEPTED));
+            }
+            else {
+                uploading_ = true;
+                requestItem(0);
+            }
+            break;
+        }
+        case MavLinkMissionItemInt::kMessageId: {
+            MavLinkMissionItemInt item;
+            item.decode(msg);
+            int count = static_cast<int>(mission_.size());
+            if (uploading_ && strict_sequence_ && item.seq != expected_) {
+                invalid_sequence_count_++;
+                sendAck(static_cast<uint8_t>(MAV_MISSION_RESULT::MAV_MISSION_INVALID_SEQUENCE));
+            }
+            else if (uploading_ && item.seq >= expected_ && item.seq < count) {
+                // keep items that arrive ahead of our request so the client's window is not wasted.
+                mission_[item.seq] = item;
+                received_[item.seq] = true;
+                int next = expected_;
+                while (next < count && received_[next]) {
+                    next++;
+                }
+                if (next == count) {
+                    expected_ = next;
+                    uploading_ = false;
+                    sendAck(static_cast<uint8_t>(MAV_MISSION_RESULT::MAV_MISSION_ACCEPTED));
+                }
+                else if (next != expected_) {
+                    expected_ = next;
+                    requestItem(expected_);
+                }
+            }
+            else if (!uploading_ && count > 0 && item.seq == count - 1) {
+                // our ack must have been lost.
+                sendAck(static_cast<uint8_t>(MAV_MISSION_RESULT::MAV_MISSION_ACCEPTED));
+            }
+            break;
+        }
+        case MavLinkMissionRequestList::kMessageId: {
+            MavLinkMissionCount count;
+            count.target_system = client_system_;
+            count.target_component = client_component_;
+            count.count = static_cast<uint16_t>(mission_.size());
+            send(count);
+            break;
+        }
+        case MavLinkMissionRequestInt::kMessageId: {
+            MavLinkMissionRequestInt req;
+            req.decode(msg);
+            if (req.seq < mission_.size()) {
+                MavLinkMissionItemInt item = mission_[req.seq];
+                item.target_system = client_system_;
+                item.target_component = client_component_;
+                send(item);
+            }
+            break;
+        }
+        case MavLinkMissionClearAll::kMessageId: {
+            mission_.clear();
+            received_.clear();
+            uploading_ = false;
+            sendAck(static_cast<uint8_t>(MAV_MISSION_RESULT::MAV_MISSION_ACCEPTED));
+            break;
+        }
+        case MavLinkMissionSetCurrent::kMessageId: {
+            MavLinkMissionSetCurrent set;
+            set.decode(msg);
+            current_ = set.seq;
+            MavLinkMissionCurrent current;
+            current.seq = set.seq;
+            send(current);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    void runWatchdog() {
+        while (running_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            std::lock_guard<std::mutex> guard(mutex_);
+            if (uploading_ && std::chrono::steady_clock::now() - last_request_ > std::chrono::milliseconds(50)) {
+                requestItem(expected_);
+            }
+        }
+    }
+
+    std::shared_ptr<MavLinkConnection> con_;
+    std::shared_ptr<MavLinkNode> node_;
+    int subscription_ = 0;
+    int loss_percent_ = 0;
+    bool strict_sequence_ = false;
+    int invalid_sequence_count_ = 0;
+    std::mt19937 random_;
+    std::mutex mutex_;
+    std::vector<MavLinkMissionItemInt> mission_;
+    std::vector<bool> received_;
+    int client_system_ = 0;
+    int client_component_ = 0;
+    bool uploading_ = false;
+    int expected_ = 0;
+    int current_ = 0;
+    std::chrono::steady_clock::time_point last_request_;
+    std::thread watchdog_;
+    bool running_ = false;
+};
+
+static std::vector<MavLinkMissionItemInt> createTestMission(int count)
+{
+    std::vector<MavLinkMissionItemInt> items;
+    for (int i = 0; i < count; i++) {
+        MavLinkMissionItemInt item;
+        item.command = static_cast<uint16_t>(MAV_CMD::MAV_CMD_NAV_WAYPOINT);
+        item.frame = static_cast<uint8_t>(MAV_FRAME::MAV_FRAME_GLOBAL_RELATIVE_ALT_INT);
+        item.x = 476414000 + i * 100;
+        item.y = -1221400000 - i * 100;
+        item.z = 10.0f + i;
+        item.autocontinue = 1;
+        items.push_back(item);
+    }
+    return items;
+}
+
+static void verifyMission(const std::vector<MavLinkMissionItemInt>& expected, const std::vector<MavLinkMissionItemInt>& actual)
+{
+    if (expected.size() != actual.size()) {
+        throw std::runtime_error(Utils::stringf("mission has %d items, but expected %d", static_cast<int>(actual.size()), static_cast<int>(expected.size())));
+    }
+    for (size_t i = 0; i < expected.size(); i++) {
+        const MavLinkMissionItemInt& a = expected[i];
+        const MavLinkMissionItemInt& b = actual[i];
+        if (b.seq != i || a.x != b.x || a.y != b.y || a.z != b.z || a.command != b.command || a.frame != b.frame) {
+            throw std::runtime_error(Utils::stringf("mission item %d does not match", static_cast<int>(i)));
+        }
+    }
+}
+
+void UnitTests::MissionTest()
+{
+    const int testPort = 14592;
+    const int lossPercent = 20;
+
+    auto vehicleConnection = MavLinkConnection::connectLocalUdp("vehicle", "127.0.0.1", testPort);
+    auto gcsConnection = MavLinkConnection::connectRemoteUdp("gcs", "127.0.0.1", "127.0.0.1", testPort);
+
+    MavLinkMissionClient client{ 166, 1 };
+    client.connect(gcsConnection);
+    client.setTimeout(250, 20);
+
+    MissionTestPeer peer(vehicleConnection);
+
+    // the vehicle needs to hear from us before it knows where to send replies, and we need a message from the
+    // vehicle before we know its system id.
+    Semaphore received;
+    int id = gcsConnection->subscribe([&](std::shared_ptr<MavLinkConnection> connection, const MavLinkMessage& msg) {
+        unused(connection);
+        unused(msg);
+        received.post();
+    });
+    MavLinkHeartbeat hb;
+    hb.type = static_cast<uint8_t>(MAV_TYPE::MAV_TYPE_GCS);
+    client.sendMessage(hb);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    peer.sendHeartbeat();
+    if (!received.timed_wait(2000)) {
+        throw std::runtime_error("heartbeat not received from vehicle connection");
+    }
+    gcsConnection->unsubscribe(id);
+
+    auto mission = createTestMission(200);
+    {
+        peer.setLossPercent(lossPercent);
+
+        bool ok = false;
+        auto start = std::chrono::steady_clock::now();
+        if (!client.uploadMission(mission).wait(30000, &ok) || !ok) {
+            MavLinkMissionProgress progress = client.getProgress();
+            throw std::runtime_error(Utils::stringf("mission upload failed: %s", progress.message.c_str()));
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        MavLinkMissionProgress progress = client.getProgress();
+        printf("    uploaded %d items with %d%% loss in %d ms, %d retransmits, %d timeouts\n", progress.goal, lossPercent,
+            static_cast<int>(elapsed.count()), progress.retransmits, progress.timeouts);
+        verifyMission(mission, peer.getMission());
+
+        std::vector<MavLinkMissionItemInt> downloaded;
+        start = std::chrono::steady_clock::now();
+        if (!client.downloadMission().wait(30000, &downloaded) || client.getProgress().error != 0) {
+            throw std::runtime_error(Utils::stringf("mission download failed: %s", client.getProgress().message.c_str()));
+        }
+        elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        progress = client.getProgress();
+        printf("    downloaded %d items with %d%% loss in %d ms, %d retransmits, %d timeouts\n", progress.goal, lossPercent,
+            static_cast<int>(elapsed.count()), progress.retransmits, progress.timeouts);
+        verifyMission(mission, downloaded);
+
+        if (!client.setCurrentMissionItem(42).wait(10000, &ok) || !ok || peer.getCurrent() != 42) {
+            throw std::runtime_error("set current mission item failed");
+        }
+
+        if (!client.clearMission().wait(10000, &ok) || !ok || peer.getMission().size() != 0) {
+            throw std::runtime_error("mission clear failed");
+        }
+
+        if (!client.downloadMission().wait(10000, &downloaded) || client.getProgress().error != 0 || downloaded.size() != 0) {
+            throw std::runtime_error("empty mission download failed");
+        }
+    }
+
+    // compare the pipelined transfer with the classic one item per round trip protocol on a clean link.
+    {
+        peer.setLossPercent(0);
+        for (int window = 1; window <= 16; window *= 4) {
+            client.setWindowSize(window);
+            bool ok = false;
+            auto start = std::chrono::steady_clock::now();
+            if (!client.uploadMission(mission).wait(30000, &ok) || !ok) {
+                throw std::runtime_error(Utils::stringf("mission upload with window %d failed", window));
+            }
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+            printf("    window %d: uploaded %d items in %d us\n", window, static_cast<int>(mission.size()), static_cast<int>(elapsed.count()));
+            verifyMission(mission, peer.getMission());
+        }
+    }
+
+    // an autopilot that rejects items sent ahead of its request must not fail the upload.
+    {
+        peer.setLossPercent(lossPercent);
+        peer.setStrictSequence(true);
+        client.setWindowSize(8);
+        bool ok = false;
+        if (!client.uploadMission(mission).wait(30000, &ok) || !ok) {
+            MavLinkMissionProgress progress = client.getProgress();
+            throw std::runtime_error(Utils::stringf("mission upload to a strict sequence peer failed: %s", progress.message.c_str()));
+        }
+        if (peer.getInvalidSequenceCount() == 0) {
+            throw std::runtime_error("strict sequence peer never rejected an item");
+        }
+        printf("    uploaded %d items to a strict sequence peer, %d items rejected as out of sequence\n",
+            static_cast<int>(mission.size()), peer.getInvalidSequenceCount());
+        verifyMission(mission, peer.getMission());
+        peer.setStrictSequence(false);
+    }
+
+    client.close();
+}
+
+void UnitTests::VehicleStateTest()
+{
+    const int testPort = 14593;
+    const int messageCount = 20000;
+    const int readerCount = 4;
+
+    // the simulated vehicle sends LOCAL_POSITION_NED and ATTITUDE messages where every field has the same value,
+    // so a reader that sees a mix of values caught the state half way through an update.
+    auto vehicleConnection = MavLinkConnection::connectRemoteUdp("sim", "127.0.0.1", "127.0.0.1", testPort);
+    auto gcsConnection = MavLinkConnection::connectLocalUdp("gcs", "127.0.0.1", testPort);
+
+    MavLinkVehicle vehicle{ 166, 1 };
+    vehicle.connect(gcsConnection);
+
+    std::atomic<int> notifications{ 0 };
+    std::atomic<int> homeNotifications{ 0 };
+    std::atomic<int> tornNotifications{ 0 };
+    std::atomic<int> lastNotifiedTime{ 0 };
+    int notifyId = vehicle.subscribeToStateChanges(VehicleStateLocalEstimate, [&](const VehicleState& state, int changedGroups) {
+        if ((changedGroups & VehicleStateLocalEstimate) == 0) {
+            tornNotifications++;
+        }
+        const VehicleState::LocalState& est = state.local_est;
+        if (est.pos.x != est.pos.y || est.pos.x != est.lin_vel.z || est.updated_on != static_cast<uint64_t>(est.pos.x)) {
+            tornNotifications++;
+        }
+        notifications++;
+        lastNotifiedTime = static_cast<int>(est.updated_on);
+    });
+    int homeId = vehicle.subscribeToStateChanges(VehicleStateHome, [&](const VehicleState& state, int changedGroups) {
+        unused(state);
+        unused(changedGroups);
+        homeNotifications++;
+    });
+
+    std::atomic<bool> done{ false };
+    std::atomic<long long> reads{ 0 };
+    std::atomic<int> tornReads{ 0 };
+    std::atomic<int> versionErrors{ 0 };
+    std::vector<std::thread> readers;
+    for (int i = 0; i < readerCount; i++) {
+        readers.push_back(std::thread([&]() {
+            int lastVersion = 0;
+            int lastLocalVersion = 0;
+            VehicleState state;
+            long long count = 0;
+            while (!done) {
+                int version = lastVersion;
+                if (!vehicle.getVehicleStateIfNewer(version, state)) {
+                    state = vehicle.getVehicleState();
+                }
+                else if (version < lastVersion) {
+                    versionErrors++;
+                }
+                lastVersion = version;
+                const VehicleState::LocalState& est = state.local_est;
+                if (est.pos.x != est.pos.y || est.pos.x != est.pos.z || est.pos.x != est.lin_vel.x ||
+                    est.pos.x != est.lin_vel.y || est.pos.x != est.lin_vel.z || est.updated_on != static_cast<uint64_t>(est.pos.x)) {
+                    tornReads++;
+                }
+                const VehicleState::AttitudeState& att = state.attitude;
+                if (att.roll != att.pitch || att.roll != att.yaw || att.roll != att.yaw_rate) {
+                    tornReads++;
+                }
+                int localVersion = vehicle.getVehicleStateVersion(VehicleStateLocalEstimate);
+                if (localVersion < lastLocalVersion) {
+                    versionErrors++;
+                }
+                lastLocalVersion = localVersion;
+                count++;
+            }
+            reads += count;
+        }));
+    }
+
+    MavLinkNode sim(1, 1);
+    sim.connect(vehicleConnection);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 1; i <= messageCount; i++) {
+        float value = static_cast<float>(i);
+        MavLinkLocalPositionNed pos;
+        pos.x = pos.y = pos.z = pos.vx = pos.vy = pos.vz = value;
+        pos.time_boot_ms = i;
+        sim.sendMessage(pos);
+        if (i % 4 == 0) {
+            MavLinkAttitude att;
+            att.roll = att.pitch = att.yaw = att.rollspeed = att.pitchspeed = att.yawspeed = value;
+            att.time_boot_ms = i;
+            sim.sendMessage(att);
+        }
+        if (i % 100 == 0) {
+            // don't overflow the UDP receive buffer.
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    done = true;
+    for (auto& t : readers) {
+        t.join();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    vehicle.unsubscribeFromStateChanges(notifyId);
+    vehicle.unsubscribeFromStateChanges(homeId);
+
+    printf("    %d readers made %lld consistent reads in %d ms (%.0f per second) while receiving %d notifications\n",
+        readerCount, static_cast<long long>(reads), static_cast<int>(elapsed.count()),
+        static_cast<double>(reads) * 1000 / (static_cast<double>(elapsed.count()) + 1), static_cast<int>(notifications));
+
+    if (tornReads != 0 || tornNotifications != 0) {
+        throw std::runtime_error(Utils::stringf("found %d torn reads and %d torn notifications", static_cast<int>(tornReads), static_cast<int>(tornNotifications)));
+    }
+    if (versionErrors != 0) {
+        throw std::runtime_error(Utils::stringf("vehicle state version went backwards %d times", static_cast<int>(versionErrors)));
+    }
+    if (notifications == 0 || homeNotifications != 0) {
+        throw std::runtime_error("state change notifications were not filtered by group");
+    }
+    if (vehicle.getVehicleStateVersion(VehicleStateHome) != 0 || vehicle.getVehicleStateVersion(VehicleStateLocalEstimate) != notifications) {
+        throw std::runtime_error("vehicle state group versions do not match the notifications");
+    }
+    VehicleState state = vehicle.getVehicleState();
+    if (lastNotifiedTime != static_cast<int>(state.local_est.updated_on)) {
+        throw std::runtime_error("last notification does not match the final vehicle state");
+    }
+
+    // single threaded read throughput with no traffic, this is the cost of one consistent copy.
+    start = std::chrono::steady_clock::now();
+    const int benchmarkReads = 1000000;
+    float sum = 0;
+    for (int i = 0; i < benchmarkReads; i++) {
+        sum += vehicle.getVehicleState().local_est.pos.x;
+    }
+    auto benchmarkElapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    printf("    getVehicleState: %.1f ns per call (checksum %f)\n", static_cast<double>(benchmarkElapsed.count()) * 1000 / benchmarkReads, sum);
+
+    sim.close();
+    vehicle.close();
+}
+
+void UnitTests::RouterTest()
+{
+    const int radioPort = 14594;
+    const int qgcPort = 14595;
+    const int vehicleCount = 8;
+    const int messageCount = 2000; // per vehicle
+
+    // a swarm of simulated vehicles shares one "radio" link to the ground station, which forwards everything to a
+    // second link where QGroundControl would be listening.
+    auto radio = MavLinkConnection::connectLocalUdp("radio", "127.0.0.1", radioPort);
+    auto swarm = MavLinkConnection::connectRemoteUdp("swarm", "127.0.0.1", "127.0.0.1", radioPort);
+    auto qgcLink = MavLinkConnection::connectLocalUdp("qgclink", "127.0.0.1", qgcPort);
+    auto qgc = MavLinkConnection::connectRemoteUdp("qgc", "127.0.0.1", "127.0.0.1", qgcPort);
+
+    auto router = std::make_shared<MavLinkRouter>();
+    router->addLink(radio);
+    router->addLink(qgcLink);
+
+    std::atomic<int> qgcReceived{ 0 };
+    int qgcId = qgc->subscribe([&](std::shared_ptr<MavLinkConnection> connection, const MavLinkMessage& msg) {
+        unused(connection);
+        if (msg.msgid == MavLinkLocalPositionNed::kMessageId) {
+            qgcReceived++;
+        }
+    });
+    std::atomic<int> commandsForSystem3{ 0 };
+    std::atomic<int> commandsForOthers{ 0 };
+    // the command as the router received it and as the vehicle got it, forwarding must not change the frame.
+    std::atomic<int> sentCommandFrame{ -1 };
+    std::atomic<int> forwardedCommandFrame{ -1 };
+    auto frameId = [](const MavLinkMessage& msg) {
+        return (msg.seq << 16) | msg.checksum;
+    };
+    int qgcLinkId = qgcLink->subscribe([&](std::shared_ptr<MavLinkConnection> connection, const MavLinkMessage& msg) {
+        unused(connection);
+        if (msg.msgid == MavLinkCommandLong::kMessageId) {
+            MavLinkCommandLong cmd;
+            cmd.decode(msg);
+            if (cmd.target_system == 3) {
+                sentCommandFrame = frameId(msg);
+            }
+        }
+    });
+    int swarmId = swarm->subscribe([&](std::shared_ptr<MavLinkConnection> connection, const MavLinkMessage& msg) {
+        unused(connection);
+        if (msg.msgid == MavLinkCommandLong::kMessageId) {
+            MavLinkCommandLong cmd;
+            cmd.decode(msg);
+            if (cmd.target_system == 3) {
+                forwardedCommandFrame = frameId(msg);
+                commandsForSystem3++;
+            }
+            else {
+                commandsForOthers++;
+            }
+        }
+    });
+
+    // the local udp links learn where to send replies from the first packet they get.
+    std::vector<std::shared_ptr<MavLinkNode>> sims;
+    for (int i = 0; i < vehicleCount; i++) {
+        auto sim = std::make_shared<MavLinkNode>(i + 1, 1);
+        sim->connect(swarm);
+        MavLinkHeartbeat hb;
+        hb.type = static_cast<uint8_t>(MAV_TYPE::MAV_TYPE_QUADROTOR);
+        sim->sendMessage(hb);
+        sims.push_back(sim);
+    }
+    MavLinkHeartbeat hb;
+    hb.type = static_cast<uint8_t>(MAV_TYPE::MAV_TYPE_GCS);
+    MavLinkMessage qgcHeartbeat;
+    hb.encode(qgcHeartbeat);
+    qgcHeartbeat.sysid = 255;
+    qgcHeartbeat.compid = 190;
+    qgc->sendMessage(qgcHeartbeat);
+
+    for (int retries = 0; retries < 100 && router->getSystems().size() < static_cast<size_t>(vehicleCount + 1); retries++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (router->getSystems().size() != static_cast<size_t>(vehicleCount + 1)) {
+        throw std::runtime_error(Utils::stringf("router found %d systems, expecting %d", static_cast<int>(router->getSystems().size()), vehicleCount + 1));
+    }
+    if (router->getLink(3) != radio || router->getLink(255) != qgcLink || router->getLink(42) != nullptr) {
+        throw std::runtime_error("router learned the wrong links");
+    }
+
+    // one vehicle node per system on the shared radio link.
+    std::vector<std::shared_ptr<MavLinkVehicle>> vehicles;
+    for (int i = 0; i < vehicleCount; i++) {
+        auto vehicle = std::make_shared<MavLinkVehicle>(166, 1);
+        vehicle->connect(router, i + 1, 1);
+        vehicles.push_back(vehicle);
+    }
+    router->getStats();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < messageCount; n++) {
+        for (int i = 0; i < vehicleCount; i++) {
+            MavLinkLocalPositionNed pos;
+            pos.x = static_cast<float>(i + 1);
+            pos.y = static_cast<float>(n);
+            pos.time_boot_ms = n;
+            sims[i]->sendMessage(pos);
+        }
+        if (n % 20 == 0) {
+            // don't overflow the UDP receive buffers.
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    int expected = vehicleCount * messageCount;
+    for (int retries = 0; retries < 200 && qgcReceived < expected; retries++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    MavLinkRouterStats stats = router->getStats();
+    printf("    routed %ld messages from %d vehicles in %d ms (%d per second), forwarded %d to qgc\n", stats.messagesReceived,
+        vehicleCount, static_cast<int>(elapsed.count()), static_cast<int>(stats.messagesReceived * 1000 / (elapsed.count() + 1)),
+        static_cast<int>(qgcReceived));
+
+    // UDP on loopback can still drop the odd packet under load, but most of them should make it.
+    if (qgcReceived < expected * 3 / 4) {
+        throw std::runtime_error(Utils::stringf("qgc only received %d of %d forwarded messages", static_cast<int>(qgcReceived), expected));
+    }
+    for (int i = 0; i < vehicleCount; i++) {
+        VehicleState state = vehicles[i]->getVehicleState();
+        if (state.local_est.pos.x != static_cast<float>(i + 1)) {
+            throw std::runtime_error(Utils::stringf("vehicle %d saw position messages from system %d", i + 1, static_cast<int>(state.local_est.pos.x)));
+        }
+        if (state.local_est.pos.y < messageCount * 3 / 4) {
+            throw std::runtime_error(Utils::stringf("vehicle %d only got to position %d", i + 1, static_cast<int>(state.local_est.pos.y)));
+        }
+    }
+
+    // targeted messages only go to the link where the target lives, and are dropped if the target is unknown.
+    // qgc's sequence numbers are moved away from the radio's, so a re-packed command would not match.
+    for (int i = 0; i < 100; i++) {
+        qgc->getNextSequence();
+    }
+    MavLinkCommandLong cmd;
+    cmd.command = static_cast<uint16_t>(MAV_CMD::MAV_CMD_REQUEST_AUTOPILOT_CAPABILITIES);
+    cmd.target_system = 3;
+    cmd.target_component = 1;
+    MavLinkMessage targeted;
+    cmd.encode(targeted);
+    targeted.sysid = 255;
+    targeted.compid = 190;
+    qgc->sendMessage(targeted);
+    cmd.target_system = 42;
+    cmd.encode(targeted);
+    targeted.sysid = 255;
+    targeted.compid = 190;
+    qgc->sendMessage(targeted);
+    for (int retries = 0; retries < 100 && commandsForSystem3 == 0; retries++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    stats = router->getStats();
+    if (commandsForSystem3 != 1 || commandsForOthers != 0 || stats.messagesDropped != 1) {
+        throw std::runtime_error(Utils::stringf("targeted routing failed, %d commands for system 3, %d for others, %d dropped",
+            static_cast<int>(commandsForSystem3), static_cast<int>(commandsForOthers), static_cast<int>(stats.messagesDropped)));
+    }
+    if (forwardedCommandFrame != sentCommandFrame) {
+        throw std::runtime_error("router re-packed the forwarded command instead of passing on the original frame");
+    }
+
+    // a system heard on another link (e.g. a backup radio) is sent to there from then on.
+    MavLinkHeartbeat moved;
+    moved.type = static_cast<uint8_t>(MAV_TYPE::MAV_TYPE_QUADROTOR);
+    MavLinkMessage movedHeartbeat;
+    moved.encode(movedHeartbeat);
+    movedHeartbeat.sysid = 3;
+    movedHeartbeat.compid = 1;
+    qgc->sendMessage(movedHeartbeat);
+    for (int retries = 0; retries < 100 && router->getLink(3) != qgcLink; retries++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (vehicles[2]->getConnection() != qgcLink) {
+        throw std::runtime_error("vehicle node did not follow its system to the link it was last heard on");
+    }
+
+    // a vehicle node closed through the router must not close the shared link.
+    vehicles[0]->close();
+    if (!radio->isOpen()) {
+        throw std::runtime_error("closing a routed node closed the shared link");
+    }
+
+    qgc->unsubscribe(qgcId);
+    qgcLink->unsubscribe(qgcLinkId);
+    swarm->unsubscribe(swarmId);
+    vehicles.clear();
+    router->close();
+    radio->close();
+    swarm->close();
+    qgcLink->close();
+    qgc->close();
+}
@@ -19,6 +19,11 @@ public:
 	void SendImageTest();
 	void FtpTest();
     void JSonLogTest();
+    void MissionTest();
+    void VehicleStateTest();
+    void RouterTest();
+    void FrameParserTest();
+    void SigningTest();
 private:
 	void RunTest(const std::string& name, TestHandler handler);
     void VerifyFile(mavlinkcom::MavLinkFtpClient& ftp, const std::string& dir, const std::string& name, bool exists, bool isdir);
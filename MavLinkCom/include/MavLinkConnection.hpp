@@ -37,6 +37,9 @@ namespace mavlinkcom {
     // This callback is invoked when a new TCP connection is accepted via acceptTcp().
     typedef std::function<void(std::shared_ptr<MavLinkConnection> port)> MavLinkConnectionHandler;
 
+    // This callback decides which unsigned messages are still accepted on a signed connection.
+    typedef std::function<bool(int msgid)> AcceptUnsignedHandler;
+
     struct SerialPortInfo {
         std::wstring displayName;
         std::wstring portName;
@@ -113,6 +116,10 @@ namespace mavlinkcom {
         // Send the given already encoded message, assuming the compid and sysid have been set by the caller.
         void sendMessage(const MavLinkMessage& msg);
 
+        // Send a message received on another connection exactly as it arrived, with its original sequence number,
+        // flags, checksum and signature.  This is how a router passes on traffic it does not originate.
+        void forwardMessage(const MavLinkMessage& msg);
+
         // get the next telemetry snapshot, then clear the internal counters and start over.  This way each snapshot
         // gives you a picture of what happened in whatever timeslice you decide to call this method.  This is packaged
         // in a mavlink message so you can easily send it to the LogViewer.
@@ -127,6 +134,21 @@ namespace mavlinkcom {
         // message signing according to the target node we are communicating with, and return the message length.
         int prepareForSending(MavLinkMessage& msg);
 
+        // Turn on MAVLink2 message signing with the given 32 byte secret key.  Every message we send is signed, and messages
+        // we receive are dropped (and counted in crcErrors) unless they are signed with the same key and carry a timestamp
+        // we have not seen before from that system, component and link id.  The linkId goes into our signatures, so give each
+        // link to the same vehicle its own id.  To make sure old messages can't be replayed after a restart, pass the last
+        // getSigningTimestamp you saved, otherwise we start from the current time.
+        void enableSigning(const std::vector<uint8_t>& secretKey, uint8_t linkId, uint64_t timestamp = 0);
+        void disableSigning();
+        bool isSigning();
+
+        // Accept some unsigned messages while signing is on, for example RADIO_STATUS from a telemetry radio that can't sign.
+        void setAcceptUnsignedHandler(AcceptUnsignedHandler handler);
+
+        // The timestamp that goes in the next signature, in 10 microsecond ticks since 1 January 2015 GMT.
+        uint64_t getSigningTimestamp();
+
     protected:
         void startListening(const std::string& nodeName, std::shared_ptr<Port> connectedPort);
 
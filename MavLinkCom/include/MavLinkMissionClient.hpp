@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef MavLinkCom_MavLinkMissionClient_hpp
+#define MavLinkCom_MavLinkMissionClient_hpp
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "MavLinkNode.hpp"
+
+namespace mavlinkcom_impl {
+    class MavLinkMissionClientImpl;
+}
+
+namespace mavlinkcom {
+
+    struct MavLinkMissionProgress {
+    public:
+        bool complete = false;
+        int error = 0; // MAV_MISSION_RESULT from the remote node, or kErrorTimeout/kErrorCancelled.
+        std::string message;
+        int current = 0; // number of mission items transferred so far.
+        int goal = 0; // number of mission items in the transfer.
+        int retransmits = 0; // number of items (or requests) that had to be sent again.
+        int timeouts = 0; // number of times the watchdog had to kick the transfer.
+
+        static const int kErrorTimeout = -1;
+        static const int kErrorCancelled = -2;
+    };
+
+    // This class implements the client (ground station) side of the MAVLink mission protocol, so you can
+    // upload, download and clear whole missions and pick the current mission item.  Uploads are pipelined,
+    // meaning we send a window of items ahead of the MISSION_REQUEST_INT messages coming from the vehicle,
+    // and only resend an item when the vehicle asks for it again.  Downloads keep a window of
+    // MISSION_REQUEST_INT messages outstanding and only re-request the items that never arrived.
+    // Only one mission transfer can be in progress at a time, starting a new one cancels the previous one.
+    class MavLinkMissionClient : public MavLinkNode
+    {
+    public:
+        MavLinkMissionClient(int localSystemId, int localComponentId);
+        ~MavLinkMissionClient();
+
+        // Set how many items are sent (or requested) ahead of the remote node, default is 8.
+        // A window size of 1 gives you the classic one item per round trip protocol.  An upload drops to one item per
+        // request when the remote node rejects items it did not ask for with MAV_MISSION_INVALID_SEQUENCE, like ArduPilot.
+        void setWindowSize(int items);
+
+        // Set how long to wait for the remote node before retransmitting, and how many times to do that before
+        // giving up on the transfer.
+        void setTimeout(int milliseconds, int maxRetries);
+
+        // Replace the mission on the remote node with the given items.  The seq and target fields are filled in
+        // for you.  The result is true if the remote node accepted the whole mission.
+        AsyncResult<bool> uploadMission(const std::vector<MavLinkMissionItemInt>& items);
+
+        // Read the mission from the remote node.  The result is empty if the download failed, see getProgress
+        // for the error.
+        AsyncResult<std::vector<MavLinkMissionItemInt>> downloadMission();
+
+        // Delete all mission items on the remote node.
+        AsyncResult<bool> clearMission();
+
+        // Tell the remote node to fly to the given mission item next, the result is true once MISSION_CURRENT
+        // reports the new item.
+        AsyncResult<bool> setCurrentMissionItem(int seq);
+
+        // Get a snapshot of the progress of the current (or last) transfer.
+        MavLinkMissionProgress getProgress();
+
+        // cancel any pending transfer.
+        void cancel();
+    };
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include <vector>
 #include "AsyncResult.hpp"
 #include "MavLinkConnection.hpp"
+#include "MavLinkRouter.hpp"
 #include "MavLinkMessages.hpp"
 
 namespace mavlinkcom_impl {
@@ -40,7 +41,12 @@ namespace mavlinkcom {
         // start listening to this connection
         void connect(std::shared_ptr<MavLinkConnection> connection);
 
-        // stop listening to the connection.
+        // start listening to the given remote system through the router, this node will only see messages from
+        // that system and will send on the link the system was last heard on, so you can have one node per vehicle
+        // on a shared link.  The router must have already heard from the system.
+        void connect(std::shared_ptr<MavLinkRouter> router, int targetSystemId, int targetComponentId);
+
+        // stop listening to the connection.  A connection that came from a router is left open.
         void close();
 
         // Send heartbeat to drone.  You should not do this if some other node is
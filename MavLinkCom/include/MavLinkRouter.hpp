@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef MavLinkCom_MavLinkRouter_hpp
+#define MavLinkCom_MavLinkRouter_hpp
+
+#include <string>
+#include <memory>
+#include <vector>
+#include "MavLinkConnection.hpp"
+
+namespace mavlinkcom_impl {
+    class MavLinkRouterImpl;
+}
+
+namespace mavlinkcom {
+
+    struct MavLinkRouterStats {
+        long messagesReceived = 0; // messages read from all links.
+        long messagesDispatched = 0; // calls made to subscribers.
+        long messagesForwarded = 0; // copies sent out on other links.
+        long messagesDropped = 0; // targeted messages for a system we have never heard from.
+    };
+
+    // This class routes MavLink messages between a number of links, where each link can have any number of
+    // systems behind it, for example a swarm sharing one radio, or a SITL multiplexer.  It follows the MAVLink
+    // routing rules: the router learns which link each system/component lives on from the messages it receives,
+    // broadcast messages are forwarded to every other link, and targeted messages are only forwarded to the link
+    // where the target was seen.  Messages are never sent back on the link they came from.
+    // Each message is parsed once by the link it arrived on, and the router hands the same message to the
+    // subscribers for the source system, so you can have one MavLinkNode per vehicle on a shared link, see
+    // MavLinkNode::connect(router, systemId, componentId).
+    class MavLinkRouter
+    {
+    public:
+        MavLinkRouter();
+        ~MavLinkRouter();
+
+        // Start routing messages to and from this link.
+        void addLink(std::shared_ptr<MavLinkConnection> link);
+
+        // Stop routing messages to and from this link and forget the systems that were seen on it.
+        void removeLink(std::shared_ptr<MavLinkConnection> link);
+
+        // Get a callback for every message from the given system, or from all systems if systemId is 0.
+        int subscribe(int systemId, MessageHandler handler);
+        void unsubscribe(int id);
+
+        // Get the link the given system was last heard on, or nullptr if we have not heard from it yet.
+        std::shared_ptr<MavLinkConnection> getLink(int systemId);
+
+        // Get the ids of all the systems we have heard from so far.
+        std::vector<int> getSystems();
+
+        // Send a message from a local node (with sysid and compid already set) using the same routing rules.
+        void sendMessage(const MavLinkMessageBase& msg);
+        void sendMessage(const MavLinkMessage& msg);
+
+        // get the counters since the last call to getStats, then clear them.
+        MavLinkRouterStats getStats();
+
+        // Stop routing, the links are not closed.
+        void close();
+
+    private:
+        std::shared_ptr<mavlinkcom_impl::MavLinkRouterImpl> impl_;
+    };
+}
+
+#endif
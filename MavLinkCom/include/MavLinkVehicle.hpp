@@ -10,6 +10,7 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <functional>
 
 namespace mavlinkcom_impl {
     class MavLinkVehicleImpl;
@@ -17,6 +18,9 @@ namespace mavlinkcom_impl {
 
 namespace mavlinkcom {
 
+    // changedGroups is the set of VehicleStateGroup flags that changed since the last notification.
+    typedef std::function<void(const VehicleState& state, int changedGroups)> VehicleStateHandler;
+
     // This class represents a MavLinkNode that can be controlled, hence a "vehicle" of some sort.
     // It also keeps certain state about the vehicle position so you can query it any time.
     // All x,y,z coordinates are in the NED coordinate system.
@@ -66,8 +70,21 @@ namespace mavlinkcom {
         void moveByAttitude(float roll, float pitch, float yaw, float rollRate, float pitchRate, float yawRate, float thrust);
          
         uint32_t getTimeStamp();
+
+        // The vehicle state is published as a consistent snapshot every time a message updates it, so these
+        // never return a half updated state and never block the thread that is processing incoming messages.
         int getVehicleStateVersion();
-        const VehicleState& getVehicleState();
+        int getVehicleStateVersion(VehicleStateGroup group);
+        VehicleState getVehicleState();
+
+        // Copy the current vehicle state only if it is newer than the given version, in which case the version is
+        // updated to match the returned state.
+        bool getVehicleStateIfNewer(int& version, VehicleState& state);
+
+        // Get a callback whenever any of the given VehicleStateGroup flags change, the callback is made on the
+        // thread that processes incoming messages so it should not block.
+        int subscribeToStateChanges(int groups, VehicleStateHandler handler);
+        void unsubscribeFromStateChanges(int id);
 
     public:
         //needed for piml pattern
@@ -8,6 +8,25 @@
 #include <string>
 
 namespace mavlinkcom {
+
+    // The VehicleState fields are grouped by the messages that update them, each group has its own version
+    // number and these flags can be combined to subscribe to changes in more than one group.
+    enum VehicleStateGroup {
+        VehicleStateAttitude = 1 << 0,
+        VehicleStateGlobalEstimate = 1 << 1,
+        VehicleStateRc = 1 << 2,
+        VehicleStateServo = 1 << 3,
+        VehicleStateControls = 1 << 4,
+        VehicleStateLocalEstimate = 1 << 5,
+        VehicleStateMocap = 1 << 6,
+        VehicleStateAltitude = 1 << 7,
+        VehicleStateVfrHud = 1 << 8,
+        VehicleStateHome = 1 << 9,
+        VehicleStateMode = 1 << 10,
+        VehicleStateAll = (1 << 11) - 1
+    };
+    const int VehicleStateGroupCount = 11;
+
     typedef struct _VehicleState {
         typedef unsigned long long uint64_t;
         typedef unsigned char uint8_t;
@@ -62,7 +81,7 @@ namespace mavlinkcom {
             Vector3 pos; // in NEU (north, east, up) coordinates (positive Z goes upwards).
             Vector3 lin_vel;
             Vector3 acc;
-            uint64_t updated_on;
+            uint64_t updated_on = 0;
         } local_est;
 
         struct MocapState {
@@ -68,6 +68,31 @@ int MavLinkConnection::prepareForSending(MavLinkMessage& msg)
     return pImpl->prepareForSending(msg);
 }
 
+void MavLinkConnection::enableSigning(const std::vector<uint8_t>& secretKey, uint8_t linkId, uint64_t timestamp)
+{
+    pImpl->enableSigning(secretKey, linkId, timestamp);
+}
+
+void MavLinkConnection::disableSigning()
+{
+    pImpl->disableSigning();
+}
+
+bool MavLinkConnection::isSigning()
+{
+    return pImpl->isSigning();
+}
+
+void MavLinkConnection::setAcceptUnsignedHandler(AcceptUnsignedHandler handler)
+{
+    pImpl->setAcceptUnsignedHandler(handler);
+}
+
+uint64_t MavLinkConnection::getSigningTimestamp()
+{
+    return pImpl->getSigningTimestamp();
+}
+
 std::string MavLinkConnection::getName()
 {
     return pImpl->getName();
@@ -93,6 +118,10 @@ void MavLinkConnection::sendMessage(const MavLinkMessage& msg)
 {
     pImpl->sendMessage(msg);
 }
+void MavLinkConnection::forwardMessage(const MavLinkMessage& msg)
+{
+    pImpl->forwardMessage(msg);
+}
 
 int MavLinkConnection::subscribe(MessageHandler handler)
 {
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "MavLinkMissionClient.hpp"
+#include "impl/MavLinkMissionClientImpl.hpp"
+
+using namespace mavlinkcom;
+using namespace mavlinkcom_impl;
+
+MavLinkMissionClient::MavLinkMissionClient(int localSystemId, int localComponentId)
+    : MavLinkNode(localSystemId, localComponentId)
+{
+    pImpl.reset(new MavLinkMissionClientImpl(localSystemId, localComponentId));
+}
+
+MavLinkMissionClient::~MavLinkMissionClient()
+{
+}
+
+void MavLinkMissionClient::setWindowSize(int items)
+{
+    auto ptr = static_cast<MavLinkMissionClientImpl*>(pImpl.get());
+    ptr->setWindowSize(items);
+}
+
+void MavLinkMissionClient::setTimeout(int milliseconds, int maxRetries)
+{
+    auto ptr = static_cast<MavLinkMissionClientImpl*>(pImpl.get());
+    ptr->setTimeout(milliseconds, maxRetries);
+}
+
+AsyncResult<bool> MavLinkMissionClient::uploadMission(const std::vector<MavLinkMissionItemInt>& items)
+{
+    auto ptr = static_cast<MavLinkMissionClientImpl*>(pImpl.get());
+    return ptr->uploadMission(items);
+}
+
+AsyncResult<std::vector<MavLinkMissionItemInt>> MavLinkMissionClient::downloadMission()
+{
+    auto ptr = static_cast<MavLinkMissionClientImpl*>(pImpl.get());
+    return ptr->downloadMission();
+}
+
+AsyncResult<bool> MavLinkMissionClient::clearMission()
+{
+    auto ptr = static_cast<MavLinkMissionClientImpl*>(pImpl.get());
+    return ptr->clearMission();
+}
+
+AsyncResult<bool> MavLinkMissionClient::setCurrentMissionItem(int seq)
+{
+    auto ptr = static_cast<MavLinkMissionClientImpl*>(pImpl.get());
+    return ptr->setCurrentMissionItem(seq);
+}
+
+MavLinkMissionProgress MavLinkMissionClient::getProgress()
+{
+    auto ptr = static_cast<MavLinkMissionClientImpl*>(pImpl.get());
+    return ptr->getProgress();
+}
+
+void MavLinkMissionClient::cancel()
+{
+    auto ptr = static_cast<MavLinkMissionClientImpl*>(pImpl.get());
+    ptr->cancel();
+}
@@ -27,6 +27,11 @@ void MavLinkNode::connect(std::shared_ptr<MavLinkConnection> connection)
 	pImpl->connect(connection);
 }
 
+void MavLinkNode::connect(std::shared_ptr<MavLinkRouter> router, int targetSystemId, int targetComponentId)
+{
+	pImpl->connect(router, targetSystemId, targetComponentId);
+}
+
 // Send heartbeat to drone.  You should not do this if some other node is
 // already doing it.
 void MavLinkNode::startHeartbeat()
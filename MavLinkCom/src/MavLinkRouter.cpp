@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "MavLinkRouter.hpp"
+#include "impl/MavLinkRouterImpl.hpp"
+
+using namespace mavlinkcom;
+using namespace mavlinkcom_impl;
+
+MavLinkRouter::MavLinkRouter()
+    : impl_(new MavLinkRouterImpl())
+{
+}
+
+MavLinkRouter::~MavLinkRouter()
+{
+    impl_->close();
+}
+
+void MavLinkRouter::addLink(std::shared_ptr<MavLinkConnection> link)
+{
+    impl_->addLink(link);
+}
+
+void MavLinkRouter::removeLink(std::shared_ptr<MavLinkConnection> link)
+{
+    impl_->removeLink(link);
+}
+
+int MavLinkRouter::subscribe(int systemId, MessageHandler handler)
+{
+    return impl_->subscribe(systemId, handler);
+}
+
+void MavLinkRouter::unsubscribe(int id)
+{
+    impl_->unsubscribe(id);
+}
+
+std::shared_ptr<MavLinkConnection> MavLinkRouter::getLink(int systemId)
+{
+    return impl_->getLink(systemId);
+}
+
+std::vector<int> MavLinkRouter::getSystems()
+{
+    return impl_->getSystems();
+}
+
+void MavLinkRouter::sendMessage(const MavLinkMessageBase& msg)
+{
+    impl_->sendMessage(msg);
+}
+
+void MavLinkRouter::sendMessage(const MavLinkMessage& msg)
+{
+    impl_->sendMessage(msg);
+}
+
+MavLinkRouterStats MavLinkRouter::getStats()
+{
+    return impl_->getStats();
+}
+
+void MavLinkRouter::close()
+{
+    impl_->close();
+}
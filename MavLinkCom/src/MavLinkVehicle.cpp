@@ -177,11 +177,35 @@ int MavLinkVehicle::getVehicleStateVersion()
 	return ptr->getVehicleStateVersion();
 }
 
-const VehicleState& MavLinkVehicle::getVehicleState()
+int MavLinkVehicle::getVehicleStateVersion(VehicleStateGroup group)
+{
+	auto ptr = static_cast<MavLinkVehicleImpl*>(pImpl.get());
+	return ptr->getVehicleStateVersion(group);
+}
+
+VehicleState MavLinkVehicle::getVehicleState()
 {
 	auto ptr = static_cast<MavLinkVehicleImpl*>(pImpl.get());
 	return ptr->getVehicleState();
 }
 
+bool MavLinkVehicle::getVehicleStateIfNewer(int& version, VehicleState& state)
+{
+	auto ptr = static_cast<MavLinkVehicleImpl*>(pImpl.get());
+	return ptr->getVehicleStateIfNewer(version, state);
+}
+
+int MavLinkVehicle::subscribeToStateChanges(int groups, VehicleStateHandler handler)
+{
+	auto ptr = static_cast<MavLinkVehicleImpl*>(pImpl.get());
+	return ptr->subscribeToStateChanges(groups, handler);
+}
+
+void MavLinkVehicle::unsubscribeFromStateChanges(int id)
+{
+	auto ptr = static_cast<MavLinkVehicleImpl*>(pImpl.get());
+	ptr->unsubscribeFromStateChanges(id);
+}
+
 //MavLinkVehicle::MavLinkVehicle() = default;
 //MavLinkVehicle::MavLinkVehicle(MavLinkVehicle&&) = default;
@@ -22,10 +22,6 @@ MavLinkConnectionImpl::MavLinkConnectionImpl()
     telemetry_.messagesSent = 0;
     telemetry_.renderTime = 0;
     closed = true;
-    ::memset(&mavlink_intermediate_status_, 0, sizeof(mavlink_status_t));
-    ::memset(&mavlink_status_, 0, sizeof(mavlink_status_t));
-    // todo: if we support signing then initialize
-    // mavlink_intermediate_status_.signing callbacks
 }
 std::string MavLinkConnectionImpl::getName() {
     return name;
@@ -163,6 +159,40 @@ uint8_t MavLinkConnectionImpl::getNextSequence()
     return next_seq++;
 }
 
+void MavLinkConnectionImpl::enableSigning(const std::vector<uint8_t>& secretKey, uint8_t linkId, uint64_t timestamp)
+{
+    auto signing = std::make_shared<MavLinkSigning>(secretKey, linkId, timestamp);
+    std::lock_guard<std::mutex> guard(signing_mutex_);
+    signing->setAcceptUnsignedHandler(accept_unsigned_);
+    std::atomic_store(&signing_, signing);
+}
+
+void MavLinkConnectionImpl::disableSigning()
+{
+    std::atomic_store(&signing_, std::shared_ptr<MavLinkSigning>());
+}
+
+bool MavLinkConnectionImpl::isSigning()
+{
+    return std::atomic_load(&signing_) != nullptr;
+}
+
+void MavLinkConnectionImpl::setAcceptUnsignedHandler(AcceptUnsignedHandler handler)
+{
+    std::lock_guard<std::mutex> guard(signing_mutex_);
+    accept_unsigned_ = handler;
+    auto signing = std::atomic_load(&signing_);
+    if (signing != nullptr) {
+        signing->setAcceptUnsignedHandler(handler);
+    }
+}
+
+uint64_t MavLinkConnectionImpl::getSigningTimestamp()
+{
+    auto signing = std::atomic_load(&signing_);
+    return signing != nullptr ? signing->getTimestamp() : 0;
+}
+
 void MavLinkConnectionImpl::ignoreMessage(uint8_t message_id)
 {
     ignored_messageids.insert(message_id);
@@ -217,14 +247,47 @@ void MavLinkConnectionImpl::sendMessage(const MavLinkMessage& m)
 
 }
 
+void MavLinkConnectionImpl::forwardMessage(const MavLinkMessage& msg)
+{
+    if (ignored_messageids.find(msg.msgid) != ignored_messageids.end())
+        return;
+
+    if (closed) {
+        return;
+    }
+
+    {
+        if (sendLog_ != nullptr)
+        {
+            sendLog_->write(msg);
+        }
+
+        // unlike sendMessage nothing is re-packed, the sequence number, CRC and signature belong to the sender.
+        std::lock_guard<std::mutex> guard(buffer_mutex);
+        size_t len = MavLinkFrameParser::encodeFrame(msg, message_buf);
+
+        try {
+            port->write(message_buf, static_cast<int>(len));
+        }
+        catch (std::exception& e) {
+            throw std::runtime_error(Utils::stringf("MavLinkConnectionImpl: Error forwarding message on connection '%s', details: %s", name.c_str(), e.what()));
+        }
+    }
+    {
+        std::lock_guard<std::mutex> guard(telemetry_mutex_);
+        telemetry_.messagesSent++;
+    }
+}
+
 int MavLinkConnectionImpl::prepareForSending(MavLinkMessage& msg)
 {
     // as per  https://github.com/mavlink/mavlink/blob/master/doc/MAVLink2.md
     int seqno = getNextSequence();
 
-    bool mavlink1 = !supports_mavlink2_;
-    bool signing = !mavlink1 && mavlink_status_.signing && (mavlink_status_.signing->flags & MAVLINK_SIGNING_FLAG_SIGN_OUTGOING);
-    uint8_t signature_len = signing ? MAVLINK_SIGNATURE_BLOCK_LEN : 0;
+    // signing needs MAVLink2, so a signed link uses it even before we hear from the other side.
+    std::shared_ptr<MavLinkSigning> signing = std::atomic_load(&signing_);
+    bool mavlink1 = !supports_mavlink2_ && signing == nullptr;
+    uint8_t signature_len = signing != nullptr ? MAVLINK_SIGNATURE_BLOCK_LEN : 0;
 
     uint8_t header_len = MAVLINK_CORE_HEADER_LEN + 1;
     uint8_t buf[MAVLINK_CORE_HEADER_LEN + 1];
@@ -238,7 +301,7 @@ int MavLinkConnectionImpl::prepareForSending(MavLinkMessage& msg)
 
     msg.seq = seqno;
     msg.incompat_flags = 0;
-    if (signing_) {
+    if (signing != nullptr) {
         msg.incompat_flags |= MAVLINK_IFLAG_SIGNED;
     }
     msg.compat_flags = 0;
@@ -258,7 +321,8 @@ int MavLinkConnectionImpl::prepareForSending(MavLinkMessage& msg)
     if (msg.msgid == MavLinkTelemetry::kMessageId) {
         msglen = 28; // mavlink doesn't know about our custom telemetry message.
     }
-    if (len != msglen) {
+    // a message we received from a MAVLink2 node has its trailing zeros trimmed, so it can be shorter when we forward it.
+    if (len > msglen) {
         throw std::runtime_error(Utils::stringf("Message length %d doesn't match expected length%d\n", len, msglen));
     }
     msg.len = mavlink1 ? msglen : _mav_trim_payload(payload, msglen);
@@ -283,9 +347,9 @@ int MavLinkConnectionImpl::prepareForSending(MavLinkMessage& msg)
         buf[9] = (msg.msgid >> 16) & 0xFF;
     }
 
-    msg.checksum = crc_calculate(&buf[1], header_len - 1);
-    crc_accumulate_buffer(&msg.checksum, payload, msg.len);
-    crc_accumulate(crc_extra, &msg.checksum);
+    msg.checksum = MavLinkFrameParser::crcAccumulate(X25_INIT_CRC, &buf[1], header_len - 1);
+    msg.checksum = MavLinkFrameParser::crcAccumulate(msg.checksum, reinterpret_cast<const uint8_t*>(payload), msg.len);
+    msg.checksum = MavLinkFrameParser::crcAccumulate(msg.checksum, &crc_extra, 1);
 
     // these macros use old style cast.
     STRICT_MODE_OFF
@@ -293,12 +357,9 @@ int MavLinkConnectionImpl::prepareForSending(MavLinkMessage& msg)
     mavlink_ck_b(&msg) = (uint8_t)(msg.checksum >> 8);
     STRICT_MODE_ON
 
-    if (signing_) {
-        mavlink_sign_packet(mavlink_status_.signing,
-            reinterpret_cast<uint8_t *>(msg.signature),
-            reinterpret_cast<const uint8_t *>(message_buf), header_len,
-            reinterpret_cast<const uint8_t *>(payload), msg.len,
-            reinterpret_cast<const uint8_t *>(payload) + msg.len);
+    if (signing != nullptr) {
+        signing->sign(buf, header_len, reinterpret_cast<const uint8_t*>(payload), msg.len,
+            reinterpret_cast<const uint8_t*>(payload) + msg.len, reinterpret_cast<uint8_t*>(msg.signature));
     }
 
     return msg.len + header_len + 2 + signature_len;
@@ -360,16 +421,12 @@ void MavLinkConnectionImpl::readPackets()
 {
     //CurrentThread::setMaximumPriority();
     std::shared_ptr<Port> safePort = this->port;
-    mavlink_message_t msg;
-    mavlink_message_t msgBuffer; // intermediate state.
     const int MAXBUFFER = 512;
     uint8_t* buffer = new uint8_t[MAXBUFFER];
-    mavlink_intermediate_status_.parse_state = MAVLINK_PARSE_STATE_IDLE;
-    int channel = 0;
+    parser_.reset();
     int hr = 0;
     while (hr == 0 && con_ != nullptr && !closed)
     {
-        int read = 0;
         if (safePort->isClosed())
         {
             // hmmm, wait till it is opened?
@@ -383,68 +440,10 @@ void MavLinkConnectionImpl::readPackets()
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
             continue;
         }
-        for (int i = 0; i < count; i++)
-        {
-            uint8_t frame_state = mavlink_frame_char_buffer(&msgBuffer, &mavlink_intermediate_status_, buffer[i], &msg, &mavlink_status_);
-
-            if (frame_state == MAVLINK_FRAMING_INCOMPLETE) {
-                continue;
-            }
-            else if (frame_state == MAVLINK_FRAMING_BAD_CRC) {
-                std::lock_guard<std::mutex> guard(telemetry_mutex_);
-                telemetry_.crcErrors++;
-            }
-            else if (frame_state == MAVLINK_FRAMING_OK)
-            {
-                int msgId = msg.msgid;
-
-                // pick up the sysid/compid of the remote node we are connected to.
-                if (other_system_id == -1) {
-                    other_system_id = msg.sysid;
-                    other_component_id = msg.compid;
-                }
-
-                if (mavlink_intermediate_status_.flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)
-                {
-                    // then this is a mavlink 1 message
-                } else {
-                    // then this mavlink sender supports mavlink 2
-                    supports_mavlink2_ = true;
-                }
-
-                if (con_ != nullptr && !closed)
-                {
-                    {
-                        std::lock_guard<std::mutex> guard(telemetry_mutex_);
-                        telemetry_.messagesReceived++;
-                    }
-                    // queue event for publishing.
-                    {
-                        std::lock_guard<std::mutex> guard(msg_queue_mutex_);
-                        MavLinkMessage message;
-                        message.compid = msg.compid;
-                        message.sysid = msg.sysid;
-                        message.len = msg.len;
-                        message.checksum = msg.checksum;
-                        message.magic = msg.magic;
-                        message.incompat_flags = msg.incompat_flags;
-                        message.compat_flags = msg.compat_flags;
-                        message.seq = msg.seq;
-                        message.msgid = msg.msgid;
-                        ::memcpy(message.signature, msg.signature, 13);
-                        ::memcpy(message.payload64, msg.payload64, PayloadSize * sizeof(uint64_t));
-                        msg_queue_.push(message);
-                    }
-                    if (waiting_for_msg_) {
-                        msg_available_.post();
-                    }
-                }
-            }
-            else {
-                std::lock_guard<std::mutex> guard(telemetry_mutex_);
-                telemetry_.crcErrors++;
-            }
-        }	
+        parser_.setSigning(std::atomic_load(&signing_));
+        parser_.parse(buffer, count, [this](uint8_t frame_state, const MavLinkMessage& message) {
+            handleFrame(frame_state, message);
+        });
 
     } //while
 
@@ -452,6 +451,44 @@ void MavLinkConnectionImpl::readPackets()
 
 } //readPackets
 
+void MavLinkConnectionImpl::handleFrame(uint8_t frame_state, const MavLinkMessage& message)
+{
+    if (frame_state != MAVLINK_FRAMING_OK)
+    {
+        std::lock_guard<std::mutex> guard(telemetry_mutex_);
+        telemetry_.crcErrors++;
+        return;
+    }
+
+    // pick up the sysid/compid of the remote node we are connected to.
+    if (other_system_id == -1) {
+        other_system_id = message.sysid;
+        other_component_id = message.compid;
+    }
+
+    if (message.magic != MAVLINK_STX_MAVLINK1)
+    {
+        // then this mavlink sender supports mavlink 2
+        supports_mavlink2_ = true;
+    }
+
+    if (con_ != nullptr && !closed)
+    {
+        {
+            std::lock_guard<std::mutex> guard(telemetry_mutex_);
+            telemetry_.messagesReceived++;
+        }
+        // queue event for publishing.
+        {
+            std::lock_guard<std::mutex> guard(msg_queue_mutex_);
+            msg_queue_.push(message);
+        }
+        if (waiting_for_msg_) {
+            msg_available_.post();
+        }
+    }
+}
+
 void MavLinkConnectionImpl::drainQueue()
 {
     MavLinkMessage message;
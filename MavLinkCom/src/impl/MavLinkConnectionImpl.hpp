@@ -13,6 +13,8 @@
 #include "MavLinkConnection.hpp"
 #include "MavLinkMessageBase.hpp"
 #include "Semaphore.hpp"
+#include "MavLinkFrameParser.hpp"
+#include "MavLinkSigning.hpp"
 #include "../serial_com/TcpClientPort.hpp"
 #include "StrictMode.hpp"
 #define MAVLINK_PACKED
@@ -48,6 +50,7 @@ namespace mavlinkcom_impl {
         bool isOpen();
         void sendMessage(const MavLinkMessageBase& msg);
         void sendMessage(const MavLinkMessage& msg);
+        void forwardMessage(const MavLinkMessage& msg);
         int subscribe(MessageHandler handler);
         void unsubscribe(int id);		
         uint8_t getNextSequence();
@@ -55,12 +58,18 @@ namespace mavlinkcom_impl {
         void getTelemetry(MavLinkTelemetry& result);
         void ignoreMessage(uint8_t message_id);
         int prepareForSending(MavLinkMessage& msg);
+        void enableSigning(const std::vector<uint8_t>& secretKey, uint8_t linkId, uint64_t timestamp);
+        void disableSigning();
+        bool isSigning();
+        void setAcceptUnsignedHandler(AcceptUnsignedHandler handler);
+        uint64_t getSigningTimestamp();
     private:
         static std::shared_ptr<MavLinkConnection> createConnection(const std::string& nodeName, std::shared_ptr<Port> port);
         void joinLeftSubscriber(std::shared_ptr<MavLinkConnection> remote, std::shared_ptr<MavLinkConnection>con, const MavLinkMessage& msg);
         void joinRightSubscriber(std::shared_ptr<MavLinkConnection>con, const MavLinkMessage& msg);
         void publishPackets();
         void readPackets();
+        void handleFrame(uint8_t frame_state, const MavLinkMessage& message);
         void drainQueue();
         std::string name;
         std::shared_ptr<Port> port;
@@ -91,9 +100,11 @@ namespace mavlinkcom_impl {
         mavlink_utils::Semaphore msg_available_;
         bool waiting_for_msg_ = false;
         bool supports_mavlink2_ = false;
-        bool signing_ = false;
-        mavlink_status_t mavlink_intermediate_status_;
-        mavlink_status_t mavlink_status_;
+        // replaced with std::atomic_store, so the reader and senders always see a whole signing state.
+        std::shared_ptr<MavLinkSigning> signing_;
+        std::mutex signing_mutex_;
+        AcceptUnsignedHandler accept_unsigned_;
+        MavLinkFrameParser parser_;
         std::mutex telemetry_mutex_;
         MavLinkTelemetry telemetry_;
         std::unordered_set<uint8_t> ignored_messageids;
@@ -0,0 +1,334 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "MavLinkFrameParser.hpp"
+#include "StrictMode.hpp"
+#include <string.h>
+#include <algorithm>
+
+STRICT_MODE_OFF
+#define MAVLINK_PACKED
+#include "../mavlink/common/mavlink.h"
+#include "../mavlink/mavlink_helpers.h"
+STRICT_MODE_ON
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MAVLINKCOM_FRAME_SCAN_SSE2
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+using namespace mavlinkcom_impl;
+
+namespace {
+
+    // slice-by-4 tables for the reflected CCITT polynomial MAVLink uses (X.25, init 0xffff, no final xor),
+    // table[k][b] is the effect of byte b followed by k zero bytes.
+    struct CrcTables {
+        uint16_t table[4][256];
+
+        CrcTables() {
+            for (int b = 0; b < 256; b++) {
+                uint16_t crc = static_cast<uint16_t>(b);
+                for (int bit = 0; bit < 8; bit++) {
+                    crc = (crc & 1) ? static_cast<uint16_t>((crc >> 1) ^ 0x8408) : static_cast<uint16_t>(crc >> 1);
+                }
+                table[0][b] = crc;
+            }
+            for (int k = 1; k < 4; k++) {
+                for (int b = 0; b < 256; b++) {
+                    uint16_t prev = table[k - 1][b];
+                    table[k][b] = static_cast<uint16_t>((prev >> 8) ^ table[0][prev & 0xff]);
+                }
+            }
+        }
+    };
+
+    const CrcTables crc_tables;
+
+    const size_t Mavlink1HeaderLength = MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1;
+    const size_t Mavlink2HeaderLength = MAVLINK_CORE_HEADER_LEN + 1;
+
+    inline bool isMavlink1(const uint8_t* frame) {
+        return frame[0] == MAVLINK_STX_MAVLINK1;
+    }
+
+    inline size_t headerLength(const uint8_t* frame) {
+        return isMavlink1(frame) ? Mavlink1HeaderLength : Mavlink2HeaderLength;
+    }
+
+    // mavlink_frame_char_buffer only leaves the payload state when its 8 bit index wraps around to the length,
+    // so a zero length frame carries 256 payload bytes.
+    inline size_t payloadLength(const uint8_t* frame) {
+        return frame[1] == 0 ? 256 : frame[1];
+    }
+
+    inline bool isSigned(const uint8_t* frame) {
+        return !isMavlink1(frame) && (frame[2] & MAVLINK_IFLAG_SIGNED) != 0;
+    }
+}
+
+MavLinkFrameParser::MavLinkFrameParser()
+{
+    ::memset(&msg_, 0, sizeof(msg_));
+}
+
+void MavLinkFrameParser::reset()
+{
+    pending_length_ = 0;
+    bad_crc_reported_ = false;
+}
+
+void MavLinkFrameParser::setSigning(std::shared_ptr<MavLinkSigning> signing)
+{
+    signing_ = signing;
+}
+
+uint16_t MavLinkFrameParser::crcAccumulate(uint16_t crc, const uint8_t* data, size_t length)
+{
+    const uint8_t* end = data + length;
+    while (end - data >= 4) {
+        uint16_t x = static_cast<uint16_t>(crc ^ (data[0] | (data[1] << 8)));
+        crc = static_cast<uint16_t>(crc_tables.table[3][x & 0xff] ^ crc_tables.table[2][x >> 8] ^
+            crc_tables.table[1][data[2]] ^ crc_tables.table[0][data[3]]);
+        data += 4;
+    }
+    for (; data < end; data++) {
+        crc = static_cast<uint16_t>((crc >> 8) ^ crc_tables.table[0][(crc ^ *data) & 0xff]);
+    }
+    return crc;
+}
+
+const uint8_t* MavLinkFrameParser::findStx(const uint8_t* ptr, const uint8_t* end)
+{
+#ifdef MAVLINKCOM_FRAME_SCAN_SSE2
+    const __m128i stx1 = _mm_set1_epi8(static_cast<char>(MAVLINK_STX_MAVLINK1));
+    const __m128i stx2 = _mm_set1_epi8(static_cast<char>(MAVLINK_STX));
+    while (end - ptr >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, stx1), _mm_cmpeq_epi8(block, stx2)));
+        if (mask != 0) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, static_cast<unsigned long>(mask));
+            return ptr + index;
+#else
+            return ptr + __builtin_ctz(static_cast<unsigned int>(mask));
+#endif
+        }
+        ptr += 16;
+    }
+    for (; ptr < end; ptr++) {
+        if (*ptr == MAVLINK_STX || *ptr == MAVLINK_STX_MAVLINK1) {
+            return ptr;
+        }
+    }
+    return end;
+#else
+    const void* stx2 = ::memchr(ptr, MAVLINK_STX, end - ptr);
+    const uint8_t* limit = stx2 == nullptr ? end : static_cast<const uint8_t*>(stx2);
+    const void* stx1 = ::memchr(ptr, MAVLINK_STX_MAVLINK1, limit - ptr);
+    return stx1 == nullptr ? limit : static_cast<const uint8_t*>(stx1);
+#endif
+}
+
+void MavLinkFrameParser::parse(const uint8_t* buffer, size_t length, const FrameHandler& handler)
+{
+    size_t pos = 0;
+    if (pending_length_ > 0) {
+        pos = completePending(buffer, length, handler);
+    }
+    const uint8_t* end = buffer + length;
+    while (pos < length) {
+        const uint8_t* frame = findStx(buffer + pos, end);
+        if (frame == end) {
+            break;
+        }
+        size_t available = end - frame;
+        size_t consumed = scanFrame(frame, available, handler);
+        if (consumed == 0) {
+            // the rest of the frame is in the next read.
+            ::memcpy(pending_, frame, available);
+            pending_length_ = available;
+            break;
+        }
+        pos = (frame - buffer) + consumed;
+    }
+}
+
+size_t MavLinkFrameParser::completePending(const uint8_t* buffer, size_t length, const FrameHandler& handler)
+{
+    // only take the bytes the frame needs for the next decision, so whatever follows a rejected
+    // header is scanned again from the input buffer, the same way the byte at a time parser sees it.
+    size_t pos = 0;
+    while (pending_length_ > 0) {
+        size_t take = std::min(requiredLength(pending_, pending_length_) - pending_length_, length - pos);
+        ::memcpy(pending_ + pending_length_, buffer + pos, take);
+        pending_length_ += take;
+        pos += take;
+        if (scanFrame(pending_, pending_length_, handler) > 0) {
+            pending_length_ = 0;
+        }
+        else if (pos == length) {
+            break;
+        }
+    }
+    return pos;
+}
+
+size_t MavLinkFrameParser::requiredLength(const uint8_t* frame, size_t available)
+{
+    if (available < 2) {
+        return 2;
+    }
+    if (!isMavlink1(frame) && available < 3) {
+        return 3;
+    }
+    size_t crc_end = headerLength(frame) + payloadLength(frame) + 2;
+    if (available < crc_end) {
+        return crc_end;
+    }
+    return crc_end + (isSigned(frame) ? MAVLINK_SIGNATURE_BLOCK_LEN : 0);
+}
+
+size_t MavLinkFrameParser::scanFrame(const uint8_t* frame, size_t available, const FrameHandler& handler)
+{
+    if (available < 2) {
+        return 0;
+    }
+    if (!isMavlink1(frame)) {
+        if (available < 3) {
+            return 0;
+        }
+        if ((frame[2] & ~MAVLINK_IFLAG_MASK) != 0) {
+            // unknown incompatible flag, the parser goes back to looking for a start byte after the flags.
+            return 3;
+        }
+    }
+
+    size_t header_length = headerLength(frame);
+    size_t payload_length = payloadLength(frame);
+    size_t crc_pos = header_length + payload_length;
+    if (available < crc_pos + 2) {
+        return 0;
+    }
+
+    uint32_t msgid = frame[header_length - 1];
+    if (!isMavlink1(frame)) {
+        msgid = frame[7] | (frame[8] << 8) | (msgid << 16);
+    }
+    const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(msgid);
+    uint8_t crc_extra = entry != nullptr ? entry->crc_extra : 0;
+    uint16_t crc = crcAccumulate(X25_INIT_CRC, frame + 1, crc_pos - 1);
+    crc = crcAccumulate(crc, &crc_extra, 1);
+    uint16_t wire_crc = static_cast<uint16_t>(frame[crc_pos] | (frame[crc_pos + 1] << 8));
+    bool crc_ok = crc == wire_crc;
+
+    if (!isSigned(frame)) {
+        uint8_t framing = crc_ok ? MAVLINK_FRAMING_OK : MAVLINK_FRAMING_BAD_CRC;
+        if (crc_ok && signing_ != nullptr && !signing_->acceptUnsigned(msgid)) {
+            framing = MAVLINK_FRAMING_BAD_SIGNATURE;
+        }
+        decode(frame, crc_ok ? crc : wire_crc);
+        handler(framing, msg_);
+        return crc_pos + 2;
+    }
+
+    // a signed frame with a bad CRC is reported as soon as the CRC arrives, and then again when the
+    // signature has arrived.
+    if (!crc_ok && !bad_crc_reported_) {
+        decode(frame, wire_crc);
+        handler(MAVLINK_FRAMING_BAD_CRC, msg_);
+        bad_crc_reported_ = true;
+    }
+    size_t frame_length = crc_pos + 2 + MAVLINK_SIGNATURE_BLOCK_LEN;
+    if (available < frame_length) {
+        return 0;
+    }
+    bad_crc_reported_ = false;
+    // like mavlink_frame_char_buffer the signature decides, even if the CRC was bad.
+    const uint8_t* signature = frame + crc_pos + 2;
+    bool signature_ok = signing_ == nullptr ||
+        signing_->check(frame, crc_pos + 2, signature, frame[5], frame[6]) ||
+        signing_->acceptUnsigned(msgid);
+    decode(frame, crc);
+    ::memcpy(msg_.signature, signature, MAVLINK_SIGNATURE_BLOCK_LEN);
+    handler(signature_ok ? MAVLINK_FRAMING_OK : MAVLINK_FRAMING_BAD_SIGNATURE, msg_);
+    return frame_length;
+}
+
+size_t MavLinkFrameParser::encodeFrame(const MavLinkMessage& msg, uint8_t* buffer)
+{
+    size_t pos = 0;
+    buffer[pos++] = msg.magic;
+    buffer[pos++] = msg.len;
+    if (isMavlink1(buffer)) {
+        buffer[pos++] = msg.seq;
+        buffer[pos++] = msg.sysid;
+        buffer[pos++] = msg.compid;
+        buffer[pos++] = static_cast<uint8_t>(msg.msgid & 0xFF);
+    }
+    else {
+        buffer[pos++] = msg.incompat_flags;
+        buffer[pos++] = msg.compat_flags;
+        buffer[pos++] = msg.seq;
+        buffer[pos++] = msg.sysid;
+        buffer[pos++] = msg.compid;
+        buffer[pos++] = static_cast<uint8_t>(msg.msgid & 0xFF);
+        buffer[pos++] = static_cast<uint8_t>((msg.msgid >> 8) & 0xFF);
+        buffer[pos++] = static_cast<uint8_t>((msg.msgid >> 16) & 0xFF);
+    }
+    ::memcpy(buffer + pos, &msg.payload64[0], msg.len);
+    pos += msg.len;
+    buffer[pos++] = msg.ck[0];
+    buffer[pos++] = msg.ck[1];
+    if (isSigned(buffer)) {
+        ::memcpy(buffer + pos, msg.signature, MAVLINK_SIGNATURE_BLOCK_LEN);
+        pos += MAVLINK_SIGNATURE_BLOCK_LEN;
+    }
+    return pos;
+}
+
+void MavLinkFrameParser::decode(const uint8_t* frame, uint16_t checksum)
+{
+    msg_.magic = frame[0];
+    msg_.len = frame[1];
+    if (isMavlink1(frame)) {
+        msg_.incompat_flags = 0;
+        msg_.compat_flags = 0;
+        msg_.seq = frame[2];
+        msg_.sysid = frame[3];
+        msg_.compid = frame[4];
+        msg_.msgid = frame[5];
+    }
+    else {
+        msg_.incompat_flags = frame[2];
+        msg_.compat_flags = frame[3];
+        msg_.seq = frame[4];
+        msg_.sysid = frame[5];
+        msg_.compid = frame[6];
+        msg_.msgid = frame[7] | (frame[8] << 8) | (frame[9] << 16);
+    }
+    msg_.checksum = checksum;
+
+    size_t header_length = headerLength(frame);
+    size_t payload_length = payloadLength(frame);
+    uint8_t* payload = reinterpret_cast<uint8_t*>(&msg_.payload64[0]);
+    ::memcpy(payload, frame + header_length, payload_length);
+    if (frame[1] != 0) {
+        // short MAVLink2 payloads have their trailing zeros trimmed.
+        ::memset(payload + payload_length, 0, sizeof(msg_.payload64) - payload_length);
+    }
+    else {
+        // the 256 byte case, where the byte at a time parser zero fills from its wrapped index.
+        const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(msg_.msgid);
+        if (entry != nullptr) {
+            ::memset(payload, 0, entry->msg_len);
+        }
+    }
+    msg_.ck[0] = frame[header_length + payload_length];
+    msg_.ck[1] = frame[header_length + payload_length + 1];
+    ::memset(msg_.signature, 0, sizeof(msg_.signature));
+}
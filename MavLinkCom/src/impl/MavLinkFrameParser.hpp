@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef MavLinkCom_MavLinkFrameParser_hpp
+#define MavLinkCom_MavLinkFrameParser_hpp
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <memory>
+#include "MavLinkMessageBase.hpp"
+#include "MavLinkSigning.hpp"
+
+using namespace mavlinkcom;
+
+namespace mavlinkcom_impl {
+
+    // This class finds MAVLink frames in a buffer of bytes read from a port.  It gives exactly the same results
+    // as feeding the bytes one at a time through mavlink_frame_char_buffer, including the way it recovers from
+    // garbage and bad frames, but instead of running the state machine on every byte it scans ahead for the next
+    // start byte, checks the CRC of the whole frame in one go, and decodes the frame straight into a MavLinkMessage.
+    // A frame that is split across two reads is carried over to the next call to parse.
+    class MavLinkFrameParser
+    {
+    public:
+        // framing is one of MAVLINK_FRAMING_OK, MAVLINK_FRAMING_BAD_CRC or MAVLINK_FRAMING_BAD_SIGNATURE.
+        typedef std::function<void(uint8_t framing, const MavLinkMessage& msg)> FrameHandler;
+
+        MavLinkFrameParser();
+
+        // parse the next block of bytes from the stream, calling the handler for every frame that is completed.
+        void parse(const uint8_t* buffer, size_t length, const FrameHandler& handler);
+
+        // forget any partial frame, for example after the port is reopened.
+        void reset();
+
+        // check signatures with the given link state, or pass nullptr to accept all frames the way
+        // mavlink_frame_char_buffer does when there is no signing setup.
+        void setSigning(std::shared_ptr<MavLinkSigning> signing);
+
+        // write the frame a parsed message was decoded from back into buffer, byte for byte, and return its length.
+        // buffer must hold MaxFrameLength bytes.
+        static size_t encodeFrame(const MavLinkMessage& msg, uint8_t* buffer);
+
+        // the X.25 checksum used by MAVLink, crc is the checksum so far (start with 0xffff).
+        static uint16_t crcAccumulate(uint16_t crc, const uint8_t* data, size_t length);
+
+        static const size_t MaxFrameLength = 10 + 256 + 2 + 13;
+
+    private:
+        size_t scanFrame(const uint8_t* frame, size_t available, const FrameHandler& handler);
+        size_t completePending(const uint8_t* buffer, size_t length, const FrameHandler& handler);
+        static size_t requiredLength(const uint8_t* frame, size_t available);
+        static const uint8_t* findStx(const uint8_t* ptr, const uint8_t* end);
+        void decode(const uint8_t* frame, uint16_t checksum);
+
+        uint8_t pending_[MaxFrameLength];
+        size_t pending_length_ = 0;
+        bool bad_crc_reported_ = false;
+        std::shared_ptr<MavLinkSigning> signing_;
+        MavLinkMessage msg_;
+    };
+}
+
+#endif
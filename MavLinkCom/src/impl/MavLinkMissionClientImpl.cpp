@@ -0,0 +1,516 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "MavLinkMissionClientImpl.hpp"
+#include "Utils.hpp"
+#include <algorithm>
+
+using namespace mavlink_utils;
+using namespace mavlinkcom;
+using namespace mavlinkcom_impl;
+
+#define WATCHDOG_INTERVAL 20 // milliseconds between checks on the progress of the current transfer.
+
+MavLinkMissionClientImpl::MavLinkMissionClientImpl(int localSystemId, int localComponentId)
+    : MavLinkNodeImpl(localSystemId, localComponentId)
+{
+}
+
+MavLinkMissionClientImpl::~MavLinkMissionClientImpl()
+{
+    cancel();
+    stopWatchdog();
+}
+
+void MavLinkMissionClientImpl::setWindowSize(int items)
+{
+    if (items < 1) {
+        throw std::runtime_error(Utils::stringf("Mission window size must be at least 1, but got %d", items));
+    }
+    std::lock_guard<std::mutex> guard(mutex_);
+    window_size_ = items;
+}
+
+void MavLinkMissionClientImpl::setTimeout(int milliseconds, int maxRetries)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    timeout_ms_ = milliseconds;
+    max_retries_ = maxRetries;
+}
+
+MavLinkMissionProgress MavLinkMissionClientImpl::getProgress()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    return progress_;
+}
+
+void MavLinkMissionClientImpl::cancel()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (command_ != MissionCommandNone) {
+        if (command_ == MissionCommandUpload || command_ == MissionCommandDownload) {
+            // tell the remote node to stop waiting for us.
+            try {
+                sendAck(static_cast<uint8_t>(MAV_MISSION_RESULT::MAV_MISSION_ERROR));
+            }
+            catch (std::exception&) {
+                // connection is already gone, so there is nobody to tell.
+            }
+        }
+        finish(MavLinkMissionProgress::kErrorCancelled, "mission transfer cancelled");
+    }
+}
+
+AsyncResult<bool> MavLinkMissionClientImpl::uploadMission(const std::vector<MavLinkMissionItemInt>& items)
+{
+    ensureConnection();
+    cancel();
+
+    AsyncResult<bool> result([=](int state) {
+        unused(state);
+    });
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    items_ = items;
+    for (size_t i = 0; i < items_.size(); i++) {
+        items_[i].seq = static_cast<uint16_t>(i);
+    }
+    request_count_.assign(items_.size(), 0);
+    next_to_send_ = 0;
+    last_requested_ = -1;
+    push_rejected_ = false;
+    bool_result_ = std::make_shared<AsyncResult<bool>>(result);
+    start(MissionCommandUpload, static_cast<int>(items_.size()));
+    sendCount();
+    return result;
+}
+
+AsyncResult<std::vector<MavLinkMissionItemInt>> MavLinkMissionClientImpl::downloadMission()
+{
+    ensureConnection();
+    cancel();
+
+    AsyncResult<std::vector<MavLinkMissionItemInt>> result([=](int state) {
+        unused(state);
+    });
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    items_.clear();
+    received_.clear();
+    received_count_ = 0;
+    next_to_request_ = 0;
+    count_received_ = false;
+    items_result_ = std::make_shared<AsyncResult<std::vector<MavLinkMissionItemInt>>>(result);
+    start(MissionCommandDownload, 0);
+    sendRequestList();
+    return result;
+}
+
+AsyncResult<bool> MavLinkMissionClientImpl::clearMission()
+{
+    ensureConnection();
+    cancel();
+
+    AsyncResult<bool> result([=](int state) {
+        unused(state);
+    });
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    bool_result_ = std::make_shared<AsyncResult<bool>>(result);
+    start(MissionCommandClear, 0);
+    sendClearAll();
+    return result;
+}
+
+AsyncResult<bool> MavLinkMissionClientImpl::setCurrentMissionItem(int seq)
+{
+    ensureConnection();
+    cancel();
+
+    AsyncResult<bool> result([=](int state) {
+        unused(state);
+    });
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    current_seq_ = seq;
+    bool_result_ = std::make_shared<AsyncResult<bool>>(result);
+    start(MissionCommandSetCurrent, 1);
+    sendSetCurrent();
+    return result;
+}
+
+void MavLinkMissionClientImpl::start(MissionCommandEnum command, int goal)
+{
+    command_ = command;
+    progress_ = MavLinkMissionProgress();
+    progress_.goal = goal;
+    retries_ = 0;
+    last_progress_ = std::chrono::steady_clock::now();
+    startWatchdog();
+}
+
+void MavLinkMissionClientImpl::finish(int error, const std::string& message)
+{
+    MissionCommandEnum command = command_;
+    command_ = MissionCommandNone;
+    progress_.complete = true;
+    progress_.error = error;
+    progress_.message = message;
+
+    bool success = error == static_cast<int>(MAV_MISSION_RESULT::MAV_MISSION_ACCEPTED);
+    if (error != 0) {
+        Utils::log(Utils::stringf("MavLinkMissionClient: %s (error %d)", message.c_str(), error), Utils::kLogLevelWarn);
+    }
+
+    if (command == MissionCommandDownload && items_result_ != nullptr) {
+        auto result = items_result_;
+        items_result_ = nullptr;
+        result->setResult(success ? items_ : std::vector<MavLinkMissionItemInt>());
+    }
+    else if (bool_result_ != nullptr) {
+        auto result = bool_result_;
+        bool_result_ = nullptr;
+        result->setResult(success);
+    }
+}
+
+void MavLinkMissionClientImpl::recordProgress()
+{
+    retries_ = 0;
+    last_progress_ = std::chrono::steady_clock::now();
+}
+
+bool MavLinkMissionClientImpl::isForUs(int targetSystem, int targetComponent)
+{
+    // 0 is the broadcast address.
+    return (targetSystem == 0 || targetSystem == getLocalSystemId()) &&
+        (targetComponent == 0 || targetComponent == getLocalComponentId());
+}
+
+void MavLinkMissionClientImpl::handleMessage(std::shared_ptr<MavLinkConnection> connection, const MavLinkMessage& msg)
+{
+    unused(connection);
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (command_ == MissionCommandNone) {
+        return;
+    }
+
+    switch (msg.msgid) {
+    case MavLinkMissionRequestInt::kMessageId: {
+        MavLinkMissionRequestInt req;
+        req.decode(msg);
+        if (command_ == MissionCommandUpload && isForUs(req.target_system, req.target_component)) {
+            handleUploadRequest(req.seq);
+        }
+        break;
+    }
+    case MavLinkMissionRequest::kMessageId: {
+        // older autopilots ask for MISSION_ITEM, but they also accept MISSION_ITEM_INT in reply.
+        MavLinkMissionRequest req;
+        req.decode(msg);
+        if (command_ == MissionCommandUpload && isForUs(req.target_system, req.target_component)) {
+            handleUploadRequest(req.seq);
+        }
+        break;
+    }
+    case MavLinkMissionCount::kMessageId: {
+        MavLinkMissionCount count;
+        count.decode(msg);
+        if (command_ == MissionCommandDownload && isForUs(count.target_system, count.target_component)) {
+            handleDownloadCount(count.count);
+        }
+        break;
+    }
+    case MavLinkMissionItemInt::kMessageId: {
+        MavLinkMissionItemInt item;
+        item.decode(msg);
+        if (command_ == MissionCommandDownload && isForUs(item.target_system, item.target_component)) {
+            handleDownloadItem(item);
+        }
+        break;
+    }
+    case MavLinkMissionAck::kMessageId: {
+        MavLinkMissionAck ack;
+        ack.decode(msg);
+        if (!isForUs(ack.target_system, ack.target_component)) {
+            break;
+        }
+        if (command_ == MissionCommandUpload) {
+            if (ack.type == static_cast<uint8_t>(MAV_MISSION_RESULT::MAV_MISSION_ACCEPTED)) {
+                progress_.current = progress_.goal;
+                finish(ack.type, "mission upload complete");
+            }
+            else if (ack.type == static_cast<uint8_t>(MAV_MISSION_RESULT::MAV_MISSION_INVALID_SEQUENCE)) {
+                // ArduPilot answers an item it did not ask for this way and keeps requesting the one it wants, so
+                // the upload goes on, but from now on only the requested items are sent.
+                if (!push_rejected_) {
+                    push_rejected_ = true;
+                    next_to_send_ = last_requested_ + 1;
+                }
+            }
+            else {
+                finish(ack.type, "mission upload rejected by remote node");
+            }
+        }
+        else if (command_ == MissionCommandClear) {
+            progress_.current = progress_.goal;
+            finish(ack.type, ack.type == 0 ? "mission cleared" : "mission clear rejected by remote node");
+        }
+        else if (command_ == MissionCommandDownload && ack.type != static_cast<uint8_t>(MAV_MISSION_RESULT::MAV_MISSION_ACCEPTED)) {
+            // the remote node gave up on the download.
+            finish(ack.type, "mission download aborted by remote node");
+        }
+        break;
+    }
+    case MavLinkMissionCurrent::kMessageId: {
+        MavLinkMissionCurrent current;
+        current.decode(msg);
+        if (command_ == MissionCommandSetCurrent && current.seq == current_seq_) {
+            progress_.current = 1;
+            finish(0, "current mission item set");
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void MavLinkMissionClientImpl::handleUploadRequest(int seq)
+{
+    int count = static_cast<int>(items_.size());
+    if (seq < 0 || seq >= count) {
+        return;
+    }
+    recordProgress();
+    request_count_[seq]++;
+    if (seq > last_requested_) {
+        last_requested_ = seq;
+        // the remote node requests items in order, so everything below seq has been received.
+        progress_.current = seq;
+    }
+
+    if (seq >= next_to_send_) {
+        // first time we hear about this item.
+        fillUploadWindow(seq);
+    }
+    else if (request_count_[seq] > 1) {
+        // the remote node is asking again, so the item we sent must have been lost.
+        progress_.retransmits++;
+        sendItem(seq);
+        fillUploadWindow(seq);
+    }
+    else {
+        // we already pushed this item ahead of the request so it should be in flight, just keep the window full.
+        fillUploadWindow(seq);
+    }
+}
+
+void MavLinkMissionClientImpl::fillUploadWindow(int seq)
+{
+    int count = static_cast<int>(items_.size());
+    int end = std::min(count, seq + (push_rejected_ ? 1 : window_size_));
+    while (next_to_send_ < end) {
+        sendItem(next_to_send_++);
+    }
+}
+
+void MavLinkMissionClientImpl::handleDownloadCount(int count)
+{
+    if (count_received_) {
+        // duplicate, we must have sent the request list more than once.
+        return;
+    }
+    recordProgress();
+    count_received_ = true;
+    progress_.goal = count;
+    items_.resize(count);
+    received_.assign(count, false);
+    if (count == 0) {
+        sendAck(static_cast<uint8_t>(MAV_MISSION_RESULT::MAV_MISSION_ACCEPTED));
+        finish(0, "mission download complete");
+        return;
+    }
+    int end = std::min(count, window_size_);
+    while (next_to_request_ < end) {
+        sendRequest(next_to_request_++);
+    }
+}
+
+void MavLinkMissionClientImpl::handleDownloadItem(const MavLinkMissionItemInt& item)
+{
+    int count = static_cast<int>(items_.size());
+    int seq = item.seq;
+    if (!count_received_ || seq >= count || received_[seq]) {
+        return;
+    }
+    recordProgress();
+    received_[seq] = true;
+    items_[seq] = item;
+    received_count_++;
+    progress_.current = received_count_;
+
+    if (received_count_ == count) {
+        sendAck(static_cast<uint8_t>(MAV_MISSION_RESULT::MAV_MISSION_ACCEPTED));
+        finish(0, "mission download complete");
+        return;
+    }
+    // slide the window along.
+    if (next_to_request_ < count) {
+        sendRequest(next_to_request_++);
+    }
+}
+
+void MavLinkMissionClientImpl::retry()
+{
+    retries_++;
+    progress_.timeouts++;
+    if (retries_ > max_retries_) {
+        if (command_ == MissionCommandUpload || command_ == MissionCommandDownload) {
+            sendAck(static_cast<uint8_t>(MAV_MISSION_RESULT::MAV_MISSION_ERROR));
+        }
+        finish(MavLinkMissionProgress::kErrorTimeout, "mission transfer timed out, remote node is not responding");
+        return;
+    }
+    last_progress_ = std::chrono::steady_clock::now();
+
+    switch (command_)
+    {
+    case MissionCommandUpload:
+        if (last_requested_ < 0) {
+            sendCount();
+        }
+        else {
+            // resend the item the remote node is waiting on, the rest of the window follows from its requests.
+            progress_.retransmits++;
+            sendItem(last_requested_);
+        }
+        break;
+    case MissionCommandDownload:
+        if (!count_received_) {
+            sendRequestList();
+        }
+        else {
+            // only ask again for the items that never arrived.
+            for (int i = 0; i < next_to_request_; i++) {
+                if (!received_[i]) {
+                    progress_.retransmits++;
+                    sendRequest(i);
+                }
+            }
+        }
+        break;
+    case MissionCommandClear:
+        sendClearAll();
+        break;
+    case MissionCommandSetCurrent:
+        sendSetCurrent();
+        break;
+    default:
+        break;
+    }
+}
+
+void MavLinkMissionClientImpl::sendCount()
+{
+    MavLinkMissionCount msg;
+    msg.target_system = getTargetSystemId();
+    msg.target_component = getTargetComponentId();
+    msg.count = static_cast<uint16_t>(items_.size());
+    sendMessage(msg);
+}
+
+void MavLinkMissionClientImpl::sendItem(int seq)
+{
+    MavLinkMissionItemInt& item = items_[seq];
+    item.target_system = getTargetSystemId();
+    item.target_component = getTargetComponentId();
+    sendMessage(item);
+}
+
+void MavLinkMissionClientImpl::sendRequestList()
+{
+    MavLinkMissionRequestList msg;
+    msg.target_system = getTargetSystemId();
+    msg.target_component = getTargetComponentId();
+    sendMessage(msg);
+}
+
+void MavLinkMissionClientImpl::sendRequest(int seq)
+{
+    MavLinkMissionRequestInt msg;
+    msg.target_system = getTargetSystemId();
+    msg.target_component = getTargetComponentId();
+    msg.seq = static_cast<uint16_t>(seq);
+    sendMessage(msg);
+}
+
+void MavLinkMissionClientImpl::sendAck(uint8_t type)
+{
+    MavLinkMissionAck msg;
+    msg.target_system = getTargetSystemId();
+    msg.target_component = getTargetComponentId();
+    msg.type = type;
+    sendMessage(msg);
+}
+
+void MavLinkMissionClientImpl::sendClearAll()
+{
+    MavLinkMissionClearAll msg;
+    msg.target_system = getTargetSystemId();
+    msg.target_component = getTargetComponentId();
+    sendMessage(msg);
+}
+
+void MavLinkMissionClientImpl::sendSetCurrent()
+{
+    MavLinkMissionSetCurrent msg;
+    msg.target_system = getTargetSystemId();
+    msg.target_component = getTargetComponentId();
+    msg.seq = static_cast<uint16_t>(current_seq_);
+    sendMessage(msg);
+}
+
+void MavLinkMissionClientImpl::startWatchdog()
+{
+    if (!watchdog_running_) {
+        watchdog_running_ = true;
+        Utils::cleanupThread(watchdog_thread_);
+        watchdog_thread_ = std::thread{ &MavLinkMissionClientImpl::runWatchdog, this };
+    }
+}
+
+void MavLinkMissionClientImpl::stopWatchdog()
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        watchdog_running_ = false;
+    }
+    if (watchdog_thread_.joinable()) {
+        watchdog_thread_.join();
+    }
+}
+
+void MavLinkMissionClientImpl::runWatchdog()
+{
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(WATCHDOG_INTERVAL));
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (!watchdog_running_) {
+            break;
+        }
+        if (command_ == MissionCommandNone) {
+            continue;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - last_progress_);
+        if (elapsed.count() > timeout_ms_) {
+            try {
+                retry();
+            }
+            catch (std::exception& e) {
+                finish(MavLinkMissionProgress::kErrorTimeout, Utils::stringf("mission transfer failed: %s", e.what()));
+            }
+        }
+    }
+}
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef MavLinkCom_MavLinkMissionClientImpl_hpp
+#define MavLinkCom_MavLinkMissionClientImpl_hpp
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include "MavLinkNode.hpp"
+#include "MavLinkNodeImpl.hpp"
+#include "MavLinkMissionClient.hpp"
+
+namespace mavlinkcom_impl {
+
+    class MavLinkMissionClientImpl : public MavLinkNodeImpl
+    {
+    public:
+        MavLinkMissionClientImpl(int localSystemId, int localComponentId);
+        ~MavLinkMissionClientImpl();
+
+        void setWindowSize(int items);
+        void setTimeout(int milliseconds, int maxRetries);
+        AsyncResult<bool> uploadMission(const std::vector<MavLinkMissionItemInt>& items);
+        AsyncResult<std::vector<MavLinkMissionItemInt>> downloadMission();
+        AsyncResult<bool> clearMission();
+        AsyncResult<bool> setCurrentMissionItem(int seq);
+        MavLinkMissionProgress getProgress();
+        void cancel();
+
+    protected:
+        virtual void handleMessage(std::shared_ptr<MavLinkConnection> connection, const MavLinkMessage& message) override;
+
+    private:
+        enum MissionCommandEnum {
+            MissionCommandNone, MissionCommandUpload, MissionCommandDownload, MissionCommandClear, MissionCommandSetCurrent
+        };
+
+        // these are all called with mutex_ held.
+        void start(MissionCommandEnum command, int goal);
+        void finish(int error, const std::string& message);
+        void recordProgress();
+        void retry();
+        void sendCount();
+        void sendItem(int seq);
+        void fillUploadWindow(int seq);
+        void sendRequestList();
+        void sendRequest(int seq);
+        void sendAck(uint8_t type);
+        void sendClearAll();
+        void sendSetCurrent();
+        void handleUploadRequest(int seq);
+        void handleDownloadCount(int count);
+        void handleDownloadItem(const MavLinkMissionItemInt& item);
+        bool isForUs(int targetSystem, int targetComponent);
+
+        void startWatchdog();
+        void stopWatchdog();
+        void runWatchdog();
+
+        std::mutex mutex_;
+        MissionCommandEnum command_ = MissionCommandNone;
+        MavLinkMissionProgress progress_;
+        int window_size_ = 8;
+        int timeout_ms_ = 1500;
+        int max_retries_ = 5;
+        int retries_ = 0;
+        std::chrono::steady_clock::time_point last_progress_;
+
+        // upload state
+        std::vector<MavLinkMissionItemInt> items_;
+        std::vector<int> request_count_; // how many times the remote node asked for each item.
+        int next_to_send_ = 0; // the items below this index have been sent at least once.
+        int last_requested_ = -1;
+        bool push_rejected_ = false; // the remote node does not keep items we send before it asks for them.
+
+        // download state
+        std::vector<bool> received_;
+        int received_count_ = 0;
+        int next_to_request_ = 0; // the items below this index have been requested at least once.
+        bool count_received_ = false;
+
+        // set current state
+        int current_seq_ = 0;
+
+        // only one of these is pending at a time, matching command_.
+        std::shared_ptr<AsyncResult<bool>> bool_result_;
+        std::shared_ptr<AsyncResult<std::vector<MavLinkMissionItemInt>>> items_result_;
+
+        std::thread watchdog_thread_;
+        bool watchdog_running_ = false;
+    };
+}
+
+#endif
@@ -34,6 +34,23 @@ void MavLinkNodeImpl::connect(std::shared_ptr<MavLinkConnection> connection)
     });
 }
 
+// start listening to one remote system on a router.
+void MavLinkNodeImpl::connect(std::shared_ptr<MavLinkRouter> router, int targetSystemId, int targetComponentId)
+{
+    auto link = router->getLink(targetSystemId);
+    if (link == nullptr) {
+        throw std::runtime_error(Utils::stringf("Cannot connect to system %d as the router has not heard from it yet", targetSystemId));
+    }
+    has_cap_ = false;
+    connection_ = link;
+    router_ = router;
+    target_system_id_ = targetSystemId;
+    target_component_id_ = targetComponentId;
+    subscription_ = router_->subscribe(targetSystemId, [=](std::shared_ptr<MavLinkConnection> con, const MavLinkMessage& msg) {
+        handleMessage(con, msg);
+    });
+}
+
 // Send heartbeat to drone.  You should not do this if some other node is
 // already doing it.
 void MavLinkNodeImpl::startHeartbeat()
@@ -76,7 +93,11 @@ void MavLinkNodeImpl::handleMessage(std::shared_ptr<MavLinkConnection> connectio
 // stop listening to the connection.
 void MavLinkNodeImpl::close()
 {
-    if (subscription_ != 0 && connection_ != nullptr) {
+    if (subscription_ != 0 && router_ != nullptr) {
+        router_->unsubscribe(subscription_);
+        subscription_ = 0;
+    }
+    else if (subscription_ != 0 && connection_ != nullptr) {
         connection_->unsubscribe(subscription_);
         subscription_ = 0;
     }
@@ -86,10 +107,11 @@ void MavLinkNodeImpl::close()
             heartbeat_thread_.join();
         }
     }
-    if (connection_ != nullptr) {
+    if (connection_ != nullptr && router_ == nullptr) {
         connection_->close();
     }
     connection_ = nullptr;
+    router_ = nullptr;
 }
 
 AsyncResult<MavLinkAutopilotVersion> MavLinkNodeImpl::getCapabilities()
@@ -15,9 +15,10 @@ namespace mavlinkcom_impl {
     {
     public:
         MavLinkNodeImpl(int localSystemId, int localComponentId);
-        ~MavLinkNodeImpl();
+        virtual ~MavLinkNodeImpl();
 
         void connect(std::shared_ptr<MavLinkConnection> connection);
+        void connect(std::shared_ptr<MavLinkRouter> router, int targetSystemId, int targetComponentId);
         void close();
 
         // Send heartbeat to drone.  You should not do this if some other node is
@@ -38,16 +39,24 @@ namespace mavlinkcom_impl {
         // get the connection 
         std::shared_ptr<MavLinkConnection> getConnection()
         {
+            if (router_ != nullptr) {
+                // the target can move to another link (e.g. a backup radio), so ask the router every time.
+                auto link = router_->getLink(target_system_id_);
+                if (link != nullptr) {
+                    return link;
+                }
+            }
             return connection_;
         }
 
         std::shared_ptr<MavLinkConnection> ensureConnection()
         {
-            if (connection_ == nullptr)
+            auto connection = getConnection();
+            if (connection == nullptr)
             {
                 throw std::runtime_error("Cannot perform operation as there is no connection, did you forget to call connect() ?");
             }
-            return connection_;
+            return connection;
         }
 
         int getLocalSystemId() {
@@ -58,10 +67,16 @@ namespace mavlinkcom_impl {
         }
 
         int getTargetSystemId() {
+            if (router_ != nullptr) {
+                return target_system_id_;
+            }
             return ensureConnection()->getTargetSystemId();
         }
 
         int getTargetComponentId() {
+            if (router_ != nullptr) {
+                return target_component_id_;
+            }
             return ensureConnection()->getTargetComponentId();
         }
 
@@ -90,6 +105,10 @@ namespace mavlinkcom_impl {
         bool inside_handle_message_;
         std::shared_ptr<MavLinkConnection> connection_;
         int subscription_ = 0;
+        // set when we are connected through a router, in which case subscription_ belongs to the router.
+        std::shared_ptr<MavLinkRouter> router_;
+        int target_system_id_ = 0;
+        int target_component_id_ = 0;
         int local_system_id;
         int local_component_id;
         std::vector<MavLinkParameter> parameters_; //cached snapshot.
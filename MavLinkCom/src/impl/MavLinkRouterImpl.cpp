@@ -0,0 +1,264 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "MavLinkRouterImpl.hpp"
+#include "Utils.hpp"
+#include <algorithm>
+
+STRICT_MODE_OFF
+#include "../mavlink/common/mavlink.h"
+#include "../mavlink/mavlink_helpers.h"
+STRICT_MODE_ON
+
+using namespace mavlink_utils;
+using namespace mavlinkcom_impl;
+
+MavLinkRouterImpl::MavLinkRouterImpl()
+{
+}
+
+MavLinkRouterImpl::~MavLinkRouterImpl()
+{
+    close();
+}
+
+void MavLinkRouterImpl::addLink(std::shared_ptr<MavLinkConnection> link)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (auto ptr = links_.begin(); ptr != links_.end(); ptr++) {
+        if (ptr->link == link) {
+            return;
+        }
+    }
+    LinkEntry entry;
+    entry.link = link;
+    entry.subscription = link->subscribe([=](std::shared_ptr<MavLinkConnection> connection, const MavLinkMessage& msg) {
+        handleMessage(connection, msg);
+    });
+    links_.push_back(entry);
+}
+
+void MavLinkRouterImpl::removeLink(std::shared_ptr<MavLinkConnection> link)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (auto ptr = links_.begin(); ptr != links_.end(); ptr++) {
+        if (ptr->link == link) {
+            link->unsubscribe(ptr->subscription);
+            links_.erase(ptr);
+            break;
+        }
+    }
+    for (auto ptr = routes_.begin(); ptr != routes_.end(); ) {
+        if (ptr->second == link) {
+            ptr = routes_.erase(ptr);
+        }
+        else {
+            ptr++;
+        }
+    }
+}
+
+void MavLinkRouterImpl::close()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (auto ptr = links_.begin(); ptr != links_.end(); ptr++) {
+        ptr->link->unsubscribe(ptr->subscription);
+    }
+    links_.clear();
+    routes_.clear();
+}
+
+int MavLinkRouterImpl::subscribe(int systemId, MessageHandler handler)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    HandlerEntry entry = { ++next_handler_id_, handler };
+    auto list = std::make_shared<std::vector<HandlerEntry>>();
+    auto existing = handlers_.find(systemId);
+    if (existing != handlers_.end()) {
+        *list = *existing->second;
+    }
+    list->push_back(entry);
+    handlers_[systemId] = list;
+    return entry.id;
+}
+
+void MavLinkRouterImpl::unsubscribe(int id)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (auto pair = handlers_.begin(); pair != handlers_.end(); pair++) {
+        const std::vector<HandlerEntry>& existing = *pair->second;
+        for (size_t i = 0; i < existing.size(); i++) {
+            if (existing[i].id == id) {
+                auto list = std::make_shared<std::vector<HandlerEntry>>(existing);
+                list->erase(list->begin() + i);
+                pair->second = list;
+                return;
+            }
+        }
+    }
+}
+
+std::shared_ptr<MavLinkConnection> MavLinkRouterImpl::getLink(int systemId)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto ptr = routes_.lower_bound(routeKey(systemId, 0));
+    if (ptr != routes_.end() && (ptr->first >> 8) == systemId) {
+        return ptr->second;
+    }
+    return nullptr;
+}
+
+std::vector<int> MavLinkRouterImpl::getSystems()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    std::vector<int> result;
+    for (auto ptr = routes_.begin(); ptr != routes_.end(); ptr++) {
+        int systemId = ptr->first >> 8;
+        if (result.empty() || result.back() != systemId) {
+            result.push_back(systemId);
+        }
+    }
+    return result;
+}
+
+MavLinkRouterStats MavLinkRouterImpl::getStats()
+{
+    MavLinkRouterStats stats;
+    stats.messagesReceived = messages_received_.exchange(0);
+    stats.messagesDispatched = messages_dispatched_.exchange(0);
+    stats.messagesForwarded = messages_forwarded_.exchange(0);
+    stats.messagesDropped = messages_dropped_.exchange(0);
+    return stats;
+}
+
+void MavLinkRouterImpl::sendMessage(const MavLinkMessageBase& msg)
+{
+    MavLinkMessage m;
+    msg.encode(m);
+    sendMessage(m);
+}
+
+void MavLinkRouterImpl::sendMessage(const MavLinkMessage& msg)
+{
+    route(nullptr, msg);
+}
+
+void MavLinkRouterImpl::handleMessage(std::shared_ptr<MavLinkConnection> link, const MavLinkMessage& msg)
+{
+    messages_received_++;
+
+    HandlerList systemHandlers;
+    HandlerList allHandlers;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        // learn where this system/component lives, a system that moves to another link (e.g. a backup radio)
+        // is picked up on its next message.
+        routes_[routeKey(msg.sysid, msg.compid)] = link;
+        auto ptr = handlers_.find(msg.sysid);
+        if (ptr != handlers_.end()) {
+            systemHandlers = ptr->second;
+        }
+        ptr = handlers_.find(0);
+        if (ptr != handlers_.end()) {
+            allHandlers = ptr->second;
+        }
+    }
+
+    dispatch(systemHandlers, link, msg);
+    dispatch(allHandlers, link, msg);
+    route(link, msg);
+}
+
+void MavLinkRouterImpl::dispatch(const HandlerList& handlers, std::shared_ptr<MavLinkConnection> link, const MavLinkMessage& msg)
+{
+    if (handlers == nullptr) {
+        return;
+    }
+    for (auto ptr = handlers->begin(); ptr != handlers->end(); ptr++) {
+        try {
+            ptr->handler(link, msg);
+        }
+        catch (std::exception& e) {
+            Utils::log(Utils::stringf("MavLinkRouter: Error handling message %d from system %d, details: %s",
+                msg.msgid, msg.sysid, e.what()), Utils::kLogLevelError);
+        }
+        messages_dispatched_++;
+    }
+}
+
+void MavLinkRouterImpl::route(std::shared_ptr<MavLinkConnection> source, const MavLinkMessage& msg)
+{
+    int targetSystem = 0;
+    int targetComponent = 0;
+    getTarget(msg, targetSystem, targetComponent);
+
+    // collect the destinations under the lock and send outside of it.
+    std::vector<std::shared_ptr<MavLinkConnection>> destinations;
+    auto add = [&](const std::shared_ptr<MavLinkConnection>& link) {
+        if (link != source && std::find(destinations.begin(), destinations.end(), link) == destinations.end()) {
+            destinations.push_back(link);
+        }
+    };
+
+    bool known = true;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (targetSystem == 0) {
+            // broadcast, goes everywhere except back where it came from.
+            for (auto ptr = links_.begin(); ptr != links_.end(); ptr++) {
+                add(ptr->link);
+            }
+        }
+        else {
+            auto ptr = routes_.find(routeKey(targetSystem, targetComponent));
+            if (targetComponent != 0 && ptr != routes_.end()) {
+                add(ptr->second);
+            }
+            else {
+                // every link where some component of the target system was seen, this also covers a component
+                // we have not heard from yet.
+                auto end = routes_.lower_bound(routeKey(targetSystem + 1, 0));
+                ptr = routes_.lower_bound(routeKey(targetSystem, 0));
+                known = ptr != end;
+                for (; ptr != end; ptr++) {
+                    add(ptr->second);
+                }
+            }
+        }
+    }
+
+    if (!known) {
+        messages_dropped_++;
+        return;
+    }
+
+    for (auto ptr = destinations.begin(); ptr != destinations.end(); ptr++) {
+        try {
+            (*ptr)->forwardMessage(msg);
+            messages_forwarded_++;
+        }
+        catch (std::exception& e) {
+            Utils::log(Utils::stringf("MavLinkRouter: Error forwarding message %d to '%s', details: %s",
+                msg.msgid, (*ptr)->getName().c_str(), e.what()), Utils::kLogLevelError);
+        }
+    }
+}
+
+void MavLinkRouterImpl::getTarget(const MavLinkMessage& msg, int& targetSystem, int& targetComponent)
+{
+    targetSystem = 0;
+    targetComponent = 0;
+    const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(msg.msgid);
+    if (entry == nullptr) {
+        // unknown messages are treated as broadcast.
+        return;
+    }
+    // the payload past msg.len is zero filled, so trimmed MAVLink2 payloads read as target 0 (broadcast).
+    const uint8_t* payload = reinterpret_cast<const uint8_t*>(&msg.payload64[0]);
+    if ((entry->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_SYSTEM) != 0) {
+        targetSystem = payload[entry->target_system_ofs];
+    }
+    if ((entry->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_COMPONENT) != 0) {
+        targetComponent = payload[entry->target_component_ofs];
+    }
+}
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef MavLinkCom_MavLinkRouterImpl_hpp
+#define MavLinkCom_MavLinkRouterImpl_hpp
+
+#include <memory>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include "MavLinkRouter.hpp"
+#include "MavLinkConnection.hpp"
+
+using namespace mavlinkcom;
+
+namespace mavlinkcom_impl {
+
+    class MavLinkRouterImpl
+    {
+    public:
+        MavLinkRouterImpl();
+        ~MavLinkRouterImpl();
+
+        void addLink(std::shared_ptr<MavLinkConnection> link);
+        void removeLink(std::shared_ptr<MavLinkConnection> link);
+        int subscribe(int systemId, MessageHandler handler);
+        void unsubscribe(int id);
+        std::shared_ptr<MavLinkConnection> getLink(int systemId);
+        std::vector<int> getSystems();
+        void sendMessage(const MavLinkMessageBase& msg);
+        void sendMessage(const MavLinkMessage& msg);
+        MavLinkRouterStats getStats();
+        void close();
+
+    private:
+        struct LinkEntry {
+            std::shared_ptr<MavLinkConnection> link;
+            int subscription;
+        };
+        struct HandlerEntry {
+            int id;
+            MessageHandler handler;
+        };
+        // subscribers are copied on write so the links can dispatch without holding the lock.
+        typedef std::shared_ptr<const std::vector<HandlerEntry>> HandlerList;
+
+        void handleMessage(std::shared_ptr<MavLinkConnection> link, const MavLinkMessage& msg);
+        void dispatch(const HandlerList& handlers, std::shared_ptr<MavLinkConnection> link, const MavLinkMessage& msg);
+        void route(std::shared_ptr<MavLinkConnection> source, const MavLinkMessage& msg);
+        static void getTarget(const MavLinkMessage& msg, int& targetSystem, int& targetComponent);
+        static int routeKey(int systemId, int componentId) {
+            return (systemId << 8) | componentId;
+        }
+
+        std::mutex mutex_;
+        std::vector<LinkEntry> links_;
+        // the link each system/component was last heard on.
+        std::map<int, std::shared_ptr<MavLinkConnection>> routes_;
+        // the subscribers for each system id, 0 means all systems.
+        std::unordered_map<int, HandlerList> handlers_;
+        int next_handler_id_ = 0;
+
+        std::atomic<long> messages_received_{ 0 };
+        std::atomic<long> messages_dispatched_{ 0 };
+        std::atomic<long> messages_forwarded_{ 0 };
+        std::atomic<long> messages_dropped_{ 0 };
+    };
+}
+
+#endif
@@ -0,0 +1,272 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "MavLinkSigning.hpp"
+#include <string.h>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace mavlinkcom_impl;
+
+namespace {
+
+    const uint32_t round_constants[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    inline uint32_t rotr(uint32_t x, int n) {
+        return (x >> n) | (x << (32 - n));
+    }
+
+    inline uint32_t loadBigEndian(const uint8_t* p) {
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) | (static_cast<uint32_t>(p[2]) << 8) | p[3];
+    }
+
+    // 10 microsecond ticks between the unix epoch and 1 January 2015 GMT.
+    const uint64_t Epoch2015 = 1420070400ULL * 100000ULL;
+
+    // a new stream is only accepted if its timestamp is less than a minute behind ours.
+    const uint64_t NewStreamLimit = 60ULL * 100000ULL;
+}
+
+MavLinkSha256::MavLinkSha256()
+{
+    reset();
+}
+
+void MavLinkSha256::reset()
+{
+    state_[0] = 0x6a09e667;
+    state_[1] = 0xbb67ae85;
+    state_[2] = 0x3c6ef372;
+    state_[3] = 0xa54ff53a;
+    state_[4] = 0x510e527f;
+    state_[5] = 0x9b05688c;
+    state_[6] = 0x1f83d9ab;
+    state_[7] = 0x5be0cd19;
+    length_ = 0;
+    buffered_ = 0;
+}
+
+void MavLinkSha256::transform(const uint8_t block[64])
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = loadBigEndian(block + i * 4);
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t w15 = w[i - 15];
+        uint32_t w2 = w[i - 2];
+        w[i] = w[i - 16] + (rotr(w15, 7) ^ rotr(w15, 18) ^ (w15 >> 3)) + w[i - 7] + (rotr(w2, 17) ^ rotr(w2, 19) ^ (w2 >> 10));
+    }
+
+    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+    uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+    // eight rounds at a time with the variables renamed instead of shifted along.
+#define MAVLINK_SHA256_ROUND(a, b, c, d, e, f, g, h, i) { \
+        uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + (g ^ (e & (f ^ g))) + round_constants[i] + w[i]; \
+        d += t1; \
+        h = t1 + (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) | (c & (a | b))); }
+    for (int i = 0; i < 64; i += 8) {
+        MAVLINK_SHA256_ROUND(a, b, c, d, e, f, g, h, i);
+        MAVLINK_SHA256_ROUND(h, a, b, c, d, e, f, g, i + 1);
+        MAVLINK_SHA256_ROUND(g, h, a, b, c, d, e, f, i + 2);
+        MAVLINK_SHA256_ROUND(f, g, h, a, b, c, d, e, i + 3);
+        MAVLINK_SHA256_ROUND(e, f, g, h, a, b, c, d, i + 4);
+        MAVLINK_SHA256_ROUND(d, e, f, g, h, a, b, c, i + 5);
+        MAVLINK_SHA256_ROUND(c, d, e, f, g, h, a, b, i + 6);
+        MAVLINK_SHA256_ROUND(b, c, d, e, f, g, h, a, i + 7);
+    }
+#undef MAVLINK_SHA256_ROUND
+    state_[0] += a;
+    state_[1] += b;
+    state_[2] += c;
+    state_[3] += d;
+    state_[4] += e;
+    state_[5] += f;
+    state_[6] += g;
+    state_[7] += h;
+}
+
+void MavLinkSha256::update(const uint8_t* data, size_t length)
+{
+    length_ += length;
+    if (buffered_ > 0) {
+        size_t n = std::min(length, sizeof(buffer_) - buffered_);
+        ::memcpy(buffer_ + buffered_, data, n);
+        buffered_ += n;
+        data += n;
+        length -= n;
+        if (buffered_ < sizeof(buffer_)) {
+            return;
+        }
+        transform(buffer_);
+        buffered_ = 0;
+    }
+    while (length >= sizeof(buffer_)) {
+        transform(data);
+        data += sizeof(buffer_);
+        length -= sizeof(buffer_);
+    }
+    ::memcpy(buffer_, data, length);
+    buffered_ = length;
+}
+
+void MavLinkSha256::pad()
+{
+    uint64_t bits = length_ * 8;
+    buffer_[buffered_++] = 0x80;
+    if (buffered_ > 56) {
+        ::memset(buffer_ + buffered_, 0, sizeof(buffer_) - buffered_);
+        transform(buffer_);
+        buffered_ = 0;
+    }
+    ::memset(buffer_ + buffered_, 0, 56 - buffered_);
+    for (int i = 0; i < 8; i++) {
+        buffer_[63 - i] = static_cast<uint8_t>(bits >> (i * 8));
+    }
+    transform(buffer_);
+    buffered_ = 0;
+}
+
+void MavLinkSha256::finish(uint8_t hash[32])
+{
+    pad();
+    for (int i = 0; i < 8; i++) {
+        hash[i * 4] = static_cast<uint8_t>(state_[i] >> 24);
+        hash[i * 4 + 1] = static_cast<uint8_t>(state_[i] >> 16);
+        hash[i * 4 + 2] = static_cast<uint8_t>(state_[i] >> 8);
+        hash[i * 4 + 3] = static_cast<uint8_t>(state_[i]);
+    }
+}
+
+void MavLinkSha256::finish48(uint8_t hash[6])
+{
+    pad();
+    hash[0] = static_cast<uint8_t>(state_[0] >> 24);
+    hash[1] = static_cast<uint8_t>(state_[0] >> 16);
+    hash[2] = static_cast<uint8_t>(state_[0] >> 8);
+    hash[3] = static_cast<uint8_t>(state_[0]);
+    hash[4] = static_cast<uint8_t>(state_[1] >> 24);
+    hash[5] = static_cast<uint8_t>(state_[1] >> 16);
+}
+
+MavLinkSigning::MavLinkSigning(const std::vector<uint8_t>& secretKey, uint8_t linkId, uint64_t timestamp)
+    : link_id_(linkId), timestamp_(std::max(timestamp, currentTimestamp()))
+{
+    if (secretKey.size() != 32) {
+        throw std::runtime_error("MAVLink signing key must be 32 bytes");
+    }
+    keyed_.update(secretKey.data(), secretKey.size());
+}
+
+uint64_t MavLinkSigning::currentTimestamp()
+{
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    uint64_t ticks = static_cast<uint64_t>(micros) / 10;
+    return ticks > Epoch2015 ? ticks - Epoch2015 : 0;
+}
+
+uint64_t MavLinkSigning::getTimestamp()
+{
+    return timestamp_;
+}
+
+void MavLinkSigning::advanceTimestamp(uint64_t timestamp)
+{
+    uint64_t current = timestamp_;
+    while (timestamp > current && !timestamp_.compare_exchange_weak(current, timestamp)) {
+    }
+}
+
+void MavLinkSigning::sign(const uint8_t* header, size_t headerLength, const uint8_t* payload, size_t payloadLength, const uint8_t ck[2], uint8_t signature[13])
+{
+    // every signature needs a new timestamp, and it should keep up with the clock so a restarted
+    // sender does not look like a replay.
+    uint64_t now = currentTimestamp();
+    uint64_t current = timestamp_;
+    uint64_t next;
+    do {
+        next = std::max(current + 1, now);
+    } while (!timestamp_.compare_exchange_weak(current, next));
+
+    signature[0] = link_id_;
+    for (int i = 0; i < 6; i++) {
+        signature[1 + i] = static_cast<uint8_t>(next >> (i * 8));
+    }
+    MavLinkSha256 sha = keyed_;
+    sha.update(header, headerLength);
+    sha.update(payload, payloadLength);
+    sha.update(ck, 2);
+    sha.update(signature, 7);
+    sha.finish48(signature + 7);
+}
+
+bool MavLinkSigning::check(const uint8_t* frame, size_t length, const uint8_t signature[13], uint8_t sysid, uint8_t compid)
+{
+    uint8_t hash[6];
+    MavLinkSha256 sha = keyed_;
+    sha.update(frame, length);
+    sha.update(signature, 7);
+    sha.finish48(hash);
+    uint8_t diff = 0;
+    for (int i = 0; i < 6; i++) {
+        diff |= hash[i] ^ signature[7 + i];
+    }
+    if (diff != 0) {
+        return false;
+    }
+
+    uint64_t timestamp = 0;
+    for (int i = 0; i < 6; i++) {
+        timestamp |= static_cast<uint64_t>(signature[1 + i]) << (i * 8);
+    }
+    uint32_t key = (static_cast<uint32_t>(signature[0]) << 16) | (sysid << 8) | compid;
+    auto found = streams_.find(key);
+    if (found == streams_.end()) {
+        if (streams_.size() >= MaxStreams || timestamp + NewStreamLimit < timestamp_) {
+            return false;
+        }
+        streams_[key] = Stream{ timestamp, 1 };
+    }
+    else {
+        Stream& stream = found->second;
+        if (timestamp > stream.highest) {
+            uint64_t shift = timestamp - stream.highest;
+            stream.seen = shift >= ReplayWindow ? 1 : (stream.seen << shift) | 1;
+            stream.highest = timestamp;
+        }
+        else {
+            uint64_t age = stream.highest - timestamp;
+            if (age >= ReplayWindow || ((stream.seen >> age) & 1) != 0) {
+                // too old, or a replay.
+                return false;
+            }
+            stream.seen |= 1ULL << age;
+        }
+    }
+
+    // our next timestamp must be at least the newest one we have accepted.
+    advanceTimestamp(timestamp);
+    return true;
+}
+
+bool MavLinkSigning::acceptUnsigned(uint32_t msgid)
+{
+    std::lock_guard<std::mutex> guard(accept_mutex_);
+    return accept_unsigned_ != nullptr && accept_unsigned_(static_cast<int>(msgid));
+}
+
+void MavLinkSigning::setAcceptUnsignedHandler(std::function<bool(int msgid)> handler)
+{
+    std::lock_guard<std::mutex> guard(accept_mutex_);
+    accept_unsigned_ = handler;
+}
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#ifndef MavLinkCom_MavLinkSigning_hpp
+#define MavLinkCom_MavLinkSigning_hpp
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
+
+namespace mavlinkcom_impl {
+
+    // SHA-256 that can be copied part way through, so the secret key only has to be hashed once per link.
+    class MavLinkSha256
+    {
+    public:
+        MavLinkSha256();
+        void reset();
+        void update(const uint8_t* data, size_t length);
+        void finish(uint8_t hash[32]);
+        // MAVLink signatures only use the first 48 bits of the hash.
+        void finish48(uint8_t hash[6]);
+
+    private:
+        void transform(const uint8_t block[64]);
+        void pad();
+
+        uint32_t state_[8];
+        uint64_t length_;
+        uint8_t buffer_[64];
+        size_t buffered_;
+    };
+
+    // The MAVLink2 signing state of one link, see https://mavlink.io/en/guide/message_signing.html.
+    // sign can be called from any thread, check is only called from the thread reading the link.
+    class MavLinkSigning
+    {
+    public:
+        MavLinkSigning(const std::vector<uint8_t>& secretKey, uint8_t linkId, uint64_t timestamp);
+
+        // fill in the 13 byte signature block for a frame, the header includes the start byte.
+        void sign(const uint8_t* header, size_t headerLength, const uint8_t* payload, size_t payloadLength, const uint8_t ck[2], uint8_t signature[13]);
+
+        // check the signature of a frame, frame points at the start byte and length covers the header, payload and
+        // crc.  The timestamp must be new for the (link id, sysid, compid) stream, frames that arrive a little out of
+        // order are accepted once.
+        bool check(const uint8_t* frame, size_t length, const uint8_t signature[13], uint8_t sysid, uint8_t compid);
+
+        bool acceptUnsigned(uint32_t msgid);
+        void setAcceptUnsignedHandler(std::function<bool(int msgid)> handler);
+
+        // the timestamp for the next signature, in 10 microsecond ticks since 1 January 2015 GMT.
+        uint64_t getTimestamp();
+        static uint64_t currentTimestamp();
+
+        static const int ReplayWindow = 64;
+        static const size_t MaxStreams = 256;
+
+    private:
+        struct Stream {
+            uint64_t highest; // newest timestamp seen on this stream
+            uint64_t seen; // bit n is set if highest - n was seen
+        };
+        void advanceTimestamp(uint64_t timestamp);
+
+        MavLinkSha256 keyed_; // the hash state after the secret key
+        uint8_t link_id_;
+        std::atomic<uint64_t> timestamp_;
+        std::unordered_map<uint32_t, Stream> streams_;
+        std::mutex accept_mutex_;
+        std::function<bool(int msgid)> accept_unsigned_;
+    };
+}
+
+#endif
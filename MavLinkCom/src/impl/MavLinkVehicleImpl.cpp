@@ -8,6 +8,7 @@
 #include "../serial_com/UdpClientPort.hpp"
 #include <exception>
 #include <cstring>
+#include <algorithm>
 using namespace mavlink_utils;
 
 using namespace mavlinkcom_impl;
@@ -109,6 +110,7 @@ enum PX4_CUSTOM_SUB_MODE_AUTO {
 MavLinkVehicleImpl::MavLinkVehicleImpl(int localSystemId, int localComponentId)
     : MavLinkNodeImpl(localSystemId, localComponentId)
 {
+    snapshot_ = std::make_shared<VehicleStateSnapshot>();
 }
 
 MavLinkVehicleImpl::~MavLinkVehicleImpl()
@@ -150,12 +152,8 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
 {
     unused(connection);
     //status messages should usually be only sent by actual PX4. However if someone else is sending it to, we should listen it.
-    //in future it would be good to have ability to add system IDs we are interested in
-    //if (msg.sysid != getTargetSystemId())
-    //{
-    //	// we only care about messages from our intended remote node. 
-    //	return;
-    //}
+    //when there is more than one vehicle on the link, connect this node through a MavLinkRouter so we only
+    //see the messages from our own system.
 
     switch (msg.msgid) {
     case MavLinkHeartbeat::kMessageId: { // MAVLINK_MSG_ID_HEARTBEAT:
@@ -164,12 +162,14 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
         MavLinkHeartbeat heartbeat;
         heartbeat.decode(msg);
 
-        vehicle_state_.mode = heartbeat.base_mode;
-
         bool armed = (heartbeat.base_mode & static_cast<uint8_t>(MAV_MODE_FLAG::MAV_MODE_FLAG_SAFETY_ARMED)) != 0;
         std::lock_guard<std::mutex> guard(state_mutex_);
+        if (vehicle_state_.mode != heartbeat.base_mode) {
+            stateChanged(VehicleStateMode);
+            vehicle_state_.mode = heartbeat.base_mode;
+        }
         if (vehicle_state_.controls.armed != armed) {
-            state_version_++;
+            stateChanged(VehicleStateControls);
             vehicle_state_.controls.armed = armed;
         }
         if (heartbeat.autopilot == static_cast<uint8_t>(MAV_AUTOPILOT::MAV_AUTOPILOT_PX4)) {
@@ -179,6 +179,7 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
 
             bool isOffboard = (mode == PX4_CUSTOM_MAIN_MODE_OFFBOARD);
             if (vehicle_state_.controls.offboard != isOffboard) {
+                stateChanged(VehicleStateControls);
                 vehicle_state_.controls.offboard = isOffboard;
                 Utils::log("MavLinkVehicle: is no longer in offboard mode\n");
             }
@@ -186,6 +187,7 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
                 if (control_request_sent_) {
                     // user may have changed modes on us! So we need to honor that and not
                     // try and take it back.
+                    stateChanged(VehicleStateControls);
                     vehicle_state_.controls.offboard = false;
                     control_requested_ = false;
                     control_request_sent_ = false;
@@ -203,7 +205,7 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
         att.decode(msg);
 
         std::lock_guard<std::mutex> guard(state_mutex_);
-        state_version_++;
+        stateChanged(VehicleStateAttitude);
         updateReadStats(msg);
         vehicle_state_.attitude.roll = att.roll;
         vehicle_state_.attitude.pitch = att.pitch;
@@ -220,7 +222,7 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
         cnt.decode(msg);
 
         std::lock_guard<std::mutex> guard(state_mutex_);
-        state_version_++;
+        stateChanged(VehicleStateLocalEstimate);
         updateReadStats(msg);
         vehicle_state_.local_est.acc.x = cnt.x_acc;
         vehicle_state_.local_est.acc.y = cnt.x_acc;
@@ -232,7 +234,7 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
         MavLinkLocalPositionNed value;
         value.decode(msg);
         std::lock_guard<std::mutex> guard(state_mutex_);
-        state_version_++;
+        stateChanged(VehicleStateLocalEstimate);
         updateReadStats(msg);
         vehicle_state_.local_est.pos.x = value.x;
         vehicle_state_.local_est.pos.y = value.y;
@@ -247,7 +249,7 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
         MavLinkGlobalPositionInt pos;
         pos.decode(msg);
         std::lock_guard<std::mutex> guard(state_mutex_);
-        state_version_++;
+        stateChanged(VehicleStateGlobalEstimate);
         updateReadStats(msg);
         vehicle_state_.global_est.pos.lat = static_cast<float>(pos.lat) / 1E7f;
         vehicle_state_.global_est.pos.lon = static_cast<float>(pos.lon) / 1E7f;
@@ -264,7 +266,7 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
         MavLinkRcChannelsScaled ch;
         ch.decode(msg);
         std::lock_guard<std::mutex> guard(state_mutex_);
-        state_version_++;
+        stateChanged(VehicleStateRc);
         updateReadStats(msg);
         int port = ch.port;
         // we can store up to 16 channels in rc_channels_scaled.
@@ -285,7 +287,9 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
     case MavLinkRcChannels::kMessageId: { // MAVLINK_MSG_ID_RC_CHANNELS:
         MavLinkRcChannels ch;
         ch.decode(msg);
-
+        std::lock_guard<std::mutex> guard(state_mutex_);
+        stateChanged(VehicleStateRc);
+        updateReadStats(msg);
         vehicle_state_.rc.rc_channels_count = ch.chancount;
         vehicle_state_.rc.rc_signal_strength = ch.rssi;
         vehicle_state_.rc.updated_on = ch.time_boot_ms;
@@ -297,7 +301,7 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
         MavLinkServoOutputRaw servo;
         servo.decode(msg);
         std::lock_guard<std::mutex> guard(state_mutex_);
-        state_version_++;
+        stateChanged(VehicleStateServo);
         updateReadStats(msg);
         vehicle_state_.servo.servo_raw[0] = servo.servo1_raw; vehicle_state_.servo.servo_raw[1] = servo.servo2_raw; vehicle_state_.servo.servo_raw[2] = servo.servo3_raw; vehicle_state_.servo.servo_raw[3] = servo.servo4_raw;
         vehicle_state_.servo.servo_raw[4] = servo.servo5_raw; vehicle_state_.servo.servo_raw[5] = servo.servo6_raw; vehicle_state_.servo.servo_raw[6] = servo.servo7_raw; vehicle_state_.servo.servo_raw[7] = servo.servo8_raw;
@@ -311,7 +315,7 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
         MavLinkVfrHud vfrhud;
         vfrhud.decode(msg);
         std::lock_guard<std::mutex> guard(state_mutex_);
-        state_version_++;
+        stateChanged(VehicleStateVfrHud);
         updateReadStats(msg);
         vehicle_state_.vfrhud.true_airspeed = vfrhud.airspeed;
         vehicle_state_.vfrhud.groundspeed = vfrhud.groundspeed;
@@ -329,7 +333,7 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
         MavLinkAltitude altitude;
         altitude.decode(msg);
         std::lock_guard<std::mutex> guard(state_mutex_);
-        state_version_++;
+        stateChanged(VehicleStateAltitude);
         updateReadStats(msg);
         vehicle_state_.altitude.altitude_amsl = altitude.altitude_amsl;
         vehicle_state_.altitude.altitude_local = altitude.altitude_local;
@@ -348,7 +352,7 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
         MavLinkHomePosition home;
         home.decode(msg);
         std::lock_guard<std::mutex> guard(state_mutex_);
-        state_version_++;
+        stateChanged(VehicleStateHome);
         updateReadStats(msg);
         vehicle_state_.home.global_pos.lat = static_cast<float>(home.latitude) / 1E7f;
         vehicle_state_.home.global_pos.lon = static_cast<float>(home.longitude) / 1E7f;
@@ -379,7 +383,7 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
         bool landed = extstatus.landed_state == static_cast<int>(MAV_LANDED_STATE::MAV_LANDED_STATE_ON_GROUND);
         std::lock_guard<std::mutex> guard(state_mutex_);
         if (vehicle_state_.controls.landed != landed) {
-            state_version_++;
+            stateChanged(VehicleStateControls);
             updateReadStats(msg);
             vehicle_state_.controls.landed = landed;
         }
@@ -409,7 +413,7 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
         MavLinkHilControls value;
         value.decode(msg);
         std::lock_guard<std::mutex> guard(state_mutex_);
-        state_version_++;
+        stateChanged(VehicleStateControls);
         updateReadStats(msg);
         vehicle_state_.controls.actuator_controls[0] = value.roll_ailerons;
         vehicle_state_.controls.actuator_controls[1] = value.pitch_elevator;
@@ -432,20 +436,24 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
         ack.decode(msg);
         if (ack.command == MavCmdNavGuidedEnable::kCommandId)
         {
+            std::lock_guard<std::mutex> guard(state_mutex_);
             MAV_RESULT ackResult = static_cast<MAV_RESULT>(ack.result);
             if (ackResult == MAV_RESULT::MAV_RESULT_TEMPORARILY_REJECTED) {
                 Utils::log("### command MavCmdNavGuidedEnable result: MAV_RESULT_TEMPORARILY_REJECTED");
             }
             else if (ackResult == MAV_RESULT::MAV_RESULT_UNSUPPORTED) {
                 Utils::log("### command MavCmdNavGuidedEnable result: MAV_RESULT_UNSUPPORTED");
+                stateChanged(VehicleStateControls);
                 vehicle_state_.controls.offboard = false;
             }
             else if (ackResult == MAV_RESULT::MAV_RESULT_FAILED) {
                 Utils::log("### command MavCmdNavGuidedEnable result: MAV_RESULT_FAILED");
+                stateChanged(VehicleStateControls);
                 vehicle_state_.controls.offboard = false;
             }
             else if (ackResult == MAV_RESULT::MAV_RESULT_ACCEPTED) {
                 Utils::log("### command MavCmdNavGuidedEnableresult: MAV_RESULT_ACCEPTED");
+                stateChanged(VehicleStateControls);
                 vehicle_state_.controls.offboard = true;
             }
         }
@@ -455,7 +463,7 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
         MavLinkAttPosMocap mocap;
         mocap.decode(msg);
         std::lock_guard<std::mutex> guard(state_mutex_);
-        state_version_++;
+        stateChanged(VehicleStateMocap);
         updateReadStats(msg);
         vehicle_state_.mocap.pose.pos.x = mocap.x;
         vehicle_state_.mocap.pose.pos.y = mocap.y;
@@ -467,12 +475,16 @@ void MavLinkVehicleImpl::handleMessage(std::shared_ptr<MavLinkConnection> connec
     default:
         break;
     }
+
+    publishState();
 }
 
 void MavLinkVehicleImpl::writeMessage(MavLinkMessageBase& msg, bool update_stats)
 {
     sendMessage(msg);
     if (update_stats) {
+        // stats are not a group of their own, they show up in the next published snapshot.
+        std::lock_guard<std::mutex> guard(state_mutex_);
         vehicle_state_.stats.last_write_msg_id = msg.msgid;
         vehicle_state_.stats.last_write_msg_time = getTimeStamp();
     }
@@ -488,8 +500,9 @@ AsyncResult<bool> MavLinkVehicleImpl::armDisarm(bool arm)
 AsyncResult<bool> MavLinkVehicleImpl::takeoff(float z, float pitch, float yaw)
 {
     // careful here, we are doing a tricky conversion from local coordinates to global coordinates.
-    float deltaZ = z - vehicle_state_.local_est.pos.z;
-    float targetAlt = vehicle_state_.home.global_pos.alt - deltaZ;
+    VehicleState state = getVehicleState();
+    float deltaZ = z - state.local_est.pos.z;
+    float targetAlt = state.home.global_pos.alt - deltaZ;
     Utils::log(Utils::stringf("Take off to %f", targetAlt));
     MavCmdNavTakeoff cmd{};
     cmd.MinimumPitch = pitch;
@@ -578,7 +591,14 @@ void MavLinkVehicleImpl::releaseControl()
 {
     control_requested_ = false;
     control_request_sent_ = false;
-    vehicle_state_.controls.offboard = false;
+    {
+        std::lock_guard<std::mutex> guard(state_mutex_);
+        if (vehicle_state_.controls.offboard) {
+            stateChanged(VehicleStateControls);
+            vehicle_state_.controls.offboard = false;
+        }
+    }
+    publishState();
     MavCmdNavGuidedEnable cmd{};
     cmd.OnOff = 0;
     sendCommand(cmd);
@@ -591,7 +611,7 @@ void MavLinkVehicleImpl::checkOffboard()
         throw std::runtime_error("You must call requestControl first.");
     }
 
-    if (control_requested_ && !vehicle_state_.controls.offboard)
+    if (control_requested_ && !getVehicleState().controls.offboard)
     {
         // Ok, now's the time to actually request it since the caller is about to send MavLinkSetPositionTargetGlobalInt, but
         // PX4 will reject this thinking 'offboard_control_loss_timeout' because we haven't actually sent any offboard messages
@@ -679,10 +699,11 @@ AsyncResult<bool> MavLinkVehicleImpl::setMode(int mode, int customMode, int cust
     control_requested_ = false;
     control_request_sent_ = false;
 
-    if ((vehicle_state_.mode & static_cast<int>(MAV_MODE_FLAG::MAV_MODE_FLAG_HIL_ENABLED)) != 0) {
+    int currentMode = getVehicleState().mode;
+    if ((currentMode & static_cast<int>(MAV_MODE_FLAG::MAV_MODE_FLAG_HIL_ENABLED)) != 0) {
         mode |= static_cast<int>(MAV_MODE_FLAG::MAV_MODE_FLAG_HIL_ENABLED); // must preserve this flag.
     }
-    if ((vehicle_state_.mode & static_cast<uint8_t>(MAV_MODE_FLAG::MAV_MODE_FLAG_SAFETY_ARMED)) != 0) {
+    if ((currentMode & static_cast<uint8_t>(MAV_MODE_FLAG::MAV_MODE_FLAG_SAFETY_ARMED)) != 0) {
         mode |= static_cast<int>(MAV_MODE_FLAG::MAV_MODE_FLAG_SAFETY_ARMED); // must preserve this flag.
     }
     requested_mode_ = (customMode & 0xff) + ((customSubMode & 0xff) << 8);
@@ -887,16 +908,126 @@ void MavLinkVehicleImpl::resetCommandParams(MavLinkCommandLong& cmd)
     cmd.param1 = cmd.param2 = cmd.param3 = cmd.param4 = cmd.param5 = cmd.param6 = cmd.param7 = 0;
 }
 
-const VehicleState& MavLinkVehicleImpl::getVehicleState()
+VehicleState MavLinkVehicleImpl::getVehicleState()
 {
-    std::lock_guard<std::mutex> guard(state_mutex_);
-    return vehicle_state_; // return a snapshot.
+    std::shared_ptr<const VehicleStateSnapshot> snapshot;
+    {
+        std::lock_guard<std::mutex> guard(snapshot_mutex_);
+        snapshot = snapshot_;
+    }
+    return snapshot->state;
+}
+
+bool MavLinkVehicleImpl::getVehicleStateIfNewer(int& version, VehicleState& state)
+{
+    std::shared_ptr<const VehicleStateSnapshot> snapshot;
+    {
+        std::lock_guard<std::mutex> guard(snapshot_mutex_);
+        snapshot = snapshot_;
+    }
+    if (snapshot->version == version) {
+        return false;
+    }
+    state = snapshot->state;
+    version = snapshot->version;
+    return true;
 }
 
 int MavLinkVehicleImpl::getVehicleStateVersion()
 {
-    std::lock_guard<std::mutex> guard(state_mutex_);
-    return state_version_; 
+    std::lock_guard<std::mutex> guard(snapshot_mutex_);
+    return snapshot_->version;
+}
+
+int MavLinkVehicleImpl::getVehicleStateVersion(VehicleStateGroup group)
+{
+    std::lock_guard<std::mutex> guard(snapshot_mutex_);
+    for (int i = 0; i < VehicleStateGroupCount; i++) {
+        if (group == (1 << i)) {
+            return snapshot_->group_versions[i];
+        }
+    }
+    throw std::runtime_error(Utils::stringf("getVehicleStateVersion expects a single VehicleStateGroup, but got 0x%x", static_cast<int>(group)));
+}
+
+int MavLinkVehicleImpl::subscribeToStateChanges(int groups, VehicleStateHandler handler)
+{
+    std::lock_guard<std::mutex> guard(listener_mutex_);
+    StateListener listener;
+    listener.id = ++next_listener_id_;
+    listener.groups = groups;
+    listener.handler = handler;
+    listeners_.push_back(listener);
+    return listener.id;
+}
+
+void MavLinkVehicleImpl::unsubscribeFromStateChanges(int id)
+{
+    std::lock_guard<std::mutex> guard(listener_mutex_);
+    for (auto ptr = listeners_.begin(); ptr != listeners_.end(); ptr++)
+    {
+        if (ptr->id == id) {
+            listeners_.erase(ptr);
+            break;
+        }
+    }
+}
+
+void MavLinkVehicleImpl::stateChanged(int groups)
+{
+    state_version_++;
+    changed_groups_ |= groups;
+    for (int i = 0; i < VehicleStateGroupCount; i++) {
+        if ((groups & (1 << i)) != 0) {
+            group_versions_[i]++;
+        }
+    }
+}
+
+void MavLinkVehicleImpl::publishState()
+{
+    std::shared_ptr<const VehicleStateSnapshot> published;
+    int changed = 0;
+    {
+        std::lock_guard<std::mutex> guard(state_mutex_);
+        changed = changed_groups_;
+        if (changed == 0) {
+            return;
+        }
+        changed_groups_ = 0;
+
+        // readers may still be copying the previous snapshot, so never write into it.
+        std::shared_ptr<VehicleStateSnapshot> snapshot = std::make_shared<VehicleStateSnapshot>();
+        snapshot->state = vehicle_state_;
+        snapshot->version = state_version_;
+        std::copy(group_versions_, group_versions_ + VehicleStateGroupCount, snapshot->group_versions);
+
+        // the previous snapshot is freed after snapshot_mutex_ is released so readers don't wait on it.
+        std::shared_ptr<const VehicleStateSnapshot> previous;
+        {
+            std::lock_guard<std::mutex> snapshotGuard(snapshot_mutex_);
+            previous = snapshot_;
+            snapshot_ = snapshot;
+        }
+        published = snapshot;
+    }
+
+    std::vector<StateListener> listeners;
+    {
+        std::lock_guard<std::mutex> guard(listener_mutex_);
+        listeners = listeners_;
+    }
+    for (auto ptr = listeners.begin(); ptr != listeners.end(); ptr++)
+    {
+        if ((ptr->groups & changed) != 0) {
+            try {
+                ptr->handler(published->state, changed);
+            }
+            catch (std::exception& e) {
+                Utils::log(Utils::stringf("MavLinkVehicle: Error handling state change, details: %s", e.what()), Utils::kLogLevelError);
+            }
+        }
+    }
 }
 
 void MavLinkVehicleImpl::updateReadStats(const MavLinkMessage& msg)
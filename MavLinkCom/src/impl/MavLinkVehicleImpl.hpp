@@ -18,10 +18,17 @@
 #include <mutex>
 #include <memory>
 #include "AsyncResult.hpp"
+#include "MavLinkVehicle.hpp"
 
 using namespace mavlinkcom;
 
 namespace mavlinkcom_impl {
+	struct VehicleStateSnapshot {
+		VehicleState state;
+		int version = 0;
+		int group_versions[VehicleStateGroupCount] = { 0 };
+	};
+
 	class MavLinkVehicleImpl : public MavLinkNodeImpl {
 	public:
 		MavLinkVehicleImpl(int localSystemId, int localComponentId);
@@ -67,7 +74,11 @@ namespace mavlinkcom_impl {
         void writeMessage(MavLinkMessageBase& message, bool update_stats = true);
 
 		int getVehicleStateVersion();
-		const VehicleState& getVehicleState();
+		int getVehicleStateVersion(VehicleStateGroup group);
+		VehicleState getVehicleState();
+		bool getVehicleStateIfNewer(int& version, VehicleState& state);
+		int subscribeToStateChanges(int groups, VehicleStateHandler handler);
+		void unsubscribeFromStateChanges(int id);
 
 		uint32_t getTimeStamp();
 	private:
@@ -76,10 +87,31 @@ namespace mavlinkcom_impl {
 		void updateReadStats(const MavLinkMessage& msg);
 		void checkOffboard();
 		bool getRcSwitch(int channel, float threshold);
+		// called with state_mutex_ held to record which groups were modified.
+		void stateChanged(int groups);
+		// publish a new snapshot if anything changed and notify subscribers, called without state_mutex_ held.
+		void publishState();
 
 	private:
+		// vehicle_state_ is only touched with state_mutex_ held, readers get the last published snapshot instead.
 		std::mutex state_mutex_;
 		int state_version_ = 0;
+		int group_versions_[VehicleStateGroupCount] = { 0 };
+		int changed_groups_ = 0;
+
+		// the snapshots are immutable once published, so readers only hold snapshot_mutex_ long enough to
+		// copy the pointer.  Each publish allocates a new snapshot so a reader can never see it being overwritten.
+		std::mutex snapshot_mutex_;
+		std::shared_ptr<const VehicleStateSnapshot> snapshot_;
+
+		struct StateListener {
+			int id;
+			int groups;
+			VehicleStateHandler handler;
+		};
+		std::mutex listener_mutex_;
+		std::vector<StateListener> listeners_;
+		int next_listener_id_ = 0;
         bool control_requested_ = false;
 		bool control_request_sent_ = false;
         int requested_mode_ = 0;
@@ -260,6 +260,8 @@ public:
 			closesocket(sock);
 #else
 			int fd = static_cast<int>(sock);
+			// closing the socket does not wake up a thread blocked in recvfrom on Linux, but shutdown does.
+			::shutdown(fd, SHUT_RDWR);
 			::close(fd);
 #endif
 		}
@@ -35,6 +35,7 @@ class ImageType:
     Segmentation = 5
     SurfaceNormals = 6
     Infrared = 7
+    OpticalFlow = 8
 
 class DrivetrainType:
     MaxDegreeOfFreedom = 0
@@ -44,6 +45,16 @@ class LandedState:
     Landed = 0
     Flying = 1
 
+class ControlInterpolation:
+    Hold = 0
+    Linear = 1
+
+class ScheduledCommand:
+    Velocity = 0
+    VelocityZ = 1
+    RollPitchZ = 2
+    RollPitchThrottle = 3
+
 class Vector3r(MsgpackMixin):
     x_val = np.float32(0)
     y_val = np.float32(0)
@@ -157,6 +168,22 @@ class ImageResponse(MsgpackMixin):
     height = 0
     image_type = ImageType.Scene
 
+class EventPacket(MsgpackMixin):
+    start_time = np.uint64(0)
+    end_time = np.uint64(0)
+    width = 0
+    height = 0
+    events = b''
+
+    # returns time stamps in nanoseconds, x, y and polarity (1 for ON, 0 for OFF) of the events as numpy arrays
+    def unpack(self):
+        words = np.frombuffer(self.events, dtype='<u8', count=len(self.events) // 8)
+        time_stamps = np.uint64(self.start_time) + (words >> np.uint64(32)) * np.uint64(1000)
+        x = (words & np.uint64(0xffff)).astype(np.uint16)
+        y = ((words >> np.uint64(16)) & np.uint64(0x7fff)).astype(np.uint16)
+        polarity = ((words >> np.uint64(31)) & np.uint64(1)).astype(np.uint8)
+        return time_stamps, x, y, polarity
+
 class CarControls(MsgpackMixin):
     throttle = np.float32(0)
     steering = np.float32(0)
@@ -221,6 +248,27 @@ class MultirotorState(MsgpackMixin):
     landed_state = LandedState.Landed
     rc_data = RCData()
 
+class MultirotorSetpoint(MsgpackMixin):
+    x = 0.0
+    y = 0.0
+    z = 0.0
+    yaw = 0.0
+
+    def __init__(self, x = 0.0, y = 0.0, z = 0.0, yaw = 0.0):
+        self.x = x
+        self.y = y
+        self.z = z
+        self.yaw = yaw
+
+class ControlScheduleStatus(MsgpackMixin):
+    is_active = False
+    pending_count = 0
+    executed_count = 0
+    skipped_count = 0
+    last_lag = 0.0
+    max_lag = 0.0
+    last_setpoint_time = np.uint64(0)
+
 class CameraInfo(MsgpackMixin):
     pose = Pose()
     fov = -1
@@ -47,6 +47,13 @@ class VehicleClient:
     def simContinueForTime(self, seconds):
         self.client.call('simContinueForTime', seconds)
 
+    # logs every API call to a file on the simulator machine, see RpcSessionReplayer to replay it
+    def simStartRpcRecording(self, file_path):
+        self.client.call('simStartRpcRecording', file_path)
+
+    def simStopRpcRecording(self):
+        self.client.call('simStopRpcRecording')
+
     def getHomeGeoPoint(self, vehicle_name = ''):
         return GeoPoint.from_msgpack(self.client.call('getHomeGeoPoint', vehicle_name))
 
@@ -93,6 +100,11 @@ class VehicleClient:
         responses_raw = self.client.call('simGetImages', requests, vehicle_name)
         return [ImageResponse.from_msgpack(response_raw) for response_raw in responses_raw]
 
+    # DVS events of the camera since the previous call, emulated on the server from its Scene images
+    # the first call for a camera only starts the sequence, use EventPacket.unpack() to read the events
+    def simGetCameraEvents(self, camera_name, vehicle_name = ''):
+        return EventPacket.from_msgpack(self.client.call('simGetCameraEvents', camera_name, vehicle_name))
+
     def simSetCameraPose(self, camera_pose_obj, vehicle_name = ''):
         self.client.call('simSetCameraPose', camera_pose_obj, vehicle_name)
 
@@ -224,11 +236,31 @@ class VehicleClient:
         self.client.call('simSetBonePoses', poses, character_name)
     def simCharGetBonePoses(self, bone_names, character_name = ""):
         return self.client.call('simGetBonePoses', bone_names, character_name)
+    def simCharGetBoneNames(self, character_name = ""):
+        return self.client.call('simCharGetBoneNames', character_name)
+    def simCharSetBonePosesByIndex(self, bone_indices, poses, character_name = ""):
+        values = []
+        for pose in poses:
+            values += [pose.position.x_val, pose.position.y_val, pose.position.z_val,
+                pose.orientation.w_val, pose.orientation.x_val, pose.orientation.y_val, pose.orientation.z_val]
+        self.client.call('simCharSetBonePosesByIndex', bone_indices, values, character_name)
+    def simCharGetBonePosesByIndex(self, bone_indices, character_name = ""):
+        values = self.client.call('simCharGetBonePosesByIndex', bone_indices, character_name)
+        return [Pose(Vector3r(*values[i:i+3]), Quaternionr(values[i+4], values[i+5], values[i+6], values[i+3]))
+            for i in range(0, len(values), 7)]
+    def simCharPlayMotionClip(self, clip_file, scale = 1.0, rate = 1.0, loop = False, character_name = ""):
+        self.client.call('simCharPlayMotionClip', clip_file, scale, rate, loop, character_name)
+    def simCharSetMotionClipTimeWarp(self, play_times, clip_times, character_name = ""):
+        self.client.call('simCharSetMotionClipTimeWarp', play_times, clip_times, character_name)
+    def simCharStopMotionClip(self, character_name = ""):
+        self.client.call('simCharStopMotionClip', character_name)
 
     def cancelLastTask():
         self.client.call('cancelLastTask')
     def waitOnLastTask(timeout_sec = float('nan')):
         return self.client.call('waitOnLastTask', timeout_sec)
+    def getControlScheduleStatus(self, vehicle_name = ''):
+        return ControlScheduleStatus.from_msgpack(self.client.call('getControlScheduleStatus', vehicle_name))
 
     # legacy handling
     # TODO: remove below legacy wrappers in future major releases
@@ -346,6 +378,9 @@ class MultirotorClient(VehicleClient, object):
 
     def moveByRC(self, rcdata = RCData(), vehicle_name = ''):
         return self.client.call('moveByRC', rcdata, vehicle_name)
+    def moveByControlSchedule(self, times, setpoints, command = ScheduledCommand.Velocity, yaw_is_rate = True,
+        interpolation = ControlInterpolation.Hold, horizon = 0.0, vehicle_name = ''):
+        self.client.call('moveByControlSchedule', times, setpoints, command, yaw_is_rate, interpolation, horizon, vehicle_name)
         
     # query vehicle state
     def getMultirotorState(self, vehicle_name = ''):
@@ -360,6 +395,8 @@ class CarClient(VehicleClient, object):
 
     def setCarControls(self, controls, vehicle_name = ''):
         self.client.call('setCarControls', controls, vehicle_name)
+    def setCarControlSchedule(self, times, controls, interpolation = ControlInterpolation.Hold, horizon = 0.0, vehicle_name = ''):
+        self.client.call('setCarControlSchedule', times, controls, interpolation, horizon, vehicle_name)
 
     def getCarState(self, vehicle_name = ''):
         state_raw = self.client.call('getCarState', vehicle_name)
@@ -4,8 +4,9 @@
 // adapted for AirSim by Matthias Mueller
 
 #include "dsimage.h"
+#include <vector>
 
-void getDispMap2(DSI &dv1, DSI &dv2, int confThreshold, float * dispMap, unsigned char * confMap)
+void getDispMap2(DSI &dv1, DSI &dv2, int confThreshold, int doSubPixRefinement, float * dispMap, unsigned char * confMap)
 {
 	int cols = (int)dv1.m_cols;
 	int rows = (int)dv1.m_rows;
@@ -93,7 +94,7 @@ void getDispMap2(DSI &dv1, DSI &dv2, int confThreshold, float * dispMap, unsigne
 				// Local quadratic fit of cost and subpixel refinement.
 				double rDisp = bestplane;
 				double rCost = minval;
-				if (bestplane >= 1 && bestplane < planes - 1)
+				if (doSubPixRefinement && bestplane >= 1 && bestplane < planes - 1)
 				{
 					double yl = pV1[bestplane - 1] + pV2[bestplane - 1];
 					double xc = bestplane;
@@ -117,4 +118,57 @@ void getDispMap2(DSI &dv1, DSI &dv2, int confThreshold, float * dispMap, unsigne
 			}
 		}
 	}
-}
\ No newline at end of file
+}
+
+
+void leftRightCheck(DSI &dv1, DSI *dv2, int minDisparity, float tolerance, float * dispMap, unsigned char * confMap)
+{
+	int cols = (int)dv1.m_cols;
+	int rows = (int)dv1.m_rows;
+	int planes = (int)dv1.m_planes;
+
+#pragma omp parallel for schedule(dynamic,1)
+
+	for (int y = 1; y < rows - 1; y++)
+	{
+		uint64_t offset = y * cols;
+		float *pDisp = &(dispMap[offset]);
+		unsigned char *pConf = &(confMap[offset]);
+
+		// right pixel xr sees left pixel xr - disparity of plane d
+		std::vector<int> rightPlane(cols, -1);
+		for (int xr = 0; xr < cols; xr++)
+		{
+			int minval = INT_MAX;
+			for (int d = 0; d < planes; d++)
+			{
+				int xl = xr - (d + minDisparity);
+				if (xl < 1 || xl >= cols - 1)
+					continue;
+				int val = dv1(xl, y)[d];
+				if (dv2 != NULL)
+					val += (*dv2)(xl, y)[d];
+				if (val < minval)
+				{
+					minval = val;
+					rightPlane[xr] = d;
+				}
+			}
+		}
+
+		for (int x = 1; x < cols - 1; x++)
+		{
+			if (pDisp[x] == FLT_MAX)
+				continue;
+
+			// dispMap holds the plane minus the plane count
+			float plane = pDisp[x] + planes;
+			int xr = x + (int)floor(plane + 0.5f) + minDisparity;
+			if (xr < 0 || xr >= cols || rightPlane[xr] < 0 || fabs(plane - rightPlane[xr]) > tolerance)
+			{
+				pDisp[x] = FLT_MAX;
+				pConf[x] = 0;
+			}
+		}
+	}
+}
@@ -192,7 +192,12 @@ public:
 	short *m_data;
 };
 
-void getDispMap2(DSI &dv1, DSI &dv2, int confThreshold, float * dispMap, unsigned char * confMap);
+void getDispMap2(DSI &dv1, DSI &dv2, int confThreshold, int doSubPixRefinement, float * dispMap, unsigned char * confMap);
+
+// Invalidates left disparities that the right view doesn't agree with, which removes occluded pixels and most
+// mismatches. Right disparities are taken from the same aggregated costs (the sum of dv1 and dv2 when dv2 is given)
+// along the diagonals of the disparity space, so no second SGM pass is needed.
+void leftRightCheck(DSI &dv1, DSI *dv2, int minDisparity, float tolerance, float * dispMap, unsigned char * confMap);
 
 #endif
 
@@ -9,13 +9,58 @@
 #include "sgmstereo.h"
 #include "dsimage.h"
 #include "emmintrin.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// census costs are scaled so that the 24 bit Hamming distance spans the same range as the NCC cost
+static const short CENSUS_COST_SCALE = 10;
+static const int CENSUS_RADIUS = 2;
+
+static inline int popcount32(unsigned int v)
+{
+#ifdef _MSC_VER
+	return (int)__popcnt(v);
+#else
+	return __builtin_popcount(v);
+#endif
+}
+
+// one bit per neighbor in the 5x5 window, set when the neighbor is darker than the center; 0 near the border
+static void censusTransform(const unsigned char *img, int cols, int rows, unsigned int *census)
+{
+	memset(census, 0, cols * rows * sizeof(unsigned int));
+
+#pragma omp parallel for schedule(dynamic,1)
+	for (int y = CENSUS_RADIUS; y < rows - CENSUS_RADIUS; y++)
+	{
+		for (int x = CENSUS_RADIUS; x < cols - CENSUS_RADIUS; x++)
+		{
+			unsigned char center = img[y * cols + x];
+			unsigned int bits = 0;
+			for (int dy = -CENSUS_RADIUS; dy <= CENSUS_RADIUS; dy++)
+			{
+				const unsigned char *row = &img[(y + dy) * cols + x];
+				for (int dx = -CENSUS_RADIUS; dx <= CENSUS_RADIUS; dx++)
+				{
+					if (dx != 0 || dy != 0)
+						bits = (bits << 1) | (row[dx] < center ? 1u : 0u);
+				}
+			}
+			census[y * cols + x] = bits;
+		}
+	}
+}
 
 SGMStereo::SGMStereo(int _w, int _h, int minDisparity, int maxDisparity, int numDirections, int sgmConfidenceThreshold, int doSubPixRefinement,
 	float smoothness,
 	float penalty1,
 	float penalty2,
 	float alpha,
-	int doSequential)
+	int doSequential,
+	int costFunction,
+	int doLeftRightCheck,
+	float leftRightTolerance)
 {
 	m_w = _w;
 	m_h = _h;
@@ -29,6 +74,9 @@ SGMStereo::SGMStereo(int _w, int _h, int minDisparity, int maxDisparity, int num
 	m_sgmConfidenceThreshold = sgmConfidenceThreshold;
     m_doSubPixRefinement = doSubPixRefinement;
 	m_doSequential = doSequential;
+	m_costFunction = costFunction;
+	m_doLeftRightCheck = doLeftRightCheck;
+	m_leftRightTolerance = leftRightTolerance;
 
 	if (minDisparity >= maxDisparity)
 	{
@@ -36,6 +84,20 @@ SGMStereo::SGMStereo(int _w, int _h, int minDisparity, int maxDisparity, int num
 		exit(1);
 	}
 
+	if (costFunction != SGM_COST_NCC && costFunction != SGM_COST_CENSUS)
+	{
+		printf("[ERROR] Invalid Cost Function %d ...\n", costFunction);
+		exit(1);
+	}
+
+	m_censusLeft = NULL;
+	m_censusRight = NULL;
+	if (m_costFunction == SGM_COST_CENSUS)
+	{
+		m_censusLeft = new unsigned int[_w * _h];
+		m_censusRight = new unsigned int[_w * _h];
+	}
+
 
 	int dispRange = maxDisparity - minDisparity;
 	
@@ -191,6 +253,51 @@ void SGMStereo::calculateDSI_sse(unsigned char *L, unsigned char * R)
 
 
 
+void SGMStereo::calculateDSI_census(unsigned char *L, unsigned char * R)
+{
+	int cols = m_w;
+	int rows = m_h;
+	int planes = m_maxDisparity - m_minDisparity;
+
+	censusTransform(L, cols, rows, m_censusLeft);
+	censusTransform(R, cols, rows, m_censusRight);
+
+#pragma omp parallel for schedule(dynamic,1)
+
+	for (int y = 0; y < rows; y++)
+	{
+		const unsigned int *cL = &m_censusLeft[y * cols];
+		const unsigned int *cR = &m_censusRight[y * cols];
+		bool rowValid = y >= CENSUS_RADIUS && y < rows - CENSUS_RADIUS;
+		for (int x = 0; x < cols; x++)
+		{
+			short *pDSI = m_dsi(x, y);
+
+			// disparities whose match lies inside the region with census bits
+			int first = planes, last = 0;
+			if (rowValid && x >= CENSUS_RADIUS && x < cols - CENSUS_RADIUS)
+			{
+				first = __max(CENSUS_RADIUS - x - m_minDisparity, 0);
+				last = __min(cols - CENSUS_RADIUS - x - m_minDisparity, planes);
+			}
+
+			for (int d = 0; d < planes; d++)
+			{
+				pDSI[d] = 255;
+			}
+
+			unsigned int c = cL[x];
+			int xr = x + m_minDisparity;
+			for (int d = first; d < last; d++)
+			{
+				pDSI[d] = (short)(popcount32(c ^ cR[xr + d]) * CENSUS_COST_SCALE);
+			}
+		}
+	}
+}
+
+
+
 void subtractMinVal(short *pMessage, int size)
 {
 	__m128i* pM = (__m128i*)pMessage;
@@ -464,7 +571,10 @@ void SGMStereo::Run(
 	float* dispMap, 
 	unsigned char* confMap)
 {
-	calculateDSI_sse(iLeft, iRight);
+	if (m_costFunction == SGM_COST_CENSUS)
+		calculateDSI_census(iLeft, iRight);
+	else
+		calculateDSI_sse(iLeft, iRight);
 
 	if (m_doSequential)
 	{
@@ -477,6 +587,8 @@ void SGMStereo::Run(
 			scanlineOptimization(m_dsi, messages, iLeft, wLUT, 1, -1);
 		}
 		messages.getDispMap(m_sgmConfidenceThreshold, m_doSubPixRefinement, dispMap, confMap);
+		if (m_doLeftRightCheck)
+			leftRightCheck(messages, NULL, m_minDisparity, m_leftRightTolerance, dispMap, confMap);
 	}
 	else
 	{
@@ -491,7 +603,9 @@ void SGMStereo::Run(
 			if (k==1)
 				scanlineOptimization_vert(m_dsi, messages_ver, iLeft, wLUT);
 		}
-		getDispMap2(messages_hor, messages_ver, m_sgmConfidenceThreshold, dispMap, confMap);
+		getDispMap2(messages_hor, messages_ver, m_sgmConfidenceThreshold, m_doSubPixRefinement, dispMap, confMap);
+		if (m_doLeftRightCheck)
+			leftRightCheck(messages_hor, &messages_ver, m_minDisparity, m_leftRightTolerance, dispMap, confMap);
 	}
 }
 
@@ -511,6 +625,10 @@ void SGMStereo::free()
 	}
 
 	delete[] wLUT;
+	delete[] m_censusLeft;
+	delete[] m_censusRight;
+	m_censusLeft = NULL;
+	m_censusRight = NULL;
 }
 
 
@@ -8,10 +8,18 @@
 
 #include "dsimage.h"
 
+// matching cost used to build the DSI
+enum SGMCostFunction
+{
+	SGM_COST_NCC = 0,		// 1 - normalized cross correlation of 3x3 windows
+	SGM_COST_CENSUS = 1		// Hamming distance between census transforms of 5x5 windows
+};
+
 class SGMStereo
 {
 private:
 	void calculateDSI_sse(unsigned char *refImage, unsigned char * nbrImage);
+	void calculateDSI_census(unsigned char *refImage, unsigned char * nbrImage);
 	void messagePassing(short *pData, short *pBuffer1, short *pDMessage, int size, float weight, short smoothness);
 	void scanlineOptimization(DSI &dv, DSI &messages, unsigned char * img, float *lut, int dx_, int dy_);
 	void scanlineOptimization_hor(DSI &dv, DSI &messages, unsigned char *img, float *lut);
@@ -22,6 +30,8 @@ private:
 	DSI messages_hor, messages_ver;
 
 	float * wLUT;
+	unsigned int * m_censusLeft;
+	unsigned int * m_censusRight;
 
 	int m_w, m_h;
 
@@ -35,6 +45,9 @@ private:
 	int		m_sgmConfidenceThreshold;
 	int     m_doSubPixRefinement;
 	int     m_doSequential;
+	int     m_costFunction;
+	int     m_doLeftRightCheck;
+	float   m_leftRightTolerance;
 	
 public:
 	SGMStereo(int _w, int _h, int minDisparity, int maxDisparity, int numDirections, int sgmConfidenceThreshold, int doSubPixRefinement,
@@ -42,7 +55,10 @@ public:
 		float penalty1,
 		float penalty2,
 		float alpha,
-		int doSequential);
+		int doSequential,
+		int costFunction = SGM_COST_NCC,
+		int doLeftRightCheck = 0,
+		float leftRightTolerance = 1.0f);
 
 	void Run(unsigned char * iLeft, unsigned char * iRight, float* dispMap, unsigned char* confMap);
 
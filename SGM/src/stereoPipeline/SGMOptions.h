@@ -27,6 +27,9 @@ struct SGMOptions
 	float penalty2;
 	float alpha;
 	int doSubPixRefinement;
+	int costFunction;				// 0: NCC, 1: census transform (see SGMCostFunction)
+	int doLeftRightCheck;			// if 1, then invalidate disparities the right view doesn't agree with.
+	float leftRightTolerance;		// largest disparity difference in pixels the left-right check accepts
 
 	SGMOptions()
     {
@@ -46,6 +49,9 @@ struct SGMOptions
 		alpha = 10.0;
 		onlyStereo = 0;
 		doSubPixRefinement = 1;
+		costFunction = 0;
+		doLeftRightCheck = 0;
+		leftRightTolerance = 1.0f;
 	}
 
     void Print()
@@ -65,6 +71,9 @@ struct SGMOptions
 		wprintf(L"   doOut = %d\n", doOut);
 		wprintf(L"   onlyStereo = %d\n", onlyStereo);
 		wprintf(L"   doSubPixRefinement = %d\n", doSubPixRefinement);
+		wprintf(L"   costFunction = %d\n", costFunction);
+		wprintf(L"   doLeftRightCheck = %d\n", doLeftRightCheck);
+		wprintf(L"   leftRightTolerance = %f\n", leftRightTolerance);
 		printf("*********************************************************\n\n\n");
     }
 
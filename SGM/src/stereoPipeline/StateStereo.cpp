@@ -60,7 +60,10 @@ void CStateStereo::Initialize(SGMOptions& params, int m, int n)
 		params.penalty1,
 		params.penalty2,
 		params.alpha,
-		params.doSequential);
+		params.doSequential,
+		params.costFunction,
+		params.doLeftRightCheck,
+		params.leftRightTolerance);
 }
 
 void CStateStereo::CleanUp()
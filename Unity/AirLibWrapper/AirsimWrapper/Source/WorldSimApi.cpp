@@ -132,4 +132,30 @@ std::unordered_map<std::string, msr::airlib::Pose> WorldSimApi::charGetBonePoses
 	return std::unordered_map<std::string, Pose>();
 }
 
+std::vector<std::string> WorldSimApi::charGetBoneNames(const std::string& character_name) const
+{
+	return std::vector<std::string>();
+}
+
+void WorldSimApi::charSetBonePosesByIndex(const std::vector<int>& bone_indices, const std::vector<msr::airlib::Pose>& poses, const std::string& character_name)
+{
+}
+
+std::vector<msr::airlib::Pose> WorldSimApi::charGetBonePosesByIndex(const std::vector<int>& bone_indices, const std::string& character_name) const
+{
+	return std::vector<Pose>();
+}
+
+void WorldSimApi::charPlayMotionClip(const std::string& clip_file, float scale, float rate, bool loop, const std::string& character_name)
+{
+}
+
+void WorldSimApi::charSetMotionClipTimeWarp(const std::vector<float>& play_times, const std::vector<float>& clip_times, const std::string& character_name)
+{
+}
+
+void WorldSimApi::charStopMotionClip(const std::string& character_name)
+{
+}
+
 #pragma endregion
@@ -464,6 +464,7 @@ namespace AirSimUnity {
         Segmentation,
         SurfaceNormals,
         Infrared,
+        OpticalFlow,
         Count
     };
 
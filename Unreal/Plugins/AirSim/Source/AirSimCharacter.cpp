@@ -1,4 +1,6 @@
 #include "AirSimCharacter.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "AirBlueprintLib.h"
 
 
 void AAirSimCharacter::setFaceExpression(const std::string& expression_name, float value)
@@ -92,3 +94,102 @@ void AAirSimCharacter::reset()
 {
     //derived class should override this
 }
+std::vector<std::string> AAirSimCharacter::getBoneNames() const
+{
+    std::vector<std::string> bone_names;
+    const USkeletalMeshComponent* mesh = GetMesh();
+    if (mesh != nullptr) {
+        for (int32 i = 0; i < mesh->GetNumBones(); ++i)
+            bone_names.push_back(std::string(TCHAR_TO_UTF8(*mesh->GetBoneName(i).ToString())));
+    }
+    return bone_names;
+}
+std::vector<std::string> AAirSimCharacter::cacheBoneNames() const
+{
+    std::vector<std::string> bone_names = getBoneNames();
+    std::lock_guard<std::mutex> lock(bone_names_mutex_);
+    bone_names_ = bone_names;
+    return bone_names;
+}
+void AAirSimCharacter::setBonePosesByIndex(const std::vector<int>& bone_indices, const std::vector<msr::airlib::Pose>& poses)
+{
+    ensureBoneNames();
+    std::unordered_map<std::string, msr::airlib::Pose> named_poses;
+    {
+        std::lock_guard<std::mutex> lock(bone_names_mutex_);
+        for (size_t i = 0; i < bone_indices.size() && i < poses.size(); ++i) {
+            const std::string& bone_name = getBoneName(bone_indices[i]);
+            if (bone_name != "")
+                named_poses[bone_name] = poses[i];
+        }
+    }
+    setBonePoses(named_poses);
+}
+std::vector<msr::airlib::Pose> AAirSimCharacter::getBonePosesByIndex(const std::vector<int>& bone_indices) const
+{
+    ensureBoneNames();
+    std::vector<std::string> bone_names;
+    {
+        std::lock_guard<std::mutex> lock(bone_names_mutex_);
+        for (int bone_index : bone_indices)
+            bone_names.push_back(getBoneName(bone_index));
+    }
+    std::unordered_map<std::string, msr::airlib::Pose> named_poses = getBonePoses(bone_names);
+
+    std::vector<msr::airlib::Pose> poses;
+    for (const std::string& bone_name : bone_names) {
+        auto found = named_poses.find(bone_name);
+        poses.push_back(found == named_poses.end() ? msr::airlib::Pose::nanPose() : found->second);
+    }
+    return poses;
+}
+//for clients that use indices without asking for the names first, the skeleton is only read on the game thread
+void AAirSimCharacter::ensureBoneNames() const
+{
+    bool cached;
+    {
+        std::lock_guard<std::mutex> lock(bone_names_mutex_);
+        cached = !bone_names_.empty();
+    }
+    if (!cached) {
+        UAirBlueprintLib::RunCommandOnGameThread([this]() {
+            cacheBoneNames();
+        }, true);
+    }
+}
+//bone_names_mutex_ must be held, the names come from the last cacheBoneNames() call
+const std::string& AAirSimCharacter::getBoneName(int bone_index) const
+{
+    static const std::string no_bone;
+    if (bone_index < 0 || static_cast<size_t>(bone_index) >= bone_names_.size())
+        return no_bone;
+    return bone_names_[bone_index];
+}
+void AAirSimCharacter::playMotionClip(std::shared_ptr<const msr::airlib::MotionClip> clip, float rate, bool loop)
+{
+    motion_player_.setClip(clip);
+    motion_player_.setRate(rate);
+    motion_player_.setLoop(loop);
+    motion_player_.mapBones(cacheBoneNames());
+}
+void AAirSimCharacter::setMotionClipTimeWarp(const std::vector<msr::airlib::MotionClipPlayer::TimeWarpKey>& keys)
+{
+    motion_player_.setTimeWarp(keys);
+}
+void AAirSimCharacter::stopMotionClip()
+{
+    motion_player_.setClip(nullptr);
+}
+void AAirSimCharacter::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    if (motion_player_.getClip() != nullptr) {
+        motion_player_.update(DeltaSeconds);
+        setBonePosesByIndex(motion_player_.getBoneIndices(), motion_player_.getBonePoses());
+
+        //the last pose stays on the bones
+        if (motion_player_.isFinished())
+            stopMotionClip();
+    }
+}
@@ -3,8 +3,10 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Engine/DataTable.h"
+#include <mutex>
 
 #include "common/Common.hpp"
+#include "common/MotionClipPlayer.hpp"
 #include "AirSimCharacter.generated.h"
 
 UCLASS()
@@ -30,4 +32,29 @@ public:
     virtual void setFacePreset(const std::string& preset_name, float value);
     virtual void setFacePresets(const std::unordered_map<std::string, float>& presets);
     virtual void reset();
+
+    //bone indices are positions in getBoneNames(); the defaults use the skeleton of the mesh and fall back on
+    //the name based methods, derived classes can override them to skip the names
+    virtual std::vector<std::string> getBoneNames() const;
+    virtual void setBonePosesByIndex(const std::vector<int>& bone_indices, const std::vector<msr::airlib::Pose>& poses);
+    virtual std::vector<msr::airlib::Pose> getBonePosesByIndex(const std::vector<int>& bone_indices) const;
+    //getBoneNames() that also keeps the names for the default by index methods, so they don't look bones up per call
+    std::vector<std::string> cacheBoneNames() const;
+
+    //clip joints are matched to bones by name when the clip starts, then posed every tick until it finishes
+    void playMotionClip(std::shared_ptr<const msr::airlib::MotionClip> clip, float rate, bool loop);
+    void setMotionClipTimeWarp(const std::vector<msr::airlib::MotionClipPlayer::TimeWarpKey>& keys);
+    void stopMotionClip();
+
+    virtual void Tick(float DeltaSeconds) override;
+
+private:
+    void ensureBoneNames() const;
+    const std::string& getBoneName(int bone_index) const;
+
+private:
+    msr::airlib::MotionClipPlayer motion_player_;
+    //filled by cacheBoneNames(), read by the by index methods on the game and RPC threads
+    mutable std::mutex bone_names_mutex_;
+    mutable std::vector<std::string> bone_names_;
 };
@@ -62,6 +62,10 @@ void APIPCamera::BeginPlay()
     camera_type_enabled_.assign(imageTypeCount(), false);
 
     for (unsigned int image_type = 0; image_type < imageTypeCount(); ++image_type) {
+        //OpticalFlow is computed from other captures and has no component
+        if (captures_[image_type] == nullptr)
+            continue;
+
         //use final color for all calculations
         captures_[image_type]->CaptureSource = ESceneCaptureSource::SCS_FinalColorLDR;
 
@@ -119,7 +123,8 @@ msr::airlib::ProjectionMatrix APIPCamera::getProjectionMatrix(const APIPCamera::
 	    }
 	    else
 	    {
-            float fov = Utils::degreesToRadians(capture->FOVAngle);
+            //the matrices take half of the field of view
+            float fov = Utils::degreesToRadians(capture->FOVAngle) / 2;
 		    if ((int32)ERHIZBuffer::IsInverted)
 		    {
 			    proj_mat = FReversedZPerspectiveMatrix(
@@ -178,7 +183,7 @@ void APIPCamera::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
     if (noise_materials_.Num()) {
         for (unsigned int image_type = 0; image_type < imageTypeCount(); ++image_type) {
-            if (noise_materials_[image_type + 1])
+            if (noise_materials_[image_type + 1] && captures_[image_type])
                 captures_[image_type]->PostProcessSettings.RemoveBlendable(noise_materials_[image_type + 1]);
         }
         if (noise_materials_[0])
@@ -242,6 +247,8 @@ void APIPCamera::setupCameraFromSettings(const APIPCamera::CameraSetting& camera
     //TODO: can we eliminate storing NedTransform?
     ned_transform_ = &ned_transform;
 
+    optical_flow_setting_ = camera_setting.optical_flow;
+
     gimbal_stabilization_ = Utils::clip(camera_setting.gimbal.stabilization, 0.0f, 1.0f);
     if (gimbal_stabilization_ > 0) {
         this->SetActorTickEnabled(true);
@@ -258,6 +265,9 @@ void APIPCamera::setupCameraFromSettings(const APIPCamera::CameraSetting& camera
         const auto& noise_setting = camera_setting.noise_settings.at(image_type);
 
         if (image_type >= 0) { //scene capture components
+            if (captures_[image_type] == nullptr)
+                continue;
+
             updateCaptureComponentSetting(captures_[image_type], render_targets_[image_type],
                 capture_setting, ned_transform);
 
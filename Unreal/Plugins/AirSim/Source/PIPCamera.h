@@ -43,6 +43,7 @@ public:
     void setCameraOrientation(const FRotator& rotator);
 
     msr::airlib::ProjectionMatrix getProjectionMatrix(const APIPCamera::ImageType image_type) const;
+    const AirSimSettings::OpticalFlowSetting& getOpticalFlowSetting() const { return optical_flow_setting_; }
 
 
     USceneCaptureComponent2D* getCaptureComponent(const ImageType type, bool if_active);
@@ -67,6 +68,7 @@ private: //members
     FRotator gimbald_rotator_;
     float gimbal_stabilization_;
     const NedTransform* ned_transform_;
+    AirSimSettings::OpticalFlowSetting optical_flow_setting_;
 
     int index_ = 0; // for URDF bot camera cycling
 
@@ -20,7 +20,7 @@ void ASimModeWorldBase::initializeForPlay()
     std::unique_ptr<PhysicsEngineBase> physics_engine = createPhysicsEngine();
     physics_engine_ = physics_engine.get();
     physics_world_.reset(new msr::airlib::PhysicsWorld(std::move(physics_engine),
-        vehicles, getPhysicsLoopPeriod()));
+        vehicles, getPhysicsLoopPeriod(), false, true, world_clock_));
 }
 
 void ASimModeWorldBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -49,6 +49,14 @@ void ASimModeWorldBase::setPhysicsLoopPeriod(long long  period)
     physics_loop_period_ = period;
 }
 
+void ASimModeWorldBase::setWorldClock(std::shared_ptr<msr::airlib::ClockBase> clock)
+{
+    //the physics thread, the API server and the game thread all share the world clock domain,
+    //so timeouts and state timestamps read the time of the last physics tick
+    world_clock_ = clock;
+    ClockFactory::get(world_clock_);
+}
+
 std::unique_ptr<ASimModeWorldBase::PhysicsEngineBase> ASimModeWorldBase::createPhysicsEngine()
 {
     std::unique_ptr<PhysicsEngineBase> physics_engine;
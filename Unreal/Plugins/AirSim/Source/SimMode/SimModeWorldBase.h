@@ -7,6 +7,7 @@
 #include "physics/FastPhysicsEngine.hpp"
 #include "physics/World.hpp"
 #include "physics/PhysicsWorld.hpp"
+#include "common/MonotonicClock.hpp"
 #include "common/StateReporterWrapper.hpp"
 #include "api/ApiServerBase.hpp"
 #include "SimModeBase.h"
@@ -41,6 +42,10 @@ protected:
 
     long long getPhysicsLoopPeriod() const;
     void setPhysicsLoopPeriod(long long  period);
+
+    //installs clock as the ClockFactory clock and as the clock domain of the physics world
+    //must be called from setupClockSpeed, before anything reads the clock
+    void setWorldClock(std::shared_ptr<msr::airlib::ClockBase> clock);
 private:
     typedef msr::airlib::UpdatableObject UpdatableObject;
     typedef msr::airlib::PhysicsEngineBase PhysicsEngineBase;
@@ -52,6 +57,7 @@ private:
 private:
     std::unique_ptr<msr::airlib::PhysicsWorld> physics_world_;
     PhysicsEngineBase* physics_engine_;
+    std::shared_ptr<msr::airlib::ClockBase> world_clock_;
 
     /*
     300Hz seems to be minimum for non-aggressive flights
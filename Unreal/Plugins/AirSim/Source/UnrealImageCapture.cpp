@@ -25,8 +25,106 @@ void UnrealImageCapture::getImages(const std::vector<msr::airlib::ImageCaptureBa
             responses[responses.size() - 1].message = "camera is not set";
         }
     }
-    else
-        getSceneCaptureImage(requests, responses, false);
+    else {
+        bool has_optical_flow = false;
+        for (const auto& request : requests)
+            has_optical_flow |= request.image_type == ImageType::OpticalFlow;
+        if (!has_optical_flow) {
+            getSceneCaptureImage(requests, responses, false);
+            return;
+        }
+
+        //OpticalFlow images are computed from a DepthPlanner capture, and an Infrared capture for the object IDs to mask
+        std::vector<ImageRequest> capture_requests;
+        std::vector<int> capture_index(requests.size()), infrared_index(requests.size(), -1);
+        for (unsigned int i = 0; i < requests.size(); ++i) {
+            const ImageRequest& request = requests[i];
+            capture_index[i] = static_cast<int>(capture_requests.size());
+            if (request.image_type != ImageType::OpticalFlow) {
+                capture_requests.push_back(request);
+                continue;
+            }
+            capture_requests.push_back(ImageRequest(request.camera_name, ImageType::DepthPlanner, true, false));
+            if (!cameras_->at(request.camera_name)->getOpticalFlowSetting().masked_object_ids.empty()) {
+                infrared_index[i] = static_cast<int>(capture_requests.size());
+                capture_requests.push_back(ImageRequest(request.camera_name, ImageType::Infrared, false, false));
+            }
+        }
+
+        std::vector<ImageResponse> capture_responses;
+        getSceneCaptureImage(capture_requests, capture_responses, false);
+
+        for (unsigned int i = 0; i < requests.size(); ++i) {
+            const ImageRequest& request = requests[i];
+            ImageResponse& capture_response = capture_responses[capture_index[i]];
+            if (request.image_type != ImageType::OpticalFlow) {
+                responses.push_back(std::move(capture_response));
+                continue;
+            }
+            responses.push_back(ImageResponse());
+            getOpticalFlowImage(request, capture_response,
+                infrared_index[i] < 0 ? nullptr : &capture_responses[infrared_index[i]], responses.back());
+        }
+    }
+}
+
+void UnrealImageCapture::getOpticalFlowImage(const ImageRequest& request, const ImageResponse& depth, const ImageResponse* infrared,
+    ImageResponse& response) const
+{
+    response.camera_name = request.camera_name;
+    response.time_stamp = depth.time_stamp;
+    response.camera_position = depth.camera_position;
+    response.camera_orientation = depth.camera_orientation;
+    response.pixels_as_float = request.pixels_as_float;
+    response.compress = request.compress;
+    response.width = depth.width;
+    response.height = depth.height;
+    response.image_type = request.image_type;
+
+    if (!request.pixels_as_float) {
+        response.message = "OpticalFlow images are only available with pixels_as_float";
+        return;
+    }
+    if (!depth.message.empty()) {
+        response.message = depth.message;
+        return;
+    }
+    const size_t pixels = static_cast<size_t>(depth.width) * depth.height;
+    if (pixels == 0 || depth.image_data_float.size() != pixels) {
+        response.message = "DepthPlanner capture for OpticalFlow is empty";
+        return;
+    }
+    if (infrared != nullptr && (!infrared->message.empty() || infrared->width != depth.width || infrared->height != depth.height
+        || infrared->image_data_uint8.size() < pixels)) {
+        response.message = "Infrared capture for OpticalFlow masking must have the size of the DepthPlanner capture";
+        return;
+    }
+
+    APIPCamera* camera = cameras_->at(request.camera_name);
+    msr::airlib::OpticalFlowGenerator::Frame frame;
+    frame.planar_depth = depth.image_data_float.data();
+    frame.width = depth.width;
+    frame.height = depth.height;
+    frame.pose = msr::airlib::Pose(depth.camera_position, depth.camera_orientation);
+    if (infrared != nullptr) {
+        frame.object_ids = infrared->image_data_uint8.data();
+        frame.object_id_stride = static_cast<int>(infrared->image_data_uint8.size() / pixels);
+    }
+
+    try {
+        frame.intrinsics = msr::airlib::OpticalFlowGenerator::Intrinsics::fromProjectionMatrix(
+            camera->getProjectionMatrix(ImageType::DepthPlanner), depth.width, depth.height);
+
+        std::lock_guard<std::mutex> lock(optical_flow_mutex_);
+        auto& generator = optical_flow_generators_[request.camera_name];
+        if (generator == nullptr)
+            generator.reset(new msr::airlib::OpticalFlowGenerator(camera->getOpticalFlowSetting()));
+        generator->addFrame(frame, response.image_data_float);
+    }
+    catch (const std::exception& error) {
+        response.message = error.what();
+        response.image_data_float.clear();
+    }
 }
 
 
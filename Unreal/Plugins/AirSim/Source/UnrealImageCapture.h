@@ -4,6 +4,10 @@
 #include "PIPCamera.h"
 #include "common/ImageCaptureBase.hpp"
 #include "common/common_utils/UniqueValueMap.hpp"
+#include "camera/OpticalFlowGenerator.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
 
 
 class UnrealImageCapture : public msr::airlib::ImageCaptureBase
@@ -20,6 +24,9 @@ private:
     void getSceneCaptureImage(const std::vector<msr::airlib::ImageCaptureBase::ImageRequest>& requests, 
         std::vector<msr::airlib::ImageCaptureBase::ImageResponse>& responses, bool use_safe_method) const;
 
+    void getOpticalFlowImage(const ImageRequest& request, const ImageResponse& depth, const ImageResponse* infrared,
+        ImageResponse& response) const;
+
     void addScreenCaptureHandler(UWorld *world);
     bool getScreenshotScreen(ImageType image_type, std::vector<uint8_t>& compressedPng);
 
@@ -28,4 +35,8 @@ private:
 private:
     const common_utils::UniqueValueMap<std::string, APIPCamera*>* cameras_;
     std::vector<uint8_t> last_compressed_png_;
+
+    //previous pose of each camera that returned OpticalFlow images
+    mutable std::mutex optical_flow_mutex_;
+    mutable std::map<std::string, std::unique_ptr<msr::airlib::OpticalFlowGenerator>> optical_flow_generators_;
 };
\ No newline at end of file
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "UnrealDistanceArraySensor.h"
+#include "AirBlueprintLib.h"
+#include "common/Common.hpp"
+#include "NedTransform.h"
+
+UnrealDistanceArraySensor::UnrealDistanceArraySensor(const AirSimSettings::DistanceArraySetting& setting,
+    AActor* actor, const NedTransform* ned_transform)
+    : DistanceArraySimple(setting), actor_(actor), ned_transform_(ned_transform)
+{
+    this->ignore_pawn_collision_ = setting.ignore_pawn_collision;
+    this->draw_debug_points_ = setting.draw_debug_points;
+}
+
+void UnrealDistanceArraySensor::castRays(const msr::airlib::Pose& pose, const msr::airlib::vector<Vector3r>& directions,
+    msr::airlib::real_T max_distance, msr::airlib::vector<RayHit>& hits)
+{
+    FVector startVec;
+    FQuat rayRotation;
+    float distance_scale;
+    if (this->ned_transform_ != nullptr)
+    {
+        startVec = ned_transform_->fromLocalNed(pose.position);
+        rayRotation = FQuat::Identity;
+        distance_scale = 100.0f;    //cm in Unreal
+    }
+    else
+    {
+        //UrdfBot links are in Unreal coordinates, so place the sensor relative to the actor as UnrealDistanceSensor does
+        const msr::airlib::Pose& relative_pose = getParams().relative_pose;
+        Vector3r location = this->getGroundTruth().kinematics->pose.position;
+        location += VectorMath::rotateVector(relative_pose.position, this->getGroundTruth().kinematics->pose.orientation, true);
+        startVec = FVector(location.x(), location.y(), location.z());
+        rayRotation = this->actor_->GetActorQuat() *
+            FQuat(relative_pose.orientation.x(), relative_pose.orientation.y(), relative_pose.orientation.z(), relative_pose.orientation.w());
+        distance_scale = 1.0f;
+    }
+
+    for (size_t i = 0; i < directions.size(); ++i)
+    {
+        FVector endVec;
+        if (this->ned_transform_ != nullptr)
+        {
+            const Vector3r end = pose.position + VectorMath::rotateVector(directions[i], pose.orientation, true) * max_distance;
+            endVec = ned_transform_->fromLocalNed(end);
+        }
+        else
+            endVec = startVec + rayRotation.RotateVector(FVector(directions[i].x(), directions[i].y(), directions[i].z())) * max_distance;
+
+        FHitResult hit_result = FHitResult(ForceInit);
+        RayHit& hit = hits[i];
+        hit.is_hit = UAirBlueprintLib::GetObstacle(actor_, startVec, endVec, hit_result, TArray<const AActor*>(), ECC_Visibility, this->ignore_pawn_collision_);
+        if (hit.is_hit)
+        {
+            hit.distance = hit_result.Distance / distance_scale;
+            //Unreal normals and ray directions are in the same left handed frame, so the cosine carries over
+            hit.incidence_cos = FVector::DotProduct((endVec - startVec).GetSafeNormal(), hit_result.ImpactNormal);
+        }
+        else
+        {
+            hit.distance = max_distance;
+            hit.incidence_cos = 1;
+        }
+
+        if (this->draw_debug_points_)
+        {
+            DrawDebugPoint(
+                actor_->GetWorld(),
+                hit.is_hit ? hit_result.ImpactPoint : endVec,
+                5,                       //size
+                hit.is_hit ? FColor::Red : FColor::Green,
+                false,                   //persistent (never goes away)
+                0.1                      //point leaves a trail on moving object
+            );
+        }
+    }
+}
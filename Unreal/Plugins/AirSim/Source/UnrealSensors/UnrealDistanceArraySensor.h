@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "common/Common.hpp"
+#include "GameFramework/Actor.h"
+#include "Runtime/Engine/Public/DrawDebugHelpers.h"
+#include "sensors/distance/DistanceArraySimple.hpp"
+#include "NedTransform.h"
+
+class UnrealDistanceArraySensor : public msr::airlib::DistanceArraySimple {
+public:
+    typedef msr::airlib::AirSimSettings AirSimSettings;
+
+public:
+    UnrealDistanceArraySensor(const AirSimSettings::DistanceArraySetting& setting,
+        AActor* actor, const NedTransform* ned_transform);
+
+protected:
+    virtual void castRays(const msr::airlib::Pose& pose, const msr::airlib::vector<msr::airlib::Vector3r>& directions,
+        msr::airlib::real_T max_distance, msr::airlib::vector<RayHit>& hits) override;
+
+private:
+    using Vector3r = msr::airlib::Vector3r;
+    using VectorMath = msr::airlib::VectorMath;
+
+
+private:
+    AActor* actor_;
+    const NedTransform* ned_transform_;
+    bool ignore_pawn_collision_ = true;
+    bool draw_debug_points_ = false;
+};
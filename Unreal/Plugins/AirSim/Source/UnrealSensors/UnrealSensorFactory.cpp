@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #include "UnrealSensorFactory.h"
 #include "UnrealSensors/UnrealDistanceSensor.h"
+#include "UnrealSensors/UnrealDistanceArraySensor.h"
 #include "UnrealSensors/UnrealLidarSensor.h"
 #include "vehicles/AirSimVehicle.h"
 
@@ -29,6 +30,9 @@ std::unique_ptr<msr::airlib::SensorBase> UnrealSensorFactory::createSensorFromSe
     case SensorBase::SensorType::Distance:
         return std::unique_ptr<UnrealDistanceSensor>(new UnrealDistanceSensor(
             *static_cast<const AirSimSettings::DistanceSetting*>(sensor_setting), attachActor, ned_transform_));
+    case SensorBase::SensorType::DistanceArray:
+        return std::unique_ptr<UnrealDistanceArraySensor>(new UnrealDistanceArraySensor(
+            *static_cast<const AirSimSettings::DistanceArraySetting*>(sensor_setting), attachActor, ned_transform_));
     case SensorBase::SensorType::Lidar:
         return std::unique_ptr<UnrealLidarSensor>(new UnrealLidarSensor(
             *static_cast<const AirSimSettings::LidarSetting*>(sensor_setting), attachActor, ned_transform_));
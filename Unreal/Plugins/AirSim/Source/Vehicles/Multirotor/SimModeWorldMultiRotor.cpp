@@ -42,8 +42,8 @@ void ASimModeWorldMultiRotor::setupClockSpeed()
     std::string clock_type = getSettings().clock_type;
 
     if (clock_type == "ScalableClock") {
-        //scalable clock returns interval same as wall clock but multiplied by a scale factor
-        ClockFactory::get(std::make_shared<msr::airlib::ScalableClock>(clock_speed == 1 ? 1 : 1 / clock_speed));
+        //the world clock runs clock_speed times the monotonic wall clock and only moves when the physics world ticks
+        setWorldClock(std::make_shared<msr::airlib::MonotonicClock>(clock_speed));
     }
     else if (clock_type == "SteppableClock") {
         //steppable clock returns interval that is a constant number irrespective of wall clock
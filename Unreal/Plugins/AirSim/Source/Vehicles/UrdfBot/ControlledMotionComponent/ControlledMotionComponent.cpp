@@ -20,4 +20,126 @@ bool ControlledMotionComponent::GetFloatFromConfiguration(FString configName, TM
     }
     out = FCString::Atof(*configValue);
     return true;
-}
\ No newline at end of file
+}
+
+void ControlledMotionComponent::CaptureJointReference(float jointPositionOffset)
+{
+    FTransform baseTransform = this->baseLink_->GetActorTransform();
+    this->referenceRotation_ = baseTransform.GetRotation().Inverse() * this->actuationLink_->GetActorQuat();
+    this->referenceLocation_ = baseTransform.InverseTransformVectorNoScale(this->actuationLink_->GetActorLocation() - baseTransform.GetLocation());
+    this->jointPositionOffset_ = jointPositionOffset;
+    this->hasJointReference_ = true;
+}
+
+FVector ControlledMotionComponent::GetWorldJointAxis() const
+{
+    return this->baseLink_->GetActorQuat().RotateVector(this->jointSpecification_->Axis.GetSafeNormal());
+}
+
+float ControlledMotionComponent::GetJointPosition() const
+{
+    FTransform baseTransform = this->baseLink_->GetActorTransform();
+    FVector axis = this->jointSpecification_->Axis.GetSafeNormal();
+
+    if (this->jointSpecification_->Type == PRISMATIC_TYPE)
+    {
+        FVector location = baseTransform.InverseTransformVectorNoScale(this->actuationLink_->GetActorLocation() - baseTransform.GetLocation());
+        return this->jointPositionOffset_ + FVector::DotProduct(location - this->referenceLocation_, axis) / this->worldScale;
+    }
+
+    // Twist about the axis of the rotation since the reference was taken.
+    FQuat relative = baseTransform.GetRotation().Inverse() * this->actuationLink_->GetActorQuat();
+    FQuat delta = relative * this->referenceRotation_.Inverse();
+    float twist = 2.0f * FMath::Atan2(FVector::DotProduct(FVector(delta.X, delta.Y, delta.Z), axis), delta.W);
+    return this->jointPositionOffset_ + FMath::UnwindRadians(twist);
+}
+
+float ControlledMotionComponent::GetJointVelocity() const
+{
+    FVector axis = this->GetWorldJointAxis();
+
+    if (this->jointSpecification_->Type == PRISMATIC_TYPE)
+    {
+        FVector velocity = this->actuationLink_->GetRootMesh()->GetPhysicsLinearVelocity() - this->baseLink_->GetRootMesh()->GetPhysicsLinearVelocity();
+        return FVector::DotProduct(velocity, axis) / this->worldScale;
+    }
+
+    FVector angularVelocity = this->actuationLink_->GetRootMesh()->GetPhysicsAngularVelocityInRadians() - this->baseLink_->GetRootMesh()->GetPhysicsAngularVelocityInRadians();
+    return FVector::DotProduct(angularVelocity, axis);
+}
+
+void ControlledMotionComponent::ApplyActuatorEffort(float delta)
+{
+    if (!this->hasJointReference_)
+        this->CaptureJointReference(0.0f);
+
+    float effort = this->actuator_->update(delta, this->GetJointPosition(), this->GetJointVelocity());
+    if (this->actuator_->isIdle())
+        return;
+
+    // Equal and opposite, so the motor does not push the robot as a whole. Both calls wake their body.
+    FVector axis = this->GetWorldJointAxis();
+    if (this->jointSpecification_->Type == PRISMATIC_TYPE)
+    {
+        FVector force = axis * effort * this->worldScale;
+        this->actuationLink_->GetRootMesh()->AddForce(force);
+        this->baseLink_->GetRootMesh()->AddForce(-force);
+    }
+    else
+    {
+        FVector torque = axis * effort * this->worldScale * this->worldScale;
+        this->actuationLink_->GetRootMesh()->AddTorque(torque);
+        this->baseLink_->GetRootMesh()->AddTorque(-torque);
+    }
+}
+
+void ControlledMotionComponent::GetJointSensorState(float& position, float& velocity, float& effort)
+{
+    if (!this->hasJointReference_)
+        this->CaptureJointReference(0.0f);
+
+    // Same calibrated units as the Position control signal.
+    position = this->GetJointPosition();
+    if (this->jointCoupling_ != nullptr && this->jointCoupling_->contains(this->jointName_))
+        position = this->jointCoupling_->toCalibrated(this->jointName_, position);
+    velocity = this->GetJointVelocity();
+
+    if (this->actuator_ != nullptr)
+    {
+        effort = this->actuator_->getEffort();
+        return;
+    }
+
+    FVector linearForce, angularForce;
+    this->constraintComponent_->GetConstraintForce(linearForce, angularForce);
+    FVector axis = this->GetWorldJointAxis();
+    if (this->jointSpecification_->Type == PRISMATIC_TYPE)
+        effort = FVector::DotProduct(linearForce, axis) / this->worldScale;
+    else
+        effort = FVector::DotProduct(angularForce, axis) / (this->worldScale * this->worldScale);
+}
+
+void ControlledMotionComponent::AddActuatorState(TMap<FString, FString>& state) const
+{
+    if (this->actuator_ == nullptr)
+        return;
+
+    state.Add(TEXT("Effort"), FString::SanitizeFloat(this->actuator_->getEffort()));
+    state.Add(TEXT("Current"), FString::SanitizeFloat(this->actuator_->getCurrent()));
+    state.Add(TEXT("Voltage"), FString::SanitizeFloat(this->actuator_->getVoltage()));
+}
+
+bool ControlledMotionComponent::SetPointChanged(float setPoint)
+{
+    if (setPoint == this->lastSetPoint_)
+        return false;
+
+    this->lastSetPoint_ = setPoint;
+    return true;
+}
+
+void ControlledMotionComponent::WakeLinks()
+{
+    this->actuationLink_->GetRootMesh()->WakeAllRigidBodies();
+    this->baseLink_->GetRootMesh()->WakeAllRigidBodies();
+}
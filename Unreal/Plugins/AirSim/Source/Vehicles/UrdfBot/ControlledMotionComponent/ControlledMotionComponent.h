@@ -7,6 +7,8 @@
 #include "AirBlueprintLib.h"
 #include "Vehicles/UrdfBot/UrdfLink.h"
 #include "Vehicles/UrdfBot/UrdfParser/UrdfJointSpecification.h"
+#include "vehicles/urdfbot/JointCoupling.hpp"
+#include "vehicles/urdfbot/JointActuator.hpp"
 
 class ControlledMotionComponent
 {
@@ -27,6 +29,18 @@ class ControlledMotionComponent
             this->jointSpecification_ = jointSpecification;
             this->constraintComponent_ = constraintComponent;
             this->name_ = jointSpecification->Name;
+
+            if (jointSpecification->Actuator != nullptr)
+            {
+                this->actuator_.reset(new msr::airlib::JointActuator(*jointSpecification->Actuator));
+            }
+        }
+
+        // Set points go through the coupling, which applies mimic, soft limits and velocity limits before ComputeForces reads them back.
+        virtual void SetJointCoupling(msr::airlib::JointCoupling* jointCoupling)
+        {
+            this->jointCoupling_ = jointCoupling;
+            this->jointName_ = std::string(TCHAR_TO_UTF8(*this->name_));
         }
 
         virtual void SetControl(TMap<FString, float> controlSignals) = 0;
@@ -35,10 +49,28 @@ class ControlledMotionComponent
         // Should be called on each tick
         virtual void ComputeForces(float delta) = 0;
 
+        // Measured state for the joint sensors. The effort is the actuator output, or the constraint reaction about the joint axis.
+        void GetJointSensorState(float& position, float& velocity, float& effort);
+
 
     protected:
         bool GetFloatFromConfiguration(FString configName, TMap<FString, FString> configuration, float& out, bool throwIfNotExist = false, bool throwIfNonNumeric = false);
 
+        // Remembers the pose of the actuated link relative to the base link, where the joint is at jointPositionOffset.
+        void CaptureJointReference(float jointPositionOffset);
+        FVector GetWorldJointAxis() const;
+        // Radians or meters along the joint axis, and their rate.
+        float GetJointPosition() const;
+        float GetJointVelocity() const;
+
+        // Steps the motor model with the measured joint state and applies its effort to both links. Idle motors apply nothing, so the links can sleep.
+        void ApplyActuatorEffort(float delta);
+        void AddActuatorState(TMap<FString, FString>& state) const;
+
+        // Constraint drives only need a new target, and the links a wake up, when the set point moves.
+        bool SetPointChanged(float setPoint);
+        void WakeLinks();
+
         FString name_;
         float worldScale = 100.0f;
 
@@ -48,4 +80,17 @@ class ControlledMotionComponent
         AUrdfLink* actuationLink_;
         UrdfJointSpecification *jointSpecification_;
         UPhysicsConstraintComponent* constraintComponent_;
+
+        msr::airlib::JointCoupling* jointCoupling_ = nullptr;
+        std::string jointName_;
+
+        // Only set for joints with an <actuator>, which are driven by torque rather than by a constraint drive.
+        std::unique_ptr<msr::airlib::JointActuator> actuator_;
+
+    private:
+        bool hasJointReference_ = false;
+        float jointPositionOffset_ = 0.0f;
+        FQuat referenceRotation_ = FQuat::Identity;
+        FVector referenceLocation_ = FVector::ZeroVector;
+        float lastSetPoint_ = std::numeric_limits<float>::quiet_NaN();
 };
\ No newline at end of file
@@ -20,7 +20,6 @@ void LinearActuator::Attach(AUrdfLink* baseLink, AUrdfLink* actuationLink, UrdfJ
 
     this->range_ = (jointSpecification->Limit->Upper - jointSpecification->Limit->Lower) * this->worldScale;
     this->invRange_ = 1.0f / this->range_;
-    this->maxActuationRate_ = jointSpecification->Limit->Velocity;
 
     // Compute min and max transform points
     FVector parentLocation = this->baseLink_->GetActorLocation();
@@ -48,9 +47,20 @@ void LinearActuator::Attach(AUrdfLink* baseLink, AUrdfLink* actuationLink, UrdfJ
 
 void LinearActuator::SetControl(TMap<FString, float> controlSignals)
 {
+    float jointRange = this->jointSpecification_->Limit->Upper - this->lower_;
+
+    // 'Position' is in meters from the calibration reference, 'Value' is 0-1 across the joint limits.
+    if (controlSignals.Contains(TEXT("Position")))
+    {
+        float position = this->jointCoupling_->fromCalibrated(this->jointName_, controlSignals[TEXT("Position")]);
+        this->jointCoupling_->setPositionTarget(this->jointName_, position);
+        this->controlSignalSetPoint_ = (position - this->lower_) / jointRange;
+        return;
+    }
+
     if (!controlSignals.Contains(TEXT("Value")))
     {
-        throw std::runtime_error("LinearActuator '" + std::string(TCHAR_TO_UTF8(*(this->GetName()))) + "' is missing the required 'Value' parameter in SetControl().");
+        throw std::runtime_error("LinearActuator '" + std::string(TCHAR_TO_UTF8(*(this->GetName()))) + "' is missing the required 'Value' or 'Position' parameter in SetControl().");
     }
 
     float value = controlSignals[TEXT("Value")];
@@ -58,6 +68,7 @@ void LinearActuator::SetControl(TMap<FString, float> controlSignals)
     if (value < 0 || value > 1)
         throw std::runtime_error("LinearActuator control signal has value '" + std::to_string(value) + "', which is outside the expected range of 0-1.");
 
+    this->jointCoupling_->setPositionTarget(this->jointName_, this->lower_ + value * jointRange);
     this->controlSignalSetPoint_ = value;
 }
 
@@ -74,7 +85,7 @@ void LinearActuator::ComputeForces(float delta)
     FVector actuatorOneHalf = (actuatorZero + actuatorOne) * 0.5f;
 
     FVector zeroToOne = (actuatorOne - actuatorZero);
-    float setPointDistance = this->controlSignalSetPoint_ * this->range_;
+    float jointRange = this->jointSpecification_->Limit->Upper - this->lower_;
 
     // For the first tick, initialize the clock and initial position
     if (!this->runOneTick_)
@@ -91,23 +102,36 @@ void LinearActuator::ComputeForces(float delta)
             throw std::runtime_error("The initial state of the actuator could not be resolved. The actuator is extended longer than the maximal allowable distance.");
         }
 
-        // Start with no-op. User will set control signal in future frames.
+        // Start with no-op. User will set control signal in future frames. Followers take their position from their leader.
         this->controlSignalSetPoint_ = noopControlSignal;
-        this->actualActuatorPosition_ = noopControlSignal;
+        if (!this->jointCoupling_->isFollower(this->jointName_))
+        {
+            this->jointCoupling_->resetPosition(this->jointName_, this->lower_ + noopControlSignal * jointRange);
+        }
+        this->CaptureJointReference(this->lower_ + noopControlSignal * jointRange);
+
         this->runOneTick_ = true;
         return;
     }
 
-    float error = this->controlSignalSetPoint_ - this->actualActuatorPosition_;
-    float maxActuationAmount = this->maxActuationRate_ * delta;
+    // The coupling has already stepped this tick, so its position respects the rate, soft limits and any mimic.
+    float position = this->jointCoupling_->getPosition(this->jointName_);
+
+    if (this->actuator_ != nullptr)
+    {
+        this->actuator_->setPositionTarget(position, this->jointCoupling_->getVelocity(this->jointName_));
+        this->ApplyActuatorEffort(delta);
+        return;
+    }
+
+    if (!this->SetPointChanged(position))
+        return;
 
-    error = std::max(std::min(error, maxActuationAmount), -1.0f * maxActuationAmount);
-    this->actualActuatorPosition_ += error;
+    this->actualActuatorPosition_ = (position - this->lower_) / jointRange;
 
     FVector setVec = zeroToOne * (this->actualActuatorPosition_ - 0.5f);
     FVector ss = this->jointSpecification_->Axis.Rotation().RotateVector(setVec);
-    //this->actuationLink_->GetRootComponent()->WakeAllRigidBodies();
-    //this->baseLink_->GetRootComponent()->WakeAllRigidBodies();
+    this->WakeLinks();
     this->constraintComponent_->SetLinearPositionTarget(ss);
 }
 
@@ -124,5 +148,6 @@ TMap<FString, FString> LinearActuator::GetState()
     float actuatorPoint = (actualDistance - this->lower_) * this->invRange_;
 
     state.Add(TEXT("ActualPoint"), FString::SanitizeFloat(actuatorPoint)); // convert back to 0-1 range
+    this->AddActuatorState(state);
     return state;
 }
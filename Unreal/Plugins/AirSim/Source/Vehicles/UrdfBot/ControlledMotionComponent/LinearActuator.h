@@ -19,8 +19,6 @@ class LinearActuator : public ControlledMotionComponent
         virtual TMap<FString, FString> GetState() override;
 
     private:
-        float maxActuationRate_ = 1.0f;
-
         FVector baseToActuatorZero_;
         FVector baseToActuatorOne_;
 
@@ -10,7 +10,14 @@ void Motor::Attach(AUrdfLink* baseLink, AUrdfLink* actuationLink, UrdfJointSpeci
     }
 
     this->rotationAxis_ = jointSpecification->Axis;
-    this->maxVelocity_ = jointSpecification->Limit->Velocity;
+
+    // Without a <limit>, an actuated motor is scaled to the speed its supply allows.
+    if (jointSpecification->Limit != nullptr)
+        this->maxVelocity_ = jointSpecification->Limit->Velocity;
+    else if (this->actuator_ != nullptr)
+        this->maxVelocity_ = this->actuator_->getNoLoadVelocity();
+    else
+        throw std::runtime_error("Motor on joint '" + std::string(TCHAR_TO_UTF8(*jointSpecification->Name)) + "' needs a <limit> velocity or an actuator to scale its control signal.");
     this->controlSignalSetPoint_ = 0.0f;
 }
 
@@ -26,13 +33,26 @@ void Motor::SetControl(TMap<FString, float> controlSignals)
     if (value < -1 || value > 1)
         throw std::runtime_error("Motor control signal has value '" + std::to_string(value) + "', which is outside the expected range of -1 to 1.");
 
+    this->jointCoupling_->setVelocityTarget(this->jointName_, value * this->maxVelocity_);
     this->controlSignalSetPoint_ = value;
 }
 void Motor::ComputeForces(float delta)
 {
-    FVector targetAngularVelocity = FVector(this->maxVelocity_, 0, 0) * this->controlSignalSetPoint_;
-    this->baseLink_->GetRootMesh()->WakeAllRigidBodies();
-    this->actuationLink_->GetRootMesh()->WakeAllRigidBodies();
+    // Followers get their velocity from their leader through the coupling.
+    float velocity = this->jointCoupling_->getVelocity(this->jointName_);
+
+    if (this->actuator_ != nullptr)
+    {
+        this->actuator_->setVelocityTarget(velocity);
+        this->ApplyActuatorEffort(delta);
+        return;
+    }
+
+    if (!this->SetPointChanged(velocity))
+        return;
+
+    FVector targetAngularVelocity = FVector(velocity, 0, 0);
+    this->WakeLinks();
     this->constraintComponent_->SetAngularVelocityTarget(targetAngularVelocity);
 }
 
@@ -42,14 +62,16 @@ TMap<FString, FString> Motor::GetState()
     state.Add(TEXT("SetPoint"), FString::SanitizeFloat(this->controlSignalSetPoint_));
 
     FVector targetAngularVelocity = this->actuationLink_->GetPhysicsAngularVelocityInRadians();
-    FVector baseAngularVelocity = this->actuationLink_->GetPhysicsAngularVelocityInRadians();
+    FVector baseAngularVelocity = this->baseLink_->GetPhysicsAngularVelocityInRadians();
     FVector worldDiffAngularVelocity = targetAngularVelocity - baseAngularVelocity;
 
+    // The drive turns about the X axis of the constraint frame.
     FRotator componentRotation = this->constraintComponent_->GetComponentRotation();
-    FVector localDiffAngularVelocity = componentRotation.RotateVector(worldDiffAngularVelocity);
+    FVector localDiffAngularVelocity = componentRotation.UnrotateVector(worldDiffAngularVelocity);
 
-    float actualSetPoint = localDiffAngularVelocity[0] / this->maxVelocity_;
+    float actualSetPoint = this->maxVelocity_ > 0 ? localDiffAngularVelocity[0] / this->maxVelocity_ : 0.0f;
     state.Add(TEXT("ActualPoint"), FString::SanitizeFloat(actualSetPoint));
+    this->AddActuatorState(state);
 
     return state;
 }
\ No newline at end of file
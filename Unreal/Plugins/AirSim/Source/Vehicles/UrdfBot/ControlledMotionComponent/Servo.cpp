@@ -28,20 +28,30 @@ void Servo::Attach(AUrdfLink* baseLink, AUrdfLink* actuationLink, UrdfJointSpeci
         throw std::runtime_error("Joint '" + std::string(TCHAR_TO_UTF8(*jointSpecification->Name)) + "' has an upper of '" + std::to_string(jointSpecification->Limit->Upper) + "', which is < 0.");
     }
 
-    this->rotationRange_ = FMath::RadiansToDegrees(jointSpecification->Limit->Upper - jointSpecification->Limit->Lower);
-    this->invRotationRange_ = 1.0f / this->rotationRange_;
-    this->maxRotationRate_ = jointSpecification->Limit->Velocity;
-    this->lower_ = FMath::RadiansToDegrees(jointSpecification->Limit->Lower);
+    this->lower_ = jointSpecification->Limit->Lower;
+    this->range_ = jointSpecification->Limit->Upper - jointSpecification->Limit->Lower;
+    this->center_ = (jointSpecification->Limit->Upper + jointSpecification->Limit->Lower) * 0.5f;
+
+    // The coupling starts the joint at 0, the no-op position.
+    this->controlSignalSetPoint_ = (0.0f - this->lower_) / this->range_;
 
     this->isAttached_ = true;
-    this->runOneTick_ = false;
 }
 
 void Servo::SetControl(TMap<FString, float> controlSignals)
 {
+    // 'Position' is in radians from the calibration reference, 'Value' is 0-1 across the joint limits.
+    if (controlSignals.Contains(TEXT("Position")))
+    {
+        float position = this->jointCoupling_->fromCalibrated(this->jointName_, controlSignals[TEXT("Position")]);
+        this->jointCoupling_->setPositionTarget(this->jointName_, position);
+        this->controlSignalSetPoint_ = (position - this->lower_) / this->range_;
+        return;
+    }
+
     if (!controlSignals.Contains(TEXT("Value")))
     {
-        throw std::runtime_error("Servo '" + std::string(TCHAR_TO_UTF8(*(this->GetName()))) + "' is missing the required 'Value' parameter in SetControl().");
+        throw std::runtime_error("Servo '" + std::string(TCHAR_TO_UTF8(*(this->GetName()))) + "' is missing the required 'Value' or 'Position' parameter in SetControl().");
     }
 
     float value = controlSignals[TEXT("Value")];
@@ -49,6 +59,7 @@ void Servo::SetControl(TMap<FString, float> controlSignals)
     if (value < 0 || value > 1)
         throw std::runtime_error("Servo control signal has value '" + std::to_string(value) + "', which is outside the expected range of 0-1.");
 
+    this->jointCoupling_->setPositionTarget(this->jointName_, this->lower_ + value * this->range_);
     this->controlSignalSetPoint_ = value;
 }
 
@@ -57,40 +68,22 @@ void Servo::ComputeForces(float delta)
     if (!this->isAttached_)
         return;
 
-    FQuat baseLinkQuat = this->baseLink_->GetActorQuat();
-    float setPointAngle = this->controlSignalSetPoint_ * this->rotationRange_;
+    // The coupling has already stepped this tick, so its position respects the rate, soft limits and any mimic.
+    float position = this->jointCoupling_->getPosition(this->jointName_);
 
-    if (!this->runOneTick_)
+    if (this->actuator_ != nullptr)
     {
-        float noopControlSignal = (0.0f - this->lower_) * this->invRotationRange_;
-
-        if (noopControlSignal < 0.0f)
-        {
-            throw std::runtime_error("The initial state of the actuator could not be resolved. The actuator is compressed shorter than the minimal allowable distance.");
-        }
-        else if (noopControlSignal > 1.0f)
-        {
-            throw std::runtime_error("The initial state of the actuator could not be resolved. The actuator is extended longer than the maximal allowable distance.");
-        }
-
-        // Start with no-op. User will set control signal in future frames.
-        this->controlSignalSetPoint_ = noopControlSignal;
-        this->actualServoPosition_ = noopControlSignal;
-        this->runOneTick_ = true;
-
+        this->actuator_->setPositionTarget(position, this->jointCoupling_->getVelocity(this->jointName_));
+        this->ApplyActuatorEffort(delta);
         return;
     }
 
-    float error = (this->controlSignalSetPoint_ - this->actualServoPosition_) ;
-    float maxRotationAmount = this->maxRotationRate_ * delta;
-
-    error = std::max(std::min(error, maxRotationAmount), -1.0f * maxRotationAmount);
-    this->actualServoPosition_ += error;
+    if (!this->SetPointChanged(position))
+        return;
 
-    float rotateDegrees = (this->actualServoPosition_ * this->rotationRange_) - (0.5 * this->rotationRange_);
+    float rotateDegrees = FMath::RadiansToDegrees(position - this->center_);
     FRotator setRotator = FRotator(0, 0, rotateDegrees);
-    this->actuationLink_->GetRootMesh()->WakeAllRigidBodies();
-    this->baseLink_->GetRootMesh()->WakeAllRigidBodies();
+    this->WakeLinks();
     this->constraintComponent_->SetAngularOrientationTarget(setRotator);
 }
 
@@ -99,8 +92,9 @@ TMap<FString, FString> Servo::GetState()
     TMap<FString, FString> state;
     state.Add(TEXT("SetPoint"), FString::SanitizeFloat(this->controlSignalSetPoint_));
 
-    FQuat baseLinkQuat = this->baseLink_->GetActorQuat();
-    FQuat actuationQuat = this->actuationLink_->GetActorQuat();
-    state.Add(TEXT("AcutalPoint"), FString::SanitizeFloat(this->actualServoPosition_));
+    float position = this->jointCoupling_->getPosition(this->jointName_);
+    state.Add(TEXT("AcutalPoint"), FString::SanitizeFloat((position - this->lower_) / this->range_));
+    state.Add(TEXT("Position"), FString::SanitizeFloat(this->jointCoupling_->toCalibrated(this->jointName_, position)));
+    this->AddActuatorState(state);
     return state;
 }
@@ -21,13 +21,10 @@ public:
 
 private:
     float controlSignalSetPoint_ = 0.0f;
-    float actualServoPosition_ = 0.0f;
 
-    float maxRotationRate_ = 0.0f;
-    float rotationRange_ = 0.0f;
-    float deadZone_ = 0.05f;
-    float invRotationRange_ = 1.0f;
+    // Joint limits, in radians
     float lower_ = 0.0f;
-    bool runOneTick_ = false;
+    float range_ = 0.0f;
+    float center_ = 0.0f;
 
 };
\ No newline at end of file
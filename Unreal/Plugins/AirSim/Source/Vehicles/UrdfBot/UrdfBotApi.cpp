@@ -6,6 +6,24 @@ UrdfBotApi::UrdfBotApi(AUrdfBotPawn* pawn, const msr::airlib::Kinematics::State*
     : UrdfBotApiBase(vehicle_setting, sensor_factory, state_provider_fxn, environment),
         pawn_(pawn), pawn_kinematics_(pawn_kinematics), home_geopoint_(home_geopoint)
 {
+    // Only joints with a controlled motion component can be measured.
+    this->setJointStateProvider([this](const std::string& jointName, msr::airlib::JointSensorBase::JointState& state) {
+        TMap<FString, ControlledMotionComponent*> components = this->pawn_->GetControlledMotionComponents();
+        ControlledMotionComponent** component = components.Find(FString(jointName.c_str()));
+        if (component == nullptr)
+            return false;
+
+        float position, velocity, effort;
+        (*component)->GetJointSensorState(position, velocity, effort);
+        state.position = position;
+        state.velocity = velocity;
+        state.effort = effort;
+        return true;
+    });
+
+    this->setContactProvider([this](const std::string& linkName, msr::airlib::ContactBase::ContactTotals& totals) {
+        return this->pawn_->GetContacts().getTotals(linkName, totals);
+    });
 }
 
 UrdfBotApi::~UrdfBotApi()
@@ -138,6 +156,9 @@ const msr::airlib::UrdfBotApiBase::UrdfBotState UrdfBotApi::getBotState(const st
 
 void UrdfBotApi::reset()
 {
+    // Contact totals start again from zero, and must do so before the contact sensors are reset.
+    this->pawn_->ResetContacts();
+
     msr::airlib::UrdfBotApiBase::reset();
 
     //TODO: Reset all forces on object to 0
@@ -114,6 +114,12 @@ void AUrdfBotPawn::Tick(float delta)
 {
     Super::Tick(delta);
 
+    // The hits of the last physics step have all been reported by now.
+    this->contacts_.endStep();
+
+    // Step every joint set point together, so mimic joints move with their leader on the same tick.
+    this->joint_coupling_.update(delta);
+
     for (const auto& kvp : this->controlled_motion_components_)
     {
         kvp.Value->ComputeForces(delta);
@@ -157,23 +163,27 @@ void AUrdfBotPawn::NotifyHit(class UPrimitiveComponent* myComp, class AActor* ot
         return;
     }
 
-    FString meshCompName = myComp->GetName();
-    FString otherCompName = other->GetName();
-    if (this->collision_blacklist_.Contains(meshCompName))
+    const AActor* link = myComp->GetOwner();
+    const int32* linkIndex = this->contact_link_index_.Find(link);
+    if (linkIndex == nullptr)
     {
-        TArray<FRegexPattern> patterns = this->collision_blacklist_[meshCompName];
-        for (int i = 0; i < patterns.Num(); i++)
-        {
-            FRegexMatcher matcher(patterns[i], otherCompName);
-            if (matcher.FindNext())
-            {
-                return;
-            }
-        }
+        return;
     }
 
-    this->pawn_events_.getCollisionSignal().emit(myComp, other, otherComp, bSelfMoved, hitLocation,
-        hitNormal, normalImpulse, hit);
+    // The blacklist decision for this pair is cached, so the name is only built the first time they touch.
+    FTransform linkTransform = link->GetActorTransform();
+    FVector location = linkTransform.InverseTransformPositionNoScale(hitLocation) / this->world_scale_;
+    FVector impulse = linkTransform.InverseTransformVectorNoScale(normalImpulse) / this->world_scale_;
+    bool firstHitOfStep = this->contacts_.addHit(*linkIndex, otherComp->GetUniqueID(),
+        [other]() { return std::string(TCHAR_TO_UTF8(*other->GetName())); },
+        msr::airlib::Vector3r(location.X, location.Y, location.Z), msr::airlib::Vector3r(impulse.X, impulse.Y, impulse.Z));
+
+    // One collision event per link and step is enough to record the collision; the rest are summed by the aggregator.
+    if (firstHitOfStep)
+    {
+        this->pawn_events_.getCollisionSignal().emit(myComp, other, otherComp, bSelfMoved, hitLocation,
+            hitNormal, normalImpulse, hit);
+    }
 }
 
 void AUrdfBotPawn::InitializeForBeginPlay()
@@ -197,18 +207,18 @@ void AUrdfBotPawn::InitializeForBeginPlay()
 
     this->ConstructFromFile(urdfPath);
 
-    this->collision_blacklist_.Empty();
-    for (auto &kvp : settings.vehicles["UrdfBot"].get()->collision_blacklist)
+    std::vector<std::string> linkNames;
+    this->contact_link_index_.Empty();
+    for (const auto& kvp : this->components_)
     {
-        FString bot_mesh = FString(kvp.first.c_str()) + TEXT("_visual");
-        FString regex = FString(kvp.second.c_str());
-
-        if (!this->collision_blacklist_.Contains(bot_mesh))
-        {
-            this->collision_blacklist_.Add(bot_mesh, TArray<FRegexPattern>());
-        }
+        this->contact_link_index_.Add(kvp.Value, static_cast<int32>(linkNames.size()));
+        linkNames.push_back(std::string(TCHAR_TO_UTF8(*kvp.Key)));
+    }
 
-        this->collision_blacklist_[bot_mesh].Add(FRegexPattern(regex));
+    this->contacts_.initialize(linkNames);
+    for (auto &kvp : settings.vehicles["UrdfBot"].get()->collision_blacklist)
+    {
+        this->contacts_.addFilter(kvp.first, kvp.second);
     }
 }
 
@@ -232,6 +242,18 @@ AUrdfLink* AUrdfBotPawn::GetRootLinkComponent() const
     return this->root_component_;
 }
 
+const msr::airlib::ContactAggregator& AUrdfBotPawn::GetContacts() const
+{
+    return this->contacts_;
+}
+
+void AUrdfBotPawn::ResetContacts()
+{
+    // Other components may have been destroyed and their ids reused.
+    this->contacts_.clearFilterCache();
+    this->contacts_.reset();
+}
+
 TMap<FString, ControlledMotionComponent*> AUrdfBotPawn::GetControlledMotionComponents() const
 {
     return this->controlled_motion_components_;
@@ -294,6 +316,8 @@ void AUrdfBotPawn::ConstructFromFile(FString fileName)
     TMap<FString, UrdfJointSpecification*> joints = parser.GetJoints();
     TMap<FString, UrdfForceSpecification*> forces = parser.GetForces();
 
+    this->joint_coupling_.initialize(parser.GetRobot());
+
     for (auto kvp : links)
     {
         AUrdfLink* createdLink = this->CreateLinkFromSpecification(*kvp.Value);
@@ -468,6 +492,7 @@ void AUrdfBotPawn::AttachChildren(AUrdfLink* parentLink, const UrdfLinkSpecifica
     if (this->ConstraintNeedsControlledMotionComponent(*jointSpecification))
     {
         ControlledMotionComponent* component = ControlledMotionComponentFactory::CreateControlledMotionComponent(parentLink, childLink, jointSpecification, constraint);
+        component->SetJointCoupling(&this->joint_coupling_);
         this->controlled_motion_components_.Add(component->GetName(), component);
     }
 
@@ -511,7 +536,7 @@ FConstraintInstance AUrdfBotPawn::CreateConstraint(const UrdfJointSpecification
     case PRISMATIC_TYPE:
         range = (jointSpecification.Limit->Upper - jointSpecification.Limit->Lower) * this->world_scale_ * 0.5f;
         constraintInstance.SetLinearXLimit(ELinearConstraintMotion::LCM_Limited, range);
-        if (jointSpecification.Limit != nullptr && jointSpecification.Limit->Effort > 0)
+        if (jointSpecification.Limit != nullptr && jointSpecification.Limit->Effort > 0 && jointSpecification.Actuator == nullptr)
         {
             constraintInstance.SetLinearDriveParams(jointSpecification.Limit->Effort * this->world_scale_, 5.0f, jointSpecification.Limit->Effort * this->world_scale_);
             constraintInstance.SetLinearPositionDrive(true, false, false);
@@ -525,7 +550,7 @@ FConstraintInstance AUrdfBotPawn::CreateConstraint(const UrdfJointSpecification
     case REVOLUTE_TYPE:
         range = FMath::RadiansToDegrees(jointSpecification.Limit->Upper - jointSpecification.Limit->Lower) * 0.5f;
         constraintInstance.SetAngularTwistLimit(EAngularConstraintMotion::ACM_Limited, range);
-        if (jointSpecification.Limit != nullptr && jointSpecification.Limit->Effort > 0)
+        if (jointSpecification.Limit != nullptr && jointSpecification.Limit->Effort > 0 && jointSpecification.Actuator == nullptr)
         {
             constraintInstance.SetAngularPositionDrive(false, true);
             constraintInstance.SetAngularDriveParams(jointSpecification.Limit->Effort * this->world_scale_ * this->world_scale_, 5.0f, jointSpecification.Limit->Effort * this->world_scale_ * this->world_scale_);
@@ -538,7 +563,7 @@ FConstraintInstance AUrdfBotPawn::CreateConstraint(const UrdfJointSpecification
         break;
     case CONTINUOUS_TYPE:
         constraintInstance.SetAngularTwistLimit(EAngularConstraintMotion::ACM_Free, 0.0f);
-        if (jointSpecification.Limit != nullptr && jointSpecification.Limit->Effort > 0)
+        if (jointSpecification.Limit != nullptr && jointSpecification.Limit->Effort > 0 && jointSpecification.Actuator == nullptr)
         {
             constraintInstance.SetAngularVelocityDrive(false, true);
             constraintInstance.SetAngularDriveParams(5.0f, jointSpecification.Limit->Effort * this->world_scale_ * this->world_scale_, jointSpecification.Limit->Effort * this->world_scale_ * this->world_scale_);
@@ -627,7 +652,9 @@ bool AUrdfBotPawn::ConstraintNeedsControlledMotionComponent(const UrdfJointSpeci
 {
     if (spec.Type == PRISMATIC_TYPE || spec.Type == REVOLUTE_TYPE || spec.Type == CONTINUOUS_TYPE)
     {
-        return (spec.Limit->Effort > 0) && !(this->controlled_motion_components_.Contains(spec.Name));
+        // Actuated joints are driven by torque, the others by a constraint drive that needs an effort limit
+        bool driven = spec.Actuator != nullptr || (spec.Limit != nullptr && spec.Limit->Effort > 0);
+        return driven && !(this->controlled_motion_components_.Contains(spec.Name));
     }
 
     return false;
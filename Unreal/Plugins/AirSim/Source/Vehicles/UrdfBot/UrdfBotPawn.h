@@ -12,13 +12,14 @@
 #include "Runtime/Engine/Classes/PhysicsEngine/PhysicsConstraintComponent.h"
 #include "Runtime/Engine/Classes/PhysicsEngine/ConstraintInstance.h"
 #include "Runtime/Engine/Classes/Engine/StaticMesh.h"
-#include "Runtime/Core/Public/Internationalization/Regex.h"
 
 #include "PIPCamera.h"
 #include "common/common_utils/UniqueValueMap.hpp"
 #include "common/common_utils/Utils.hpp"
 #include "AirBlueprintLib.h"
 #include "vehicles/urdfbot/api/UrdfBotApiBase.hpp"
+#include "vehicles/urdfbot/JointCoupling.hpp"
+#include "vehicles/urdfbot/ContactAggregator.hpp"
 
 #include "UrdfParser/UrdfGeometry.h"
 #include "UrdfParser/UrdfParser.h"
@@ -65,6 +66,10 @@ class AUrdfBotPawn : public APawn, public AirsimVehicle
 
         TMap<FString, ControlledMotionComponent*> GetControlledMotionComponents() const;
 
+        // Filtered hits summed per link, closed at the start of each tick.
+        const msr::airlib::ContactAggregator& GetContacts() const;
+        void ResetContacts();
+
         virtual USceneComponent* GetComponent(FString componentName) override;
         virtual AUrdfLink* GetLink(FString linkName);
         virtual APawn* GetPawn() override { return this; }
@@ -129,11 +134,13 @@ class AUrdfBotPawn : public APawn, public AirsimVehicle
         UPROPERTY()
         TMap<FString, UStaticMesh*> procedural_mesh_cache_;
 
-        TMap<FString, TArray<FRegexPattern>> collision_blacklist_;
+        msr::airlib::ContactAggregator contacts_;
+        TMap<const AActor*, int32> contact_link_index_;
 
         TMap<FString, TTuple<UrdfJointType, UPhysicsConstraintComponent*>> constraints_;
 
         TMap<FString, ControlledMotionComponent*> controlled_motion_components_;
+        msr::airlib::JointCoupling joint_coupling_;
 
         StaticMeshGenerator staticMeshGenerator_;
 
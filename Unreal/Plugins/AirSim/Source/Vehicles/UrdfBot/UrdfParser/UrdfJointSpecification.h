@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "UrdfOrigin.h"
 #include "UrdfLinkSpecification.h"
+#include "vehicles/urdfbot/parser/UrdfSpecification.hpp"
 
 enum UrdfJointType
 {
@@ -77,6 +78,7 @@ class UrdfJointSpecification
         UrdfJointLimitSpecification* Limit = nullptr;
         UrdfJointMimicSpecification* Mimic = nullptr;
         UrdfJointSafetyControllerSpecification* SafetyController = nullptr;
+        msr::airlib::UrdfActuator* Actuator = nullptr;
 
         static UrdfJointType ParseJointType(FString type)
         {
@@ -8,11 +8,9 @@
 #include "UrdfForceSpecification.h"
 #include "UrdfMaterialSpecification.h"
 #include "UrdfCameraSpecification.h"
-#include "Runtime/XmlParser/Public/XmlFile.h"
-#include "Runtime/XmlParser/Public/XmlNode.h"
-#include "Runtime/XmlParser/Public/XmlParser.h"
-#include "Runtime/XmlParser/Public/FastXml.h"
+#include "vehicles/urdfbot/parser/UrdfParser.hpp"
 
+// Reads the robot with the engine independent AirLib parser, which also expands xacro, and converts it to Unreal types.
 class UrdfParser
 {
     public:
@@ -21,41 +19,23 @@ class UrdfParser
         TMap<FString, UrdfJointSpecification*> GetJoints();
         TMap<FString, UrdfForceSpecification*> GetForces();
         TMap<FString, UrdfMaterialSpecification*> GetMaterials();
+        const msr::airlib::UrdfRobot& GetRobot() const;
 
     private:
+        UrdfLinkSpecification* ConvertLinkSpecification(const msr::airlib::UrdfLink& link);
+        UrdfJointSpecification* ConvertJointSpecification(const msr::airlib::UrdfJoint& joint);
+        UrdfForceSpecification* ConvertForceSpecification(const msr::airlib::UrdfForce& force);
+        UrdfMaterialSpecification* ConvertMaterialSpecification(const msr::airlib::UrdfMaterial& material);
+        UrdfGeometry* ConvertGeometry(const msr::airlib::UrdfGeometry& geometry);
+        UrdfOrigin ConvertOrigin(const msr::airlib::UrdfOrigin& origin);
 
-        UrdfLinkSpecification* ParseLinkSpecification(FXmlNode *linkNode);
-        UrdfJointSpecification* ParseJointSpecification(FXmlNode *jointNode);
-        UrdfForceSpecification* ParseForceSpecification(FXmlNode *forceNode);
-        UrdfMaterialSpecification* ParseMaterialSpecification(FXmlNode* materialNode);
-
-        // Link parsing
-        UrdfLinkInertialSpecification* ParseLinkInertialSpecification(FXmlNode *inertialNode);
-        UrdfLinkVisualSpecification* ParseLinkVisualSpecification(FXmlNode *visualNode);
-        UrdfLinkCollisionSpecification* ParseLinkCollisionSpecification(FXmlNode *collisionNode);
-        UrdfGeometry* ParseUrdfGeometrySpecification(FXmlNode *geometryNode);
-
-        // Joint parsing
-        UrdfJointCalibrationSpecification* ParseJointCalibrationSpecification(FXmlNode *calibrationNode);
-        UrdfJointDynamicsSpecification ParseJointDynamicsSpecification(FXmlNode *dynamicsNode);
-        UrdfJointLimitSpecification* ParseJointLimitSpecification(FXmlNode *limitNode);
-        UrdfJointMimicSpecification* ParseJointMimicSpecification(FXmlNode *mimicNode);
-        UrdfJointSafetyControllerSpecification* ParseJointSafetyControllerSpecification(FXmlNode *safetyControllerNode);
-
-        // Force parsing
-        UrdfAngularForceSpecification* ParseAngularForceSpecification(FXmlNode *angularForceNode);
-        UrdfLinearForceSpecification* ParseLinearForceSpecification(FXmlNode *linearForceNode);
-
-        // General parsing
-        UrdfOrigin ParseUrdfOrigin(FXmlNode *originNode);
-        FVector ParseFVectorFromAttributeString(const FString &string);
-        FRotator ParseFRotatorFromAttributeString(const FString &string);
-        FVector4 ParseFVector4FromAttributeString(const FString &string);
-        msr::airlib::VectorMathf::Matrix3x3f ParseInertiaMatrixFromAttributes(FXmlNode *inertiaNode);
-        UrdfGeometryType GeometryTypeFromString(FString typeString);
+        static FString ToFString(const std::string& value);
+        static FVector ToFVector(const msr::airlib::Vector3r& value);
+        static FRotator ToFRotator(const msr::airlib::Vector3r& rollPitchYaw);
 
         TMap<FString, UrdfLinkSpecification*> links_;
         TMap<FString, UrdfJointSpecification*> joints_;
         TMap<FString, UrdfForceSpecification*> forces_;
         TMap<FString, UrdfMaterialSpecification*> materials_;
-};
\ No newline at end of file
+        msr::airlib::UrdfRobot robot_;
+};
@@ -254,35 +254,88 @@ std::unordered_map<std::string, msr::airlib::Pose> WorldSimApi::charGetBonePoses
     const AAirSimCharacter* character = getAirSimCharacter(character_name);
     return character->getBonePoses(bone_names);
 }
+std::vector<std::string> WorldSimApi::charGetBoneNames(const std::string& character_name) const
+{
+    const AAirSimCharacter* character = getAirSimCharacter(character_name);
+    std::vector<std::string> bone_names;
+    UAirBlueprintLib::RunCommandOnGameThread([character, &bone_names]() {
+        bone_names = character->cacheBoneNames();
+    }, true);
+    return bone_names;
+}
+void WorldSimApi::charSetBonePosesByIndex(const std::vector<int>& bone_indices, const std::vector<msr::airlib::Pose>& poses, const std::string& character_name)
+{
+    AAirSimCharacter* character = getAirSimCharacter(character_name);
+    character->setBonePosesByIndex(bone_indices, poses);
+}
+std::vector<msr::airlib::Pose> WorldSimApi::charGetBonePosesByIndex(const std::vector<int>& bone_indices, const std::string& character_name) const
+{
+    const AAirSimCharacter* character = getAirSimCharacter(character_name);
+    return character->getBonePosesByIndex(bone_indices);
+}
+void WorldSimApi::charPlayMotionClip(const std::string& clip_file, float scale, float rate, bool loop, const std::string& character_name)
+{
+    //parse here rather than on the game thread so a long clip doesn't hold up a frame
+    std::shared_ptr<const msr::airlib::MotionClip> clip = std::make_shared<msr::airlib::MotionClip>(
+        msr::airlib::BvhParser::parseFile(clip_file, scale));
+
+    AAirSimCharacter* character = getAirSimCharacter(character_name);
+    UAirBlueprintLib::RunCommandOnGameThread([character, clip, rate, loop]() {
+        character->playMotionClip(clip, rate, loop);
+    }, true);
+}
+void WorldSimApi::charSetMotionClipTimeWarp(const std::vector<float>& play_times, const std::vector<float>& clip_times, const std::string& character_name)
+{
+    if (play_times.size() != clip_times.size())
+        throw std::invalid_argument("Time warp needs one clip time for each play time");
+
+    std::vector<msr::airlib::MotionClipPlayer::TimeWarpKey> keys;
+    for (size_t i = 0; i < play_times.size(); ++i)
+        keys.emplace_back(play_times[i], clip_times[i]);
+    msr::airlib::MotionClipPlayer::checkTimeWarp(keys);
+
+    AAirSimCharacter* character = getAirSimCharacter(character_name);
+    UAirBlueprintLib::RunCommandOnGameThread([character, &keys]() {
+        character->setMotionClipTimeWarp(keys);
+    }, true);
+}
+void WorldSimApi::charStopMotionClip(const std::string& character_name)
+{
+    AAirSimCharacter* character = getAirSimCharacter(character_name);
+    UAirBlueprintLib::RunCommandOnGameThread([character]() {
+        character->stopMotionClip();
+    }, true);
+}
 
 AAirSimCharacter* WorldSimApi::getAirSimCharacter(const std::string& character_name)
 {
-    AAirSimCharacter* character = nullptr;
-    UAirBlueprintLib::RunCommandOnGameThread([this, &character_name, &character]() {
-        if (chars_.size() == 0) { //not found in the cache
+    //only the first call waits for the game thread to find the characters, later calls just read the cache
+    std::lock_guard<std::mutex> lock(chars_mutex_);
+    if (chars_.size() == 0) {
+        UAirBlueprintLib::RunCommandOnGameThread([this]() {
             TArray<AActor*> characters;
             UAirBlueprintLib::FindAllActor<AAirSimCharacter>(simmode_, characters);
             for (AActor* actor : characters) {
-                character = static_cast<AAirSimCharacter*>(actor);
+                AAirSimCharacter* character = static_cast<AAirSimCharacter*>(actor);
                 chars_[std::string(
                     TCHAR_TO_UTF8(*character->GetName()))] = character;
             }
-        }
-
-        if (chars_.size() == 0) {
-            throw std::invalid_argument(
-                "There were no actors of class ACharactor found in the environment");
-        }
-
-        //choose first character if name was blank or find by name
-        character = character_name == "" ? chars_.begin()->second
-            : common_utils::Utils::findOrDefault(chars_, character_name);
-
-        if (!character) {
-            throw std::invalid_argument(common_utils::Utils::stringf(
-                "Character with name %s was not found in the environment", character_name.c_str()).c_str());
-        }
-    }, true);
+        }, true);
+    }
+
+    if (chars_.size() == 0) {
+        throw std::invalid_argument(
+            "There were no actors of class ACharactor found in the environment");
+    }
+
+    //choose first character if name was blank or find by name
+    AAirSimCharacter* character = character_name == "" ? chars_.begin()->second
+        : common_utils::Utils::findOrDefault(chars_, character_name);
+
+    if (!character) {
+        throw std::invalid_argument(common_utils::Utils::stringf(
+            "Character with name %s was not found in the environment", character_name.c_str()).c_str());
+    }
 
     return character;
 }
@@ -8,6 +8,7 @@
 #include <string>
 #include "Engine/StaticMeshActor.h"
 #include "common/Common.hpp"
+#include <mutex>
 
 class WorldSimApi : public msr::airlib::WorldSimApiBase {
 public:
@@ -49,6 +50,12 @@ public:
     virtual void charSetFacePresets(const std::unordered_map<std::string, float>& presets, const std::string& character_name) override;
     virtual void charSetBonePoses(const std::unordered_map<std::string, msr::airlib::Pose>& poses, const std::string& character_name) override;
     virtual std::unordered_map<std::string, msr::airlib::Pose> charGetBonePoses(const std::vector<std::string>& bone_names, const std::string& character_name) const override;
+    virtual std::vector<std::string> charGetBoneNames(const std::string& character_name) const override;
+    virtual void charSetBonePosesByIndex(const std::vector<int>& bone_indices, const std::vector<msr::airlib::Pose>& poses, const std::string& character_name) override;
+    virtual std::vector<msr::airlib::Pose> charGetBonePosesByIndex(const std::vector<int>& bone_indices, const std::string& character_name) const override;
+    virtual void charPlayMotionClip(const std::string& clip_file, float scale, float rate, bool loop, const std::string& character_name) override;
+    virtual void charSetMotionClipTimeWarp(const std::vector<float>& play_times, const std::vector<float>& clip_times, const std::string& character_name) override;
+    virtual void charStopMotionClip(const std::string& character_name) override;
 
 private:
     AAirSimCharacter* getAirSimCharacter(const std::string& character_name);
@@ -59,4 +66,5 @@ private:
 private:
     ASimModeBase* simmode_;
     std::map<std::string, AAirSimCharacter*> chars_;
+    std::mutex chars_mutex_;
 };